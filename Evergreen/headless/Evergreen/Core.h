@@ -0,0 +1,16 @@
+#pragma once
+#include "Evergreen/Log.h"
+
+// Headless stand-in for Evergreen/src/Evergreen/Core.h (see headless/pch.h)
+
+#define EVERGREEN_API
+
+#define ND [[nodiscard]]
+
+#ifdef EG_ENABLE_ASSERTS
+	#define EG_ASSERT(x, ...) { if (!(x)) { EG_ERROR("Assertion Failed: {0}", __VA_ARGS__); std::abort(); } }
+	#define EG_CORE_ASSERT(x, ...) { if (!(x)) { EG_CORE_ERROR("Assertion Failed: {0}", __VA_ARGS__); std::abort(); } }
+#else
+	#define EG_ASSERT(x, ...)
+	#define EG_CORE_ASSERT(x, ...)
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdio>
+#include <sstream>
+#include <string_view>
+
+// Headless stand-in for Evergreen/src/Evergreen/Log.h (see headless/pch.h). Messages go to stderr instead of spdlog.
+
+namespace Evergreen::HeadlessLog
+{
+// Minimal stand-in for std::format (which not every Linux toolchain ships yet) - replaces each "{...}" in order
+inline void FormatTo(std::ostringstream& out, std::string_view fmt) { out << fmt; }
+template<typename T, typename... Args>
+void FormatTo(std::ostringstream& out, std::string_view fmt, const T& value, const Args&... args)
+{
+	const size_t open = fmt.find('{');
+	const size_t close = open == std::string_view::npos ? open : fmt.find('}', open);
+	if (close == std::string_view::npos)
+	{
+		out << fmt;
+		return;
+	}
+	out << fmt.substr(0, open) << value;
+	FormatTo(out, fmt.substr(close + 1), args...);
+}
+template<typename... Args>
+void Write(const char* level, std::string_view fmt, const Args&... args)
+{
+	std::ostringstream out;
+	FormatTo(out, fmt, args...);
+	std::fprintf(stderr, "[%s] %s\n", level, out.str().c_str());
+}
+}
+
+#define EG_CORE_TRACE(...) ::Evergreen::HeadlessLog::Write("trace", __VA_ARGS__)
+#define EG_CORE_INFO(...) ::Evergreen::HeadlessLog::Write("info", __VA_ARGS__)
+#define EG_CORE_WARN(...) ::Evergreen::HeadlessLog::Write("warning", __VA_ARGS__)
+#define EG_CORE_ERROR(...) ::Evergreen::HeadlessLog::Write("error", __VA_ARGS__)
+
+#define EG_TRACE(...) ::Evergreen::HeadlessLog::Write("trace", __VA_ARGS__)
+#define EG_INFO(...) ::Evergreen::HeadlessLog::Write("info", __VA_ARGS__)
+#define EG_WARN(...) ::Evergreen::HeadlessLog::Write("warning", __VA_ARGS__)
+#define EG_ERROR(...) ::Evergreen::HeadlessLog::Write("error", __VA_ARGS__)
@@ -0,0 +1,19 @@
+#pragma once
+
+// Stand-ins for the engine's precompiled header, Core.h and Log.h, used by the CMake targets (Tests/, MoleculesBatch/)
+// that compile the parts of Evergreen that only depend on the standard library (ex. JobSystem, PieceTable and
+// SoftwareRasterizer) on platforms without Windows/DirectX. Put this directory on the include path BEFORE Evergreen/src
+// so that "pch.h", "Evergreen/Core.h" and "Evergreen/Log.h" resolve to these files.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
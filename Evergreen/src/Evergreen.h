@@ -7,5 +7,15 @@
 #include "Evergreen/UI/JSONLoading/JSONLoaders.h"
 #include "Evergreen/UI/Controls.h"
 #include "Evergreen/UI/Brushes.h"
+#include "Evergreen/UI/Observable.h"
+#include "Evergreen/UI/ControlProfiler.h"
+#include "Evergreen/UI/DrawList.h"
+#include "Evergreen/UI/DrawListRasterizer.h"
 #include "Evergreen/Rendering/DeviceResources.h"
+#include "Evergreen/Rendering/Software/SoftwareRasterizer.h"
+#include "Evergreen/Utils/JobSystem.h"
+#include "Evergreen/Utils/InputRecording.h"
+#include "Evergreen/Utils/MemoryAccounting.h"
+#include "Evergreen/Utils/Animator.h"
+#include "Evergreen/Utils/PieceTable.h"
 
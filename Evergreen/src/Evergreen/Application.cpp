@@ -5,9 +5,13 @@
 namespace Evergreen
 {
 #define BIND_EVENT_FN(fn, type) [this](type& e) { this->fn(e); }
+// Live input is dropped while an input recording is being replayed
+#define BIND_INPUT_EVENT_FN(fn, type) [this](type& e) { if (!m_inputReplay.IsReplaying()) this->fn(e); }
 
 Application::Application()
 {
+	m_jobSystem = std::make_unique<JobSystem>();
+
 	// Create main window
 	m_window = std::make_shared<Window>();
 	m_window->InitializeCursors();
@@ -18,17 +22,17 @@ Application::Application()
 	m_window->SetOnAppTick(BIND_EVENT_FN(OnAppTick, AppTickEvent));
 	m_window->SetOnAppUpdate(BIND_EVENT_FN(OnAppUpdate, AppUpdateEvent));
 	m_window->SetOnAppRender(BIND_EVENT_FN(OnAppRender, AppRenderEvent));
-	m_window->SetOnChar(BIND_EVENT_FN(OnChar, CharEvent));
-	m_window->SetOnKeyPressed(BIND_EVENT_FN(OnKeyPressed, KeyPressedEvent));
-	m_window->SetOnKeyReleased(BIND_EVENT_FN(OnKeyReleased, KeyReleasedEvent));
-	m_window->SetOnMouseMove(BIND_EVENT_FN(OnMouseMove, MouseMoveEvent));
-	m_window->SetOnMouseEnter(BIND_EVENT_FN(OnMouseEnter, MouseEnterEvent));
-	m_window->SetOnMouseLeave(BIND_EVENT_FN(OnMouseLeave, MouseLeaveEvent));
-	m_window->SetOnMouseScrolledVertical(BIND_EVENT_FN(OnMouseScrolledVertical, MouseScrolledEvent));
-	m_window->SetOnMouseScrolledHorizontal(BIND_EVENT_FN(OnMouseScrolledHorizontal, MouseScrolledEvent));
-	m_window->SetOnMouseButtonPressed(BIND_EVENT_FN(OnMouseButtonPressed, MouseButtonPressedEvent));
-	m_window->SetOnMouseButtonReleased(BIND_EVENT_FN(OnMouseButtonReleased, MouseButtonReleasedEvent));
-	m_window->SetOnMouseButtonDoubleClick(BIND_EVENT_FN(OnMouseButtonDoubleClick, MouseButtonDoubleClickEvent));
+	m_window->SetOnChar(BIND_INPUT_EVENT_FN(OnChar, CharEvent));
+	m_window->SetOnKeyPressed(BIND_INPUT_EVENT_FN(OnKeyPressed, KeyPressedEvent));
+	m_window->SetOnKeyReleased(BIND_INPUT_EVENT_FN(OnKeyReleased, KeyReleasedEvent));
+	m_window->SetOnMouseMove(BIND_INPUT_EVENT_FN(OnMouseMove, MouseMoveEvent));
+	m_window->SetOnMouseEnter(BIND_INPUT_EVENT_FN(OnMouseEnter, MouseEnterEvent));
+	m_window->SetOnMouseLeave(BIND_INPUT_EVENT_FN(OnMouseLeave, MouseLeaveEvent));
+	m_window->SetOnMouseScrolledVertical(BIND_INPUT_EVENT_FN(OnMouseScrolledVertical, MouseScrolledEvent));
+	m_window->SetOnMouseScrolledHorizontal(BIND_INPUT_EVENT_FN(OnMouseScrolledHorizontal, MouseScrolledEvent));
+	m_window->SetOnMouseButtonPressed(BIND_INPUT_EVENT_FN(OnMouseButtonPressed, MouseButtonPressedEvent));
+	m_window->SetOnMouseButtonReleased(BIND_INPUT_EVENT_FN(OnMouseButtonReleased, MouseButtonReleasedEvent));
+	m_window->SetOnMouseButtonDoubleClick(BIND_INPUT_EVENT_FN(OnMouseButtonDoubleClick, MouseButtonDoubleClickEvent));
 
 	// Create DeviceResources
 	m_deviceResources = std::make_shared<DeviceResources>(m_window.get());
@@ -40,6 +44,11 @@ int Application::Run()
 {
 	while (true)
 	{
+		// When rendering on demand and nothing is changing, sleep until there is something to respond to rather than
+		// rendering identical frames
+		if (m_renderOnDemand && !m_ui->IsAnimating() && !m_inputReplay.IsReplaying() && !NeedsContinuousRendering())
+			m_window->WaitForMessages(m_idleTimeoutMs);
+
 		// process all messages pending, but to not block for new messages
 		if (const auto ecode = m_window->ProcessMessages())
 		{
@@ -47,6 +56,32 @@ int Application::Run()
 			return *ecode;
 		}
 
+		// This frame's input has either just been delivered by the window (and is now marked as complete in the
+		// recording), or comes from the replay
+		if (m_inputReplay.IsReplaying())
+		{
+			std::span<const RecordedInput> input;
+			uint64_t elapsedTicks = 0;
+			if (m_inputReplay.NextFrame(input, elapsedTicks))
+			{
+				for (const RecordedInput& i : input)
+					ReplayInput(i);
+
+				m_timer.AdvanceVirtualTime(elapsedTicks);
+			}
+			else
+			{
+				InputReplayFinished();
+			}
+		}
+		else if (m_inputRecorder.IsRecording())
+		{
+			m_inputRecorder.RecordFrame();
+		}
+
+		// Run the work that background threads posted for the UI since the last frame, so Update sees its results
+		m_ui->RunPostedWork();
+
 		m_timer.Tick([&]()
 			{
 				Update(m_timer);
@@ -55,7 +90,141 @@ int Application::Run()
 
 		Render();
 		Present();
+
+		MemoryAccounting::EndFrame();
+
+		if (m_inputReplay.IsReplaying())
+			m_inputReplay.FrameFinished();
+	}
+}
+
+bool Application::StartInputRecording(const std::filesystem::path& file) noexcept
+{
+	if (m_inputReplay.IsReplaying())
+	{
+		EG_CORE_ERROR("{}:{} - Cannot record input while replaying a recording", __FILE__, __LINE__);
+		return false;
+	}
+
+	if (!m_inputRecorder.Start(file))
+		return false;
+
+	// Start from the current window size so that a replay begins with the same layout
+	WindowResizeEvent e(m_window->GetWidth(), m_window->GetHeight());
+	m_inputRecorder.Record(e);
+	return true;
+}
+void Application::StopInputRecording() noexcept
+{
+	m_inputRecorder.Stop();
+}
+bool Application::StartInputReplay(const std::filesystem::path& file, InputReplay::Timing timing, bool quitWhenFinished) noexcept
+{
+	if (m_inputRecorder.IsRecording())
+	{
+		EG_CORE_ERROR("{}:{} - Cannot replay input while recording", __FILE__, __LINE__);
+		return false;
+	}
+
+	if (!m_inputReplay.Start(file, timing))
+		return false;
+
+	m_quitWhenReplayFinished = quitWhenFinished;
+	m_timer.SetVirtualTime(true);
+	return true;
+}
+void Application::ReplayInput(const RecordedInput& input)
+{
+	switch (input.type)
+	{
+	case RecordedInputType::WINDOW_RESIZE:
+		// Resize the actual window, which then delivers the WindowResizeEvent through the usual path
+		m_window->SetClientSize(static_cast<unsigned int>(input.value), static_cast<unsigned int>(input.value2));
+		break;
+
+	case RecordedInputType::CHAR:
+	{
+		CharEvent e(static_cast<char>(input.value), input.value2);
+		OnChar(e);
+		break;
+	}
+	case RecordedInputType::KEY_PRESSED:
+	{
+		KeyPressedEvent e(static_cast<KEY_CODE>(input.value), input.value2, input.flag);
+		OnKeyPressed(e);
+		break;
+	}
+	case RecordedInputType::KEY_RELEASED:
+	{
+		KeyReleasedEvent e(static_cast<KEY_CODE>(input.value));
+		OnKeyReleased(e);
+		break;
+	}
+	case RecordedInputType::MOUSE_MOVE:
+	{
+		MouseMoveEvent e(input.x, input.y);
+		OnMouseMove(e);
+		break;
+	}
+	case RecordedInputType::MOUSE_ENTER:
+	{
+		MouseEnterEvent e;
+		OnMouseEnter(e);
+		break;
+	}
+	case RecordedInputType::MOUSE_LEAVE:
+	{
+		MouseLeaveEvent e;
+		OnMouseLeave(e);
+		break;
 	}
+	case RecordedInputType::MOUSE_SCROLLED_VERTICAL:
+	{
+		MouseScrolledEvent e(input.x, input.y, input.value);
+		OnMouseScrolledVertical(e);
+		break;
+	}
+	case RecordedInputType::MOUSE_SCROLLED_HORIZONTAL:
+	{
+		MouseScrolledEvent e(input.x, input.y, input.value);
+		OnMouseScrolledHorizontal(e);
+		break;
+	}
+	case RecordedInputType::MOUSE_BUTTON_PRESSED:
+	{
+		MouseButtonPressedEvent e(static_cast<MOUSE_BUTTON>(input.value), input.x, input.y);
+		OnMouseButtonPressed(e);
+		break;
+	}
+	case RecordedInputType::MOUSE_BUTTON_RELEASED:
+	{
+		MouseButtonReleasedEvent e(static_cast<MOUSE_BUTTON>(input.value), input.x, input.y);
+		OnMouseButtonReleased(e);
+		break;
+	}
+	case RecordedInputType::MOUSE_BUTTON_DOUBLE_CLICK:
+	{
+		MouseButtonDoubleClickEvent e(static_cast<MOUSE_BUTTON>(input.value), input.x, input.y);
+		OnMouseButtonDoubleClick(e);
+		break;
+	}
+	default:
+		EG_CORE_ASSERT(false, "Frame markers are never passed to ReplayInput");
+		break;
+	}
+}
+void Application::InputReplayFinished()
+{
+	m_timer.SetVirtualTime(false);
+
+	const ReplayStats stats = m_inputReplay.GetStats();
+	EG_CORE_INFO("Input replay finished: {} frames, {} events in {:.3f}s", stats.frameCount, stats.eventCount, stats.totalSeconds);
+	EG_CORE_INFO("Frame time (ms): mean {:.3f} | min {:.3f} | median {:.3f} | p95 {:.3f} | p99 {:.3f} | max {:.3f}", stats.meanMs, stats.minMs, stats.medianMs, stats.p95Ms, stats.p99Ms, stats.maxMs);
+
+	OnInputReplayFinished(stats);
+
+	if (m_quitWhenReplayFinished)
+		PostQuitMessage(0);
 }
 
 void Application::Update(const Timer& timer)
@@ -84,6 +253,7 @@ void Application::Present()
 
 void Application::OnWindowResize(WindowResizeEvent& e)
 {
+	m_inputRecorder.Record(e);
 	EG_CORE_INFO("{}", e);
 	m_deviceResources->OnResize(static_cast<float>(e.GetWidth()), static_cast<float>(e.GetHeight()));
 	m_ui->OnWindowResize(e);
@@ -110,52 +280,63 @@ void Application::OnAppRender(AppRenderEvent& e)
 }
 void Application::OnChar(CharEvent& e)
 {
+	m_inputRecorder.Record(e);
 	EG_CORE_INFO("{}", e);
 	m_ui->OnChar(e);
 }
 void Application::OnKeyPressed(KeyPressedEvent& e)
 {
+	m_inputRecorder.Record(e);
 	EG_CORE_INFO("{}", e);
 	m_ui->OnKeyPressed(e);
 }
 void Application::OnKeyReleased(KeyReleasedEvent& e)
 {
+	m_inputRecorder.Record(e);
 	EG_CORE_INFO("{}", e);
 	m_ui->OnKeyReleased(e);
 }
 void Application::OnMouseMove(MouseMoveEvent& e)
 {
+	m_inputRecorder.Record(e);
 	m_ui->OnMouseMove(e);
 	//EG_CORE_INFO("{}", e);
 }
 void Application::OnMouseEnter(MouseEnterEvent& e)
 {
+	m_inputRecorder.Record(e);
 	EG_CORE_INFO("{}", e);
 }
 void Application::OnMouseLeave(MouseLeaveEvent& e)
 {
+	m_inputRecorder.Record(e);
 	EG_CORE_INFO("{}", e);
 }
 void Application::OnMouseScrolledVertical(MouseScrolledEvent& e)
 {
+	m_inputRecorder.RecordScrolledVertical(e);
 	m_ui->OnMouseScrolledVertical(e);
 }
 void Application::OnMouseScrolledHorizontal(MouseScrolledEvent& e)
 {
+	m_inputRecorder.RecordScrolledHorizontal(e);
 	m_ui->OnMouseScrolledHorizontal(e);
 }
 void Application::OnMouseButtonPressed(MouseButtonPressedEvent& e)
 {
+	m_inputRecorder.Record(e);
 	m_ui->OnMouseButtonPressed(e);
 	EG_CORE_INFO("{}", e);
 }
 void Application::OnMouseButtonReleased(MouseButtonReleasedEvent& e)
 {
+	m_inputRecorder.Record(e);
 	m_ui->OnMouseButtonReleased(e);
 	EG_CORE_INFO("{}", e);
 }
 void Application::OnMouseButtonDoubleClick(MouseButtonDoubleClickEvent& e)
 {
+	m_inputRecorder.Record(e);
 	m_ui->OnMouseButtonDoubleClick(e);
 	EG_CORE_INFO("{}", e);
 }
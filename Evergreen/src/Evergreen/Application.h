@@ -9,6 +9,9 @@
 #include "Evergreen/Window/Window.h"
 #include "Rendering/DeviceResources.h"
 #include "Evergreen/Utils/Timer.h"
+#include "Evergreen/Utils/JobSystem.h"
+#include "Evergreen/Utils/InputRecording.h"
+#include "Evergreen/Utils/MemoryAccounting.h"
 
 // See: https://learn.microsoft.com/en-us/cpp/c-runtime-library/debug-versions-of-heap-allocation-functions?view=msvc-170
 #if defined(DEBUG) || defined(_DEBUG)
@@ -33,21 +36,44 @@ public:
 
 	int Run();
 
+	// Input recording & replay (see Utils/InputRecording.h). Recording and replaying are mutually exclusive. While
+	// replaying, live input is ignored and the Timer runs on virtual time. When the replay finishes, the per-frame
+	// statistics are logged and passed to OnInputReplayFinished
+	bool StartInputRecording(const std::filesystem::path& file) noexcept;
+	void StopInputRecording() noexcept;
+	bool StartInputReplay(const std::filesystem::path& file, InputReplay::Timing timing, bool quitWhenFinished = false) noexcept;
+
+	// By default a frame is rendered on every pass of the main loop. When rendering on demand, the loop instead waits
+	// for window messages whenever nothing is animating (see UI::GetAnimator) and the client application does not need
+	// continuous rendering. 'idleTimeoutMs' bounds the wait, so that work posted to the UI by other threads (see
+	// UI::Post) is still picked up while idle
+	void SetRenderOnDemand(bool enable, unsigned int idleTimeoutMs = 100) noexcept { m_renderOnDemand = enable; m_idleTimeoutMs = idleTimeoutMs; }
+
 protected:
 	std::unique_ptr<UI> m_ui;
 	std::shared_ptr<DeviceResources> m_deviceResources;
 	Timer m_timer;
 	std::shared_ptr<Window> m_window;
+	// Worker threads for the client application and the engine's subsystems. The main (UI) thread is worker 0, so
+	// jobs it schedules run on the other workers unless it waits on them
+	std::unique_ptr<JobSystem> m_jobSystem;
 
 	// Virtual functions so the client application can update & render to viewports 
 	virtual void OnUpdate(const Timer& timer) {}
 	virtual void OnRender() {}
+	virtual void OnInputReplayFinished(const ReplayStats& stats) {}
+	// Only used when rendering on demand. Return true while the client has content that changes every frame (ex. a
+	// running simulation)
+	ND virtual bool NeedsContinuousRendering() const { return false; }
 
 private:
 	void Update(const Timer& timer);
 	void Render();
 	void Present();
 
+	void ReplayInput(const RecordedInput& input);
+	void InputReplayFinished();
+
 	void OnWindowResize(WindowResizeEvent& e);
 	void OnWindowCreate(WindowCreateEvent& e);
 	void OnWindowClose(WindowCloseEvent& e);
@@ -66,6 +92,13 @@ private:
 	void OnMouseButtonReleased(MouseButtonReleasedEvent& e);
 	void OnMouseButtonDoubleClick(MouseButtonDoubleClickEvent& e);
 
+	InputRecorder m_inputRecorder;
+	InputReplay m_inputReplay;
+	bool m_quitWhenReplayFinished = false;
+
+	bool m_renderOnDemand = false;
+	unsigned int m_idleTimeoutMs = 100;
+
 
 
 // There is a somewhat weird behavior in DirectX reporting memory leaks on application shutdown.
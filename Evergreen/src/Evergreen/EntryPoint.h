@@ -12,6 +12,30 @@ int main(int argc, char** argv)
 	try
 	{
 		std::unique_ptr<Evergreen::Application> app = std::unique_ptr<Evergreen::Application>(Evergreen::CreateApplication());
+
+		// Input recording/replay (see Evergreen/Utils/InputRecording.h):
+		//		--record-input <file>
+		//		--replay-input <file> [--replay-fast] [--replay-quit]
+		std::string recordFile, replayFile;
+		bool replayFast = false, replayQuit = false;
+		for (int iii = 1; iii < argc; ++iii)
+		{
+			std::string_view arg = argv[iii];
+			if (arg == "--record-input" && iii + 1 < argc)
+				recordFile = argv[++iii];
+			else if (arg == "--replay-input" && iii + 1 < argc)
+				replayFile = argv[++iii];
+			else if (arg == "--replay-fast")
+				replayFast = true;
+			else if (arg == "--replay-quit")
+				replayQuit = true;
+		}
+
+		if (!replayFile.empty())
+			app->StartInputReplay(replayFile, replayFast ? Evergreen::InputReplay::Timing::AS_FAST_AS_POSSIBLE : Evergreen::InputReplay::Timing::RECORDED, replayQuit);
+		else if (!recordFile.empty())
+			app->StartInputRecording(recordFile);
+
 		app->Run();
 	}
     catch (const Evergreen::BaseException& e)
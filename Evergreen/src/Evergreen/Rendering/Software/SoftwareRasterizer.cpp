@@ -0,0 +1,777 @@
+#include "pch.h"
+#include "SoftwareRasterizer.h"
+#include "Evergreen/Utils/JobSystem.h"
+
+#include <chrono>
+#include <cmath>
+
+// EG_RASTER_NO_SIMD forces the scalar span blending, so that tests can check it produces the same pixels as SSE2
+#if (defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)) && !defined(EG_RASTER_NO_SIMD)
+	#include <emmintrin.h>
+	#define EG_RASTER_SSE2
+#endif
+
+namespace Evergreen
+{
+// Large enough to contain anything that is drawn, small enough that it can be converted to an int
+static constexpr float NoClipExtent = 1.0e9f;
+
+ND static inline RasterRect Intersect(const RasterRect& a, const RasterRect& b) noexcept
+{
+	return { std::max(a.left, b.left), std::max(a.top, b.top), std::min(a.right, b.right), std::min(a.bottom, b.bottom) };
+}
+ND static inline RasterRect Inflate(const RasterRect& rect, float amount) noexcept
+{
+	return { rect.left - amount, rect.top - amount, rect.right + amount, rect.bottom + amount };
+}
+
+// RasterImage -------------------------------------------------------------------------------------------------------
+RasterImage::RasterImage(uint32_t width, uint32_t height, uint32_t clearColor)
+{
+	Resize(width, height, clearColor);
+}
+void RasterImage::Resize(uint32_t width, uint32_t height, uint32_t clearColor)
+{
+	m_width = width;
+	m_height = height;
+	m_pixels.assign(static_cast<size_t>(width) * height, clearColor);
+}
+void RasterImage::Clear(uint32_t color) noexcept
+{
+	std::fill(m_pixels.begin(), m_pixels.end(), color);
+}
+
+uint32_t RasterImage::Pack(const RasterColor& color) noexcept
+{
+	const float alpha = std::clamp(color.a, 0.0f, 1.0f);
+	auto channel = [](float value) { return static_cast<uint32_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f)); };
+	return channel(color.r * alpha) | (channel(color.g * alpha) << 8) | (channel(color.b * alpha) << 16) | (channel(alpha) << 24);
+}
+
+size_t RasterImage::CountDifferences(const RasterImage& a, const RasterImage& b, uint8_t tolerance) noexcept
+{
+	if (a.m_width != b.m_width || a.m_height != b.m_height)
+		return std::max(a.m_pixels.size(), b.m_pixels.size());
+
+	size_t differences = 0;
+	for (size_t iii = 0; iii < a.m_pixels.size(); ++iii)
+	{
+		const uint32_t pixelA = a.m_pixels[iii];
+		const uint32_t pixelB = b.m_pixels[iii];
+		if (pixelA == pixelB)
+			continue;
+
+		for (unsigned int shift = 0; shift < 32; shift += 8)
+		{
+			const int channelA = static_cast<int>((pixelA >> shift) & 0xFF);
+			const int channelB = static_cast<int>((pixelB >> shift) & 0xFF);
+			if (std::abs(channelA - channelB) > tolerance)
+			{
+				++differences;
+				break;
+			}
+		}
+	}
+	return differences;
+}
+
+// GlyphAtlas --------------------------------------------------------------------------------------------------------
+GlyphAtlas::GlyphAtlas(uint32_t width, uint32_t height) :
+	m_width(width),
+	m_height(height),
+	m_coverage(static_cast<size_t>(width) * height, 0)
+{
+	EG_CORE_ASSERT(width <= UINT16_MAX && height <= UINT16_MAX, "Glyph atlas positions are stored as 16-bit values");
+}
+
+const GlyphAtlasEntry* GlyphAtlas::Find(uint64_t key) const noexcept
+{
+	auto iter = m_entries.find(key);
+	return iter != m_entries.end() ? &iter->second : nullptr;
+}
+
+const GlyphAtlasEntry* GlyphAtlas::Add(uint64_t key, uint32_t width, uint32_t height, int offsetX, int offsetY, const uint8_t* coverage, size_t stride)
+{
+	if (const GlyphAtlasEntry* existing = Find(key))
+		return existing;
+
+	GlyphAtlasEntry entry;
+	entry.offsetX = static_cast<int16_t>(offsetX);
+	entry.offsetY = static_cast<int16_t>(offsetY);
+
+	if (width > 0 && height > 0)
+	{
+		EG_CORE_ASSERT(coverage != nullptr, "No coverage for a glyph with a bitmap");
+
+		// Leave a 1 pixel gap between glyphs
+		if (m_shelfX + width > m_width)
+		{
+			m_shelfY += m_shelfHeight + 1;
+			m_shelfX = 0;
+			m_shelfHeight = 0;
+		}
+		if (width > m_width || m_shelfY + height > m_height)
+			return nullptr;
+
+		entry.x = static_cast<uint16_t>(m_shelfX);
+		entry.y = static_cast<uint16_t>(m_shelfY);
+		entry.width = static_cast<uint16_t>(width);
+		entry.height = static_cast<uint16_t>(height);
+
+		for (uint32_t row = 0; row < height; ++row)
+			std::copy_n(coverage + row * stride, width, m_coverage.data() + static_cast<size_t>(m_shelfY + row) * m_width + m_shelfX);
+
+		m_shelfX += width + 1;
+		m_shelfHeight = std::max(m_shelfHeight, height);
+	}
+
+	return &m_entries.emplace(key, entry).first->second;
+}
+
+void GlyphAtlas::Clear() noexcept
+{
+	m_entries.clear();
+	std::fill(m_coverage.begin(), m_coverage.end(), static_cast<uint8_t>(0));
+	m_shelfX = 0;
+	m_shelfY = 0;
+	m_shelfHeight = 0;
+}
+
+// RasterCommandList -------------------------------------------------------------------------------------------------
+RasterCommandList::RasterCommandList()
+{
+	Clear();
+}
+
+void RasterCommandList::Clear() noexcept
+{
+	m_commands.clear();
+	m_paints.clear();
+	m_clips.clear();
+	m_clipStack.clear();
+	m_glyphs.clear();
+
+	m_clips.push_back({ { -NoClipExtent, -NoClipExtent, NoClipExtent, NoClipExtent }, false });
+}
+
+RasterPaintId RasterCommandList::AddPaint(RasterPaint paint)
+{
+	if (paint.type != RasterPaintType::SOLID)
+	{
+		EG_CORE_ASSERT(!paint.stops.empty(), "A gradient needs at least one stop");
+		std::stable_sort(paint.stops.begin(), paint.stops.end(), [](const RasterGradientStop& a, const RasterGradientStop& b) { return a.position < b.position; });
+	}
+
+	m_paints.push_back(std::move(paint));
+	return static_cast<RasterPaintId>(m_paints.size() - 1);
+}
+RasterPaintId RasterCommandList::AddSolidPaint(const RasterColor& color, float opacity)
+{
+	RasterPaint paint;
+	paint.color = color;
+	paint.opacity = opacity;
+	return AddPaint(std::move(paint));
+}
+
+RasterCommand* RasterCommandList::Add(RasterCommandType type, RasterPaintId paint, float strokeWidth, const RasterRect& bounds)
+{
+	EG_CORE_ASSERT(type == RasterCommandType::DRAW_IMAGE || paint < m_paints.size(), "Invalid paint id");
+
+	const uint32_t clip = m_clipStack.empty() ? 0 : m_clipStack.back();
+	const RasterRect clipped = Intersect(bounds, m_clips[clip].rect);
+	if (clipped.IsEmpty())
+		return nullptr;
+
+	RasterCommand& command = m_commands.emplace_back();
+	command.type = type;
+	command.paint = paint;
+	command.clip = clip;
+	command.strokeWidth = strokeWidth;
+	command.bounds = clipped;
+	return &command;
+}
+
+void RasterCommandList::FillRectangle(const RasterRect& rect, RasterPaintId paint)
+{
+	if (RasterCommand* command = Add(RasterCommandType::FILL_RECTANGLE, paint, 0.0f, rect))
+		command->shape = { rect, 0.0f, 0.0f };
+}
+void RasterCommandList::DrawRectangle(const RasterRect& rect, RasterPaintId paint, float strokeWidth)
+{
+	if (RasterCommand* command = Add(RasterCommandType::DRAW_RECTANGLE, paint, strokeWidth, Inflate(rect, strokeWidth / 2.0f)))
+		command->shape = { rect, 0.0f, 0.0f };
+}
+// Shapes that are antialiased with a distance estimate can touch pixels up to half a pixel outside of their edge
+void RasterCommandList::FillRoundedRectangle(const RasterRect& rect, float radiusX, float radiusY, RasterPaintId paint)
+{
+	if (RasterCommand* command = Add(RasterCommandType::FILL_ROUNDED_RECTANGLE, paint, 0.0f, Inflate(rect, 0.5f)))
+		command->shape = { rect, radiusX, radiusY };
+}
+void RasterCommandList::DrawRoundedRectangle(const RasterRect& rect, float radiusX, float radiusY, RasterPaintId paint, float strokeWidth)
+{
+	if (RasterCommand* command = Add(RasterCommandType::DRAW_ROUNDED_RECTANGLE, paint, strokeWidth, Inflate(rect, strokeWidth / 2.0f + 0.5f)))
+		command->shape = { rect, radiusX, radiusY };
+}
+void RasterCommandList::FillEllipse(float centerX, float centerY, float radiusX, float radiusY, RasterPaintId paint)
+{
+	const RasterRect rect = { centerX - radiusX, centerY - radiusY, centerX + radiusX, centerY + radiusY };
+	if (RasterCommand* command = Add(RasterCommandType::FILL_ELLIPSE, paint, 0.0f, Inflate(rect, 0.5f)))
+		command->shape = { rect, radiusX, radiusY };
+}
+void RasterCommandList::DrawEllipse(float centerX, float centerY, float radiusX, float radiusY, RasterPaintId paint, float strokeWidth)
+{
+	const RasterRect rect = { centerX - radiusX, centerY - radiusY, centerX + radiusX, centerY + radiusY };
+	if (RasterCommand* command = Add(RasterCommandType::DRAW_ELLIPSE, paint, strokeWidth, Inflate(rect, strokeWidth / 2.0f + 0.5f)))
+		command->shape = { rect, radiusX, radiusY };
+}
+void RasterCommandList::DrawLine(float x0, float y0, float x1, float y1, RasterPaintId paint, float strokeWidth)
+{
+	if (x0 == x1 && y0 == y1)
+		return;
+
+	const RasterRect bounds = Inflate({ std::min(x0, x1), std::min(y0, y1), std::max(x0, x1), std::max(y0, y1) }, strokeWidth / 2.0f + 0.5f);
+	if (RasterCommand* command = Add(RasterCommandType::DRAW_LINE, paint, strokeWidth, bounds))
+		command->line = { x0, y0, x1, y1 };
+}
+void RasterCommandList::DrawImage(const RasterImage& image, const RasterRect& dest, const RasterRect& source, float opacity)
+{
+	if (image.Width() == 0 || image.Height() == 0 || source.IsEmpty())
+		return;
+
+	if (RasterCommand* command = Add(RasterCommandType::DRAW_IMAGE, 0, 0.0f, dest))
+		command->image = { &image, dest, source, opacity };
+}
+void RasterCommandList::DrawGlyphs(const GlyphAtlas& atlas, std::span<const RasterGlyph> glyphs, RasterPaintId paint)
+{
+	const size_t first = m_glyphs.size();
+	RasterRect bounds = { NoClipExtent, NoClipExtent, -NoClipExtent, -NoClipExtent };
+
+	for (const RasterGlyph& glyph : glyphs)
+	{
+		const GlyphAtlasEntry* entry = atlas.Find(glyph.key);
+		if (entry == nullptr || entry->width == 0)
+			continue;
+
+		RasterGlyphQuad& quad = m_glyphs.emplace_back();
+		quad.x = static_cast<int32_t>(std::lround(glyph.x)) + entry->offsetX;
+		quad.y = static_cast<int32_t>(std::lround(glyph.y)) + entry->offsetY;
+		quad.entry = *entry;
+
+		bounds.left = std::min(bounds.left, static_cast<float>(quad.x));
+		bounds.top = std::min(bounds.top, static_cast<float>(quad.y));
+		bounds.right = std::max(bounds.right, static_cast<float>(quad.x + entry->width));
+		bounds.bottom = std::max(bounds.bottom, static_cast<float>(quad.y + entry->height));
+	}
+
+	RasterCommand* command = m_glyphs.size() > first ? Add(RasterCommandType::DRAW_GLYPHS, paint, 0.0f, bounds) : nullptr;
+	if (command == nullptr)
+	{
+		m_glyphs.resize(first);
+		return;
+	}
+	command->glyphs = { &atlas, static_cast<uint32_t>(first), static_cast<uint32_t>(m_glyphs.size() - first) };
+}
+
+void RasterCommandList::PushClip(const RasterRect& rect, bool antialias)
+{
+	// An aliased clip keeps the pixels whose centers are inside of it
+	RasterRect clipRect = rect;
+	if (!antialias)
+		clipRect = { std::round(rect.left), std::round(rect.top), std::round(rect.right), std::round(rect.bottom) };
+
+	const RasterClip& parent = m_clips[m_clipStack.empty() ? 0 : m_clipStack.back()];
+	m_clips.push_back({ Intersect(parent.rect, clipRect), parent.antialias || antialias });
+	m_clipStack.push_back(static_cast<uint32_t>(m_clips.size() - 1));
+}
+void RasterCommandList::PopClip()
+{
+	EG_CORE_ASSERT(!m_clipStack.empty(), "PopClip without a matching PushClip");
+	if (!m_clipStack.empty())
+		m_clipStack.pop_back();
+}
+
+// Coverage ----------------------------------------------------------------------------------------------------------
+// Fraction of the pixel [pixel, pixel + 1) that is inside [low, high)
+ND static inline float Overlap(float low, float high, float pixel) noexcept
+{
+	return std::clamp(std::min(high, pixel + 1.0f) - std::max(low, pixel), 0.0f, 1.0f);
+}
+ND static inline float RectCoverage(const RasterRect& rect, float x, float y) noexcept
+{
+	return Overlap(rect.left, rect.right, x) * Overlap(rect.top, rect.bottom, y);
+}
+
+// Signed distance from (x, y) to the edge of a rounded rectangle (negative inside). Elliptical corners are handled by
+// scaling y so that they become circular, which is exact for circular corners and close enough for the rest
+ND static float RoundedRectDistance(const RasterCommand::Shape& shape, float x, float y) noexcept
+{
+	const float halfWidth = (shape.rect.right - shape.rect.left) / 2.0f;
+	const float halfHeight = (shape.rect.bottom - shape.rect.top) / 2.0f;
+	const float radiusX = std::clamp(shape.radiusX, 0.0f, halfWidth);
+	const float radiusY = std::clamp(shape.radiusY, 0.0f, halfHeight);
+	const float scale = radiusX > 0.0f && radiusY > 0.0f ? radiusX / radiusY : 1.0f;
+	const float radius = radiusX > 0.0f && radiusY > 0.0f ? radiusX : 0.0f;
+
+	const float dx = std::abs(x - (shape.rect.left + halfWidth)) - (halfWidth - radius);
+	const float dy = (std::abs(y - (shape.rect.top + halfHeight)) - halfHeight) * scale + radius;
+
+	const float outsideX = std::max(dx, 0.0f);
+	const float outsideY = std::max(dy, 0.0f);
+	return std::sqrt(outsideX * outsideX + outsideY * outsideY) + std::min(std::max(dx, dy), 0.0f) - radius;
+}
+// Approximate signed distance to the edge of an ellipse (see https://iquilezles.org/articles/ellipsedist)
+ND static float EllipseDistance(const RasterCommand::Shape& shape, float x, float y) noexcept
+{
+	const float radiusX = std::max(shape.radiusX, 1.0e-3f);
+	const float radiusY = std::max(shape.radiusY, 1.0e-3f);
+	const float px = x - (shape.rect.left + shape.rect.right) / 2.0f;
+	const float py = y - (shape.rect.top + shape.rect.bottom) / 2.0f;
+
+	const float k0 = std::sqrt((px * px) / (radiusX * radiusX) + (py * py) / (radiusY * radiusY));
+	const float k1 = std::sqrt((px * px) / (radiusX * radiusX * radiusX * radiusX) + (py * py) / (radiusY * radiusY * radiusY * radiusY));
+	return k1 > 0.0f ? k0 * (k0 - 1.0f) / k1 : -std::min(radiusX, radiusY);
+}
+ND static inline float FillCoverage(float distance) noexcept
+{
+	return std::clamp(0.5f - distance, 0.0f, 1.0f);
+}
+// Strokes thinner than a pixel fade out instead of getting thinner
+ND static inline float StrokeCoverage(float distance, float strokeWidth) noexcept
+{
+	return std::min(std::clamp(strokeWidth / 2.0f + 0.5f - std::abs(distance), 0.0f, 1.0f), std::min(strokeWidth, 1.0f));
+}
+
+// Blending ----------------------------------------------------------------------------------------------------------
+// dst = src * coverage + dst * (1 - srcAlpha * coverage), where src is premultiplied and in [0, 255]. 'sourceStride'
+// is 0 when every pixel uses the same color, or 4 when 'source' holds one color per pixel
+static void BlendSpan(uint32_t* dst, const float* coverage, const float* source, size_t sourceStride, uint32_t count) noexcept
+{
+#ifdef EG_RASTER_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 inverse255 = _mm_set1_ps(1.0f / 255.0f);
+
+	for (uint32_t iii = 0; iii < count; ++iii, source += sourceStride)
+	{
+		const float pixelCoverage = coverage[iii];
+		if (pixelCoverage <= 0.0f)
+			continue;
+
+		const __m128 src = _mm_mul_ps(_mm_loadu_ps(source), _mm_set1_ps(pixelCoverage));
+		const __m128 srcAlpha = _mm_shuffle_ps(src, src, _MM_SHUFFLE(3, 3, 3, 3));
+
+		// Opaque and fully covered: no need to read the destination
+		__m128 result = src;
+		if (_mm_cvtss_f32(srcAlpha) < 255.0f)
+		{
+			__m128i pixel = _mm_cvtsi32_si128(static_cast<int>(dst[iii]));
+			pixel = _mm_unpacklo_epi16(_mm_unpacklo_epi8(pixel, zero), zero);
+			const __m128 dstColor = _mm_cvtepi32_ps(pixel);
+			result = _mm_add_ps(src, _mm_mul_ps(dstColor, _mm_sub_ps(one, _mm_mul_ps(srcAlpha, inverse255))));
+		}
+
+		__m128i packed = _mm_cvtps_epi32(result);
+		packed = _mm_packs_epi32(packed, packed);
+		packed = _mm_packus_epi16(packed, packed);
+		dst[iii] = static_cast<uint32_t>(_mm_cvtsi128_si32(packed));
+	}
+#else
+	for (uint32_t iii = 0; iii < count; ++iii, source += sourceStride)
+	{
+		const float pixelCoverage = coverage[iii];
+		if (pixelCoverage <= 0.0f)
+			continue;
+
+		const float inverseAlpha = 1.0f - source[3] * pixelCoverage * (1.0f / 255.0f);
+		uint32_t result = 0;
+		for (unsigned int channel = 0; channel < 4; ++channel)
+		{
+			const float dstChannel = static_cast<float>((dst[iii] >> (channel * 8)) & 0xFF);
+			// Round half to even, like _mm_cvtps_epi32, so both paths produce the same image
+			const float value = std::nearbyint(source[channel] * pixelCoverage + dstChannel * inverseAlpha);
+			result |= static_cast<uint32_t>(std::clamp(value, 0.0f, 255.0f)) << (channel * 8);
+		}
+		dst[iii] = result;
+	}
+#endif
+}
+
+ND static inline std::array<float, 4> Unpack(uint32_t pixel) noexcept
+{
+	return { static_cast<float>(pixel & 0xFF), static_cast<float>((pixel >> 8) & 0xFF), static_cast<float>((pixel >> 16) & 0xFF), static_cast<float>(pixel >> 24) };
+}
+
+// Bilinear sample of a premultiplied image at (u, v), in pixels, clamped to the edges of the image
+ND static std::array<float, 4> SampleBilinear(const RasterImage& image, float u, float v) noexcept
+{
+	const float x = u - 0.5f;
+	const float y = v - 0.5f;
+	const float floorX = std::floor(x);
+	const float floorY = std::floor(y);
+	const float fractionX = x - floorX;
+	const float fractionY = y - floorY;
+
+	const int maxX = static_cast<int>(image.Width()) - 1;
+	const int maxY = static_cast<int>(image.Height()) - 1;
+	const uint32_t x0 = static_cast<uint32_t>(std::clamp(static_cast<int>(floorX), 0, maxX));
+	const uint32_t x1 = static_cast<uint32_t>(std::clamp(static_cast<int>(floorX) + 1, 0, maxX));
+	const uint32_t y0 = static_cast<uint32_t>(std::clamp(static_cast<int>(floorY), 0, maxY));
+	const uint32_t y1 = static_cast<uint32_t>(std::clamp(static_cast<int>(floorY) + 1, 0, maxY));
+
+	const std::array<float, 4> topLeft = Unpack(image.Pixel(x0, y0));
+	const std::array<float, 4> topRight = Unpack(image.Pixel(x1, y0));
+	const std::array<float, 4> bottomLeft = Unpack(image.Pixel(x0, y1));
+	const std::array<float, 4> bottomRight = Unpack(image.Pixel(x1, y1));
+
+	std::array<float, 4> result;
+	for (unsigned int channel = 0; channel < 4; ++channel)
+	{
+		const float top = topLeft[channel] + (topRight[channel] - topLeft[channel]) * fractionX;
+		const float bottom = bottomLeft[channel] + (bottomRight[channel] - bottomLeft[channel]) * fractionX;
+		result[channel] = top + (bottom - top) * fractionY;
+	}
+	return result;
+}
+
+// SoftwareRasterizer ------------------------------------------------------------------------------------------------
+SoftwareRasterizer::SoftwareRasterizer(JobSystem* jobSystem) noexcept :
+	m_jobSystem(jobSystem)
+{}
+
+void SoftwareRasterizer::PreparePaints(const RasterCommandList& commands)
+{
+	std::span<const RasterPaint> paints = commands.Paints();
+	m_preparedPaints.resize(paints.size());
+	m_ramps.clear();
+
+	auto premultiply = [](const RasterColor& color, float opacity) -> std::array<float, 4>
+	{
+		const float alpha = std::clamp(color.a * opacity, 0.0f, 1.0f);
+		return { std::clamp(color.r, 0.0f, 1.0f) * alpha * 255.0f, std::clamp(color.g, 0.0f, 1.0f) * alpha * 255.0f,
+			std::clamp(color.b, 0.0f, 1.0f) * alpha * 255.0f, alpha * 255.0f };
+	};
+
+	for (size_t iii = 0; iii < paints.size(); ++iii)
+	{
+		const RasterPaint& paint = paints[iii];
+		PreparedPaint& prepared = m_preparedPaints[iii];
+
+		if (paint.type == RasterPaintType::SOLID)
+		{
+			prepared.color = premultiply(paint.color, paint.opacity);
+			prepared.rampOffset = 0;
+			continue;
+		}
+
+		// Gradients are looked up in a 256 entry ramp instead of interpolating the stops at every pixel. Stops are
+		// interpolated with straight alpha, then premultiplied
+		prepared.color = {};
+		prepared.rampOffset = static_cast<uint32_t>(m_ramps.size());
+
+		const std::vector<RasterGradientStop>& stops = paint.stops;
+		size_t stop = 0;
+		for (unsigned int entry = 0; entry < 256; ++entry)
+		{
+			const float t = entry / 255.0f;
+			while (stop + 1 < stops.size() && stops[stop + 1].position <= t)
+				++stop;
+
+			RasterColor color = stops[stop].color;
+			if (t > stops[stop].position && stop + 1 < stops.size())
+			{
+				const RasterGradientStop& next = stops[stop + 1];
+				const float span = next.position - stops[stop].position;
+				const float blend = span > 0.0f ? (t - stops[stop].position) / span : 1.0f;
+				color.r += (next.color.r - color.r) * blend;
+				color.g += (next.color.g - color.g) * blend;
+				color.b += (next.color.b - color.b) * blend;
+				color.a += (next.color.a - color.a) * blend;
+			}
+			m_ramps.push_back(premultiply(color, paint.opacity));
+		}
+	}
+}
+
+void SoftwareRasterizer::Rasterize(const RasterCommandList& commands, RasterImage& target)
+{
+	using clock = std::chrono::steady_clock;
+	const clock::time_point start = clock::now();
+
+	std::span<const RasterCommand> commandSpan = commands.Commands();
+
+	m_stats = {};
+	m_stats.commands = commandSpan.size();
+
+	const uint32_t width = target.Width();
+	const uint32_t height = target.Height();
+	m_tilesX = (width + TileSize - 1) / TileSize;
+	m_tilesY = (height + TileSize - 1) / TileSize;
+	m_stats.tiles = static_cast<size_t>(m_tilesX) * m_tilesY;
+	if (m_stats.tiles == 0 || commandSpan.empty())
+		return;
+
+	// Binning - every command is added to the bin of each tile its bounds overlap. The bins are kept between frames,
+	// so they only allocate when a tile gets more commands than it ever had
+	m_bins.resize(m_stats.tiles);
+	for (std::vector<uint32_t>& bin : m_bins)
+		bin.clear();
+
+	for (size_t iii = 0; iii < commandSpan.size(); ++iii)
+	{
+		const RasterRect& bounds = commandSpan[iii].bounds;
+		const uint32_t x0 = static_cast<uint32_t>(std::clamp(std::floor(bounds.left), 0.0f, static_cast<float>(width)));
+		const uint32_t y0 = static_cast<uint32_t>(std::clamp(std::floor(bounds.top), 0.0f, static_cast<float>(height)));
+		const uint32_t x1 = static_cast<uint32_t>(std::clamp(std::ceil(bounds.right), 0.0f, static_cast<float>(width)));
+		const uint32_t y1 = static_cast<uint32_t>(std::clamp(std::ceil(bounds.bottom), 0.0f, static_cast<float>(height)));
+		if (x0 >= x1 || y0 >= y1)
+			continue;
+
+		for (uint32_t tileY = y0 / TileSize; tileY <= (y1 - 1) / TileSize; ++tileY)
+		{
+			for (uint32_t tileX = x0 / TileSize; tileX <= (x1 - 1) / TileSize; ++tileX)
+				m_bins[static_cast<size_t>(tileY) * m_tilesX + tileX].push_back(static_cast<uint32_t>(iii));
+		}
+	}
+
+	m_tilesToDraw.clear();
+	for (size_t iii = 0; iii < m_bins.size(); ++iii)
+	{
+		if (!m_bins[iii].empty())
+		{
+			m_tilesToDraw.push_back(static_cast<uint32_t>(iii));
+			m_stats.binEntries += m_bins[iii].size();
+		}
+	}
+	m_stats.tilesDrawn = m_tilesToDraw.size();
+
+	PreparePaints(commands);
+
+	const clock::time_point binned = clock::now();
+
+	// Tiles cover disjoint pixels and only read the commands, so they can be rasterized in any order on any thread
+	auto rasterizeTiles = [this, &commands, &target](size_t begin, size_t end)
+	{
+		for (size_t iii = begin; iii < end; ++iii)
+			RasterizeTile(commands, target, m_tilesToDraw[iii]);
+	};
+
+	if (m_jobSystem != nullptr)
+		m_jobSystem->ParallelFor(0, m_tilesToDraw.size(), 1, rasterizeTiles);
+	else
+		rasterizeTiles(0, m_tilesToDraw.size());
+
+	const clock::time_point finished = clock::now();
+	m_stats.binMilliseconds = std::chrono::duration<double, std::milli>(binned - start).count();
+	m_stats.rasterMilliseconds = std::chrono::duration<double, std::milli>(finished - binned).count();
+	m_stats.totalMilliseconds = std::chrono::duration<double, std::milli>(finished - start).count();
+}
+
+void SoftwareRasterizer::RasterizeTile(const RasterCommandList& commands, RasterImage& target, uint32_t tileIndex) const noexcept
+{
+	std::span<const RasterCommand> commandSpan = commands.Commands();
+	std::span<const RasterClip> clips = commands.Clips();
+	std::span<const RasterGlyphQuad> glyphs = commands.Glyphs();
+
+	const uint32_t tileX0 = (tileIndex % m_tilesX) * TileSize;
+	const uint32_t tileY0 = (tileIndex / m_tilesX) * TileSize;
+	const uint32_t tileX1 = std::min(tileX0 + TileSize, target.Width());
+	const uint32_t tileY1 = std::min(tileY0 + TileSize, target.Height());
+
+	// Scratch for one row of the tile
+	float coverage[TileSize];
+	float colors[TileSize * 4];
+
+	for (uint32_t commandIndex : m_bins[tileIndex])
+	{
+		const RasterCommand& command = commandSpan[commandIndex];
+		const uint32_t x0 = std::max(tileX0, static_cast<uint32_t>(std::max(std::floor(command.bounds.left), 0.0f)));
+		const uint32_t y0 = std::max(tileY0, static_cast<uint32_t>(std::max(std::floor(command.bounds.top), 0.0f)));
+		const uint32_t x1 = std::min(tileX1, static_cast<uint32_t>(std::clamp(std::ceil(command.bounds.right), 0.0f, static_cast<float>(tileX1))));
+		const uint32_t y1 = std::min(tileY1, static_cast<uint32_t>(std::clamp(std::ceil(command.bounds.bottom), 0.0f, static_cast<float>(tileY1))));
+		if (x0 >= x1 || y0 >= y1)
+			continue;
+
+		const uint32_t count = x1 - x0;
+		const RasterClip& clip = clips[command.clip];
+		const bool clipCoverage = command.clip != 0 && clip.antialias;
+
+		const PreparedPaint* paint = command.type != RasterCommandType::DRAW_IMAGE ? &m_preparedPaints[command.paint] : nullptr;
+		const RasterPaint* paintDesc = paint != nullptr ? &commands.Paints()[command.paint] : nullptr;
+		const bool gradient = paintDesc != nullptr && paintDesc->type != RasterPaintType::SOLID;
+
+		// Writes the paint's color for each pixel of the row into 'colors' (gradients only)
+		auto shadeGradient = [&](uint32_t begin, uint32_t pixelCount, float y)
+		{
+			const std::array<float, 4>* ramp = &m_ramps[paint->rampOffset];
+			const float gx0 = paintDesc->point0[0];
+			const float gy0 = paintDesc->point0[1];
+			const float gx1 = paintDesc->point1[0];
+			const float gy1 = paintDesc->point1[1];
+
+			for (uint32_t iii = 0; iii < pixelCount; ++iii)
+			{
+				const float x = static_cast<float>(begin + iii) + 0.5f;
+				float t;
+				if (paintDesc->type == RasterPaintType::LINEAR_GRADIENT)
+				{
+					const float dx = gx1 - gx0;
+					const float dy = gy1 - gy0;
+					const float lengthSquared = dx * dx + dy * dy;
+					t = lengthSquared > 0.0f ? ((x - gx0) * dx + (y - gy0) * dy) / lengthSquared : 0.0f;
+				}
+				else
+				{
+					const float rx = (x - gx0) / std::max(gx1, 1.0e-3f);
+					const float ry = (y - gy0) / std::max(gy1, 1.0e-3f);
+					t = std::sqrt(rx * rx + ry * ry);
+				}
+				const std::array<float, 4>& color = ramp[static_cast<size_t>(std::clamp(t, 0.0f, 1.0f) * 255.0f + 0.5f)];
+				std::copy(color.begin(), color.end(), colors + iii * 4);
+			}
+		};
+
+		// Blends the row segment [begin, begin + pixelCount) using the paint and coverage[0, pixelCount)
+		auto fill = [&](uint32_t* row, uint32_t begin, uint32_t pixelCount, float y)
+		{
+			if (clipCoverage)
+			{
+				for (uint32_t iii = 0; iii < pixelCount; ++iii)
+					coverage[iii] *= RectCoverage(clip.rect, static_cast<float>(begin + iii), y - 0.5f);
+			}
+
+			if (gradient)
+			{
+				shadeGradient(begin, pixelCount, y);
+				BlendSpan(row + begin, coverage, colors, 4, pixelCount);
+			}
+			else
+			{
+				BlendSpan(row + begin, coverage, paint->color.data(), 0, pixelCount);
+			}
+		};
+
+		for (uint32_t y = y0; y < y1; ++y)
+		{
+			uint32_t* row = target.Row(y);
+			const float pixelY = static_cast<float>(y);
+			const float centerY = pixelY + 0.5f;
+
+			switch (command.type)
+			{
+			case RasterCommandType::FILL_RECTANGLE:
+			{
+				const float rowCoverage = Overlap(command.shape.rect.top, command.shape.rect.bottom, pixelY);
+				for (uint32_t iii = 0; iii < count; ++iii)
+					coverage[iii] = rowCoverage * Overlap(command.shape.rect.left, command.shape.rect.right, static_cast<float>(x0 + iii));
+				fill(row, x0, count, centerY);
+				break;
+			}
+			case RasterCommandType::DRAW_RECTANGLE:
+			{
+				// Area between the outer and inner edges of the stroke
+				const float halfWidth = command.strokeWidth / 2.0f;
+				const RasterRect outer = Inflate(command.shape.rect, halfWidth);
+				const RasterRect inner = Inflate(command.shape.rect, -halfWidth);
+				for (uint32_t iii = 0; iii < count; ++iii)
+				{
+					const float x = static_cast<float>(x0 + iii);
+					coverage[iii] = RectCoverage(outer, x, pixelY) - (inner.IsEmpty() ? 0.0f : RectCoverage(inner, x, pixelY));
+				}
+				fill(row, x0, count, centerY);
+				break;
+			}
+			case RasterCommandType::FILL_ROUNDED_RECTANGLE:
+				for (uint32_t iii = 0; iii < count; ++iii)
+					coverage[iii] = FillCoverage(RoundedRectDistance(command.shape, static_cast<float>(x0 + iii) + 0.5f, centerY));
+				fill(row, x0, count, centerY);
+				break;
+
+			case RasterCommandType::DRAW_ROUNDED_RECTANGLE:
+				for (uint32_t iii = 0; iii < count; ++iii)
+					coverage[iii] = StrokeCoverage(RoundedRectDistance(command.shape, static_cast<float>(x0 + iii) + 0.5f, centerY), command.strokeWidth);
+				fill(row, x0, count, centerY);
+				break;
+
+			case RasterCommandType::FILL_ELLIPSE:
+				for (uint32_t iii = 0; iii < count; ++iii)
+					coverage[iii] = FillCoverage(EllipseDistance(command.shape, static_cast<float>(x0 + iii) + 0.5f, centerY));
+				fill(row, x0, count, centerY);
+				break;
+
+			case RasterCommandType::DRAW_ELLIPSE:
+				for (uint32_t iii = 0; iii < count; ++iii)
+					coverage[iii] = StrokeCoverage(EllipseDistance(command.shape, static_cast<float>(x0 + iii) + 0.5f, centerY), command.strokeWidth);
+				fill(row, x0, count, centerY);
+				break;
+
+			case RasterCommandType::DRAW_LINE:
+			{
+				// Distance to a box around the segment, which gives the line flat caps
+				const RasterCommand::Line& line = command.line;
+				const float dx = line.x1 - line.x0;
+				const float dy = line.y1 - line.y0;
+				const float length = std::sqrt(dx * dx + dy * dy);
+				const float directionX = dx / length;
+				const float directionY = dy / length;
+				const float halfWidth = command.strokeWidth / 2.0f;
+
+				for (uint32_t iii = 0; iii < count; ++iii)
+				{
+					const float px = static_cast<float>(x0 + iii) + 0.5f - line.x0;
+					const float py = centerY - line.y0;
+					const float along = px * directionX + py * directionY;
+					const float across = std::abs(px * directionY - py * directionX);
+					const float distance = std::max(across - halfWidth, std::max(-along, along - length));
+					coverage[iii] = std::min(FillCoverage(distance), std::min(command.strokeWidth, 1.0f));
+				}
+				fill(row, x0, count, centerY);
+				break;
+			}
+			case RasterCommandType::DRAW_IMAGE:
+			{
+				const RasterCommand::Image& image = command.image;
+				const float scaleX = (image.source.right - image.source.left) / (image.dest.right - image.dest.left);
+				const float scaleY = (image.source.bottom - image.source.top) / (image.dest.bottom - image.dest.top);
+				const float v = image.source.top + (centerY - image.dest.top) * scaleY;
+				const float rowCoverage = Overlap(image.dest.top, image.dest.bottom, pixelY) * image.opacity;
+
+				for (uint32_t iii = 0; iii < count; ++iii)
+				{
+					const float x = static_cast<float>(x0 + iii);
+					coverage[iii] = rowCoverage * Overlap(image.dest.left, image.dest.right, x);
+					if (clipCoverage)
+						coverage[iii] *= RectCoverage(clip.rect, x, pixelY);
+
+					const float u = image.source.left + (x + 0.5f - image.dest.left) * scaleX;
+					const std::array<float, 4> color = SampleBilinear(*image.image, u, v);
+					std::copy(color.begin(), color.end(), colors + iii * 4);
+				}
+				BlendSpan(row + x0, coverage, colors, 4, count);
+				break;
+			}
+			case RasterCommandType::DRAW_GLYPHS:
+			{
+				const GlyphAtlas& atlas = *command.glyphs.atlas;
+				for (const RasterGlyphQuad& quad : glyphs.subspan(command.glyphs.first, command.glyphs.count))
+				{
+					const int32_t glyphRow = static_cast<int32_t>(y) - quad.y;
+					if (glyphRow < 0 || glyphRow >= quad.entry.height)
+						continue;
+
+					const uint32_t begin = static_cast<uint32_t>(std::max(static_cast<int32_t>(x0), quad.x));
+					const uint32_t end = static_cast<uint32_t>(std::min(static_cast<int32_t>(x1), quad.x + quad.entry.width));
+					if (begin >= end)
+						continue;
+
+					for (uint32_t x = begin; x < end; ++x)
+						coverage[x - begin] = atlas.Coverage(quad.entry.x + static_cast<uint32_t>(static_cast<int32_t>(x) - quad.x), quad.entry.y + static_cast<uint32_t>(glyphRow)) / 255.0f;
+					fill(row, begin, end - begin, centerY);
+				}
+				break;
+			}
+			}
+		}
+	}
+}
+
+}
@@ -0,0 +1,319 @@
+#pragma once
+#include "pch.h"
+#include "Evergreen/Core.h"
+
+#include <span>
+#include <unordered_map>
+
+// CPU rendering backend. A RasterCommandList holds resolved drawing operations (filled/stroked rectangles, rounded
+// rectangles and ellipses, lines, images and glyph runs from a GlyphAtlas), painted with a solid color or a linear/radial
+// gradient. SoftwareRasterizer::Rasterize bins the commands into TileSize x TileSize screen tiles, then rasterizes the
+// tiles in parallel on the JobSystem. Each tile walks its bin in command order, so the result matches drawing the
+// commands one by one. Shapes are antialiased analytically (exact area coverage for axis-aligned rectangles, a distance
+// estimate for everything else) and spans are blended with SSE2 when it is available.
+//
+// The output is a RasterImage: an in-memory, premultiplied RGBA8 image that can be compared against a golden image
+// (see RasterImage::CountDifferences) or timed per frame (see SoftwareRasterizerStats).
+//
+// NOTE: Like JobSystem, this file only uses the C++20 standard library (no Windows APIs), so the rasterizer can be used
+//       from any subsystem, including ones that are compiled without the rest of the engine. Translating the UI's
+//       DrawList, whose commands refer to Direct2D brushes and DirectWrite layouts, is done by DrawListRasterizer.
+namespace Evergreen
+{
+class JobSystem;
+
+struct RasterColor
+{
+	float r = 0.0f;
+	float g = 0.0f;
+	float b = 0.0f;
+	float a = 1.0f;		// Straight (not premultiplied) alpha
+};
+
+// No default member initializers, so that it can be used in RasterCommand's union
+struct RasterRect
+{
+	float left;
+	float top;
+	float right;
+	float bottom;
+
+	ND inline bool IsEmpty() const noexcept { return right <= left || bottom <= top; }
+};
+
+// Drop this warning because the private members are not accessible by the client application, but
+// the compiler will complain that they don't have a DLL interface
+// See: https://stackoverflow.com/questions/767579/exporting-classes-containing-std-objects-vector-map-etc-from-a-dll
+#pragma warning( push )
+#pragma warning( disable : 4251 ) // needs to have dll-interface to be used by clients of class
+
+// Premultiplied RGBA8 pixels, stored row by row with red in the lowest byte (the memory layout of DXGI_FORMAT_R8G8B8A8_UNORM)
+class EVERGREEN_API RasterImage
+{
+public:
+	RasterImage() noexcept = default;
+	RasterImage(uint32_t width, uint32_t height, uint32_t clearColor = 0);
+
+	void Resize(uint32_t width, uint32_t height, uint32_t clearColor = 0);
+	void Clear(uint32_t color) noexcept;
+
+	ND inline uint32_t Width() const noexcept { return m_width; }
+	ND inline uint32_t Height() const noexcept { return m_height; }
+	ND inline uint32_t* Row(uint32_t y) noexcept { return m_pixels.data() + static_cast<size_t>(y) * m_width; }
+	ND inline const uint32_t* Row(uint32_t y) const noexcept { return m_pixels.data() + static_cast<size_t>(y) * m_width; }
+	ND inline uint32_t Pixel(uint32_t x, uint32_t y) const noexcept { return Row(y)[x]; }
+	ND inline std::span<const uint32_t> Pixels() const noexcept { return m_pixels; }
+
+	// Packs a straight-alpha color into a premultiplied RGBA8 pixel
+	ND static uint32_t Pack(const RasterColor& color) noexcept;
+
+	// Number of pixels where any channel differs by more than 'tolerance'. Images of different sizes differ everywhere
+	ND static size_t CountDifferences(const RasterImage& a, const RasterImage& b, uint8_t tolerance = 0) noexcept;
+
+private:
+	uint32_t m_width = 0;
+	uint32_t m_height = 0;
+	std::vector<uint32_t> m_pixels;
+};
+
+struct GlyphAtlasEntry
+{
+	uint16_t x = 0;			// Position of the glyph's bitmap in the atlas
+	uint16_t y = 0;
+	uint16_t width = 0;		// 0 for glyphs with nothing to draw (ex. spaces)
+	uint16_t height = 0;
+	int16_t offsetX = 0;	// From the glyph's baseline origin to the top left of its bitmap
+	int16_t offsetY = 0;
+};
+
+// 8-bit coverage bitmaps of rasterized glyphs, packed into a single image with a shelf allocator. Keys are chosen by
+// whoever rasterizes the glyphs (ex. a hash of the font, size and glyph index). The atlas never evicts - once it is
+// full, Add fails and the glyph is not drawn
+class EVERGREEN_API GlyphAtlas
+{
+public:
+	GlyphAtlas(uint32_t width = 1024, uint32_t height = 1024);
+	GlyphAtlas(const GlyphAtlas&) = delete;
+	GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+	ND const GlyphAtlasEntry* Find(uint64_t key) const noexcept;
+	// Copies a width x height coverage bitmap into the atlas. Returns nullptr if it does not fit
+	const GlyphAtlasEntry* Add(uint64_t key, uint32_t width, uint32_t height, int offsetX, int offsetY, const uint8_t* coverage, size_t stride);
+	void Clear() noexcept;
+
+	ND inline uint32_t Width() const noexcept { return m_width; }
+	ND inline uint32_t Height() const noexcept { return m_height; }
+	ND inline uint8_t Coverage(uint32_t x, uint32_t y) const noexcept { return m_coverage[static_cast<size_t>(y) * m_width + x]; }
+	ND inline size_t GlyphCount() const noexcept { return m_entries.size(); }
+
+private:
+	uint32_t m_width;
+	uint32_t m_height;
+	std::vector<uint8_t> m_coverage;
+	std::unordered_map<uint64_t, GlyphAtlasEntry> m_entries;
+
+	// Glyphs are placed left to right on the current shelf, and a new shelf is started below it when one does not fit
+	uint32_t m_shelfX = 0;
+	uint32_t m_shelfY = 0;
+	uint32_t m_shelfHeight = 0;
+};
+
+struct RasterGradientStop
+{
+	float position = 0.0f;
+	RasterColor color;
+};
+
+enum class RasterPaintType : uint8_t
+{
+	SOLID,
+	LINEAR_GRADIENT,	// From point0 to point1. Clamped outside of that range
+	RADIAL_GRADIENT		// Centered on point0, with point1 as the x/y radii
+};
+
+struct RasterPaint
+{
+	RasterPaintType type = RasterPaintType::SOLID;
+	RasterColor color;		// Only used by SOLID
+	float opacity = 1.0f;
+	float point0[2] = {};
+	float point1[2] = {};
+	std::vector<RasterGradientStop> stops;
+};
+using RasterPaintId = uint32_t;
+
+// Pen position of a glyph (its baseline origin) and its key in the GlyphAtlas
+struct RasterGlyph
+{
+	float x = 0.0f;
+	float y = 0.0f;
+	uint64_t key = 0;
+};
+
+enum class RasterCommandType : uint8_t
+{
+	FILL_RECTANGLE,
+	DRAW_RECTANGLE,
+	FILL_ROUNDED_RECTANGLE,
+	DRAW_ROUNDED_RECTANGLE,
+	FILL_ELLIPSE,
+	DRAW_ELLIPSE,
+	DRAW_LINE,
+	DRAW_IMAGE,
+	DRAW_GLYPHS
+};
+
+struct RasterCommand
+{
+	struct Shape
+	{
+		RasterRect rect;	// Ellipses use their bounding box
+		float radiusX;
+		float radiusY;
+	};
+	struct Line
+	{
+		float x0, y0, x1, y1;
+	};
+	struct Image
+	{
+		const RasterImage* image;
+		RasterRect dest;
+		RasterRect source;
+		float opacity;
+	};
+	struct Glyphs
+	{
+		const GlyphAtlas* atlas;
+		uint32_t first;		// Range in RasterCommandList::Glyphs()
+		uint32_t count;
+	};
+
+	RasterCommandType type;
+	RasterPaintId paint;		// Not used by DRAW_IMAGE
+	uint32_t clip;				// Index into RasterCommandList::Clips(), resolved when the command was recorded
+	float strokeWidth;			// Only used by the DRAW_* shapes
+	RasterRect bounds;			// Every pixel the command can touch, already clipped
+	union
+	{
+		Shape shape;
+		Line line;
+		Image image;
+		Glyphs glyphs;
+	};
+};
+static_assert(std::is_trivially_copyable_v<RasterCommand>, "RasterCommand must stay plain data");
+
+struct RasterClip
+{
+	RasterRect rect;
+	bool antialias;		// Otherwise, the rect is snapped to whole pixels
+};
+
+// Positioned glyph, as stored by the command list
+struct RasterGlyphQuad
+{
+	int32_t x;			// Top left of the glyph's bitmap on the target
+	int32_t y;
+	GlyphAtlasEntry entry;
+};
+
+// Drawing operations for the SoftwareRasterizer. The clip stack is resolved as commands are recorded: each command
+// stores the intersection of the clips that were pushed, and commands that are clipped away entirely are dropped.
+// Paints are registered once and referred to by id, so many commands can share one gradient.
+//
+// NOTE: Images and glyph atlases are not copied - they must outlive the call to SoftwareRasterizer::Rasterize
+class EVERGREEN_API RasterCommandList
+{
+public:
+	RasterCommandList();
+	RasterCommandList(const RasterCommandList&) = delete;
+	RasterCommandList& operator=(const RasterCommandList&) = delete;
+
+	RasterPaintId AddPaint(RasterPaint paint);
+	RasterPaintId AddSolidPaint(const RasterColor& color, float opacity = 1.0f);
+
+	void FillRectangle(const RasterRect& rect, RasterPaintId paint);
+	void DrawRectangle(const RasterRect& rect, RasterPaintId paint, float strokeWidth = 1.0f);
+	void FillRoundedRectangle(const RasterRect& rect, float radiusX, float radiusY, RasterPaintId paint);
+	void DrawRoundedRectangle(const RasterRect& rect, float radiusX, float radiusY, RasterPaintId paint, float strokeWidth = 1.0f);
+	void FillEllipse(float centerX, float centerY, float radiusX, float radiusY, RasterPaintId paint);
+	void DrawEllipse(float centerX, float centerY, float radiusX, float radiusY, RasterPaintId paint, float strokeWidth = 1.0f);
+	void DrawLine(float x0, float y0, float x1, float y1, RasterPaintId paint, float strokeWidth = 1.0f);
+	// Draws the 'source' region of 'image' stretched over 'dest' with bilinear filtering
+	void DrawImage(const RasterImage& image, const RasterRect& dest, const RasterRect& source, float opacity = 1.0f);
+	// Glyphs are snapped to whole pixels. Glyphs that are not in the atlas are skipped
+	void DrawGlyphs(const GlyphAtlas& atlas, std::span<const RasterGlyph> glyphs, RasterPaintId paint);
+	void PushClip(const RasterRect& rect, bool antialias = true);
+	void PopClip();
+
+	void Clear() noexcept;
+
+	ND inline std::span<const RasterCommand> Commands() const noexcept { return m_commands; }
+	ND inline std::span<const RasterPaint> Paints() const noexcept { return m_paints; }
+	ND inline std::span<const RasterClip> Clips() const noexcept { return m_clips; }
+	ND inline std::span<const RasterGlyphQuad> Glyphs() const noexcept { return m_glyphs; }
+	ND inline size_t Size() const noexcept { return m_commands.size(); }
+	ND inline size_t ClipDepth() const noexcept { return m_clipStack.size(); }
+
+private:
+	// Returns nullptr if the command would be clipped away entirely
+	RasterCommand* Add(RasterCommandType type, RasterPaintId paint, float strokeWidth, const RasterRect& bounds);
+
+	std::vector<RasterCommand>		m_commands;
+	std::vector<RasterPaint>		m_paints;
+	std::vector<RasterClip>			m_clips;		// m_clips[0] is "no clip"
+	std::vector<uint32_t>			m_clipStack;	// Indices into m_clips
+	std::vector<RasterGlyphQuad>	m_glyphs;
+};
+
+struct SoftwareRasterizerStats
+{
+	size_t commands = 0;
+	size_t tiles = 0;
+	size_t tilesDrawn = 0;			// Tiles with at least one command
+	size_t binEntries = 0;			// Sum of the number of commands in each tile
+	double binMilliseconds = 0.0;
+	double rasterMilliseconds = 0.0;
+	double totalMilliseconds = 0.0;
+};
+
+class EVERGREEN_API SoftwareRasterizer
+{
+public:
+	static constexpr uint32_t TileSize = 64;
+
+	// Without a JobSystem, the tiles are rasterized on the calling thread
+	SoftwareRasterizer(JobSystem* jobSystem = nullptr) noexcept;
+	SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+	SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+
+	// Draws 'commands' over the current contents of 'target'
+	void Rasterize(const RasterCommandList& commands, RasterImage& target);
+
+	ND inline const SoftwareRasterizerStats& GetStats() const noexcept { return m_stats; }
+
+private:
+	// Premultiplied color (0-255 per channel) of a solid paint, or where the 256 entry ramp of a gradient starts
+	struct PreparedPaint
+	{
+		std::array<float, 4> color;
+		uint32_t rampOffset;		// Into m_ramps
+	};
+
+	void PreparePaints(const RasterCommandList& commands);
+	void RasterizeTile(const RasterCommandList& commands, RasterImage& target, uint32_t tileIndex) const noexcept;
+
+	JobSystem* m_jobSystem;
+	SoftwareRasterizerStats m_stats;
+
+	uint32_t m_tilesX = 0;
+	uint32_t m_tilesY = 0;
+	std::vector<std::vector<uint32_t>> m_bins;	// Command indices per tile, in command order
+	std::vector<uint32_t> m_tilesToDraw;
+	std::vector<PreparedPaint> m_preparedPaints;
+	std::vector<std::array<float, 4>> m_ramps;
+};
+#pragma warning( pop )
+
+}
@@ -11,7 +11,8 @@ BitmapBrush::BitmapBrush(std::shared_ptr<DeviceResources> deviceResources, const
 	m_bitmapBrushProperties(properties),
 	m_bitmapFileName(filename),
 	m_transformMethod(method),
-	m_bitmap(nullptr)
+	m_bitmap(nullptr),
+	m_bitmapMemory(MemoryCategory::BITMAPS)
 {
 	// Enforce the brush to be created with a file specified
 	EG_CORE_ASSERT(m_bitmapFileName.size() > 0, "File not specified");
@@ -26,7 +27,8 @@ BitmapBrush::BitmapBrush(const BitmapBrush& rhs) :
 	m_bitmapBrushProperties(rhs.m_bitmapBrushProperties),
 	m_bitmapFileName(rhs.m_bitmapFileName),
 	m_transformMethod(rhs.m_transformMethod),
-	m_bitmap(nullptr)
+	m_bitmap(nullptr),
+	m_bitmapMemory(MemoryCategory::BITMAPS)
 {
 	LoadBitmapFile();
 	TransformToRect();
@@ -105,6 +107,10 @@ void BitmapBrush::LoadBitmapFile()
 			m_bitmap.ReleaseAndGetAddressOf()
 		)
 	)
+
+	// The pixels were converted to 32bpp PBGRA above
+	const D2D1_SIZE_U size = m_bitmap->GetPixelSize();
+	m_bitmapMemory.Set(static_cast<size_t>(size.width) * size.height * 4);
 }
 
 void BitmapBrush::Refresh()
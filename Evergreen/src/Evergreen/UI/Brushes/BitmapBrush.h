@@ -55,6 +55,7 @@ private:
 	D2D1_BITMAP_BRUSH_PROPERTIES			m_bitmapBrushProperties;
 	TRANSFORM_TO_RECT_METHOD				m_transformMethod;
 	Microsoft::WRL::ComPtr<ID2D1Bitmap1>	m_bitmap;
+	ExternalMemory							m_bitmapMemory;
 
 
 };
@@ -34,6 +34,18 @@ ColorBrush& ColorBrush::operator=(const ColorBrush& rhs) noexcept
 	return *this;
 }
 
+void* ColorBrush::operator new(size_t size)
+{
+	void* p = ::operator new(size);
+	MemoryAccounting::TrackAllocation(MemoryCategory::BRUSHES, size);
+	return p;
+}
+void ColorBrush::operator delete(void* p, size_t size) noexcept
+{
+	MemoryAccounting::TrackDeallocation(MemoryCategory::BRUSHES, size);
+	::operator delete(p);
+}
+
 ID2D1Brush* ColorBrush::Get() const noexcept 
 { 
 	// This should never be called if the brush has not been initialized
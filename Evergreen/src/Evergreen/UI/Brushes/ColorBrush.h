@@ -3,6 +3,7 @@
 #include "Evergreen/Core.h"
 #include "Evergreen/Log.h"
 #include "Evergreen/Rendering/DeviceResources.h"
+#include "Evergreen/Utils/MemoryAccounting.h"
 
 namespace Evergreen
 {
@@ -20,6 +21,11 @@ public:
 	ColorBrush& operator=(const ColorBrush&) noexcept;
 	virtual ~ColorBrush() noexcept {}
 
+	// Brushes are accounted under MemoryCategory::BRUSHES. This covers the brush objects themselves - the Direct2D
+	// brushes do not report their size
+	static void* operator new(size_t size);
+	static void operator delete(void* p, size_t size) noexcept;
+
 	ND inline std::shared_ptr<DeviceResources> GetDeviceResources() const noexcept { return m_deviceResources; }
 	ND inline ID2D1Brush* Get() const noexcept;
 
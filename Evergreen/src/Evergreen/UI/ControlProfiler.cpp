@@ -0,0 +1,246 @@
+#include "pch.h"
+#include "ControlProfiler.h"
+#include "Controls/Control.h"
+#include "Layout.h"
+
+namespace Evergreen
+{
+bool ControlProfiler::s_enabled = false;
+
+static const char* ControlTypeName(Control::ControlType type) noexcept
+{
+	switch (type)
+	{
+	case Control::ControlType::Button:				return "Button";
+	case Control::ControlType::RoundedButton:		return "RoundedButton";
+	case Control::ControlType::Pane:				return "Pane";
+	case Control::ControlType::RadioButton:			return "RadioButton";
+	case Control::ControlType::Rectangle:			return "Rectangle";
+	case Control::ControlType::ScrollableLayout:	return "ScrollableLayout";
+	case Control::ControlType::SliderFloat:			return "SliderFloat";
+	case Control::ControlType::SliderInt:			return "SliderInt";
+	case Control::ControlType::Text:				return "Text";
+	case Control::ControlType::TextInput:			return "TextInput";
+	case Control::ControlType::Viewport:			return "Viewport";
+	}
+	return "Unknown";
+}
+
+static uint64_t NanosecondsBetween(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) noexcept
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+ControlProfiler& ControlProfiler::Get() noexcept
+{
+	static ControlProfiler profiler;
+	return profiler;
+}
+
+void ControlProfiler::Enable(bool enable) noexcept
+{
+	if (enable && !IsCompiledIn())
+		EG_CORE_WARN("{}:{} - ControlProfiler enabled, but Evergreen was built without EG_ENABLE_UI_PROFILING, so no controls will be measured", __FILE__, __LINE__);
+
+	Get().Clear();
+	s_enabled = enable;
+}
+void ControlProfiler::SetWindowFramesImpl(unsigned int frames) noexcept
+{
+	m_windowFrames = std::max(frames, 1u);
+	Clear();
+}
+void ControlProfiler::Clear() noexcept
+{
+	m_entries.clear();
+	m_entryIndices.clear();
+	m_openScopes.clear();
+	m_frame = 0;
+}
+
+uint32_t ControlProfiler::FindOrAddEntry(const void* object) noexcept
+{
+	auto iter = m_entryIndices.find(object);
+	if (iter != m_entryIndices.end())
+		return iter->second;
+
+	const uint32_t index = static_cast<uint32_t>(m_entries.size());
+	Entry& entry = m_entries.emplace_back();
+	entry.object = object;
+	entry.lastSeenFrame = UINT64_MAX;
+	entry.updateHistory.resize(m_windowFrames, 0);
+	entry.renderHistory.resize(m_windowFrames, 0);
+
+	m_entryIndices.emplace(object, index);
+	return index;
+}
+
+void ControlProfiler::Begin(const Control* control, const Layout* layout, Phase phase) noexcept
+{
+	// Take the start time first, so that the bookkeeping below is charged to this control rather than to its parent
+	const auto start = std::chrono::steady_clock::now();
+
+	const uint32_t index = FindOrAddEntry(control != nullptr ? static_cast<const void*>(control) : static_cast<const void*>(layout));
+	Entry& entry = m_entries[index];
+
+	// Refresh the description once per frame. This also handles a new control that was allocated at the address of
+	// a deleted one
+	if (entry.lastSeenFrame != m_frame)
+	{
+		entry.lastSeenFrame = m_frame;
+		if (control != nullptr)
+		{
+			entry.name = control->Name();
+			entry.type = ControlTypeName(control->GetControlType());
+			entry.bounds = control->AllowedRegion();
+		}
+		else
+		{
+			entry.name = layout->Name();
+			entry.type = "Layout";
+			entry.bounds = D2D1::RectF(layout->Left(), layout->Top(), layout->Left() + layout->Width(), layout->Top() + layout->Height());
+		}
+	}
+
+	m_openScopes.push_back({ index, phase, start, 0 });
+}
+void ControlProfiler::End() noexcept
+{
+	const auto end = std::chrono::steady_clock::now();
+
+	// The profiler may have been disabled/cleared while this scope was open
+	if (m_openScopes.empty())
+		return;
+
+	const OpenScope scope = m_openScopes.back();
+	m_openScopes.pop_back();
+
+	const uint64_t elapsed = NanosecondsBetween(scope.start, end);
+	const uint64_t self = elapsed > scope.childNs ? elapsed - scope.childNs : 0;
+
+	Entry& entry = m_entries[scope.entry];
+	if (scope.phase == Phase::UPDATE)
+		entry.updateNs += self;
+	else
+		entry.renderNs += self;
+
+	if (!m_openScopes.empty())
+		m_openScopes.back().childNs += NanosecondsBetween(scope.start, std::chrono::steady_clock::now());
+}
+
+void ControlProfiler::EndFrameImpl() noexcept
+{
+	EG_CORE_ASSERT(m_openScopes.empty(), "EndFrame should not be called from within a control's Update/Render");
+
+	const size_t slot = static_cast<size_t>(m_frame % m_windowFrames);
+
+	for (size_t iii = 0; iii < m_entries.size();)
+	{
+		Entry& entry = m_entries[iii];
+
+		// Drop controls that have not been seen for a whole window - they have most likely been deleted
+		if (m_frame - entry.lastSeenFrame >= m_windowFrames)
+		{
+			m_entryIndices.erase(entry.object);
+			if (iii != m_entries.size() - 1)
+			{
+				entry = std::move(m_entries.back());
+				m_entryIndices[entry.object] = static_cast<uint32_t>(iii);
+			}
+			m_entries.pop_back();
+			continue;
+		}
+
+		const uint32_t updateNs = static_cast<uint32_t>(std::min<uint64_t>(entry.updateNs, UINT32_MAX));
+		const uint32_t renderNs = static_cast<uint32_t>(std::min<uint64_t>(entry.renderNs, UINT32_MAX));
+
+		entry.updateSum -= entry.updateHistory[slot];
+		entry.updateSum += updateNs;
+		entry.updateHistory[slot] = updateNs;
+
+		entry.renderSum -= entry.renderHistory[slot];
+		entry.renderSum += renderNs;
+		entry.renderHistory[slot] = renderNs;
+
+		entry.updateNs = 0;
+		entry.renderNs = 0;
+		++iii;
+	}
+
+	++m_frame;
+}
+
+std::vector<ControlCost> ControlProfiler::GetCostsImpl() const noexcept
+{
+	std::vector<ControlCost> costs;
+
+	const unsigned int frames = FramesInWindow();
+	if (frames == 0)
+		return costs;
+
+	const double nsPerFrameToMs = 1.0 / (1'000'000.0 * frames);
+
+	costs.reserve(m_entries.size());
+	for (const Entry& entry : m_entries)
+	{
+		ControlCost& cost = costs.emplace_back();
+		cost.name = entry.name;
+		cost.type = entry.type;
+		cost.bounds = entry.bounds;
+		cost.count = 1;
+		cost.updateMs = entry.updateSum * nsPerFrameToMs;
+		cost.renderMs = entry.renderSum * nsPerFrameToMs;
+		cost.totalMs = cost.updateMs + cost.renderMs;
+
+		uint64_t peakNs = 0;
+		for (size_t iii = 0; iii < entry.updateHistory.size(); ++iii)
+			peakNs = std::max<uint64_t>(peakNs, static_cast<uint64_t>(entry.updateHistory[iii]) + entry.renderHistory[iii]);
+		cost.peakMs = peakNs / 1'000'000.0;
+	}
+
+	std::sort(costs.begin(), costs.end(), [](const ControlCost& lhs, const ControlCost& rhs) { return lhs.totalMs > rhs.totalMs; });
+	return costs;
+}
+std::vector<ControlCost> ControlProfiler::GetCostsByTypeImpl() const noexcept
+{
+	std::vector<ControlCost> costs;
+
+	const unsigned int frames = FramesInWindow();
+	if (frames == 0)
+		return costs;
+
+	const double nsPerFrameToMs = 1.0 / (1'000'000.0 * frames);
+
+	// Per type: the summed cost, and the summed per-frame history so the peak is the most expensive frame for the
+	// type as a whole
+	std::vector<std::vector<uint64_t>> histories;
+	for (const Entry& entry : m_entries)
+	{
+		auto iter = std::find_if(costs.begin(), costs.end(), [&entry](const ControlCost& cost) { return cost.type == entry.type; });
+		if (iter == costs.end())
+		{
+			costs.emplace_back().type = entry.type;
+			histories.emplace_back(m_windowFrames, 0);
+			iter = costs.end() - 1;
+		}
+
+		std::vector<uint64_t>& history = histories[iter - costs.begin()];
+		for (size_t iii = 0; iii < history.size(); ++iii)
+			history[iii] += static_cast<uint64_t>(entry.updateHistory[iii]) + entry.renderHistory[iii];
+
+		++iter->count;
+		iter->updateMs += entry.updateSum * nsPerFrameToMs;
+		iter->renderMs += entry.renderSum * nsPerFrameToMs;
+	}
+
+	for (size_t iii = 0; iii < costs.size(); ++iii)
+	{
+		costs[iii].totalMs = costs[iii].updateMs + costs[iii].renderMs;
+		costs[iii].peakMs = *std::max_element(histories[iii].begin(), histories[iii].end()) / 1'000'000.0;
+	}
+
+	std::sort(costs.begin(), costs.end(), [](const ControlCost& lhs, const ControlCost& rhs) { return lhs.totalMs > rhs.totalMs; });
+	return costs;
+}
+
+}
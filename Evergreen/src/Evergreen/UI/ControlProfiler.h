@@ -0,0 +1,163 @@
+#pragma once
+#include "pch.h"
+#include "Evergreen/Core.h"
+
+#include <chrono>
+#include <unordered_map>
+
+// Per-control cost attribution. When EG_ENABLE_UI_PROFILING is defined, Control::Update, every Control::Render override
+// and Layout::Render open a ControlProfiler::Scope, which does nothing beyond checking a flag until profiling is turned
+// on at runtime (ControlProfiler::Enable, or UI::ShowProfilerOverlay). When EG_ENABLE_UI_PROFILING is not defined, the
+// EG_PROFILE_* macros expand to nothing and there is no cost at all.
+//
+// Times are self times: time spent in a nested control/layout is charged to it and not to its parent, so a Button is
+// not blamed for the Text inside of it. Render times are the CPU cost of recording the control's draw commands (see
+// DrawList) - replaying them, and the GPU work that happens at EndDraw, is not attributed to any control.
+#ifdef EG_ENABLE_UI_PROFILING
+	#define EG_PROFILE_CONTROL_UPDATE(control) Evergreen::ControlProfiler::Scope CAT(egProfileScope, __LINE__)(control, Evergreen::ControlProfiler::Phase::UPDATE)
+	#define EG_PROFILE_CONTROL_RENDER(control) Evergreen::ControlProfiler::Scope CAT(egProfileScope, __LINE__)(control, Evergreen::ControlProfiler::Phase::RENDER)
+	#define EG_PROFILE_LAYOUT_RENDER(layout) Evergreen::ControlProfiler::Scope CAT(egProfileScope, __LINE__)(layout, Evergreen::ControlProfiler::Phase::RENDER)
+#else
+	#define EG_PROFILE_CONTROL_UPDATE(control)
+	#define EG_PROFILE_CONTROL_RENDER(control)
+	#define EG_PROFILE_LAYOUT_RENDER(layout)
+#endif
+
+namespace Evergreen
+{
+class Control;
+class Layout;
+
+// Cost of a control (or of all controls of a type, see ControlProfiler::GetCostsByType), averaged over the frames in
+// the profiler's window
+struct EVERGREEN_API ControlCost
+{
+	std::string name;
+	std::string type;
+	D2D1_RECT_F bounds = {};	// Where the control was last laid out. Empty for per-type costs
+	unsigned int count = 0;		// Number of controls combined into this entry
+	double updateMs = 0.0;		// Average self time per frame
+	double renderMs = 0.0;
+	double totalMs = 0.0;
+	double peakMs = 0.0;		// Most expensive single frame (update + render) in the window
+};
+
+// Drop this warning because the private members are not accessible by the client application, but
+// the compiler will complain that they don't have a DLL interface
+// See: https://stackoverflow.com/questions/767579/exporting-classes-containing-std-objects-vector-map-etc-from-a-dll
+#pragma warning( push )
+#pragma warning( disable : 4251 ) // needs to have dll-interface to be used by clients of class
+class EVERGREEN_API ControlProfiler
+{
+public:
+	enum class Phase
+	{
+		UPDATE,
+		RENDER
+	};
+
+	class Scope
+	{
+	public:
+		Scope(const Control* control, Phase phase) noexcept : m_active(s_enabled) { if (m_active) Get().Begin(control, nullptr, phase); }
+		Scope(const Layout* layout, Phase phase) noexcept : m_active(s_enabled) { if (m_active) Get().Begin(nullptr, layout, phase); }
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+		~Scope() noexcept { if (m_active) Get().End(); }
+
+	private:
+		bool m_active;
+	};
+
+	// Keeps anything rendered/updated within its lifetime (ex. the profiler overlay itself) out of the results
+	class Suspend
+	{
+	public:
+		Suspend() noexcept : m_wasEnabled(s_enabled) { s_enabled = false; }
+		Suspend(const Suspend&) = delete;
+		Suspend& operator=(const Suspend&) = delete;
+		~Suspend() noexcept { s_enabled = m_wasEnabled; }
+
+	private:
+		bool m_wasEnabled;
+	};
+
+	// Enabling or disabling clears all results
+	static void Enable(bool enable) noexcept;
+	ND static inline bool IsEnabled() noexcept { return s_enabled; }
+	ND static constexpr bool IsCompiledIn() noexcept
+	{
+#ifdef EG_ENABLE_UI_PROFILING
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	// Number of frames the results are averaged over (default: 120)
+	static void SetWindowFrames(unsigned int frames) noexcept { Get().SetWindowFramesImpl(frames); }
+	ND static inline unsigned int GetWindowFrames() noexcept { return Get().m_windowFrames; }
+
+	// Called by UI once per frame, after everything has been rendered
+	static void EndFrame() noexcept { if (s_enabled) Get().EndFrameImpl(); }
+
+	// One entry per control/layout, most expensive first
+	ND static std::vector<ControlCost> GetCosts() noexcept { return Get().GetCostsImpl(); }
+	// One entry per control type (plus "Layout"), most expensive first
+	ND static std::vector<ControlCost> GetCostsByType() noexcept { return Get().GetCostsByTypeImpl(); }
+
+private:
+	ControlProfiler() noexcept = default;
+	ControlProfiler(const ControlProfiler&) = delete;
+	ControlProfiler& operator=(const ControlProfiler&) = delete;
+
+	static ControlProfiler& Get() noexcept;
+
+	struct Entry
+	{
+		const void* object = nullptr;
+		std::string name;
+		std::string type;
+		D2D1_RECT_F bounds = {};
+		uint64_t lastSeenFrame = 0;
+
+		// Nanoseconds spent in the current frame
+		uint64_t updateNs = 0;
+		uint64_t renderNs = 0;
+
+		// Rolling window of per-frame times (ring buffer indexed by frame % window), and their sums
+		std::vector<uint32_t> updateHistory;
+		std::vector<uint32_t> renderHistory;
+		uint64_t updateSum = 0;
+		uint64_t renderSum = 0;
+	};
+
+	struct OpenScope
+	{
+		uint32_t entry;
+		Phase phase;
+		std::chrono::steady_clock::time_point start;
+		uint64_t childNs;
+	};
+
+	void Begin(const Control* control, const Layout* layout, Phase phase) noexcept;
+	void End() noexcept;
+	uint32_t FindOrAddEntry(const void* object) noexcept;
+	void Clear() noexcept;
+	void SetWindowFramesImpl(unsigned int frames) noexcept;
+	void EndFrameImpl() noexcept;
+	ND std::vector<ControlCost> GetCostsImpl() const noexcept;
+	ND std::vector<ControlCost> GetCostsByTypeImpl() const noexcept;
+	ND unsigned int FramesInWindow() const noexcept { return static_cast<unsigned int>(std::min<uint64_t>(m_frame, m_windowFrames)); }
+
+	static bool s_enabled;
+
+	std::vector<Entry> m_entries;
+	std::unordered_map<const void*, uint32_t> m_entryIndices;
+	std::vector<OpenScope> m_openScopes;
+	unsigned int m_windowFrames = 120;
+	uint64_t m_frame = 0;
+};
+#pragma warning( pop )
+
+}
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "Button.h"
 #include "Text.h"
+#include "Evergreen/UI/UI.h"
 
 namespace Evergreen
 {
@@ -45,6 +46,10 @@ Button::Button(std::shared_ptr<DeviceResources> deviceResources,
 
 	ButtonChanged();
 }
+Button::~Button() noexcept
+{
+	StopBackgroundAnimation();
+}
 void Button::OnUpdate(const Timer& timer)
 {
 	m_layout->Update(timer);
@@ -52,6 +57,7 @@ void Button::OnUpdate(const Timer& timer)
 
 void Button::Render() const
 {
+	EG_PROFILE_CONTROL_RENDER(this);
 	if (m_cornerRadiusX > 0.0f && m_cornerRadiusY > 0.0f)
 		RenderRoundedRect();
 	else
@@ -64,10 +70,10 @@ void Button::RenderRect() const
 	EG_CORE_ASSERT(m_backgroundBrush != nullptr, "No background brush");
 	EG_CORE_ASSERT(m_borderBrush != nullptr, "No border brush");
 
-	auto context = m_deviceResources->D2DDeviceContext();
+	DrawList& drawList = m_ui->GetDrawList();
 
 	// Draw the background
-	context->FillRectangle(m_backgroundRect, m_backgroundBrush->Get());
+	drawList.FillRectangle(m_backgroundRect, m_backgroundBrush->Get());
 
 	// Have the layout draw the background and contents of the brush
 	m_layout->Render();
@@ -83,7 +89,7 @@ void Button::RenderRect() const
 		// If the offsets are 0, then just draw the complete border
 		if (m_borderTopLeftOffsetY == 0.0f && m_borderBottomLeftOffsetY == 0.0f)
 		{
-			context->DrawLine(
+			drawList.DrawLine(
 				D2D1::Point2F(left, top),		// top-left
 				D2D1::Point2F(left, bottom),	// bottom-left
 				m_borderBrush->Get(),
@@ -92,13 +98,13 @@ void Button::RenderRect() const
 		}
 		else
 		{
-			context->DrawLine(
+			drawList.DrawLine(
 				D2D1::Point2F(left, top),							// top-left
 				D2D1::Point2F(left, top + m_borderTopLeftOffsetY),	// stop point from the top
 				m_borderBrush->Get(),
 				m_borderWidths[0]
 			);
-			context->DrawLine(
+			drawList.DrawLine(
 				D2D1::Point2F(left, bottom),								// bottom-left
 				D2D1::Point2F(left, bottom - m_borderBottomLeftOffsetY),	// stop point from the bottom
 				m_borderBrush->Get(),
@@ -111,7 +117,7 @@ void Button::RenderRect() const
 		// If the offsets are 0, then just draw the complete border
 		if (m_borderTopLeftOffsetX == 0.0f && m_borderTopRightOffsetX == 0.0f)
 		{
-			context->DrawLine(
+			drawList.DrawLine(
 				D2D1::Point2F(left, top),	// top-left
 				D2D1::Point2F(right, top),	// top-right
 				m_borderBrush->Get(),
@@ -120,13 +126,13 @@ void Button::RenderRect() const
 		}
 		else
 		{
-			context->DrawLine(
+			drawList.DrawLine(
 				D2D1::Point2F(left, top),							// top-left
 				D2D1::Point2F(left + m_borderTopLeftOffsetX, top),	// stop point from the left
 				m_borderBrush->Get(),
 				m_borderWidths[1]
 			);
-			context->DrawLine(
+			drawList.DrawLine(
 				D2D1::Point2F(right, top),								// top-right
 				D2D1::Point2F(right - m_borderTopRightOffsetX, top),	// stop point from the right
 				m_borderBrush->Get(),
@@ -139,7 +145,7 @@ void Button::RenderRect() const
 		// If the offsets are 0, then just draw the complete border
 		if (m_borderTopRightOffsetY == 0.0f && m_borderBottomRightOffsetY == 0.0f)
 		{
-			context->DrawLine(
+			drawList.DrawLine(
 				D2D1::Point2F(right, top),		// top-right
 				D2D1::Point2F(right, bottom),	// bottom-right
 				m_borderBrush->Get(),
@@ -148,13 +154,13 @@ void Button::RenderRect() const
 		}
 		else
 		{
-			context->DrawLine(
+			drawList.DrawLine(
 				D2D1::Point2F(right, top),								// top-right
 				D2D1::Point2F(right, top + m_borderTopRightOffsetY),	// stop point from the top
 				m_borderBrush->Get(),
 				m_borderWidths[2]
 			);
-			context->DrawLine(
+			drawList.DrawLine(
 				D2D1::Point2F(right, bottom),								// bottom-right
 				D2D1::Point2F(right, bottom - m_borderBottomRightOffsetY),	// stop point from the bottom
 				m_borderBrush->Get(),
@@ -167,7 +173,7 @@ void Button::RenderRect() const
 		// If the offsets are 0, then just draw the complete border
 		if (m_borderBottomLeftOffsetX == 0.0f && m_borderBottomRightOffsetX == 0.0f)
 		{
-			context->DrawLine(
+			drawList.DrawLine(
 				D2D1::Point2F(left, bottom),	// bottom-left
 				D2D1::Point2F(right, bottom),	// bottom-right
 				m_borderBrush->Get(),
@@ -176,13 +182,13 @@ void Button::RenderRect() const
 		}
 		else
 		{
-			context->DrawLine(
+			drawList.DrawLine(
 				D2D1::Point2F(left, bottom),								// bottom-left
 				D2D1::Point2F(left + m_borderBottomLeftOffsetX, bottom),	// stop point from the left
 				m_borderBrush->Get(),
 				m_borderWidths[3]
 			);
-			context->DrawLine(
+			drawList.DrawLine(
 				D2D1::Point2F(right, bottom),								// bottom-right
 				D2D1::Point2F(right - m_borderBottomRightOffsetX, bottom),	// stop point from the right
 				m_borderBrush->Get(),
@@ -198,16 +204,16 @@ void Button::RenderRoundedRect() const
 	EG_CORE_ASSERT(m_backgroundBrush != nullptr, "No background brush");
 	EG_CORE_ASSERT(m_borderBrush != nullptr, "No border brush");
 
-	auto context = m_deviceResources->D2DDeviceContext();
+	DrawList& drawList = m_ui->GetDrawList();
 
-	context->FillRoundedRectangle(m_roundedRect, m_backgroundBrush->Get());
+	drawList.FillRoundedRectangle(m_roundedRect, m_backgroundBrush->Get());
 
 	m_layout->Render();
 
 	// Draw the border last so it appears on top
 	// NOTE: We do NOT support drawing partial borders when drawing a rounded rect, so just use the first border width in the array
 	if (m_borderWidths[0] > 0.0f)
-		context->DrawRoundedRectangle(m_roundedRect, m_borderBrush->Get(), m_borderWidths[0]);
+		drawList.DrawRoundedRectangle(m_roundedRect, m_borderBrush->Get(), m_borderWidths[0]);
 }
 
 void Button::ButtonChanged()
@@ -292,7 +298,7 @@ void Button::OnMouseMove(MouseMoveEvent& e)
 		if (!currentMouseIsOver)
 		{
 			m_mouseIsOver = false;
-			m_OnMouseExited(this, e);
+			m_callbacks.Invoke(OnMouseExitedCallbackSlot, this, e);
 
 			// Only set handled=true if the mouse is down, making it so that another control can not process this event
 			// The button should continue to handle mouse events until the mouse button is released
@@ -303,13 +309,13 @@ void Button::OnMouseMove(MouseMoveEvent& e)
 		}
 
 		// Nothing changed here, just make sure the event is handled and return
-		m_OnMouseMoved(this, e);
+		m_callbacks.Invoke(OnMouseMovedCallbackSlot, this, e);
 		e.Handled(this);
 	}
 	else if (currentMouseIsOver) // Check if the mouse is newly over the button
 	{
 		m_mouseIsOver = true;
-		m_OnMouseEntered(this, e);
+		m_callbacks.Invoke(OnMouseEnteredCallbackSlot, this, e);
 		e.Handled(this);
 	}
 	else if (m_mouseLButtonIsDown)
@@ -323,7 +329,7 @@ void Button::OnMouseMove(MouseMoveEvent& e)
 void Button::MouseMoveHandledByPane(MouseMoveEvent& e)
 {
 	m_mouseIsOver = false;
-	m_OnMouseExited(this, e);
+	m_callbacks.Invoke(OnMouseExitedCallbackSlot, this, e);
 }
 void Button::OnMouseButtonPressed(MouseButtonPressedEvent& e)
 {
@@ -342,7 +348,7 @@ void Button::OnMouseButtonPressed(MouseButtonPressedEvent& e)
 		if (e.GetMouseButton() == MOUSE_BUTTON::EG_LBUTTON)
 		{
 			m_mouseLButtonIsDown = true;
-			m_OnMouseLButtonDown(this, e);
+			m_callbacks.Invoke(OnMouseLButtonDownCallbackSlot, this, e);
 		}
 	}
 }
@@ -363,7 +369,7 @@ void Button::OnMouseButtonReleased(MouseButtonReleasedEvent& e)
 		if (e.GetMouseButton() == MOUSE_BUTTON::EG_LBUTTON)
 		{
 			m_mouseLButtonIsDown = false;
-			m_OnClick(this, e);
+			m_callbacks.Invoke(OnClickCallbackSlot, this, e);
 		}
 	}
 	else
@@ -408,12 +414,31 @@ Control* Button::GetControlByID(unsigned int id) noexcept
 
 void Button::BackgroundBrush(const D2D1_COLOR_F& color)
 {
+	StopBackgroundAnimation();
 	m_backgroundBrush = std::make_unique<SolidColorBrush>(m_deviceResources, color);
 }
 void Button::BackgroundBrush(D2D1::ColorF::Enum color)
 {
+	StopBackgroundAnimation();
 	m_backgroundBrush = std::make_unique<SolidColorBrush>(m_deviceResources, D2D1::ColorF(color));
 }
+void Button::AnimateBackgroundColor(const D2D1_COLOR_F& color, double durationSeconds, Easing easing) noexcept
+{
+	SolidColorBrush* brush = dynamic_cast<SolidColorBrush*>(m_backgroundBrush.get());
+	if (brush == nullptr)
+	{
+		BackgroundBrush(color);
+		return;
+	}
+
+	// The setter looks the brush up each time instead of capturing it, because replacing the brush stops the fade
+	m_ui->GetAnimator().Animate<D2D1_COLOR_F>(this, brush->Color(), color, durationSeconds,
+		[this](const D2D1_COLOR_F& c) { static_cast<SolidColorBrush*>(m_backgroundBrush.get())->Color(c); }, easing);
+}
+void Button::StopBackgroundAnimation() noexcept
+{
+	m_ui->GetAnimator().CancelTarget(this);
+}
 void Button::BackgroundBrushAndTextColor(const D2D1_COLOR_F& buttonColor, const D2D1_COLOR_F& textColor)
 {
 	BackgroundBrush(buttonColor);
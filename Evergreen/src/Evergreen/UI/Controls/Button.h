@@ -4,6 +4,7 @@
 #include "Evergreen/UI/Styles/TextStyle.h"
 #include "Evergreen/UI/Brushes.h"
 #include "Evergreen/UI/Layout.h"
+#include "Evergreen/Utils/Animator.h"
 
 namespace Evergreen
 {
@@ -23,7 +24,7 @@ public:
 		const Evergreen::Margin& margin = { 0 }) noexcept;
 	Button(const Button& text) noexcept = delete; // Just delete for now until there is a good use case
 	Button& operator=(const Button&) noexcept = delete;
-	virtual ~Button() noexcept override {}
+	virtual ~Button() noexcept override;
 
 	// Inherited from Control
 	virtual void OnUpdate(const Timer& timer) override;
@@ -59,7 +60,7 @@ public:
 	ND inline std::array<float, 4> BorderWidth() const noexcept { return m_borderWidths; }
 	ND inline const D2D1_RECT_F& BackgroundRect() const noexcept { return m_backgroundRect; }
 
-	void BackgroundBrush(std::unique_ptr<ColorBrush> brush) noexcept { m_backgroundBrush = std::move(brush); }
+	void BackgroundBrush(std::unique_ptr<ColorBrush> brush) noexcept { StopBackgroundAnimation(); m_backgroundBrush = std::move(brush); }
 	void BorderBrush(std::unique_ptr<ColorBrush> brush) noexcept { m_borderBrush = std::move(brush); }
 	void BorderWidth(float widthAll) noexcept { m_borderWidths.fill(widthAll); }
 	void BorderWidth(const std::array<float, 4>& width) noexcept { m_borderWidths = width; }
@@ -79,11 +80,15 @@ public:
 	inline void BackgroundBrushAndTextColor(const D2D1_COLOR_F& buttonColor, D2D1::ColorF::Enum textColor);
 	inline void BackgroundBrushAndTextColor(D2D1::ColorF::Enum buttonColor, D2D1::ColorF::Enum textColor);
 
-	inline void SetOnMouseEnteredCallback(std::function<void(Button*, MouseMoveEvent&)> func) noexcept { m_OnMouseEntered = func; }
-	inline void SetOnMouseExitedCallback(std::function<void(Button*, MouseMoveEvent&)> func) noexcept { m_OnMouseExited = func; }
-	inline void SetOnMouseMovedCallback(std::function<void(Button*, MouseMoveEvent&)> func) noexcept { m_OnMouseMoved = func; }
-	inline void SetOnMouseLButtonDownCallback(std::function<void(Button*, MouseButtonPressedEvent&)> func) noexcept { m_OnMouseLButtonDown = func; }
-	inline void SetOnClickCallback(std::function<void(Button*, MouseButtonReleasedEvent&)> func) noexcept { m_OnClick = func; }
+	// Fades a solid background to 'color' (see Animator). Any other background brush is replaced immediately. Setting
+	// the background brush directly stops the fade
+	void AnimateBackgroundColor(const D2D1_COLOR_F& color, double durationSeconds = 0.15, Easing easing = Easing::EASE_OUT_QUAD) noexcept;
+
+	inline void SetOnMouseEnteredCallback(std::function<void(Button*, MouseMoveEvent&)> func) noexcept { m_callbacks.Set(OnMouseEnteredCallbackSlot, std::move(func)); }
+	inline void SetOnMouseExitedCallback(std::function<void(Button*, MouseMoveEvent&)> func) noexcept { m_callbacks.Set(OnMouseExitedCallbackSlot, std::move(func)); }
+	inline void SetOnMouseMovedCallback(std::function<void(Button*, MouseMoveEvent&)> func) noexcept { m_callbacks.Set(OnMouseMovedCallbackSlot, std::move(func)); }
+	inline void SetOnMouseLButtonDownCallback(std::function<void(Button*, MouseButtonPressedEvent&)> func) noexcept { m_callbacks.Set(OnMouseLButtonDownCallbackSlot, std::move(func)); }
+	inline void SetOnClickCallback(std::function<void(Button*, MouseButtonReleasedEvent&)> func) noexcept { m_callbacks.Set(OnClickCallbackSlot, std::move(func)); }
 
 	void SetCornerRadius(float xAndY) noexcept { m_cornerRadiusX = xAndY; m_cornerRadiusY = xAndY; ButtonChanged(); }
 	void SetCornerRadius(float x, float y) noexcept { m_cornerRadiusX = x; m_cornerRadiusY = y; ButtonChanged(); }
@@ -99,15 +104,16 @@ public:
 protected:
 	
 	virtual void ButtonChanged();
+	void StopBackgroundAnimation() noexcept;
 
 	virtual void OnMarginChanged() override;
 	virtual void OnAllowedRegionChanged() override;
 
-	std::function<void(Button*, MouseMoveEvent&)> m_OnMouseEntered = [](Button*, MouseMoveEvent&) {};
-	std::function<void(Button*, MouseMoveEvent&)> m_OnMouseExited = [](Button*, MouseMoveEvent&) {};
-	std::function<void(Button*, MouseMoveEvent&)> m_OnMouseMoved = [](Button*, MouseMoveEvent&) {};
-	std::function<void(Button*, MouseButtonPressedEvent&)> m_OnMouseLButtonDown = [](Button*, MouseButtonPressedEvent&) {};
-	std::function<void(Button*, MouseButtonReleasedEvent&)> m_OnClick = [](Button*, MouseButtonReleasedEvent&) {};
+	static constexpr CallbackSlot<void(Button*, MouseMoveEvent&)> OnMouseEnteredCallbackSlot{ FirstDerivedCallbackSlot + 0 };
+	static constexpr CallbackSlot<void(Button*, MouseMoveEvent&)> OnMouseExitedCallbackSlot{ FirstDerivedCallbackSlot + 1 };
+	static constexpr CallbackSlot<void(Button*, MouseMoveEvent&)> OnMouseMovedCallbackSlot{ FirstDerivedCallbackSlot + 2 };
+	static constexpr CallbackSlot<void(Button*, MouseButtonPressedEvent&)> OnMouseLButtonDownCallbackSlot{ FirstDerivedCallbackSlot + 3 };
+	static constexpr CallbackSlot<void(Button*, MouseButtonReleasedEvent&)> OnClickCallbackSlot{ FirstDerivedCallbackSlot + 4 };
 
 	std::unique_ptr<ColorBrush> m_backgroundBrush;
 	std::unique_ptr<ColorBrush> m_borderBrush;
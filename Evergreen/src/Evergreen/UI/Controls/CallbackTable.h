@@ -0,0 +1,291 @@
+#pragma once
+#include "pch.h"
+#include "Evergreen/Core.h"
+#include "Evergreen/Log.h"
+
+#include <bit>
+
+namespace Evergreen
+{
+// Identifies one of a control's callbacks along with its signature, so CallbackTable::Set/Invoke can only be used with
+// the matching function type. Slot 0 belongs to Control (OnUpdate); derived controls number theirs from
+// Control::FirstDerivedCallbackSlot
+template<typename Signature>
+struct CallbackSlot
+{
+	uint8_t Index;
+};
+
+// Sparse storage for a control's callbacks. Only the callbacks that were actually installed take any space: a bit mask
+// records which slots are set and the installed callbacks are kept in slot order, so a callback's position is the
+// number of set bits below its slot. Invoking a slot that was never set is just a bit test - there is no no-op
+// std::function to call.
+//
+// Everything lives in one exactly sized allocation: the std::function's (stored in place - all std::function types
+// have the same size), then the distinct "manage" functions that know how to move/copy/destroy each std::function type,
+// then one byte per callback selecting its manage function. A control's callbacks only use a few signatures, so an
+// installed callback costs one std::function plus a byte, and there is no extra allocation or virtual call per callback.
+//
+// The allocation is rebuilt when a callback is added or removed (replacing one is done in place). Inserting in slot
+// order already moves every later callback, so building the new allocation in that same pass costs nothing extra.
+//
+// Callbacks are invoked in place. A callback may change the table while it runs (including replacing or removing
+// itself), so while any callback is running, Set never moves or destroys a stored function: it copies them into a new
+// allocation instead and keeps the old one alive until the outermost Invoke returns.
+class CallbackTable
+{
+public:
+	static constexpr unsigned int MaxSlots = 32;
+
+	CallbackTable() noexcept = default;
+	CallbackTable(const CallbackTable&) = delete;
+	CallbackTable& operator=(const CallbackTable&) = delete;
+	~CallbackTable() noexcept { Destroy(m_storage.get(), Count(), m_managerCount); }
+
+	// Setting an empty function removes the callback. Safe to call from inside a callback, including to replace or
+	// remove the one that is running (see Invoke)
+	template<typename Signature>
+	void Set(CallbackSlot<Signature> slot, std::function<Signature> fn);
+
+	template<typename Signature, typename... Args>
+	inline void Invoke(CallbackSlot<Signature> slot, Args&&... args) const
+	{
+		if (!IsSet(slot))
+			return;
+
+		InvokeScope scope(*this);
+		(*Function<Signature>(m_storage.get(), Position(slot.Index)))(std::forward<Args>(args)...);
+	}
+
+	template<typename Signature>
+	ND inline bool IsSet(CallbackSlot<Signature> slot) const noexcept { return (m_installed & (1u << slot.Index)) != 0; }
+	ND inline size_t Count() const noexcept { return static_cast<size_t>(std::popcount(m_installed)); }
+	// Heap memory used by the table (not counting anything the callables themselves allocate)
+	ND inline size_t HeapBytes() const noexcept { return m_storage == nullptr ? 0 : StorageBytes(Count(), m_managerCount); }
+
+private:
+	enum class ManageOperation
+	{
+		MOVE,		// Move into 'destination' and destroy the original
+		COPY,		// Copy into 'destination'
+		DESTROY
+	};
+	using ManageFn = void (*)(ManageOperation operation, std::byte* self, std::byte* destination);
+
+	static constexpr size_t FunctionSize = sizeof(std::function<void()>);
+	static constexpr size_t FunctionAlignment = alignof(std::function<void()>);
+	static_assert(FunctionSize % alignof(ManageFn) == 0, "The manage functions are stored right after the std::function's");
+
+	template<typename Signature>
+	static void Manage(ManageOperation operation, std::byte* self, std::byte* destination)
+	{
+		std::function<Signature>* fn = std::launder(reinterpret_cast<std::function<Signature>*>(self));
+		switch (operation)
+		{
+		case ManageOperation::MOVE:
+			::new (destination) std::function<Signature>(std::move(*fn));
+			fn->~function();
+			break;
+		case ManageOperation::COPY:
+			::new (destination) std::function<Signature>(*fn);
+			break;
+		case ManageOperation::DESTROY:
+			fn->~function();
+			break;
+		}
+	}
+
+	ND static inline size_t StorageBytes(size_t count, size_t managerCount) noexcept { return count * FunctionSize + managerCount * sizeof(ManageFn) + count; }
+
+	template<typename Signature>
+	ND static inline std::function<Signature>* Function(std::byte* storage, size_t position) noexcept
+	{
+		return std::launder(reinterpret_cast<std::function<Signature>*>(storage + position * FunctionSize));
+	}
+	ND static inline ManageFn* Managers(std::byte* storage, size_t count) noexcept { return reinterpret_cast<ManageFn*>(storage + count * FunctionSize); }
+	ND static inline uint8_t* ManagerIndices(std::byte* storage, size_t count, size_t managerCount) noexcept { return reinterpret_cast<uint8_t*>(storage + count * FunctionSize + managerCount * sizeof(ManageFn)); }
+
+	static void Destroy(std::byte* storage, size_t count, size_t managerCount) noexcept
+	{
+		if (storage == nullptr)
+			return;
+		ManageFn* managers = Managers(storage, count);
+		uint8_t* indices = ManagerIndices(storage, count, managerCount);
+		for (size_t iii = 0; iii < count; ++iii)
+			managers[indices[iii]](ManageOperation::DESTROY, storage + iii * FunctionSize, nullptr);
+	}
+
+	ND inline size_t Position(uint8_t index) const noexcept { return static_cast<size_t>(std::popcount(m_installed & ((1u << index) - 1u))); }
+
+	// An allocation that was replaced while a callback was running. Destroyed once no callback is running anymore
+	struct RetiredStorage
+	{
+		std::unique_ptr<std::byte[]> Storage;
+		size_t Count;
+		size_t ManagerCount;
+		std::unique_ptr<RetiredStorage> Next;
+
+		~RetiredStorage() noexcept { Destroy(Storage.get(), Count, ManagerCount); }
+	};
+
+	class InvokeScope
+	{
+	public:
+		explicit InvokeScope(const CallbackTable& table) noexcept : m_table(table)
+		{
+			EG_CORE_ASSERT(m_table.m_invokeDepth < UINT16_MAX, "Callbacks nested too deeply");
+			++m_table.m_invokeDepth;
+		}
+		~InvokeScope() noexcept
+		{
+			if (--m_table.m_invokeDepth > 0 || m_table.m_retired == nullptr)
+				return;
+
+			// Take the retired allocations out of the table before destroying them, in case a destructor calls back into it
+			std::unique_ptr<RetiredStorage> retired = std::move(m_table.m_retired);
+		}
+
+	private:
+		const CallbackTable& m_table;
+	};
+
+	std::unique_ptr<std::byte[]> m_storage;
+	mutable std::unique_ptr<RetiredStorage> m_retired;
+	uint32_t m_installed = 0;
+	uint8_t m_managerCount = 0;
+	mutable uint16_t m_invokeDepth = 0;
+};
+
+template<typename Signature>
+void CallbackTable::Set(CallbackSlot<Signature> slot, std::function<Signature> fn)
+{
+	static_assert(sizeof(std::function<Signature>) == FunctionSize && alignof(std::function<Signature>) <= FunctionAlignment,
+		"CallbackTable assumes every std::function has the same size");
+	EG_CORE_ASSERT(slot.Index < MaxSlots, "Callback slot out of range");
+
+	const uint32_t bit = 1u << slot.Index;
+	const bool isSet = (m_installed & bit) != 0;
+	if (!isSet && !fn)
+		return;
+
+	const size_t position = Position(slot.Index);
+	const bool isReplace = isSet && fn;
+
+	// The previous callback is only destroyed when we return, once the table is consistent again, in case its
+	// destructor calls back into the table
+	std::function<Signature> previous;
+
+	// A slot always holds the same std::function type, so replacing a callback never changes the layout. While a
+	// callback is running (possibly this one), the stored functions must stay where they are, so rebuild instead
+	if (isReplace && m_invokeDepth == 0)
+	{
+		std::function<Signature>* existing = Function<Signature>(m_storage.get(), position);
+		previous = std::move(*existing);
+		*existing = std::move(fn);
+		return;
+	}
+
+	const size_t count = Count();
+	const size_t newCount = isReplace ? count : (isSet ? count - 1 : count + 1);
+	std::byte* oldStorage = m_storage.get();
+	ManageFn* oldManagers = oldStorage == nullptr ? nullptr : Managers(oldStorage, count);
+	uint8_t* oldIndices = oldStorage == nullptr ? nullptr : ManagerIndices(oldStorage, count, m_managerCount);
+
+	// Position in the old table of the callback that ends up at 'destination' in the new one (NoSource for the new one)
+	constexpr size_t NoSource = SIZE_MAX;
+	auto source = [isSet, isReplace, position](size_t destination) noexcept -> size_t
+	{
+		if (destination < position)
+			return destination;
+		if (isReplace)
+			return destination == position ? NoSource : destination;
+		if (isSet)
+			return destination + 1;
+		return destination == position ? NoSource : destination - 1;
+	};
+
+	// Assign the manager indices first - the layout depends on how many distinct manage functions are left
+	ManageFn managers[MaxSlots];
+	uint8_t indices[MaxSlots];
+	size_t managerCount = 0;
+	for (size_t destination = 0; destination < newCount; ++destination)
+	{
+		const size_t from = source(destination);
+		const ManageFn manager = from == NoSource ? &Manage<Signature> : oldManagers[oldIndices[from]];
+
+		size_t index = 0;
+		while (index < managerCount && managers[index] != manager)
+			++index;
+		if (index == managerCount)
+			managers[managerCount++] = manager;
+		indices[destination] = static_cast<uint8_t>(index);
+	}
+
+	// Allocate before touching anything, so the table is unchanged if this throws
+	std::unique_ptr<std::byte[]> newStorage = newCount > 0 ? std::make_unique<std::byte[]>(StorageBytes(newCount, managerCount)) : nullptr;
+
+	// While a callback is running, the old allocation has to stay intact, so the callbacks are copied rather than moved
+	// and the old allocation is retired instead of freed. Allocate its record up front as well
+	const bool isInvoking = m_invokeDepth > 0;
+	std::unique_ptr<RetiredStorage> retired = isInvoking && oldStorage != nullptr ? std::make_unique<RetiredStorage>() : nullptr;
+
+	if (newStorage != nullptr)
+	{
+		std::byte* storage = newStorage.get();
+		std::copy(managers, managers + managerCount, Managers(storage, newCount));
+		std::copy(indices, indices + newCount, ManagerIndices(storage, newCount, managerCount));
+
+		// Moving a callback over also destroys it in the old allocation. Copying can throw, in which case the copies
+		// made so far are destroyed and the table is left unchanged
+		const ManageOperation transfer = isInvoking ? ManageOperation::COPY : ManageOperation::MOVE;
+		size_t destination = 0;
+		try
+		{
+			for (; destination < newCount; ++destination)
+			{
+				const size_t from = source(destination);
+				if (from != NoSource)
+					oldManagers[oldIndices[from]](transfer, oldStorage + from * FunctionSize, storage + destination * FunctionSize);
+			}
+		}
+		catch (...)
+		{
+			for (size_t iii = 0; iii < destination; ++iii)
+			{
+				if (source(iii) != NoSource)
+					managers[indices[iii]](ManageOperation::DESTROY, storage + iii * FunctionSize, nullptr);
+			}
+			throw;
+		}
+
+		for (destination = 0; destination < newCount; ++destination)
+		{
+			if (source(destination) == NoSource)
+				::new (storage + destination * FunctionSize) std::function<Signature>(std::move(fn));
+		}
+	}
+
+	std::unique_ptr<std::byte[]> oldOwner = std::move(m_storage);
+	if (retired != nullptr)
+	{
+		// The old allocation still holds every callback (including the one being replaced/removed)
+		retired->Storage = std::move(oldOwner);
+		retired->Count = count;
+		retired->ManagerCount = m_managerCount;
+		retired->Next = std::move(m_retired);
+		m_retired = std::move(retired);
+	}
+	else if (isSet)
+	{
+		// The replaced/removed callback is the only one left in the old allocation
+		previous = std::move(*Function<Signature>(oldStorage, position));
+		oldManagers[oldIndices[position]](ManageOperation::DESTROY, oldStorage + position * FunctionSize, nullptr);
+	}
+
+	m_storage = std::move(newStorage);
+	if (!isReplace)
+		m_installed ^= bit;
+	m_managerCount = static_cast<uint8_t>(managerCount);
+}
+
+}
@@ -21,6 +21,18 @@ Control::Control(std::shared_ptr<DeviceResources> deviceResources,
 	EG_CORE_ASSERT(m_ui != nullptr, "No UI");
 }
 
+void* Control::operator new(size_t size)
+{
+	void* p = ::operator new(size);
+	MemoryAccounting::TrackAllocation(MemoryCategory::UI_TREE, size);
+	return p;
+}
+void Control::operator delete(void* p, size_t size) noexcept
+{
+	MemoryAccounting::TrackDeallocation(MemoryCategory::UI_TREE, size);
+	::operator delete(p);
+}
+
 void Control::Margin(float left, float top, float right, float bottom) noexcept
 {
 	m_margin.Left = left;
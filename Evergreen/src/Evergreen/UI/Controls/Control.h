@@ -4,6 +4,9 @@
 #include "Evergreen/Log.h"
 #include "Evergreen/Rendering/DeviceResources.h"
 #include "Evergreen/Utils/Timer.h"
+#include "CallbackTable.h"
+#include "Evergreen/UI/ControlProfiler.h"
+#include "Evergreen/Utils/MemoryAccounting.h"
 
 namespace Evergreen
 {
@@ -49,10 +52,15 @@ public:
 	Control& operator=(const Control& control) noexcept = delete;
 	virtual ~Control() noexcept {}
 
+	// Controls are accounted under MemoryCategory::UI_TREE
+	static void* operator new(size_t size);
+	static void operator delete(void* p, size_t size) noexcept;
+
 	void Update(const Timer& timer) 
 	{ 
+		EG_PROFILE_CONTROL_UPDATE(this);
 		OnUpdate(timer); 
-		m_CustomOnUpdateCallback(this, timer); 
+		m_callbacks.Invoke(OnUpdateCallbackSlot, this, timer); 
 	}
 protected:
 	virtual void OnUpdate(const Timer& timer) {}
@@ -90,7 +98,7 @@ public:
 	void AllowedRegionRight(float right) noexcept;
 	void AllowedRegionTop(float top) noexcept;
 	void AllowedRegionBottom(float bottom) noexcept;
-	void SetOnUpdateCallback(std::function<void(Control*, const Timer&)> fn) noexcept { m_CustomOnUpdateCallback = fn; }
+	void SetOnUpdateCallback(std::function<void(Control*, const Timer&)> fn) noexcept { m_callbacks.Set(OnUpdateCallbackSlot, std::move(fn)); }
 
 	ND inline const std::string& Name() const noexcept { return m_name; }
 	ND inline unsigned int ID() const noexcept { return m_id; }
@@ -124,7 +132,11 @@ protected:
 	Evergreen::Margin					m_margin;	
 	UI*									m_ui;
 
-	std::function<void(Control*, const Timer&)> m_CustomOnUpdateCallback = [](Control*, const Timer&) {};
+	// Only the callbacks that have been set take up any space (see CallbackTable). Derived controls declare their own
+	// CallbackSlot's starting at FirstDerivedCallbackSlot
+	CallbackTable						m_callbacks;
+	static constexpr CallbackSlot<void(Control*, const Timer&)> OnUpdateCallbackSlot{ 0 };
+	static constexpr uint8_t FirstDerivedCallbackSlot = 1;
 
 	// Allowed region should be set by the parent layout
 	D2D1_RECT_F							m_allowedRegion;
@@ -371,6 +371,7 @@ void Pane::OnUpdate(const Timer& timer)
 }
 void Pane::Render() const
 {
+	EG_PROFILE_CONTROL_RENDER(this);
 	EG_CORE_ASSERT(m_contentLayout != nullptr, "No content layout");
 	EG_CORE_ASSERT(m_deviceResources != nullptr, "No device resources");
 	EG_CORE_ASSERT(m_backgroundBrush != nullptr, "No background brush");
@@ -378,8 +379,7 @@ void Pane::Render() const
 	if (!m_visible)
 		return;
 
-	auto context = m_deviceResources->D2DDeviceContext();
-	EG_CORE_ASSERT(context != nullptr, "No device context");
+	DrawList& drawList = m_ui->GetDrawList();
 
 	if (m_titleLayout != nullptr)
 	{
@@ -396,7 +396,7 @@ void Pane::Render() const
 		{
 			if (m_minimized)
 			{
-				context->FillRoundedRectangle(
+				drawList.FillRoundedRectangle(
 					D2D1::RoundedRect(titleRect, m_paneCornerRadiusX, m_paneCornerRadiusY),
 					m_titleBarBrush->Get()
 				);
@@ -404,7 +404,7 @@ void Pane::Render() const
 				
 				if (m_borderBrush != nullptr && m_borderWidths[0] > 0.0f)
 				{
-					context->DrawRoundedRectangle(
+					drawList.DrawRoundedRectangle(
 						D2D1::RoundedRect(titleRect, m_paneCornerRadiusX, m_paneCornerRadiusY),
 						m_borderBrush->Get(), 
 						m_borderWidths[0]
@@ -413,19 +413,19 @@ void Pane::Render() const
 			}
 			else
 			{
-				context->PushAxisAlignedClip(titleRect, D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
-				context->FillRoundedRectangle(D2D1::RoundedRect(m_allowedRegion, m_paneCornerRadiusX, m_paneCornerRadiusY), m_titleBarBrush->Get());
+				drawList.PushAxisAlignedClip(titleRect, D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
+				drawList.FillRoundedRectangle(D2D1::RoundedRect(m_allowedRegion, m_paneCornerRadiusX, m_paneCornerRadiusY), m_titleBarBrush->Get());
 				m_titleLayout->Render();
-				context->PopAxisAlignedClip();
+				drawList.PopAxisAlignedClip();
 
-				context->PushAxisAlignedClip(contentRect, D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
-				context->FillRoundedRectangle(D2D1::RoundedRect(m_allowedRegion, m_paneCornerRadiusX, m_paneCornerRadiusY), m_backgroundBrush->Get());
+				drawList.PushAxisAlignedClip(contentRect, D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
+				drawList.FillRoundedRectangle(D2D1::RoundedRect(m_allowedRegion, m_paneCornerRadiusX, m_paneCornerRadiusY), m_backgroundBrush->Get());
 				m_contentLayout->Render();
-				context->PopAxisAlignedClip();
+				drawList.PopAxisAlignedClip();
 
 				if (m_borderBrush != nullptr && m_borderWidths[0] > 0.0f)
 				{
-					context->DrawRoundedRectangle(
+					drawList.DrawRoundedRectangle(
 						D2D1::RoundedRect(m_allowedRegion, m_paneCornerRadiusX, m_paneCornerRadiusY),
 						m_borderBrush->Get(),
 						m_borderWidths[0]
@@ -435,12 +435,12 @@ void Pane::Render() const
 		}
 		else
 		{
-			context->FillRectangle(titleRect, m_titleBarBrush->Get());
+			drawList.FillRectangle(titleRect, m_titleBarBrush->Get());
 			m_titleLayout->Render();
 
 			if (!m_minimized)
 			{
-				context->FillRectangle(contentRect, m_backgroundBrush->Get());
+				drawList.FillRectangle(contentRect, m_backgroundBrush->Get());
 				m_contentLayout->Render();
 			}
 
@@ -457,7 +457,7 @@ void Pane::Render() const
 					// If the offsets are 0, then just draw the complete border
 					if (m_borderTopLeftOffsetY == 0.0f && m_borderBottomLeftOffsetY == 0.0f)
 					{
-						context->DrawLine(
+						drawList.DrawLine(
 							D2D1::Point2F(left, top),		// top-left
 							D2D1::Point2F(left, bottom),	// bottom-left
 							m_borderBrush->Get(),
@@ -466,13 +466,13 @@ void Pane::Render() const
 					}
 					else
 					{
-						context->DrawLine(
+						drawList.DrawLine(
 							D2D1::Point2F(left, top),							// top-left
 							D2D1::Point2F(left, top + m_borderTopLeftOffsetY),	// stop point from the top
 							m_borderBrush->Get(),
 							m_borderWidths[0]
 						);
-						context->DrawLine(
+						drawList.DrawLine(
 							D2D1::Point2F(left, bottom),								// bottom-left
 							D2D1::Point2F(left, bottom - m_borderBottomLeftOffsetY),	// stop point from the bottom
 							m_borderBrush->Get(),
@@ -485,7 +485,7 @@ void Pane::Render() const
 					// If the offsets are 0, then just draw the complete border
 					if (m_borderTopLeftOffsetX == 0.0f && m_borderTopRightOffsetX == 0.0f)
 					{
-						context->DrawLine(
+						drawList.DrawLine(
 							D2D1::Point2F(left, top),	// top-left
 							D2D1::Point2F(right, top),	// top-right
 							m_borderBrush->Get(),
@@ -494,13 +494,13 @@ void Pane::Render() const
 					}
 					else
 					{
-						context->DrawLine(
+						drawList.DrawLine(
 							D2D1::Point2F(left, top),							// top-left
 							D2D1::Point2F(left + m_borderTopLeftOffsetX, top),	// stop point from the left
 							m_borderBrush->Get(),
 							m_borderWidths[1]
 						);
-						context->DrawLine(
+						drawList.DrawLine(
 							D2D1::Point2F(right, top),								// top-right
 							D2D1::Point2F(right - m_borderTopRightOffsetX, top),	// stop point from the right
 							m_borderBrush->Get(),
@@ -513,7 +513,7 @@ void Pane::Render() const
 					// If the offsets are 0, then just draw the complete border
 					if (m_borderTopRightOffsetY == 0.0f && m_borderBottomRightOffsetY == 0.0f)
 					{
-						context->DrawLine(
+						drawList.DrawLine(
 							D2D1::Point2F(right, top),		// top-right
 							D2D1::Point2F(right, bottom),	// bottom-right
 							m_borderBrush->Get(),
@@ -522,13 +522,13 @@ void Pane::Render() const
 					}
 					else
 					{
-						context->DrawLine(
+						drawList.DrawLine(
 							D2D1::Point2F(right, top),								// top-right
 							D2D1::Point2F(right, top + m_borderTopRightOffsetY),	// stop point from the top
 							m_borderBrush->Get(),
 							m_borderWidths[2]
 						);
-						context->DrawLine(
+						drawList.DrawLine(
 							D2D1::Point2F(right, bottom),								// bottom-right
 							D2D1::Point2F(right, bottom - m_borderBottomRightOffsetY),	// stop point from the bottom
 							m_borderBrush->Get(),
@@ -541,7 +541,7 @@ void Pane::Render() const
 					// If the offsets are 0, then just draw the complete border
 					if (m_borderBottomLeftOffsetX == 0.0f && m_borderBottomRightOffsetX == 0.0f)
 					{
-						context->DrawLine(
+						drawList.DrawLine(
 							D2D1::Point2F(left, bottom),	// bottom-left
 							D2D1::Point2F(right, bottom),	// bottom-right
 							m_borderBrush->Get(),
@@ -550,13 +550,13 @@ void Pane::Render() const
 					}
 					else
 					{
-						context->DrawLine(
+						drawList.DrawLine(
 							D2D1::Point2F(left, bottom),								// bottom-left
 							D2D1::Point2F(left + m_borderBottomLeftOffsetX, bottom),	// stop point from the left
 							m_borderBrush->Get(),
 							m_borderWidths[3]
 						);
-						context->DrawLine(
+						drawList.DrawLine(
 							D2D1::Point2F(right, bottom),								// bottom-right
 							D2D1::Point2F(right - m_borderBottomRightOffsetX, bottom),	// stop point from the right
 							m_borderBrush->Get(),
@@ -576,17 +576,17 @@ void Pane::Render() const
 		//       a partial edge border
 		if (m_paneCornerRadiusX > 0.0f && m_paneCornerRadiusY > 0.0f)
 		{
-			context->FillRoundedRectangle(D2D1::RoundedRect(m_allowedRegion, m_paneCornerRadiusX, m_paneCornerRadiusY), m_backgroundBrush->Get());
+			drawList.FillRoundedRectangle(D2D1::RoundedRect(m_allowedRegion, m_paneCornerRadiusX, m_paneCornerRadiusY), m_backgroundBrush->Get());
 			m_contentLayout->Render();
 
 			if (m_borderBrush != nullptr && m_borderWidths[0] > 0.0f)
 			{
-				context->DrawRoundedRectangle(D2D1::RoundedRect(m_allowedRegion, m_paneCornerRadiusX, m_paneCornerRadiusY), m_borderBrush->Get(), m_borderWidths[0]);
+				drawList.DrawRoundedRectangle(D2D1::RoundedRect(m_allowedRegion, m_paneCornerRadiusX, m_paneCornerRadiusY), m_borderBrush->Get(), m_borderWidths[0]);
 			}
 		}
 		else
 		{
-			context->FillRectangle(m_allowedRegion, m_backgroundBrush->Get());
+			drawList.FillRectangle(m_allowedRegion, m_backgroundBrush->Get());
 			m_contentLayout->Render();
 
 			if (m_borderBrush != nullptr)
@@ -595,7 +595,7 @@ void Pane::Render() const
 
 				if (m_borderWidths[0] > 0.0f)
 				{
-					context->DrawLine(
+					drawList.DrawLine(
 						D2D1::Point2F(rect.left, rect.top + m_borderTopLeftOffsetY),		// top-left
 						D2D1::Point2F(rect.left, rect.bottom - m_borderBottomLeftOffsetY),	// bottom-left
 						m_borderBrush->Get(),
@@ -604,7 +604,7 @@ void Pane::Render() const
 				}
 				if (m_borderWidths[1] > 0.0f)
 				{
-					context->DrawLine(
+					drawList.DrawLine(
 						D2D1::Point2F(rect.left + m_borderTopLeftOffsetX, rect.top),	// top-left
 						D2D1::Point2F(rect.right - m_borderTopRightOffsetX, rect.top),	// top-right
 						m_borderBrush->Get(),
@@ -613,7 +613,7 @@ void Pane::Render() const
 				}
 				if (m_borderWidths[2] > 0.0f)
 				{
-					context->DrawLine(
+					drawList.DrawLine(
 						D2D1::Point2F(rect.right, rect.top + m_borderTopRightOffsetY),			// top-right
 						D2D1::Point2F(rect.right, rect.bottom - m_borderBottomRightOffsetY),	// bottom-right
 						m_borderBrush->Get(),
@@ -622,7 +622,7 @@ void Pane::Render() const
 				}
 				if (m_borderWidths[3] > 0.0f)
 				{
-					context->DrawLine(
+					drawList.DrawLine(
 						D2D1::Point2F(rect.right - m_borderBottomRightOffsetX, rect.bottom),	// bottom-right
 						D2D1::Point2F(rect.left + m_borderBottomLeftOffsetX, rect.bottom),		// bottom-left
 						m_borderBrush->Get(),
@@ -763,12 +763,12 @@ void Pane::ForceMouseToBeNotOverTitleAndContent(MouseMoveEvent& e) noexcept
 	if (m_mouseTitleBarState == MouseOverDraggableAreaState::OVER)
 	{
 		m_mouseTitleBarState = MouseOverDraggableAreaState::NOT_OVER;
-		m_OnMouseExitedTitleBar(this, e);
+		m_callbacks.Invoke(OnMouseExitedTitleBarCallbackSlot, this, e);
 	}
 	else if (m_mouseContentRegionState == MouseOverDraggableAreaState::OVER)
 	{
 		m_mouseContentRegionState = MouseOverDraggableAreaState::NOT_OVER;
-		m_OnMouseExitedContentRegion(this, e);
+		m_callbacks.Invoke(OnMouseExitedContentRegionCallbackSlot, this, e);
 	}
 }
 
@@ -820,7 +820,7 @@ void Pane::OnMouseMove(MouseMoveEvent& e)
 		return;
 
 	if (RectContainsPoint(m_allowedRegion, e.GetX(), e.GetY()))
-		m_OnMouseMoved(this, e);
+		m_callbacks.Invoke(OnMouseMovedCallbackSlot, this, e);
 
 	// Only perform the DRAGGING checks if the pane is resizeable
 	if (m_resizable)
@@ -1305,12 +1305,12 @@ void Pane::OnMouseMove(MouseMoveEvent& e)
 			{
 				m_mouseTitleBarState = MouseOverDraggableAreaState::OVER;
 				e.Handled(this);
-				m_OnMouseEnteredTitleBar(this, e);
+				m_callbacks.Invoke(OnMouseEnteredTitleBarCallbackSlot, this, e);
 
 				if (m_mouseContentRegionState == MouseOverDraggableAreaState::OVER)
 				{
 					m_mouseContentRegionState = MouseOverDraggableAreaState::NOT_OVER;
-					m_OnMouseExitedContentRegion(this, e);
+					m_callbacks.Invoke(OnMouseExitedContentRegionCallbackSlot, this, e);
 				}
 
 				return;
@@ -1321,7 +1321,7 @@ void Pane::OnMouseMove(MouseMoveEvent& e)
 			if (!mouseIsOverTitleBar)
 			{
 				m_mouseTitleBarState = MouseOverDraggableAreaState::NOT_OVER;
-				m_OnMouseExitedTitleBar(this, e);
+				m_callbacks.Invoke(OnMouseExitedTitleBarCallbackSlot, this, e);
 			}
 		}
 	}
@@ -1337,13 +1337,13 @@ void Pane::OnMouseMove(MouseMoveEvent& e)
 			if (mouseIsOverContentRect)
 			{
 				m_mouseContentRegionState = MouseOverDraggableAreaState::OVER;
-				m_OnMouseEnteredContentRegion(this, e);
+				m_callbacks.Invoke(OnMouseEnteredContentRegionCallbackSlot, this, e);
 			}
 		}
 		else if (!mouseIsOverContentRect)
 		{
 			m_mouseContentRegionState = MouseOverDraggableAreaState::NOT_OVER;
-			m_OnMouseExitedContentRegion(this, e);
+			m_callbacks.Invoke(OnMouseExitedContentRegionCallbackSlot, this, e);
 		}
 	}
 
@@ -1361,12 +1361,12 @@ void Pane::MouseMoveHandledByPane(MouseMoveEvent& e)
 	if (m_mouseTitleBarState == MouseOverDraggableAreaState::OVER)
 	{
 		m_mouseTitleBarState = MouseOverDraggableAreaState::NOT_OVER;
-		m_OnMouseExitedTitleBar(this, e);
+		m_callbacks.Invoke(OnMouseExitedTitleBarCallbackSlot, this, e);
 	}
 	else if (m_mouseContentRegionState == MouseOverDraggableAreaState::OVER)
 	{
 		m_mouseContentRegionState = MouseOverDraggableAreaState::NOT_OVER;
-		m_OnMouseExitedContentRegion(this, e);
+		m_callbacks.Invoke(OnMouseExitedContentRegionCallbackSlot, this, e);
 	}
 }
 void Pane::OnMouseScrolledVertical(MouseScrolledEvent& e)
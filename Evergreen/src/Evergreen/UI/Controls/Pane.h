@@ -115,11 +115,11 @@ public:
 	ND inline bool GetMinimized() const noexcept { return m_minimized; }
 	ND inline bool GetVisible() const noexcept { return m_visible; }
 
-	void SetOnMouseEnteredTitleBarCallback(std::function<void(Pane*, MouseMoveEvent& e)> func) noexcept { m_OnMouseEnteredTitleBar = func; }
-	void SetOnMouseExitedTitleBarCallback(std::function<void(Pane*, MouseMoveEvent& e)> func) noexcept { m_OnMouseExitedTitleBar = func; }
-	void SetOnMouseEnteredContentRegionCallback(std::function<void(Pane*, MouseMoveEvent& e)> func) noexcept { m_OnMouseEnteredContentRegion = func; }
-	void SetOnMouseExitedContentRegionCallback(std::function<void(Pane*, MouseMoveEvent& e)> func) noexcept { m_OnMouseExitedContentRegion = func; }
-	void SetOnMouseMovedCallback(std::function<void(Pane*, MouseMoveEvent& e)> func) noexcept { m_OnMouseMoved = func; }
+	void SetOnMouseEnteredTitleBarCallback(std::function<void(Pane*, MouseMoveEvent& e)> func) noexcept { m_callbacks.Set(OnMouseEnteredTitleBarCallbackSlot, std::move(func)); }
+	void SetOnMouseExitedTitleBarCallback(std::function<void(Pane*, MouseMoveEvent& e)> func) noexcept { m_callbacks.Set(OnMouseExitedTitleBarCallbackSlot, std::move(func)); }
+	void SetOnMouseEnteredContentRegionCallback(std::function<void(Pane*, MouseMoveEvent& e)> func) noexcept { m_callbacks.Set(OnMouseEnteredContentRegionCallbackSlot, std::move(func)); }
+	void SetOnMouseExitedContentRegionCallback(std::function<void(Pane*, MouseMoveEvent& e)> func) noexcept { m_callbacks.Set(OnMouseExitedContentRegionCallbackSlot, std::move(func)); }
+	void SetOnMouseMovedCallback(std::function<void(Pane*, MouseMoveEvent& e)> func) noexcept { m_callbacks.Set(OnMouseMovedCallbackSlot, std::move(func)); }
 
 	template<class T>
 	T* CreateControl(std::shared_ptr<DeviceResources> deviceResources) noexcept requires (std::is_base_of_v<Control, T>);
@@ -170,11 +170,11 @@ private:
 
 	void ForceMouseToBeNotOverTitleAndContent(MouseMoveEvent& e) noexcept;
 
-	std::function<void(Pane*, MouseMoveEvent&)> m_OnMouseEnteredTitleBar = [](Pane*, MouseMoveEvent&) {};
-	std::function<void(Pane*, MouseMoveEvent&)> m_OnMouseExitedTitleBar = [](Pane*, MouseMoveEvent&) {};
-	std::function<void(Pane*, MouseMoveEvent&)> m_OnMouseEnteredContentRegion = [](Pane*, MouseMoveEvent&) {};
-	std::function<void(Pane*, MouseMoveEvent&)> m_OnMouseExitedContentRegion = [](Pane*, MouseMoveEvent&) {};
-	std::function<void(Pane*, MouseMoveEvent&)> m_OnMouseMoved = [](Pane*, MouseMoveEvent&) {};
+	static constexpr CallbackSlot<void(Pane*, MouseMoveEvent&)> OnMouseEnteredTitleBarCallbackSlot{ FirstDerivedCallbackSlot + 0 };
+	static constexpr CallbackSlot<void(Pane*, MouseMoveEvent&)> OnMouseExitedTitleBarCallbackSlot{ FirstDerivedCallbackSlot + 1 };
+	static constexpr CallbackSlot<void(Pane*, MouseMoveEvent&)> OnMouseEnteredContentRegionCallbackSlot{ FirstDerivedCallbackSlot + 2 };
+	static constexpr CallbackSlot<void(Pane*, MouseMoveEvent&)> OnMouseExitedContentRegionCallbackSlot{ FirstDerivedCallbackSlot + 3 };
+	static constexpr CallbackSlot<void(Pane*, MouseMoveEvent&)> OnMouseMovedCallbackSlot{ FirstDerivedCallbackSlot + 4 };
 	// I can't think of use cases for these so I'm only going to implement what is currently necessary
 	//std::function<void(Pane*, MouseButtonPressedEvent&)> m_OnMouseLButtonDown = [](Pane*, MouseButtonPressedEvent&) {};
 	//std::function<void(Pane*, MouseButtonReleasedEvent&)> m_OnMouseLButtonUp = [](Pane*, MouseButtonReleasedEvent&) {};
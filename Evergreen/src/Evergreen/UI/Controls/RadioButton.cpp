@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "RadioButton.h"
+#include "Evergreen/UI/UI.h"
 
 
 
@@ -36,23 +37,24 @@ RadioButton::RadioButton(std::shared_ptr<DeviceResources> deviceResources,
 
 void RadioButton::Render() const
 {
+	EG_PROFILE_CONTROL_RENDER(this);
 	EG_CORE_ASSERT(m_deviceResources != nullptr, "No device resources");
 	EG_CORE_ASSERT(m_innerBrush != nullptr, "No inner brush");
 	EG_CORE_ASSERT(m_outerBrush != nullptr, "No outer brush");
 	EG_CORE_ASSERT(m_innerCircle != nullptr, "No inner circle");
 	EG_CORE_ASSERT(m_outerCircle != nullptr, "No outer circle");
 
-	auto context = m_deviceResources->D2DDeviceContext();
+	DrawList& drawList = m_ui->GetDrawList();
 
 	D2D1_ELLIPSE outerCircle;
 	m_outerCircle->GetEllipse(&outerCircle);
-	context->DrawEllipse(outerCircle, m_outerBrush->Get(), m_outerLineWidth);
+	drawList.DrawEllipse(outerCircle, m_outerBrush->Get(), m_outerLineWidth);
 
 	if (m_isChecked)
 	{
 		D2D1_ELLIPSE innerCircle;
 		m_innerCircle->GetEllipse(&innerCircle);
-		context->FillEllipse(innerCircle, m_innerBrush->Get());
+		drawList.FillEllipse(innerCircle, m_innerBrush->Get());
 	}
 }
 
@@ -96,10 +98,16 @@ void RadioButton::SetIsChecked(bool checked) noexcept
 	{
 		m_isChecked = checked;
 		RadioButtonIsCheckedChangedEvent e(checked);
-		m_OnIsCheckedChanged(this, e);
+		m_isCheckedBinding.Write(m_isChecked);
+		m_callbacks.Invoke(OnIsCheckedChangedCallbackSlot, this, e);
 	}
 }
 
+void RadioButton::BindIsChecked(Observable<bool>& source)
+{
+	m_isCheckedBinding = source.Subscribe([this](const bool& value) { SetIsChecked(value); });
+}
+
 // Event handling
 void RadioButton::OnMouseMove(MouseMoveEvent& e)
 {
@@ -112,7 +120,7 @@ void RadioButton::OnMouseMove(MouseMoveEvent& e)
 		if (currentMouseIsOver)
 		{
 			m_mouseState = MouseOverState::OVER;
-			m_OnMouseEntered(this, e);
+			m_callbacks.Invoke(OnMouseEnteredCallbackSlot, this, e);
 			e.Handled(this);
 		}
 		break;
@@ -120,11 +128,11 @@ void RadioButton::OnMouseMove(MouseMoveEvent& e)
 	case MouseOverState::OVER:
 	case MouseOverState::OVER_AND_LBUTTON_DOWN:
 	{
-		m_OnMouseMoved(this, e);
+		m_callbacks.Invoke(OnMouseMovedCallbackSlot, this, e);
 		if (!currentMouseIsOver)
 		{
 			m_mouseState = MouseOverState::NOT_OVER;
-			m_OnMouseExited(this, e);			
+			m_callbacks.Invoke(OnMouseExitedCallbackSlot, this, e);			
 		}
 		e.Handled(this);
 		break;
@@ -134,7 +142,7 @@ void RadioButton::OnMouseMove(MouseMoveEvent& e)
 void RadioButton::MouseMoveHandledByPane(MouseMoveEvent& e)
 {
 	m_mouseState = MouseOverState::NOT_OVER;
-	m_OnMouseExited(this, e);
+	m_callbacks.Invoke(OnMouseExitedCallbackSlot, this, e);
 }
 void RadioButton::OnMouseButtonPressed(MouseButtonPressedEvent& e)
 {
@@ -142,7 +150,7 @@ void RadioButton::OnMouseButtonPressed(MouseButtonPressedEvent& e)
 		m_mouseState == MouseOverState::OVER)
 	{
 		m_mouseState = MouseOverState::OVER_AND_LBUTTON_DOWN;
-		m_OnMouseLButtonDown(this, e);
+		m_callbacks.Invoke(OnMouseLButtonDownCallbackSlot, this, e);
 		e.Handled(this);
 	}
 }
@@ -155,7 +163,8 @@ void RadioButton::OnMouseButtonReleased(MouseButtonReleasedEvent& e)
 		m_mouseState = MouseOverState::OVER;
 
 		RadioButtonIsCheckedChangedEvent e(m_isChecked);
-		m_OnIsCheckedChanged(this, e);
+		m_isCheckedBinding.Write(m_isChecked);
+		m_callbacks.Invoke(OnIsCheckedChangedCallbackSlot, this, e);
 
 		e.Handled(this);
 	}
@@ -1,6 +1,7 @@
 #pragma once
 #include "pch.h"
 #include "Control.h"
+#include "Evergreen/UI/Observable.h"
 #include "Evergreen/UI/Brushes.h"
 #include "Evergreen/UI/Layout.h"
 
@@ -72,17 +73,20 @@ public:
 	ND inline float GetInnerRadius() const noexcept { return m_innerRadius; }
 
 	void SetIsChecked(bool checked) noexcept;
+	// Two-way binding: the radio button follows 'source', and clicking it sets 'source'
+	void BindIsChecked(Observable<bool>& source);
+	inline void UnbindIsChecked() noexcept { m_isCheckedBinding.Reset(); }
 	inline void SetOuterBrush(std::unique_ptr<ColorBrush> brush) noexcept { m_outerBrush = std::move(brush); }
 	inline void SetInnerBrush(std::unique_ptr<ColorBrush> brush) noexcept { m_innerBrush = std::move(brush); }
 	void SetOuterLineWidth(float width) noexcept { m_outerLineWidth = width; }
 	void SetInnerRadius(float width) { m_innerRadius = width; RadioButtonChanged(); }
 	void SetOuterRadius(float width) { m_outerRadius = width; RadioButtonChanged(); }
 
-	inline void SetOnMouseEnteredCallback(std::function<void(RadioButton*, MouseMoveEvent&)> func) noexcept { m_OnMouseEntered = func; }
-	inline void SetOnMouseExitedCallback(std::function<void(RadioButton*, MouseMoveEvent&)> func) noexcept { m_OnMouseExited = func; }
-	inline void SetOnMouseMovedCallback(std::function<void(RadioButton*, MouseMoveEvent&)> func) noexcept { m_OnMouseMoved = func; }
-	inline void SetOnMouseLButtonDownCallback(std::function<void(RadioButton*, MouseButtonPressedEvent&)> func) noexcept { m_OnMouseLButtonDown = func; }
-	inline void SetOnIsCheckedChanged(std::function<void(RadioButton*, RadioButtonIsCheckedChangedEvent&)> func) noexcept { m_OnIsCheckedChanged = func; }
+	inline void SetOnMouseEnteredCallback(std::function<void(RadioButton*, MouseMoveEvent&)> func) noexcept { m_callbacks.Set(OnMouseEnteredCallbackSlot, std::move(func)); }
+	inline void SetOnMouseExitedCallback(std::function<void(RadioButton*, MouseMoveEvent&)> func) noexcept { m_callbacks.Set(OnMouseExitedCallbackSlot, std::move(func)); }
+	inline void SetOnMouseMovedCallback(std::function<void(RadioButton*, MouseMoveEvent&)> func) noexcept { m_callbacks.Set(OnMouseMovedCallbackSlot, std::move(func)); }
+	inline void SetOnMouseLButtonDownCallback(std::function<void(RadioButton*, MouseButtonPressedEvent&)> func) noexcept { m_callbacks.Set(OnMouseLButtonDownCallbackSlot, std::move(func)); }
+	inline void SetOnIsCheckedChanged(std::function<void(RadioButton*, RadioButtonIsCheckedChangedEvent&)> func) noexcept { m_callbacks.Set(OnIsCheckedChangedCallbackSlot, std::move(func)); }
 
 	virtual ControlType GetControlType() const noexcept override { return ControlType::RadioButton; }
 
@@ -100,13 +104,14 @@ protected:
 
 	ND inline bool MouseIsOver(float x, float y) noexcept;
 
-	std::function<void(RadioButton*, MouseMoveEvent&)> m_OnMouseEntered = [](RadioButton*, MouseMoveEvent&) {};
-	std::function<void(RadioButton*, MouseMoveEvent&)> m_OnMouseExited = [](RadioButton*, MouseMoveEvent&) {};
-	std::function<void(RadioButton*, MouseMoveEvent&)> m_OnMouseMoved = [](RadioButton*, MouseMoveEvent&) {};
-	std::function<void(RadioButton*, MouseButtonPressedEvent&)> m_OnMouseLButtonDown = [](RadioButton*, MouseButtonPressedEvent&) {};
-	std::function<void(RadioButton*, RadioButtonIsCheckedChangedEvent&)> m_OnIsCheckedChanged = [](RadioButton*, RadioButtonIsCheckedChangedEvent&) {};
+	static constexpr CallbackSlot<void(RadioButton*, MouseMoveEvent&)> OnMouseEnteredCallbackSlot{ FirstDerivedCallbackSlot + 0 };
+	static constexpr CallbackSlot<void(RadioButton*, MouseMoveEvent&)> OnMouseExitedCallbackSlot{ FirstDerivedCallbackSlot + 1 };
+	static constexpr CallbackSlot<void(RadioButton*, MouseMoveEvent&)> OnMouseMovedCallbackSlot{ FirstDerivedCallbackSlot + 2 };
+	static constexpr CallbackSlot<void(RadioButton*, MouseButtonPressedEvent&)> OnMouseLButtonDownCallbackSlot{ FirstDerivedCallbackSlot + 3 };
+	static constexpr CallbackSlot<void(RadioButton*, RadioButtonIsCheckedChangedEvent&)> OnIsCheckedChangedCallbackSlot{ FirstDerivedCallbackSlot + 4 };
 
 	bool						m_isChecked;
+	ObservableSubscription		m_isCheckedBinding;
 	std::unique_ptr<ColorBrush> m_innerBrush;
 	std::unique_ptr<ColorBrush> m_outerBrush;
 	float						m_outerLineWidth;
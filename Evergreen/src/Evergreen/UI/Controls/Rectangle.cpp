@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "Rectangle.h"
+#include "Evergreen/UI/UI.h"
 
 
 namespace Evergreen
@@ -24,11 +25,12 @@ Rectangle::Rectangle(std::shared_ptr<DeviceResources> deviceResources,
 
 void Rectangle::Render() const
 {
+	EG_PROFILE_CONTROL_RENDER(this);
 	EG_CORE_ASSERT(m_deviceResources != nullptr, "No device resources"); 
 	EG_CORE_ASSERT(m_brush != nullptr, "No background brush");
 	
-	auto context = m_deviceResources->D2DDeviceContext();
-	context->FillRectangle(m_backgroundRect, m_brush->Get());
+	DrawList& drawList = m_ui->GetDrawList();
+	drawList.FillRectangle(m_backgroundRect, m_brush->Get());
 }
 
 Control* Rectangle::GetControlByName(const std::string& name) noexcept
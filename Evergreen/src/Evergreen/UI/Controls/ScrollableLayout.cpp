@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "ScrollableLayout.h"
+#include "Evergreen/UI/UI.h"
 
 using Microsoft::WRL::ComPtr;
 
@@ -77,30 +78,31 @@ void ScrollableLayout::OnUpdate(const Timer& timer)
 }
 void ScrollableLayout::Render() const
 {
+	EG_PROFILE_CONTROL_RENDER(this);
 	EG_CORE_ASSERT(m_deviceResources != nullptr, "No device resources");
 	EG_CORE_ASSERT(m_layout != nullptr, "No layout");
 	EG_CORE_ASSERT(m_backgroundBrush != nullptr, "No background brush");
 	EG_CORE_ASSERT(m_borderBrush != nullptr, "No border brush");
 
-	auto context = m_deviceResources->D2DDeviceContext();
+	DrawList& drawList = m_ui->GetDrawList();
 
 	// Only allow drawing within the background rect.
-	context->PushAxisAlignedClip(m_backgroundRect, D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
+	drawList.PushAxisAlignedClip(m_backgroundRect, D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
 
 	// Draw the background
-	context->FillRectangle(m_backgroundRect, m_backgroundBrush->Get());
+	drawList.FillRectangle(m_backgroundRect, m_backgroundBrush->Get());
 
 	// Have the layout draw the background and contents of the brush
 	m_layout->Render();
 
 	// Must remove the clipping area
-	context->PopAxisAlignedClip();
+	drawList.PopAxisAlignedClip();
 
 	// Vertical scroll bar ----------------------------------------------------------------------------------------------
 	bool verticalScrollBarIsVisible = !m_verticalScrollBarHiddenWhenNotOver || m_mouseIsOverVerticalScrollBarRegion || m_verticalScrollBarState == MouseOverBarState::DRAGGING;
 	if (m_verticalScrollBarEnabled && LayoutHeightExceedsBackgroundHeight() && verticalScrollBarIsVisible)
 	{
-		context->FillRectangle(m_verticalScrollBarRegion, m_verticalScrollBarRegionBrush->Get());
+		drawList.FillRectangle(m_verticalScrollBarRegion, m_verticalScrollBarRegionBrush->Get());
 
 		ColorBrush* brush = nullptr;
 		switch(m_verticalScrollBarState)
@@ -112,16 +114,16 @@ void ScrollableLayout::Render() const
 		EG_CORE_ASSERT(brush != nullptr, "Something went wrong. brush should never be nullptr");
 
 		if (m_verticalScrollBarCornerXRadius == 0.0f && m_verticalScrollBarCornerYRadius == 0.0f)
-			context->FillRectangle(m_verticalScrollBar, brush->Get());
+			drawList.FillRectangle(m_verticalScrollBar, brush->Get());
 		else
-			context->FillRoundedRectangle(D2D1::RoundedRect(m_verticalScrollBar, m_verticalScrollBarCornerXRadius, m_verticalScrollBarCornerYRadius), brush->Get());
+			drawList.FillRoundedRectangle(D2D1::RoundedRect(m_verticalScrollBar, m_verticalScrollBarCornerXRadius, m_verticalScrollBarCornerYRadius), brush->Get());
 	}
 
 	// Horizontal scroll bar
 	bool horizontalScrollBarIsVisible = !m_horizontalScrollBarHiddenWhenNotOver || m_mouseIsOverHorizontalScrollBarRegion || m_horizontalScrollBarState == MouseOverBarState::DRAGGING;
 	if (m_horizontalScrollBarEnabled && LayoutWidthExceedsBackgroundWidth() && horizontalScrollBarIsVisible)
 	{
-		context->FillRectangle(m_horizontalScrollBarRegion, m_horizontalScrollBarRegionBrush->Get());
+		drawList.FillRectangle(m_horizontalScrollBarRegion, m_horizontalScrollBarRegionBrush->Get());
 
 		ColorBrush* brush = nullptr;
 		switch (m_horizontalScrollBarState)
@@ -133,14 +135,14 @@ void ScrollableLayout::Render() const
 		EG_CORE_ASSERT(brush != nullptr, "Something went wrong. brush should never be nullptr");
 
 		if (m_horizontalScrollBarCornerXRadius == 0.0f && m_horizontalScrollBarCornerYRadius == 0.0f)
-			context->FillRectangle(m_horizontalScrollBar, brush->Get());
+			drawList.FillRectangle(m_horizontalScrollBar, brush->Get());
 		else
-			context->FillRoundedRectangle(D2D1::RoundedRect(m_horizontalScrollBar, m_horizontalScrollBarCornerXRadius, m_horizontalScrollBarCornerYRadius), brush->Get());
+			drawList.FillRoundedRectangle(D2D1::RoundedRect(m_horizontalScrollBar, m_horizontalScrollBarCornerXRadius, m_horizontalScrollBarCornerYRadius), brush->Get());
 	}
 
 	// Draw the border last so it appears on top
 	if (m_borderWidth > 0.0f)
-		context->DrawRectangle(m_backgroundRect, m_borderBrush->Get(), m_borderWidth);
+		drawList.DrawRectangle(m_backgroundRect, m_borderBrush->Get(), m_borderWidth);
 }
 
 Row* ScrollableLayout::AddRow(RowColumnDefinition definition)
@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "SliderFloat.h"
+#include "Evergreen/UI/UI.h"
 
 namespace Evergreen
 {
@@ -321,6 +322,7 @@ float SliderFloat::PixelToValue(float pixel) const noexcept
 	
 void SliderFloat::Render() const
 {
+	EG_PROFILE_CONTROL_RENDER(this);
 	EG_CORE_ASSERT(m_deviceResources != nullptr, "No device resources");
 	EG_CORE_ASSERT(m_lineBrushLeft != nullptr, "No line brush left");
 	EG_CORE_ASSERT(m_lineBrushRight != nullptr, "No line brush right");
@@ -331,7 +333,7 @@ void SliderFloat::Render() const
 	EG_CORE_ASSERT(m_valueTextInputOnRight != nullptr, "Should not be nullptr");
 	EG_CORE_ASSERT(m_valueTextOnPopUp != nullptr, "Should not be nullptr");
 
-	auto context = m_deviceResources->D2DDeviceContext();
+	DrawList& drawList = m_ui->GetDrawList();
 
 	float halfLineWidth = m_lineWidth / 2;
 	float lineTop = m_lineY - halfLineWidth;
@@ -342,7 +344,7 @@ void SliderFloat::Render() const
 	{
 		D2D1_RECT_F leftRect = D2D1::RectF(m_lineLeftX, lineTop, m_circlePositionX, lineBottom);
 		D2D1_ROUNDED_RECT leftRoundedRect = D2D1::RoundedRect(leftRect, halfLineWidth, halfLineWidth);
-		context->FillRoundedRectangle(leftRoundedRect, m_lineBrushLeft->Get());
+		drawList.FillRoundedRectangle(leftRoundedRect, m_lineBrushLeft->Get());
 	}
 
 	// Right Line
@@ -352,20 +354,20 @@ void SliderFloat::Render() const
 		D2D1_ROUNDED_RECT rightRoundedRect = D2D1::RoundedRect(rightRect, halfLineWidth, halfLineWidth);
 
 		if (m_fillLineRight)
-			context->FillRoundedRectangle(rightRoundedRect, m_lineBrushRight->Get());
+			drawList.FillRoundedRectangle(rightRoundedRect, m_lineBrushRight->Get());
 		else
-			context->DrawRoundedRectangle(rightRoundedRect, m_lineBrushRight->Get(), 1.0f);
+			drawList.DrawRoundedRectangle(rightRoundedRect, m_lineBrushRight->Get(), 1.0f);
 	}
 
 	// Circle
 	D2D1_ELLIPSE circle = D2D1::Ellipse(D2D1::Point2F(m_circlePositionX, m_lineY), m_circleRadius, m_circleRadius);
-	context->FillEllipse(circle, m_circleBrush->Get());
+	drawList.FillEllipse(circle, m_circleBrush->Get());
 
 	// Circle 2
 	if (m_mouseOverCircleState != MouseOverCircleState::NOT_OVER && m_circleBrush2 != nullptr)
 	{
 		D2D1_ELLIPSE circle2 = D2D1::Ellipse(D2D1::Point2F(m_circlePositionX, m_lineY), m_circleRadius2, m_circleRadius2);
-		context->FillEllipse(circle2, m_circleBrush2->Get());
+		drawList.FillEllipse(circle2, m_circleBrush2->Get());
 	}
 
 	// Min/Max text
@@ -384,15 +386,15 @@ void SliderFloat::Render() const
 		if (m_popUpCornerRadiusX > 0.0f && m_popUpCornerRadiusY > 0.0f)
 		{
 			D2D1_ROUNDED_RECT popUpRounded = D2D1::RoundedRect(rect, m_popUpCornerRadiusX, m_popUpCornerRadiusY);
-			context->FillRoundedRectangle(popUpRounded, m_popUpBackgroundBrush->Get());
+			drawList.FillRoundedRectangle(popUpRounded, m_popUpBackgroundBrush->Get());
 			if (m_popUpBorderWidth > 0.0f)
-				context->DrawRoundedRectangle(popUpRounded, m_popUpBorderBrush->Get(), m_popUpBorderWidth);
+				drawList.DrawRoundedRectangle(popUpRounded, m_popUpBorderBrush->Get(), m_popUpBorderWidth);
 		}
 		else
 		{
-			context->FillRectangle(rect, m_popUpBackgroundBrush->Get());
+			drawList.FillRectangle(rect, m_popUpBackgroundBrush->Get());
 			if (m_popUpBorderWidth > 0.0f)
-				context->DrawRectangle(rect, m_popUpBorderBrush->Get(), m_popUpBorderWidth);
+				drawList.DrawRectangle(rect, m_popUpBorderBrush->Get(), m_popUpBorderWidth);
 		}
 
 		m_valueTextOnPopUp->Render();
@@ -472,9 +474,14 @@ void SliderFloat::SetValue(float value) noexcept
 		SliderChanged();
 
 		SliderFloatValueChangedEvent _e(m_value);
-		m_OnValueChanged(this, _e);
+		m_valueBinding.Write(m_value);
+		m_callbacks.Invoke(OnValueChangedCallbackSlot, this, _e);
 	}
 }
+void SliderFloat::BindValue(Observable<float>& source)
+{
+	m_valueBinding = source.Subscribe([this](const float& value) { SetValue(std::clamp(value, m_minValue, m_maxValue)); });
+}
 void SliderFloat::SetTextInputHeight(float height) noexcept
 {
 	if (height <= 0.0f)
@@ -586,7 +593,7 @@ void SliderFloat::OnMouseMove(MouseMoveEvent& e)
 			if (!m_mouseIsOverCircle)
 			{
 				m_mouseIsOverCircle = true;
-				m_OnMouseEnteredCircle(this, e);
+				m_callbacks.Invoke(OnMouseEnteredCircleCallbackSlot, this, e);
 			}
 		}
 		else
@@ -594,7 +601,7 @@ void SliderFloat::OnMouseMove(MouseMoveEvent& e)
 			if (m_mouseIsOverCircle)
 			{
 				m_mouseIsOverCircle = false;
-				m_OnMouseExitedCircle(this, e);
+				m_callbacks.Invoke(OnMouseExitedCircleCallbackSlot, this, e);
 			}
 		}
 
@@ -608,7 +615,8 @@ void SliderFloat::OnMouseMove(MouseMoveEvent& e)
 				UpdateValueTexts();
 
 				SliderFloatValueChangedEvent _e(m_value);
-				m_OnValueChanged(this, _e);
+				m_valueBinding.Write(m_value);
+				m_callbacks.Invoke(OnValueChangedCallbackSlot, this, _e);
 			}
 		}
 		else if (e.GetX() < m_lineLeftX)
@@ -620,7 +628,8 @@ void SliderFloat::OnMouseMove(MouseMoveEvent& e)
 				UpdateValueTexts();
 
 				SliderFloatValueChangedEvent _e(m_value);
-				m_OnValueChanged(this, _e);
+				m_valueBinding.Write(m_value);
+				m_callbacks.Invoke(OnValueChangedCallbackSlot, this, _e);
 			}
 		}
 		else
@@ -633,7 +642,8 @@ void SliderFloat::OnMouseMove(MouseMoveEvent& e)
 				UpdateValueTexts();
 
 				SliderFloatValueChangedEvent _e(m_value);
-				m_OnValueChanged(this, _e);
+				m_valueBinding.Write(m_value);
+				m_callbacks.Invoke(OnValueChangedCallbackSlot, this, _e);
 			}
 		}
 
@@ -646,7 +656,7 @@ void SliderFloat::OnMouseMove(MouseMoveEvent& e)
 		if (currentMouseIsOverCircle)
 		{
 			m_mouseOverCircleState = MouseOverCircleState::OVER;
-			m_OnMouseEnteredCircle(this, e);
+			m_callbacks.Invoke(OnMouseEnteredCircleCallbackSlot, this, e);
 			e.Handled(this);
 			m_mouseIsOverCircle = currentMouseIsOverCircle;
 			return;
@@ -659,7 +669,7 @@ void SliderFloat::OnMouseMove(MouseMoveEvent& e)
 		if (!currentMouseIsOverCircle)
 		{
 			m_mouseOverCircleState = MouseOverCircleState::NOT_OVER;
-			m_OnMouseExitedCircle(this, e);
+			m_callbacks.Invoke(OnMouseExitedCircleCallbackSlot, this, e);
 			break;
 		}
 		e.Handled(this);
@@ -677,7 +687,7 @@ void SliderFloat::MouseMoveHandledByPane(MouseMoveEvent& e)
 	{
 		m_mouseOverCircleState = MouseOverCircleState::NOT_OVER;
 		m_mouseIsOverCircle = false;
-		m_OnMouseExitedCircle(this, e);
+		m_callbacks.Invoke(OnMouseExitedCircleCallbackSlot, this, e);
 	}
 }
 void SliderFloat::OnMouseButtonPressed(MouseButtonPressedEvent& e)
@@ -685,7 +695,7 @@ void SliderFloat::OnMouseButtonPressed(MouseButtonPressedEvent& e)
 	if (m_mouseOverCircleState == MouseOverCircleState::OVER && e.GetMouseButton() == MOUSE_BUTTON::EG_LBUTTON)
 	{
 		m_mouseOverCircleState = MouseOverCircleState::DRAGGING;
-		m_OnBeginDragging(this, e);
+		m_callbacks.Invoke(OnBeginDraggingCallbackSlot, this, e);
 		e.Handled(this);
 		return;
 	}
@@ -697,7 +707,7 @@ void SliderFloat::OnMouseButtonReleased(MouseButtonReleasedEvent& e)
 	if (m_mouseOverCircleState == MouseOverCircleState::DRAGGING && e.GetMouseButton() == MOUSE_BUTTON::EG_LBUTTON)
 	{
 		m_mouseOverCircleState = CircleContainsPoint(e.GetX(), e.GetY()) ? MouseOverCircleState::OVER : MouseOverCircleState::NOT_OVER;
-		m_OnStoppedDragging(this, e);
+		m_callbacks.Invoke(OnStoppedDraggingCallbackSlot, this, e);
 		e.Handled(this);
 		return;
 	}
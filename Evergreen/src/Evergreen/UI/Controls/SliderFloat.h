@@ -1,6 +1,7 @@
 #pragma once
 #include "pch.h"
 #include "Control.h"
+#include "Evergreen/UI/Observable.h"
 #include "Evergreen/UI/Brushes.h"
 #include "Evergreen/UI/Controls/Text.h"
 #include "Evergreen/UI/Controls/TextInput.h"
@@ -106,6 +107,9 @@ public:
 	void SetMaximumValue(float maximum) noexcept;
 	void SetMiniumAndMaximumValues(float minimum, float maximum) noexcept;
 	void SetValue(float value) noexcept;
+	// Two-way binding: the slider follows 'source' (clamped to [minimum, maximum]), and moving the slider sets 'source'
+	void BindValue(Observable<float>& source);
+	inline void UnbindValue() noexcept { m_valueBinding.Reset(); }
 	inline void SetLineWidth(float width) noexcept { m_lineWidth = width; }
 	inline void SetCircleRadius(float radius) noexcept { m_circleRadius = radius; m_valueTextOnPopUp->AllowedRegion(GetPopUpRect()); }
 	inline void SetCircleRadiusOuter(float radius) noexcept { m_circleRadius2 = radius; }
@@ -148,11 +152,11 @@ public:
 
 	inline void SetValueFormatString(const std::wstring& fmt) noexcept { m_valueFormatString = fmt; UpdateValueTexts();  }
 	
-	inline void SetOnMouseEnteredCircleCallback(std::function<void(SliderFloat*, MouseMoveEvent& e)> func) noexcept { m_OnMouseEnteredCircle = func; }
-	inline void SetOnMouseExitedCircleCallback(std::function<void(SliderFloat*, MouseMoveEvent& e)> func) noexcept { m_OnMouseExitedCircle = func; }
-	inline void SetOnBeginDraggingCallback(std::function<void(SliderFloat*, MouseButtonPressedEvent& e)> func) noexcept { m_OnBeginDragging = func; }
-	inline void SetOnStoppedDraggingCallback(std::function<void(SliderFloat*, MouseButtonReleasedEvent& e)> func) noexcept { m_OnStoppedDragging = func; }
-	inline void SetOnValueChangedCallback(std::function<void(SliderFloat*, SliderFloatValueChangedEvent& e)> func) noexcept { m_OnValueChanged = func; }
+	inline void SetOnMouseEnteredCircleCallback(std::function<void(SliderFloat*, MouseMoveEvent& e)> func) noexcept { m_callbacks.Set(OnMouseEnteredCircleCallbackSlot, std::move(func)); }
+	inline void SetOnMouseExitedCircleCallback(std::function<void(SliderFloat*, MouseMoveEvent& e)> func) noexcept { m_callbacks.Set(OnMouseExitedCircleCallbackSlot, std::move(func)); }
+	inline void SetOnBeginDraggingCallback(std::function<void(SliderFloat*, MouseButtonPressedEvent& e)> func) noexcept { m_callbacks.Set(OnBeginDraggingCallbackSlot, std::move(func)); }
+	inline void SetOnStoppedDraggingCallback(std::function<void(SliderFloat*, MouseButtonReleasedEvent& e)> func) noexcept { m_callbacks.Set(OnStoppedDraggingCallbackSlot, std::move(func)); }
+	inline void SetOnValueChangedCallback(std::function<void(SliderFloat*, SliderFloatValueChangedEvent& e)> func) noexcept { m_callbacks.Set(OnValueChangedCallbackSlot, std::move(func)); }
 
 	virtual ControlType GetControlType() const noexcept override { return ControlType::SliderFloat; }
 
@@ -180,15 +184,16 @@ protected:
 
 	void UpdateValueTexts();
 
-	std::function<void(SliderFloat*, MouseMoveEvent&)> m_OnMouseEnteredCircle = [](SliderFloat*, MouseMoveEvent&) {};
-	std::function<void(SliderFloat*, MouseMoveEvent&)> m_OnMouseExitedCircle = [](SliderFloat*, MouseMoveEvent&) {};
-	std::function<void(SliderFloat*, MouseButtonPressedEvent&)> m_OnBeginDragging = [](SliderFloat*, MouseButtonPressedEvent&) {};
-	std::function<void(SliderFloat*, MouseButtonReleasedEvent&)> m_OnStoppedDragging = [](SliderFloat*, MouseButtonReleasedEvent&) {};
-	std::function<void(SliderFloat*, SliderFloatValueChangedEvent&)> m_OnValueChanged = [](SliderFloat*, SliderFloatValueChangedEvent&) {};
+	static constexpr CallbackSlot<void(SliderFloat*, MouseMoveEvent&)> OnMouseEnteredCircleCallbackSlot{ FirstDerivedCallbackSlot + 0 };
+	static constexpr CallbackSlot<void(SliderFloat*, MouseMoveEvent&)> OnMouseExitedCircleCallbackSlot{ FirstDerivedCallbackSlot + 1 };
+	static constexpr CallbackSlot<void(SliderFloat*, MouseButtonPressedEvent&)> OnBeginDraggingCallbackSlot{ FirstDerivedCallbackSlot + 2 };
+	static constexpr CallbackSlot<void(SliderFloat*, MouseButtonReleasedEvent&)> OnStoppedDraggingCallbackSlot{ FirstDerivedCallbackSlot + 3 };
+	static constexpr CallbackSlot<void(SliderFloat*, SliderFloatValueChangedEvent&)> OnValueChangedCallbackSlot{ FirstDerivedCallbackSlot + 4 };
 
 	float m_minValue;
 	float m_maxValue;
 	float m_value;
+	ObservableSubscription m_valueBinding;
 
 	float m_lineLeftX;
 	float m_lineRightX;
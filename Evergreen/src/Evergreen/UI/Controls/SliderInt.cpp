@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "SliderInt.h"
+#include "Evergreen/UI/UI.h"
 
 namespace Evergreen
 {
@@ -319,6 +320,7 @@ int SliderInt::PixelToValue(float pixel) const noexcept
 
 void SliderInt::Render() const
 {
+	EG_PROFILE_CONTROL_RENDER(this);
 	EG_CORE_ASSERT(m_deviceResources != nullptr, "No device resources");
 	EG_CORE_ASSERT(m_lineBrushLeft != nullptr, "No line brush left");
 	EG_CORE_ASSERT(m_lineBrushRight != nullptr, "No line brush right");
@@ -329,7 +331,7 @@ void SliderInt::Render() const
 	EG_CORE_ASSERT(m_valueTextInputOnRight != nullptr, "Should not be nullptr");
 	EG_CORE_ASSERT(m_valueTextOnPopUp != nullptr, "Should not be nullptr");
 
-	auto context = m_deviceResources->D2DDeviceContext();
+	DrawList& drawList = m_ui->GetDrawList();
 
 	float halfLineWidth = m_lineWidth / 2;
 	float lineTop = m_lineY - halfLineWidth;
@@ -340,7 +342,7 @@ void SliderInt::Render() const
 	{
 		D2D1_RECT_F leftRect = D2D1::RectF(m_lineLeftX, lineTop, m_circlePositionX, lineBottom);
 		D2D1_ROUNDED_RECT leftRoundedRect = D2D1::RoundedRect(leftRect, halfLineWidth, halfLineWidth);
-		context->FillRoundedRectangle(leftRoundedRect, m_lineBrushLeft->Get());
+		drawList.FillRoundedRectangle(leftRoundedRect, m_lineBrushLeft->Get());
 	}
 
 	// Right Line
@@ -350,20 +352,20 @@ void SliderInt::Render() const
 		D2D1_ROUNDED_RECT rightRoundedRect = D2D1::RoundedRect(rightRect, halfLineWidth, halfLineWidth);
 
 		if (m_fillLineRight)
-			context->FillRoundedRectangle(rightRoundedRect, m_lineBrushRight->Get());
+			drawList.FillRoundedRectangle(rightRoundedRect, m_lineBrushRight->Get());
 		else
-			context->DrawRoundedRectangle(rightRoundedRect, m_lineBrushRight->Get(), 1.0f);
+			drawList.DrawRoundedRectangle(rightRoundedRect, m_lineBrushRight->Get(), 1.0f);
 	}
 
 	// Circle
 	D2D1_ELLIPSE circle = D2D1::Ellipse(D2D1::Point2F(m_circlePositionX, m_lineY), m_circleRadius, m_circleRadius);
-	context->FillEllipse(circle, m_circleBrush->Get());
+	drawList.FillEllipse(circle, m_circleBrush->Get());
 
 	// Circle 2
 	if (m_mouseOverCircleState != MouseOverCircleState::NOT_OVER && m_circleBrush2 != nullptr)
 	{
 		D2D1_ELLIPSE circle2 = D2D1::Ellipse(D2D1::Point2F(m_circlePositionX, m_lineY), m_circleRadius2, m_circleRadius2);
-		context->FillEllipse(circle2, m_circleBrush2->Get());
+		drawList.FillEllipse(circle2, m_circleBrush2->Get());
 	}
 
 	// Min/Max text
@@ -382,15 +384,15 @@ void SliderInt::Render() const
 		if (m_popUpCornerRadiusX > 0.0f && m_popUpCornerRadiusY > 0.0f)
 		{
 			D2D1_ROUNDED_RECT popUpRounded = D2D1::RoundedRect(rect, m_popUpCornerRadiusX, m_popUpCornerRadiusY);
-			context->FillRoundedRectangle(popUpRounded, m_popUpBackgroundBrush->Get());
+			drawList.FillRoundedRectangle(popUpRounded, m_popUpBackgroundBrush->Get());
 			if (m_popUpBorderWidth > 0.0f)
-				context->DrawRoundedRectangle(popUpRounded, m_popUpBorderBrush->Get(), m_popUpBorderWidth);
+				drawList.DrawRoundedRectangle(popUpRounded, m_popUpBorderBrush->Get(), m_popUpBorderWidth);
 		}
 		else
 		{
-			context->FillRectangle(rect, m_popUpBackgroundBrush->Get());
+			drawList.FillRectangle(rect, m_popUpBackgroundBrush->Get());
 			if (m_popUpBorderWidth > 0.0f)
-				context->DrawRectangle(rect, m_popUpBorderBrush->Get(), m_popUpBorderWidth);
+				drawList.DrawRectangle(rect, m_popUpBorderBrush->Get(), m_popUpBorderWidth);
 		}
 
 		m_valueTextOnPopUp->Render();
@@ -470,9 +472,14 @@ void SliderInt::SetValue(int value) noexcept
 		SliderChanged();
 
 		SliderIntValueChangedEvent _e(m_value);
-		m_OnValueChanged(this, _e);
+		m_valueBinding.Write(m_value);
+		m_callbacks.Invoke(OnValueChangedCallbackSlot, this, _e);
 	}
 }
+void SliderInt::BindValue(Observable<int>& source)
+{
+	m_valueBinding = source.Subscribe([this](const int& value) { SetValue(std::clamp(value, m_minValue, m_maxValue)); });
+}
 void SliderInt::SetTextInputHeight(float height) noexcept
 {
 	if (height <= 0.0f)
@@ -584,7 +591,7 @@ void SliderInt::OnMouseMove(MouseMoveEvent& e)
 			if (!m_mouseIsOverCircle)
 			{
 				m_mouseIsOverCircle = true;
-				m_OnMouseEnteredCircle(this, e);
+				m_callbacks.Invoke(OnMouseEnteredCircleCallbackSlot, this, e);
 			}
 		}
 		else
@@ -592,7 +599,7 @@ void SliderInt::OnMouseMove(MouseMoveEvent& e)
 			if (m_mouseIsOverCircle)
 			{
 				m_mouseIsOverCircle = false;
-				m_OnMouseExitedCircle(this, e);
+				m_callbacks.Invoke(OnMouseExitedCircleCallbackSlot, this, e);
 			}
 		}
 
@@ -606,7 +613,8 @@ void SliderInt::OnMouseMove(MouseMoveEvent& e)
 				UpdateValueTexts();
 
 				SliderIntValueChangedEvent _e(m_value);
-				m_OnValueChanged(this, _e);
+				m_valueBinding.Write(m_value);
+				m_callbacks.Invoke(OnValueChangedCallbackSlot, this, _e);
 			}
 		}
 		else if (e.GetX() < m_lineLeftX)
@@ -618,7 +626,8 @@ void SliderInt::OnMouseMove(MouseMoveEvent& e)
 				UpdateValueTexts();
 
 				SliderIntValueChangedEvent _e(m_value);
-				m_OnValueChanged(this, _e);
+				m_valueBinding.Write(m_value);
+				m_callbacks.Invoke(OnValueChangedCallbackSlot, this, _e);
 			}
 		}
 		else
@@ -631,7 +640,8 @@ void SliderInt::OnMouseMove(MouseMoveEvent& e)
 				UpdateValueTexts();
 
 				SliderIntValueChangedEvent _e(m_value);
-				m_OnValueChanged(this, _e);
+				m_valueBinding.Write(m_value);
+				m_callbacks.Invoke(OnValueChangedCallbackSlot, this, _e);
 			}
 		}
 
@@ -644,7 +654,7 @@ void SliderInt::OnMouseMove(MouseMoveEvent& e)
 		if (currentMouseIsOverCircle)
 		{
 			m_mouseOverCircleState = MouseOverCircleState::OVER;
-			m_OnMouseEnteredCircle(this, e);
+			m_callbacks.Invoke(OnMouseEnteredCircleCallbackSlot, this, e);
 			e.Handled(this);
 			m_mouseIsOverCircle = currentMouseIsOverCircle;
 			return;
@@ -657,7 +667,7 @@ void SliderInt::OnMouseMove(MouseMoveEvent& e)
 		if (!currentMouseIsOverCircle)
 		{
 			m_mouseOverCircleState = MouseOverCircleState::NOT_OVER;
-			m_OnMouseExitedCircle(this, e);
+			m_callbacks.Invoke(OnMouseExitedCircleCallbackSlot, this, e);
 			break;
 		}
 		e.Handled(this);
@@ -675,7 +685,7 @@ void SliderInt::MouseMoveHandledByPane(MouseMoveEvent& e)
 	{
 		m_mouseOverCircleState = MouseOverCircleState::NOT_OVER;
 		m_mouseIsOverCircle = false;
-		m_OnMouseExitedCircle(this, e);
+		m_callbacks.Invoke(OnMouseExitedCircleCallbackSlot, this, e);
 	}
 }
 void SliderInt::OnMouseButtonPressed(MouseButtonPressedEvent& e)
@@ -683,7 +693,7 @@ void SliderInt::OnMouseButtonPressed(MouseButtonPressedEvent& e)
 	if (m_mouseOverCircleState == MouseOverCircleState::OVER && e.GetMouseButton() == MOUSE_BUTTON::EG_LBUTTON)
 	{
 		m_mouseOverCircleState = MouseOverCircleState::DRAGGING;
-		m_OnBeginDragging(this, e);
+		m_callbacks.Invoke(OnBeginDraggingCallbackSlot, this, e);
 		e.Handled(this);
 		return;
 	}
@@ -695,7 +705,7 @@ void SliderInt::OnMouseButtonReleased(MouseButtonReleasedEvent& e)
 	if (m_mouseOverCircleState == MouseOverCircleState::DRAGGING && e.GetMouseButton() == MOUSE_BUTTON::EG_LBUTTON)
 	{
 		m_mouseOverCircleState = CircleContainsPoint(e.GetX(), e.GetY()) ? MouseOverCircleState::OVER : MouseOverCircleState::NOT_OVER;
-		m_OnStoppedDragging(this, e);
+		m_callbacks.Invoke(OnStoppedDraggingCallbackSlot, this, e);
 		e.Handled(this);
 		return;
 	}
@@ -1,6 +1,7 @@
 #pragma once
 #include "pch.h"
 #include "Control.h"
+#include "Evergreen/UI/Observable.h"
 #include "Evergreen/UI/Brushes.h"
 #include "Evergreen/UI/Controls/Text.h"
 #include "Evergreen/UI/Controls/TextInput.h"
@@ -107,6 +108,9 @@ public:
 	void SetMaximumValue(int maximum) noexcept;
 	void SetMiniumAndMaximumValues(int minimum, int maximum) noexcept;
 	void SetValue(int value) noexcept;
+	// Two-way binding: the slider follows 'source' (clamped to [minimum, maximum]), and moving the slider sets 'source'
+	void BindValue(Observable<int>& source);
+	inline void UnbindValue() noexcept { m_valueBinding.Reset(); }
 	inline void SetLineWidth(float width) noexcept { m_lineWidth = width; }
 	inline void SetCircleRadius(float radius) noexcept { m_circleRadius = radius; m_valueTextOnPopUp->AllowedRegion(GetPopUpRect()); }
 	inline void SetCircleRadiusOuter(float radius) noexcept { m_circleRadius2 = radius; }
@@ -149,11 +153,11 @@ public:
 
 	inline void SetValueFormatString(const std::wstring& fmt) noexcept { m_valueFormatString = fmt; UpdateValueTexts(); }
 
-	inline void SetOnMouseEnteredCircleCallback(std::function<void(SliderInt*, MouseMoveEvent& e)> func) noexcept { m_OnMouseEnteredCircle = func; }
-	inline void SetOnMouseExitedCircleCallback(std::function<void(SliderInt*, MouseMoveEvent& e)> func) noexcept { m_OnMouseExitedCircle = func; }
-	inline void SetOnBeginDraggingCallback(std::function<void(SliderInt*, MouseButtonPressedEvent& e)> func) noexcept { m_OnBeginDragging = func; }
-	inline void SetOnStoppedDraggingCallback(std::function<void(SliderInt*, MouseButtonReleasedEvent& e)> func) noexcept { m_OnStoppedDragging = func; }
-	inline void SetOnValueChangedCallback(std::function<void(SliderInt*, SliderIntValueChangedEvent& e)> func) noexcept { m_OnValueChanged = func; }
+	inline void SetOnMouseEnteredCircleCallback(std::function<void(SliderInt*, MouseMoveEvent& e)> func) noexcept { m_callbacks.Set(OnMouseEnteredCircleCallbackSlot, std::move(func)); }
+	inline void SetOnMouseExitedCircleCallback(std::function<void(SliderInt*, MouseMoveEvent& e)> func) noexcept { m_callbacks.Set(OnMouseExitedCircleCallbackSlot, std::move(func)); }
+	inline void SetOnBeginDraggingCallback(std::function<void(SliderInt*, MouseButtonPressedEvent& e)> func) noexcept { m_callbacks.Set(OnBeginDraggingCallbackSlot, std::move(func)); }
+	inline void SetOnStoppedDraggingCallback(std::function<void(SliderInt*, MouseButtonReleasedEvent& e)> func) noexcept { m_callbacks.Set(OnStoppedDraggingCallbackSlot, std::move(func)); }
+	inline void SetOnValueChangedCallback(std::function<void(SliderInt*, SliderIntValueChangedEvent& e)> func) noexcept { m_callbacks.Set(OnValueChangedCallbackSlot, std::move(func)); }
 
 	virtual ControlType GetControlType() const noexcept override { return ControlType::SliderInt; }
 
@@ -181,15 +185,16 @@ protected:
 
 	void UpdateValueTexts();
 
-	std::function<void(SliderInt*, MouseMoveEvent&)> m_OnMouseEnteredCircle = [](SliderInt*, MouseMoveEvent&) {};
-	std::function<void(SliderInt*, MouseMoveEvent&)> m_OnMouseExitedCircle = [](SliderInt*, MouseMoveEvent&) {};
-	std::function<void(SliderInt*, MouseButtonPressedEvent&)> m_OnBeginDragging = [](SliderInt*, MouseButtonPressedEvent&) {};
-	std::function<void(SliderInt*, MouseButtonReleasedEvent&)> m_OnStoppedDragging = [](SliderInt*, MouseButtonReleasedEvent&) {};
-	std::function<void(SliderInt*, SliderIntValueChangedEvent&)> m_OnValueChanged = [](SliderInt*, SliderIntValueChangedEvent&) {};
+	static constexpr CallbackSlot<void(SliderInt*, MouseMoveEvent&)> OnMouseEnteredCircleCallbackSlot{ FirstDerivedCallbackSlot + 0 };
+	static constexpr CallbackSlot<void(SliderInt*, MouseMoveEvent&)> OnMouseExitedCircleCallbackSlot{ FirstDerivedCallbackSlot + 1 };
+	static constexpr CallbackSlot<void(SliderInt*, MouseButtonPressedEvent&)> OnBeginDraggingCallbackSlot{ FirstDerivedCallbackSlot + 2 };
+	static constexpr CallbackSlot<void(SliderInt*, MouseButtonReleasedEvent&)> OnStoppedDraggingCallbackSlot{ FirstDerivedCallbackSlot + 3 };
+	static constexpr CallbackSlot<void(SliderInt*, SliderIntValueChangedEvent&)> OnValueChangedCallbackSlot{ FirstDerivedCallbackSlot + 4 };
 
 	int m_minValue;
 	int m_maxValue;
 	int m_value;
+	ObservableSubscription m_valueBinding;
 
 	float m_lineLeftX;
 	float m_lineRightX;
@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "Text.h"
+#include "Evergreen/UI/UI.h"
 
 using Microsoft::WRL::ComPtr;
 
@@ -16,6 +17,7 @@ Text::Text(std::shared_ptr<DeviceResources> deviceResources,
 	m_text(text),
 	m_style(std::move(style)),
 	m_textLayout(nullptr),
+	m_textLayoutMemory(MemoryCategory::TEXT_LAYOUTS),
 	m_colorBrush(std::move(brush))
 {
 	// We cannot instantiate a SolidColorBrush as a default parameter, so the default is nullptr.
@@ -44,6 +46,7 @@ void Text::SetTextStyle(std::unique_ptr<TextStyle> style) noexcept
 
 void Text::Render() const
 {
+	EG_PROFILE_CONTROL_RENDER(this);
 	EG_CORE_ASSERT(m_deviceResources != nullptr, "No device resources");
 	EG_CORE_ASSERT(m_textLayout != nullptr, "TextLayout is nullptr");
 	EG_CORE_ASSERT(m_colorBrush != nullptr, "ColorBrush is nullptr");
@@ -51,20 +54,20 @@ void Text::Render() const
 	// NOTE: No need for any sort of error checking on the D2D API function calls.
 	//       They don't report success/failure - you need to check the result of EndDraw() which we already do
 
-	auto context = m_deviceResources->D2DDeviceContext();
-	context->PushAxisAlignedClip(m_allowedRegion, D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
+	DrawList& drawList = m_ui->GetDrawList();
+	drawList.PushAxisAlignedClip(m_allowedRegion, D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
 
 	// Don't set a transform - it will also affect the location of the AxisAlignedClip
 	//context->SetTransform(D2D1::Matrix3x2F::Translation(m_topLeftPosition.x, m_topLeftPosition.y - 15.0f));
 
-	context->DrawTextLayout(
+	drawList.DrawTextLayout(
 		D2D1::Point2F(m_allowedRegion.left + m_margin.Left, m_allowedRegion.top + m_margin.Top),
 		m_textLayout.Get(),
 		m_colorBrush->Get(),
 		D2D1_DRAW_TEXT_OPTIONS_CLIP			// <-- TODO: investigate these options, clipping is interesting
 	);
 
-	context->PopAxisAlignedClip();
+	drawList.PopAxisAlignedClip();
 }
 
 void Text::TextChanged() noexcept
@@ -78,6 +81,7 @@ void Text::TextChanged() noexcept
 		(m_allowedRegion.bottom - m_margin.Bottom) - (m_allowedRegion.top + m_margin.Top)
 	);
 	m_textLayout->GetMetrics(&m_textMetrics);
+	m_textLayoutMemory.Set(TextStyle::EstimatedTextLayoutSize(m_text.size()));
 
 	// If using a non-SolidColorBrush, we need to update the draw region for the brush
 	UpdateBrushDrawRegion();
@@ -88,19 +92,13 @@ float Text::RightSideOfCharacterAtIndex(unsigned int index) const noexcept
 	EG_CORE_ASSERT(index < m_text.size(), "Index is too large");
 	EG_CORE_ASSERT(m_style != nullptr, "No TextStyle");
 
-	std::wstring substring = m_text.substr(0, index + 1);
-
-	DWRITE_TEXT_METRICS metrics;
-	ZeroMemory(&metrics, sizeof(DWRITE_TEXT_METRICS));
+	EG_CORE_ASSERT(m_textLayout != nullptr, "TextLayout is nullptr");
 
-	ComPtr<IDWriteTextLayout4> layout;
-	layout = m_style->CreateTextLayout(
-		substring,
-		(m_allowedRegion.right - m_margin.Right) - (m_allowedRegion.left + m_margin.Left),
-		(m_allowedRegion.bottom - m_margin.Bottom) - (m_allowedRegion.top + m_margin.Top)
-	);
-	layout->GetMetrics(&metrics);
-	return Left() + metrics.widthIncludingTrailingWhitespace;
+	// Hit test the existing layout rather than laying out the substring again
+	FLOAT x, y;
+	DWRITE_HIT_TEST_METRICS metrics;
+	m_textLayout->HitTestTextPosition(index, TRUE, &x, &y, &metrics);
+	return Left() + x;
 }
 
 
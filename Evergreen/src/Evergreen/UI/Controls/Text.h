@@ -3,6 +3,7 @@
 #include "Control.h"
 #include "Evergreen/UI/Styles/TextStyle.h"
 #include "Evergreen/UI/Brushes.h"
+#include "Evergreen/UI/Observable.h"
 
 
 namespace Evergreen
@@ -53,6 +54,12 @@ public:
 	void SetTextStyle(std::unique_ptr<TextStyle> style) noexcept;
 	void SetColorBrush(std::unique_ptr<ColorBrush> brush) noexcept { m_colorBrush = std::move(brush); }
 
+	// Displays the value of 'source' (numbers are formatted with std::format). The text is only updated when the
+	// published value changes
+	template<typename T>
+	void BindText(Observable<T>& source);
+	inline void UnbindText() noexcept { m_textBinding.Reset(); }
+
 	void AddChar(char c, unsigned int index) noexcept;
 	void RemoveChar(unsigned int index) noexcept;
 
@@ -72,9 +79,32 @@ private:
 	DWRITE_TEXT_METRICS			m_textMetrics;
 
 	Microsoft::WRL::ComPtr<IDWriteTextLayout4>	m_textLayout;
+	ExternalMemory								m_textLayoutMemory;
+
+	ObservableSubscription		m_textBinding;
 };
 #pragma warning( pop )
 
+template<typename T>
+void Text::BindText(Observable<T>& source)
+{
+	m_textBinding = source.Subscribe([this](const T& value)
+		{
+			if constexpr (std::is_same_v<T, std::wstring>)
+			{
+				if (value != m_text)
+					SetText(value);
+			}
+			else
+			{
+				std::wstring text = std::format(L"{}", value);
+				if (text != m_text)
+					SetText(text);
+			}
+		}
+	);
+}
+
 
 
 
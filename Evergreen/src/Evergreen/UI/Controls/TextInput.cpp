@@ -1,11 +1,30 @@
 #include "pch.h"
 #include "TextInput.h"
+#include "Evergreen/UI/UI.h"
 
 
 namespace Evergreen
 {
 const float TextInput::m_originalMarginLeft = 4.0f;
 
+static std::wstring ReadClipboardText()
+{
+	std::wstring text;
+	if (!OpenClipboard(nullptr))
+		return text;
+
+	if (HANDLE data = GetClipboardData(CF_UNICODETEXT))
+	{
+		if (const wchar_t* chars = static_cast<const wchar_t*>(GlobalLock(data)))
+		{
+			text = chars;
+			GlobalUnlock(data);
+		}
+	}
+	CloseClipboard();
+	return text;
+}
+
 TextInput::TextInput(std::shared_ptr<DeviceResources> deviceResources,
 					UI* ui,
 					const D2D1_RECT_F& allowedRegion,
@@ -23,7 +42,6 @@ TextInput::TextInput(std::shared_ptr<DeviceResources> deviceResources,
 	m_placeholderText(placeholderText),
 	m_placeholderTextBrush(std::move(placeholderBrush)),
 	m_placeholderTextStyle(std::move(placeholderStyle)),
-	m_inputText(L""),
 	m_inputTextBrush(std::move(inputTextBrush)),
 	m_inputTextStyle(std::move(inputTextStyle)),
 	m_backgroundBrush(std::move(backgroundBrush)),
@@ -35,7 +53,11 @@ TextInput::TextInput(std::shared_ptr<DeviceResources> deviceResources,
 	m_mouseState(MouseOverState::NOT_OVER),
 	m_drawVerticalBar(false),
 	m_marginLeft(m_originalMarginLeft),
-	m_verticalBarWidth(2.0f)
+	m_verticalBarWidth(2.0f),
+	m_multiline(false),
+	m_lineHeight(0.0f),
+	m_scrollOffsetX(0.0f),
+	m_scrollOffsetY(0.0f)
 {
 	// Brushes
 	if (m_placeholderTextBrush == nullptr)
@@ -130,21 +152,51 @@ TextInput::TextInput(std::shared_ptr<DeviceResources> deviceResources,
 
 void TextInput::Render() const
 {
+	EG_PROFILE_CONTROL_RENDER(this);
 	EG_CORE_ASSERT(m_deviceResources != nullptr, "No device resources");
 	EG_CORE_ASSERT(m_layout != nullptr, "No layout");
 	EG_CORE_ASSERT(m_backgroundBrush != nullptr, "No background brush");
 	EG_CORE_ASSERT(m_borderBrush != nullptr, "No border brush");
 
 	// Draw the background
-	m_deviceResources->D2DDeviceContext()->FillRectangle(m_backgroundRect, m_backgroundBrush->Get());
+	m_ui->GetDrawList().FillRectangle(m_backgroundRect, m_backgroundBrush->Get());
 
 	// Have the layout draw the background and text
 	m_layout->Render();
 
-	// Draw vertical bar
-	if (m_drawVerticalBar)
+	if (m_multiline)
 	{
-		m_deviceResources->D2DDeviceContext()->DrawLine(
+		// Only the visible lines have a layout, so this is all we need to draw. The vertical bar is drawn within the
+		// same clip, because it may be on a line that is only partially visible
+		DrawList& drawList = m_ui->GetDrawList();
+		drawList.PushAxisAlignedClip(m_textRegionRect, D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
+
+		const float left = m_textRegionRect.left + m_originalMarginLeft - m_scrollOffsetX;
+		for (const LineLayout& lineLayout : m_lineLayouts)
+		{
+			drawList.DrawTextLayout(
+				D2D1::Point2F(left, m_textRegionRect.top + lineLayout.line * m_lineHeight - m_scrollOffsetY),
+				lineLayout.layout.Get(),
+				m_inputTextBrush->Get(),
+				D2D1_DRAW_TEXT_OPTIONS_CLIP
+			);
+		}
+
+		if (m_drawVerticalBar)
+		{
+			drawList.DrawLine(
+				D2D1::Point2F(m_verticalBarX, m_verticalBarTop),
+				D2D1::Point2F(m_verticalBarX, m_verticalBarBottom),
+				m_verticalBarBrush->Get(),
+				m_verticalBarWidth
+			);
+		}
+
+		drawList.PopAxisAlignedClip();
+	}
+	else if (m_drawVerticalBar)
+	{
+		m_ui->GetDrawList().DrawLine(
 			D2D1::Point2F(m_verticalBarX, m_verticalBarTop),
 			D2D1::Point2F(m_verticalBarX, m_verticalBarBottom),
 			m_verticalBarBrush->Get(),
@@ -154,7 +206,7 @@ void TextInput::Render() const
 
 	// Draw the border last so it appears on top
 	if (m_borderWidth > 0.0f)
-		m_deviceResources->D2DDeviceContext()->DrawRectangle(m_backgroundRect, m_borderBrush->Get(), m_borderWidth);
+		m_ui->GetDrawList().DrawRectangle(m_backgroundRect, m_borderBrush->Get(), m_borderWidth);
 }
 
 Layout* TextInput::AddRightColumnLayout(RowColumnDefinition rightColumnDefinition)
@@ -208,6 +260,13 @@ void TextInput::TextInputChanged() noexcept
 	m_textRegionRect.bottom = m_backgroundRect.bottom;
 	m_textRegionRect.right = m_layout->Columns()[0].Right();
 
+	// The number of visible lines may have changed (this also updates the vertical bar)
+	if (m_multiline)
+	{
+		SetScrollOffsetY(m_scrollOffsetY);
+		return;
+	}
+
 	// Update the location of the vertical bar
 	UpdateVerticalBar();
 }
@@ -216,6 +275,24 @@ void TextInput::UpdateVerticalBar() noexcept
 {
 	EG_CORE_ASSERT(m_text != nullptr, "No Text control");
 
+	if (m_multiline)
+	{
+		const size_t line = m_inputText.LineOfPosition(m_nextCharIndex);
+		m_verticalBarTop = m_textRegionRect.top + line * m_lineHeight - m_scrollOffsetY;
+		m_verticalBarBottom = m_verticalBarTop + m_lineHeight;
+		m_verticalBarX = m_textRegionRect.left + m_originalMarginLeft - m_scrollOffsetX;
+
+		// Lines that are not visible have no layout - the bar is clipped in that case anyways
+		if (const LineLayout* lineLayout = FindLineLayout(line))
+		{
+			FLOAT x, y;
+			DWRITE_HIT_TEST_METRICS metrics;
+			lineLayout->layout->HitTestTextPosition(static_cast<UINT32>(m_nextCharIndex - m_inputText.LineStart(line)), FALSE, &x, &y, &metrics);
+			m_verticalBarX += x;
+		}
+		return;
+	}
+
 	m_verticalBarTop = m_text->Top();
 	m_verticalBarBottom = m_text->Bottom();
 
@@ -224,7 +301,201 @@ void TextInput::UpdateVerticalBar() noexcept
 	else if (m_nextCharIndex == 0)
 		m_verticalBarX = m_text->Left();
 	else
-		m_verticalBarX = m_text->RightSideOfCharacterAtIndex(m_nextCharIndex - 1);
+		m_verticalBarX = m_text->RightSideOfCharacterAtIndex(static_cast<unsigned int>(m_nextCharIndex - 1));
+}
+
+void TextInput::UpdateLineHeight() noexcept
+{
+	EG_CORE_ASSERT(m_inputTextStyle != nullptr, "No input text style");
+
+	DWRITE_TEXT_METRICS metrics;
+	m_inputTextStyle->CreateTextLayout(L"M", 1000.0f, 1000.0f)->GetMetrics(&metrics);
+	m_lineHeight = std::max(1.0f, metrics.height);
+}
+
+const TextInput::LineLayout* TextInput::FindLineLayout(size_t line) const noexcept
+{
+	auto it = std::lower_bound(m_lineLayouts.begin(), m_lineLayouts.end(), line, [](const LineLayout& lineLayout, size_t l) { return lineLayout.line < l; });
+	return it != m_lineLayouts.end() && it->line == line ? &(*it) : nullptr;
+}
+
+void TextInput::InputTextEdited(size_t firstLine, size_t oldLineCount, size_t newLineCount) noexcept
+{
+	// Lines [firstLine, firstLine + oldLineCount) were replaced by [firstLine, firstLine + newLineCount). Only those
+	// lines need to be laid out again - the layouts of the lines after them are still valid, they just moved
+	const size_t oldEnd = firstLine + oldLineCount;
+	std::erase_if(m_lineLayouts, [firstLine, oldEnd](const LineLayout& lineLayout) { return lineLayout.line >= firstLine && lineLayout.line < oldEnd; });
+	for (LineLayout& lineLayout : m_lineLayouts)
+	{
+		if (lineLayout.line >= oldEnd)
+			lineLayout.line = lineLayout.line + newLineCount - oldLineCount;
+	}
+
+	ScrollToCaret();
+}
+
+void TextInput::UpdateVisibleLines() noexcept
+{
+	EG_CORE_ASSERT(m_inputTextStyle != nullptr, "No input text style");
+	EG_CORE_ASSERT(m_lineHeight > 0.0f, "Line height has not been computed");
+
+	const size_t lastLine = m_inputText.LineCount() - 1;
+	const size_t first = std::min(static_cast<size_t>(m_scrollOffsetY / m_lineHeight), lastLine);
+	const size_t last = std::min(static_cast<size_t>((m_scrollOffsetY + (m_textRegionRect.bottom - m_textRegionRect.top)) / m_lineHeight), lastLine);
+	const float width = std::max(1.0f, m_textRegionRect.right - m_textRegionRect.left);
+
+	// Reuse the layouts we already have and only create the ones for lines that just became visible (or were edited)
+	std::vector<LineLayout> visible;
+	visible.reserve(last - first + 1);
+
+	auto cached = m_lineLayouts.begin();
+	for (size_t line = first; line <= last; ++line)
+	{
+		while (cached != m_lineLayouts.end() && cached->line < line)
+			++cached;
+
+		if (cached != m_lineLayouts.end() && cached->line == line)
+			visible.push_back(std::move(*cached));
+		else
+		{
+			std::wstring text = m_inputText.Line(line);
+			const size_t layoutSize = TextStyle::EstimatedTextLayoutSize(text.size());
+			visible.push_back({ line, m_inputTextStyle->CreateTextLayout(std::move(text), width, m_lineHeight), ExternalMemory(MemoryCategory::TEXT_LAYOUTS, layoutSize) });
+		}
+	}
+
+	m_lineLayouts = std::move(visible);
+}
+
+void TextInput::SetScrollOffsetY(float offset) noexcept
+{
+	const float maxOffset = std::max(0.0f, m_inputText.LineCount() * m_lineHeight - (m_textRegionRect.bottom - m_textRegionRect.top));
+	m_scrollOffsetY = std::clamp(offset, 0.0f, maxOffset);
+
+	UpdateVisibleLines();
+	UpdateVerticalBar();
+}
+
+void TextInput::ScrollToCaret() noexcept
+{
+	// Vertically, scroll just enough to bring the caret's line into view
+	const float lineTop = m_inputText.LineOfPosition(m_nextCharIndex) * m_lineHeight;
+	const float regionHeight = m_textRegionRect.bottom - m_textRegionRect.top;
+
+	float offset = m_scrollOffsetY;
+	if (lineTop < offset)
+		offset = lineTop;
+	else if (lineTop + m_lineHeight > offset + regionHeight)
+		offset = lineTop + m_lineHeight - regionHeight;
+
+	SetScrollOffsetY(offset);
+
+	// Horizontally, jump by a quarter of the available space at a time (same as the single line mode)
+	const float textLeft = m_textRegionRect.left + m_originalMarginLeft;
+	const float regionWidth = (m_textRegionRect.right - m_textRegionRect.left) - 2.0f * m_originalMarginLeft;
+	const float caretX = m_verticalBarX - textLeft + m_scrollOffsetX;
+
+	if (caretX < m_scrollOffsetX)
+		m_scrollOffsetX = std::max(0.0f, caretX - regionWidth / 4.0f);
+	else if (caretX > m_scrollOffsetX + regionWidth)
+		m_scrollOffsetX = caretX - regionWidth * 0.75f;
+	else
+		return;
+
+	UpdateVerticalBar();
+}
+
+void TextInput::MoveCaretToLine(size_t line) noexcept
+{
+	const size_t currentLine = m_inputText.LineOfPosition(m_nextCharIndex);
+	const size_t column = m_nextCharIndex - m_inputText.LineStart(currentLine);
+	m_nextCharIndex = m_inputText.LineStart(line) + std::min(column, m_inputText.LineLength(line));
+}
+
+void TextInput::SetMultiline(bool multiline) noexcept
+{
+	EG_CORE_ASSERT(m_text != nullptr, "No Text");
+
+	if (m_multiline == multiline)
+		return;
+
+	m_multiline = multiline;
+	m_lineLayouts.clear();
+	m_scrollOffsetX = 0.0f;
+	m_scrollOffsetY = 0.0f;
+
+	if (m_multiline)
+	{
+		UpdateLineHeight();
+
+		// The Text control now only displays the placeholder text, so undo any horizontal scrolling
+		m_marginLeft = m_originalMarginLeft;
+		m_text->MarginLeft(m_marginLeft);
+	}
+	else if (m_inputText.LineCount() > 1)
+	{
+		std::wstring text = m_inputText.ToString();
+		std::replace(text.begin(), text.end(), L'\n', L' ');
+		m_inputText.Assign(std::move(text));
+	}
+
+	if (m_inputText.Empty() && !m_textInputControlIsSelected)
+		SetTextToPlaceholder();
+	else
+		SetTextToInput();
+
+	TextInputChanged();
+}
+
+void TextInput::InsertText(std::wstring_view text) noexcept
+{
+	EG_CORE_ASSERT(m_text != nullptr, "No Text");
+
+	// Normalize the line breaks ("\r\n" and '\r' become '\n'), which are not allowed at all in single line mode
+	std::wstring normalized;
+	normalized.reserve(text.size());
+	for (size_t iii = 0; iii < text.size(); ++iii)
+	{
+		wchar_t c = text[iii];
+		if (c == L'\r')
+		{
+			if (iii + 1 < text.size() && text[iii + 1] == L'\n')
+				continue;
+			c = L'\n';
+		}
+		if (c == L'\n' && !m_multiline)
+			c = L' ';
+		normalized.push_back(c);
+	}
+
+	if (normalized.empty())
+		return;
+
+	const bool wasEmpty = m_inputText.Empty();
+	const size_t line = m_inputText.LineOfPosition(m_nextCharIndex);
+	const size_t lineBreaks = static_cast<size_t>(std::count(normalized.begin(), normalized.end(), L'\n'));
+
+	m_inputText.Insert(m_nextCharIndex, normalized);
+	m_nextCharIndex += normalized.size();
+
+	if (m_multiline)
+	{
+		if (wasEmpty)
+			SetTextToInput(); // Removes the placeholder text
+
+		InputTextEdited(line, 1, 1 + lineBreaks);
+		return;
+	}
+
+	SetTextToInput();
+
+	// Same as typing a character: keep the right side of the text aligned with the right side of the control area
+	if (m_verticalBarX > m_textRegionRect.right)
+	{
+		m_marginLeft = -1.0f * (m_text->Width() - (m_textRegionRect.right - m_textRegionRect.left - 4.0f));
+		m_text->MarginLeft(m_marginLeft);
+		UpdateVerticalBar();
+	}
 }
 
 void TextInput::OnMarginChanged()
@@ -248,11 +519,16 @@ void TextInput::OnAllowedRegionChanged()
 
 	// I suppose it is probably possible that the size of the input string could change
 	// as the allowed region changes. So to be safe, just set the nextCharIndex to the end
-	// of the current string
-	m_nextCharIndex = static_cast<unsigned int>(m_inputText.size());
+	// of the current string (in multi-line mode, the caret stays where it is)
+	if (m_multiline)
+		ScrollToCaret();
+	else
+	{
+		m_nextCharIndex = m_inputText.Size();
 
-	// Update the location of the vertical bar
-	UpdateVerticalBar();
+		// Update the location of the vertical bar
+		UpdateVerticalBar();
+	}
 
 	// Update brush regions
 	m_backgroundBrush->SetDrawRegion(m_allowedRegion);
@@ -280,10 +556,14 @@ void TextInput::SetTextToInput() noexcept
 	EG_CORE_ASSERT(m_inputTextBrush != nullptr, "Input brush should not be nullptr");
 	EG_CORE_ASSERT(m_inputTextStyle != nullptr, "Input text style should not be nullptr");
 
-	m_text->SetText(m_inputText);
+	// In multi-line mode, the lines are drawn by the TextInput itself, so the Text control is left empty
+	m_text->SetText(m_multiline ? std::wstring() : m_inputText.ToString());
 	m_text->SetColorBrush(std::move(m_inputTextBrush->Duplicate()));
 	m_text->SetTextStyle(std::move(std::unique_ptr<TextStyle>(static_cast<TextStyle*>(m_inputTextStyle->Duplicate().release()))));
 
+	if (m_multiline)
+		UpdateVisibleLines();
+
 	UpdateVerticalBar();
 }
 
@@ -297,10 +577,43 @@ void TextInput::OnChar(CharEvent& e)
 	{
 		const char key = e.GetKeyCode();
 
+		// CTRL+V arrives as the SYN control character
+		if (key == 0x16)
+		{
+			InsertText(ReadClipboardText());
+			m_callbacks.Invoke(OnInputTextChangedCallbackSlot, this, e);
+			return;
+		}
+
+		if (m_multiline)
+		{
+			if (key == '\b')
+			{
+				if (m_nextCharIndex > 0)
+				{
+					--m_nextCharIndex;
+					const size_t line = m_inputText.LineOfPosition(m_nextCharIndex);
+					const bool joinsLines = m_inputText.At(m_nextCharIndex) == L'\n';
+
+					m_inputText.Erase(m_nextCharIndex, 1);
+					InputTextEdited(line, joinsLines ? 2 : 1, 1);
+				}
+			}
+			else
+			{
+				// InsertText() turns ENTER into a line break
+				const wchar_t c = key;
+				InsertText(std::wstring_view(&c, 1));
+			}
+
+			m_callbacks.Invoke(OnInputTextChangedCallbackSlot, this, e);
+			return;
+		}
+
 		// First, handle if the user presses ENTER
 		if (key == '\r' || key == '\n')
 		{
-			m_OnEnterKey(this, e);
+			m_callbacks.Invoke(OnEnterKeyCallbackSlot, this, e);
 			return;
 		}
 
@@ -309,8 +622,8 @@ void TextInput::OnChar(CharEvent& e)
 		{
 			if (m_nextCharIndex > 0)
 			{
-				m_inputText.erase(--m_nextCharIndex, 1);
-				m_text->RemoveChar(m_nextCharIndex);
+				m_inputText.Erase(--m_nextCharIndex, 1);
+				m_text->RemoveChar(static_cast<unsigned int>(m_nextCharIndex));
 
 				// If we have updated the left margin, we may need to update it again to shift the text back towards the right
 				if (m_marginLeft != m_originalMarginLeft)
@@ -342,13 +655,11 @@ void TextInput::OnChar(CharEvent& e)
 		{
 			// Update the input text string that is held locally (we need this to be able to swap back and
 			// forth between the input text and placeholder text)
-			if (m_nextCharIndex == m_inputText.size())
-				m_inputText.push_back(key);
-			else
-				m_inputText.insert(m_nextCharIndex, 1, key);
+			const wchar_t c = key;
+			m_inputText.Insert(m_nextCharIndex, std::wstring_view(&c, 1));
 
 			// Next, update Text control (Faster than calling SetText)
-			m_text->AddChar(key, m_nextCharIndex);
+			m_text->AddChar(key, static_cast<unsigned int>(m_nextCharIndex));
 			++m_nextCharIndex;
 
 			UpdateVerticalBar();
@@ -363,7 +674,7 @@ void TextInput::OnChar(CharEvent& e)
 			}
 		}
 
-		m_OnInputTextChanged(this, e);
+		m_callbacks.Invoke(OnInputTextChangedCallbackSlot, this, e);
 	}
 	else
 	{
@@ -379,7 +690,28 @@ void TextInput::OnKeyPressed(KeyPressedEvent& e)
 	// repeated. OnKeyReleased only occurs once when the key is actually released
 
 	// Only edit the text if this control has been clicked into
-	if (m_textInputControlIsSelected)
+	if (m_textInputControlIsSelected && m_multiline)
+	{
+		const size_t line = m_inputText.LineOfPosition(m_nextCharIndex);
+		const size_t visibleLineCount = static_cast<size_t>(std::max(1.0f, (m_textRegionRect.bottom - m_textRegionRect.top) / m_lineHeight));
+
+		switch (e.GetKeyCode())
+		{
+		case KEY_CODE::EG_LEFT_ARROW:	if (m_nextCharIndex > 0) --m_nextCharIndex; break;
+		case KEY_CODE::EG_RIGHT_ARROW:	if (m_nextCharIndex < m_inputText.Size()) ++m_nextCharIndex; break;
+		case KEY_CODE::EG_UP_ARROW:		if (line > 0) MoveCaretToLine(line - 1); break;
+		case KEY_CODE::EG_DOWN_ARROW:	if (line + 1 < m_inputText.LineCount()) MoveCaretToLine(line + 1); break;
+		case KEY_CODE::EG_PAGE_UP:		MoveCaretToLine(line - std::min(line, visibleLineCount)); break;
+		case KEY_CODE::EG_PAGE_DOWN:	MoveCaretToLine(std::min(line + visibleLineCount, m_inputText.LineCount() - 1)); break;
+		case KEY_CODE::EG_HOME:			m_nextCharIndex = m_inputText.LineStart(line); break;
+		case KEY_CODE::EG_END:			m_nextCharIndex = m_inputText.LineStart(line) + m_inputText.LineLength(line); break;
+		default:
+			return;
+		}
+
+		ScrollToCaret();
+	}
+	else if (m_textInputControlIsSelected)
 	{
 		switch (e.GetKeyCode())
 		{
@@ -439,7 +771,7 @@ void TextInput::OnMouseMove(MouseMoveEvent& e)
 	// We are going to just trigger the OnMouseMove callback as long as the mouse is moving over the
 	// control, even though the layout may decide to handle the event
 	if (mouseIsOver)
-		m_OnMouseMoved(this, e);
+		m_callbacks.Invoke(OnMouseMovedCallbackSlot, this, e);
 
 	// First pass to layout, if the layout does not handle it, then the control can handle it
 	m_layout->OnMouseMove(e);
@@ -454,7 +786,7 @@ void TextInput::OnMouseMove(MouseMoveEvent& e)
 			m_mouseState = MouseOverState::OVER;
 			e.Handled(this);
 			Window::SetCursor(Cursor::I_BEAM);
-			m_OnMouseEntered(this, e);
+			m_callbacks.Invoke(OnMouseEnteredCallbackSlot, this, e);
 		}
 		else if (m_textInputControlIsSelected)
 		{
@@ -468,7 +800,7 @@ void TextInput::OnMouseMove(MouseMoveEvent& e)
 		{
 			m_mouseState = MouseOverState::NOT_OVER;
 			Window::SetCursor(Cursor::ARROW);
-			m_OnMouseExited(this, e);
+			m_callbacks.Invoke(OnMouseExitedCallbackSlot, this, e);
 			return;
 		}
 
@@ -493,7 +825,12 @@ void TextInput::OnMouseMove(MouseMoveEvent& e)
 }
 void TextInput::OnMouseScrolledVertical(MouseScrolledEvent& e)
 {
-
+	if (m_multiline && ContainsPoint(e.GetX(), e.GetY()))
+	{
+		// Same as ScrollableLayout: mouse pad deltas are usually in the range [1-10], mouse wheel deltas are +/-120
+		SetScrollOffsetY(m_scrollOffsetY - static_cast<float>(std::abs(e.GetScrollDelta()) < 100 ? e.GetScrollDelta() : e.GetScrollDelta() / 10));
+		e.Handled(this);
+	}
 }
 void TextInput::OnMouseScrolledHorizontal(MouseScrolledEvent& e)
 {
@@ -513,7 +850,7 @@ void TextInput::OnMouseButtonPressed(MouseButtonPressedEvent& e)
 		m_drawVerticalBar = false;
 
 		// if the input text size is 0, reload the placeholder text
-		if (m_inputText.size() == 0)
+		if (m_inputText.Empty())
 			SetTextToPlaceholder();
 
 		return;
@@ -534,7 +871,7 @@ void TextInput::OnMouseButtonPressed(MouseButtonPressedEvent& e)
 		if (e.GetMouseButton() == MOUSE_BUTTON::EG_LBUTTON)
 		{
 			m_mouseState = MouseOverState::OVER_AND_LBUTTON_DOWN;
-			m_OnMouseLButtonDown(this, e);
+			m_callbacks.Invoke(OnMouseLButtonDownCallbackSlot, this, e);
 		}
 	}
 }
@@ -558,13 +895,29 @@ void TextInput::OnMouseButtonReleased(MouseButtonReleasedEvent& e)
 				m_drawVerticalBar = true;
 
 				// Only need to call SetTextToInput if we are switching back from placeholder which is only true if there is no input text
-				if (m_inputText.size() == 0)
+				if (m_inputText.Empty())
 					SetTextToInput();
 			}
 
 			// Update the location of the vertical bar based on where the user clicked
 			float x = e.GetX();
-			if (m_text->Right() < x) // If the user clicks right all the text, just set m_nextCharIndex to the end
+			if (m_multiline)
+			{
+				const float y = std::max(0.0f, e.GetY() - m_textRegionRect.top + m_scrollOffsetY);
+				const size_t line = std::min(static_cast<size_t>(y / m_lineHeight), m_inputText.LineCount() - 1);
+				m_nextCharIndex = m_inputText.LineStart(line);
+
+				if (const LineLayout* lineLayout = FindLineLayout(line))
+				{
+					BOOL isTrailingHit, isInside;
+					DWRITE_HIT_TEST_METRICS metrics;
+					lineLayout->layout->HitTestPoint(x - (m_textRegionRect.left + m_originalMarginLeft) + m_scrollOffsetX, m_lineHeight / 2.0f, &isTrailingHit, &isInside, &metrics);
+					m_nextCharIndex += std::min<size_t>(metrics.textPosition + (isTrailingHit ? metrics.length : 0), m_inputText.LineLength(line));
+				}
+
+				ScrollToCaret();
+			}
+			else if (m_text->Right() < x) // If the user clicks right all the text, just set m_nextCharIndex to the end
 				m_nextCharIndex = m_text->Size();
 			else
 			{
@@ -578,16 +931,17 @@ void TextInput::OnMouseButtonReleased(MouseButtonReleasedEvent& e)
 				}
 			}
 
-			UpdateVerticalBar();
+			if (!m_multiline)
+				UpdateVerticalBar();
 			
 			e.Handled(this);
-			m_OnClick(this, e);
+			m_callbacks.Invoke(OnClickCallbackSlot, this, e);
 			return;
 		}
 		else if (m_mouseState == MouseOverState::NOT_OVER_AND_LBUTTON_DOWN)
 		{
 			m_mouseState = MouseOverState::NOT_OVER;
-			m_OnClick(this, e);
+			m_callbacks.Invoke(OnClickCallbackSlot, this, e);
 			return;
 		}
 	}
@@ -611,7 +965,7 @@ void TextInput::SetPlaceholderText(const std::wstring& placeholderText) noexcept
 	m_placeholderText = placeholderText;
 
 	// If there is no input text and the control is not selected, display the placeholder text
-	if (m_inputText.size() == 0 && !m_textInputControlIsSelected)
+	if (m_inputText.Empty() && !m_textInputControlIsSelected)
 	{
 		SetTextToPlaceholder();
 	}
@@ -623,7 +977,7 @@ void TextInput::SetPlaceholderTextStyle(std::unique_ptr<TextStyle> style) noexce
 	m_placeholderTextStyle = std::move(style);
 
 	// If there is no input text and the control is not selected, display the placeholder text
-	if (m_inputText.size() == 0 && !m_textInputControlIsSelected)
+	if (m_inputText.Empty() && !m_textInputControlIsSelected)
 	{
 		SetTextToPlaceholder();
 	}
@@ -635,21 +989,25 @@ void TextInput::SetPlaceholderTextBrush(std::unique_ptr<ColorBrush> brush) noexc
 	m_placeholderTextBrush = std::move(brush);
 
 	// If there is no input text and the control is not selected, display the placeholder text
-	if (m_inputText.size() == 0 && !m_textInputControlIsSelected)
+	if (m_inputText.Empty() && !m_textInputControlIsSelected)
 	{
 		SetTextToPlaceholder();
 	}
 }
 void TextInput::SetInputText(const std::wstring& inputText) noexcept
 {
-	m_inputText = inputText;
+	m_inputText.Assign(inputText);
+	m_nextCharIndex = m_inputText.Size();
+	m_lineLayouts.clear();
+	m_scrollOffsetX = 0.0f;
 
-	if (inputText.size() > 0)
-	{		
-		m_nextCharIndex = static_cast<unsigned int>(m_inputText.size());
+	if (inputText.size() > 0 || m_textInputControlIsSelected)
+	{
 		SetTextToInput();
+		if (m_multiline)
+			ScrollToCaret();
 	}
-	else if (!m_textInputControlIsSelected)
+	else
 	{
 		SetTextToPlaceholder();
 	}
@@ -660,7 +1018,14 @@ void TextInput::SetInputTextStyle(std::unique_ptr<TextStyle> style) noexcept
 
 	m_inputTextStyle = std::move(style);
 
-	if (m_inputText.size() > 0 || m_textInputControlIsSelected)
+	if (m_multiline)
+	{
+		UpdateLineHeight();
+		m_lineLayouts.clear();
+		SetScrollOffsetY(m_scrollOffsetY);
+	}
+
+	if (m_inputText.Size() > 0 || m_textInputControlIsSelected)
 	{
 		SetTextToInput();
 	}
@@ -671,7 +1036,7 @@ void TextInput::SetInputTextBrush(std::unique_ptr<ColorBrush> brush) noexcept
 
 	m_inputTextBrush = std::move(brush);
 
-	if (m_inputText.size() > 0 || m_textInputControlIsSelected)
+	if (m_inputText.Size() > 0 || m_textInputControlIsSelected)
 	{
 		SetTextToInput();
 	}
@@ -2,6 +2,7 @@
 #include "pch.h"
 #include "Text.h"
 #include "Evergreen/UI/Layout.h"
+#include "Evergreen/Utils/PieceTable.h"
 
 namespace Evergreen
 {
@@ -65,10 +66,18 @@ public:
 	inline void SetVerticalBarWidth(float width) noexcept;
 	inline void ActivateForTextInput() noexcept { m_textInputControlIsSelected = true; }
 
+	// In multi-line mode, ENTER inserts a line break (instead of triggering the OnEnterKey callback), the arrow keys and
+	// mouse wheel move through the lines, and only the lines that are visible are laid out and drawn
+	void SetMultiline(bool multiline) noexcept;
+	// Inserts the text at the caret (ex. a paste). In single-line mode, line breaks are replaced by spaces
+	void InsertText(std::wstring_view text) noexcept;
+
 	ND inline const std::wstring& GetPlaceholderText() const noexcept { return m_placeholderText; }
 	ND inline TextStyle* GetPlaceholderTextStyle() const noexcept { return m_placeholderTextStyle.get(); }
 	ND inline const ColorBrush* GetPlaceholderTextBrush() const noexcept { return m_placeholderTextBrush.get(); }
-	ND inline const std::wstring& GetInputText() const noexcept { return m_inputText; }
+	ND inline std::wstring GetInputText() const { return m_inputText.ToString(); }
+	ND inline const PieceTable& GetInputTextBuffer() const noexcept { return m_inputText; }
+	ND inline bool IsMultiline() const noexcept { return m_multiline; }
 	ND inline TextStyle* GetInputTextStyle() const noexcept { return m_inputTextStyle.get(); }
 	ND inline const ColorBrush* GetInputTextBrush() const noexcept { return m_inputTextBrush.get(); }
 	ND inline const ColorBrush* GetBackgroundBrush() const noexcept { return m_backgroundBrush.get(); }
@@ -78,24 +87,24 @@ public:
 	ND inline float GetVerticalBarWidth() const noexcept { return m_verticalBarWidth; }
 
 	// Callback Setters
-	void SetOnMouseEnteredCallback(std::function<void(TextInput*, MouseMoveEvent&)> func) noexcept { m_OnMouseEntered = func; }
-	void SetOnMouseExitedCallback(std::function<void(TextInput*, MouseMoveEvent&)> func) noexcept { m_OnMouseExited = func; }
-	void SetOnMouseMovedCallback(std::function<void(TextInput*, MouseMoveEvent&)> func) noexcept { m_OnMouseMoved = func; }
-	void SetOnMouseLButtonDownCallback(std::function<void(TextInput*, MouseButtonPressedEvent&)> func) noexcept { m_OnMouseLButtonDown = func; }
-	void SetOnClickCallback(std::function<void(TextInput*, MouseButtonReleasedEvent&)> func) noexcept { m_OnClick = func; }
-	void SetOnEnterKeyCallback(std::function<void(TextInput*, CharEvent&)> func) noexcept { m_OnEnterKey = func; }
-	void SetOnInputTextChangedCallback(std::function<void(TextInput*, CharEvent&)> func) noexcept { m_OnInputTextChanged = func; }
+	void SetOnMouseEnteredCallback(std::function<void(TextInput*, MouseMoveEvent&)> func) noexcept { m_callbacks.Set(OnMouseEnteredCallbackSlot, std::move(func)); }
+	void SetOnMouseExitedCallback(std::function<void(TextInput*, MouseMoveEvent&)> func) noexcept { m_callbacks.Set(OnMouseExitedCallbackSlot, std::move(func)); }
+	void SetOnMouseMovedCallback(std::function<void(TextInput*, MouseMoveEvent&)> func) noexcept { m_callbacks.Set(OnMouseMovedCallbackSlot, std::move(func)); }
+	void SetOnMouseLButtonDownCallback(std::function<void(TextInput*, MouseButtonPressedEvent&)> func) noexcept { m_callbacks.Set(OnMouseLButtonDownCallbackSlot, std::move(func)); }
+	void SetOnClickCallback(std::function<void(TextInput*, MouseButtonReleasedEvent&)> func) noexcept { m_callbacks.Set(OnClickCallbackSlot, std::move(func)); }
+	void SetOnEnterKeyCallback(std::function<void(TextInput*, CharEvent&)> func) noexcept { m_callbacks.Set(OnEnterKeyCallbackSlot, std::move(func)); }
+	void SetOnInputTextChangedCallback(std::function<void(TextInput*, CharEvent&)> func) noexcept { m_callbacks.Set(OnInputTextChangedCallbackSlot, std::move(func)); }
 
 	virtual ControlType GetControlType() const noexcept override { return ControlType::TextInput; }
 
 private:
-	std::function<void(TextInput*, MouseMoveEvent&)> m_OnMouseEntered = [](TextInput*, MouseMoveEvent&) {};
-	std::function<void(TextInput*, MouseMoveEvent&)> m_OnMouseExited = [](TextInput*, MouseMoveEvent&) {};
-	std::function<void(TextInput*, MouseMoveEvent&)> m_OnMouseMoved = [](TextInput*, MouseMoveEvent&) {};
-	std::function<void(TextInput*, MouseButtonPressedEvent&)> m_OnMouseLButtonDown = [](TextInput*, MouseButtonPressedEvent&) {};
-	std::function<void(TextInput*, MouseButtonReleasedEvent&)> m_OnClick = [](TextInput*, MouseButtonReleasedEvent&) {};
-	std::function<void(TextInput*, CharEvent&)> m_OnEnterKey = [](TextInput*, CharEvent&) {};
-	std::function<void(TextInput*, CharEvent&)> m_OnInputTextChanged = [](TextInput*, CharEvent&) {};
+	static constexpr CallbackSlot<void(TextInput*, MouseMoveEvent&)> OnMouseEnteredCallbackSlot{ FirstDerivedCallbackSlot + 0 };
+	static constexpr CallbackSlot<void(TextInput*, MouseMoveEvent&)> OnMouseExitedCallbackSlot{ FirstDerivedCallbackSlot + 1 };
+	static constexpr CallbackSlot<void(TextInput*, MouseMoveEvent&)> OnMouseMovedCallbackSlot{ FirstDerivedCallbackSlot + 2 };
+	static constexpr CallbackSlot<void(TextInput*, MouseButtonPressedEvent&)> OnMouseLButtonDownCallbackSlot{ FirstDerivedCallbackSlot + 3 };
+	static constexpr CallbackSlot<void(TextInput*, MouseButtonReleasedEvent&)> OnClickCallbackSlot{ FirstDerivedCallbackSlot + 4 };
+	static constexpr CallbackSlot<void(TextInput*, CharEvent&)> OnEnterKeyCallbackSlot{ FirstDerivedCallbackSlot + 5 };
+	static constexpr CallbackSlot<void(TextInput*, CharEvent&)> OnInputTextChangedCallbackSlot{ FirstDerivedCallbackSlot + 6 };
 
 
 	enum class MouseOverState
@@ -120,6 +129,21 @@ private:
 
 	void UpdateVerticalBar() noexcept;
 
+	// Multi-line mode
+	struct LineLayout
+	{
+		size_t line;
+		Microsoft::WRL::ComPtr<IDWriteTextLayout4> layout;
+		ExternalMemory memory;
+	};
+	void InputTextEdited(size_t firstLine, size_t oldLineCount, size_t newLineCount) noexcept;
+	void UpdateVisibleLines() noexcept;
+	void ScrollToCaret() noexcept;
+	void SetScrollOffsetY(float offset) noexcept;
+	void MoveCaretToLine(size_t line) noexcept;
+	ND const LineLayout* FindLineLayout(size_t line) const noexcept;
+	void UpdateLineHeight() noexcept;
+
 	std::unique_ptr<Layout> m_layout;
 	Layout* m_rightSublayout;
 
@@ -128,13 +152,13 @@ private:
 
 	// Data that will be used to update the Text control
 	std::wstring m_placeholderText;
-	std::wstring m_inputText;
+	PieceTable m_inputText;
 	std::unique_ptr<ColorBrush>	m_placeholderTextBrush;
 	std::unique_ptr<ColorBrush>	m_inputTextBrush;
 	std::unique_ptr<TextStyle>	m_placeholderTextStyle;
 	std::unique_ptr<TextStyle>	m_inputTextStyle;
 	bool m_textInputControlIsSelected;
-	unsigned int m_nextCharIndex;
+	size_t m_nextCharIndex;
 
 	// Other
 	MouseOverState				m_mouseState;
@@ -157,6 +181,14 @@ private:
 	static const float m_originalMarginLeft;
 	float m_marginLeft;
 	D2D1_RECT_F m_textRegionRect;
+
+	// Data for multi-line mode. m_lineLayouts only holds the visible lines (in order) - an edit only re-creates the
+	// layouts of the lines it touched
+	bool m_multiline;
+	float m_lineHeight;
+	float m_scrollOffsetX;
+	float m_scrollOffsetY;
+	std::vector<LineLayout> m_lineLayouts;
 };
 #pragma warning( pop )
 
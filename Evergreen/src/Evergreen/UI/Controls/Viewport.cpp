@@ -49,7 +49,7 @@ void Viewport::ViewportChanged()
 		m_viewport.Height
 	);
 
-	m_OnSizeChanged(m_viewport.Width, m_viewport.Height);
+	m_callbacks.Invoke(OnSizeChangedCallbackSlot, m_viewport.Width, m_viewport.Height);
 }
 void Viewport::OnMarginChanged()
 {
@@ -67,6 +67,7 @@ void Viewport::OnUpdate(const Timer& timer)
 }
 void Viewport::Render() const
 {
+	EG_PROFILE_CONTROL_RENDER(this);
 	EG_CORE_ASSERT(m_layout != nullptr, "Layout is nullptr");
 	m_layout->Render();
 }
@@ -80,7 +81,7 @@ void Viewport::OnChar(CharEvent& e)
 
 	if (m_selected)
 	{
-		m_OnChar(this, e);
+		m_callbacks.Invoke(OnCharCallbackSlot, this, e);
 		e.Handled(this);
 	}
 }
@@ -93,7 +94,7 @@ void Viewport::OnKeyPressed(KeyPressedEvent& e)
 
 	if (m_selected)
 	{
-		m_OnKeyPressed(this, e);
+		m_callbacks.Invoke(OnKeyPressedCallbackSlot, this, e);
 		e.Handled(this);
 	}
 }
@@ -106,7 +107,7 @@ void Viewport::OnKeyReleased(KeyReleasedEvent& e)
 
 	if (m_selected)
 	{
-		m_OnKeyReleased(this, e);
+		m_callbacks.Invoke(OnKeyReleasedCallbackSlot, this, e);
 		e.Handled(this);
 	}
 }
@@ -124,18 +125,18 @@ void Viewport::OnMouseMove(MouseMoveEvent& e)
 		if (!currentMouseIsOver)
 		{
 			m_mouseIsOver = false;
-			m_OnMouseExited(this, e);
+			m_callbacks.Invoke(OnMouseExitedCallbackSlot, this, e);
 
 			// Continue to track the move events if a button is down
 			if (m_mouseLButtonDown || m_mouseMButtonDown || m_mouseRButtonDown || m_mouseX1ButtonDown || m_mouseX2ButtonDown)
 			{
-				m_OnMouseMoved(this, e);
+				m_callbacks.Invoke(OnMouseMovedCallbackSlot, this, e);
 				e.Handled(this);
 			}
 		}
 		else 
 		{
-			m_OnMouseMoved(this, e);
+			m_callbacks.Invoke(OnMouseMovedCallbackSlot, this, e);
 			e.Handled(this);
 		}
 	}
@@ -143,7 +144,7 @@ void Viewport::OnMouseMove(MouseMoveEvent& e)
 	{
 		// NOTE: Don't set m_selected = true because we only want it to be selected after it has been clicked
 		m_mouseIsOver = true;
-		m_OnMouseEntered(this, e);
+		m_callbacks.Invoke(OnMouseEnteredCallbackSlot, this, e);
 		e.Handled(this);
 	}
 	else if (m_selected)
@@ -152,7 +153,7 @@ void Viewport::OnMouseMove(MouseMoveEvent& e)
 		// (this the viewport will become unselected when the user clicks on another control)
 		if (m_mouseLButtonDown || m_mouseMButtonDown || m_mouseRButtonDown || m_mouseX1ButtonDown || m_mouseX2ButtonDown)
 		{
-			m_OnMouseMoved(this, e);
+			m_callbacks.Invoke(OnMouseMovedCallbackSlot, this, e);
 		}
 		e.Handled(this);
 	}
@@ -160,7 +161,7 @@ void Viewport::OnMouseMove(MouseMoveEvent& e)
 void Viewport::MouseMoveHandledByPane(MouseMoveEvent& e)
 {
 	m_mouseIsOver = false;
-	m_OnMouseExited(this, e);
+	m_callbacks.Invoke(OnMouseExitedCallbackSlot, this, e);
 }
 void Viewport::OnMouseScrolledVertical(MouseScrolledEvent& e)
 {
@@ -171,7 +172,7 @@ void Viewport::OnMouseScrolledVertical(MouseScrolledEvent& e)
 
 	if (m_mouseIsOver)
 	{
-		m_OnMouseScrolledVertical(this, e);
+		m_callbacks.Invoke(OnMouseScrolledVerticalCallbackSlot, this, e);
 		e.Handled(this);
 	}
 }
@@ -184,7 +185,7 @@ void Viewport::OnMouseScrolledHorizontal(MouseScrolledEvent& e)
 
 	if (m_mouseIsOver)
 	{
-		m_OnMouseScrolledHorizontal(this, e);
+		m_callbacks.Invoke(OnMouseScrolledHorizontalCallbackSlot, this, e);
 		e.Handled(this);
 	}
 }
@@ -206,7 +207,7 @@ void Viewport::OnMouseButtonPressed(MouseButtonPressedEvent& e)
 		}
 
 		m_selected = true;
-		m_OnMouseButtonPressed(this, e);
+		m_callbacks.Invoke(OnMouseButtonPressedCallbackSlot, this, e);
 		e.Handled(this);
 	}
 	else
@@ -225,8 +226,8 @@ void Viewport::OnMouseButtonReleased(MouseButtonReleasedEvent& e)
 		if (m_mouseLButtonDown)
 		{
 			m_mouseLButtonDown = false;
-			m_OnMouseButtonReleased(this, e);
-			m_OnClick(this, e);
+			m_callbacks.Invoke(OnMouseButtonReleasedCallbackSlot, this, e);
+			m_callbacks.Invoke(OnClickCallbackSlot, this, e);
 			e.Handled(this);
 		}
 		else
@@ -238,8 +239,8 @@ void Viewport::OnMouseButtonReleased(MouseButtonReleasedEvent& e)
 		if (m_mouseMButtonDown)
 		{
 			m_mouseMButtonDown = false;
-			m_OnMouseButtonReleased(this, e);
-			m_OnClick(this, e);
+			m_callbacks.Invoke(OnMouseButtonReleasedCallbackSlot, this, e);
+			m_callbacks.Invoke(OnClickCallbackSlot, this, e);
 			e.Handled(this);
 		}
 		else
@@ -251,8 +252,8 @@ void Viewport::OnMouseButtonReleased(MouseButtonReleasedEvent& e)
 		if (m_mouseRButtonDown)
 		{
 			m_mouseRButtonDown = false;
-			m_OnMouseButtonReleased(this, e);
-			m_OnClick(this, e);
+			m_callbacks.Invoke(OnMouseButtonReleasedCallbackSlot, this, e);
+			m_callbacks.Invoke(OnClickCallbackSlot, this, e);
 			e.Handled(this);
 		}
 		else
@@ -264,8 +265,8 @@ void Viewport::OnMouseButtonReleased(MouseButtonReleasedEvent& e)
 		if (m_mouseX1ButtonDown)
 		{
 			m_mouseX1ButtonDown = false;
-			m_OnMouseButtonReleased(this, e);
-			m_OnClick(this, e);
+			m_callbacks.Invoke(OnMouseButtonReleasedCallbackSlot, this, e);
+			m_callbacks.Invoke(OnClickCallbackSlot, this, e);
 			e.Handled(this);
 		}
 		else
@@ -277,8 +278,8 @@ void Viewport::OnMouseButtonReleased(MouseButtonReleasedEvent& e)
 		if (m_mouseX2ButtonDown)
 		{
 			m_mouseX2ButtonDown = false;
-			m_OnMouseButtonReleased(this, e);
-			m_OnClick(this, e);
+			m_callbacks.Invoke(OnMouseButtonReleasedCallbackSlot, this, e);
+			m_callbacks.Invoke(OnClickCallbackSlot, this, e);
 			e.Handled(this);
 		}
 		else
@@ -297,7 +298,7 @@ void Viewport::OnMouseButtonDoubleClick(MouseButtonDoubleClickEvent& e)
 
 	if (m_mouseIsOver)
 	{
-		m_OnDoubleClick(this, e);
+		m_callbacks.Invoke(OnDoubleClickCallbackSlot, this, e);
 		e.Handled(this);
 	}
 }
@@ -41,20 +41,20 @@ public:
 	ND inline Layout* GetLayout() const noexcept { return m_layout.get(); }
 
 	// SET
-	inline void SetOnCharCallback(std::function<void(Viewport*, CharEvent& e)> func) { m_OnChar = func; }
-	inline void SetOnKeyPressedCallback(std::function<void(Viewport*, KeyPressedEvent& e)> func) { m_OnKeyPressed = func; }
-	inline void SetOnKeyReleasedCallback(std::function<void(Viewport*, KeyReleasedEvent& e)> func) { m_OnKeyReleased = func; }
-	inline void SetOnMouseEnteredCallback(std::function<void(Viewport*, MouseMoveEvent& e)> func) { m_OnMouseEntered = func; }
-	inline void SetOnMouseExitedCallback(std::function<void(Viewport*, MouseMoveEvent& e)> func) { m_OnMouseExited = func; }
-	inline void SetOnMouseMovedCallback(std::function<void(Viewport*, MouseMoveEvent& e)> func) { m_OnMouseMoved = func; }
-	inline void SetOnMouseScrolledVerticalCallback(std::function<void(Viewport*, MouseScrolledEvent& e)> func) { m_OnMouseScrolledVertical = func; }
-	inline void SetOnMouseScrolledHorizontalCallback(std::function<void(Viewport*, MouseScrolledEvent& e)> func) { m_OnMouseScrolledHorizontal = func; }
-	inline void SetOnMouseButtonPressedCallback(std::function<void(Viewport*, MouseButtonPressedEvent& e)> func) { m_OnMouseButtonPressed = func; }
-	inline void SetOnMouseButtonReleasedCallback(std::function<void(Viewport*, MouseButtonReleasedEvent& e)> func) { m_OnMouseButtonReleased = func; }
-	inline void SetOnClickCallback(std::function<void(Viewport*, MouseButtonReleasedEvent& e)> func) { m_OnClick = func; }
-	inline void SetOnDoubleClickCallback(std::function<void(Viewport*, MouseButtonDoubleClickEvent& e)> func) { m_OnDoubleClick = func; }
-
-	inline void SetOnSizeChangedCallback(std::function<void(float, float)> fn) noexcept { m_OnSizeChanged = fn; }
+	inline void SetOnCharCallback(std::function<void(Viewport*, CharEvent& e)> func) { m_callbacks.Set(OnCharCallbackSlot, std::move(func)); }
+	inline void SetOnKeyPressedCallback(std::function<void(Viewport*, KeyPressedEvent& e)> func) { m_callbacks.Set(OnKeyPressedCallbackSlot, std::move(func)); }
+	inline void SetOnKeyReleasedCallback(std::function<void(Viewport*, KeyReleasedEvent& e)> func) { m_callbacks.Set(OnKeyReleasedCallbackSlot, std::move(func)); }
+	inline void SetOnMouseEnteredCallback(std::function<void(Viewport*, MouseMoveEvent& e)> func) { m_callbacks.Set(OnMouseEnteredCallbackSlot, std::move(func)); }
+	inline void SetOnMouseExitedCallback(std::function<void(Viewport*, MouseMoveEvent& e)> func) { m_callbacks.Set(OnMouseExitedCallbackSlot, std::move(func)); }
+	inline void SetOnMouseMovedCallback(std::function<void(Viewport*, MouseMoveEvent& e)> func) { m_callbacks.Set(OnMouseMovedCallbackSlot, std::move(func)); }
+	inline void SetOnMouseScrolledVerticalCallback(std::function<void(Viewport*, MouseScrolledEvent& e)> func) { m_callbacks.Set(OnMouseScrolledVerticalCallbackSlot, std::move(func)); }
+	inline void SetOnMouseScrolledHorizontalCallback(std::function<void(Viewport*, MouseScrolledEvent& e)> func) { m_callbacks.Set(OnMouseScrolledHorizontalCallbackSlot, std::move(func)); }
+	inline void SetOnMouseButtonPressedCallback(std::function<void(Viewport*, MouseButtonPressedEvent& e)> func) { m_callbacks.Set(OnMouseButtonPressedCallbackSlot, std::move(func)); }
+	inline void SetOnMouseButtonReleasedCallback(std::function<void(Viewport*, MouseButtonReleasedEvent& e)> func) { m_callbacks.Set(OnMouseButtonReleasedCallbackSlot, std::move(func)); }
+	inline void SetOnClickCallback(std::function<void(Viewport*, MouseButtonReleasedEvent& e)> func) { m_callbacks.Set(OnClickCallbackSlot, std::move(func)); }
+	inline void SetOnDoubleClickCallback(std::function<void(Viewport*, MouseButtonDoubleClickEvent& e)> func) { m_callbacks.Set(OnDoubleClickCallbackSlot, std::move(func)); }
+
+	inline void SetOnSizeChangedCallback(std::function<void(float, float)> fn) noexcept { m_callbacks.Set(OnSizeChangedCallbackSlot, std::move(fn)); }
 
 	// Event handling
 	void OnChar(CharEvent& e) override;
@@ -78,20 +78,20 @@ protected:
 
 	ND inline bool ContainsPoint(float x, float y) const noexcept;
 
-	std::function<void(Viewport*, CharEvent&)> m_OnChar = [](Viewport*, CharEvent&) {};
-	std::function<void(Viewport*, KeyPressedEvent&)> m_OnKeyPressed = [](Viewport*, KeyPressedEvent&) {};
-	std::function<void(Viewport*, KeyReleasedEvent&)> m_OnKeyReleased = [](Viewport*, KeyReleasedEvent&) {};
-	std::function<void(Viewport*, MouseMoveEvent&)> m_OnMouseEntered = [](Viewport*, MouseMoveEvent&) {};
-	std::function<void(Viewport*, MouseMoveEvent&)> m_OnMouseExited = [](Viewport*, MouseMoveEvent&) {};
-	std::function<void(Viewport*, MouseMoveEvent&)> m_OnMouseMoved = [](Viewport*, MouseMoveEvent&) {};
-	std::function<void(Viewport*, MouseScrolledEvent&)> m_OnMouseScrolledVertical = [](Viewport*, MouseScrolledEvent&) {};
-	std::function<void(Viewport*, MouseScrolledEvent&)> m_OnMouseScrolledHorizontal = [](Viewport*, MouseScrolledEvent&) {};
-	std::function<void(Viewport*, MouseButtonPressedEvent&)> m_OnMouseButtonPressed = [](Viewport*, MouseButtonPressedEvent&) {};
-	std::function<void(Viewport*, MouseButtonReleasedEvent&)> m_OnMouseButtonReleased = [](Viewport*, MouseButtonReleasedEvent&) {};
-	std::function<void(Viewport*, MouseButtonReleasedEvent&)> m_OnClick = [](Viewport*, MouseButtonReleasedEvent&) {};
-	std::function<void(Viewport*, MouseButtonDoubleClickEvent&)> m_OnDoubleClick = [](Viewport*, MouseButtonDoubleClickEvent&) {};
-
-	std::function<void(float, float)> m_OnSizeChanged = [](float width, float height) {};
+	static constexpr CallbackSlot<void(Viewport*, CharEvent&)> OnCharCallbackSlot{ FirstDerivedCallbackSlot + 0 };
+	static constexpr CallbackSlot<void(Viewport*, KeyPressedEvent&)> OnKeyPressedCallbackSlot{ FirstDerivedCallbackSlot + 1 };
+	static constexpr CallbackSlot<void(Viewport*, KeyReleasedEvent&)> OnKeyReleasedCallbackSlot{ FirstDerivedCallbackSlot + 2 };
+	static constexpr CallbackSlot<void(Viewport*, MouseMoveEvent&)> OnMouseEnteredCallbackSlot{ FirstDerivedCallbackSlot + 3 };
+	static constexpr CallbackSlot<void(Viewport*, MouseMoveEvent&)> OnMouseExitedCallbackSlot{ FirstDerivedCallbackSlot + 4 };
+	static constexpr CallbackSlot<void(Viewport*, MouseMoveEvent&)> OnMouseMovedCallbackSlot{ FirstDerivedCallbackSlot + 5 };
+	static constexpr CallbackSlot<void(Viewport*, MouseScrolledEvent&)> OnMouseScrolledVerticalCallbackSlot{ FirstDerivedCallbackSlot + 6 };
+	static constexpr CallbackSlot<void(Viewport*, MouseScrolledEvent&)> OnMouseScrolledHorizontalCallbackSlot{ FirstDerivedCallbackSlot + 7 };
+	static constexpr CallbackSlot<void(Viewport*, MouseButtonPressedEvent&)> OnMouseButtonPressedCallbackSlot{ FirstDerivedCallbackSlot + 8 };
+	static constexpr CallbackSlot<void(Viewport*, MouseButtonReleasedEvent&)> OnMouseButtonReleasedCallbackSlot{ FirstDerivedCallbackSlot + 9 };
+	static constexpr CallbackSlot<void(Viewport*, MouseButtonReleasedEvent&)> OnClickCallbackSlot{ FirstDerivedCallbackSlot + 10 };
+	static constexpr CallbackSlot<void(Viewport*, MouseButtonDoubleClickEvent&)> OnDoubleClickCallbackSlot{ FirstDerivedCallbackSlot + 11 };
+	static constexpr CallbackSlot<void(float, float)> OnSizeChangedCallbackSlot{ FirstDerivedCallbackSlot + 12 };
+
 
 	D3D11_VIEWPORT m_viewport;
 	std::unique_ptr<Layout>	m_layout;
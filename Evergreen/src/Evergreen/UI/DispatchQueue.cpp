@@ -0,0 +1,167 @@
+#include "pch.h"
+#include "DispatchQueue.h"
+#include "Evergreen/Log.h"
+
+namespace Evergreen
+{
+DispatchQueue::DispatchQueue() noexcept :
+	m_head(&m_stub),
+	m_tail(&m_stub),
+	m_slots(std::make_unique<Slot[]>(MaxCoalescingKeys))
+{
+}
+
+DispatchQueue::~DispatchQueue() noexcept
+{
+	// Work that was never drained is discarded
+	while (Node* node = Pop())
+		delete node;
+
+	for (size_t iii = 0; iii < MaxCoalescingKeys; ++iii)
+	{
+		delete m_slots[iii].latest.load(std::memory_order_acquire);
+		delete m_slots[iii].key.load(std::memory_order_acquire);
+	}
+}
+
+void DispatchQueue::Push(Node* node) noexcept
+{
+	node->next.store(nullptr, std::memory_order_relaxed);
+	Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+	// Between the exchange and this store, the queue is briefly "broken" at 'previous' - Pop() treats that as empty
+	previous->next.store(node, std::memory_order_release);
+}
+
+DispatchQueue::Node* DispatchQueue::Pop() noexcept
+{
+	Node* tail = m_tail;
+	Node* next = tail->next.load(std::memory_order_acquire);
+
+	if (tail == &m_stub)
+	{
+		if (next == nullptr)
+			return nullptr;
+		m_tail = next;
+		tail = next;
+		next = next->next.load(std::memory_order_acquire);
+	}
+
+	if (next != nullptr)
+	{
+		m_tail = next;
+		return tail;
+	}
+
+	// 'tail' is the last node. We can only hand it out after putting the stub behind it, otherwise the queue would
+	// become empty with m_tail pointing at a node we gave away
+	if (tail != m_head.load(std::memory_order_acquire))
+		return nullptr; // A producer is in the middle of pushing - try again next time
+
+	Push(&m_stub);
+
+	next = tail->next.load(std::memory_order_acquire);
+	if (next != nullptr)
+	{
+		m_tail = next;
+		return tail;
+	}
+	return nullptr;
+}
+
+size_t DispatchQueue::FindOrAddSlot(std::string_view key)
+{
+	const uint64_t hash = static_cast<uint64_t>(std::hash<std::string_view>()(key));
+
+	// Only allocated if we reach an unused slot, i.e. the first time a key is posted
+	std::unique_ptr<SlotKey> candidate;
+
+	// Open addressing with linear probing. Slots are never removed, so a key always stays in the slot it claimed. Keys
+	// are compared in full, so two keys whose hashes collide get separate slots instead of superseding each other's work
+	for (size_t probe = 0; probe < MaxCoalescingKeys; ++probe)
+	{
+		const size_t index = (static_cast<size_t>(hash) + probe) & (MaxCoalescingKeys - 1);
+		const SlotKey* slotKey = m_slots[index].key.load(std::memory_order_acquire);
+		if (slotKey == nullptr)
+		{
+			if (candidate == nullptr)
+				candidate = std::make_unique<SlotKey>(SlotKey{ hash, std::string(key) });
+
+			// On failure, 'slotKey' is the key another thread just claimed the slot with - it may well be ours
+			if (m_slots[index].key.compare_exchange_strong(slotKey, candidate.get(), std::memory_order_acq_rel))
+			{
+				candidate.release();
+				return index;
+			}
+		}
+		if (slotKey->hash == hash && slotKey->name == key)
+			return index;
+	}
+	return NoSlot;
+}
+
+void DispatchQueue::Post(WorkFn fn)
+{
+	Node* node = new Node();
+	node->fn = std::move(fn);
+	m_pushedCount.fetch_add(1, std::memory_order_relaxed);
+	Push(node);
+}
+
+void DispatchQueue::PostCoalesced(std::string_view key, WorkFn fn)
+{
+	static_assert((MaxCoalescingKeys & (MaxCoalescingKeys - 1)) == 0, "MaxCoalescingKeys must be a power of 2");
+
+	const size_t slot = FindOrAddSlot(key);
+	if (slot == NoSlot)
+	{
+		Post(std::move(fn));
+		return;
+	}
+
+	Node* work = new Node();
+	work->fn = std::move(fn);
+
+	Node* superseded = m_slots[slot].latest.exchange(work, std::memory_order_acq_rel);
+	if (superseded != nullptr)
+	{
+		// The slot is already queued - it will run our work instead
+		delete superseded;
+		return;
+	}
+
+	Node* marker = new Node();
+	marker->slot = slot;
+	m_pushedCount.fetch_add(1, std::memory_order_relaxed);
+	Push(marker);
+}
+
+size_t DispatchQueue::Drain()
+{
+	// Only run what had been posted when we started (see header)
+	const uint64_t pushedCount = m_pushedCount.load(std::memory_order_acquire);
+
+	size_t ran = 0;
+	while (m_poppedCount < pushedCount)
+	{
+		Node* node = Pop();
+		if (node == nullptr)
+			break;
+		++m_poppedCount;
+
+		if (node->slot != NoSlot)
+		{
+			// Take the slot's latest work. Anything posted to the key from now on queues the slot again
+			Node* work = m_slots[node->slot].latest.exchange(nullptr, std::memory_order_acq_rel);
+			delete node;
+			node = work;
+			EG_CORE_ASSERT(node != nullptr, "A queued coalescing slot should always hold work");
+		}
+
+		node->fn();
+		delete node;
+		++ran;
+	}
+	return ran;
+}
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "pch.h"
+#include "Evergreen/Core.h"
+
+#include <atomic>
+
+// NOTE: DispatchQueue only uses the C++20 standard library (no Windows APIs).
+
+namespace Evergreen
+{
+// Lets any thread hand work to the UI thread. Posting never takes a lock: work items go into an intrusive
+// multi-producer/single-consumer queue (Vyukov) that the UI thread drains once per frame.
+//
+// PostCoalesced() keeps only the most recent work item per key - ex. a background task reporting its progress 1000s
+// of times per second only causes one control update per frame. Each key owns a slot holding its latest work item:
+// posting swaps the new item into the slot and only enqueues the slot if it was empty, so a superseded item is just
+// deleted by whichever thread swapped it out.
+#pragma warning( push )
+#pragma warning( disable : 4251 ) // needs to have dll-interface to be used by clients of class
+class EVERGREEN_API DispatchQueue
+{
+public:
+	using WorkFn = std::function<void()>;
+
+	// Maximum number of distinct keys passed to PostCoalesced(). Beyond that, coalesced posts fall back to Post()
+	static constexpr size_t MaxCoalescingKeys = 1024;
+
+	DispatchQueue() noexcept;
+	DispatchQueue(const DispatchQueue&) = delete;
+	DispatchQueue& operator=(const DispatchQueue&) = delete;
+	~DispatchQueue() noexcept;
+
+	// Any thread
+	void Post(WorkFn fn);
+	void PostCoalesced(std::string_view key, WorkFn fn);
+
+	// UI thread only. Runs the work that was posted before this call started - work posted by the work items
+	// themselves runs on the next call, so a work item that re-posts itself cannot stall the frame. Returns the
+	// number of work items that ran
+	size_t Drain();
+
+private:
+	struct Node
+	{
+		WorkFn fn;
+		std::atomic<Node*> next = nullptr;
+		size_t slot = NoSlot;		// Coalesced: the slot to take the work from (fn is empty)
+	};
+	static constexpr size_t NoSlot = SIZE_MAX;
+
+	// Immutable once a slot has claimed it. The hash is compared first so that most mismatches skip the string compare
+	struct SlotKey
+	{
+		uint64_t hash;
+		std::string name;
+	};
+
+	struct alignas(64) Slot
+	{
+		std::atomic<const SlotKey*> key = nullptr;	// nullptr = unused
+		std::atomic<Node*> latest = nullptr;
+	};
+
+	void Push(Node* node) noexcept;
+	Node* Pop() noexcept;
+	size_t FindOrAddSlot(std::string_view key);
+
+	alignas(64) std::atomic<Node*> m_head;		// Producers
+	alignas(64) Node* m_tail;					// Consumer
+	Node m_stub;
+	std::atomic<uint64_t> m_pushedCount = 0;
+	uint64_t m_poppedCount = 0;
+
+	std::unique_ptr<Slot[]> m_slots;
+};
+#pragma warning( pop )
+
+}
@@ -0,0 +1,274 @@
+#include "pch.h"
+#include "DrawList.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace Evergreen
+{
+// DrawList ----------------------------------------------------------------------------------------------------------
+DrawCommand& DrawList::Add(DrawCommandType type, ID2D1Brush* brush, float strokeWidth)
+{
+	DrawCommand& command = m_commands.emplace_back();
+	command.type = type;
+	command.strokeWidth = strokeWidth;
+	command.brush = brush;
+	return command;
+}
+
+void DrawList::FillRectangle(const D2D1_RECT_F& rect, ID2D1Brush* brush)
+{
+	EG_CORE_ASSERT(brush != nullptr, "No brush");
+	Add(DrawCommandType::FILL_RECTANGLE, brush).roundedRect = D2D1::RoundedRect(rect, 0.0f, 0.0f);
+}
+void DrawList::DrawRectangle(const D2D1_RECT_F& rect, ID2D1Brush* brush, float strokeWidth)
+{
+	EG_CORE_ASSERT(brush != nullptr, "No brush");
+	Add(DrawCommandType::DRAW_RECTANGLE, brush, strokeWidth).roundedRect = D2D1::RoundedRect(rect, 0.0f, 0.0f);
+}
+void DrawList::FillRoundedRectangle(const D2D1_ROUNDED_RECT& roundedRect, ID2D1Brush* brush)
+{
+	EG_CORE_ASSERT(brush != nullptr, "No brush");
+	Add(DrawCommandType::FILL_ROUNDED_RECTANGLE, brush).roundedRect = roundedRect;
+}
+void DrawList::DrawRoundedRectangle(const D2D1_ROUNDED_RECT& roundedRect, ID2D1Brush* brush, float strokeWidth)
+{
+	EG_CORE_ASSERT(brush != nullptr, "No brush");
+	Add(DrawCommandType::DRAW_ROUNDED_RECTANGLE, brush, strokeWidth).roundedRect = roundedRect;
+}
+void DrawList::FillEllipse(const D2D1_ELLIPSE& ellipse, ID2D1Brush* brush)
+{
+	EG_CORE_ASSERT(brush != nullptr, "No brush");
+	Add(DrawCommandType::FILL_ELLIPSE, brush).ellipse = ellipse;
+}
+void DrawList::DrawEllipse(const D2D1_ELLIPSE& ellipse, ID2D1Brush* brush, float strokeWidth)
+{
+	EG_CORE_ASSERT(brush != nullptr, "No brush");
+	Add(DrawCommandType::DRAW_ELLIPSE, brush, strokeWidth).ellipse = ellipse;
+}
+void DrawList::DrawLine(D2D1_POINT_2F point0, D2D1_POINT_2F point1, ID2D1Brush* brush, float strokeWidth)
+{
+	EG_CORE_ASSERT(brush != nullptr, "No brush");
+	Add(DrawCommandType::DRAW_LINE, brush, strokeWidth).line = { point0, point1 };
+}
+void DrawList::DrawTextLayout(D2D1_POINT_2F origin, IDWriteTextLayout* textLayout, ID2D1Brush* brush, D2D1_DRAW_TEXT_OPTIONS options)
+{
+	EG_CORE_ASSERT(brush != nullptr, "No brush");
+	EG_CORE_ASSERT(textLayout != nullptr, "No text layout");
+	Add(DrawCommandType::DRAW_TEXT_LAYOUT, brush).text = { origin, textLayout, options };
+}
+void DrawList::PushAxisAlignedClip(const D2D1_RECT_F& rect, D2D1_ANTIALIAS_MODE antialiasMode)
+{
+	Add(DrawCommandType::PUSH_CLIP, nullptr).clip = { rect, antialiasMode };
+	++m_clipDepth;
+}
+void DrawList::PopAxisAlignedClip()
+{
+	EG_CORE_ASSERT(m_clipDepth > 0, "PopAxisAlignedClip without a matching PushAxisAlignedClip");
+	Add(DrawCommandType::POP_CLIP, nullptr);
+	--m_clipDepth;
+}
+
+// DrawListRenderer --------------------------------------------------------------------------------------------------
+static bool RectsOverlap(const D2D1_RECT_F& a, const D2D1_RECT_F& b) noexcept
+{
+	return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+}
+
+// Only the shape matters for the geometry - the brush and stroke width are applied when it is drawn
+static bool SameShape(const DrawCommand& a, const DrawCommand& b) noexcept
+{
+	if (a.type != b.type)
+		return false;
+
+	if (a.type == DrawCommandType::DRAW_LINE)
+		return a.line.point0.x == b.line.point0.x && a.line.point0.y == b.line.point0.y &&
+			a.line.point1.x == b.line.point1.x && a.line.point1.y == b.line.point1.y;
+
+	const D2D1_RECT_F& ra = a.roundedRect.rect;
+	const D2D1_RECT_F& rb = b.roundedRect.rect;
+	return ra.left == rb.left && ra.top == rb.top && ra.right == rb.right && ra.bottom == rb.bottom;
+}
+
+static uint64_t HashShapes(std::span<const DrawCommand> batch) noexcept
+{
+	// FNV-1a over the type and coordinates of each command
+	uint64_t hash = 14695981039346656037ull;
+	auto mix = [&hash](const void* data, size_t size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t iii = 0; iii < size; ++iii)
+		{
+			hash ^= bytes[iii];
+			hash *= 1099511628211ull;
+		}
+	};
+
+	for (const DrawCommand& command : batch)
+	{
+		mix(&command.type, sizeof(command.type));
+		if (command.type == DrawCommandType::DRAW_LINE)
+			mix(&command.line, sizeof(command.line));
+		else
+			mix(&command.roundedRect.rect, sizeof(command.roundedRect.rect));
+	}
+	return hash;
+}
+
+DrawListRenderer::DrawListRenderer(std::shared_ptr<DeviceResources> deviceResources) noexcept :
+	m_deviceResources(deviceResources)
+{
+	EG_CORE_ASSERT(m_deviceResources != nullptr, "No device resources");
+}
+
+size_t DrawListRenderer::FindBatchEnd(std::span<const DrawCommand> commands, size_t start) noexcept
+{
+	EG_CORE_ASSERT(start < commands.size(), "Start index out of range");
+
+	const DrawCommand& first = commands[start];
+	if (first.type != DrawCommandType::DRAW_LINE && first.type != DrawCommandType::FILL_RECTANGLE && first.type != DrawCommandType::DRAW_RECTANGLE)
+		return start + 1;
+
+	const size_t last = std::min(commands.size(), start + MaxBatchSize);
+	size_t end = start + 1;
+	for (; end < last; ++end)
+	{
+		const DrawCommand& command = commands[end];
+		if (command.type != first.type || command.brush != first.brush || command.strokeWidth != first.strokeWidth)
+			break;
+
+		// Overlapping fills are blended once per rectangle when drawn separately, but only once when they are part of
+		// the same geometry, so only merge fills that do not overlap. Strokes are merged regardless, because borders
+		// always meet at their corners - this only differs for translucent brushes, at the points where lines meet
+		if (command.type == DrawCommandType::FILL_RECTANGLE)
+		{
+			bool overlaps = false;
+			for (size_t iii = start; iii < end && !overlaps; ++iii)
+				overlaps = RectsOverlap(commands[iii].roundedRect.rect, command.roundedRect.rect);
+
+			if (overlaps)
+				break;
+		}
+	}
+
+	return end;
+}
+
+ID2D1PathGeometry* DrawListRenderer::GetBatchGeometry(std::span<const DrawCommand> batch)
+{
+	const uint64_t hash = HashShapes(batch);
+
+	CachedGeometry& cached = m_geometryCache[hash];
+	cached.lastUsedFrame = m_frame;
+
+	if (cached.geometry != nullptr && std::equal(batch.begin(), batch.end(), cached.commands.begin(), cached.commands.end(), SameShape))
+	{
+		++m_stats.geometriesReused;
+		return cached.geometry.Get();
+	}
+
+	ComPtr<ID2D1PathGeometry> geometry;
+	GFX_THROW_INFO(
+		m_deviceResources->D2DFactory()->CreatePathGeometry(geometry.ReleaseAndGetAddressOf())
+	)
+
+	ComPtr<ID2D1GeometrySink> sink;
+	GFX_THROW_INFO(
+		geometry->Open(sink.ReleaseAndGetAddressOf())
+	)
+
+	// Winding, so that rectangles which touch do not cancel each other out
+	sink->SetFillMode(D2D1_FILL_MODE_WINDING);
+
+	for (const DrawCommand& command : batch)
+	{
+		if (command.type == DrawCommandType::DRAW_LINE)
+		{
+			sink->BeginFigure(command.line.point0, D2D1_FIGURE_BEGIN_HOLLOW);
+			sink->AddLine(command.line.point1);
+			sink->EndFigure(D2D1_FIGURE_END_OPEN);
+		}
+		else
+		{
+			const D2D1_RECT_F& rect = command.roundedRect.rect;
+			sink->BeginFigure(D2D1::Point2F(rect.left, rect.top), D2D1_FIGURE_BEGIN_FILLED);
+			sink->AddLine(D2D1::Point2F(rect.right, rect.top));
+			sink->AddLine(D2D1::Point2F(rect.right, rect.bottom));
+			sink->AddLine(D2D1::Point2F(rect.left, rect.bottom));
+			sink->EndFigure(D2D1_FIGURE_END_CLOSED);
+		}
+	}
+
+	GFX_THROW_INFO(
+		sink->Close()
+	)
+
+	++m_stats.geometriesCreated;
+	cached.commands.assign(batch.begin(), batch.end());
+	cached.geometry = std::move(geometry);
+	return cached.geometry.Get();
+}
+
+void DrawListRenderer::ReplayCommand(const DrawCommand& command)
+{
+	auto context = m_deviceResources->D2DDeviceContext();
+
+	switch (command.type)
+	{
+	case DrawCommandType::FILL_RECTANGLE:			context->FillRectangle(command.roundedRect.rect, command.brush); break;
+	case DrawCommandType::DRAW_RECTANGLE:			context->DrawRectangle(command.roundedRect.rect, command.brush, command.strokeWidth); break;
+	case DrawCommandType::FILL_ROUNDED_RECTANGLE:	context->FillRoundedRectangle(command.roundedRect, command.brush); break;
+	case DrawCommandType::DRAW_ROUNDED_RECTANGLE:	context->DrawRoundedRectangle(command.roundedRect, command.brush, command.strokeWidth); break;
+	case DrawCommandType::FILL_ELLIPSE:				context->FillEllipse(command.ellipse, command.brush); break;
+	case DrawCommandType::DRAW_ELLIPSE:				context->DrawEllipse(command.ellipse, command.brush, command.strokeWidth); break;
+	case DrawCommandType::DRAW_LINE:				context->DrawLine(command.line.point0, command.line.point1, command.brush, command.strokeWidth); break;
+	case DrawCommandType::DRAW_TEXT_LAYOUT:			context->DrawTextLayout(command.text.origin, command.text.layout, command.brush, command.text.options); break;
+	case DrawCommandType::PUSH_CLIP:				context->PushAxisAlignedClip(command.clip.rect, command.clip.antialiasMode); break;
+	case DrawCommandType::POP_CLIP:					context->PopAxisAlignedClip(); break;
+	default:
+		EG_CORE_ERROR("{}:{} - Unrecognized DrawCommandType: {}", __FILE__, __LINE__, static_cast<int>(command.type));
+		break;
+	}
+}
+
+void DrawListRenderer::Replay(const DrawList& drawList)
+{
+	EG_CORE_ASSERT(drawList.ClipDepth() == 0, "DrawList has a PushAxisAlignedClip without a matching PopAxisAlignedClip");
+
+	++m_frame;
+	m_stats = {};
+
+	std::span<const DrawCommand> commands = drawList.Commands();
+	m_stats.commands = commands.size();
+
+	auto context = m_deviceResources->D2DDeviceContext();
+
+	for (size_t iii = 0; iii < commands.size();)
+	{
+		const size_t end = FindBatchEnd(commands, iii);
+		if (end - iii > 1)
+		{
+			const DrawCommand& first = commands[iii];
+			ID2D1PathGeometry* geometry = GetBatchGeometry(commands.subspan(iii, end - iii));
+
+			if (first.type == DrawCommandType::FILL_RECTANGLE)
+				context->FillGeometry(geometry, first.brush);
+			else
+				context->DrawGeometry(geometry, first.brush, first.strokeWidth);
+
+			++m_stats.batches;
+			m_stats.batchedCommands += end - iii;
+		}
+		else
+		{
+			ReplayCommand(commands[iii]);
+		}
+
+		++m_stats.drawCalls;
+		iii = end;
+	}
+
+	// Drop the geometries of batches that were not drawn this frame
+	std::erase_if(m_geometryCache, [this](const auto& entry) { return entry.second.lastUsedFrame != m_frame; });
+}
+
+}
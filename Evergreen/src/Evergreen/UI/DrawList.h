@@ -0,0 +1,152 @@
+#pragma once
+#include "pch.h"
+#include "Evergreen/Core.h"
+#include "Evergreen/Rendering/DeviceResources.h"
+
+#include <span>
+#include <unordered_map>
+
+// Recorded UI drawing. Controls and layouts do not call Direct2D from Render() - they append DrawCommands to the UI's
+// DrawList (see UI::GetDrawList), whose methods mirror the subset of ID2D1DeviceContext the UI uses. Once the whole UI
+// has been recorded, a DrawListRenderer replays the list in order, merging runs of adjacent lines/rectangles that share
+// a brush and stroke width into a single path geometry. For example, a layout border becomes one DrawGeometry call
+// instead of up to eight DrawLine calls.
+//
+// Commands are plain data and hold non-owning brush and text layout pointers, so they are only valid until the controls
+// that recorded them change. The UI therefore records and replays the list every frame, but leaves it intact after the
+// replay so that it can be inspected (ex. to check what a control drew) until the next UI::Render.
+namespace Evergreen
+{
+enum class DrawCommandType : uint8_t
+{
+	FILL_RECTANGLE,
+	DRAW_RECTANGLE,
+	FILL_ROUNDED_RECTANGLE,
+	DRAW_ROUNDED_RECTANGLE,
+	FILL_ELLIPSE,
+	DRAW_ELLIPSE,
+	DRAW_LINE,
+	DRAW_TEXT_LAYOUT,
+	PUSH_CLIP,
+	POP_CLIP
+};
+
+struct DrawCommand
+{
+	struct Line
+	{
+		D2D1_POINT_2F point0;
+		D2D1_POINT_2F point1;
+	};
+	struct TextRun
+	{
+		D2D1_POINT_2F origin;
+		IDWriteTextLayout* layout;
+		D2D1_DRAW_TEXT_OPTIONS options;
+	};
+	struct Clip
+	{
+		D2D1_RECT_F rect;
+		D2D1_ANTIALIAS_MODE antialiasMode;
+	};
+
+	DrawCommandType type;
+	float			strokeWidth;	// Only used by the DRAW_* shapes
+	ID2D1Brush*		brush;			// nullptr for clips
+	union
+	{
+		D2D1_ROUNDED_RECT	roundedRect;	// Rectangles use roundedRect.rect and leave the radii at 0
+		D2D1_ELLIPSE		ellipse;
+		Line				line;
+		TextRun				text;
+		Clip				clip;
+	};
+};
+static_assert(std::is_trivially_copyable_v<DrawCommand>, "DrawCommand must stay plain data");
+
+// Drop this warning because the private members are not accessible by the client application, but
+// the compiler will complain that they don't have a DLL interface
+// See: https://stackoverflow.com/questions/767579/exporting-classes-containing-std-objects-vector-map-etc-from-a-dll
+#pragma warning( push )
+#pragma warning( disable : 4251 ) // needs to have dll-interface to be used by clients of class
+class EVERGREEN_API DrawList
+{
+public:
+	DrawList() noexcept = default;
+	DrawList(const DrawList&) = delete;
+	DrawList& operator=(const DrawList&) = delete;
+
+	void FillRectangle(const D2D1_RECT_F& rect, ID2D1Brush* brush);
+	void DrawRectangle(const D2D1_RECT_F& rect, ID2D1Brush* brush, float strokeWidth = 1.0f);
+	void FillRoundedRectangle(const D2D1_ROUNDED_RECT& roundedRect, ID2D1Brush* brush);
+	void DrawRoundedRectangle(const D2D1_ROUNDED_RECT& roundedRect, ID2D1Brush* brush, float strokeWidth = 1.0f);
+	void FillEllipse(const D2D1_ELLIPSE& ellipse, ID2D1Brush* brush);
+	void DrawEllipse(const D2D1_ELLIPSE& ellipse, ID2D1Brush* brush, float strokeWidth = 1.0f);
+	void DrawLine(D2D1_POINT_2F point0, D2D1_POINT_2F point1, ID2D1Brush* brush, float strokeWidth = 1.0f);
+	void DrawTextLayout(D2D1_POINT_2F origin, IDWriteTextLayout* textLayout, ID2D1Brush* brush, D2D1_DRAW_TEXT_OPTIONS options = D2D1_DRAW_TEXT_OPTIONS_NONE);
+	void PushAxisAlignedClip(const D2D1_RECT_F& rect, D2D1_ANTIALIAS_MODE antialiasMode);
+	void PopAxisAlignedClip();
+
+	void Clear() noexcept { m_commands.clear(); m_clipDepth = 0; }
+
+	ND inline std::span<const DrawCommand> Commands() const noexcept { return m_commands; }
+	ND inline size_t Size() const noexcept { return m_commands.size(); }
+	ND inline unsigned int ClipDepth() const noexcept { return m_clipDepth; }
+
+private:
+	DrawCommand& Add(DrawCommandType type, ID2D1Brush* brush, float strokeWidth = 0.0f);
+
+	std::vector<DrawCommand>	m_commands;
+	unsigned int				m_clipDepth = 0;
+};
+
+struct DrawListStats
+{
+	size_t commands = 0;
+	size_t drawCalls = 0;			// Direct2D calls made to replay the list (including clips)
+	size_t batches = 0;				// Runs of commands that were merged into a single geometry
+	size_t batchedCommands = 0;		// Commands that were part of a batch
+	size_t geometriesCreated = 0;
+	size_t geometriesReused = 0;	// Batches whose geometry was unchanged from the previous frame
+};
+
+class EVERGREEN_API DrawListRenderer
+{
+public:
+	// Longest run of commands that will be merged into one geometry
+	static constexpr size_t MaxBatchSize = 64;
+
+	DrawListRenderer(std::shared_ptr<DeviceResources> deviceResources) noexcept;
+	DrawListRenderer(const DrawListRenderer&) = delete;
+	DrawListRenderer& operator=(const DrawListRenderer&) = delete;
+
+	// Must be called between DeviceResources::BeginDraw and EndDraw
+	void Replay(const DrawList& drawList);
+
+	ND inline const DrawListStats& GetStats() const noexcept { return m_stats; }
+
+	// Returns the index one past the last command that can be merged with commands[start]
+	ND static size_t FindBatchEnd(std::span<const DrawCommand> commands, size_t start) noexcept;
+
+private:
+	ND ID2D1PathGeometry* GetBatchGeometry(std::span<const DrawCommand> batch);
+	void ReplayCommand(const DrawCommand& command);
+
+	struct CachedGeometry
+	{
+		std::vector<DrawCommand> commands;
+		Microsoft::WRL::ComPtr<ID2D1PathGeometry> geometry;
+		uint64_t lastUsedFrame = 0;
+	};
+
+	std::shared_ptr<DeviceResources> m_deviceResources;
+	DrawListStats m_stats;
+
+	// Geometries of last frame's batches, keyed by a hash of their shapes. The UI mostly draws the same thing frame to
+	// frame, so most batches do not need a new geometry
+	std::unordered_map<uint64_t, CachedGeometry> m_geometryCache;
+	uint64_t m_frame = 0;
+};
+#pragma warning( pop )
+
+}
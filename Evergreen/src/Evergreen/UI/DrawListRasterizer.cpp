@@ -0,0 +1,343 @@
+#include "pch.h"
+#include "DrawListRasterizer.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace Evergreen
+{
+// GlyphRunCollector -------------------------------------------------------------------------------------------------
+// Text renderer that IDWriteTextLayout::Draw calls back into. Instead of drawing, it makes sure each glyph is in the
+// atlas and records where it goes. It is owned by the DrawListRasterizer rather than reference counted, so AddRef and
+// Release do nothing
+class GlyphRunCollector final : public IDWriteTextRenderer
+{
+public:
+	GlyphRunCollector(IDWriteFactory* factory, GlyphAtlas& atlas) noexcept :
+		m_factory(factory),
+		m_atlas(atlas)
+	{}
+	GlyphRunCollector(const GlyphRunCollector&) = delete;
+	GlyphRunCollector& operator=(const GlyphRunCollector&) = delete;
+
+	void Reset() noexcept { m_glyphs.clear(); m_decorations.clear(); }
+
+	ND inline std::span<const RasterGlyph> Glyphs() const noexcept { return m_glyphs; }
+	ND inline std::span<const RasterRect> Decorations() const noexcept { return m_decorations; }
+
+	// IUnknown
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) noexcept override
+	{
+		if (riid == __uuidof(IDWriteTextRenderer) || riid == __uuidof(IDWritePixelSnapping) || riid == __uuidof(IUnknown))
+		{
+			*object = this;
+			return S_OK;
+		}
+		*object = nullptr;
+		return E_NOINTERFACE;
+	}
+	ULONG STDMETHODCALLTYPE AddRef() noexcept override { return 1; }
+	ULONG STDMETHODCALLTYPE Release() noexcept override { return 1; }
+
+	// IDWritePixelSnapping
+	HRESULT STDMETHODCALLTYPE IsPixelSnappingDisabled(void*, BOOL* isDisabled) noexcept override
+	{
+		*isDisabled = FALSE;
+		return S_OK;
+	}
+	HRESULT STDMETHODCALLTYPE GetCurrentTransform(void*, DWRITE_MATRIX* transform) noexcept override
+	{
+		*transform = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+		return S_OK;
+	}
+	HRESULT STDMETHODCALLTYPE GetPixelsPerDip(void*, FLOAT* pixelsPerDip) noexcept override
+	{
+		*pixelsPerDip = 1.0f;
+		return S_OK;
+	}
+
+	// IDWriteTextRenderer
+	HRESULT STDMETHODCALLTYPE DrawGlyphRun(void*, FLOAT baselineOriginX, FLOAT baselineOriginY, DWRITE_MEASURING_MODE,
+		const DWRITE_GLYPH_RUN* glyphRun, const DWRITE_GLYPH_RUN_DESCRIPTION*, IUnknown*) noexcept override
+	{
+		// Right-to-left runs advance from the origin towards the left
+		const bool rightToLeft = (glyphRun->bidiLevel & 1) != 0;
+		float penX = baselineOriginX;
+
+		for (UINT32 iii = 0; iii < glyphRun->glyphCount; ++iii)
+		{
+			const float advance = glyphRun->glyphAdvances != nullptr ? glyphRun->glyphAdvances[iii] : 0.0f;
+			if (rightToLeft)
+				penX -= advance;
+
+			RasterGlyph glyph = { penX, baselineOriginY, GlyphKey(glyphRun->fontFace, glyphRun->fontEmSize, glyphRun->glyphIndices[iii], glyphRun->isSideways) };
+			if (glyphRun->glyphOffsets != nullptr)
+			{
+				glyph.x += rightToLeft ? -glyphRun->glyphOffsets[iii].advanceOffset : glyphRun->glyphOffsets[iii].advanceOffset;
+				glyph.y -= glyphRun->glyphOffsets[iii].ascenderOffset;
+			}
+
+			if (m_atlas.Find(glyph.key) != nullptr || RasterizeGlyph(*glyphRun, glyphRun->glyphIndices[iii], glyph.key))
+				m_glyphs.push_back(glyph);
+
+			if (!rightToLeft)
+				penX += advance;
+		}
+		return S_OK;
+	}
+	HRESULT STDMETHODCALLTYPE DrawUnderline(void*, FLOAT baselineOriginX, FLOAT baselineOriginY, const DWRITE_UNDERLINE* underline, IUnknown*) noexcept override
+	{
+		const float top = baselineOriginY + underline->offset;
+		m_decorations.push_back({ baselineOriginX, top, baselineOriginX + underline->width, top + underline->thickness });
+		return S_OK;
+	}
+	HRESULT STDMETHODCALLTYPE DrawStrikethrough(void*, FLOAT baselineOriginX, FLOAT baselineOriginY, const DWRITE_STRIKETHROUGH* strikethrough, IUnknown*) noexcept override
+	{
+		const float top = baselineOriginY + strikethrough->offset;
+		m_decorations.push_back({ baselineOriginX, top, baselineOriginX + strikethrough->width, top + strikethrough->thickness });
+		return S_OK;
+	}
+	// The UI does not use inline objects
+	HRESULT STDMETHODCALLTYPE DrawInlineObject(void*, FLOAT, FLOAT, IDWriteInlineObject*, BOOL, BOOL, IUnknown*) noexcept override
+	{
+		return S_OK;
+	}
+
+private:
+	// NOTE: The font face pointer is part of the key. DirectWrite keeps font faces alive in its cache while layouts that
+	//       use them exist, so a pointer identifies the same font for as long as the glyph can be drawn
+	ND static uint64_t GlyphKey(IDWriteFontFace* fontFace, float emSize, UINT16 glyphIndex, BOOL isSideways) noexcept
+	{
+		// FNV-1a over the font face, size and glyph
+		uint64_t hash = 14695981039346656037ull;
+		auto mix = [&hash](const void* data, size_t size)
+		{
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			for (size_t iii = 0; iii < size; ++iii)
+			{
+				hash ^= bytes[iii];
+				hash *= 1099511628211ull;
+			}
+		};
+		mix(&fontFace, sizeof(fontFace));
+		mix(&emSize, sizeof(emSize));
+		mix(&glyphIndex, sizeof(glyphIndex));
+		mix(&isSideways, sizeof(isSideways));
+		return hash;
+	}
+
+	// Rasterizes one glyph at the origin and adds its coverage to the atlas. DirectWrite only produces antialiased glyphs
+	// as 3x1 (ClearType) textures, so the three subpixel samples are averaged into a single coverage value
+	bool RasterizeGlyph(const DWRITE_GLYPH_RUN& glyphRun, UINT16 glyphIndex, uint64_t key) noexcept
+	{
+		const FLOAT advance = 0.0f;
+		DWRITE_GLYPH_RUN run = {};
+		run.fontFace = glyphRun.fontFace;
+		run.fontEmSize = glyphRun.fontEmSize;
+		run.glyphCount = 1;
+		run.glyphIndices = &glyphIndex;
+		run.glyphAdvances = &advance;
+		run.isSideways = glyphRun.isSideways;
+
+		ComPtr<IDWriteGlyphRunAnalysis> analysis;
+		RECT bounds = {};
+		HRESULT hr = m_factory->CreateGlyphRunAnalysis(&run, 1.0f, nullptr, DWRITE_RENDERING_MODE_NATURAL, DWRITE_MEASURING_MODE_NATURAL, 0.0f, 0.0f, &analysis);
+		if (SUCCEEDED(hr))
+			hr = analysis->GetAlphaTextureBounds(DWRITE_TEXTURE_CLEARTYPE_3x1, &bounds);
+		if (FAILED(hr))
+		{
+			EG_CORE_ERROR("{}:{} - Failed to rasterize glyph {} (HRESULT {:#x})", __FILE__, __LINE__, glyphIndex, static_cast<unsigned long>(hr));
+			return false;
+		}
+
+		const uint32_t width = static_cast<uint32_t>(std::max(bounds.right - bounds.left, 0L));
+		const uint32_t height = static_cast<uint32_t>(std::max(bounds.bottom - bounds.top, 0L));
+		if (width == 0 || height == 0)
+			return m_atlas.Add(key, 0, 0, 0, 0, nullptr, 0) != nullptr;
+
+		m_texture.resize(static_cast<size_t>(width) * height * 3);
+		if (FAILED(hr = analysis->CreateAlphaTexture(DWRITE_TEXTURE_CLEARTYPE_3x1, &bounds, m_texture.data(), static_cast<UINT32>(m_texture.size()))))
+		{
+			EG_CORE_ERROR("{}:{} - Failed to rasterize glyph {} (HRESULT {:#x})", __FILE__, __LINE__, glyphIndex, static_cast<unsigned long>(hr));
+			return false;
+		}
+
+		m_coverage.resize(static_cast<size_t>(width) * height);
+		for (size_t iii = 0; iii < m_coverage.size(); ++iii)
+			m_coverage[iii] = static_cast<uint8_t>((m_texture[iii * 3] + m_texture[iii * 3 + 1] + m_texture[iii * 3 + 2] + 1) / 3);
+
+		if (m_atlas.Add(key, width, height, bounds.left, bounds.top, m_coverage.data(), width) == nullptr)
+		{
+			EG_CORE_WARN("{}:{} - Glyph atlas is full - glyph {} will not be drawn", __FILE__, __LINE__, glyphIndex);
+			return false;
+		}
+		return true;
+	}
+
+	IDWriteFactory* m_factory;
+	GlyphAtlas& m_atlas;
+
+	std::vector<RasterGlyph> m_glyphs;
+	std::vector<RasterRect> m_decorations;	// Underlines and strikethroughs
+
+	// Scratch for RasterizeGlyph
+	std::vector<BYTE> m_texture;
+	std::vector<uint8_t> m_coverage;
+};
+
+// DrawListRasterizer ------------------------------------------------------------------------------------------------
+ND static inline RasterRect ToRasterRect(const D2D1_RECT_F& rect) noexcept
+{
+	return { rect.left, rect.top, rect.right, rect.bottom };
+}
+ND static inline RasterColor ToRasterColor(const D2D1_COLOR_F& color) noexcept
+{
+	return { color.r, color.g, color.b, color.a };
+}
+
+DrawListRasterizer::DrawListRasterizer(std::shared_ptr<DeviceResources> deviceResources, JobSystem* jobSystem) :
+	m_deviceResources(deviceResources),
+	m_rasterizer(jobSystem)
+{
+	EG_CORE_ASSERT(m_deviceResources != nullptr, "No device resources");
+	m_glyphRunCollector = std::make_unique<GlyphRunCollector>(m_deviceResources->DWriteFactory(), m_glyphAtlas);
+}
+DrawListRasterizer::~DrawListRasterizer() noexcept = default;
+
+std::optional<RasterPaintId> DrawListRasterizer::TranslateBrush(ID2D1Brush* brush)
+{
+	auto iter = m_paints.find(brush);
+	if (iter != m_paints.end())
+		return iter->second;
+
+	RasterPaint paint;
+	paint.opacity = brush->GetOpacity();
+
+	D2D1_MATRIX_3X2_F matrix;
+	brush->GetTransform(&matrix);
+	const D2D1::Matrix3x2F* transform = D2D1::Matrix3x2F::ReinterpretBaseType(&matrix);
+
+	auto setStops = [&paint](ID2D1GradientStopCollection* collection)
+	{
+		std::vector<D2D1_GRADIENT_STOP> stops(collection->GetGradientStopCount());
+		collection->GetGradientStops(stops.data(), static_cast<UINT32>(stops.size()));
+		for (const D2D1_GRADIENT_STOP& stop : stops)
+			paint.stops.push_back({ stop.position, ToRasterColor(stop.color) });
+	};
+
+	ComPtr<ID2D1SolidColorBrush> solid;
+	ComPtr<ID2D1LinearGradientBrush> linear;
+	ComPtr<ID2D1RadialGradientBrush> radial;
+	ComPtr<ID2D1GradientStopCollection> stops;
+
+	std::optional<RasterPaintId> id;
+	if (SUCCEEDED(brush->QueryInterface(IID_PPV_ARGS(&solid))))
+	{
+		paint.color = ToRasterColor(solid->GetColor());
+		id = m_commands.AddPaint(std::move(paint));
+	}
+	else if (SUCCEEDED(brush->QueryInterface(IID_PPV_ARGS(&linear))))
+	{
+		const D2D1_POINT_2F start = transform->TransformPoint(linear->GetStartPoint());
+		const D2D1_POINT_2F end = transform->TransformPoint(linear->GetEndPoint());
+		paint.type = RasterPaintType::LINEAR_GRADIENT;
+		paint.point0[0] = start.x;
+		paint.point0[1] = start.y;
+		paint.point1[0] = end.x;
+		paint.point1[1] = end.y;
+
+		linear->GetGradientStopCollection(&stops);
+		setStops(stops.Get());
+		if (!paint.stops.empty())
+			id = m_commands.AddPaint(std::move(paint));
+	}
+	else if (SUCCEEDED(brush->QueryInterface(IID_PPV_ARGS(&radial))))
+	{
+		// The gradient origin offset is ignored - the gradient is always centered
+		const D2D1_POINT_2F center = transform->TransformPoint(radial->GetCenter());
+		paint.type = RasterPaintType::RADIAL_GRADIENT;
+		paint.point0[0] = center.x;
+		paint.point0[1] = center.y;
+		paint.point1[0] = radial->GetRadiusX() * std::abs(matrix._11);
+		paint.point1[1] = radial->GetRadiusY() * std::abs(matrix._22);
+
+		radial->GetGradientStopCollection(&stops);
+		setStops(stops.Get());
+		if (!paint.stops.empty())
+			id = m_commands.AddPaint(std::move(paint));
+	}
+
+	m_paints.emplace(brush, id);
+	return id;
+}
+
+void DrawListRasterizer::TranslateTextLayout(const DrawCommand::TextRun& text, RasterPaintId paint)
+{
+	const bool clip = (text.options & D2D1_DRAW_TEXT_OPTIONS_CLIP) != 0;
+	if (clip)
+	{
+		m_commands.PushClip({ text.origin.x, text.origin.y, text.origin.x + text.layout->GetMaxWidth(), text.origin.y + text.layout->GetMaxHeight() });
+	}
+
+	m_glyphRunCollector->Reset();
+	GFX_THROW_INFO(text.layout->Draw(nullptr, m_glyphRunCollector.get(), text.origin.x, text.origin.y));
+
+	m_commands.DrawGlyphs(m_glyphAtlas, m_glyphRunCollector->Glyphs(), paint);
+	for (const RasterRect& decoration : m_glyphRunCollector->Decorations())
+		m_commands.FillRectangle(decoration, paint);
+
+	if (clip)
+		m_commands.PopClip();
+}
+
+void DrawListRasterizer::Rasterize(const DrawList& drawList, RasterImage& target)
+{
+	m_commands.Clear();
+	m_paints.clear();
+	m_skippedCommands = 0;
+
+	for (const DrawCommand& command : drawList.Commands())
+	{
+		if (command.type == DrawCommandType::PUSH_CLIP)
+		{
+			m_commands.PushClip(ToRasterRect(command.clip.rect), command.clip.antialiasMode == D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
+			continue;
+		}
+		if (command.type == DrawCommandType::POP_CLIP)
+		{
+			m_commands.PopClip();
+			continue;
+		}
+
+		const std::optional<RasterPaintId> paint = TranslateBrush(command.brush);
+		if (!paint.has_value())
+		{
+			++m_skippedCommands;
+			continue;
+		}
+
+		const D2D1_ROUNDED_RECT& roundedRect = command.roundedRect;
+		const D2D1_ELLIPSE& ellipse = command.ellipse;
+
+		switch (command.type)
+		{
+		case DrawCommandType::FILL_RECTANGLE:			m_commands.FillRectangle(ToRasterRect(roundedRect.rect), paint.value()); break;
+		case DrawCommandType::DRAW_RECTANGLE:			m_commands.DrawRectangle(ToRasterRect(roundedRect.rect), paint.value(), command.strokeWidth); break;
+		case DrawCommandType::FILL_ROUNDED_RECTANGLE:	m_commands.FillRoundedRectangle(ToRasterRect(roundedRect.rect), roundedRect.radiusX, roundedRect.radiusY, paint.value()); break;
+		case DrawCommandType::DRAW_ROUNDED_RECTANGLE:	m_commands.DrawRoundedRectangle(ToRasterRect(roundedRect.rect), roundedRect.radiusX, roundedRect.radiusY, paint.value(), command.strokeWidth); break;
+		case DrawCommandType::FILL_ELLIPSE:				m_commands.FillEllipse(ellipse.point.x, ellipse.point.y, ellipse.radiusX, ellipse.radiusY, paint.value()); break;
+		case DrawCommandType::DRAW_ELLIPSE:				m_commands.DrawEllipse(ellipse.point.x, ellipse.point.y, ellipse.radiusX, ellipse.radiusY, paint.value(), command.strokeWidth); break;
+		case DrawCommandType::DRAW_LINE:
+			m_commands.DrawLine(command.line.point0.x, command.line.point0.y, command.line.point1.x, command.line.point1.y, paint.value(), command.strokeWidth);
+			break;
+		case DrawCommandType::DRAW_TEXT_LAYOUT:			TranslateTextLayout(command.text, paint.value()); break;
+		default:
+			EG_CORE_ERROR("{}:{} - Unrecognized DrawCommandType value: {}", __FILE__, __LINE__, static_cast<int>(command.type));
+			++m_skippedCommands;
+			break;
+		}
+	}
+
+	m_rasterizer.Rasterize(m_commands, target);
+}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "pch.h"
+#include "Evergreen/Core.h"
+#include "Evergreen/Rendering/DeviceResources.h"
+#include "Evergreen/Rendering/Software/SoftwareRasterizer.h"
+#include "DrawList.h"
+
+#include <unordered_map>
+
+// Replays a DrawList with the SoftwareRasterizer instead of Direct2D, producing a RasterImage (see UI::RenderSoftware).
+// This is what UI performance and visual regression tests use, since the output does not depend on the GPU or driver.
+//
+// Each DrawCommand is translated into a RasterCommand:
+//		Brushes			- Solid color, linear gradient and radial gradient brushes become RasterPaints (including their
+//						  opacity and transform). Other brushes (ex. bitmap brushes) are not supported - commands that
+//						  use them are skipped and counted in SkippedCommands()
+//		Text layouts	- The layout is drawn into a custom IDWriteTextRenderer, which rasterizes each glyph once with
+//						  IDWriteGlyphRunAnalysis into the GlyphAtlas and records its position. Underlines and
+//						  strikethroughs become rectangles
+//
+// NOTE: DirectWrite is still used to lay out and rasterize glyphs, so only the drawing is done without Direct2D.
+namespace Evergreen
+{
+class GlyphRunCollector;
+
+// Drop this warning because the private members are not accessible by the client application, but
+// the compiler will complain that they don't have a DLL interface
+// See: https://stackoverflow.com/questions/767579/exporting-classes-containing-std-objects-vector-map-etc-from-a-dll
+#pragma warning( push )
+#pragma warning( disable : 4251 ) // needs to have dll-interface to be used by clients of class
+class EVERGREEN_API DrawListRasterizer
+{
+public:
+	// Without a JobSystem, the tiles are rasterized on the calling thread
+	DrawListRasterizer(std::shared_ptr<DeviceResources> deviceResources, JobSystem* jobSystem = nullptr);
+	DrawListRasterizer(const DrawListRasterizer&) = delete;
+	DrawListRasterizer& operator=(const DrawListRasterizer&) = delete;
+	~DrawListRasterizer() noexcept;
+
+	// Draws 'drawList' over the current contents of 'target'
+	void Rasterize(const DrawList& drawList, RasterImage& target);
+
+	ND inline const RasterCommandList& GetCommands() const noexcept { return m_commands; }
+	ND inline const SoftwareRasterizerStats& GetStats() const noexcept { return m_rasterizer.GetStats(); }
+	ND inline const GlyphAtlas& GetGlyphAtlas() const noexcept { return m_glyphAtlas; }
+	// Commands from the last call to Rasterize that could not be translated
+	ND inline size_t SkippedCommands() const noexcept { return m_skippedCommands; }
+
+private:
+	ND std::optional<RasterPaintId> TranslateBrush(ID2D1Brush* brush);
+	void TranslateTextLayout(const DrawCommand::TextRun& text, RasterPaintId paint);
+
+	std::shared_ptr<DeviceResources> m_deviceResources;
+	SoftwareRasterizer m_rasterizer;
+	RasterCommandList m_commands;
+	GlyphAtlas m_glyphAtlas;
+	std::unique_ptr<GlyphRunCollector> m_glyphRunCollector;
+
+	// Paint of each brush used this frame
+	std::unordered_map<ID2D1Brush*, std::optional<RasterPaintId>> m_paints;
+	size_t m_skippedCommands = 0;
+};
+#pragma warning( pop )
+
+}
@@ -126,4 +126,24 @@ void ControlLoader::ParseOnUpdateCallback(Control* control, json& data)
 	}
 }
 
+bool ControlLoader::IsBinding(const json& value) noexcept
+{
+	if (!value.is_string())
+		return false;
+
+	const std::string& s = value.get_ref<const std::string&>();
+	return s.size() > 7 && s.starts_with("{bind:") && s.back() == '}';
+}
+ObservableBase* ControlLoader::ParseBinding(json& data, const std::string& field)
+{
+	EG_CORE_ASSERT(data.contains(field) && IsBinding(data[field]), "Not a binding");
+
+	const std::string& value = data[field].get_ref<const std::string&>();
+	const std::string key = value.substr(6, value.size() - 7);
+
+	ObservableBase* observable = JSONLoaders::GetObservable(key);
+	JSON_LOADER_EXCEPTION_IF_FALSE(observable != nullptr, "Control with name: '{}'. '{}' is bound to '{}', but no Observable was registered with that key (see JSONLoaders::AddObservable). Invalid data: {}", m_name, field, key, data.dump(4));
+	return observable;
+}
+
 }
\ No newline at end of file
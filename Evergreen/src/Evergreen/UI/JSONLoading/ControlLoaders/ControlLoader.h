@@ -32,12 +32,26 @@ protected:
 	unsigned int ParseID(json& data);
 	void ParseOnUpdateCallback(Control* control, json& data);
 
+	// Bindings are strings of the form "{bind:key}", where 'key' was registered with JSONLoaders::AddObservable
+	ND static bool IsBinding(const json& value) noexcept;
+	ND ObservableBase* ParseBinding(json& data, const std::string& field);
+	template<typename T>
+	ND Observable<T>* ParseBinding(json& data, const std::string& field);
+
 	std::string m_name;
 
 	
 };
 #pragma warning( pop )
 
+template<typename T>
+Observable<T>* ControlLoader::ParseBinding(json& data, const std::string& field)
+{
+	ObservableBase* observable = ParseBinding(data, field);
+	JSON_LOADER_EXCEPTION_IF_FALSE(observable->HoldsType<T>(), "Control with name: '{}'. '{}' is bound to an Observable of the wrong type (expected Observable<{}>). Invalid data: {}", m_name, field, typeid(T).name(), data.dump(4));
+	return static_cast<Observable<T>*>(observable);
+}
+
 
 }
 
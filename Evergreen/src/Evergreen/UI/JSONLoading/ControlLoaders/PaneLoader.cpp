@@ -43,7 +43,7 @@ Control* PaneLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceResources,
 	float titleBarHeight = ParseTitleBarHeight(data);
 
 	// Warn about unrecognized keys
-	constexpr std::array recognizedKeys{ "id", "Type", "Text", "Title", "Top", "Left", "Height", "Width", "Resizable",
+	static constexpr StaticKeySet recognizedKeys{ "id", "Type", "Text", "Title", "Top", "Left", "Height", "Width", "Resizable",
 	"Relocatable", "BackgroundBrush", "BorderBrush", "BorderWidth", "CornerRadius", "CornerRadiusX", "CornerRadiusY", 
 	"IncludeTitleBar", "TitleBarBrush", "TitleBarHeight", "IsMinimized", "IsVisible", "Content", "OnMouseEnteredTitleBar", 
 	"OnMouseExitedTitleBar", "OnMouseEnteredContentRegion", "OnMouseExitedContentRegion", "OnMouseMoved", "OnUpdate",
@@ -51,7 +51,7 @@ Control* PaneLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceResources,
 	"BorderBottomLeftOffsetY", "BorderBottomRightOffsetX", "BorderBottomRightOffsetY" };
 	for (auto& [key, value] : data.items())
 	{
-		if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) == recognizedKeys.end())
+		if (!recognizedKeys.Contains(key))
 			EG_CORE_WARN("{}:{} - Pane control with name '{}'. Unrecognized key: '{}'.", __FILE__, __LINE__, m_name, key);
 	}
 
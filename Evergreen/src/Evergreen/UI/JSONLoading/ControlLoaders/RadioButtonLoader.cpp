@@ -31,13 +31,13 @@ Control* RadioButtonLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceReso
 	std::unique_ptr<ColorBrush> outerBrush = std::move(ParseOuterBrush(deviceResources, data));
 
 	// Warn about unrecognized keys
-	constexpr std::array recognizedKeys{ "id", "Type", "Row", "Column", "RowSpan", "ColumnSpan", "Margin",
+	static constexpr StaticKeySet recognizedKeys{ "id", "Type", "Row", "Column", "RowSpan", "ColumnSpan", "Margin",
 	"IsChecked", "InnerRadius", "OuterRadius", "InnerBrush", "OuterBrush", "OuterBrushLineWidth",
 	"OnMouseEntered", "OnMouseExited", "OnMouseMoved", "OnMouseLButtonDown", "OnIsCheckedChanged",
 	"OnUpdate" };
 	for (auto& [key, value] : data.items())
 	{
-		if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) == recognizedKeys.end())
+		if (!recognizedKeys.Contains(key))
 			EG_CORE_WARN("{}:{} - RadioButton control with name '{}'. Unrecognized key: '{}'.", __FILE__, __LINE__, m_name, key);
 	}
 
@@ -64,6 +64,7 @@ Control* RadioButtonLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceReso
 	ParseOnMouseMoved(rb, data);
 	ParseOnMouseLButtonDown(rb, data);
 	ParseOnIsCheckedChanged(rb, data);
+	ParseIsCheckedBinding(rb, data);
 
 	ParseOnUpdateCallback(rb, data);
 
@@ -74,6 +75,9 @@ bool RadioButtonLoader::ParseIsChecked(json& data)
 {
 	if (data.contains("IsChecked"))
 	{
+		if (IsBinding(data["IsChecked"]))
+			return ParseBinding<bool>(data, "IsChecked")->Get();
+
 		JSON_LOADER_EXCEPTION_IF_FALSE(data["IsChecked"].is_boolean(), "RadioButton control with name '{}': 'IsChecked' value must be a boolean. Invalid RadioButton object: {}", m_name, data.dump(4));
 		return data["IsChecked"].get<bool>();
 	}
@@ -196,5 +200,11 @@ void RadioButtonLoader::ParseOnIsCheckedChanged(RadioButton* rb, json& data)
 		rb->SetOnIsCheckedChanged(callback);
 	}
 }
+void RadioButtonLoader::ParseIsCheckedBinding(RadioButton* rb, json& data)
+{
+	EG_CORE_ASSERT(rb != nullptr, "No radio button");
+	if (data.contains("IsChecked") && IsBinding(data["IsChecked"]))
+		rb->BindIsChecked(*ParseBinding<bool>(data, "IsChecked"));
+}
 
 }
\ No newline at end of file
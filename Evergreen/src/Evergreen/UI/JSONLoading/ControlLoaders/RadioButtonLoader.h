@@ -45,6 +45,7 @@ private:
 	void ParseOnMouseMoved(RadioButton* rb, json& data);
 	void ParseOnMouseLButtonDown(RadioButton* rb, json& data);
 	void ParseOnIsCheckedChanged(RadioButton* rb, json& data);
+	void ParseIsCheckedBinding(RadioButton* rb, json& data);
 
 };
 #pragma warning( pop )
@@ -27,11 +27,11 @@ Control* RectangleLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceResour
 	float width = ParseWidth(data);
 
 	// Warn about unrecognized keys
-	constexpr std::array recognizedKeys{ "id", "Type", "Row", "Column", "RowSpan", "ColumnSpan", "Margin",
+	static constexpr StaticKeySet recognizedKeys{ "id", "Type", "Row", "Column", "RowSpan", "ColumnSpan", "Margin",
 	"Brush", "Height", "Width" };
 	for (auto& [key, value] : data.items())
 	{
-		if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) == recognizedKeys.end())
+		if (!recognizedKeys.Contains(key))
 			EG_CORE_WARN("{}:{} - Rectangle control with name '{}'. Unrecognized key: '{}'.", __FILE__, __LINE__, m_name, key);
 	}
 
@@ -38,7 +38,7 @@ Control* ScrollableLayoutLoader::LoadImpl(std::shared_ptr<DeviceResources> devic
 		EG_CORE_WARN("{}:{} - ScrollableLayout control with name '{}'. 'scrollHorizontal' and 'scrollVertical' are both false. At least one of these should be true.", __FILE__, __LINE__, m_name);
 
 	// Warn about unrecognized keys
-	constexpr std::array recognizedKeys{ "id", "Type", "Row", "Column", "RowSpan", "ColumnSpan", "RowDefinitions", "ColumnDefinitions",
+	static constexpr StaticKeySet recognizedKeys{ "id", "Type", "Row", "Column", "RowSpan", "ColumnSpan", "RowDefinitions", "ColumnDefinitions",
 	"Margin", "ScrollVertical", "ScrollHorizontal", "BackgroundBrush", "BorderBrush", "BorderWidth", "VerticalScrollBarCornerRadius", 
 	"VerticalScrollBarCornerRadiusX", "VerticalScrollBarCornerRadiusY", "VerticalScrollBarEnabled", "VerticalScrollBarHiddenWhenNotOver", 
 	"VerticalScrollBarWidth",	"VerticalScrollBarRegionWidth", "VerticalScrollBarBrush", "VerticalScrollBarHoveredBrush", 
@@ -47,7 +47,7 @@ Control* ScrollableLayoutLoader::LoadImpl(std::shared_ptr<DeviceResources> devic
 	"HorizontalScrollBarBrush", "HorizontalScrollBarHoveredBrush", "HorizontalScrollBarDraggingBrush", "OnUpdate"};
 	for (auto& [key, value] : data.items())
 	{
-		if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) == recognizedKeys.end())
+		if (!recognizedKeys.Contains(key))
 		{
 			// Ignore the key/value if it is an object. It will be assumed that it is either a Control or Layout object for now, but
 			// if there is an issue with the object, it will get picked up by JSONLoaders::LoadLayout()
@@ -592,7 +592,7 @@ void ScrollableLayoutLoader::LoadControls(std::shared_ptr<DeviceResources> devic
 {
 	EG_CORE_ASSERT(scrollableLayout != nullptr, "ScrollableLayout should not be nullptr");
 
-	constexpr std::array recognizedKeys{ "Type", "Row", "Column", "RowSpan", "ColumnSpan", "RowDefinitions", "ColumnDefinitions",
+	static constexpr StaticKeySet recognizedKeys{ "Type", "Row", "Column", "RowSpan", "ColumnSpan", "RowDefinitions", "ColumnDefinitions",
 	"Margin", "ScrollVertical", "ScrollHorizontal", "BackgroundBrush", "BorderBrush", "BorderWidth", "VerticalScrollBarCornerRadius",
 	"VerticalScrollBarCornerRadiusX", "VerticalScrollBarCornerRadiusY", "VerticalScrollBarEnabled", "VerticalScrollBarHiddenWhenNotOver",
 	"VerticalScrollBarWidth",	"VerticalScrollBarRegionWidth", "VerticalScrollBarBrush", "VerticalScrollBarHoveredBrush",
@@ -603,7 +603,7 @@ void ScrollableLayoutLoader::LoadControls(std::shared_ptr<DeviceResources> devic
 	// Now iterate over the controls and sublayouts within the layout
 	for (auto& [key, value] : data.items())
 	{
-		if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) != recognizedKeys.end())
+		if (recognizedKeys.Contains(key))
 			continue;
 
 		JSON_LOADER_EXCEPTION_IF_FALSE(data[key].contains("Type"), "ScrollableLayout control with name '{}': Child control has no 'Type' definition: {}", m_name, data[key].dump(4));
@@ -24,10 +24,13 @@ Control* SliderFloatLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceReso
 	float max = ParseMaximumValue(data);
 	float value = ParseValue(data);
 	JSON_LOADER_EXCEPTION_IF_FALSE(min < max, "SliderFloat control with name '{}': 'MinimumValue' ({}) must be less than 'MaximumValue' ({}). Invalid SliderFloat object: {}", m_name, min, max, data.dump(4));
-	JSON_LOADER_EXCEPTION_IF_FALSE(min <= value && value <= max, "SliderFloat control with name '{}': 'Value' ({}) must be >= 'MinimumValue' ({}) and <= 'MaximumValue' ({}). Invalid SliderFloat object: {}", m_name, value, min, max, data.dump(4));
+	if (IsBinding(data["Value"]))
+		value = std::clamp(value, min, max); // The Observable's value - the slider clamps it the same way once bound
+	else
+		JSON_LOADER_EXCEPTION_IF_FALSE(min <= value && value <= max, "SliderFloat control with name '{}': 'Value' ({}) must be >= 'MinimumValue' ({}) and <= 'MaximumValue' ({}). Invalid SliderFloat object: {}", m_name, value, min, max, data.dump(4));
 
 	// Warn about unrecognized keys
-	constexpr std::array recognizedKeys{ "id", "Type", "Row", "Column", "RowSpan", "ColumnSpan", "Margin",
+	static constexpr StaticKeySet recognizedKeys{ "id", "Type", "Row", "Column", "RowSpan", "ColumnSpan", "Margin",
 	"MinimumValue",	"MaximumValue",	"Value",
 	"LineWidth", "LineBrushLeft", "LineBrushRight", "FillLineOnRightSide",
 	"CircleRadius", "CircleRadiusOuter", "CircleBrush", "CircleBrushOuter", 
@@ -41,7 +44,7 @@ Control* SliderFloatLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceReso
 	"OnUpdate" };
 	for (auto& [key, value] : data.items())
 	{
-		if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) == recognizedKeys.end())
+		if (!recognizedKeys.Contains(key))
 			EG_CORE_WARN("{}:{} - SliderFloat control with name '{}'. Unrecognized key: '{}'.", __FILE__, __LINE__, m_name, key);
 	}
 
@@ -103,6 +106,7 @@ Control* SliderFloatLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceReso
 	ParseOnBeginDragging(slider, data);
 	ParseOnStoppedDragging(slider, data);
 	ParseOnValueChanged(slider, data);
+	ParseValueBinding(slider, data);
 
 	ParseOnUpdateCallback(slider, data);
 
@@ -124,6 +128,8 @@ float SliderFloatLoader::ParseMaximumValue(json& data)
 float SliderFloatLoader::ParseValue(json& data)
 {
 	JSON_LOADER_EXCEPTION_IF_FALSE(data.contains("Value"), "SliderFloat control with name '{}': 'Value' field is required. Incomplete SliderFloat object: {}", m_name, data.dump(4));
+	if (IsBinding(data["Value"]))
+		return ParseBinding<float>(data, "Value")->Get();
 	JSON_LOADER_EXCEPTION_IF_FALSE(data["Value"].is_number(), "SliderFloat control with name '{}': 'Value' value must be a number. Invalid SliderFloat object: {}", m_name, data.dump(4));
 	return data["Value"].get<float>();
 }
@@ -630,4 +636,10 @@ void SliderFloatLoader::ParseOnValueChanged(SliderFloat* slider, json& data)
 		slider->SetOnValueChangedCallback(callback);
 	}
 }
+void SliderFloatLoader::ParseValueBinding(SliderFloat* slider, json& data)
+{
+	EG_CORE_ASSERT(slider != nullptr, "No slider");
+	if (IsBinding(data["Value"]))
+		slider->BindValue(*ParseBinding<float>(data, "Value"));
+}
 }
\ No newline at end of file
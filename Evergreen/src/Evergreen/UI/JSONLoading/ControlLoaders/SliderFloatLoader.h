@@ -81,6 +81,7 @@ private:
 	void ParseOnBeginDragging(SliderFloat* slider, json& data);
 	void ParseOnStoppedDragging(SliderFloat* slider, json& data);
 	void ParseOnValueChanged(SliderFloat* slider, json& data);
+	void ParseValueBinding(SliderFloat* slider, json& data);
 
 };
 #pragma warning( pop )
@@ -23,10 +23,13 @@ Control* SliderIntLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceResour
 	int max = ParseMaximumValue(data);
 	int value = ParseValue(data);
 	JSON_LOADER_EXCEPTION_IF_FALSE(min < max, "SliderInt control with name '{}': 'MinimumValue' ({}) must be less than 'MaximumValue' ({}). Invalid SliderInt object: {}", m_name, min, max, data.dump(4));
-	JSON_LOADER_EXCEPTION_IF_FALSE(min <= value && value <= max, "SliderInt control with name '{}': 'Value' ({}) must be >= 'MinimumValue' ({}) and <= 'MaximumValue' ({}). Invalid SliderInt object: {}", m_name, value, min, max, data.dump(4));
+	if (IsBinding(data["Value"]))
+		value = std::clamp(value, min, max); // The Observable's value - the slider clamps it the same way once bound
+	else
+		JSON_LOADER_EXCEPTION_IF_FALSE(min <= value && value <= max, "SliderInt control with name '{}': 'Value' ({}) must be >= 'MinimumValue' ({}) and <= 'MaximumValue' ({}). Invalid SliderInt object: {}", m_name, value, min, max, data.dump(4));
 
 	// Warn about unrecognized keys
-	constexpr std::array recognizedKeys{ "id", "Type", "Row", "Column", "RowSpan", "ColumnSpan", "Margin",
+	static constexpr StaticKeySet recognizedKeys{ "id", "Type", "Row", "Column", "RowSpan", "ColumnSpan", "Margin",
 	"MinimumValue",	"MaximumValue",	"Value",
 	"LineWidth", "LineBrushLeft", "LineBrushRight", "FillLineOnRightSide",
 	"CircleRadius", "CircleRadiusOuter", "CircleBrush", "CircleBrushOuter",
@@ -40,7 +43,7 @@ Control* SliderIntLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceResour
 	"OnUpdate" };
 	for (auto& [key, value] : data.items())
 	{
-		if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) == recognizedKeys.end())
+		if (!recognizedKeys.Contains(key))
 			EG_CORE_WARN("{}:{} - SliderInt control with name '{}'. Unrecognized key: '{}'.", __FILE__, __LINE__, m_name, key);
 	}
 
@@ -102,6 +105,7 @@ Control* SliderIntLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceResour
 	ParseOnBeginDragging(slider, data);
 	ParseOnStoppedDragging(slider, data);
 	ParseOnValueChanged(slider, data);
+	ParseValueBinding(slider, data);
 
 	ParseOnUpdateCallback(slider, data);
 
@@ -123,6 +127,8 @@ int SliderIntLoader::ParseMaximumValue(json& data)
 int SliderIntLoader::ParseValue(json& data)
 {
 	JSON_LOADER_EXCEPTION_IF_FALSE(data.contains("Value"), "SliderInt control with name '{}': 'Value' field is required. Incomplete SliderInt object: {}", m_name, data.dump(4));
+	if (IsBinding(data["Value"]))
+		return ParseBinding<int>(data, "Value")->Get();
 	JSON_LOADER_EXCEPTION_IF_FALSE(data["Value"].is_number(), "SliderInt control with name '{}': 'Value' value must be a number. Invalid SliderInt object: {}", m_name, data.dump(4));
 	return data["Value"].get<int>();
 }
@@ -629,4 +635,10 @@ void SliderIntLoader::ParseOnValueChanged(SliderInt* slider, json& data)
 		slider->SetOnValueChangedCallback(callback);
 	}
 }
+void SliderIntLoader::ParseValueBinding(SliderInt* slider, json& data)
+{
+	EG_CORE_ASSERT(slider != nullptr, "No slider");
+	if (IsBinding(data["Value"]))
+		slider->BindValue(*ParseBinding<int>(data, "Value"));
+}
 }
\ No newline at end of file
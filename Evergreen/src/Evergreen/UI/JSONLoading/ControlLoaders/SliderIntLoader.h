@@ -81,6 +81,7 @@ private:
 	void ParseOnBeginDragging(SliderInt* slider, json& data);
 	void ParseOnStoppedDragging(SliderInt* slider, json& data);
 	void ParseOnValueChanged(SliderInt* slider, json& data);
+	void ParseValueBinding(SliderInt* slider, json& data);
 
 };
 #pragma warning( pop )
@@ -52,14 +52,14 @@ Control* TextInputLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceResour
 	EG_CORE_ASSERT(inputTextStyle != nullptr, "Not allowed to return nullptr. Should have thrown exception");
 
 	// Warn about unrecognized keys
-	constexpr std::array recognizedKeys{ "id", "Type", "Row", "Column", "RowSpan", "ColumnSpan", "Margin",
+	static constexpr StaticKeySet recognizedKeys{ "id", "Type", "Row", "Column", "RowSpan", "ColumnSpan", "Margin",
 	"BackgroundBrush", "BorderBrush", "BorderWidth", "PlaceholderText", "PlaceholderTextBrush", "PlaceholderTextStyle", 
 	"InputTextBrush", "InputTextStyle", "VerticalBarBrush", "VerticalBarWidth", "OnMouseEntered", "OnMouseExited",
 	"OnMouseMoved", "OnMouseLButtonDown", "OnClick", "OnEnterKey", "OnInputTextChanged", 
-	"RightSideLayoutColumnWidth", "RightSideLayout", "OnUpdate" };
+	"RightSideLayoutColumnWidth", "RightSideLayout", "OnUpdate", "Multiline" };
 	for (auto& [key, value] : data.items())
 	{
-		if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) == recognizedKeys.end())
+		if (!recognizedKeys.Contains(key))
 			EG_CORE_WARN("{}:{} - TextInput control with name '{}'. Unrecognized key: '{}'.", __FILE__, __LINE__, m_name, key);
 	}
 
@@ -84,6 +84,7 @@ Control* TextInputLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceResour
 
 	ParseVerticalBarBrush(textInput, data);
 	ParseVerticalBarWidth(textInput, data);
+	ParseMultiline(textInput, data);
 
 	ParseOnMouseEnter(textInput, data);
 	ParseOnMouseExited(textInput, data);
@@ -251,6 +252,17 @@ void TextInputLoader::ParseVerticalBarWidth(TextInput* textInput, json& data)
 		textInput->SetVerticalBarWidth(width);
 	}
 }
+void TextInputLoader::ParseMultiline(TextInput* textInput, json& data)
+{
+	EG_CORE_ASSERT(textInput != nullptr, "textInput should not be nullptr");
+
+	if (data.contains("Multiline"))
+	{
+		JSON_LOADER_EXCEPTION_IF_FALSE(data["Multiline"].is_boolean(), "TextInput control with name '{}': 'Multiline' value must be a boolean. Invalid TextInput object: {}", m_name, data.dump(4));
+
+		textInput->SetMultiline(data["Multiline"].get<bool>());
+	}
+}
 
 void TextInputLoader::ParseOnMouseEnter(TextInput* textInput, json& data)
 {
@@ -47,6 +47,7 @@ private:
 	// Methods to set attributes not included in the TextInput constructor
 	void ParseVerticalBarBrush(TextInput* textInput, json& data);
 	void ParseVerticalBarWidth(TextInput* textInput, json& data);
+	void ParseMultiline(TextInput* textInput, json& data);
 
 	void ParseOnMouseEnter(TextInput* textInput, json& data);
 	void ParseOnMouseExited(TextInput* textInput, json& data);
@@ -37,12 +37,12 @@ Control* TextLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceResources,
 
 
 	// Warn about unrecognized keys
-	constexpr std::array recognizedKeys{ "id", "Type", "Text", "Row", "Column", "RowSpan", "ColumnSpan", "Margin",
+	static constexpr StaticKeySet recognizedKeys{ "id", "Type", "Text", "Row", "Column", "RowSpan", "ColumnSpan", "Margin",
 	"Style", "Brush", "FontFamily", "FontSize", "FontWeight", "FontStyle", "FontStretch", "TextAlignment",
 	"ParagraphAlignment", "WordWrapping", "Trimming", "Locale", "OnUpdate"};
 	for (auto& [key, value] : data.items())
 	{
-		if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) == recognizedKeys.end())
+		if (!recognizedKeys.Contains(key))
 			EG_CORE_WARN("{}:{} - Text control with name '{}'. Unrecognized key: '{}'.", __FILE__, __LINE__, m_name, key);
 	}
 
@@ -53,6 +53,7 @@ Control* TextLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceResources,
 	textControl->Name(name);
 	textControl->ID(ParseID(data));
 
+	ParseTextBinding(textControl, data);
 	ParseOnUpdateCallback(textControl, data);
 	
 	return textControl;
@@ -64,14 +65,14 @@ void TextLoader::ValidateJSONData(json& data)
 	// no other TextStyle fields are present
 	if (data.contains("Style"))
 	{
-		constexpr std::array textStyleFields = {
+		static constexpr StaticKeySet textStyleFields{
 			"FontFamily", "FontSize", "FontWeight", "FontStyle", "FontStretch", "TextAlignment",
 			"ParagraphAlignment", "WordWrapping", "Trimming", "Locale"
 		};
 
 		for (auto& [key, value] : data.items())
 		{
-			JSON_LOADER_EXCEPTION_IF_FALSE(std::find(textStyleFields.begin(), textStyleFields.end(), key) == textStyleFields.end(), "Invalid json for Text control with name '{}'. Cannot include '{}' field if 'Style' field is specified.", m_name, key);
+			JSON_LOADER_EXCEPTION_IF_FALSE(!textStyleFields.Contains(key), "Invalid json for Text control with name '{}'. Cannot include '{}' field if 'Style' field is specified.", m_name, key);
 		}
 	}
 }
@@ -80,7 +81,7 @@ std::wstring TextLoader::ParseText(json& data)
 {
 	std::wstring text = L"";
 
-	if (data.contains("Text"))
+	if (data.contains("Text") && !IsBinding(data["Text"]))
 	{
 		JSON_LOADER_EXCEPTION_IF_FALSE(data["Text"].is_string(), "Text control with name '{}': 'Text' field must be a string. Invalid value: {}", m_name, data["Text"].dump(4));
 
@@ -111,6 +112,28 @@ std::wstring TextLoader::ParseText(json& data)
 
 	return text;
 }
+void TextLoader::ParseTextBinding(Text* text, json& data)
+{
+	EG_CORE_ASSERT(text != nullptr, "No text");
+
+	if (!data.contains("Text") || !IsBinding(data["Text"]))
+		return;
+
+	ObservableBase* observable = ParseBinding(data, "Text");
+
+	if (observable->HoldsType<std::wstring>())
+		text->BindText(*static_cast<Observable<std::wstring>*>(observable));
+	else if (observable->HoldsType<int>())
+		text->BindText(*static_cast<Observable<int>*>(observable));
+	else if (observable->HoldsType<unsigned int>())
+		text->BindText(*static_cast<Observable<unsigned int>*>(observable));
+	else if (observable->HoldsType<float>())
+		text->BindText(*static_cast<Observable<float>*>(observable));
+	else if (observable->HoldsType<double>())
+		text->BindText(*static_cast<Observable<double>*>(observable));
+	else
+		JSON_LOADER_EXCEPTION("Text control with name '{}': 'Text' can only be bound to an Observable<std::wstring/int/unsigned int/float/double>. Invalid data: {}", m_name, data.dump(4));
+}
 std::unique_ptr<ColorBrush> TextLoader::ParseBrush(std::shared_ptr<DeviceResources> deviceResources, json& data)
 {
 	EG_CORE_ASSERT(deviceResources != nullptr, "No device resources");
@@ -35,6 +35,7 @@ private:
 	void ValidateJSONData(json& data);
 
 	std::wstring ParseText(json& data);
+	void ParseTextBinding(Text* text, json& data);
 	std::unique_ptr<ColorBrush> ParseBrush(std::shared_ptr<DeviceResources> deviceResources, json& data);
 	std::unique_ptr<TextStyle> ParseStyle(std::shared_ptr<DeviceResources> deviceResources, json& data);
 
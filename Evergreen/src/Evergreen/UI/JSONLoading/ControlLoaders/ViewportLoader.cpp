@@ -16,13 +16,13 @@ Control* ViewportLoader::LoadImpl(std::shared_ptr<DeviceResources> deviceResourc
 	Margin margin = ParseMargin(data);
 
 	// Warn about unrecognized keys
-	constexpr std::array recognizedKeys{ "id", "Type", "Row", "Column", "RowSpan", "ColumnSpan", "Margin",
+	static constexpr StaticKeySet recognizedKeys{ "id", "Type", "Row", "Column", "RowSpan", "ColumnSpan", "Margin",
 	"Content", "OnChar", "OnKeyPressed", "OnKeyReleased", "OnMouseEntered", "OnMouseExited", "OnMouseMoved", 
 	"OnMouseScrolledVertical", "OnMouseScrolledHorizontal", "OnMouseButtonPressed", "OnMouseButtonReleased", 
 	"OnClick", "OnDoubleClick", "OnUpdate"};
 	for (auto& [key, value] : data.items())
 	{
-		if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) == recognizedKeys.end())
+		if (!recognizedKeys.Contains(key))
 			EG_CORE_WARN("{}:{} - Viewport control with name '{}'. Unrecognized key: '{}'.", __FILE__, __LINE__, m_name, key);
 	}
 
@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "JSONLoaders.h"
+#include "JSONStreamLoader.h"
 #include "Evergreen/UI/Utils/ColorHelper.h"
 #include <fstream>
 
@@ -80,10 +81,10 @@ std::unique_ptr<ColorBrush> JSONLoaders::LoadSolidColorBrush(std::shared_ptr<Dev
 	JSON_LOADER_EXCEPTION_IF_FALSE(data.contains("Color"), "SolidColorBrush json object must have key 'Color'. Incomplete 'SolidColorBrush' object: {}", data.dump(4));
 
 	// Warn about unrecognized keys
-	constexpr std::array recognizedKeys{ "Type", "Color" };
+	static constexpr StaticKeySet recognizedKeys{ "Type", "Color" };
 	for (auto& [key, value] : data.items())
 	{
-		if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) == recognizedKeys.end())
+		if (!recognizedKeys.Contains(key))
 			EG_CORE_WARN("{}:{} - JSONLoaders::LoadSolidColorBrush() unrecognized key: '{}'.", __FILE__, __LINE__, key);
 	}
 
@@ -111,10 +112,10 @@ std::unique_ptr<ColorBrush> JSONLoaders::LoadGradientBrush(std::shared_ptr<Devic
 		JSON_LOADER_EXCEPTION_IF_FALSE(stopObject.contains("Position"), "Each 'Stops' array values must contain the key 'Position'. Invalid 'Stops' object: {}", stopObject.dump(4));
 
 		// Warn about unrecognized keys
-		constexpr std::array recognizedKeys{ "Color", "Position" };
+		static constexpr StaticKeySet recognizedKeys{ "Color", "Position" };
 		for (auto& [key, value] : stopObject.items())
 		{
-			if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) == recognizedKeys.end())
+			if (!recognizedKeys.Contains(key))
 				EG_CORE_WARN("{}:{} - JSONLoaders::LoadGradientBrush() 'Stops' value unrecognized key: '{}'.", __FILE__, __LINE__, key);
 		}
 
@@ -189,10 +190,10 @@ std::unique_ptr<ColorBrush> JSONLoaders::LoadGradientBrush(std::shared_ptr<Devic
 	}
 
 	// Warn about unrecognized keys
-	constexpr std::array recognizedKeys{ "Type", "Stops", "Gamma", "ExtendMode", "Axis" };
+	static constexpr StaticKeySet recognizedKeys{ "Type", "Stops", "Gamma", "ExtendMode", "Axis" };
 	for (auto& [key, value] : data.items())
 	{
-		if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) == recognizedKeys.end())
+		if (!recognizedKeys.Contains(key))
 			EG_CORE_WARN("{}:{} - JSONLoaders::LoadGradientBrush() unrecognized key: '{}'.", __FILE__, __LINE__, key);
 	}
 
@@ -220,10 +221,10 @@ std::unique_ptr<ColorBrush> JSONLoaders::LoadRadialBrush(std::shared_ptr<DeviceR
 		JSON_LOADER_EXCEPTION_IF_FALSE(stopObject.contains("Position"), "Each 'Stops' array values must contain the key 'Position'. Invalid 'Stops' object: {}", stopObject.dump(4));
 
 		// Warn about unrecognized keys
-		constexpr std::array recognizedKeys{ "Color", "Position" };
+		static constexpr StaticKeySet recognizedKeys{ "Color", "Position" };
 		for (auto& [key, value] : stopObject.items())
 		{
-			if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) == recognizedKeys.end())
+			if (!recognizedKeys.Contains(key))
 				EG_CORE_WARN("{}:{} - JSONLoaders::LoadRadialBrush() 'Stops' value unrecognized key: '{}'.", __FILE__, __LINE__, key);
 		}
 
@@ -289,10 +290,10 @@ std::unique_ptr<ColorBrush> JSONLoaders::LoadRadialBrush(std::shared_ptr<DeviceR
 	}
 
 	// Warn about unrecognized keys
-	constexpr std::array recognizedKeys{ "Type", "Stops", "Gamma", "ExtendMode", "OriginOffset" };
+	static constexpr StaticKeySet recognizedKeys{ "Type", "Stops", "Gamma", "ExtendMode", "OriginOffset" };
 	for (auto& [key, value] : data.items())
 	{
-		if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) == recognizedKeys.end())
+		if (!recognizedKeys.Contains(key))
 			EG_CORE_WARN("{}:{} - JSONLoaders::LoadRadialBrush() 'Stops' unrecognized key: '{}'.", __FILE__, __LINE__, key);
 	}
 
@@ -391,10 +392,10 @@ std::unique_ptr<ColorBrush> JSONLoaders::LoadBitmapBrush(std::shared_ptr<DeviceR
 	}
 
 	// Warn about unrecognized keys
-	constexpr std::array recognizedKeys{ "Type", "File", "TransformMethod", "ExtendModeX", "ExtendModeY", "InterpolationMode" };
+	static constexpr StaticKeySet recognizedKeys{ "Type", "File", "TransformMethod", "ExtendModeX", "ExtendModeY", "InterpolationMode" };
 	for (auto& [key, value] : data.items())
 	{
-		if (std::find(recognizedKeys.begin(), recognizedKeys.end(), key) == recognizedKeys.end())
+		if (!recognizedKeys.Contains(key))
 			EG_CORE_WARN("{}:{} - JSONLoaders::LoadBitmapBrush() unrecognized key: '{}'.", __FILE__, __LINE__, key);
 	}
 
@@ -441,6 +442,7 @@ bool JSONLoaders::LoadUIImpl(std::shared_ptr<DeviceResources> deviceResources, c
 		std::filesystem::path rootFilePath = std::filesystem::path(rootDirectory).append(rootFile);
 
 		m_jsonRoot = LoadJSONFile(rootFilePath);
+		m_jsonRootMemory.Set(EstimateJSONSize(m_jsonRoot));
 
 		// Before constructing the layout, load global data that can be retrieved later on
 		LoadGlobalStyles(deviceResources);
@@ -456,6 +458,7 @@ bool JSONLoaders::LoadUIImpl(std::shared_ptr<DeviceResources> deviceResources, c
 
 		// Cleanup
 		m_jsonRoot = {};
+		m_jsonRootMemory.Set(0);
 
 		return true;
 	}
@@ -487,6 +490,78 @@ bool JSONLoaders::LoadUIImpl(std::shared_ptr<DeviceResources> deviceResources, c
 
 	m_controlNames.clear();
 	m_jsonRoot = {};
+	m_jsonRootMemory.Set(0);
+	return false;
+}
+bool JSONLoaders::LoadUIStreamingImpl(std::shared_ptr<DeviceResources> deviceResources, const std::filesystem::path& rootDirectory, const std::string& rootFile, Layout* rootLayout) noexcept
+{
+	// See LoadUIImpl
+	m_controlNames.clear();
+
+	try
+	{
+		m_jsonRootDirectory = rootDirectory;
+		std::filesystem::path rootFilePath = std::filesystem::path(rootDirectory).append(rootFile);
+
+		std::ifstream file(rootFilePath, std::ios::binary);
+		JSON_LOADER_EXCEPTION_IF_FALSE(file.is_open(), "Failed to open file '{}'", rootFilePath.string());
+
+		// Collects every root level key except 'root' (styles, panes, json to import, ...), then loads the global styles
+		// and creates the root layout and all of its controls while parsing 'root'.
+		// This can throw and somewhere up the call tree there needs to be a catch for json::parse_error
+		m_jsonRoot = json::object();
+		JSONStreamLoader loader(*this, deviceResources, rootLayout);
+		json::sax_parse(file, &loader);
+		m_jsonRootMemory.Set(EstimateJSONSize(m_jsonRoot));
+
+		// 'root' came before the global styles, so it was collected whole instead. Load it the same way LoadUI does
+		if (!loader.RootStreamed())
+		{
+			LoadGlobalStyles(deviceResources);
+			LoadLayoutDetails(deviceResources, rootLayout, m_jsonRoot["root"]);
+		}
+
+		// Finally, load all panes
+		LoadPanes(deviceResources, rootLayout);
+
+		// LayoutCheck is entirely optional - In a Release build, this does nothing
+		rootLayout->LayoutCheck();
+
+		// Cleanup
+		m_jsonRoot = {};
+		m_jsonRootMemory.Set(0);
+
+		return true;
+	}
+	catch (const JSONLoadersException& ex)
+	{
+		EG_CORE_ERROR("Failed to load UI file '{}'", rootFile);
+		EG_CORE_ERROR("Caught JSONLoadersException with message:\n{}", ex.what());
+	}
+	catch (const BaseException& ex)
+	{
+		EG_CORE_ERROR("Failed to load UI file '{}'", rootFile);
+		EG_CORE_ERROR("Caught BaseException with message:\n{}", ex.what());
+	}
+	catch (json::parse_error& e)
+	{
+		EG_CORE_ERROR("Failed to load UI file '{}'", rootFile);
+		EG_CORE_ERROR("Caught json::parse_error:\n{}", e.what());
+	}
+	catch (const std::exception& ex)
+	{
+		EG_CORE_ERROR("Failed to load UI file '{}'", rootFile);
+		EG_CORE_ERROR("Caught std::exception with message:\n{}", ex.what());
+	}
+	catch (...)
+	{
+		EG_CORE_ERROR("Failed to load UI file '{}'", rootFile);
+		EG_CORE_ERROR("{}", "Caught unidentified exception");
+	}
+
+	m_controlNames.clear();
+	m_jsonRoot = {};
+	m_jsonRootMemory.Set(0);
 	return false;
 }
 void JSONLoaders::LoadControlsFromFileImpl(const std::string& fileName, Layout* parentLayout, std::optional<RowColumnPosition> rowColumnPositionOverride)
@@ -501,6 +576,7 @@ void JSONLoaders::LoadControlsFromFileImpl(const std::string& fileName, Layout*
 	{
 		std::filesystem::path filePath = std::filesystem::path(m_jsonRootDirectory).append(fileName);
 		json data = LoadJSONFile(filePath);
+		ExternalMemory dataMemory(MemoryCategory::JSON, EstimateJSONSize(data));
 
 		for (auto& [key, value] : data.items())
 		{
@@ -564,6 +640,7 @@ void JSONLoaders::LoadLayoutFromFileImpl(const std::string& fileName, Layout* la
 	{
 		std::filesystem::path filePath = std::filesystem::path(m_jsonRootDirectory).append(fileName); 
 		json data = LoadJSONFile(filePath); 
+		ExternalMemory dataMemory(MemoryCategory::JSON, EstimateJSONSize(data));
 
 		for (auto& [key, value] : data.items()) 
 		{
@@ -628,6 +705,9 @@ json JSONLoaders::LoadJSONFile(std::filesystem::path filePath)
 		fileData = oss.str();
 		file.close();
 
+		// The text only lives until it has been parsed, but it is part of the peak
+		ExternalMemory fileMemory(MemoryCategory::JSON, fileData.capacity());
+
 		// This can throw and somewhere up the call tree there needs to be a catch for json::parse_error
 		return json::parse(fileData);
 	}
@@ -635,6 +715,38 @@ json JSONLoaders::LoadJSONFile(std::filesystem::path filePath)
 	JSON_LOADER_EXCEPTION("Failed to open file '{}'", filePath.string());
 	return {};
 }
+size_t JSONLoaders::EstimateJSONSize(const json& data) noexcept
+{
+	// Strings, arrays and objects each own a separate allocation. Object entries are tree nodes (three pointers and
+	// a color) holding the key and the value
+	constexpr size_t mapNodeOverhead = 4 * sizeof(void*);
+
+	switch (data.type())
+	{
+	case json::value_t::string:
+		return sizeof(json) + sizeof(json::string_t) + data.get_ref<const json::string_t&>().capacity();
+
+	case json::value_t::array:
+	{
+		const json::array_t& array = data.get_ref<const json::array_t&>();
+		size_t size = sizeof(json) + sizeof(json::array_t) + (array.capacity() - array.size()) * sizeof(json);
+		for (const json& value : array)
+			size += EstimateJSONSize(value);
+		return size;
+	}
+
+	case json::value_t::object:
+	{
+		size_t size = sizeof(json) + sizeof(json::object_t);
+		for (const auto& [key, value] : data.get_ref<const json::object_t&>())
+			size += mapNodeOverhead + sizeof(json::string_t) + key.capacity() + EstimateJSONSize(value);
+		return size;
+	}
+
+	default:
+		return sizeof(json);
+	}
+}
 void JSONLoaders::LoadGlobalStyles(std::shared_ptr<DeviceResources> deviceResources)
 {
 	for (auto& [key, value] : m_jsonRoot.items())
@@ -687,52 +799,35 @@ void JSONLoaders::LoadLayoutDetails(std::shared_ptr<DeviceResources> deviceResou
 	// Now iterate over the controls and sublayouts within the layout
 	for (auto& [key, value] : data.items())
 	{
-		if (key.compare("import") == 0 ||
-			key.compare("id") == 0 ||
-			key.compare("Type") == 0 ||
-			key.compare("Brush") == 0 ||
-			key.compare("Row") == 0 ||
-			key.compare("Column") == 0 ||
-			key.compare("RowSpan") == 0 ||
-			key.compare("ColumnSpan") == 0 ||
-			key.compare("RowDefinitions") == 0 ||
-			key.compare("ColumnDefinitions") == 0 ||
-			key.compare("Margin") == 0 ||
-			key.compare("BorderBrush") == 0 ||
-			key.compare("BorderWidth") == 0 ||
-			key.compare("BorderTopLeftOffsetX") == 0 || 
-			key.compare("BorderTopLeftOffsetY") == 0 ||
-			key.compare("BorderTopRightOffsetX") == 0 ||
-			key.compare("BorderTopRightOffsetY") == 0 ||
-			key.compare("BorderBottomLeftOffsetX") == 0 ||
-			key.compare("BorderBottomLeftOffsetY") == 0 ||
-			key.compare("BorderBottomRightOffsetX") == 0 ||
-			key.compare("BorderBottomRightOffsetY") == 0 ||
-			key.compare("OnResize") == 0)
+		if (LayoutKeys.Contains(key))
 			continue;
 
-		JSON_LOADER_EXCEPTION_IF_FALSE(data[key].contains("Type"), "Control or sub-layout has no 'Type' definition: {}", data[key].dump(4));
-		JSON_LOADER_EXCEPTION_IF_FALSE(data[key]["Type"].is_string(), "Control or sub-layout 'Type' definition must be a string.\nInvalid value : {}", data[key]["Type"].dump(4));
+		LoadLayoutChild(deviceResources, layout, data[key], key);
+	}
+}
+void JSONLoaders::LoadLayoutChild(std::shared_ptr<DeviceResources> deviceResources, Layout* layout, json& data, const std::string& name)
+{
+	JSON_LOADER_EXCEPTION_IF_FALSE(data.contains("Type"), "Control or sub-layout has no 'Type' definition: {}", data.dump(4));
+	JSON_LOADER_EXCEPTION_IF_FALSE(data["Type"].is_string(), "Control or sub-layout 'Type' definition must be a string.\nInvalid value : {}", data["Type"].dump(4));
 
-		std::string type = data[key]["Type"].get<std::string>();
+	std::string type = data["Type"].get<std::string>();
 
-		// Load either a sublayout or control
-		if (type.compare("Layout") == 0)
-		{
-			LoadSubLayout(deviceResources, layout, data[key], key);
-		}
-		else if (JSONLoaders::IsControlKey(type))
-		{
-			ImportJSON(data[key]);
+	// Load either a sublayout or control
+	if (type.compare("Layout") == 0)
+	{
+		LoadSubLayout(deviceResources, layout, data, name);
+	}
+	else if (JSONLoaders::IsControlKey(type))
+	{
+		ImportJSON(data);
 
-			Control* control = JSONLoaders::LoadControl(deviceResources, type, layout, data[key], key);
-			if (control == nullptr)
-				EG_CORE_ERROR("Failed to load control with name '{}'.", key);
-		}
-		else
-		{
-			EG_CORE_WARN("Attempting to load control: {} (... not yet supported ...)", type);
-		}
+		Control* control = JSONLoaders::LoadControl(deviceResources, type, layout, data, name);
+		if (control == nullptr)
+			EG_CORE_ERROR("Failed to load control with name '{}'.", name);
+	}
+	else
+	{
+		EG_CORE_WARN("Attempting to load control: {} (... not yet supported ...)", type);
 	}
 }
 void JSONLoaders::LoadPanes(std::shared_ptr<DeviceResources> deviceResources, Layout* layout)
@@ -1120,7 +1215,7 @@ void JSONLoaders::LoadLayoutMargin(Layout* layout, json& data)
 		layout->Margin(margin);
 	}
 }
-void JSONLoaders::LoadSubLayout(std::shared_ptr<DeviceResources> deviceResources, Layout* parent, json& data, const std::string& name)
+Layout* JSONLoaders::LoadSubLayout(std::shared_ptr<DeviceResources> deviceResources, Layout* parent, json& data, const std::string& name)
 {
 	// First, import any necessary data
 	ImportJSON(data);
@@ -1129,7 +1224,8 @@ void JSONLoaders::LoadSubLayout(std::shared_ptr<DeviceResources> deviceResources
 	RowColumnPosition position = ParseRowColumnPosition(data);
 
 	Layout* sublayout = parent->AddSubLayout(position, name);
-	return LoadLayoutDetails(deviceResources, sublayout, data);
+	LoadLayoutDetails(deviceResources, sublayout, data);
+	return sublayout;
 }
 
 RowColumnPosition JSONLoaders::ParseRowColumnPosition(json& data)
@@ -6,6 +6,9 @@
 #include "Evergreen/UI/Styles/Style.h"
 #include "Evergreen/UI/Controls.h"
 #include "Evergreen/UI/Brushes.h"
+#include "Evergreen/UI/Observable.h"
+#include "Evergreen/UI/JSONLoading/StaticKeySet.h"
+#include "Evergreen/Utils/MemoryAccounting.h"
 #include "Evergreen/Exceptions/JSONLoadersException.h"
 #include "Evergreen/Events/Event.h"
 
@@ -60,7 +63,16 @@ public:
 	static D2D1_COLOR_F LoadColor(json& data);
 
 	static bool LoadUI(std::shared_ptr<DeviceResources> deviceResources, const std::filesystem::path& rootDirectory, const std::string& rootFile, Layout* rootLayout) noexcept { return Get().LoadUIImpl(deviceResources, rootDirectory, rootFile, rootLayout); }
+	// Same as LoadUI, but the root file is parsed as a stream (see JSONStreamLoader) instead of being loaded into a json
+	// object first, so memory use does not grow with the size of the file. Meant for large UI files. Differences to LoadUI:
+	//    - Controls are created in the order they appear in the file (LoadUI creates them in alphabetical order)
+	//    - A Layout's own keys (RowDefinitions, Margin, ...) must come before its controls/sub-layouts
+	//    - Global styles must come before "root". If "root" comes before all of them (or the file has none), "root" is
+	//      loaded from memory like LoadUI does
+	static bool LoadUIStreaming(std::shared_ptr<DeviceResources> deviceResources, const std::filesystem::path& rootDirectory, const std::string& rootFile, Layout* rootLayout) noexcept { return Get().LoadUIStreamingImpl(deviceResources, rootDirectory, rootFile, rootLayout); }
 	static json LoadJSONFile(std::filesystem::path filePath);
+	// Approximate heap footprint of a json document, used to account for it under MemoryCategory::JSON
+	ND static size_t EstimateJSONSize(const json& data) noexcept;
 
 	static void ImportJSON(json& data) { Get().ImportJSONImpl(data); }
 
@@ -79,6 +91,11 @@ public:
 	static void AddLayoutCallback(const std::string& key, LayoutCallbackFn fn) { Get().AddLayoutCallbackImpl(key, fn); }
 	static LayoutCallbackFn GetLayoutCallback(const std::string& key) { return Get().GetLayoutCallbackImpl(key); }
 
+	// Observables that controls can be bound to from JSON - ex. "Text": "{bind:key}". The Observable only needs to
+	// stay alive while JSON that binds to it is being loaded (controls unsubscribe themselves, see ObservableSubscription)
+	static void AddObservable(const std::string& key, ObservableBase& observable) { Get().AddObservableImpl(key, &observable); }
+	static ObservableBase* GetObservable(const std::string& key) { return Get().GetObservableImpl(key); }
+
 public:
 	template <class C, class E>
 	static std::function<void(C*, E&)> GetCallback(const std::string& key) { return Get().GetCallbackImpl<C, E>(key); }
@@ -135,6 +152,14 @@ private:
 
 
 private:
+	friend class JSONStreamLoader;
+
+	// Keys of a Layout object that describe the layout itself. Every other key is a control or sub-layout
+	static constexpr StaticKeySet<22> LayoutKeys{ "import", "id", "Type", "Brush", "Row", "Column", "RowSpan", "ColumnSpan",
+		"RowDefinitions", "ColumnDefinitions", "Margin", "BorderBrush", "BorderWidth", "BorderTopLeftOffsetX", "BorderTopLeftOffsetY",
+		"BorderTopRightOffsetX", "BorderTopRightOffsetY", "BorderBottomLeftOffsetX", "BorderBottomLeftOffsetY", "BorderBottomRightOffsetX",
+		"BorderBottomRightOffsetY", "OnResize" };
+
 	JSONLoaders() noexcept = default;
 
 	static JSONLoaders& Get() noexcept
@@ -151,6 +176,13 @@ private:
 	void AddLayoutCallbackImpl(const std::string& key, LayoutCallbackFn fn) noexcept { m_layoutCallbacks[key] = fn; }
 	LayoutCallbackFn GetLayoutCallbackImpl(const std::string& key) noexcept { return m_layoutCallbacks[key]; }
 
+	void AddObservableImpl(const std::string& key, ObservableBase* observable) noexcept { m_observables[key] = observable; }
+	ObservableBase* GetObservableImpl(const std::string& key) const noexcept
+	{
+		auto it = m_observables.find(key);
+		return it != m_observables.end() ? it->second : nullptr;
+	}
+
 	Control* LoadControlImpl(std::shared_ptr<DeviceResources> deviceResources, const std::string& key, Layout* parent, json& data, const std::string& name, std::optional<RowColumnPosition> rowColumnPositionOverride);
 	std::unique_ptr<Style> LoadStyleImpl(std::shared_ptr<DeviceResources> deviceResources, const std::string& key, json& data, const std::string& stylename);
 
@@ -163,8 +195,10 @@ private:
 	void LoadLayoutFromFileImpl(const std::string& fileName, Layout* layoutToFill);
 
 	bool LoadUIImpl(std::shared_ptr<DeviceResources> deviceResources, const std::filesystem::path& rootDirectory, const std::string& rootFile, Layout* rootLayout) noexcept;
+	bool LoadUIStreamingImpl(std::shared_ptr<DeviceResources> deviceResources, const std::filesystem::path& rootDirectory, const std::string& rootFile, Layout* rootLayout) noexcept;
 	void LoadGlobalStyles(std::shared_ptr<DeviceResources> deviceResources);
 	void LoadLayoutDetails(std::shared_ptr<DeviceResources> deviceResources, Layout* layout, json& data);
+	void LoadLayoutChild(std::shared_ptr<DeviceResources> deviceResources, Layout* layout, json& data, const std::string& name);
 	void LoadPanes(std::shared_ptr<DeviceResources> deviceResources, Layout* layout);
 
 
@@ -175,7 +209,7 @@ private:
 	void LoadLayoutBorder(std::shared_ptr<DeviceResources> deviceResources, Layout* layout, json& data);
 	void LoadLayoutCallbacks(Layout* layout, json& data);
 	void LoadLayoutID(Layout* layout, json& data);
-	void LoadSubLayout(std::shared_ptr<DeviceResources> deviceResources, Layout* parent, json& data, const std::string& name);
+	Layout* LoadSubLayout(std::shared_ptr<DeviceResources> deviceResources, Layout* parent, json& data, const std::string& name);
 
 	RowColumnPosition ParseRowColumnPosition(json& data);
 	std::tuple<RowColumnType, float> ParseRowColumnTypeAndSizeImpl(json& data, const std::string& layoutName);
@@ -190,6 +224,7 @@ private:
 	std::unordered_map<std::string, ControlLoaderFn>	m_controlLoaders; 
 	std::unordered_map<std::string, StyleLoaderFn>		m_styleLoaders;
 	std::unordered_map<std::string, LayoutCallbackFn>	m_layoutCallbacks;
+	std::unordered_map<std::string, ObservableBase*>	m_observables;
 
 	// Keep a cache of styles that have been parsed for quick lookup
 	std::unordered_map<std::string, std::unique_ptr<Style>> m_stylesCache;
@@ -198,6 +233,7 @@ private:
 	std::vector<std::string> m_controlNames;
 
 	json					m_jsonRoot;
+	ExternalMemory			m_jsonRootMemory{ MemoryCategory::JSON };
 	std::filesystem::path	m_jsonRootDirectory;
 };
 #pragma warning( pop )
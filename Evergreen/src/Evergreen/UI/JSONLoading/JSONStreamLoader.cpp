@@ -0,0 +1,269 @@
+#include "pch.h"
+#include "JSONStreamLoader.h"
+
+namespace Evergreen
+{
+JSONStreamLoader::JSONStreamLoader(JSONLoaders& loaders, std::shared_ptr<DeviceResources> deviceResources, Layout* rootLayout) noexcept :
+	m_loaders(loaders),
+	m_deviceResources(std::move(deviceResources)),
+	m_rootLayout(rootLayout),
+	m_inRootObject(false),
+	m_globalStyleRead(false),
+	m_rootStreamed(false),
+	m_capturing(false),
+	m_captureTarget(CaptureTarget::ROOT_KEY),
+	m_childTypeIsNext(false)
+{
+	EG_CORE_ASSERT(m_deviceResources != nullptr, "No device resources");
+	EG_CORE_ASSERT(m_rootLayout != nullptr, "No root layout");
+}
+
+JSONStreamLoader::Action JSONStreamLoader::BeginValue(bool isObject)
+{
+	// The file itself
+	if (!m_inRootObject)
+	{
+		JSON_LOADER_EXCEPTION_IF_FALSE(isObject, "{}", "The root of a UI file must be a json object");
+		m_inRootObject = true;
+		return Action::NONE;
+	}
+
+	// A root level key
+	if (m_layouts.empty())
+	{
+		// 'root' can only be streamed once the global styles its controls refer to have been loaded. If no global style
+		// has been read yet, collect it like any other root level key and leave it to JSONLoaders
+		if (m_key.compare("root") != 0 || !m_globalStyleRead)
+		{
+			BeginCapture(CaptureTarget::ROOT_KEY, m_key);
+			return Action::CAPTURE;
+		}
+
+		JSON_LOADER_EXCEPTION_IF_FALSE(isObject, "{}", "'root' value must be a json object");
+		JSON_LOADER_EXCEPTION_IF_FALSE(!m_rootStreamed, "{}", "UI file contains more than one 'root' key");
+
+		// Before constructing the layout, load global data that can be retrieved later on
+		m_loaders.m_jsonRootMemory.Set(JSONLoaders::EstimateJSONSize(m_loaders.m_jsonRoot));
+		m_loaders.LoadGlobalStyles(m_deviceResources);
+		m_rootStreamed = true;
+
+		m_layouts.push_back({ nullptr, nullptr, m_key, json::object() });
+		return Action::NONE;
+	}
+
+	// A key within a layout
+	LayoutFrame& frame = m_layouts.back();
+	if (JSONLoaders::LayoutKeys.Contains(m_key))
+	{
+		JSON_LOADER_EXCEPTION_IF_FALSE(frame.layout == nullptr, "Layout with name '{}': Key '{}' must come before the layout's controls and sub-layouts when loading with JSONLoaders::LoadUIStreaming()", frame.name, m_key);
+
+		BeginCapture(CaptureTarget::LAYOUT_PROPERTY, m_key);
+		return Action::CAPTURE;
+	}
+
+	JSON_LOADER_EXCEPTION_IF_FALSE(isObject, "Layout with name '{}': Control or sub-layout '{}' must be a json object", frame.name, m_key);
+
+	// This is the first control/sub-layout, so all of the layout's own keys have been read
+	if (frame.layout == nullptr)
+		CreateLayout(frame);
+
+	BeginCapture(CaptureTarget::CHILD, m_key);
+	return Action::CAPTURE;
+}
+
+bool JSONStreamLoader::string(json::string_t& value)
+{
+	// A child whose first key is "Type": "Layout" is streamed just like the root layout instead of being collected
+	if (m_childTypeIsNext && value.compare("Layout") == 0)
+	{
+		m_childTypeIsNext = false;
+		m_capturing = false;
+		m_captureStack.clear();
+		m_captured = json();
+
+		m_layouts.push_back({ m_layouts.back().layout, nullptr, m_captureName, json{ { "Type", "Layout" } } });
+		return true;
+	}
+
+	return Value(json(std::move(value)));
+}
+
+bool JSONStreamLoader::start_object(std::size_t)
+{
+	if (m_capturing || BeginValue(true) == Action::CAPTURE)
+		return StartContainer(json::object());
+
+	return true;
+}
+
+bool JSONStreamLoader::start_array(std::size_t)
+{
+	if (m_capturing || BeginValue(false) == Action::CAPTURE)
+		return StartContainer(json::array());
+
+	return true;
+}
+
+bool JSONStreamLoader::key(json::string_t& key)
+{
+	if (m_capturing)
+	{
+		m_childTypeIsNext = m_captureTarget == CaptureTarget::CHILD && m_captureStack.size() == 1 && m_captured.empty() && key.compare("Type") == 0;
+		m_captureKey = std::move(key);
+		return true;
+	}
+
+	m_key = std::move(key);
+	return true;
+}
+
+bool JSONStreamLoader::end_object()
+{
+	if (m_capturing)
+		return EndContainer();
+
+	// The end of a layout, or of the file
+	if (!m_layouts.empty())
+	{
+		// A layout without any controls or sub-layouts
+		if (m_layouts.back().layout == nullptr)
+			CreateLayout(m_layouts.back());
+
+		m_layouts.pop_back();
+	}
+	else
+	{
+		m_inRootObject = false;
+	}
+	return true;
+}
+
+bool JSONStreamLoader::Value(json&& value)
+{
+	if (!m_capturing && BeginValue(false) != Action::CAPTURE)
+		return true;
+
+	m_childTypeIsNext = false;
+
+	if (m_captureStack.empty())
+	{
+		m_captured = std::move(value);
+		CaptureComplete();
+		return true;
+	}
+
+	json& parent = *m_captureStack.back();
+	if (parent.is_object())
+		parent[m_captureKey] = std::move(value);
+	else
+		parent.push_back(std::move(value));
+
+	return true;
+}
+
+bool JSONStreamLoader::StartContainer(json&& container)
+{
+	m_childTypeIsNext = false;
+
+	// NOTE: Pointers to the open containers stay valid, because nothing is added to a container's parent until the
+	//       container has been closed
+	json* added = nullptr;
+	if (m_captureStack.empty())
+	{
+		m_captured = std::move(container);
+		added = &m_captured;
+	}
+	else
+	{
+		json& parent = *m_captureStack.back();
+		if (parent.is_object())
+		{
+			added = &(parent[m_captureKey] = std::move(container));
+		}
+		else
+		{
+			parent.push_back(std::move(container));
+			added = &parent.back();
+		}
+	}
+
+	m_captureStack.push_back(added);
+	return true;
+}
+
+bool JSONStreamLoader::EndContainer()
+{
+	EG_CORE_ASSERT(m_capturing && !m_captureStack.empty(), "Unexpected end of container");
+
+	m_captureStack.pop_back();
+	if (m_captureStack.empty())
+		CaptureComplete();
+
+	return true;
+}
+
+void JSONStreamLoader::BeginCapture(CaptureTarget target, const std::string& name) noexcept
+{
+	m_capturing = true;
+	m_captureTarget = target;
+	m_captureName = name;
+	m_captured = json();
+	m_captureStack.clear();
+	m_childTypeIsNext = false;
+}
+
+void JSONStreamLoader::CaptureComplete()
+{
+	m_capturing = false;
+
+	switch (m_captureTarget)
+	{
+	case CaptureTarget::ROOT_KEY:
+		if (IsGlobalStyle(m_captured))
+		{
+			JSON_LOADER_EXCEPTION_IF_FALSE(!m_rootStreamed, "Global style '{}' must come before 'root' when loading with JSONLoaders::LoadUIStreaming()", m_captureName);
+			m_globalStyleRead = true;
+		}
+		m_loaders.m_jsonRoot[m_captureName] = std::move(m_captured);
+		break;
+
+	case CaptureTarget::LAYOUT_PROPERTY:
+		m_layouts.back().properties[m_captureName] = std::move(m_captured);
+		break;
+
+	case CaptureTarget::CHILD:
+		EG_CORE_ASSERT(m_layouts.back().layout != nullptr, "Layout should have been created before its first child");
+		m_loaders.LoadLayoutChild(m_deviceResources, m_layouts.back().layout, m_captured, m_captureName);
+		break;
+	}
+
+	// Release the control's json right away
+	m_captured = json();
+}
+
+void JSONStreamLoader::CreateLayout(LayoutFrame& frame)
+{
+	if (frame.parent == nullptr)
+	{
+		frame.layout = m_rootLayout;
+		m_loaders.LoadLayoutDetails(m_deviceResources, frame.layout, frame.properties);
+	}
+	else
+	{
+		frame.layout = m_loaders.LoadSubLayout(m_deviceResources, frame.parent, frame.properties, frame.name);
+	}
+
+	frame.properties = json();
+}
+
+bool JSONStreamLoader::IsGlobalStyle(const json& value) const noexcept
+{
+	// Mirrors the check in JSONLoaders::LoadGlobalStyles
+	if (!value.is_object())
+		return false;
+
+	auto type = value.find("Type");
+	return type != value.end() && type->is_string() && m_loaders.IsStyleKeyImpl(type->get_ref<const std::string&>());
+}
+
+}
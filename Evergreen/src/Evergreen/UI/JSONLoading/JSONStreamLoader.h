@@ -0,0 +1,109 @@
+#pragma once
+#include "pch.h"
+#include "JSONLoaders.h"
+
+namespace Evergreen
+{
+// nlohmann SAX handler behind JSONLoaders::LoadUIStreaming(). Controls are created while the file is being parsed,
+// so the file is never held in memory as a whole:
+//    - Layouts are streamed: a Layout's own keys are collected until its first control/sub-layout key is reached, at
+//      which point the Layout is created, and its controls/sub-layouts are then loaded one at a time
+//    - Every control is collected into a small json object, which is handed to its control loader (the same loaders
+//      LoadUI uses) and released as soon as the control has been created
+//
+// The root file is parsed once. Every root level key other than "root" (global styles, Panes and the json that 'import'
+// refers to) is collected into JSONLoaders::m_jsonRoot. When "root" is reached, the global styles read so far are
+// loaded and "root" is streamed, so a UI file should list its global data first and "root" after it. If "root" comes
+// before any global style, it is collected whole instead and JSONLoaders loads it once the file has been parsed, just
+// like LoadUI would (this includes files without any global styles). A global style that only appears after a streamed
+// "root" is an error.
+//
+// Memory use is therefore bounded by the largest single control (plus the root level keys), not by the file.
+#pragma warning( push )
+#pragma warning( disable : 4251 ) // needs to have dll-interface to be used by clients of class
+class JSONStreamLoader
+{
+public:
+	JSONStreamLoader(JSONLoaders& loaders, std::shared_ptr<DeviceResources> deviceResources, Layout* rootLayout) noexcept;
+	JSONStreamLoader(const JSONStreamLoader&) = delete;
+	JSONStreamLoader& operator=(const JSONStreamLoader&) = delete;
+	~JSONStreamLoader() noexcept = default;
+
+	// False if "root" was collected into JSONLoaders::m_jsonRoot instead (or there was no "root" key)
+	ND inline bool RootStreamed() const noexcept { return m_rootStreamed; }
+
+	// nlohmann SAX interface
+	bool null() { return Value(json(nullptr)); }
+	bool boolean(bool value) { return Value(json(value)); }
+	bool number_integer(json::number_integer_t value) { return Value(json(value)); }
+	bool number_unsigned(json::number_unsigned_t value) { return Value(json(value)); }
+	bool number_float(json::number_float_t value, const json::string_t&) { return Value(json(value)); }
+	bool string(json::string_t& value);
+	bool binary(json::binary_t& value) { return Value(json(std::move(value))); }
+	bool start_object(std::size_t);
+	bool key(json::string_t& key);
+	bool end_object();
+	bool start_array(std::size_t);
+	bool end_array() { return EndContainer(); }
+
+	template<typename Exception>
+	bool parse_error(std::size_t, const std::string&, const Exception& ex)
+	{
+		// Rethrow as the same exception type json::parse() would have thrown
+		throw ex;
+	}
+
+private:
+	struct LayoutFrame
+	{
+		Layout* parent;			// nullptr for the root layout
+		Layout* layout;			// nullptr until the layout's own keys have been read
+		std::string name;
+		json properties;		// The layout's own keys
+	};
+
+	enum class CaptureTarget
+	{
+		ROOT_KEY,
+		LAYOUT_PROPERTY,
+		CHILD
+	};
+
+	enum class Action
+	{
+		NONE,
+		CAPTURE
+	};
+
+	ND Action BeginValue(bool isObject);
+	bool Value(json&& value);
+	bool StartContainer(json&& container);
+	bool EndContainer();
+
+	void BeginCapture(CaptureTarget target, const std::string& name) noexcept;
+	void CaptureComplete();
+	void CreateLayout(LayoutFrame& frame);
+	ND bool IsGlobalStyle(const json& value) const noexcept;
+
+	JSONLoaders&					m_loaders;
+	std::shared_ptr<DeviceResources> m_deviceResources;
+	Layout*							m_rootLayout;
+
+	bool							m_inRootObject;
+	bool							m_globalStyleRead;
+	bool							m_rootStreamed;
+	std::string						m_key;			// The last key read outside of a capture (root or layout level)
+	std::vector<LayoutFrame>		m_layouts;
+
+	// The json value currently being collected. m_captureStack holds the open objects/arrays within it
+	bool							m_capturing;
+	CaptureTarget					m_captureTarget;
+	std::string						m_captureName;
+	json							m_captured;
+	std::vector<json*>				m_captureStack;
+	std::string						m_captureKey;
+	bool							m_childTypeIsNext;
+};
+#pragma warning( pop )
+
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include "pch.h"
+#include "Evergreen/Core.h"
+
+#include <bit>
+
+namespace Evergreen
+{
+// A fixed set of JSON keys, looked up with a perfect hash that is found at compile time. A lookup hashes the key once,
+// reads the single slot it maps to, and compares against the one key that can live there - so checking a key against
+// a control's 25 recognized keys costs the same as checking it against 2.
+//
+//		static constexpr StaticKeySet recognizedKeys{ "Type", "Row", "Column" };
+//		if (!recognizedKeys.Contains(key)) ...
+//
+// IndexOf() returns the position of the key in the list it was declared with, which is also constexpr, so it can be
+// used to dispatch on a key with a switch:
+//
+//		switch (recognizedKeys.IndexOf(key))
+//		{
+//		case recognizedKeys.IndexOf("Row"): ...
+//		}
+template<size_t N>
+class StaticKeySet
+{
+public:
+	static constexpr size_t NotFound = N;
+
+	template<typename... Keys>
+	consteval StaticKeySet(Keys... keys) :
+		m_keys{ std::string_view(keys)... },
+		m_slots{},
+		m_seed(0)
+	{
+		static_assert(N > 0 && N < Empty, "StaticKeySet must hold between 1 and 254 keys");
+
+		for (size_t iii = 0; iii < N; ++iii)
+		{
+			if (m_keys[iii].empty())
+				throw "StaticKeySet: empty key (or fewer keys than N)";
+
+			for (size_t jjj = iii + 1; jjj < N; ++jjj)
+			{
+				if (m_keys[iii] == m_keys[jjj])
+					throw "StaticKeySet: duplicate key"; // Not a constant expression -> compile error
+			}
+		}
+
+		// Try seeds until every key lands in its own slot. With 4 slots per key, this only takes a handful of tries
+		for (;; ++m_seed)
+		{
+			if (m_seed == 100000)
+				throw "StaticKeySet: failed to find a perfect hash";
+
+			std::fill(m_slots.begin(), m_slots.end(), Empty);
+
+			bool collision = false;
+			for (size_t iii = 0; iii < N && !collision; ++iii)
+			{
+				uint8_t& slot = m_slots[Slot(m_keys[iii], m_seed)];
+				if (slot != Empty)
+					collision = true;
+				else
+					slot = static_cast<uint8_t>(iii);
+			}
+
+			if (!collision)
+				break;
+		}
+	}
+
+	ND constexpr size_t IndexOf(std::string_view key) const noexcept
+	{
+		const uint8_t index = m_slots[Slot(key, m_seed)];
+		return index != Empty && m_keys[index] == key ? index : NotFound;
+	}
+	ND constexpr bool Contains(std::string_view key) const noexcept { return IndexOf(key) != NotFound; }
+	ND constexpr std::string_view operator[](size_t index) const noexcept { return m_keys[index]; }
+	ND static constexpr size_t Size() noexcept { return N; }
+
+private:
+	static constexpr uint8_t Empty = 0xFF;
+	static constexpr size_t SlotCount = std::bit_ceil(N * 4);
+
+	// FNV-1a, seeded, with a final mix so that the low bits (which select the slot) depend on the whole key
+	ND static constexpr size_t Slot(std::string_view key, uint32_t seed) noexcept
+	{
+		uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+		for (char c : key)
+		{
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 16777619u;
+		}
+		hash ^= hash >> 15;
+		return static_cast<size_t>(hash) & (SlotCount - 1);
+	}
+
+	std::array<std::string_view, N> m_keys;
+	std::array<uint8_t, SlotCount> m_slots;
+	uint32_t m_seed;
+};
+
+template<typename... Keys>
+StaticKeySet(Keys...) -> StaticKeySet<sizeof...(Keys)>;
+
+}
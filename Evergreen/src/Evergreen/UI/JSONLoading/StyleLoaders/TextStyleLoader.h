@@ -4,6 +4,7 @@
 #include "Evergreen/UI/Styles/TextStyle.h"
 #include "Evergreen/UI/Utils/ColorHelper.h"
 #include "Evergreen/Exceptions/JSONLoadersException.h"
+#include "Evergreen/UI/JSONLoading/StaticKeySet.h"
 
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "Layout.h"
+#include "Evergreen/UI/UI.h"
 //#include "Evergreen/Utils/SetCursor.h"
 
 #include "Evergreen/Window/Window.h"
@@ -157,6 +158,18 @@ Layout::Layout(std::shared_ptr<DeviceResources> deviceResources, UI* ui, float t
 	// Leave rows and columns empty for now
 }
 
+void* Layout::operator new(size_t size)
+{
+	void* p = ::operator new(size);
+	MemoryAccounting::TrackAllocation(MemoryCategory::UI_TREE, size);
+	return p;
+}
+void Layout::operator delete(void* p, size_t size) noexcept
+{
+	MemoryAccounting::TrackDeallocation(MemoryCategory::UI_TREE, size);
+	::operator delete(p);
+}
+
 Row* Layout::AddRow(RowColumnDefinition definition)
 {
 	switch (definition.Type)
@@ -571,15 +584,16 @@ void Layout::Update(const Timer& timer)
 }
 void Layout::Render() const
 {
+	EG_PROFILE_LAYOUT_RENDER(this);
 	EG_CORE_ASSERT(m_deviceResources != nullptr, "No device resources");
 	EG_CORE_ASSERT(m_rows.size() > 0, "No rows added");
 	EG_CORE_ASSERT(m_columns.size() > 0, "No columns added");
 
-	auto context = m_deviceResources->D2DDeviceContext();
+	DrawList& drawList = m_ui->GetDrawList();
 
 	if (m_backgroundBrush != nullptr)
 	{
-		context->FillRectangle(
+		drawList.FillRectangle(
 			D2D1::RectF(
 				m_left + m_margin.Left, 
 				m_top + m_margin.Top, 
@@ -596,31 +610,32 @@ void Layout::Render() const
 		float right = m_left + m_width - m_margin.Right;
 		float top = m_top + m_margin.Top;
 		float bottom = m_top + m_height - m_margin.Bottom;
+		ID2D1Brush* borderBrush = m_borderBrush->Get();
 
 		if (m_borderWidths[0] > 0.0f)
 		{
 			// If the offsets are 0, then just draw the complete border
 			if (m_borderTopLeftOffsetY == 0.0f && m_borderBottomLeftOffsetY == 0.0f)
 			{
-				context->DrawLine(
+				drawList.DrawLine(
 					D2D1::Point2F(left, top),		// top-left
 					D2D1::Point2F(left, bottom),	// bottom-left
-					m_borderBrush->Get(),
+					borderBrush,
 					m_borderWidths[0]
 				);
 			}
 			else
 			{
-				context->DrawLine(
+				drawList.DrawLine(
 					D2D1::Point2F(left, top),							// top-left
 					D2D1::Point2F(left, top + m_borderTopLeftOffsetY),	// stop point from the top
-					m_borderBrush->Get(),
+					borderBrush,
 					m_borderWidths[0]
 				);
-				context->DrawLine(
+				drawList.DrawLine(
 					D2D1::Point2F(left, bottom),								// bottom-left
 					D2D1::Point2F(left, bottom - m_borderBottomLeftOffsetY),	// stop point from the bottom
-					m_borderBrush->Get(),
+					borderBrush,
 					m_borderWidths[0]
 				);
 			}
@@ -630,25 +645,25 @@ void Layout::Render() const
 			// If the offsets are 0, then just draw the complete border
 			if (m_borderTopLeftOffsetX == 0.0f && m_borderTopRightOffsetX == 0.0f)
 			{
-				context->DrawLine(
+				drawList.DrawLine(
 					D2D1::Point2F(left, top),	// top-left
 					D2D1::Point2F(right, top),	// top-right
-					m_borderBrush->Get(),
+					borderBrush,
 					m_borderWidths[1]
 				);
 			}
 			else
 			{
-				context->DrawLine(
+				drawList.DrawLine(
 					D2D1::Point2F(left, top),							// top-left
 					D2D1::Point2F(left + m_borderTopLeftOffsetX, top),	// stop point from the left
-					m_borderBrush->Get(),
+					borderBrush,
 					m_borderWidths[1]
 				);
-				context->DrawLine(
+				drawList.DrawLine(
 					D2D1::Point2F(right, top),								// top-right
 					D2D1::Point2F(right - m_borderTopRightOffsetX, top),	// stop point from the right
-					m_borderBrush->Get(),
+					borderBrush,
 					m_borderWidths[1]
 				);
 			}
@@ -658,25 +673,25 @@ void Layout::Render() const
 			// If the offsets are 0, then just draw the complete border
 			if (m_borderTopRightOffsetY == 0.0f && m_borderBottomRightOffsetY == 0.0f)
 			{
-				context->DrawLine(
+				drawList.DrawLine(
 					D2D1::Point2F(right, top),		// top-right
 					D2D1::Point2F(right, bottom),	// bottom-right
-					m_borderBrush->Get(),
+					borderBrush,
 					m_borderWidths[2]
 				);
 			}
 			else
 			{
-				context->DrawLine(
+				drawList.DrawLine(
 					D2D1::Point2F(right, top),								// top-right
 					D2D1::Point2F(right, top + m_borderTopRightOffsetY),	// stop point from the top
-					m_borderBrush->Get(),
+					borderBrush,
 					m_borderWidths[2]
 				);
-				context->DrawLine(
+				drawList.DrawLine(
 					D2D1::Point2F(right, bottom),								// bottom-right
 					D2D1::Point2F(right, bottom - m_borderBottomRightOffsetY),	// stop point from the bottom
-					m_borderBrush->Get(),
+					borderBrush,
 					m_borderWidths[2]
 				);
 			}
@@ -686,25 +701,25 @@ void Layout::Render() const
 			// If the offsets are 0, then just draw the complete border
 			if (m_borderBottomLeftOffsetX == 0.0f && m_borderBottomRightOffsetX == 0.0f)
 			{
-				context->DrawLine(
+				drawList.DrawLine(
 					D2D1::Point2F(left, bottom),	// bottom-left
 					D2D1::Point2F(right, bottom),	// bottom-right
-					m_borderBrush->Get(),
+					borderBrush,
 					m_borderWidths[3]
 				);
 			}
 			else
 			{
-				context->DrawLine(
+				drawList.DrawLine(
 					D2D1::Point2F(left, bottom),								// bottom-left
 					D2D1::Point2F(left + m_borderBottomLeftOffsetX, bottom),	// stop point from the left
-					m_borderBrush->Get(),
+					borderBrush,
 					m_borderWidths[3]
 				);
-				context->DrawLine(
+				drawList.DrawLine(
 					D2D1::Point2F(right, bottom),								// bottom-right
 					D2D1::Point2F(right - m_borderBottomRightOffsetX, bottom),	// stop point from the right
-					m_borderBrush->Get(),
+					borderBrush,
 					m_borderWidths[3]
 				);
 			}
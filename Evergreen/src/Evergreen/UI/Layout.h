@@ -170,6 +170,10 @@ public:
 		// EG_CORE_TRACE("~Layout: {}", m_name);
 	}
 
+	// Layouts are accounted under MemoryCategory::UI_TREE
+	static void* operator new(size_t size);
+	static void operator delete(void* p, size_t size) noexcept;
+
 	Layout* AddSubLayout(RowColumnPosition position, const std::string& name = "Unnamed");
 
 	template<class T>
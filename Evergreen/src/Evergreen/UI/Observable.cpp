@@ -0,0 +1,98 @@
+#include "pch.h"
+#include "Observable.h"
+
+namespace Evergreen
+{
+// Observables that changed since the last PublishChanges(), and the ones currently being published. Both keep their
+// capacity, so publishing doesn't allocate once the UI has warmed up
+static std::vector<ObservableBase*> s_changedObservables;
+static std::vector<ObservableBase*> s_publishingObservables;
+
+ObservableBase::~ObservableBase() noexcept
+{
+	if (m_changeQueued)
+	{
+		// Don't leave a dangling pointer behind in either list
+		for (ObservableBase*& observable : s_changedObservables)
+		{
+			if (observable == this)
+				observable = nullptr;
+		}
+		for (ObservableBase*& observable : s_publishingObservables)
+		{
+			if (observable == this)
+				observable = nullptr;
+		}
+	}
+}
+
+void ObservableBase::MarkChanged()
+{
+	if (m_changeQueued)
+		return;
+
+	m_changeQueued = true;
+	s_changedObservables.push_back(this);
+}
+
+size_t ObservableBase::PublishChanges()
+{
+	if (s_changedObservables.empty())
+		return 0;
+
+	// Swap the lists so that anything set by a subscriber is queued for the next call instead of this one
+	s_publishingObservables.swap(s_changedObservables);
+
+	size_t published = 0;
+	for (size_t iii = 0; iii < s_publishingObservables.size(); ++iii)
+	{
+		ObservableBase* observable = s_publishingObservables[iii];
+		if (observable == nullptr)
+			continue; // Destroyed after it was queued
+
+		observable->m_changeQueued = false;
+		observable->Publish();
+		++published;
+	}
+	s_publishingObservables.clear();
+
+	return published;
+}
+
+void ObservableBase::Detach(ObservableSubscription* subscription) noexcept
+{
+	subscription->m_source = nullptr;
+}
+
+// ObservableSubscription ----------------------------------------------------------------------------------------
+ObservableSubscription::ObservableSubscription(ObservableSubscription&& other) noexcept :
+	m_source(other.m_source)
+{
+	if (m_source != nullptr)
+		m_source->Relocate(&other, this);
+	other.m_source = nullptr;
+}
+
+ObservableSubscription& ObservableSubscription::operator=(ObservableSubscription&& other) noexcept
+{
+	if (this != &other)
+	{
+		Reset();
+		m_source = other.m_source;
+		if (m_source != nullptr)
+			m_source->Relocate(&other, this);
+		other.m_source = nullptr;
+	}
+	return *this;
+}
+
+void ObservableSubscription::Reset() noexcept
+{
+	if (m_source != nullptr)
+	{
+		m_source->Unsubscribe(this);
+		m_source = nullptr;
+	}
+}
+
+}
@@ -0,0 +1,176 @@
+#pragma once
+#include "pch.h"
+#include "Evergreen/Core.h"
+#include "Evergreen/Log.h"
+
+#include <typeindex>
+
+namespace Evergreen
+{
+class ObservableSubscription;
+
+// Non-template part of Observable<T>: batches changes so that subscribers hear about them once per frame.
+//
+// Setting an Observable to a new value only queues it (once, no matter how many times it is set). UI::Update then
+// calls PublishChanges(), which hands each queued Observable's latest value to its subscribers - but only if that
+// value differs from the one they were last given. An Observable that is not set, or is set to the value it already
+// holds, does no work at all.
+//
+// NOTE: Observables (and their subscriptions) may only be used from the UI thread. Background threads should use
+//       UI::PostCoalesced() to set them.
+#pragma warning( push )
+#pragma warning( disable : 4251 ) // needs to have dll-interface to be used by clients of class
+class EVERGREEN_API ObservableBase
+{
+public:
+	ObservableBase(const ObservableBase&) = delete;
+	ObservableBase& operator=(const ObservableBase&) = delete;
+	virtual ~ObservableBase() noexcept;
+
+	// Publishes every Observable that changed since the last call. Changes made by the subscribers themselves are
+	// published on the next call. Returns the number of Observables that were published
+	static size_t PublishChanges();
+
+	template<typename T>
+	ND inline bool HoldsType() const noexcept { return m_valueType == std::type_index(typeid(T)); }
+
+protected:
+	ObservableBase(std::type_index valueType) noexcept : m_valueType(valueType) {}
+
+	void MarkChanged();
+	virtual void Publish() = 0;
+
+	// Called by ObservableSubscription when it is destroyed/moved
+	virtual void Unsubscribe(ObservableSubscription* subscription) noexcept = 0;
+	virtual void Relocate(ObservableSubscription* from, ObservableSubscription* to) noexcept = 0;
+
+	static void Detach(ObservableSubscription* subscription) noexcept;
+
+private:
+	friend class ObservableSubscription;
+
+	std::type_index m_valueType;
+	bool m_changeQueued = false;
+};
+
+// Keeps a subscriber attached to an Observable. Destroying the subscription (ex. when the control that owns it is
+// destroyed) unsubscribes; if the Observable is destroyed first, the subscription just becomes inactive
+class EVERGREEN_API ObservableSubscription
+{
+public:
+	ObservableSubscription() noexcept = default;
+	ObservableSubscription(ObservableSubscription&& other) noexcept;
+	ObservableSubscription& operator=(ObservableSubscription&& other) noexcept;
+	ObservableSubscription(const ObservableSubscription&) = delete;
+	ObservableSubscription& operator=(const ObservableSubscription&) = delete;
+	~ObservableSubscription() noexcept { Reset(); }
+
+	void Reset() noexcept;
+	ND inline bool IsActive() const noexcept { return m_source != nullptr; }
+
+	// Two-way bindings: sets the Observable that we are subscribed to (if it still exists). Because an Observable
+	// ignores the value it already holds, a control writing back the value it was just given does nothing
+	template<typename T>
+	void Write(const T& value);
+
+private:
+	friend class ObservableBase;
+	template<typename T> friend class Observable;
+
+	explicit ObservableSubscription(ObservableBase* source) noexcept : m_source(source) {}
+
+	ObservableBase* m_source = nullptr;
+};
+#pragma warning( pop )
+
+// A value that controls can be bound to, either in code (ex. Text::BindText) or from JSON ("Text": "{bind:key}",
+// once the Observable has been registered with JSONLoaders::AddObservable). T must be copyable and support ==
+template<typename T>
+class Observable : public ObservableBase
+{
+public:
+	Observable(const T& value = T()) : ObservableBase(std::type_index(typeid(T))), m_value(value), m_published(value) {}
+	Observable(const Observable&) = delete;
+	Observable& operator=(const Observable&) = delete;
+	~Observable() noexcept override
+	{
+		for (Subscriber& subscriber : m_subscribers)
+			Detach(subscriber.owner);
+	}
+
+	ND inline const T& Get() const noexcept { return m_value; }
+	void Set(const T& value)
+	{
+		if (value == m_value)
+			return;
+		m_value = value;
+		MarkChanged();
+	}
+
+	// 'fn' is called right away with the current value, and from then on with each published value.
+	// NOTE: Subscribers must not subscribe to the Observable that is calling them
+	ND ObservableSubscription Subscribe(std::function<void(const T&)> fn)
+	{
+		EG_CORE_ASSERT(fn != nullptr, "Subscriber cannot be empty");
+		fn(m_value);
+
+		ObservableSubscription subscription(this);
+		m_subscribers.push_back({ &subscription, std::move(fn) });
+		return subscription;
+	}
+
+	ND inline size_t SubscriberCount() const noexcept { return m_subscribers.size(); }
+
+private:
+	struct Subscriber
+	{
+		ObservableSubscription* owner;
+		std::function<void(const T&)> fn;
+	};
+
+	void Publish() override
+	{
+		// Set back to the value the subscribers already have before it was published
+		if (m_value == m_published)
+			return;
+		m_published = m_value;
+
+		// Index based, so a subscriber that destroys another control's subscription doesn't invalidate the loop
+		for (size_t iii = 0; iii < m_subscribers.size(); ++iii)
+			m_subscribers[iii].fn(m_published);
+	}
+
+	void Unsubscribe(ObservableSubscription* subscription) noexcept override
+	{
+		auto it = std::find_if(m_subscribers.begin(), m_subscribers.end(), [subscription](const Subscriber& s) { return s.owner == subscription; });
+		if (it != m_subscribers.end())
+			m_subscribers.erase(it);
+	}
+	void Relocate(ObservableSubscription* from, ObservableSubscription* to) noexcept override
+	{
+		for (Subscriber& subscriber : m_subscribers)
+		{
+			if (subscriber.owner == from)
+			{
+				subscriber.owner = to;
+				return;
+			}
+		}
+	}
+
+	T m_value;
+	T m_published;
+	std::vector<Subscriber> m_subscribers;
+};
+
+template<typename T>
+void ObservableSubscription::Write(const T& value)
+{
+	if (m_source == nullptr)
+		return;
+
+	EG_CORE_ASSERT(m_source->HoldsType<T>(), "ObservableSubscription::Write called with the wrong type");
+	static_cast<Observable<T>*>(m_source)->Set(value);
+}
+
+}
@@ -39,6 +39,9 @@ public:
 	ND std::unique_ptr<Style> Duplicate() const override;
 
 	ND Microsoft::WRL::ComPtr<IDWriteTextLayout4> CreateTextLayout(std::wstring text, float maxWidth = FLT_MAX, float maxHeight = FLT_MAX);
+	// DirectWrite does not report how much memory a text layout uses, so this is what gets accounted under
+	// MemoryCategory::TEXT_LAYOUTS: a fixed overhead plus a copy of the text and the glyph data for each character
+	ND static constexpr size_t EstimatedTextLayoutSize(size_t textLength) noexcept { return 512 + textLength * 20; }
 
 	inline void SetOnTextFormatChanged(std::function<void()> func) noexcept { m_OnTextFormatChanged = func; }
 
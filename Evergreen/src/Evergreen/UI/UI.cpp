@@ -24,6 +24,7 @@ UI::UI(std::shared_ptr<DeviceResources> deviceResources, std::shared_ptr<Window>
 	m_deviceResources(deviceResources),
 	m_window(window),
 	m_rootLayout(nullptr),
+	m_drawListRenderer(deviceResources),
 	m_mouseHandlingControl(nullptr),
 	m_mouseHandlingLayout(nullptr),
 	m_keyboardHandlingControl(nullptr),
@@ -33,7 +34,14 @@ UI::UI(std::shared_ptr<DeviceResources> deviceResources, std::shared_ptr<Window>
 	m_mouseRButtonDown(false),
 	m_mouseX1ButtonDown(false),
 	m_mouseX2ButtonDown(false),
-	m_mouseIsOverAPane(false)
+	m_mouseIsOverAPane(false),
+	m_profilerOverlay(nullptr),
+	m_profilerOverlayText(nullptr),
+	m_profilerHeatmap(false),
+	m_profilerOverlayNextRefresh(0.0),
+	m_memoryOverlay(nullptr),
+	m_memoryOverlayText(nullptr),
+	m_memoryOverlayNextRefresh(0.0)
 {
 	// Add built-in control loaders
 	JSONLoaders::AddControlLoader("Text", [](std::shared_ptr<DeviceResources> deviceResources, Layout* parentLayout, json& data, const std::string& controlName, std::optional<RowColumnPosition> rowColumnPositionOverride) -> Control* { return TextLoader::Load(deviceResources, parentLayout, data, controlName, rowColumnPositionOverride); });
@@ -898,8 +906,16 @@ void UI::LoadDefaultUI() noexcept
 	Text* vpText = vpLayout->CreateControl<Text>(m_deviceResources, L"Viewport");
 }
 
-void UI::LoadUI(const std::string& fileName) noexcept
+void UI::LoadUI(const std::string& fileName, bool streaming) noexcept
 {
+	// The debug overlays are Panes as well, so take them down with the others and bring them back once the new UI is loaded
+	const bool showProfilerOverlay = m_profilerOverlay != nullptr;
+	if (showProfilerOverlay)
+		RemoveProfilerOverlay();
+	const bool showMemoryOverlay = m_memoryOverlay != nullptr;
+	if (showMemoryOverlay)
+		RemoveDebugOverlay(m_memoryOverlay, m_memoryOverlayText);
+
 	// Clear any panes that were previously created
 	m_panes.clear();
 
@@ -911,13 +927,22 @@ void UI::LoadUI(const std::string& fileName) noexcept
 		nullptr,
 		"Root Layout");
 
-	if (!JSONLoaders::LoadUI(m_deviceResources, m_jsonRootDirectory, fileName, m_rootLayout.get()))
+	const bool loaded = streaming ?
+		JSONLoaders::LoadUIStreaming(m_deviceResources, m_jsonRootDirectory, fileName, m_rootLayout.get()) :
+		JSONLoaders::LoadUI(m_deviceResources, m_jsonRootDirectory, fileName, m_rootLayout.get());
+
+	if (!loaded)
 	{
 		// When loading the UI fails, we must also clean up all panes
 		m_panes.clear();
 
 		LoadErrorUI();
 	}
+
+	if (showProfilerOverlay)
+		CreateProfilerOverlay();
+	if (showMemoryOverlay)
+		ShowMemoryOverlay(true);
 }
 void UI::LoadControlsFromFile(const std::string& fileName, Layout* parentLayout, std::optional<RowColumnPosition> rowColumnPositionOverride)
 {
@@ -975,24 +1000,269 @@ void UI::LoadErrorUI() noexcept
 
 void UI::Update(const Timer& timer)
 {
+	// Tweens run first, so controls see this frame's animated values
+	m_animator.Update(timer);
+
+	// Push the Observables that changed this frame out to the controls bound to them
+	ObservableBase::PublishChanges();
+
 	m_rootLayout->Update(timer);
+
+	if (m_profilerOverlay != nullptr)
+		UpdateProfilerOverlay(timer);
+	if (m_memoryOverlay != nullptr)
+		UpdateMemoryOverlay(timer);
 }
 
-void UI::Render() const
+void UI::RecordDrawList() const
 {
-	m_deviceResources->BeginDraw();
+	m_drawList.Clear();
 
 	m_rootLayout->Render();
 
 	// Iterate of the panes in reverse order so that we render the ones on top last
 	for (auto iter = m_panes.rbegin(); iter != m_panes.rend(); ++iter) 
 	{
-		iter->get()->Render();
+		if (iter->get() == m_profilerOverlay)
+		{
+			// Keep the overlay out of its own results
+			ControlProfiler::Suspend suspend;
+			iter->get()->Render();
+		}
+		else
+		{
+			iter->get()->Render();
+		}
 	}
 
+	ControlProfiler::EndFrame();
+}
+
+void UI::Render() const
+{
+	m_deviceResources->BeginDraw();
+
+	// Record the whole UI first, then replay it in a single pass so that adjacent primitives can be batched
+	RecordDrawList();
+	m_drawListRenderer.Replay(m_drawList);
+
+	// The heatmap changes the opacity of its brush between rectangles, so it is drawn directly rather than recorded
+	if (m_profilerOverlay != nullptr && m_profilerHeatmap)
+		RenderProfilerHeatmap();
+
 	m_deviceResources->EndDraw();
 }
 
+void UI::RenderSoftware(DrawListRasterizer& rasterizer, RasterImage& target) const
+{
+	RecordDrawList();
+	rasterizer.Rasterize(m_drawList, target);
+}
+
+void UI::ShowProfilerOverlay(bool show, bool heatmap) noexcept
+{
+	m_profilerHeatmap = heatmap;
+
+	if (show == (m_profilerOverlay != nullptr))
+		return;
+
+	if (show)
+	{
+		ControlProfiler::Enable(true);
+		CreateProfilerOverlay();
+	}
+	else
+	{
+		RemoveProfilerOverlay();
+		ControlProfiler::Enable(false);
+		m_profilerCosts.clear();
+	}
+}
+Pane* UI::CreateDebugOverlay(const std::string& name, const std::string& title, float top, float left, float height, float width, Text*& text) noexcept
+{
+	std::unique_ptr<Pane> pane = std::make_unique<Pane>(
+		m_deviceResources,
+		this,
+		top,
+		left,
+		height,
+		width,
+		true,	// resizable
+		true,	// relocatable
+		std::make_unique<SolidColorBrush>(m_deviceResources, D2D1::ColorF(0.0f, 0.0f, 0.0f, 0.8f)),
+		std::make_unique<SolidColorBrush>(m_deviceResources, D2D1::ColorF(D2D1::ColorF::Gray)),
+		1.0f,	// border width
+		true,	// include title bar
+		std::make_unique<SolidColorBrush>(m_deviceResources, D2D1::ColorF(0.2f, 0.2f, 0.2f, 1.0f)),
+		20.0f	// title bar height
+	);
+	pane->Name(name);
+	pane->ClearTitleBarLayoutAndAddTitle(title);
+
+	Layout* content = pane->GetContentLayout();
+	content->AddRow({ RowColumnType::STAR, 1.0f });
+	content->AddColumn({ RowColumnType::STAR, 1.0f });
+
+	std::unique_ptr<TextStyle> style = std::make_unique<TextStyle>(
+		m_deviceResources,
+		name + " TextStyle",
+		Evergreen::FontFamily::Consolas,
+		12.0f,
+		DWRITE_FONT_WEIGHT::DWRITE_FONT_WEIGHT_REGULAR,
+		DWRITE_FONT_STYLE::DWRITE_FONT_STYLE_NORMAL,
+		DWRITE_FONT_STRETCH::DWRITE_FONT_STRETCH_NORMAL,
+		DWRITE_TEXT_ALIGNMENT::DWRITE_TEXT_ALIGNMENT_LEADING,
+		DWRITE_PARAGRAPH_ALIGNMENT::DWRITE_PARAGRAPH_ALIGNMENT_NEAR,
+		DWRITE_WORD_WRAPPING::DWRITE_WORD_WRAPPING_NO_WRAP
+	);
+	std::unique_ptr<SolidColorBrush> brush = std::make_unique<SolidColorBrush>(m_deviceResources, D2D1::ColorF(D2D1::ColorF::White));
+	text = content->CreateControl<Text>(m_deviceResources, L"Collecting...", std::move(brush), std::move(style), Evergreen::Margin{ 6.0f, 4.0f, 6.0f, 4.0f });
+
+	return AddPane(std::move(pane), name);
+}
+void UI::RemoveDebugOverlay(Pane*& pane, Text*& text) noexcept
+{
+	EG_CORE_ASSERT(pane != nullptr, "No overlay");
+
+	// Don't leave a dangling pointer behind in the event handling state
+	if (m_mouseHandlingControl == pane || m_keyboardHandlingControl == pane)
+		ClearHandlingControlAndLayout();
+
+	RemovePane(pane);
+	pane = nullptr;
+	text = nullptr;
+}
+
+void UI::CreateProfilerOverlay() noexcept
+{
+	EG_CORE_ASSERT(m_profilerOverlay == nullptr, "Profiler overlay already exists");
+
+	m_profilerOverlay = CreateDebugOverlay("EvergreenProfilerOverlay", "UI Profiler", 10.0f, 10.0f, 320.0f, 460.0f, m_profilerOverlayText);
+	m_profilerHeatmapBrush = std::make_unique<SolidColorBrush>(m_deviceResources, D2D1::ColorF(D2D1::ColorF::Red));
+	m_profilerOverlayNextRefresh = 0.0;
+}
+void UI::RemoveProfilerOverlay() noexcept
+{
+	RemoveDebugOverlay(m_profilerOverlay, m_profilerOverlayText);
+}
+void UI::UpdateProfilerOverlay(const Timer& timer) noexcept
+{
+	EG_CORE_ASSERT(m_profilerOverlayText != nullptr, "No profiler overlay text");
+
+	// Rebuilding the text layout every frame would make the overlay one of the most expensive things on screen
+	if (timer.GetTotalSeconds() < m_profilerOverlayNextRefresh)
+		return;
+	m_profilerOverlayNextRefresh = timer.GetTotalSeconds() + 0.25;
+
+	m_profilerCosts = ControlProfiler::GetCosts();
+
+	if (!ControlProfiler::IsCompiledIn())
+	{
+		m_profilerOverlayText->SetText(L"Evergreen was built without EG_ENABLE_UI_PROFILING");
+		return;
+	}
+
+	std::wstring text = std::format(L"Average ms/frame over {} frames (self time)\n{:<32} {:>8} {:>8} {:>8}\n", ControlProfiler::GetWindowFrames(), L"Control", L"Update", L"Render", L"Peak");
+
+	constexpr size_t maxRows = 15;
+	for (size_t iii = 0; iii < m_profilerCosts.size() && iii < maxRows; ++iii)
+	{
+		const ControlCost& cost = m_profilerCosts[iii];
+		std::string label = cost.name.empty() ? std::format("({})", cost.type) : std::format("{} ({})", cost.name, cost.type);
+		if (label.size() > 32)
+			label = label.substr(0, 29) + "...";
+
+		text += std::format(L"{:<32} {:>8.3f} {:>8.3f} {:>8.3f}\n", std::wstring(label.begin(), label.end()), cost.updateMs, cost.renderMs, cost.peakMs);
+	}
+
+	text += L"\nBy type:\n";
+	for (const ControlCost& cost : ControlProfiler::GetCostsByType())
+	{
+		const std::string label = std::format("{} x{}", cost.type, cost.count);
+		text += std::format(L"{:<32} {:>8.3f} {:>8.3f} {:>8.3f}\n", std::wstring(label.begin(), label.end()), cost.updateMs, cost.renderMs, cost.peakMs);
+	}
+
+	const DrawListStats& drawStats = m_drawListRenderer.GetStats();
+	text += std::format(L"\nDraw list: {} commands, {} draw calls, {} batches ({} commands), {} new geometries\n",
+		drawStats.commands, drawStats.drawCalls, drawStats.batches, drawStats.batchedCommands, drawStats.geometriesCreated);
+
+	m_profilerOverlayText->SetText(text);
+}
+void UI::RenderProfilerHeatmap() const noexcept
+{
+	EG_CORE_ASSERT(m_profilerHeatmapBrush != nullptr, "No heatmap brush");
+
+	if (m_profilerCosts.empty() || m_profilerCosts.front().totalMs <= 0.0)
+		return;
+
+	// Costs are sorted, so the first one is the most expensive. Shade every control relative to it, skipping layouts,
+	// which would just cover everything they contain
+	const double maxMs = m_profilerCosts.front().totalMs;
+	auto context = m_deviceResources->D2DDeviceContext();
+	ID2D1Brush* brush = m_profilerHeatmapBrush->Get();
+
+	for (const ControlCost& cost : m_profilerCosts)
+	{
+		if (cost.type == "Layout" || cost.bounds.right <= cost.bounds.left || cost.bounds.bottom <= cost.bounds.top)
+			continue;
+
+		// Ignore the FLT_MAX regions of controls that have not been laid out
+		if (cost.bounds.right >= FLT_MAX || cost.bounds.bottom >= FLT_MAX)
+			continue;
+
+		const float intensity = static_cast<float>(cost.totalMs / maxMs);
+		if (intensity < 0.02f)
+			continue;
+
+		brush->SetOpacity(0.6f * intensity);
+		context->FillRectangle(cost.bounds, brush);
+	}
+	brush->SetOpacity(1.0f);
+}
+
+void UI::ShowMemoryOverlay(bool show) noexcept
+{
+	if (show == (m_memoryOverlay != nullptr))
+		return;
+
+	if (show)
+	{
+		m_memoryOverlay = CreateDebugOverlay("EvergreenMemoryOverlay", "Memory", 340.0f, 10.0f, 200.0f, 560.0f, m_memoryOverlayText);
+		m_memoryOverlayNextRefresh = 0.0;
+	}
+	else
+	{
+		RemoveDebugOverlay(m_memoryOverlay, m_memoryOverlayText);
+	}
+}
+void UI::UpdateMemoryOverlay(const Timer& timer) noexcept
+{
+	EG_CORE_ASSERT(m_memoryOverlayText != nullptr, "No memory overlay text");
+
+	if (timer.GetTotalSeconds() < m_memoryOverlayNextRefresh)
+		return;
+	m_memoryOverlayNextRefresh = timer.GetTotalSeconds() + 0.25;
+
+	auto kb = [](int64_t bytes) -> double { return bytes / 1024.0; };
+
+	std::wstring text = std::format(L"{:<14} {:>10} {:>10} {:>8} {:>9} {:>9} {:>9}\n", L"KB", L"Live", L"Peak", L"Allocs", L"Allocs/s", L"KB/s", L"Max/frm");
+	for (const MemoryCategoryStats& stats : MemoryAccounting::GetAllStats())
+	{
+		const std::string name = stats.name;
+		text += std::format(L"{:<14} {:>10.1f} {:>10.1f} {:>8} {:>9.0f} {:>9.1f} {:>9}\n",
+			std::wstring(name.begin(), name.end()),
+			kb(stats.liveBytes),
+			kb(stats.peakBytes),
+			stats.liveAllocations,
+			stats.allocationsPerSecond,
+			stats.bytesPerSecond / 1024.0,
+			stats.peakFrameAllocations
+		);
+	}
+
+	m_memoryOverlayText->SetText(text);
+}
+
 Layout* UI::GetLayoutByName(const std::string& name) noexcept
 {
 	Layout* l = nullptr;
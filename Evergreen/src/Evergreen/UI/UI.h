@@ -12,6 +12,12 @@
 #include "JSONLoading/JSONLoaders.h"
 #include "Controls.h"
 #include "Evergreen/Utils/Timer.h"
+#include "Evergreen/Utils/Animator.h"
+#include "DispatchQueue.h"
+#include "Observable.h"
+#include "ControlProfiler.h"
+#include "DrawList.h"
+#include "DrawListRasterizer.h"
 
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
@@ -31,7 +37,9 @@ public:
 	UI& operator=(const UI&) = delete;
 
 	void SetUIRoot(const std::string& directoryPath) noexcept { m_jsonRootDirectory = std::filesystem::path(directoryPath); }
-	void LoadUI(const std::string& fileName) noexcept;
+	// 'streaming' loads the file with JSONLoaders::LoadUIStreaming instead of JSONLoaders::LoadUI (see there for the
+	// requirements it puts on the file)
+	void LoadUI(const std::string& fileName, bool streaming = false) noexcept;
 
 	void LoadControlsFromFile(const std::string& fileName, Layout* parentLayout, std::optional<RowColumnPosition> rowColumnPositionOverride = std::nullopt);
 	void LoadLayoutFromFile(const std::string& fileName, Layout* layoutToFill);
@@ -39,6 +47,27 @@ public:
 	void Update(const Timer& timer);
 	void Render() const;
 
+	// Controls record what they draw into this list during Render (see DrawList). After Render, it holds the frame's
+	// commands until the next call to Render
+	ND inline DrawList& GetDrawList() const noexcept { return m_drawList; }
+	ND inline const DrawListStats& GetDrawListStats() const noexcept { return m_drawListRenderer.GetStats(); }
+	// Records the UI exactly like Render, but rasterizes it on the CPU into 'target' (see DrawListRasterizer) instead of
+	// drawing it with Direct2D. The profiler heatmap is not included
+	void RenderSoftware(DrawListRasterizer& rasterizer, RasterImage& target) const;
+
+	// Controls may only be touched from the UI thread. Other threads can Post() work that needs to update them and
+	// it will run on the UI thread at the start of the next frame. PostCoalesced() only keeps the latest work per key
+	// (ex. progress updates). Both are safe to call from any thread and never block
+	inline void Post(DispatchQueue::WorkFn fn) { m_dispatchQueue.Post(std::move(fn)); }
+	inline void PostCoalesced(std::string_view key, DispatchQueue::WorkFn fn) { m_dispatchQueue.PostCoalesced(key, std::move(fn)); }
+	// Called by the Application once per frame, before Update
+	inline size_t RunPostedWork() { return m_dispatchQueue.Drain(); }
+
+	// Every tween in the application (control hover fades, camera moves, ...) is owned by this Animator and is
+	// evaluated at the start of Update
+	ND inline Animator& GetAnimator() noexcept { return m_animator; }
+	ND inline bool IsAnimating() const noexcept { return m_animator.IsAnimating(); }
+
 	void OnChar(CharEvent& e);
 	void OnKeyPressed(KeyPressedEvent& e);
 	void OnKeyReleased(KeyReleasedEvent& e);
@@ -65,12 +94,33 @@ public:
 	void BringPaneToForeground(const std::string& name) noexcept;
 	void ClearHandlingControlAndLayout() noexcept;
 
+	// Shows a Pane that ranks the most expensive controls (see ControlProfiler) and, optionally, a heatmap of the
+	// per-control cost drawn over the UI. Showing the overlay enables the profiler and hiding it disables the profiler
+	void ShowProfilerOverlay(bool show, bool heatmap = true) noexcept;
+	ND inline bool ProfilerOverlayIsVisible() const noexcept { return m_profilerOverlay != nullptr; }
+
+	// Shows a Pane with the live/peak bytes, allocation rates and worst frame of each MemoryCategory
+	void ShowMemoryOverlay(bool show) noexcept;
+	ND inline bool MemoryOverlayIsVisible() const noexcept { return m_memoryOverlay != nullptr; }
+
 private:
 	void LoadDefaultUI() noexcept;
 	void LoadErrorUI() noexcept;
 	void RemovePaneFromVector(Pane* pane) noexcept;
+	Pane* CreateDebugOverlay(const std::string& name, const std::string& title, float top, float left, float height, float width, Text*& text) noexcept;
+	void RemoveDebugOverlay(Pane*& pane, Text*& text) noexcept;
+	void CreateProfilerOverlay() noexcept;
+	void RemoveProfilerOverlay() noexcept;
+	void UpdateProfilerOverlay(const Timer& timer) noexcept;
+	void RecordDrawList() const;
+	void RenderProfilerHeatmap() const noexcept;
+	void UpdateMemoryOverlay(const Timer& timer) noexcept;
 
 	std::shared_ptr<Window>		m_window;
+
+	// Declared before the controls so that it is still alive when they cancel their tweens during destruction
+	Animator					m_animator;
+
 	std::unique_ptr<Layout>		m_rootLayout;
 
 	std::vector<std::unique_ptr<Pane>> m_panes;
@@ -81,6 +131,12 @@ private:
 
 	std::shared_ptr<DeviceResources> m_deviceResources;
 
+	DispatchQueue m_dispatchQueue;
+
+	// Render() is const, but recording and replaying the frame's draw commands is not
+	mutable DrawList			m_drawList;
+	mutable DrawListRenderer	m_drawListRenderer;
+
 	// Keep track of whether or not the mouse is actively over a Pane
 	bool m_mouseIsOverAPane;
 
@@ -97,6 +153,19 @@ private:
 	bool m_mouseRButtonDown;
 	bool m_mouseX1ButtonDown;
 	bool m_mouseX2ButtonDown;
+
+	// Profiler overlay (see ShowProfilerOverlay)
+	Pane*						m_profilerOverlay;
+	Text*						m_profilerOverlayText;
+	bool						m_profilerHeatmap;
+	double						m_profilerOverlayNextRefresh;
+	std::vector<ControlCost>	m_profilerCosts;
+	std::unique_ptr<SolidColorBrush> m_profilerHeatmapBrush;
+
+	// Memory overlay (see ShowMemoryOverlay)
+	Pane*						m_memoryOverlay;
+	Text*						m_memoryOverlayText;
+	double						m_memoryOverlayNextRefresh;
 };
 #pragma warning( pop )
 
@@ -0,0 +1,230 @@
+#include "pch.h"
+#include "Animator.h"
+
+namespace Evergreen
+{
+float ApplyEasing(Easing easing, float t) noexcept
+{
+	t = std::clamp(t, 0.0f, 1.0f);
+
+	switch (easing)
+	{
+	case Easing::LINEAR:			return t;
+	case Easing::EASE_IN_QUAD:		return t * t;
+	case Easing::EASE_OUT_QUAD:		return t * (2.0f - t);
+	case Easing::EASE_IN_OUT_QUAD:
+	{
+		const float u = -2.0f * t + 2.0f;
+		return t < 0.5f ? 2.0f * t * t : 1.0f - u * u / 2.0f;
+	}
+	case Easing::EASE_IN_CUBIC:		return t * t * t;
+	case Easing::EASE_OUT_CUBIC:
+	{
+		const float u = 1.0f - t;
+		return 1.0f - u * u * u;
+	}
+	case Easing::EASE_IN_OUT_CUBIC:
+	{
+		const float u = -2.0f * t + 2.0f;
+		return t < 0.5f ? 4.0f * t * t * t : 1.0f - u * u * u / 2.0f;
+	}
+	case Easing::EASE_OUT_BACK:
+	{
+		constexpr float c1 = 1.70158f;
+		constexpr float c3 = c1 + 1.0f;
+		const float u = t - 1.0f;
+		return 1.0f + c3 * u * u * u + c1 * u * u;
+	}
+	}
+
+	EG_CORE_ERROR("{}:{} - Unrecognized Easing value: {}", __FILE__, __LINE__, static_cast<int>(easing));
+	return t;
+}
+
+AnimationId Animator::Start(const void* key, float* target, const float* from, const float* to, unsigned int componentCount, double durationSeconds,
+	Easing easing, UpdateFn onUpdate, CompletionFn onComplete)
+{
+	EG_CORE_ASSERT(componentCount > 0 && componentCount <= MaxComponents, "Invalid component count");
+
+	// Copy the values before cancelling the old tween, in case 'from'/'to' point into this Animator's storage
+	Components fromComponents = {};
+	Components toComponents = {};
+	std::copy_n(from, componentCount, fromComponents.begin());
+	std::copy_n(to, componentCount, toComponents.begin());
+
+	if (key != nullptr)
+		CancelTarget(key);
+
+	const AnimationId id = m_nextId++;
+	m_ids.push_back(id);
+	m_keys.push_back(key);
+	m_startTimes.push_back(-1.0);
+	m_durations.push_back(static_cast<float>(std::max(durationSeconds, 0.0)));
+	m_easings.push_back(easing);
+	m_componentCounts.push_back(static_cast<uint8_t>(componentCount));
+	m_from.push_back(fromComponents);
+	m_to.push_back(toComponents);
+	m_targets.push_back(target);
+	m_onUpdate.push_back(std::move(onUpdate));
+	m_onComplete.push_back(std::move(onComplete));
+	m_removed.push_back(0);
+
+	return id;
+}
+
+void Animator::Cancel(AnimationId id) noexcept
+{
+	auto iter = std::find(m_ids.begin(), m_ids.end(), id);
+	if (iter != m_ids.end())
+		Remove(static_cast<size_t>(iter - m_ids.begin()));
+}
+void Animator::CancelTarget(const void* key) noexcept
+{
+	if (key == nullptr)
+		return;
+
+	// Walk backwards, because removing outside of Update moves the last tween into the removed slot
+	for (size_t iii = m_keys.size(); iii > 0; --iii)
+	{
+		if (m_keys[iii - 1] == key)
+			Remove(iii - 1);
+	}
+}
+void Animator::CancelAll() noexcept
+{
+	for (size_t iii = m_ids.size(); iii > 0; --iii)
+		Remove(iii - 1);
+}
+
+bool Animator::IsActive(AnimationId id) const noexcept
+{
+	auto iter = std::find(m_ids.begin(), m_ids.end(), id);
+	return iter != m_ids.end() && m_removed[iter - m_ids.begin()] == 0;
+}
+
+void Animator::Remove(size_t index) noexcept
+{
+	EG_CORE_ASSERT(index < m_ids.size(), "Index out of range");
+
+	if (m_removed[index] != 0)
+		return;
+
+	// While the pass is running, indices must stay stable, so only mark the tween
+	if (m_updating)
+	{
+		m_removed[index] = 1;
+		++m_removedCount;
+		return;
+	}
+
+	auto swapRemove = [index](auto& vec)
+	{
+		if (index != vec.size() - 1)
+			vec[index] = std::move(vec.back());
+		vec.pop_back();
+	};
+
+	swapRemove(m_ids);
+	swapRemove(m_keys);
+	swapRemove(m_startTimes);
+	swapRemove(m_durations);
+	swapRemove(m_easings);
+	swapRemove(m_componentCounts);
+	swapRemove(m_from);
+	swapRemove(m_to);
+	swapRemove(m_targets);
+	swapRemove(m_onUpdate);
+	swapRemove(m_onComplete);
+	swapRemove(m_removed);
+}
+void Animator::RemoveMarked() noexcept
+{
+	EG_CORE_ASSERT(!m_updating, "Cannot remove tweens during the pass");
+
+	for (size_t iii = m_removed.size(); iii > 0 && m_removedCount > 0; --iii)
+	{
+		if (m_removed[iii - 1] != 0)
+		{
+			m_removed[iii - 1] = 0;
+			--m_removedCount;
+			Remove(iii - 1);
+		}
+	}
+
+	EG_CORE_ASSERT(m_removedCount == 0, "Removed count is out of sync");
+}
+
+void Animator::Update(const Timer& timer)
+{
+	if (m_ids.empty())
+		return;
+
+	const double now = timer.GetTotalSeconds();
+
+	// Tweens started from here on (ex. by an update callback) are not evaluated until the next frame
+	const size_t count = m_ids.size();
+	m_updating = true;
+
+	// Pass 1: linear progress of every tween
+	m_progress.resize(count);
+	for (size_t iii = 0; iii < count; ++iii)
+	{
+		if (m_startTimes[iii] < 0.0)
+			m_startTimes[iii] = now;
+
+		// A zero duration finishes on the first Update
+		m_progress[iii] = m_durations[iii] > 0.0f ? std::min(static_cast<float>(now - m_startTimes[iii]) / m_durations[iii], 1.0f) : 1.0f;
+	}
+
+	// Pass 2: ease, interpolate and write each value out
+	for (size_t iii = 0; iii < count; ++iii)
+	{
+		// Cancelled by a callback earlier in this pass
+		if (m_removed[iii] != 0)
+			continue;
+
+		const bool finished = m_progress[iii] >= 1.0f;
+		const float eased = finished ? 1.0f : ApplyEasing(m_easings[iii], m_progress[iii]);
+		const unsigned int components = m_componentCounts[iii];
+		const Components& from = m_from[iii];
+		const Components& to = m_to[iii];
+
+		Components value;
+		for (unsigned int c = 0; c < components; ++c)
+			value[c] = finished ? to[c] : from[c] + (to[c] - from[c]) * eased;
+
+		if (m_targets[iii] != nullptr)
+		{
+			std::copy_n(value.begin(), components, m_targets[iii]);
+		}
+		else
+		{
+			// The callback may start new tweens, which can reallocate m_onUpdate, so call it from a local
+			UpdateFn onUpdate = std::move(m_onUpdate[iii]);
+			onUpdate(value.data());
+			m_onUpdate[iii] = std::move(onUpdate);
+		}
+
+		if (finished && m_removed[iii] == 0)
+		{
+			if (m_onComplete[iii] != nullptr)
+				m_completed.push_back(std::move(m_onComplete[iii]));
+			m_removed[iii] = 1;
+			++m_removedCount;
+		}
+	}
+
+	m_updating = false;
+	RemoveMarked();
+
+	// Completion callbacks run last, so they see every tween's final value and are free to start new tweens
+	if (!m_completed.empty())
+	{
+		std::vector<CompletionFn> completed;
+		completed.swap(m_completed);
+		for (CompletionFn& onComplete : completed)
+			onComplete();
+	}
+}
+
+}
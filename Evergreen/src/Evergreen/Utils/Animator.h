@@ -0,0 +1,131 @@
+#pragma once
+#include "pch.h"
+#include "Evergreen/Core.h"
+#include "Timer.h"
+
+// Central owner of every running tween. A tween moves a float, D2D1_COLOR_F, D2D1_RECT_F or DirectX::XMFLOAT3 from its
+// current value to a target value over a fixed duration. All tweens are stored as structure-of-arrays and evaluated
+// together in a single pass per frame (Animator::Update), instead of each control/camera keeping its own start time,
+// duration and "am I moving" flag.
+//
+// There are two kinds of tweens:
+//		Target tweens	- Animate(value, to, ...) writes directly into 'value' each frame. 'value' must outlive the
+//						  tween (or the tween must be cancelled with CancelTarget(&value) first)
+//		Setter tweens	- Animate(key, from, to, ..., setter) passes each intermediate value to 'setter' instead (ex.
+//						  SolidColorBrush::Color). 'key' is only used to identify the tween, so that starting a new
+//						  tween for the same key replaces the old one and CancelTarget(key) can stop it. A nullptr
+//						  key never replaces anything
+//
+// On the frame a tween finishes, the final value is written/passed to the setter exactly, then its completion callback
+// is called. Completion callbacks run after the whole pass, so they may start new tweens (ex. to chain animations).
+//
+// The Animator is not thread safe - it is owned by the UI (see UI::GetAnimator) and must only be used from the UI thread.
+namespace Evergreen
+{
+enum class Easing
+{
+	LINEAR,
+	EASE_IN_QUAD,
+	EASE_OUT_QUAD,
+	EASE_IN_OUT_QUAD,
+	EASE_IN_CUBIC,
+	EASE_OUT_CUBIC,
+	EASE_IN_OUT_CUBIC,
+	EASE_OUT_BACK		// Overshoots the target slightly, then settles on it
+};
+
+// Maps t in [0, 1] to eased progress. Every easing returns exactly 0 at t = 0 and 1 at t = 1
+ND EVERGREEN_API float ApplyEasing(Easing easing, float t) noexcept;
+
+using AnimationId = uint64_t;
+static constexpr AnimationId INVALID_ANIMATION_ID = 0;
+
+template<typename T>
+concept Animatable = std::is_same_v<T, float> || std::is_same_v<T, D2D1_COLOR_F> || std::is_same_v<T, D2D1_RECT_F> || std::is_same_v<T, DirectX::XMFLOAT3>;
+
+// Drop this warning because the private members are not accessible by the client application, but
+// the compiler will complain that they don't have a DLL interface
+// See: https://stackoverflow.com/questions/767579/exporting-classes-containing-std-objects-vector-map-etc-from-a-dll
+#pragma warning( push )
+#pragma warning( disable : 4251 ) // needs to have dll-interface to be used by clients of class
+class EVERGREEN_API Animator
+{
+public:
+	using CompletionFn = std::function<void()>;
+
+	Animator() noexcept = default;
+	Animator(const Animator&) = delete;
+	Animator& operator=(const Animator&) = delete;
+
+	// Tweens 'value' from its current value to 'to'. Replaces any tween already running on 'value'
+	template<typename T>
+	AnimationId Animate(T& value, const T& to, double durationSeconds, Easing easing = Easing::EASE_IN_OUT_QUAD, CompletionFn onComplete = nullptr) requires Animatable<T>
+	{
+		return Start(&value, reinterpret_cast<float*>(&value), reinterpret_cast<const float*>(&value), reinterpret_cast<const float*>(&to),
+			ComponentCount<T>(), durationSeconds, easing, nullptr, std::move(onComplete));
+	}
+
+	// Tweens from 'from' to 'to', passing each intermediate value to 'setter'. Replaces any tween already running for 'key'.
+	// (The setter is a non-deduced parameter so that a lambda can be passed directly)
+	template<typename T>
+	AnimationId Animate(const void* key, const T& from, const T& to, double durationSeconds, std::type_identity_t<std::function<void(const T&)>> setter, Easing easing = Easing::EASE_IN_OUT_QUAD, CompletionFn onComplete = nullptr) requires Animatable<T>
+	{
+		EG_CORE_ASSERT(setter != nullptr, "Setter tween requires a setter");
+		return Start(key, nullptr, reinterpret_cast<const float*>(&from), reinterpret_cast<const float*>(&to), ComponentCount<T>(), durationSeconds, easing,
+			[setter = std::move(setter)](const float* components) { setter(*reinterpret_cast<const T*>(components)); }, std::move(onComplete));
+	}
+
+	// Stops the tween where it is. Its completion callback is not called
+	void Cancel(AnimationId id) noexcept;
+	void CancelTarget(const void* key) noexcept;
+	void CancelAll() noexcept;
+
+	// Evaluates every tween. Called by the UI once per frame, before the controls are updated
+	void Update(const Timer& timer);
+
+	ND inline bool IsAnimating() const noexcept { return m_ids.size() > m_removedCount; }
+	ND bool IsActive(AnimationId id) const noexcept;
+	ND inline size_t ActiveCount() const noexcept { return m_ids.size() - m_removedCount; }
+
+private:
+	static constexpr unsigned int MaxComponents = 4;
+	using Components = std::array<float, MaxComponents>;
+	using UpdateFn = std::function<void(const float*)>;
+
+	template<typename T>
+	static constexpr unsigned int ComponentCount() noexcept
+	{
+		static_assert(sizeof(T) % sizeof(float) == 0 && sizeof(T) / sizeof(float) <= MaxComponents);
+		return sizeof(T) / sizeof(float);
+	}
+
+	AnimationId Start(const void* key, float* target, const float* from, const float* to, unsigned int componentCount, double durationSeconds,
+		Easing easing, UpdateFn onUpdate, CompletionFn onComplete);
+	void Remove(size_t index) noexcept;
+	void RemoveMarked() noexcept;
+
+	// One entry per tween. A negative start time means the tween starts on the next Update
+	std::vector<AnimationId>	m_ids;
+	std::vector<const void*>	m_keys;
+	std::vector<double>			m_startTimes;
+	std::vector<float>			m_durations;
+	std::vector<Easing>			m_easings;
+	std::vector<uint8_t>		m_componentCounts;
+	std::vector<Components>		m_from;
+	std::vector<Components>		m_to;
+	std::vector<float*>			m_targets;		// nullptr for setter tweens
+	std::vector<UpdateFn>		m_onUpdate;
+	std::vector<CompletionFn>	m_onComplete;
+	std::vector<uint8_t>		m_removed;		// Finished/cancelled during Update, erased at the end of the pass
+
+	// Scratch storage for the pass
+	std::vector<float>			m_progress;
+	std::vector<CompletionFn>	m_completed;
+
+	AnimationId	m_nextId = 1;
+	size_t		m_removedCount = 0;
+	bool		m_updating = false;
+};
+#pragma warning( pop )
+
+}
@@ -0,0 +1,422 @@
+#include "pch.h"
+#include "InputRecording.h"
+#include "Evergreen/Log.h"
+
+#include <thread>
+
+namespace Evergreen
+{
+static constexpr char LogMagic[4] = { 'E', 'G', 'I', 'R' };
+static constexpr uint16_t LogVersion = 1;
+
+// Timer ticks are 100ns
+static uint64_t TicksSince(std::chrono::steady_clock::time_point start) noexcept
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / 100);
+}
+
+// InputRecorder ===================================================================================================
+bool InputRecorder::Start(const std::filesystem::path& file) noexcept
+{
+	Stop();
+
+	m_file.open(file, std::ios::binary | std::ios::trunc);
+	if (!m_file.is_open())
+	{
+		EG_CORE_ERROR("{}:{} - Failed to open input recording file '{}'", __FILE__, __LINE__, file.string());
+		return false;
+	}
+
+	m_buffer.clear();
+	m_buffer.insert(m_buffer.end(), std::begin(LogMagic), std::end(LogMagic));
+	Write(LogVersion);
+
+	m_start = std::chrono::steady_clock::now();
+	m_lastTimestamp = 0;
+
+	EG_CORE_INFO("{}:{} - Recording input to '{}'", __FILE__, __LINE__, file.string());
+	return true;
+}
+void InputRecorder::Stop() noexcept
+{
+	if (!m_file.is_open())
+		return;
+
+	Flush();
+	m_file.close();
+}
+void InputRecorder::Flush() noexcept
+{
+	m_file.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+	m_buffer.clear();
+
+	if (!m_file.good())
+	{
+		EG_CORE_ERROR("{}:{} - Failed to write input recording. Recording stopped", __FILE__, __LINE__);
+		m_file.close();
+	}
+}
+
+bool InputRecorder::BeginRecord(RecordedInputType type) noexcept
+{
+	if (!m_file.is_open())
+		return false;
+
+	// Write in chunks rather than per event so that recording doesn't add file IO to every mouse move
+	if (m_buffer.size() >= 64 * 1024)
+	{
+		Flush();
+		if (!m_file.is_open())
+			return false;
+	}
+
+	// steady_clock is monotonic, but make sure a delta can never be negative
+	const uint64_t timestamp = std::max(TicksSince(m_start), m_lastTimestamp);
+
+	m_buffer.push_back(static_cast<uint8_t>(type));
+	WriteVarint(timestamp - m_lastTimestamp);
+	m_lastTimestamp = timestamp;
+	return true;
+}
+void InputRecorder::WriteVarint(uint64_t value) noexcept
+{
+	while (value >= 0x80)
+	{
+		m_buffer.push_back(static_cast<uint8_t>(value) | 0x80);
+		value >>= 7;
+	}
+	m_buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void InputRecorder::RecordFrame() noexcept
+{
+	BeginRecord(RecordedInputType::FRAME);
+}
+void InputRecorder::Record(const WindowResizeEvent& e) noexcept
+{
+	if (!BeginRecord(RecordedInputType::WINDOW_RESIZE))
+		return;
+	WriteVarint(e.GetWidth());
+	WriteVarint(e.GetHeight());
+}
+void InputRecorder::Record(const CharEvent& e) noexcept
+{
+	if (!BeginRecord(RecordedInputType::CHAR))
+		return;
+	Write(e.GetKeyCode());
+	WriteVarint(static_cast<uint64_t>(e.GetRepeatCount()));
+}
+void InputRecorder::Record(const KeyPressedEvent& e) noexcept
+{
+	if (!BeginRecord(RecordedInputType::KEY_PRESSED))
+		return;
+	WriteVarint(static_cast<uint64_t>(e.GetKeyCode()));
+	WriteVarint(static_cast<uint64_t>(e.GetRepeatCount()));
+	Write(static_cast<uint8_t>(e.KeyWasPreviouslyDown()));
+}
+void InputRecorder::Record(const KeyReleasedEvent& e) noexcept
+{
+	if (!BeginRecord(RecordedInputType::KEY_RELEASED))
+		return;
+	WriteVarint(static_cast<uint64_t>(e.GetKeyCode()));
+}
+void InputRecorder::Record(const MouseMoveEvent& e) noexcept
+{
+	if (!BeginRecord(RecordedInputType::MOUSE_MOVE))
+		return;
+	Write(e.GetX());
+	Write(e.GetY());
+}
+void InputRecorder::Record(const MouseEnterEvent&) noexcept
+{
+	BeginRecord(RecordedInputType::MOUSE_ENTER);
+}
+void InputRecorder::Record(const MouseLeaveEvent&) noexcept
+{
+	BeginRecord(RecordedInputType::MOUSE_LEAVE);
+}
+void InputRecorder::RecordScrolledVertical(const MouseScrolledEvent& e) noexcept
+{
+	if (!BeginRecord(RecordedInputType::MOUSE_SCROLLED_VERTICAL))
+		return;
+	Write(e.GetX());
+	Write(e.GetY());
+	WriteSigned(e.GetScrollDelta());
+}
+void InputRecorder::RecordScrolledHorizontal(const MouseScrolledEvent& e) noexcept
+{
+	if (!BeginRecord(RecordedInputType::MOUSE_SCROLLED_HORIZONTAL))
+		return;
+	Write(e.GetX());
+	Write(e.GetY());
+	WriteSigned(e.GetScrollDelta());
+}
+void InputRecorder::Record(const MouseButtonPressedEvent& e) noexcept
+{
+	if (!BeginRecord(RecordedInputType::MOUSE_BUTTON_PRESSED))
+		return;
+	Write(static_cast<uint8_t>(e.GetMouseButton()));
+	Write(e.GetX());
+	Write(e.GetY());
+}
+void InputRecorder::Record(const MouseButtonReleasedEvent& e) noexcept
+{
+	if (!BeginRecord(RecordedInputType::MOUSE_BUTTON_RELEASED))
+		return;
+	Write(static_cast<uint8_t>(e.GetMouseButton()));
+	Write(e.GetX());
+	Write(e.GetY());
+}
+void InputRecorder::Record(const MouseButtonDoubleClickEvent& e) noexcept
+{
+	if (!BeginRecord(RecordedInputType::MOUSE_BUTTON_DOUBLE_CLICK))
+		return;
+	Write(static_cast<uint8_t>(e.GetMouseButton()));
+	Write(e.GetX());
+	Write(e.GetY());
+}
+
+// InputReplay =====================================================================================================
+bool InputReplay::Start(const std::filesystem::path& file, Timing timing) noexcept
+{
+	Stop();
+
+	std::ifstream stream(file, std::ios::binary);
+	if (!stream.is_open())
+	{
+		EG_CORE_ERROR("{}:{} - Failed to open input recording file '{}'", __FILE__, __LINE__, file.string());
+		return false;
+	}
+
+	std::vector<uint8_t> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+	m_records.clear();
+	if (!Decode(data, m_records))
+	{
+		EG_CORE_ERROR("{}:{} - '{}' is not a valid input recording", __FILE__, __LINE__, file.string());
+		m_records.clear();
+		return false;
+	}
+
+	m_next = 0;
+	m_timing = timing;
+	m_replaying = true;
+	m_lastFrameTimestamp = 0;
+	m_frameTimesMs.clear();
+	m_eventCount = 0;
+	m_start = std::chrono::steady_clock::now();
+	m_frameStart = m_start;
+	m_end = m_start;
+
+	EG_CORE_INFO("{}:{} - Replaying input from '{}' ({} records)", __FILE__, __LINE__, file.string(), m_records.size());
+	return true;
+}
+void InputReplay::Stop() noexcept
+{
+	if (!m_replaying)
+		return;
+
+	m_replaying = false;
+	m_end = std::chrono::steady_clock::now();
+}
+
+bool InputReplay::NextFrame(std::span<const RecordedInput>& input, uint64_t& elapsedTicks) noexcept
+{
+	if (!m_replaying)
+		return false;
+
+	// Find the end of the frame. Input recorded after the last frame marker belongs to a frame that never ran
+	size_t frameEnd = m_next;
+	while (frameEnd < m_records.size() && m_records[frameEnd].type != RecordedInputType::FRAME)
+		++frameEnd;
+
+	if (frameEnd == m_records.size())
+	{
+		Stop();
+		return false;
+	}
+
+	const uint64_t frameTimestamp = m_records[frameEnd].timestamp;
+
+	if (m_timing == Timing::RECORDED)
+	{
+		const auto due = m_start + std::chrono::nanoseconds(frameTimestamp * 100);
+		std::this_thread::sleep_until(due);
+	}
+
+	m_frameStart = std::chrono::steady_clock::now();
+
+	input = std::span<const RecordedInput>(m_records.data() + m_next, frameEnd - m_next);
+	elapsedTicks = frameTimestamp - m_lastFrameTimestamp;
+
+	m_eventCount += input.size();
+	m_lastFrameTimestamp = frameTimestamp;
+	m_next = frameEnd + 1;
+	return true;
+}
+void InputReplay::FrameFinished() noexcept
+{
+	m_frameTimesMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_frameStart).count());
+}
+
+ReplayStats InputReplay::GetStats() const noexcept
+{
+	ReplayStats stats;
+	stats.frameCount = static_cast<uint32_t>(m_frameTimesMs.size());
+	stats.eventCount = m_eventCount;
+	stats.totalSeconds = std::chrono::duration<double>((m_replaying ? std::chrono::steady_clock::now() : m_end) - m_start).count();
+
+	if (m_frameTimesMs.empty())
+		return stats;
+
+	std::vector<double> sorted = m_frameTimesMs;
+	std::sort(sorted.begin(), sorted.end());
+
+	auto percentile = [&sorted](double p) { return sorted[static_cast<size_t>(p * (sorted.size() - 1) + 0.5)]; };
+
+	double sum = 0.0;
+	for (double ms : sorted)
+		sum += ms;
+
+	stats.meanMs = sum / sorted.size();
+	stats.minMs = sorted.front();
+	stats.medianMs = percentile(0.5);
+	stats.p95Ms = percentile(0.95);
+	stats.p99Ms = percentile(0.99);
+	stats.maxMs = sorted.back();
+	return stats;
+}
+
+bool InputReplay::Decode(std::span<const uint8_t> data, std::vector<RecordedInput>& records) noexcept
+{
+	size_t pos = 0;
+
+	auto readBytes = [&](void* dest, size_t count) -> bool
+	{
+		if (data.size() - pos < count)
+			return false;
+		std::memcpy(dest, data.data() + pos, count);
+		pos += count;
+		return true;
+	};
+	auto readVarint = [&](uint64_t& value) -> bool
+	{
+		value = 0;
+		for (unsigned int shift = 0; shift < 64; shift += 7)
+		{
+			if (pos == data.size())
+				return false;
+			const uint8_t byte = data[pos++];
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+				return true;
+		}
+		return false;
+	};
+	auto readInt = [&](int32_t& value) -> bool
+	{
+		uint64_t v;
+		if (!readVarint(v))
+			return false;
+		value = static_cast<int32_t>(v);
+		return true;
+	};
+	auto readSigned = [&](int32_t& value) -> bool
+	{
+		uint64_t v;
+		if (!readVarint(v))
+			return false;
+		value = static_cast<int32_t>(static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1));
+		return true;
+	};
+	auto readPosition = [&](RecordedInput& r) -> bool
+	{
+		return readBytes(&r.x, sizeof(float)) && readBytes(&r.y, sizeof(float));
+	};
+
+	char magic[4];
+	uint16_t version;
+	if (!readBytes(magic, sizeof(magic)) || !std::equal(std::begin(magic), std::end(magic), std::begin(LogMagic)))
+		return false;
+	if (!readBytes(&version, sizeof(version)) || version != LogVersion)
+		return false;
+
+	uint64_t timestamp = 0;
+	while (pos < data.size())
+	{
+		RecordedInput r;
+		uint8_t type;
+		uint64_t delta;
+		if (!readBytes(&type, 1) || type >= static_cast<uint8_t>(RecordedInputType::COUNT) || !readVarint(delta))
+			return false;
+
+		timestamp += delta;
+		r.type = static_cast<RecordedInputType>(type);
+		r.timestamp = timestamp;
+
+		bool ok = true;
+		switch (r.type)
+		{
+		case RecordedInputType::FRAME:
+		case RecordedInputType::MOUSE_ENTER:
+		case RecordedInputType::MOUSE_LEAVE:
+			break;
+
+		case RecordedInputType::WINDOW_RESIZE:
+			ok = readInt(r.value) && readInt(r.value2);
+			break;
+
+		case RecordedInputType::CHAR:
+		{
+			char c;
+			ok = readBytes(&c, 1) && readInt(r.value2);
+			r.value = c;
+			break;
+		}
+
+		case RecordedInputType::KEY_PRESSED:
+		{
+			uint8_t previouslyDown = 0;
+			ok = readInt(r.value) && readInt(r.value2) && readBytes(&previouslyDown, 1);
+			r.flag = previouslyDown != 0;
+			break;
+		}
+
+		case RecordedInputType::KEY_RELEASED:
+			ok = readInt(r.value);
+			break;
+
+		case RecordedInputType::MOUSE_MOVE:
+			ok = readPosition(r);
+			break;
+
+		case RecordedInputType::MOUSE_SCROLLED_VERTICAL:
+		case RecordedInputType::MOUSE_SCROLLED_HORIZONTAL:
+			ok = readPosition(r) && readSigned(r.value);
+			break;
+
+		case RecordedInputType::MOUSE_BUTTON_PRESSED:
+		case RecordedInputType::MOUSE_BUTTON_RELEASED:
+		case RecordedInputType::MOUSE_BUTTON_DOUBLE_CLICK:
+		{
+			uint8_t button = 0;
+			ok = readBytes(&button, 1) && readPosition(r);
+			r.value = button;
+			break;
+		}
+
+		default:
+			ok = false;
+			break;
+		}
+
+		if (!ok)
+			return false;
+
+		records.push_back(r);
+	}
+
+	return true;
+}
+
+}
@@ -0,0 +1,170 @@
+#pragma once
+#include "pch.h"
+#include "Evergreen/Core.h"
+#include "Evergreen/Events/MouseEvent.h"
+#include "Evergreen/Events/KeyEvent.h"
+#include "Evergreen/Events/ApplicationEvent.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <span>
+
+// Input recording and replay, used to make interaction heavy performance problems (dragging, scrolling, typing into
+// large documents, ...) reproducible. Application records every input event it receives from the Window, along with
+// the boundaries between frames, and can later feed the log back through the same handlers - and therefore through
+// UI::On* - while the Timer runs on virtual time, so every replay performs the same sequence of Update() calls.
+//
+// Log format (little endian). All timestamps are Timer ticks since the recording started, stored as the difference to
+// the previous record's timestamp in a LEB128 varint, so a mouse move costs 1 + 2-3 + 8 bytes:
+//
+//		header:		"EGIR" | uint16 version
+//		record:		uint8 type | varint delta | payload (depends on type, see InputRecorder::Record)
+//
+// NOTE: Only the events that go through Application are recorded. Code that polls the keyboard or clipboard directly
+//       (for example, TextInput checking whether SHIFT is held) sees the live state during a replay.
+
+namespace Evergreen
+{
+enum class RecordedInputType : uint8_t
+{
+	FRAME,
+	WINDOW_RESIZE,
+	CHAR,
+	KEY_PRESSED,
+	KEY_RELEASED,
+	MOUSE_MOVE,
+	MOUSE_ENTER,
+	MOUSE_LEAVE,
+	MOUSE_SCROLLED_VERTICAL,
+	MOUSE_SCROLLED_HORIZONTAL,
+	MOUSE_BUTTON_PRESSED,
+	MOUSE_BUTTON_RELEASED,
+	MOUSE_BUTTON_DOUBLE_CLICK,
+	COUNT
+};
+
+// A decoded record. Which fields are meaningful depends on the type
+struct RecordedInput
+{
+	RecordedInputType type = RecordedInputType::FRAME;
+	uint64_t timestamp = 0;		// Ticks (see Timer) since the recording started
+	float x = 0.0f;				// Mouse position
+	float y = 0.0f;
+	int32_t value = 0;			// Key code, character, mouse button, scroll delta or width
+	int32_t value2 = 0;			// Repeat count or height
+	bool flag = false;			// Key was previously down
+};
+
+// Per-frame timing of a replay. Frame time is measured from the start of a frame's input to the end of Present, so it
+// includes waiting for vsync if the swap chain presents with it
+struct ReplayStats
+{
+	uint32_t frameCount = 0;
+	size_t eventCount = 0;
+	double totalSeconds = 0.0;	// Wall clock time of the whole replay
+	double meanMs = 0.0;
+	double minMs = 0.0;
+	double medianMs = 0.0;
+	double p95Ms = 0.0;
+	double p99Ms = 0.0;
+	double maxMs = 0.0;
+};
+
+// Drop this warning because the private members are not accessible by the client application, but
+// the compiler will complain that they don't have a DLL interface
+// See: https://stackoverflow.com/questions/767579/exporting-classes-containing-std-objects-vector-map-etc-from-a-dll
+#pragma warning( push )
+#pragma warning( disable : 4251 ) // needs to have dll-interface to be used by clients of class
+class EVERGREEN_API InputRecorder
+{
+public:
+	InputRecorder() noexcept = default;
+	InputRecorder(const InputRecorder&) = delete;
+	InputRecorder& operator=(const InputRecorder&) = delete;
+	~InputRecorder() noexcept { Stop(); }
+
+	bool Start(const std::filesystem::path& file) noexcept;
+	void Stop() noexcept;
+	ND inline bool IsRecording() const noexcept { return m_file.is_open(); }
+
+	// Marks the end of the input for the current frame
+	void RecordFrame() noexcept;
+
+	void Record(const WindowResizeEvent& e) noexcept;
+	void Record(const CharEvent& e) noexcept;
+	void Record(const KeyPressedEvent& e) noexcept;
+	void Record(const KeyReleasedEvent& e) noexcept;
+	void Record(const MouseMoveEvent& e) noexcept;
+	void Record(const MouseEnterEvent& e) noexcept;
+	void Record(const MouseLeaveEvent& e) noexcept;
+	void RecordScrolledVertical(const MouseScrolledEvent& e) noexcept;
+	void RecordScrolledHorizontal(const MouseScrolledEvent& e) noexcept;
+	void Record(const MouseButtonPressedEvent& e) noexcept;
+	void Record(const MouseButtonReleasedEvent& e) noexcept;
+	void Record(const MouseButtonDoubleClickEvent& e) noexcept;
+
+private:
+	bool BeginRecord(RecordedInputType type) noexcept;
+	void WriteVarint(uint64_t value) noexcept;
+	void WriteSigned(int64_t value) noexcept { WriteVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63)); }
+	template<typename T>
+	void Write(T value) noexcept
+	{
+		const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+		m_buffer.insert(m_buffer.end(), bytes, bytes + sizeof(T));
+	}
+	void Flush() noexcept;
+
+	std::ofstream m_file;
+	std::vector<uint8_t> m_buffer;
+	std::chrono::steady_clock::time_point m_start;
+	uint64_t m_lastTimestamp = 0;
+};
+
+class EVERGREEN_API InputReplay
+{
+public:
+	enum class Timing
+	{
+		RECORDED,			// Each frame starts no earlier than it did in the recording
+		AS_FAST_AS_POSSIBLE	// Frames run back to back (the Timer still sees the recorded frame deltas)
+	};
+
+	InputReplay() noexcept = default;
+	InputReplay(const InputReplay&) = delete;
+	InputReplay& operator=(const InputReplay&) = delete;
+	~InputReplay() noexcept = default;
+
+	bool Start(const std::filesystem::path& file, Timing timing) noexcept;
+	void Stop() noexcept;
+	ND inline bool IsReplaying() const noexcept { return m_replaying; }
+
+	// Gets the input for the next frame, and the time that passed between the previous frame and this one in the
+	// recording. In RECORDED timing, this first sleeps until the frame is due. Once the log is exhausted, this stops
+	// the replay and returns false
+	ND bool NextFrame(std::span<const RecordedInput>& input, uint64_t& elapsedTicks) noexcept;
+
+	// Call once the frame returned by NextFrame() has been presented
+	void FrameFinished() noexcept;
+
+	ND ReplayStats GetStats() const noexcept;
+
+	ND static bool Decode(std::span<const uint8_t> data, std::vector<RecordedInput>& records) noexcept;
+
+private:
+	std::vector<RecordedInput> m_records;
+	size_t m_next = 0;
+	Timing m_timing = Timing::AS_FAST_AS_POSSIBLE;
+	bool m_replaying = false;
+
+	uint64_t m_lastFrameTimestamp = 0;
+	std::chrono::steady_clock::time_point m_start;
+	std::chrono::steady_clock::time_point m_frameStart;
+	std::chrono::steady_clock::time_point m_end;
+	std::vector<double> m_frameTimesMs;
+	size_t m_eventCount = 0;
+};
+#pragma warning( pop )
+
+}
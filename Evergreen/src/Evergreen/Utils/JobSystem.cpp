@@ -0,0 +1,324 @@
+#include "pch.h"
+#include "JobSystem.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+	#include <immintrin.h>
+	#define EG_JOB_SYSTEM_PAUSE() _mm_pause()
+#else
+	#define EG_JOB_SYSTEM_PAUSE() std::this_thread::yield()
+#endif
+
+namespace Evergreen
+{
+// Spins (pausing between attempts) before an idle worker goes to sleep. Long enough that a worker between two
+// bursts of jobs in the same frame stays awake, short enough that idle workers don't burn a core
+static constexpr unsigned int IdleSpinCount = 2048;
+
+// The JobSystem (if any) that the current thread is a worker of, and its index in that JobSystem
+static thread_local JobSystem* t_jobSystem = nullptr;
+static thread_local unsigned int t_workerIndex = 0;
+
+// WorkStealingDeque ---------------------------------------------------------------------------------------------
+// See: Le, Pop, Cohen, Zappa Nardelli - "Correct and Efficient Work-Stealing for Weak Memory Models" (2013)
+bool JobSystem::WorkStealingDeque::Push(Job* job) noexcept
+{
+	const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+	const int64_t top = m_top.load(std::memory_order_acquire);
+	if (bottom - top >= Capacity)
+		return false;
+
+	// Release, so a thief that sees the new bottom also sees the job (and everything written to it)
+	m_buffer[bottom & (Capacity - 1)].store(job, std::memory_order_relaxed);
+	m_bottom.store(bottom + 1, std::memory_order_release);
+	return true;
+}
+
+JobSystem::Job* JobSystem::WorkStealingDeque::Pop() noexcept
+{
+	const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+	m_bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = m_top.load(std::memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		// Empty
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job* job = m_buffer[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+	if (top == bottom)
+	{
+		// Last job - race any thieves for it
+		if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			job = nullptr;
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+JobSystem::Job* JobSystem::WorkStealingDeque::Steal() noexcept
+{
+	int64_t top = m_top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+	if (top >= bottom)
+		return nullptr;
+
+	Job* job = m_buffer[top & (Capacity - 1)].load(std::memory_order_relaxed);
+	if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return nullptr; // Lost the race to the owner or another thief
+	return job;
+}
+
+// JobSystem -----------------------------------------------------------------------------------------------------
+unsigned int JobSystem::DefaultWorkerThreadCount() noexcept
+{
+	const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+	return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+JobSystem::JobSystem(unsigned int workerThreadCount)
+{
+	m_workers.reserve(static_cast<size_t>(workerThreadCount) + 1);
+	for (unsigned int iii = 0; iii <= workerThreadCount; ++iii)
+	{
+		m_workers.push_back(std::make_unique<Worker>());
+		m_workers.back()->randomState = 0x9E3779B9u * (iii + 1);
+	}
+
+	// The creating thread is worker 0. Its jobs only run while it is waiting on a counter (or when stolen)
+	t_jobSystem = this;
+	t_workerIndex = 0;
+
+	for (unsigned int iii = 1; iii <= workerThreadCount; ++iii)
+		m_workers[iii]->thread = std::thread(&JobSystem::WorkerMain, this, iii);
+}
+
+JobSystem::~JobSystem() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_stopRequested.store(true, std::memory_order_seq_cst);
+	}
+	m_wake.notify_all();
+
+	for (std::unique_ptr<Worker>& worker : m_workers)
+	{
+		if (worker->thread.joinable())
+			worker->thread.join();
+	}
+
+	// Jobs that were never executed (nobody waited on them) are discarded
+	for (std::unique_ptr<Worker>& worker : m_workers)
+	{
+		while (Job* job = worker->deque.Steal())
+			delete job;
+	}
+	for (Job* job : m_injectionQueue)
+		delete job;
+
+	if (t_jobSystem == this)
+		t_jobSystem = nullptr;
+}
+
+unsigned int JobSystem::CurrentThreadIndex() const noexcept
+{
+	return t_jobSystem == this ? t_workerIndex : ThreadCount();
+}
+
+JobSystem::Stats JobSystem::GetStats() const noexcept
+{
+	Stats stats;
+	for (const std::unique_ptr<Worker>& worker : m_workers)
+	{
+		stats.JobsExecuted += worker->jobsExecuted.load(std::memory_order_relaxed);
+		stats.JobsStolen += worker->jobsStolen.load(std::memory_order_relaxed);
+	}
+	stats.JobsInjected = m_jobsInjected.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void JobSystem::Run(JobFn job, JobCounter* counter)
+{
+	if (counter != nullptr)
+		counter->m_count.fetch_add(1, std::memory_order_relaxed);
+
+	Schedule(new Job{ std::move(job), counter, CurrentThreadIndex() });
+}
+
+void JobSystem::RunAfter(JobCounter& dependency, JobFn job, JobCounter* counter)
+{
+	if (counter != nullptr)
+		counter->m_count.fetch_add(1, std::memory_order_relaxed);
+
+	Job* dependent = new Job{ std::move(job), counter, CurrentThreadIndex() };
+	{
+		std::lock_guard<std::mutex> lock(dependency.m_dependentsMutex);
+		if (dependency.m_count.load(std::memory_order_acquire) != 0)
+		{
+			dependency.m_dependents.push_back(dependent);
+			return;
+		}
+	}
+	Schedule(dependent);
+}
+
+void JobSystem::Schedule(Job* job)
+{
+	const unsigned int index = CurrentThreadIndex();
+	if (index == ThreadCount() || !m_workers[index]->deque.Push(job))
+	{
+		std::lock_guard<std::mutex> lock(m_injectionMutex);
+		m_injectionQueue.push_back(job);
+		m_jobsInjected.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Both this and the check in Sleep() are seq_cst, so either the sleeping worker sees the new job or we see the
+	// sleeping worker and wake it
+	m_queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+	if (m_sleepingWorkers.load(std::memory_order_seq_cst) > 0)
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_wake.notify_one();
+	}
+}
+
+JobSystem::Job* JobSystem::FindJob(unsigned int index) noexcept
+{
+	const unsigned int threadCount = ThreadCount();
+
+	// 1. Our own deque (most recently pushed first - it is the most likely to still be in cache)
+	if (index < threadCount)
+	{
+		if (Job* job = m_workers[index]->deque.Pop())
+			return job;
+	}
+
+	// 2. The injection queue
+	{
+		std::unique_lock<std::mutex> lock(m_injectionMutex, std::try_to_lock);
+		if (lock.owns_lock() && !m_injectionQueue.empty())
+		{
+			Job* job = m_injectionQueue.front();
+			m_injectionQueue.pop_front();
+			return job;
+		}
+	}
+
+	// 3. Steal from the other workers, starting from a random victim so thieves don't all pile onto the same deque
+	uint32_t random = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+	if (index < threadCount)
+	{
+		// xorshift32
+		uint32_t& state = m_workers[index]->randomState;
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		random = state;
+	}
+	for (unsigned int iii = 0; iii < threadCount; ++iii)
+	{
+		const unsigned int victim = (random + iii) % threadCount;
+		if (victim == index || m_workers[victim]->deque.LooksEmpty())
+			continue;
+		if (Job* job = m_workers[victim]->deque.Steal())
+			return job;
+	}
+	return nullptr;
+}
+
+void JobSystem::Execute(Job* job, unsigned int index) noexcept
+{
+	m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+	job->fn();
+
+	if (index < ThreadCount())
+	{
+		Worker& worker = *m_workers[index];
+		worker.jobsExecuted.store(worker.jobsExecuted.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		if (job->scheduledBy != index)
+			worker.jobsStolen.store(worker.jobsStolen.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	JobCounter* counter = job->counter;
+	delete job;
+	FinishJob(counter);
+}
+
+void JobSystem::FinishJob(JobCounter* counter)
+{
+	if (counter == nullptr)
+		return;
+
+	counter->m_decrementsInFlight.fetch_add(1, std::memory_order_seq_cst);
+	if (counter->m_count.fetch_sub(1, std::memory_order_seq_cst) == 1)
+	{
+		// Release the jobs that were waiting on this counter
+		std::vector<void*> dependents;
+		{
+			std::lock_guard<std::mutex> lock(counter->m_dependentsMutex);
+			dependents.swap(counter->m_dependents);
+		}
+		for (void* dependent : dependents)
+			Schedule(static_cast<Job*>(dependent));
+	}
+	counter->m_decrementsInFlight.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::Wait(JobCounter& counter) noexcept
+{
+	const unsigned int index = CurrentThreadIndex();
+	unsigned int idleSpins = 0;
+	while (!counter.IsDone())
+	{
+		if (Job* job = FindJob(index))
+		{
+			Execute(job, index);
+			idleSpins = 0;
+		}
+		else if (++idleSpins < IdleSpinCount)
+			EG_JOB_SYSTEM_PAUSE();
+		else
+			std::this_thread::yield();
+	}
+}
+
+void JobSystem::WorkerMain(unsigned int index) noexcept
+{
+	t_jobSystem = this;
+	t_workerIndex = index;
+
+	unsigned int idleSpins = 0;
+	while (!m_stopRequested.load(std::memory_order_relaxed))
+	{
+		if (Job* job = FindJob(index))
+		{
+			Execute(job, index);
+			idleSpins = 0;
+		}
+		else if (++idleSpins < IdleSpinCount)
+			EG_JOB_SYSTEM_PAUSE();
+		else
+		{
+			Sleep();
+			idleSpins = 0;
+		}
+	}
+}
+
+void JobSystem::Sleep() noexcept
+{
+	std::unique_lock<std::mutex> lock(m_sleepMutex);
+	m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+	m_wake.wait(lock, [this]()
+		{
+			return m_queuedJobs.load(std::memory_order_seq_cst) > 0 || m_stopRequested.load(std::memory_order_relaxed);
+		}
+	);
+	m_sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,187 @@
+#pragma once
+#include "pch.h"
+#include "Evergreen/Core.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// NOTE: JobSystem only uses the C++20 standard library (no Windows APIs), so it can be used from any subsystem,
+//       including ones that are compiled without the rest of the engine.
+
+namespace Evergreen
+{
+class JobSystem;
+
+// Tracks a group of jobs. The count is incremented when a job is scheduled against the counter and decremented
+// when it finishes, so the group is complete once it reaches 0. Other jobs can be made to depend on a counter
+// (see JobSystem::RunAfter) and any thread can wait on one (see JobSystem::Wait).
+//
+// NOTE: A counter must outlive every job scheduled against it and every job that depends on it. The usual pattern
+//       is a counter on the stack of the function that calls JobSystem::Wait on it.
+#pragma warning( push )
+#pragma warning( disable : 4251 ) // needs to have dll-interface to be used by clients of class
+class EVERGREEN_API JobCounter
+{
+public:
+	JobCounter() noexcept = default;
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+	~JobCounter() noexcept = default;
+
+	ND inline bool IsDone() const noexcept { return m_count.load(std::memory_order_acquire) == 0 && m_decrementsInFlight.load(std::memory_order_acquire) == 0; }
+	ND inline int Count() const noexcept { return m_count.load(std::memory_order_acquire); }
+
+private:
+	friend class JobSystem;
+
+	std::atomic<int> m_count = 0;
+	// Keeps Wait() from returning (and the counter from being destroyed) while the thread that brought the count
+	// to 0 is still releasing the dependent jobs
+	std::atomic<int> m_decrementsInFlight = 0;
+	std::mutex m_dependentsMutex;
+	std::vector<void*> m_dependents;	// JobSystem::Job*
+};
+
+// Work-stealing thread pool. Every worker thread (and the thread that created the JobSystem, which counts as
+// worker 0) owns a deque of jobs: it pushes and pops at the bottom of its own deque, while idle workers steal from
+// the top of the others'. Jobs scheduled from any other thread go into a shared injection queue.
+//
+// Threads that wait on a counter don't block - they keep executing jobs until the counter is done ("help while
+// waiting"), so waiting from inside a job never deadlocks the pool.
+//
+// NOTE: Jobs must not throw. An exception escaping a job terminates the application.
+class EVERGREEN_API JobSystem
+{
+public:
+	using JobFn = std::function<void()>;
+
+	struct Stats
+	{
+		uint64_t JobsExecuted = 0;
+		uint64_t JobsStolen = 0;		// Executed by a worker other than the one that scheduled them
+		uint64_t JobsInjected = 0;		// Scheduled from outside the pool or after a deque overflowed
+	};
+
+	// workerThreadCount is the number of threads started in addition to the calling thread. By default, one less
+	// than the number of hardware threads so the pool plus the calling thread use every core
+	JobSystem(unsigned int workerThreadCount = DefaultWorkerThreadCount());
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+	~JobSystem() noexcept;
+
+	// Schedules 'job'. If 'counter' is provided, it is incremented now and decremented once the job has finished
+	void Run(JobFn job, JobCounter* counter = nullptr);
+	// Schedules 'job' once 'dependency' is done (immediately, if it already is)
+	void RunAfter(JobCounter& dependency, JobFn job, JobCounter* counter = nullptr);
+	// Executes other jobs until 'counter' is done
+	void Wait(JobCounter& counter) noexcept;
+
+	// Calls fn(rangeBegin, rangeEnd) over [begin, end) split into ranges of at most 'grainSize' elements, and
+	// returns once all of them are done. The range is split recursively in halves so that a thief always steals the
+	// largest remaining piece of work
+	template<typename F>
+	void ParallelFor(size_t begin, size_t end, size_t grainSize, F&& fn);
+
+	// Number of threads that execute jobs, including the thread that created the JobSystem
+	ND inline unsigned int ThreadCount() const noexcept { return static_cast<unsigned int>(m_workers.size()); }
+	// Index of the calling thread in [0, ThreadCount()), or ThreadCount() for threads outside the pool
+	ND unsigned int CurrentThreadIndex() const noexcept;
+	ND Stats GetStats() const noexcept;
+
+	ND static unsigned int DefaultWorkerThreadCount() noexcept;
+
+private:
+	struct Job
+	{
+		JobFn fn;
+		JobCounter* counter;
+		unsigned int scheduledBy;
+	};
+
+	// Chase-Lev work-stealing deque with a fixed capacity. Push/Pop are owner-only, Steal can be called from any thread
+	class WorkStealingDeque
+	{
+	public:
+		static constexpr int64_t Capacity = 4096;
+
+		bool Push(Job* job) noexcept;
+		Job* Pop() noexcept;
+		Job* Steal() noexcept;
+		ND inline bool LooksEmpty() const noexcept { return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed); }
+
+	private:
+		alignas(64) std::atomic<int64_t> m_top = 0;
+		alignas(64) std::atomic<int64_t> m_bottom = 0;
+		alignas(64) std::array<std::atomic<Job*>, Capacity> m_buffer = {};
+	};
+
+	struct alignas(64) Worker
+	{
+		WorkStealingDeque deque;
+		std::thread thread;
+		std::atomic<uint64_t> jobsExecuted = 0;	// Only written by the worker itself
+		std::atomic<uint64_t> jobsStolen = 0;
+		uint32_t randomState = 0;
+	};
+
+	void WorkerMain(unsigned int index) noexcept;
+	void Schedule(Job* job);
+	Job* FindJob(unsigned int index) noexcept;
+	void Execute(Job* job, unsigned int index) noexcept;
+	void FinishJob(JobCounter* counter);
+	void Sleep() noexcept;
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+
+	std::mutex m_injectionMutex;
+	std::deque<Job*> m_injectionQueue;
+	std::atomic<uint64_t> m_jobsInjected = 0;
+
+	// Idle workers sleep on m_wake. m_queuedJobs is an (approximate) count of jobs waiting in deques/the injection
+	// queue, used to decide whether a worker may go to sleep
+	std::atomic<int64_t> m_queuedJobs = 0;
+	std::atomic<int> m_sleepingWorkers = 0;
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wake;
+	std::atomic<bool> m_stopRequested = false;
+};
+#pragma warning( pop )
+
+template<typename F>
+void JobSystem::ParallelFor(size_t begin, size_t end, size_t grainSize, F&& fn)
+{
+	if (begin >= end)
+		return;
+	if (grainSize == 0)
+		grainSize = 1;
+
+	// Small ranges are not worth the scheduling overhead
+	if (end - begin <= grainSize || ThreadCount() == 1)
+	{
+		fn(begin, end);
+		return;
+	}
+
+	JobCounter counter;
+
+	// Each job hands off the upper half of its range until what is left fits in one grain. 'fn' and 'counter' are
+	// captured by reference, which is safe because we wait for every job below before returning
+	std::function<void(size_t, size_t)> split = [this, &split, &fn, &counter, grainSize](size_t rangeBegin, size_t rangeEnd)
+	{
+		while (rangeEnd - rangeBegin > grainSize)
+		{
+			const size_t middle = rangeBegin + (rangeEnd - rangeBegin) / 2;
+			Run([&split, middle, rangeEnd]() { split(middle, rangeEnd); }, &counter);
+			rangeEnd = middle;
+		}
+		fn(rangeBegin, rangeEnd);
+	};
+
+	split(begin, end);
+	Wait(counter);
+}
+
+}
@@ -0,0 +1,160 @@
+#include "pch.h"
+#include "MemoryAccounting.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace Evergreen
+{
+static constexpr size_t CategoryCount = static_cast<size_t>(MemoryCategory::COUNT);
+
+struct CategoryCounters
+{
+	std::atomic<int64_t>	liveBytes = 0;
+	std::atomic<int64_t>	peakBytes = 0;
+	std::atomic<uint64_t>	allocations = 0;
+	std::atomic<uint64_t>	deallocations = 0;
+	std::atomic<uint64_t>	bytesAllocated = 0;
+};
+
+// Per-frame deltas of the counters, kept in a ring buffer indexed by frame % HistoryFrames
+struct FrameHistory
+{
+	std::array<std::chrono::steady_clock::time_point, MemoryAccounting::HistoryFrames> frameEnd = {};
+	std::array<std::array<uint32_t, MemoryAccounting::HistoryFrames>, CategoryCount> allocations = {};
+	std::array<std::array<uint64_t, MemoryAccounting::HistoryFrames>, CategoryCount> bytes = {};
+	std::array<uint64_t, CategoryCount> lastAllocations = {};
+	std::array<uint64_t, CategoryCount> lastBytes = {};
+	uint64_t frame = 0;
+};
+
+static std::array<CategoryCounters, CategoryCount> g_counters;
+static FrameHistory g_history;
+static std::mutex g_historyMutex;
+
+void MemoryAccounting::TrackAllocation(MemoryCategory category, size_t bytes) noexcept
+{
+	EG_CORE_ASSERT(category < MemoryCategory::COUNT, "Invalid memory category");
+
+	CategoryCounters& counters = g_counters[static_cast<size_t>(category)];
+	counters.allocations.fetch_add(1, std::memory_order_relaxed);
+	counters.bytesAllocated.fetch_add(bytes, std::memory_order_relaxed);
+
+	const int64_t live = counters.liveBytes.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed) + static_cast<int64_t>(bytes);
+	int64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+	while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+	{
+	}
+}
+void MemoryAccounting::TrackDeallocation(MemoryCategory category, size_t bytes) noexcept
+{
+	EG_CORE_ASSERT(category < MemoryCategory::COUNT, "Invalid memory category");
+
+	CategoryCounters& counters = g_counters[static_cast<size_t>(category)];
+	counters.deallocations.fetch_add(1, std::memory_order_relaxed);
+	counters.liveBytes.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+}
+
+void MemoryAccounting::EndFrame() noexcept
+{
+	std::lock_guard lock(g_historyMutex);
+
+	const size_t slot = static_cast<size_t>(g_history.frame % HistoryFrames);
+	g_history.frameEnd[slot] = std::chrono::steady_clock::now();
+
+	for (size_t iii = 0; iii < CategoryCount; ++iii)
+	{
+		const uint64_t allocations = g_counters[iii].allocations.load(std::memory_order_relaxed);
+		const uint64_t bytes = g_counters[iii].bytesAllocated.load(std::memory_order_relaxed);
+
+		g_history.allocations[iii][slot] = static_cast<uint32_t>(std::min<uint64_t>(allocations - g_history.lastAllocations[iii], UINT32_MAX));
+		g_history.bytes[iii][slot] = bytes - g_history.lastBytes[iii];
+		g_history.lastAllocations[iii] = allocations;
+		g_history.lastBytes[iii] = bytes;
+	}
+
+	++g_history.frame;
+}
+
+MemoryCategoryStats MemoryAccounting::GetStats(MemoryCategory category) noexcept
+{
+	EG_CORE_ASSERT(category < MemoryCategory::COUNT, "Invalid memory category");
+
+	const size_t index = static_cast<size_t>(category);
+	const CategoryCounters& counters = g_counters[index];
+
+	MemoryCategoryStats stats;
+	stats.name = CategoryName(category);
+	stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+	stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+	stats.totalAllocations = counters.allocations.load(std::memory_order_relaxed);
+	stats.totalBytesAllocated = counters.bytesAllocated.load(std::memory_order_relaxed);
+	const uint64_t deallocations = counters.deallocations.load(std::memory_order_relaxed);
+	stats.liveAllocations = stats.totalAllocations > deallocations ? stats.totalAllocations - deallocations : 0;
+
+	std::lock_guard lock(g_historyMutex);
+
+	const uint64_t frames = std::min<uint64_t>(g_history.frame, HistoryFrames);
+	if (frames == 0)
+		return stats;
+
+	const size_t newest = static_cast<size_t>((g_history.frame - 1) % HistoryFrames);
+	stats.lastFrameAllocations = g_history.allocations[index][newest];
+
+	uint64_t allocations = 0;
+	uint64_t bytes = 0;
+	for (size_t iii = 0; iii < frames; ++iii)
+	{
+		allocations += g_history.allocations[index][iii];
+		bytes += g_history.bytes[index][iii];
+		stats.peakFrameAllocations = std::max(stats.peakFrameAllocations, g_history.allocations[index][iii]);
+		stats.peakFrameBytes = std::max(stats.peakFrameBytes, g_history.bytes[index][iii]);
+	}
+
+	// The window starts at the end of the oldest frame, so it covers one frame fewer than it holds
+	if (frames > 1)
+	{
+		const size_t oldest = static_cast<size_t>((g_history.frame - frames) % HistoryFrames);
+		const double seconds = std::chrono::duration<double>(g_history.frameEnd[newest] - g_history.frameEnd[oldest]).count();
+		if (seconds > 0.0)
+		{
+			allocations -= g_history.allocations[index][oldest];
+			bytes -= g_history.bytes[index][oldest];
+			stats.allocationsPerSecond = allocations / seconds;
+			stats.bytesPerSecond = bytes / seconds;
+		}
+	}
+
+	return stats;
+}
+std::array<MemoryCategoryStats, static_cast<size_t>(MemoryCategory::COUNT)> MemoryAccounting::GetAllStats() noexcept
+{
+	std::array<MemoryCategoryStats, CategoryCount> stats;
+	for (size_t iii = 0; iii < CategoryCount; ++iii)
+		stats[iii] = GetStats(static_cast<MemoryCategory>(iii));
+	return stats;
+}
+
+const char* MemoryAccounting::CategoryName(MemoryCategory category) noexcept
+{
+	switch (category)
+	{
+	case MemoryCategory::UI_TREE:		return "UI Tree";
+	case MemoryCategory::JSON:			return "JSON";
+	case MemoryCategory::TEXT_LAYOUTS:	return "Text Layouts";
+	case MemoryCategory::BRUSHES:		return "Brushes";
+	case MemoryCategory::BITMAPS:		return "Bitmaps";
+	case MemoryCategory::MESHES:		return "Meshes";
+	case MemoryCategory::SIMULATION:	return "Simulation";
+	default:							return "Unknown";
+	}
+}
+
+void MemoryAccounting::ResetPeaks() noexcept
+{
+	for (CategoryCounters& counters : g_counters)
+		counters.peakBytes.store(counters.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+}
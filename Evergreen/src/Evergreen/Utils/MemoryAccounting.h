@@ -0,0 +1,141 @@
+#pragma once
+#include "pch.h"
+#include "Evergreen/Core.h"
+
+// Memory accounting by category. Every category keeps live and peak byte counts, the total number of allocations and
+// bytes, and a per-frame history (see MemoryAccounting::EndFrame) from which allocation rates and the worst frame are
+// computed, so that frame time spikes caused by allocation churn show up next to the subsystem responsible for them.
+//
+// There are two ways to account for memory:
+//		TrackedAllocator	- For containers that own their memory (ex. TrackedVector<float, MemoryCategory::SIMULATION>).
+//							  Allocations go through std::allocator, plus one relaxed atomic add per counter
+//		ExternalMemory		- For memory owned by something that cannot be given an allocator (Direct2D bitmaps,
+//							  DirectWrite text layouts, json documents, ...). The owner reports the size (or an
+//							  estimate of it) and the ExternalMemory keeps it accounted for until it is destroyed
+//
+// All counters are updated with relaxed atomics, so memory may be allocated/freed on any thread.
+
+namespace Evergreen
+{
+enum class MemoryCategory : uint8_t
+{
+	UI_TREE,		// Controls and Layouts
+	JSON,			// json documents while they are being loaded
+	TEXT_LAYOUTS,	// DirectWrite text layouts (estimated)
+	BRUSHES,
+	BITMAPS,		// Decoded bitmap pixels
+	MESHES,			// CPU copies of vertex/index data
+	SIMULATION,		// Per-atom arrays
+	COUNT
+};
+
+struct MemoryCategoryStats
+{
+	const char* name = "";
+	int64_t liveBytes = 0;
+	int64_t peakBytes = 0;				// Since the start of the application (or the last call to ResetPeaks())
+	uint64_t liveAllocations = 0;
+	uint64_t totalAllocations = 0;
+	uint64_t totalBytesAllocated = 0;
+
+	// Over the frames in the history window (see MemoryAccounting::HistoryFrames)
+	double allocationsPerSecond = 0.0;
+	double bytesPerSecond = 0.0;
+	uint32_t lastFrameAllocations = 0;
+	uint32_t peakFrameAllocations = 0;	// Most allocations made during a single frame
+	uint64_t peakFrameBytes = 0;		// Most bytes allocated during a single frame
+};
+
+class EVERGREEN_API MemoryAccounting
+{
+public:
+	static constexpr unsigned int HistoryFrames = 120;
+
+	static void TrackAllocation(MemoryCategory category, size_t bytes) noexcept;
+	static void TrackDeallocation(MemoryCategory category, size_t bytes) noexcept;
+
+	// Called by Application once per frame, after Present
+	static void EndFrame() noexcept;
+
+	ND static MemoryCategoryStats GetStats(MemoryCategory category) noexcept;
+	ND static std::array<MemoryCategoryStats, static_cast<size_t>(MemoryCategory::COUNT)> GetAllStats() noexcept;
+	ND static const char* CategoryName(MemoryCategory category) noexcept;
+
+	// Sets each category's peak back to its current live byte count
+	static void ResetPeaks() noexcept;
+};
+
+template<typename T, MemoryCategory Category>
+class TrackedAllocator
+{
+public:
+	using value_type = T;
+
+	// Needed because the category is not a type, so std::allocator_traits cannot rebind this on its own
+	template<typename U>
+	struct rebind { using other = TrackedAllocator<U, Category>; };
+
+	TrackedAllocator() noexcept = default;
+	template<typename U>
+	TrackedAllocator(const TrackedAllocator<U, Category>&) noexcept {}
+
+	ND T* allocate(size_t n)
+	{
+		T* p = std::allocator<T>{}.allocate(n);
+		MemoryAccounting::TrackAllocation(Category, n * sizeof(T));
+		return p;
+	}
+	void deallocate(T* p, size_t n) noexcept
+	{
+		MemoryAccounting::TrackDeallocation(Category, n * sizeof(T));
+		std::allocator<T>{}.deallocate(p, n);
+	}
+
+	template<typename U>
+	ND bool operator==(const TrackedAllocator<U, Category>&) const noexcept { return true; }
+};
+
+template<typename T, MemoryCategory Category>
+using TrackedVector = std::vector<T, TrackedAllocator<T, Category>>;
+
+class ExternalMemory
+{
+public:
+	explicit ExternalMemory(MemoryCategory category, size_t bytes = 0) noexcept :
+		m_category(category),
+		m_bytes(0)
+	{
+		Set(bytes);
+	}
+	ExternalMemory(const ExternalMemory&) = delete;
+	ExternalMemory& operator=(const ExternalMemory&) = delete;
+	ExternalMemory(ExternalMemory&& rhs) noexcept : m_category(rhs.m_category), m_bytes(std::exchange(rhs.m_bytes, 0)) {}
+	ExternalMemory& operator=(ExternalMemory&& rhs) noexcept
+	{
+		if (this != &rhs)
+		{
+			Set(0);
+			m_category = rhs.m_category;
+			m_bytes = std::exchange(rhs.m_bytes, 0);
+		}
+		return *this;
+	}
+	~ExternalMemory() noexcept { Set(0); }
+
+	// Replaces the accounted size. A non-zero size counts as a new allocation
+	void Set(size_t bytes) noexcept
+	{
+		if (m_bytes > 0)
+			MemoryAccounting::TrackDeallocation(m_category, m_bytes);
+		m_bytes = bytes;
+		if (m_bytes > 0)
+			MemoryAccounting::TrackAllocation(m_category, m_bytes);
+	}
+	ND inline size_t Bytes() const noexcept { return m_bytes; }
+
+private:
+	MemoryCategory	m_category;
+	size_t			m_bytes;
+};
+
+}
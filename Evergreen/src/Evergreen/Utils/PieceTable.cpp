@@ -0,0 +1,229 @@
+#include "pch.h"
+#include "PieceTable.h"
+
+namespace Evergreen
+{
+PieceTable::PieceTable() noexcept :
+	m_pieceStarts(1, 0),
+	m_pieceLineBreaks(1, 0),
+	m_size(0),
+	m_lineBreakCount(0)
+{
+}
+
+PieceTable::PieceTable(std::wstring text) :
+	PieceTable()
+{
+	Assign(std::move(text));
+}
+
+void PieceTable::Assign(std::wstring text)
+{
+	m_original.text = std::move(text);
+	m_original.lineBreaks.clear();
+	AppendLineBreaks(m_original, 0);
+
+	m_add = Buffer();
+	m_pieces.clear();
+	if (!m_original.text.empty())
+		m_pieces.push_back(MakePiece(BufferType::ORIGINAL, 0, m_original.text.size()));
+
+	UpdateRunningTotals(0);
+}
+
+void PieceTable::AppendLineBreaks(Buffer& buffer, size_t from)
+{
+	for (size_t iii = from; iii < buffer.text.size(); ++iii)
+	{
+		if (buffer.text[iii] == L'\n')
+			buffer.lineBreaks.push_back(iii);
+	}
+}
+
+size_t PieceTable::CountLineBreaks(BufferType type, size_t start, size_t length) const noexcept
+{
+	const std::vector<size_t>& lineBreaks = GetBuffer(type).lineBreaks;
+	auto first = std::lower_bound(lineBreaks.begin(), lineBreaks.end(), start);
+	auto last = std::lower_bound(first, lineBreaks.end(), start + length);
+	return static_cast<size_t>(last - first);
+}
+
+size_t PieceTable::FindPiece(size_t position) const noexcept
+{
+	EG_CORE_ASSERT(position <= m_size, "Position out of range");
+
+	if (position >= m_size)
+		return m_pieces.size();
+
+	// The last piece whose start is <= position
+	auto it = std::upper_bound(m_pieceStarts.begin(), m_pieceStarts.end() - 1, position);
+	return static_cast<size_t>(it - m_pieceStarts.begin()) - 1;
+}
+
+void PieceTable::UpdateRunningTotals(size_t firstPiece) noexcept
+{
+	m_pieceStarts.resize(m_pieces.size() + 1);
+	m_pieceLineBreaks.resize(m_pieces.size() + 1);
+
+	for (size_t iii = firstPiece; iii < m_pieces.size(); ++iii)
+	{
+		m_pieceStarts[iii + 1] = m_pieceStarts[iii] + m_pieces[iii].length;
+		m_pieceLineBreaks[iii + 1] = m_pieceLineBreaks[iii] + m_pieces[iii].lineBreaks;
+	}
+
+	m_size = m_pieceStarts.back();
+	m_lineBreakCount = m_pieceLineBreaks.back();
+}
+
+void PieceTable::Insert(size_t position, std::wstring_view text)
+{
+	EG_CORE_ASSERT(position <= m_size, "Position out of range");
+
+	if (text.empty())
+		return;
+
+	const size_t addStart = m_add.text.size();
+	m_add.text.append(text);
+	AppendLineBreaks(m_add, addStart);
+
+	size_t index = FindPiece(position);
+	const size_t offset = position - m_pieceStarts[index];
+
+	// Typing: the previous piece ends exactly where this text was appended, so it can simply be extended
+	if (offset == 0 && index > 0)
+	{
+		Piece& previous = m_pieces[index - 1];
+		if (previous.buffer == BufferType::ADD && previous.start + previous.length == addStart)
+		{
+			previous.length += text.size();
+			previous.lineBreaks = CountLineBreaks(BufferType::ADD, previous.start, previous.length);
+			UpdateRunningTotals(index - 1);
+			return;
+		}
+	}
+
+	const Piece inserted = MakePiece(BufferType::ADD, addStart, text.size());
+
+	if (offset == 0)
+	{
+		m_pieces.insert(m_pieces.begin() + index, inserted);
+	}
+	else
+	{
+		// Split the piece around the inserted text
+		const Piece original = m_pieces[index];
+		const Piece left = MakePiece(original.buffer, original.start, offset);
+		const Piece right = MakePiece(original.buffer, original.start + offset, original.length - offset);
+
+		m_pieces[index] = left;
+		m_pieces.insert(m_pieces.begin() + index + 1, { inserted, right });
+	}
+
+	UpdateRunningTotals(index);
+}
+
+void PieceTable::Erase(size_t position, size_t count)
+{
+	EG_CORE_ASSERT(position <= m_size, "Position out of range");
+
+	count = std::min(count, m_size - position);
+	if (count == 0)
+		return;
+
+	const size_t end = position + count;
+	const size_t first = FindPiece(position);
+	const size_t last = FindPiece(end - 1);
+
+	// At most two pieces survive: what is left of the first piece before 'position' and of the last piece after 'end'
+	Piece remaining[2];
+	size_t remainingCount = 0;
+
+	const Piece& firstPiece = m_pieces[first];
+	const size_t keepBefore = position - m_pieceStarts[first];
+	if (keepBefore > 0)
+		remaining[remainingCount++] = MakePiece(firstPiece.buffer, firstPiece.start, keepBefore);
+
+	const Piece& lastPiece = m_pieces[last];
+	const size_t skipInLast = end - m_pieceStarts[last];
+	if (skipInLast < lastPiece.length)
+		remaining[remainingCount++] = MakePiece(lastPiece.buffer, lastPiece.start + skipInLast, lastPiece.length - skipInLast);
+
+	m_pieces.erase(m_pieces.begin() + first, m_pieces.begin() + last + 1);
+	m_pieces.insert(m_pieces.begin() + first, remaining, remaining + remainingCount);
+
+	UpdateRunningTotals(first);
+}
+
+wchar_t PieceTable::At(size_t position) const noexcept
+{
+	EG_CORE_ASSERT(position < m_size, "Position out of range");
+
+	const size_t index = FindPiece(position);
+	const Piece& piece = m_pieces[index];
+	return GetBuffer(piece.buffer).text[piece.start + position - m_pieceStarts[index]];
+}
+
+std::wstring PieceTable::Substring(size_t position, size_t count) const
+{
+	EG_CORE_ASSERT(position <= m_size, "Position out of range");
+
+	count = std::min(count, m_size - position);
+
+	std::wstring result;
+	result.reserve(count);
+
+	size_t index = FindPiece(position);
+	size_t offset = position - m_pieceStarts[std::min(index, m_pieces.size())];
+	while (count > 0 && index < m_pieces.size())
+	{
+		const Piece& piece = m_pieces[index];
+		const size_t length = std::min(count, piece.length - offset);
+		result.append(GetBuffer(piece.buffer).text, piece.start + offset, length);
+
+		count -= length;
+		offset = 0;
+		++index;
+	}
+	return result;
+}
+
+size_t PieceTable::LineStart(size_t line) const noexcept
+{
+	EG_CORE_ASSERT(line < LineCount(), "Line out of range");
+
+	if (line == 0)
+		return 0;
+
+	// Line 'line' starts right after the line'th line break. Find the piece that holds that line break...
+	auto it = std::lower_bound(m_pieceLineBreaks.begin() + 1, m_pieceLineBreaks.end(), line);
+	const size_t index = static_cast<size_t>(it - m_pieceLineBreaks.begin()) - 1;
+	const Piece& piece = m_pieces[index];
+
+	// ...and then the line break within the piece's buffer
+	const std::vector<size_t>& lineBreaks = GetBuffer(piece.buffer).lineBreaks;
+	auto firstInPiece = std::lower_bound(lineBreaks.begin(), lineBreaks.end(), piece.start);
+	const size_t lineBreak = *(firstInPiece + (line - m_pieceLineBreaks[index] - 1));
+
+	return m_pieceStarts[index] + (lineBreak - piece.start) + 1;
+}
+
+size_t PieceTable::LineLength(size_t line) const noexcept
+{
+	const size_t start = LineStart(line);
+	const size_t end = line + 1 < LineCount() ? LineStart(line + 1) - 1 : m_size;
+	return end - start;
+}
+
+size_t PieceTable::LineOfPosition(size_t position) const noexcept
+{
+	EG_CORE_ASSERT(position <= m_size, "Position out of range");
+
+	const size_t index = FindPiece(position);
+	if (index == m_pieces.size())
+		return m_lineBreakCount;
+
+	const Piece& piece = m_pieces[index];
+	return m_pieceLineBreaks[index] + CountLineBreaks(piece.buffer, piece.start, position - m_pieceStarts[index]);
+}
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "pch.h"
+#include "Evergreen/Core.h"
+#include "Evergreen/Log.h"
+
+namespace Evergreen
+{
+// Text storage for editors that need to handle large documents (TextInput uses it for all of its text).
+//
+// The text is never moved once it is stored: the initial text is kept in an 'original' buffer, everything that is
+// inserted afterwards is appended to an 'add' buffer, and the document is described by a list of pieces that each
+// reference a run of one of the two buffers. An insert appends to the add buffer and splits at most one piece; an
+// erase only trims/removes pieces. Typing (inserting right after the previous insert) just extends the last piece.
+//
+// Each buffer also records the positions of its line breaks ('\n'), so every piece knows how many line breaks it
+// holds. Together with the running totals of each piece's length/line breaks, finding a position or line is a binary
+// search over the pieces followed by a binary search within a buffer's line breaks.
+#pragma warning( push )
+#pragma warning( disable : 4251 ) // needs to have dll-interface to be used by clients of class
+class EVERGREEN_API PieceTable
+{
+public:
+	PieceTable() noexcept;
+	explicit PieceTable(std::wstring text);
+	PieceTable(const PieceTable&) = delete;
+	PieceTable& operator=(const PieceTable&) = delete;
+	PieceTable(PieceTable&&) noexcept = default;
+	PieceTable& operator=(PieceTable&&) noexcept = default;
+	~PieceTable() noexcept = default;
+
+	// Replaces all of the text (and releases both buffers)
+	void Assign(std::wstring text);
+	void Clear() noexcept { Assign(std::wstring()); }
+
+	void Insert(size_t position, std::wstring_view text);
+	void Erase(size_t position, size_t count);
+
+	ND inline size_t Size() const noexcept { return m_size; }
+	ND inline bool Empty() const noexcept { return m_size == 0; }
+	ND wchar_t At(size_t position) const noexcept;
+	ND std::wstring Substring(size_t position, size_t count) const;
+	ND std::wstring ToString() const { return Substring(0, m_size); }
+
+	// Lines are separated by '\n', so there is always at least one (possibly empty) line
+	ND inline size_t LineCount() const noexcept { return m_lineBreakCount + 1; }
+	ND size_t LineStart(size_t line) const noexcept;
+	ND size_t LineLength(size_t line) const noexcept; // Does not include the '\n'
+	ND size_t LineOfPosition(size_t position) const noexcept;
+	ND inline std::wstring Line(size_t line) const { return Substring(LineStart(line), LineLength(line)); }
+
+	ND inline size_t PieceCount() const noexcept { return m_pieces.size(); }
+
+private:
+	enum class BufferType : uint8_t
+	{
+		ORIGINAL,
+		ADD
+	};
+
+	struct Piece
+	{
+		BufferType buffer;
+		size_t start;
+		size_t length;
+		size_t lineBreaks;
+	};
+
+	struct Buffer
+	{
+		std::wstring text;
+		std::vector<size_t> lineBreaks; // Positions of every '\n' in 'text', in order
+	};
+
+	ND inline const Buffer& GetBuffer(BufferType type) const noexcept { return type == BufferType::ORIGINAL ? m_original : m_add; }
+	ND size_t CountLineBreaks(BufferType type, size_t start, size_t length) const noexcept;
+	ND inline Piece MakePiece(BufferType type, size_t start, size_t length) const noexcept { return { type, start, length, CountLineBreaks(type, start, length) }; }
+
+	// Index of the piece that holds 'position' (PieceCount() when 'position' is the end of the text)
+	ND size_t FindPiece(size_t position) const noexcept;
+	void UpdateRunningTotals(size_t firstPiece) noexcept;
+
+	static void AppendLineBreaks(Buffer& buffer, size_t from);
+
+	Buffer m_original;
+	Buffer m_add;
+	std::vector<Piece> m_pieces;
+
+	// m_pieceStarts[i] / m_pieceLineBreaks[i] are the number of characters / line breaks before piece i. Both have
+	// one extra element at the end that holds the totals
+	std::vector<size_t> m_pieceStarts;
+	std::vector<size_t> m_pieceLineBreaks;
+
+	size_t m_size;
+	size_t m_lineBreakCount;
+};
+#pragma warning( pop )
+}
@@ -22,7 +22,9 @@ public:
 		m_framesThisSecond(0),
 		m_qpcSecondCounter(0),
 		m_isFixedTimeStep(false),
-		m_targetElapsedTicks(TicksPerSecond / 60)
+		m_targetElapsedTicks(TicksPerSecond / 60),
+		m_isVirtualTime(false),
+		m_virtualTicksPending(0)
 	{
 		if (!QueryPerformanceFrequency(&m_qpcFrequency))
 		{
@@ -52,6 +54,17 @@ public:
 	// Get the current framerate.
 	ND inline uint32_t GetFramesPerSecond() const noexcept { return m_framesPerSecond; }
 
+	// In fixed timestep mode, how far (in [0, 1)) the current time is between the most recent Update and the next one.
+	// Rendering can use this to interpolate between the previous and current simulation states so that motion stays
+	// smooth when Update runs at a lower rate than the display. In variable timestep mode, Update runs exactly once
+	// per Tick, so the current state is always up to date and this returns 1.
+	ND inline double GetInterpolationAlpha() const noexcept
+	{
+		if (!m_isFixedTimeStep || m_targetElapsedTicks == 0)
+			return 1.0;
+		return std::min(static_cast<double>(m_leftOverTicks) / m_targetElapsedTicks, 1.0);
+	}
+
 	// Set whether to use fixed or variable timestep mode.
 	inline void SetFixedTimeStep(bool isFixedTimestep) noexcept { m_isFixedTimeStep = isFixedTimestep; }
 
@@ -59,6 +72,20 @@ public:
 	inline void SetTargetElapsedTicks(uint64_t targetElapsed) noexcept { m_targetElapsedTicks = targetElapsed; }
 	inline void SetTargetElapsedSeconds(double targetElapsed) noexcept { m_targetElapsedTicks = SecondsToTicks(targetElapsed); }
 
+	// Virtual time mode: instead of reading the clock, Tick() advances time by exactly the amount passed to
+	// AdvanceVirtualTime() since the previous Tick (no clamping), so that a replayed input recording produces the same
+	// sequence of Update calls regardless of how long each frame actually takes. Leaving virtual time resets the
+	// elapsed time so the next Tick doesn't see the real time that passed during the replay.
+	inline void SetVirtualTime(bool isVirtualTime) noexcept
+	{
+		if (m_isVirtualTime && !isVirtualTime)
+			ResetElapsedTime();
+		m_isVirtualTime = isVirtualTime;
+		m_virtualTicksPending = 0;
+	}
+	ND inline bool IsVirtualTime() const noexcept { return m_isVirtualTime; }
+	inline void AdvanceVirtualTime(uint64_t ticks) noexcept { m_virtualTicksPending += ticks; }
+
 	// Integer format represents time using 10,000,000 ticks per second.
 	static const uint64_t TicksPerSecond = 10000000;
 
@@ -86,29 +113,41 @@ public:
 	template<typename TUpdate>
 	void Tick(const TUpdate& update)
 	{
-		// Query the current time.
-		LARGE_INTEGER currentTime;
+		uint64_t timeDelta;
 
-		if (!QueryPerformanceCounter(&currentTime))
+		if (m_isVirtualTime)
 		{
-			EG_CORE_ERROR("{}:{} - Call to QueryPerformanceCounter failed", __FILE__, __LINE__);
+			// Virtual time is already in the canonical tick format
+			timeDelta = m_virtualTicksPending;
+			m_virtualTicksPending = 0;
+			m_qpcSecondCounter += timeDelta * m_qpcFrequency.QuadPart / TicksPerSecond;
 		}
+		else
+		{
+			// Query the current time.
+			LARGE_INTEGER currentTime;
 
+			if (!QueryPerformanceCounter(&currentTime))
+			{
+				EG_CORE_ERROR("{}:{} - Call to QueryPerformanceCounter failed", __FILE__, __LINE__);
+			}
 
-		uint64_t timeDelta = currentTime.QuadPart - m_qpcLastTime.QuadPart;
 
-		m_qpcLastTime = currentTime;
-		m_qpcSecondCounter += timeDelta;
+			timeDelta = currentTime.QuadPart - m_qpcLastTime.QuadPart;
 
-		// Clamp excessively large time deltas (e.g. after paused in the debugger).
-		if (timeDelta > m_qpcMaxDelta)
-		{
-			timeDelta = m_qpcMaxDelta;
-		}
+			m_qpcLastTime = currentTime;
+			m_qpcSecondCounter += timeDelta;
 
-		// Convert QPC units into a canonical tick format. This cannot overflow due to the previous clamp.
-		timeDelta *= TicksPerSecond;
-		timeDelta /= m_qpcFrequency.QuadPart;
+			// Clamp excessively large time deltas (e.g. after paused in the debugger).
+			if (timeDelta > m_qpcMaxDelta)
+			{
+				timeDelta = m_qpcMaxDelta;
+			}
+
+			// Convert QPC units into a canonical tick format. This cannot overflow due to the previous clamp.
+			timeDelta *= TicksPerSecond;
+			timeDelta /= m_qpcFrequency.QuadPart;
+		}
 
 		uint32_t lastFrameCount = m_frameCount;
 
@@ -189,6 +228,10 @@ private:
 	// Members for configuring fixed timestep mode.
 	bool m_isFixedTimeStep;
 	uint64_t m_targetElapsedTicks;
+
+	// Members for virtual time mode.
+	bool m_isVirtualTime;
+	uint64_t m_virtualTicksPending;
 };
 #pragma warning( pop )
 }
\ No newline at end of file
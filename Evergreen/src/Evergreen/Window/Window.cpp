@@ -52,6 +52,23 @@ void Window::Init(const WindowProperties& props) noexcept
 	// ... Create window ...
 }
 
+void Window::SetClientSize(unsigned int width, unsigned int height) noexcept
+{
+	if (width == m_width && height == m_height)
+		return;
+
+	RECT rect = { 0, 0, static_cast<LONG>(width), static_cast<LONG>(height) };
+	if (AdjustWindowRect(&rect, static_cast<DWORD>(GetWindowLongPtr(m_hWnd, GWL_STYLE)), FALSE) == 0)
+	{
+		EG_CORE_ERROR("{}:{} - Call to AdjustWindowRect failed", __FILE__, __LINE__);
+		return;
+	}
+
+	// If the window is maximized, SetWindowPos would only change the saved restore size
+	ShowWindow(m_hWnd, SW_RESTORE);
+	SetWindowPos(m_hWnd, nullptr, 0, 0, rect.right - rect.left, rect.bottom - rect.top, SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE);
+}
+
 void Window::BringToForeground() const
 {
 	if (m_hWnd != ::GetForegroundWindow())
@@ -86,6 +103,14 @@ std::optional<int> Window::ProcessMessages() const noexcept
 	// return empty optional when not quitting app
 	return {};
 }
+void Window::WaitForMessages(unsigned int timeoutMs) const noexcept
+{
+	// MWMO_INPUTAVAILABLE also wakes for input that was already in the queue but not yet removed
+	if (MsgWaitForMultipleObjectsEx(0, nullptr, timeoutMs, QS_ALLINPUT, MWMO_INPUTAVAILABLE) == WAIT_FAILED)
+	{
+		EG_CORE_ERROR("{}:{} - Call to MsgWaitForMultipleObjectsEx failed", __FILE__, __LINE__);
+	}
+}
 
 LRESULT Window::HandleMsg(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept
 {
@@ -38,11 +38,17 @@ public:
 	virtual ~Window();
 
 	ND std::optional<int> ProcessMessages() const noexcept;
+	// Blocks until a message arrives or the timeout elapses. Messages already in the queue return immediately
+	void WaitForMessages(unsigned int timeoutMs) const noexcept;
 	ND LRESULT HandleMsg(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept override;
 
 	ND inline unsigned int GetWidth() const noexcept { return m_width; }
 	ND inline unsigned int GetHeight() const noexcept { return m_height; }
 
+	// Resizes the window so that its client area has the given size. The resulting WM_SIZE is handled before this
+	// returns, so the WindowResizeEvent has already been delivered
+	void SetClientSize(unsigned int width, unsigned int height) noexcept;
+
 	// Event Callback Setters
 	void SetOnWindowResize(const std::function<void(WindowResizeEvent& e)>& f) noexcept { OnWindowResizeFn = f; }
 	void SetOnWindowCreate(const std::function<void(WindowCreateEvent& e)>& f) noexcept { OnWindowCreateFn = f; }
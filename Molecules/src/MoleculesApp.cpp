@@ -14,7 +14,7 @@ MoleculesApp::MoleculesApp() :
 {
 	SetCallbacks();
 	m_ui->SetUIRoot("src/json/");
-	m_ui->LoadUI("main.json");
+	m_ui->LoadUI("main.json", true);
 
 	// Always start with the "Simulation" button as selected
 	m_rightPanelSelectedTabButton = m_ui->GetControlByName<Button>("RightPanel_SimulationButton");
@@ -33,6 +33,7 @@ MoleculesApp::MoleculesApp() :
 
 	// Initialize the Simulation
 	m_simulation = std::make_unique<Simulation>();
+	m_simulation->SetJobSystem(m_jobSystem.get());
 	//m_simulation->Add(Element::Hydrogen, { 0.0f, 0.0f, 0.0f },  {  0.0f,  0.0f,  0.0f });
 	//m_simulation->Add(Element::Helium, { 0.0f, 0.0f, 0.0f },    { -0.1f,  0.9f,  0.0f });
 	//m_simulation->Add(Element::Lithium, { 0.0f, 0.0f, 0.0f },   {  0.2f, -0.8f,  0.0f });
@@ -81,7 +82,25 @@ MoleculesApp::MoleculesApp() :
 
 void MoleculesApp::OnUpdate(const Timer& timer)
 {
-	m_simulation->Update(timer);
+	// Only the simulation runs on a fixed time step. The app Timer stays in variable step mode so that the camera, UI and
+	// animations still update exactly once per rendered frame
+	const double stepSeconds = 1.0 / SimulationStepsPerSecond;
+	m_simulationAccumulator += timer.GetElapsedSeconds();
+
+	// After a long stall (ex. the window was dragged), drop the time that cannot be caught up on rather than running a
+	// burst of steps that makes the next frame stall as well
+	m_simulationAccumulator = std::min(m_simulationAccumulator, MaxSimulationStepsPerUpdate * stepSeconds);
+
+	while (m_simulationAccumulator >= stepSeconds)
+	{
+		m_simulation->Step(static_cast<float>(stepSeconds));
+		m_simulationAccumulator -= stepSeconds;
+	}
+
+	// How far the display is between the last step and the next one. Rendering interpolates the atoms by this much
+	m_simulationInterpolationAlpha = static_cast<float>(m_simulationAccumulator / stepSeconds);
+
+	m_simulation->Observables().ReadLatest(m_latestObservables);
 	m_scene->Update(timer);
 }
 void MoleculesApp::OnRender()
@@ -102,7 +121,8 @@ void MoleculesApp::OnRender()
 	auto vp = m_ui->GetControlByName<Viewport>("MainViewport");
 	GFX_THROW_INFO_ONLY(context->RSSetViewports(1, &vp->GetViewport()));
 
-	m_scene->Render();
+	// Interpolate the atoms between the last two simulation steps
+	m_scene->Render(m_simulationInterpolationAlpha);
 }
 
 void MoleculesApp::FinalizeUI()
@@ -294,7 +314,7 @@ void MoleculesApp::SetMenuBarEditDropDownCallbacks()
 	);
 	JSONLoaders::AddCallback("EditDropDown_MaterialsButton_OnClick", [this](Button* button, MouseButtonReleasedEvent& e)
 		{
-			::EditDropDownMaterialsButtonOnClick(button, e, m_rightPanelSelectedTabButton, m_scene.get(), m_elementSelectedForMaterialEditing);
+			::EditDropDownMaterialsButtonOnClick(button, e, m_rightPanelSelectedTabButton, m_scene.get(), m_materialEditObservables, m_elementSelectedForMaterialEditing);
 		}
 	);
 	JSONLoaders::AddCallback("EditDropDown_LightingButton_OnClick", [this](Button* button, MouseButtonReleasedEvent& e)
@@ -349,11 +369,36 @@ void MoleculesApp::SetSimulationCallbacks()
 			}
 		}
 	);
+
+	// Observable values
+	const std::array<std::pair<const char*, SimulationObservable>, 9> observableTexts{ {
+		{ "Simulation_Step_OnUpdate", SimulationObservable::STEP },
+		{ "Simulation_Time_OnUpdate", SimulationObservable::TIME },
+		{ "Simulation_KineticEnergy_OnUpdate", SimulationObservable::KINETIC_ENERGY },
+		{ "Simulation_PotentialEnergy_OnUpdate", SimulationObservable::POTENTIAL_ENERGY },
+		{ "Simulation_TotalEnergy_OnUpdate", SimulationObservable::TOTAL_ENERGY },
+		{ "Simulation_Temperature_OnUpdate", SimulationObservable::TEMPERATURE },
+		{ "Simulation_Pressure_OnUpdate", SimulationObservable::PRESSURE },
+		{ "Simulation_Momentum_OnUpdate", SimulationObservable::MOMENTUM },
+		{ "Simulation_AtomCounts_OnUpdate", SimulationObservable::ATOM_COUNTS }
+	} };
+	for (const auto& [key, observable] : observableTexts)
+	{
+		JSONLoaders::AddOnUpdateCallback(key,
+			[this, observable](Control* control, const Timer& timer)
+			{
+				SimulationObservableTextOnUpdate(static_cast<Text*>(control), m_latestObservables, observable);
+			}
+		);
+	}
 }
 
 // Material Callbacks
 void MoleculesApp::SetMaterialEditCallbacks()
 {
+	// Drop down text and sliders are bound to these
+	m_materialEditObservables.Register();
+
 	// Tab Callbacks ---------------------------------------------------------------------------
 	// Materials - Tab Button
 	JSONLoaders::AddCallback("MaterialsTabOnClick",
@@ -929,52 +974,5 @@ void MoleculesApp::ChangeButtonBackgroundAndTextColor(Button* button, D2D1::Colo
 
 void MoleculesApp::MaterialEditElementSelectorDropDownItemOnClick(const std::wstring& elementName, Element element) noexcept
 {
-	Text* dropDownText = m_ui->GetControlByName<Text>("RightPanel_ElementSelectorDropDown_Text");
-	EG_ASSERT(dropDownText != nullptr, "Could not find drop down text");
-	dropDownText->SetText(elementName);
-
-	m_elementSelectedForMaterialEditing = element;
-
-	Pane* pane = m_ui->GetPane("RightPanel_ElementSelectorDropDown_Pane");
-	EG_ASSERT(pane != nullptr, "Pane not found");
-	pane->SetVisible(false);
-
-	// Update the sliders that can edit the material
-	Scene* scene = this->GetScene(); 
-	EG_ASSERT(scene != nullptr, "scene not found"); 
-
-	MaterialsArray* materials = scene->GetMaterials(); 
-	EG_ASSERT(materials != nullptr, "materials not found"); 
-
-	const Material& material = materials->materials[static_cast<int>(m_elementSelectedForMaterialEditing) - 1]; 
-
-
-
-	SliderFloat* diffuseAlbedoX = m_rightPanelContentLayout->GetControlByName<SliderFloat>("MaterialDiffuseAlbedoXSlider"); 
-	EG_ASSERT(diffuseAlbedoX != nullptr, "diffuseAlbedoX not found");
-	diffuseAlbedoX->SetValue(material.DiffuseAlbedo.x);
-
-	SliderFloat* diffuseAlbedoY = m_rightPanelContentLayout->GetControlByName<SliderFloat>("MaterialDiffuseAlbedoYSlider"); 
-	EG_ASSERT(diffuseAlbedoY != nullptr, "diffuseAlbedoY not found");
-	diffuseAlbedoY->SetValue(material.DiffuseAlbedo.y);
-
-	SliderFloat* diffuseAlbedoZ = m_rightPanelContentLayout->GetControlByName<SliderFloat>("MaterialDiffuseAlbedoZSlider"); 
-	EG_ASSERT(diffuseAlbedoZ != nullptr, "diffuseAlbedoZ not found");
-	diffuseAlbedoZ->SetValue(material.DiffuseAlbedo.z);
-
-	SliderFloat* fresnelX = m_rightPanelContentLayout->GetControlByName<SliderFloat>("MaterialFresnelXSlider");
-	EG_ASSERT(fresnelX != nullptr, "fresnelX not found");
-	fresnelX->SetValue(material.FresnelR0.x);
-
-	SliderFloat* fresnelY = m_rightPanelContentLayout->GetControlByName<SliderFloat>("MaterialFresnelYSlider");
-	EG_ASSERT(fresnelY != nullptr, "fresnelY not found");
-	fresnelY->SetValue(material.FresnelR0.y);
-
-	SliderFloat* fresnelZ = m_rightPanelContentLayout->GetControlByName<SliderFloat>("MaterialFresnelZSlider");
-	EG_ASSERT(fresnelZ != nullptr, "fresnelZ not found");
-	fresnelZ->SetValue(material.FresnelR0.z);
-
-	SliderFloat* shininess = m_rightPanelContentLayout->GetControlByName<SliderFloat>("MaterialShininessSlider");
-	EG_ASSERT(shininess != nullptr, "shininess not found");
-	shininess->SetValue(material.Shininess);
+	::MaterialEditElementSelectorDropDownItemOnClick(m_ui.get(), this->GetScene(), m_materialEditObservables, elementName, m_elementSelectedForMaterialEditing, element);
 }
\ No newline at end of file
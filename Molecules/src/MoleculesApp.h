@@ -1,6 +1,7 @@
 #include <Evergreen.h>
 #include "Rendering/Scene.h"
 #include "Simulation/Simulation.h"
+#include "UI/RightPanel/TabControls.h"
 
 class MoleculesApp : public Evergreen::Application
 {
@@ -12,6 +13,12 @@ public:
 
 	Scene* GetScene() noexcept { return m_scene.get(); }
 
+	// The simulation steps at this fixed rate, independent of the display (see OnUpdate). Rendering interpolates the
+	// atoms between the last two steps, so the rate can be lowered to save CPU without visible judder
+	static constexpr double SimulationStepsPerSecond = 60.0;
+	// At most this many steps are run in a single frame
+	static constexpr double MaxSimulationStepsPerUpdate = 6.0;
+
 
 protected:
 	std::unique_ptr<Scene> m_scene;
@@ -25,6 +32,12 @@ protected:
 
 	// State we want to keep track of
 	Element m_elementSelectedForMaterialEditing;
+	MaterialEditObservables m_materialEditObservables;
+	ObservableSample m_latestObservables;	// Refreshed once per frame for the Simulation tab
+
+	// Time not yet simulated, always less than one step after OnUpdate. See SimulationStepsPerSecond
+	double m_simulationAccumulator = 0.0;
+	float m_simulationInterpolationAlpha = 1.0f;
 
 	void OnUpdate(const Evergreen::Timer& timer) override;
 	void OnRender() override;
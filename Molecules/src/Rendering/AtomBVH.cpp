@@ -0,0 +1,221 @@
+#include "AtomBVH.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+void AtomBVH::Build(const float* positionsXYZ, const float* radii, size_t count)
+{
+	m_nodes.clear();
+	m_indices.resize(count);
+	std::iota(m_indices.begin(), m_indices.end(), 0u);
+	m_sphereCount = count;
+	m_positions = positionsXYZ;
+	m_radii = radii;
+
+	if (count == 0)
+		return;
+
+	// Roughly 2 nodes per leaf - the vector will still grow if the median splits produce smaller leaves
+	m_nodes.reserve(2 * ((count + MaxLeafSize - 1) / MaxLeafSize));
+	BuildRecursive(positionsXYZ, radii, 0u, static_cast<uint32_t>(count));
+}
+
+uint32_t AtomBVH::BuildRecursive(const float* positionsXYZ, const float* radii, uint32_t begin, uint32_t end)
+{
+	const uint32_t nodeIndex = static_cast<uint32_t>(m_nodes.size());
+	m_nodes.push_back({});
+
+	// Bounds of the sphere centers are used to decide the split axis
+	float centerMin[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+	float centerMax[3] = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+	for (uint32_t iii = begin; iii < end; ++iii)
+	{
+		const float* p = &positionsXYZ[3 * static_cast<size_t>(m_indices[iii])];
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			centerMin[axis] = std::min(centerMin[axis], p[axis]);
+			centerMax[axis] = std::max(centerMax[axis], p[axis]);
+		}
+	}
+
+	if (end - begin <= MaxLeafSize)
+	{
+		Node& leaf = m_nodes[nodeIndex];
+		leaf.first = begin;
+		leaf.count = end - begin;
+		ComputeLeafBounds(leaf, positionsXYZ, radii);
+		return nodeIndex;
+	}
+
+	unsigned int axis = 0;
+	float extent[3] = { centerMax[0] - centerMin[0], centerMax[1] - centerMin[1], centerMax[2] - centerMin[2] };
+	if (extent[1] > extent[axis]) axis = 1;
+	if (extent[2] > extent[axis]) axis = 2;
+
+	// Median split along the longest axis
+	uint32_t middle = begin + (end - begin) / 2;
+	std::nth_element(m_indices.begin() + begin, m_indices.begin() + middle, m_indices.begin() + end,
+		[positionsXYZ, axis](uint32_t lhs, uint32_t rhs)
+		{
+			return positionsXYZ[3 * static_cast<size_t>(lhs) + axis] < positionsXYZ[3 * static_cast<size_t>(rhs) + axis];
+		}
+	);
+
+	uint32_t left = BuildRecursive(positionsXYZ, radii, begin, middle);
+	uint32_t right = BuildRecursive(positionsXYZ, radii, middle, end);
+
+	// NOTE: m_nodes may have been reallocated by the recursive calls, so do not hold a reference across them
+	Node& node = m_nodes[nodeIndex];
+	node.first = right;
+	node.count = 0;
+	for (unsigned int a = 0; a < 3; ++a)
+	{
+		node.min[a] = std::min(m_nodes[left].min[a], m_nodes[right].min[a]);
+		node.max[a] = std::max(m_nodes[left].max[a], m_nodes[right].max[a]);
+	}
+
+	return nodeIndex;
+}
+
+void AtomBVH::ComputeLeafBounds(Node& node, const float* positionsXYZ, const float* radii) const noexcept
+{
+	for (unsigned int axis = 0; axis < 3; ++axis)
+	{
+		node.min[axis] = std::numeric_limits<float>::max();
+		node.max[axis] = std::numeric_limits<float>::lowest();
+	}
+
+	for (uint32_t iii = node.first; iii < node.first + node.count; ++iii)
+	{
+		const uint32_t sphere = m_indices[iii];
+		const float* p = &positionsXYZ[3 * static_cast<size_t>(sphere)];
+		const float r = radii[sphere];
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			node.min[axis] = std::min(node.min[axis], p[axis] - r);
+			node.max[axis] = std::max(node.max[axis], p[axis] + r);
+		}
+	}
+}
+
+void AtomBVH::Refit(const float* positionsXYZ, const float* radii) noexcept
+{
+	m_positions = positionsXYZ;
+	m_radii = radii;
+
+	// Children are always stored after their parent, so walking the array backwards visits every
+	// child before its parent and a single pass is enough to refit the whole tree
+	for (size_t iii = m_nodes.size(); iii-- > 0;)
+	{
+		Node& node = m_nodes[iii];
+		if (node.count > 0)
+		{
+			ComputeLeafBounds(node, positionsXYZ, radii);
+		}
+		else
+		{
+			const Node& left = m_nodes[iii + 1];
+			const Node& right = m_nodes[node.first];
+			for (unsigned int axis = 0; axis < 3; ++axis)
+			{
+				node.min[axis] = std::min(left.min[axis], right.min[axis]);
+				node.max[axis] = std::max(left.max[axis], right.max[axis]);
+			}
+		}
+	}
+}
+
+// Slab test. Returns the entry distance or +infinity if the ray misses the box (or the box is further than 'tMax')
+static inline float RayBoxEntry(const float origin[3], const float invDirection[3], const float min[3], const float max[3], float tMax) noexcept
+{
+	float tNear = 0.0f;
+	float tFar = tMax;
+	for (unsigned int axis = 0; axis < 3; ++axis)
+	{
+		float t0 = (min[axis] - origin[axis]) * invDirection[axis];
+		float t1 = (max[axis] - origin[axis]) * invDirection[axis];
+		if (t0 > t1)
+			std::swap(t0, t1);
+		tNear = std::max(tNear, t0);
+		tFar = std::min(tFar, t1);
+	}
+	return tNear <= tFar ? tNear : std::numeric_limits<float>::infinity();
+}
+
+AtomBVH::RayHit AtomBVH::Raycast(const float origin[3], const float direction[3]) const noexcept
+{
+	RayHit hit;
+	if (m_nodes.empty())
+		return hit;
+
+	// NOTE: Division by zero produces +/- infinity here, which the slab test handles correctly
+	const float invDirection[3] = { 1.0f / direction[0], 1.0f / direction[1], 1.0f / direction[2] };
+	const float a = direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2];
+	if (a == 0.0f)
+		return hit;
+
+	float best = std::numeric_limits<float>::infinity();
+
+	// Tree depth is ~log2(n / MaxLeafSize), so 64 entries is far more than enough
+	uint32_t stack[64];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0u;
+
+	while (stackSize > 0)
+	{
+		const Node& node = m_nodes[stack[--stackSize]];
+		if (RayBoxEntry(origin, invDirection, node.min, node.max, best) == std::numeric_limits<float>::infinity())
+			continue;
+
+		if (node.count > 0)
+		{
+			for (uint32_t iii = node.first; iii < node.first + node.count; ++iii)
+			{
+				const uint32_t sphere = m_indices[iii];
+				const float* c = &m_positions[3 * static_cast<size_t>(sphere)];
+				const float r = m_radii[sphere];
+
+				// Solve |origin + t * direction - c|^2 = r^2 for the smallest t >= 0
+				const float oc[3] = { origin[0] - c[0], origin[1] - c[1], origin[2] - c[2] };
+				const float b = oc[0] * direction[0] + oc[1] * direction[1] + oc[2] * direction[2];
+				const float cc = oc[0] * oc[0] + oc[1] * oc[1] + oc[2] * oc[2] - r * r;
+				const float discriminant = b * b - a * cc;
+				if (discriminant < 0.0f)
+					continue;
+
+				const float root = std::sqrt(discriminant);
+				float t = (-b - root) / a;
+				if (t < 0.0f)
+					t = (-b + root) / a; // Origin is inside the sphere
+				if (t >= 0.0f && t < best)
+				{
+					best = t;
+					hit.index = sphere;
+					hit.distance = t;
+				}
+			}
+		}
+		else
+		{
+			// Visit the nearer child first so 'best' shrinks as quickly as possible
+			const uint32_t left = static_cast<uint32_t>(&node - m_nodes.data()) + 1;
+			const uint32_t right = node.first;
+			float tLeft = RayBoxEntry(origin, invDirection, m_nodes[left].min, m_nodes[left].max, best);
+			float tRight = RayBoxEntry(origin, invDirection, m_nodes[right].min, m_nodes[right].max, best);
+
+			if (tLeft <= tRight)
+			{
+				if (tRight != std::numeric_limits<float>::infinity()) stack[stackSize++] = right;
+				if (tLeft != std::numeric_limits<float>::infinity()) stack[stackSize++] = left;
+			}
+			else
+			{
+				if (tLeft != std::numeric_limits<float>::infinity()) stack[stackSize++] = left;
+				if (tRight != std::numeric_limits<float>::infinity()) stack[stackSize++] = right;
+			}
+		}
+	}
+
+	return hit;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// NOTE: Like FrustumCulling.h, this file has no Windows/DirectX dependencies. Positions are expected as
+//       tightly packed xyz triplets (which is exactly the layout of std::vector<DirectX::XMFLOAT3>).
+
+// Bounding volume hierarchy over a set of spheres (atoms) used for ray picking.
+//
+// The tree is built once with a median split along the longest axis and is then kept up to date by
+// calling Refit() after the spheres move. Refitting only recomputes the node bounds (bottom-up, O(n)),
+// the topology of the tree is left untouched. Call Build() again if the number of spheres changes.
+class AtomBVH
+{
+public:
+	static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+	struct RayHit
+	{
+		uint32_t index = InvalidIndex;	// Index of the sphere that was hit (InvalidIndex if nothing was hit)
+		float distance = 0.0f;			// Distance along the ray (in units of the direction vector) to the hit point
+	};
+
+	AtomBVH() noexcept = default;
+	AtomBVH(const AtomBVH&) = delete;
+	AtomBVH& operator=(const AtomBVH&) = delete;
+
+	// NOTE: The BVH does not copy the sphere data. The pointers passed to Build()/Refit() must remain valid 
+	//       until the next call to either function (Raycast() reads from them)
+	void Build(const float* positionsXYZ, const float* radii, size_t count);
+	void Refit(const float* positionsXYZ, const float* radii) noexcept;
+
+	// Returns the nearest sphere intersected by the ray origin + t * direction for t >= 0
+	[[nodiscard]] RayHit Raycast(const float origin[3], const float direction[3]) const noexcept;
+
+	[[nodiscard]] inline size_t SphereCount() const noexcept { return m_sphereCount; }
+	[[nodiscard]] inline size_t NodeCount() const noexcept { return m_nodes.size(); }
+	[[nodiscard]] inline bool Empty() const noexcept { return m_nodes.empty(); }
+
+private:
+	struct Node
+	{
+		float min[3];
+		float max[3];
+		// Leaf:     'first' is the offset into m_indices and 'count' > 0
+		// Interior: 'first' is the index of the right child (the left child always immediately follows its parent) and 'count' == 0
+		uint32_t first;
+		uint32_t count;
+	};
+
+	static constexpr uint32_t MaxLeafSize = 4;
+
+	uint32_t BuildRecursive(const float* positionsXYZ, const float* radii, uint32_t begin, uint32_t end);
+	void ComputeLeafBounds(Node& node, const float* positionsXYZ, const float* radii) const noexcept;
+
+	std::vector<Node> m_nodes;
+	std::vector<uint32_t> m_indices;
+	size_t m_sphereCount = 0;
+
+	// The sphere data is managed elsewhere (the Simulation) - these point to the data passed to the most recent Build()/Refit()
+	const float* m_positions = nullptr;
+	const float* m_radii = nullptr;
+};
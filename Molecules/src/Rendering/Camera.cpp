@@ -19,22 +19,17 @@ Camera::Camera(Viewport* viewport) :
     m_mousePositionY(0.0f),
     m_mousePositionXNew(0.0f),
     m_mousePositionYNew(0.0f),
-    m_movingToNewLocation(false),
-    m_eyeTarget{0.0f, 0.0f, 0.0f},
-    m_eyeInitial{ 0.0f, 0.0f, 0.0f },
-    m_upTarget{ 0.0f, 0.0f, 0.0f },
-    m_upInitial{ 0.0f, 0.0f, 0.0f },
-    m_moveStartTime(0.0),
-    m_movementComplete(0.0),
-    m_movementDuration(0.0),
-    m_timeAtLastMoveUpdate(0.0),
-    m_totalRotationAngle(0.0),
-    m_rotatingLeftRight(false),
-    m_rotatingUpDown(false)
+    m_animator(viewport->GetUI()->GetAnimator()),
+    m_move(INVALID_ANIMATION_ID),
+    m_moveAngle(0.0f)
 {
     EG_ASSERT(viewport != nullptr, "Viewport cannot be nullptr");
 	CreateProjectionMatrix(viewport->GetAspectRatio());
 }
+Camera::~Camera() noexcept
+{
+    CancelAutomatedMove();
+}
 
 XMMATRIX Camera::ViewMatrix() const noexcept
 {
@@ -78,12 +73,26 @@ XMFLOAT3 Camera::Position() const noexcept
 	return position;
 }
 
+void Camera::ScreenPointToRay(float x, float y, XMFLOAT3& originOut, XMFLOAT3& directionOut) const noexcept
+{
+    const D3D11_VIEWPORT& vp = m_viewport->GetViewport();
+    XMMATRIX view = ViewMatrix();
+
+    // Unproject the point onto the near and far planes. The viewport is in window coordinates, so
+    // the mouse coordinates can be passed in directly
+    XMVECTOR nearPoint = XMVector3Unproject(XMVectorSet(x, y, 0.0f, 1.0f), vp.TopLeftX, vp.TopLeftY, vp.Width, vp.Height, 0.0f, 1.0f, m_projectionMatrix, view, XMMatrixIdentity());
+    XMVECTOR farPoint = XMVector3Unproject(XMVectorSet(x, y, 1.0f, 1.0f), vp.TopLeftX, vp.TopLeftY, vp.Width, vp.Height, 0.0f, 1.0f, m_projectionMatrix, view, XMMatrixIdentity());
+
+    XMStoreFloat3(&originOut, nearPoint);
+    XMStoreFloat3(&directionOut, XMVector3Normalize(XMVectorSubtract(farPoint, nearPoint)));
+}
+
 void Camera::Update(const Timer& timer)
 {
     if (m_mouseLButtonDown)
     {
         // Cancel out any existing automated movement
-        m_movingToNewLocation = false;
+        CancelAutomatedMove();
 
         // If the pointer were to move from the middle of the screen to the far right,
         // that should produce one full rotation. Therefore, set a rotationFactor = 2
@@ -106,7 +115,7 @@ void Camera::Update(const Timer& timer)
     else if (m_upArrow || m_downArrow || m_leftArrow || m_rightArrow)
     {
         // Cancel out any existing automated movement
-        m_movingToNewLocation = false;
+        CancelAutomatedMove();
 
         // Compute the rotation
         constexpr float radiansPerSecond = 0.5f;
@@ -122,110 +131,45 @@ void Camera::Update(const Timer& timer)
         if (m_leftArrow || m_rightArrow)
             RotateLeftRight(theta);
     }
-    else if (m_movingToNewLocation)
-    {
-        if (m_movementComplete)
-        {
-            m_movingToNewLocation = false;
-            m_rotatingLeftRight = false;
-            m_rotatingUpDown = false;
-            return;
-        }
-
-        // If the move start time is less than 0, it needs to be set
-        if (m_moveStartTime < 0.0)
-        {
-            m_moveStartTime = timer.GetTotalSeconds();
-            m_timeAtLastMoveUpdate = m_moveStartTime;
-            return;
-        }
-
-        double currentTime = timer.GetTotalSeconds();
-        double timeDelta = timer.GetElapsedSeconds();
-
-        // If rotating left/right, just compute the necessary angle and call RotateLeftRight / RotateUpDown
-        if (m_rotatingLeftRight)
-        {
-            // If we have surpassed the time for the movement, then use a truncated timeDelta & signal that we are done
-            if (m_moveStartTime + m_movementDuration < currentTime)
-            {
-                m_movementComplete = true;
-                timeDelta = m_moveStartTime + m_movementDuration - m_timeAtLastMoveUpdate;
-            }
-
-            float theta = m_totalRotationAngle * static_cast<float>(timeDelta / m_movementDuration); 
-
-            RotateLeftRight(theta);
+}
 
-            m_timeAtLastMoveUpdate = currentTime;
-        }
-        else if (m_rotatingUpDown)
-        {
-            // If we have surpassed the time for the movement, then use a truncated timeDelta & signal that we are done
-            if (m_moveStartTime + m_movementDuration < currentTime)
-            {
-                m_movementComplete = true;
-                timeDelta = m_moveStartTime + m_movementDuration - m_timeAtLastMoveUpdate;
-            }
+void Camera::MoveTo(const XMFLOAT3& eyeTarget, const XMFLOAT3& upTarget, double durationSeconds) noexcept
+{
+    CancelAutomatedMove();
 
-            float theta = m_totalRotationAngle * static_cast<float>(timeDelta / m_movementDuration);
+    XMFLOAT3 eye, up;
+    DirectX::XMStoreFloat3(&eye, m_eye);
+    DirectX::XMStoreFloat3(&up, m_up);
 
-            RotateUpDown(theta);
+    // Both tweens have the same duration, so the eye tween alone tells whether the move is still running
+    m_move = m_animator.Animate<XMFLOAT3>(&m_eye, eye, eyeTarget, durationSeconds, [this](const XMFLOAT3& value) { m_eye = DirectX::XMLoadFloat3(&value); });
+    m_animator.Animate<XMFLOAT3>(&m_up, up, upTarget, durationSeconds, [this](const XMFLOAT3& value) { m_up = DirectX::XMLoadFloat3(&value); });
+}
+void Camera::Rotate90(float angle, bool leftRight) noexcept
+{
+    // Only allow a single automated move at a time
+    if (m_animator.IsActive(m_move))
+        return;
 
-            m_timeAtLastMoveUpdate = currentTime;
-        }
-        else
+    m_moveAngle = 0.0f;
+    m_move = m_animator.Animate<float>(this, 0.0f, angle, 0.5, [this, leftRight](const float& theta)
         {
-            // Compute the ratio of elapsed time / allowed time to complete
-            float timeRatio = static_cast<float>((currentTime - m_moveStartTime) / m_movementDuration);
-
-            // if the current time is passed the movement duration, just assign final postion
-            if (timeRatio >= 1.0f)
-            {
-                m_movementComplete = true;
-                m_eye = DirectX::XMLoadFloat3(&m_eyeTarget);
-                m_up = DirectX::XMLoadFloat3(&m_upTarget);
-            }
+            // Rotations build on the current eye/up vectors, so only apply what changed since the last update
+            if (leftRight)
+                RotateLeftRight(theta - m_moveAngle);
             else
-            {
-                // Compute the intermediate position
-                XMFLOAT3 eyeCurrent;
-                eyeCurrent.x = m_eyeInitial.x + ((m_eyeTarget.x - m_eyeInitial.x) * timeRatio);
-                eyeCurrent.y = m_eyeInitial.y + ((m_eyeTarget.y - m_eyeInitial.y) * timeRatio);
-                eyeCurrent.z = m_eyeInitial.z + ((m_eyeTarget.z - m_eyeInitial.z) * timeRatio);
-
-                m_eye = DirectX::XMLoadFloat3(&eyeCurrent);
-
-                // Compute the intermediate position
-                XMFLOAT3 upCurrent;
-                upCurrent.x = m_upInitial.x + ((m_upTarget.x - m_upInitial.x) * timeRatio);
-                upCurrent.y = m_upInitial.y + ((m_upTarget.y - m_upInitial.y) * timeRatio);
-                upCurrent.z = m_upInitial.z + ((m_upTarget.z - m_upInitial.z) * timeRatio);
-
-                m_up = DirectX::XMLoadFloat3(&upCurrent);
-            }
+                RotateUpDown(theta - m_moveAngle);
+
+            m_moveAngle = theta;
         }
-    }
+    );
 }
-
-
-
-void Camera::InitializeAutomatedMove(double maxMoveTime) noexcept
+void Camera::CancelAutomatedMove() noexcept
 {
-    // Set m_movingToNewLocation = true so the renderer knows to update the view matrix
-    m_movingToNewLocation = true;
-
-    // Set the move completed flag to false
-    m_movementComplete = false;
-
-    // Reset the start time to -1 to signal it needs to be set in the next Update
-    m_moveStartTime = -1.0;
-
-    // Set the movement max time to 0.1 seconds, so the zoom completes in that time
-    m_movementDuration = maxMoveTime;
-
-    DirectX::XMStoreFloat3(&m_eyeInitial, m_eye);
-    DirectX::XMStoreFloat3(&m_upInitial, m_up);
+    m_animator.CancelTarget(this);
+    m_animator.CancelTarget(&m_eye);
+    m_animator.CancelTarget(&m_up);
+    m_move = INVALID_ANIMATION_ID;
 }
 void Camera::RotateLeftRight(float theta) noexcept
 {
@@ -266,86 +210,60 @@ void Camera::RotateUpDown(float theta) noexcept
 
 void Camera::CenterOnFace() noexcept
 {
-    // Set automated move flags and initial data - 0.5 seconds for the move
-    InitializeAutomatedMove(0.5);
+    XMFLOAT3 eyeInitial, upInitial;
+    DirectX::XMStoreFloat3(&eyeInitial, m_eye);
+    DirectX::XMStoreFloat3(&upInitial, m_up);
 
     // Determine the coordinate with the max value and 0 out the other ones
-    m_eyeTarget.x = m_eyeInitial.x;
-    m_eyeTarget.y = m_eyeInitial.y;
-    m_eyeTarget.z = m_eyeInitial.z;
-
+    XMFLOAT3 eyeTarget;
     XMFLOAT3 length3;
     DirectX::XMStoreFloat3(&length3, DirectX::XMVector3Length(m_eye));
     float length = length3.x;
 
-    m_eyeTarget.x = (std::abs(m_eyeInitial.x) < std::abs(m_eyeInitial.y) || std::abs(m_eyeInitial.x) < std::abs(m_eyeInitial.z)) ? 0.0f : length;
-    m_eyeTarget.y = (std::abs(m_eyeInitial.y) < std::abs(m_eyeInitial.x) || std::abs(m_eyeInitial.y) < std::abs(m_eyeInitial.z)) ? 0.0f : length;
-    m_eyeTarget.z = (std::abs(m_eyeInitial.z) < std::abs(m_eyeInitial.x) || std::abs(m_eyeInitial.z) < std::abs(m_eyeInitial.y)) ? 0.0f : length;
+    eyeTarget.x = (std::abs(eyeInitial.x) < std::abs(eyeInitial.y) || std::abs(eyeInitial.x) < std::abs(eyeInitial.z)) ? 0.0f : length;
+    eyeTarget.y = (std::abs(eyeInitial.y) < std::abs(eyeInitial.x) || std::abs(eyeInitial.y) < std::abs(eyeInitial.z)) ? 0.0f : length;
+    eyeTarget.z = (std::abs(eyeInitial.z) < std::abs(eyeInitial.x) || std::abs(eyeInitial.z) < std::abs(eyeInitial.y)) ? 0.0f : length;
 
-    m_eyeTarget.x *= (m_eyeInitial.x < 0.0f) ? -1.0f : 1.0f;
-    m_eyeTarget.y *= (m_eyeInitial.y < 0.0f) ? -1.0f : 1.0f;
-    m_eyeTarget.z *= (m_eyeInitial.z < 0.0f) ? -1.0f : 1.0f;
+    eyeTarget.x *= (eyeInitial.x < 0.0f) ? -1.0f : 1.0f;
+    eyeTarget.y *= (eyeInitial.y < 0.0f) ? -1.0f : 1.0f;
+    eyeTarget.z *= (eyeInitial.z < 0.0f) ? -1.0f : 1.0f;
 
     // Determine the coordinate with the max value and 0 out the other ones
     // Whichever coordinate for the eye target is used must not be used for the up target, so zero it out
-    float xInit = (m_eyeTarget.x == 0.0f) ? m_upInitial.x : 0.0f;
-    float yInit = (m_eyeTarget.y == 0.0f) ? m_upInitial.y : 0.0f;
-    float zInit = (m_eyeTarget.z == 0.0f) ? m_upInitial.z : 0.0f;
+    float xInit = (eyeTarget.x == 0.0f) ? upInitial.x : 0.0f;
+    float yInit = (eyeTarget.y == 0.0f) ? upInitial.y : 0.0f;
+    float zInit = (eyeTarget.z == 0.0f) ? upInitial.z : 0.0f;
 
     DirectX::XMStoreFloat3(&length3, DirectX::XMVector3Length(m_up));
     length = length3.x;
 
-    m_upTarget.x = (std::abs(xInit) < std::abs(yInit) || std::abs(xInit) < std::abs(zInit)) ? 0.0f : length;
-    m_upTarget.y = (std::abs(yInit) < std::abs(xInit) || std::abs(yInit) < std::abs(zInit)) ? 0.0f : length;
-    m_upTarget.z = (std::abs(zInit) < std::abs(xInit) || std::abs(zInit) < std::abs(yInit)) ? 0.0f : length;
+    XMFLOAT3 upTarget;
+    upTarget.x = (std::abs(xInit) < std::abs(yInit) || std::abs(xInit) < std::abs(zInit)) ? 0.0f : length;
+    upTarget.y = (std::abs(yInit) < std::abs(xInit) || std::abs(yInit) < std::abs(zInit)) ? 0.0f : length;
+    upTarget.z = (std::abs(zInit) < std::abs(xInit) || std::abs(zInit) < std::abs(yInit)) ? 0.0f : length;
 
-    m_upTarget.x *= (xInit < 0.0f) ? -1.0f : 1.0f;
-    m_upTarget.y *= (yInit < 0.0f) ? -1.0f : 1.0f;
-    m_upTarget.z *= (zInit < 0.0f) ? -1.0f : 1.0f;
+    upTarget.x *= (xInit < 0.0f) ? -1.0f : 1.0f;
+    upTarget.y *= (yInit < 0.0f) ? -1.0f : 1.0f;
+    upTarget.z *= (zInit < 0.0f) ? -1.0f : 1.0f;
+
+    // 0.5 seconds for the move
+    MoveTo(eyeTarget, upTarget, 0.5);
 }
 void Camera::RotateLeft90() noexcept
 {
-    // Only allow a single left/right movement at a time
-    if (!m_movingToNewLocation)
-    {
-        // Set automated move flags and initial data - 0.5 seconds for the move
-        InitializeAutomatedMove(0.5);
-        m_rotatingLeftRight = true;
-        m_totalRotationAngle = -1.0f * DirectX::XM_PIDIV2;
-    }
+    Rotate90(-1.0f * DirectX::XM_PIDIV2, true);
 }
 void Camera::RotateRight90() noexcept
 {
-    // Only allow a single left/right movement at a time
-    if (!m_movingToNewLocation)
-    {
-        // Set automated move flags and initial data - 0.5 seconds for the move
-        InitializeAutomatedMove(0.5);
-        m_rotatingLeftRight = true;
-        m_totalRotationAngle = DirectX::XM_PIDIV2;
-    }
+    Rotate90(DirectX::XM_PIDIV2, true);
 }
 void Camera::RotateUp90() noexcept
 {
-    // Only allow a single up/down movement at a time
-    if (!m_movingToNewLocation)
-    {
-        // Set automated move flags and initial data - 0.5 seconds for the move
-        InitializeAutomatedMove(0.5);
-        m_rotatingUpDown = true;
-        m_totalRotationAngle = DirectX::XM_PIDIV2;
-    }
+    Rotate90(DirectX::XM_PIDIV2, false);
 }
 void Camera::RotateDown90() noexcept
 {
-    // Only allow a single up/down movement at a time
-    if (!m_movingToNewLocation)
-    {
-        // Set automated move flags and initial data - 0.5 seconds for the move
-        InitializeAutomatedMove(0.5);
-        m_rotatingUpDown = true;
-        m_totalRotationAngle = -1.0f * DirectX::XM_PIDIV2;
-    }
+    Rotate90(-1.0f * DirectX::XM_PIDIV2, false);
 }
 
 
@@ -373,15 +291,12 @@ void Camera::OnRButtonReleased(float x, float y) noexcept
 }
 void Camera::OnLButtonDoubleClick(float x, float y) noexcept
 {
-    // Set automated move flags and initial data - 0.5 seconds for the move
-    InitializeAutomatedMove(0.5);
+    XMFLOAT3 eye, up;
+    DirectX::XMStoreFloat3(&eye, m_eye);
+    DirectX::XMStoreFloat3(&up, m_up);
 
-    // Set eye target location to half the distance to the center
-    m_eyeTarget.x = m_eyeInitial.x / 2.0f;
-    m_eyeTarget.y = m_eyeInitial.y / 2.0f;
-    m_eyeTarget.z = m_eyeInitial.z / 2.0f;
-
-    m_upTarget = m_upInitial;
+    // Move the eye to half the distance to the center over 0.5 seconds
+    MoveTo(XMFLOAT3(eye.x / 2.0f, eye.y / 2.0f, eye.z / 2.0f), up, 0.5);
 }
 void Camera::OnRButtonDoubleClick(float x, float y) noexcept
 {
@@ -395,19 +310,15 @@ void Camera::OnMouseMove(float x, float y) noexcept
 void Camera::OnMouseScrolledVertical(float x, float y, int scrollDelta) noexcept
 {
     // Only update if not already moving (this avoids a flood of WM_MOUSEWHEEL messages)
-    if (!m_movingToNewLocation)
+    if (!m_animator.IsActive(m_move))
     {
-        // Set automated move flags and initial data - 0.1 seconds for the move
-        InitializeAutomatedMove(0.1);
-
-        m_upTarget = m_upInitial;
+        XMFLOAT3 eye, up;
+        DirectX::XMStoreFloat3(&eye, m_eye);
+        DirectX::XMStoreFloat3(&up, m_up);
 
-        // Set eye target location to be 10% closer/further than the current location
+        // Move the eye 10% closer/further than the current location over 0.1 seconds
         float factor = (scrollDelta > 0) ? 1.1f : 0.9f;
-
-        m_eyeTarget.x = m_eyeInitial.x * factor;
-        m_eyeTarget.y = m_eyeInitial.y * factor;
-        m_eyeTarget.z = m_eyeInitial.z * factor;
+        MoveTo(XMFLOAT3(eye.x * factor, eye.y * factor, eye.z * factor), up, 0.1);
     }
 }
 void Camera::OnMouseScrolledHorizontal(float x, float y, int scrollDelta) noexcept
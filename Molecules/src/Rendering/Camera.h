@@ -6,6 +6,9 @@ class Camera
 {
 public:
 	Camera(Evergreen::Viewport* viewport);
+	Camera(const Camera&) = delete;
+	Camera& operator=(const Camera&) = delete;
+	~Camera() noexcept;
 
 	void Update(const Evergreen::Timer& timer);
 
@@ -13,6 +16,10 @@ public:
 	ND DirectX::XMMATRIX ProjectionMatrix() const noexcept;
 	ND DirectX::XMFLOAT3 Position() const noexcept;
 
+	// Unproject a point in window coordinates (i.e. the coordinates used by mouse events) into a world space ray.
+	// The direction is normalized
+	void ScreenPointToRay(float x, float y, DirectX::XMFLOAT3& originOut, DirectX::XMFLOAT3& directionOut) const noexcept;
+
 	void UpdateProjectionMatrix() noexcept { CreateProjectionMatrix(m_viewport->GetAspectRatio()); }
 
 	void OnLButtonPressed(float x, float y) noexcept;
@@ -32,7 +39,9 @@ public:
 private:
 	void CreateProjectionMatrix(float aspectRatio) noexcept;
 
-	void InitializeAutomatedMove(double maxMoveTime) noexcept;
+	void MoveTo(const DirectX::XMFLOAT3& eyeTarget, const DirectX::XMFLOAT3& upTarget, double durationSeconds) noexcept;
+	void Rotate90(float angle, bool leftRight) noexcept;
+	void CancelAutomatedMove() noexcept;
 	void RotateLeftRight(float theta) noexcept;
 	void RotateUpDown(float theta) noexcept;
 
@@ -68,18 +77,9 @@ private:
 	float m_mousePositionYNew;
 
 	// Automated move variables
-	//		When zooming in/out, or rotating 90, etc., we simply need to set the target location and
-	//		Update() will move the camera for us
-	bool	m_movingToNewLocation;
-	DirectX::XMFLOAT3 m_eyeTarget;
-	DirectX::XMFLOAT3 m_eyeInitial;
-	DirectX::XMFLOAT3 m_upTarget;
-	DirectX::XMFLOAT3 m_upInitial;
-	double m_moveStartTime;
-	double m_movementComplete;
-	double m_movementDuration;
-	double m_timeAtLastMoveUpdate;
-	float  m_totalRotationAngle;
-	bool m_rotatingLeftRight;
-	bool m_rotatingUpDown;
+	//		When zooming in/out, rotating 90, etc., the eye/up vectors (or the rotation angle) are tweened by the
+	//		UI's Animator, which outlives the Camera. m_move is the tween that signals the move is still running
+	Evergreen::Animator&	m_animator;
+	Evergreen::AnimationId	m_move;
+	float					m_moveAngle;	// Angle of the current 90 degree rotation that has already been applied
 };
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "FrameUploadBuffer.h"
+
+using namespace Evergreen;
+
+using Microsoft::WRL::ComPtr;
+
+FrameUploadBuffer::FrameUploadBuffer(std::shared_ptr<DeviceResources> deviceResources, D3D11_BIND_FLAG bindFlag, size_t initialCapacity) :
+	m_deviceResources(deviceResources),
+	m_bindFlag(bindFlag),
+	m_allocator(initialCapacity),
+	m_tailPadding(bindFlag == D3D11_BIND_CONSTANT_BUFFER ? ConstantBufferAlignment : 0)
+{
+	EG_ASSERT(m_deviceResources != nullptr, "No device resources");
+	EG_ASSERT(initialCapacity > 0, "Capacity must be greater than 0");
+
+	if (m_bindFlag == D3D11_BIND_CONSTANT_BUFFER)
+	{
+		// Sub-allocating constant buffers requires both of these (D3D11.1 and later)
+		D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+		GFX_THROW_INFO(m_deviceResources->D3DDevice()->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options)));
+		EG_ASSERT(options.ConstantBufferOffsetting, "Device does not support constant buffer offsetting");
+		EG_ASSERT(options.MapNoOverwriteOnDynamicConstantBuffer, "Device does not support WRITE_NO_OVERWRITE on dynamic constant buffers");
+	}
+
+	CreateBuffer(initialCapacity);
+}
+
+void FrameUploadBuffer::CreateBuffer(size_t capacity)
+{
+	D3D11_BUFFER_DESC desc = {};
+	desc.ByteWidth = static_cast<UINT>(capacity + m_tailPadding);
+	desc.Usage = D3D11_USAGE_DYNAMIC;
+	desc.BindFlags = m_bindFlag;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	desc.MiscFlags = 0u;
+	desc.StructureByteStride = 0u;
+
+	GFX_THROW_INFO(m_deviceResources->D3DDevice()->CreateBuffer(&desc, nullptr, m_buffer.ReleaseAndGetAddressOf()));
+
+	// Nothing in the new buffer is in use by the GPU. The old buffer stays alive until the GPU is done with it because the
+	// context holds its own reference to anything that is bound/used by a queued draw
+	m_allocator.Reset(capacity);
+	m_needsDiscard = true;
+}
+
+void FrameUploadBuffer::BeginFrame()
+{
+	auto context = m_deviceResources->D3DDeviceContext();
+
+	// Queries complete in order, so stop at the first one that has not been signaled yet
+	uint64_t completedFenceValue = 0;
+	while (!m_pendingQueries.empty())
+	{
+		BOOL done = FALSE;
+		if (context->GetData(m_pendingQueries.front().second.Get(), &done, sizeof(BOOL), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK || !done)
+			break;
+
+		completedFenceValue = m_pendingQueries.front().first;
+		m_queryPool.push_back(std::move(m_pendingQueries.front().second));
+		m_pendingQueries.pop_front();
+	}
+
+	if (completedFenceValue > 0)
+		m_allocator.ReleaseCompletedFrames(completedFenceValue);
+}
+
+void FrameUploadBuffer::EndFrame()
+{
+	m_allocator.FinishFrame(++m_frameFenceValue);
+
+	ComPtr<ID3D11Query> query;
+	if (m_queryPool.empty())
+	{
+		D3D11_QUERY_DESC desc = {};
+		desc.Query = D3D11_QUERY_EVENT;
+		desc.MiscFlags = 0u;
+		GFX_THROW_INFO(m_deviceResources->D3DDevice()->CreateQuery(&desc, query.ReleaseAndGetAddressOf()));
+	}
+	else
+	{
+		query = std::move(m_queryPool.back());
+		m_queryPool.pop_back();
+	}
+
+	GFX_THROW_INFO_ONLY(m_deviceResources->D3DDeviceContext()->End(query.Get()));
+	m_pendingQueries.emplace_back(m_frameFenceValue, std::move(query));
+}
+
+size_t FrameUploadBuffer::Upload(const void* data, size_t size, size_t alignment)
+{
+	EG_ASSERT(data != nullptr, "Upload data cannot be nullptr");
+	EG_ASSERT(size > 0, "Upload size must be greater than 0");
+
+	size_t offset = m_allocator.Allocate(size, alignment);
+	if (offset == UploadRingAllocator::InvalidOffset)
+	{
+		// The GPU is still using everything else in the ring - grow it. This should only happen for the first few
+		// frames (or when the number of instances jumps), after which the ring settles at a size that fits
+		size_t newCapacity = std::max(2 * m_allocator.Capacity(), size + alignment);
+		EG_WARN("{}:{} - FrameUploadBuffer is full ({} bytes in use). Growing capacity from {} to {} bytes", __FILE__, __LINE__, m_allocator.UsedBytes(), m_allocator.Capacity(), newCapacity);
+		CreateBuffer(newCapacity);
+
+		offset = m_allocator.Allocate(size, alignment);
+		EG_ASSERT(offset != UploadRingAllocator::InvalidOffset, "Allocation should never fail right after growing the buffer");
+	}
+
+	auto context = m_deviceResources->D3DDeviceContext();
+
+	D3D11_MAPPED_SUBRESOURCE ms;
+	ZeroMemory(&ms, sizeof(D3D11_MAPPED_SUBRESOURCE));
+
+	GFX_THROW_INFO(context->Map(m_buffer.Get(), 0, m_needsDiscard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &ms));
+	memcpy(static_cast<char*>(ms.pData) + offset, data, size);
+	GFX_THROW_INFO_ONLY(context->Unmap(m_buffer.Get(), 0));
+
+	m_needsDiscard = false;
+
+	return offset;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "pch.h"
+#include <Evergreen.h>
+#include "UploadRingAllocator.h"
+
+// A single DYNAMIC buffer that per-frame data (world matrices, instance data, etc.) is sub-allocated from.
+//
+// Rather than mapping a separate buffer with WRITE_DISCARD before every draw, each upload is appended to the
+// ring with WRITE_NO_OVERWRITE and the draw is pointed at its offset. An event query is issued at the end of
+// each frame and the space used by that frame is only reused once the GPU has signaled the query.
+//
+// NOTE: D3D11 does not allow D3D11_BIND_CONSTANT_BUFFER to be combined with any other bind flag, so constant
+//       data and vertex/instance data must each use their own FrameUploadBuffer
+class FrameUploadBuffer
+{
+public:
+	FrameUploadBuffer(std::shared_ptr<Evergreen::DeviceResources> deviceResources, D3D11_BIND_FLAG bindFlag, size_t initialCapacity);
+	FrameUploadBuffer(const FrameUploadBuffer&) = delete;
+	FrameUploadBuffer& operator=(const FrameUploadBuffer&) = delete;
+	~FrameUploadBuffer() noexcept {}
+
+	// Release the space of every frame the GPU has finished with. Call once at the start of each frame
+	void BeginFrame();
+	// Close out the current frame and issue the query that will tell us when the GPU is done with it
+	void EndFrame();
+
+	// Copy 'size' bytes into the ring and return the byte offset they were written to. If the ring is full, the
+	// buffer is re-created with a larger capacity, so always call Get() AFTER calling Upload() to bind the buffer
+	ND size_t Upload(const void* data, size_t size, size_t alignment);
+
+	ND inline ID3D11Buffer* Get() const noexcept { return m_buffer.Get(); }
+	ND inline size_t Capacity() const noexcept { return m_allocator.Capacity(); }
+	ND inline size_t UsedBytes() const noexcept { return m_allocator.UsedBytes(); }
+
+	// Constant buffer views are bound with VSSetConstantBuffers1, which addresses the buffer in 16-byte constants
+	// and requires the first constant to be a multiple of 16 (ie. every offset must be aligned to 256 bytes)
+	static constexpr size_t ConstantBufferAlignment = 256;
+
+private:
+	void CreateBuffer(size_t capacity);
+
+	std::shared_ptr<Evergreen::DeviceResources> m_deviceResources;
+	D3D11_BIND_FLAG m_bindFlag;
+
+	Microsoft::WRL::ComPtr<ID3D11Buffer> m_buffer;
+	UploadRingAllocator m_allocator;
+
+	// A constant buffer view covers a multiple of 16 constants (256 bytes) starting at its offset, so it can extend up to
+	// 256 bytes past the end of an upload. Constant buffers are created with this much extra space at the end to keep a
+	// view of the last upload in the ring inside the buffer
+	size_t m_tailPadding;
+
+	// The first Map after creating the buffer must be WRITE_DISCARD
+	bool m_needsDiscard = true;
+
+	// Event queries for every frame that is still in flight (oldest first), and a pool of queries to reuse
+	uint64_t m_frameFenceValue = 0;
+	std::deque<std::pair<uint64_t, Microsoft::WRL::ComPtr<ID3D11Query>>> m_pendingQueries;
+	std::vector<Microsoft::WRL::ComPtr<ID3D11Query>> m_queryPool;
+};
@@ -0,0 +1,182 @@
+#include "FrustumCulling.h"
+#include <bit>
+#include <cmath>
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define FRUSTUM_CULLING_AVX
+#elif defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+	#include <emmintrin.h>
+	#define FRUSTUM_CULLING_SSE
+#endif
+
+FrustumPlanes ExtractFrustumPlanes(const float m[16]) noexcept
+{
+	// With row vectors, clip = v * M, so column j of M produces clip component j:
+	//		left   :  w + x		right :  w - x
+	//		bottom :  w + y		top   :  w - y
+	//		near   :  z			far   :  w - z
+	auto column = [m](unsigned int row, unsigned int col) -> float { return m[row * 4 + col]; };
+
+	FrustumPlanes planes = {};
+	for (unsigned int row = 0; row < 4; ++row)
+	{
+		float w = column(row, 3);
+		float values[FrustumPlanes::Count] = {
+			w + column(row, 0),
+			w - column(row, 0),
+			w + column(row, 1),
+			w - column(row, 1),
+			column(row, 2),
+			w - column(row, 2)
+		};
+
+		float* destination = row == 0 ? planes.a : row == 1 ? planes.b : row == 2 ? planes.c : planes.d;
+		for (unsigned int iii = 0; iii < FrustumPlanes::Count; ++iii)
+			destination[iii] = values[iii];
+	}
+
+	// Normalize each plane so the signed distance is in world units
+	for (unsigned int iii = 0; iii < FrustumPlanes::Count; ++iii)
+	{
+		float length = std::sqrt(planes.a[iii] * planes.a[iii] + planes.b[iii] * planes.b[iii] + planes.c[iii] * planes.c[iii]);
+		if (length > 0.0f)
+		{
+			float inv = 1.0f / length;
+			planes.a[iii] *= inv;
+			planes.b[iii] *= inv;
+			planes.c[iii] *= inv;
+			planes.d[iii] *= inv;
+		}
+	}
+
+	return planes;
+}
+
+static inline bool SphereVisible(const FrustumPlanes& planes, float x, float y, float z, float r) noexcept
+{
+	for (unsigned int iii = 0; iii < FrustumPlanes::Count; ++iii)
+	{
+		if (planes.a[iii] * x + planes.b[iii] * y + planes.c[iii] * z + planes.d[iii] < -r)
+			return false;
+	}
+	return true;
+}
+
+size_t CullSpheresScalar(const FrustumPlanes& planes,
+	const float* x, const float* y, const float* z, const float* radius,
+	size_t count, uint32_t* visibleIndicesOut) noexcept
+{
+	size_t visibleCount = 0;
+	for (size_t iii = 0; iii < count; ++iii)
+	{
+		if (SphereVisible(planes, x[iii], y[iii], z[iii], radius[iii]))
+			visibleIndicesOut[visibleCount++] = static_cast<uint32_t>(iii);
+	}
+	return visibleCount;
+}
+
+// Write out the index of every set bit in the 8-bit visibility mask
+static inline size_t CompactIndices(unsigned int mask, size_t baseIndex, uint32_t* out) noexcept
+{
+	size_t written = 0;
+	while (mask != 0)
+	{
+		out[written++] = static_cast<uint32_t>(baseIndex + std::countr_zero(mask));
+		mask &= mask - 1;
+	}
+	return written;
+}
+
+size_t CullSpheres(const FrustumPlanes& planes,
+	const float* x, const float* y, const float* z, const float* radius,
+	size_t count, uint32_t* visibleIndicesOut) noexcept
+{
+	size_t visibleCount = 0;
+	size_t iii = 0;
+
+#if defined(FRUSTUM_CULLING_AVX)
+
+	__m256 pa[FrustumPlanes::Count], pb[FrustumPlanes::Count], pc[FrustumPlanes::Count], pd[FrustumPlanes::Count];
+	for (unsigned int p = 0; p < FrustumPlanes::Count; ++p)
+	{
+		pa[p] = _mm256_set1_ps(planes.a[p]);
+		pb[p] = _mm256_set1_ps(planes.b[p]);
+		pc[p] = _mm256_set1_ps(planes.c[p]);
+		pd[p] = _mm256_set1_ps(planes.d[p]);
+	}
+
+	const __m256 zero = _mm256_setzero_ps();
+	for (; iii + 8 <= count; iii += 8)
+	{
+		__m256 vx = _mm256_loadu_ps(x + iii);
+		__m256 vy = _mm256_loadu_ps(y + iii);
+		__m256 vz = _mm256_loadu_ps(z + iii);
+		__m256 negR = _mm256_sub_ps(zero, _mm256_loadu_ps(radius + iii));
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (unsigned int p = 0; p < FrustumPlanes::Count; ++p)
+		{
+			__m256 dist = _mm256_add_ps(
+				_mm256_add_ps(_mm256_mul_ps(pa[p], vx), _mm256_mul_ps(pb[p], vy)),
+				_mm256_add_ps(_mm256_mul_ps(pc[p], vz), pd[p]));
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(dist, negR, _CMP_GE_OQ));
+		}
+
+		visibleCount += CompactIndices(static_cast<unsigned int>(_mm256_movemask_ps(inside)), iii, visibleIndicesOut + visibleCount);
+	}
+
+#elif defined(FRUSTUM_CULLING_SSE)
+
+	__m128 pa[FrustumPlanes::Count], pb[FrustumPlanes::Count], pc[FrustumPlanes::Count], pd[FrustumPlanes::Count];
+	for (unsigned int p = 0; p < FrustumPlanes::Count; ++p)
+	{
+		pa[p] = _mm_set1_ps(planes.a[p]);
+		pb[p] = _mm_set1_ps(planes.b[p]);
+		pc[p] = _mm_set1_ps(planes.c[p]);
+		pd[p] = _mm_set1_ps(planes.d[p]);
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+	for (; iii + 8 <= count; iii += 8)
+	{
+		// Process 8 spheres per iteration as two independent groups of 4 to keep both SSE pipes busy
+		__m128 vx0 = _mm_loadu_ps(x + iii);
+		__m128 vy0 = _mm_loadu_ps(y + iii);
+		__m128 vz0 = _mm_loadu_ps(z + iii);
+		__m128 negR0 = _mm_sub_ps(zero, _mm_loadu_ps(radius + iii));
+		__m128 vx1 = _mm_loadu_ps(x + iii + 4);
+		__m128 vy1 = _mm_loadu_ps(y + iii + 4);
+		__m128 vz1 = _mm_loadu_ps(z + iii + 4);
+		__m128 negR1 = _mm_sub_ps(zero, _mm_loadu_ps(radius + iii + 4));
+
+		__m128 inside0 = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		__m128 inside1 = inside0;
+		for (unsigned int p = 0; p < FrustumPlanes::Count; ++p)
+		{
+			__m128 dist0 = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(pa[p], vx0), _mm_mul_ps(pb[p], vy0)),
+				_mm_add_ps(_mm_mul_ps(pc[p], vz0), pd[p]));
+			__m128 dist1 = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(pa[p], vx1), _mm_mul_ps(pb[p], vy1)),
+				_mm_add_ps(_mm_mul_ps(pc[p], vz1), pd[p]));
+			inside0 = _mm_and_ps(inside0, _mm_cmpge_ps(dist0, negR0));
+			inside1 = _mm_and_ps(inside1, _mm_cmpge_ps(dist1, negR1));
+		}
+
+		unsigned int mask = static_cast<unsigned int>(_mm_movemask_ps(inside0)) |
+			(static_cast<unsigned int>(_mm_movemask_ps(inside1)) << 4);
+		visibleCount += CompactIndices(mask, iii, visibleIndicesOut + visibleCount);
+	}
+
+#endif
+
+	// Remaining spheres (or all of them when no SIMD instruction set is available)
+	for (; iii < count; ++iii)
+	{
+		if (SphereVisible(planes, x[iii], y[iii], z[iii], radius[iii]))
+			visibleIndicesOut[visibleCount++] = static_cast<uint32_t>(iii);
+	}
+
+	return visibleCount;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// NOTE: This file is intentionally free of any Windows/DirectX dependencies so that the culling
+//       kernel can be compiled and exercised on its own. Matrices are expected to be laid out
+//       the way DirectXMath stores them (row-major, row vectors => clip = v * M).
+
+// Six planes in structure-of-arrays form. Each plane satisfies a*x + b*y + c*z + d >= 0 for points
+// inside the frustum and the (a, b, c) normals are normalized so that the distance can be compared
+// directly against a bounding sphere radius.
+struct FrustumPlanes
+{
+	static constexpr unsigned int Count = 6;
+
+	float a[Count];
+	float b[Count];
+	float c[Count];
+	float d[Count];
+};
+
+// Extract the left/right/bottom/top/near/far planes from a combined view-projection matrix.
+// The near plane uses the Direct3D clip space convention (0 <= z <= w).
+FrustumPlanes ExtractFrustumPlanes(const float viewProjection[16]) noexcept;
+
+// Test 'count' bounding spheres (given as separate x/y/z/radius arrays) against the frustum. The indices of
+// every sphere that is at least partially inside the frustum are written, in increasing order, to
+// 'visibleIndicesOut', which must be large enough to hold 'count' values. Returns the number of visible spheres.
+//
+// Spheres are tested 8 at a time with SIMD (AVX when available, otherwise two SSE registers) and the
+// remaining spheres are handled by the scalar path.
+size_t CullSpheres(const FrustumPlanes& planes,
+	const float* x, const float* y, const float* z, const float* radius,
+	size_t count, uint32_t* visibleIndicesOut) noexcept;
+
+// Scalar reference implementation. Produces identical results to CullSpheres.
+size_t CullSpheresScalar(const FrustumPlanes& planes,
+	const float* x, const float* y, const float* z, const float* radius,
+	size_t count, uint32_t* visibleIndicesOut) noexcept;
@@ -2,6 +2,7 @@
 #include "pch.h"
 #include <Evergreen.h>
 #include "Structs.h"
+#include "RenderStateCache.h"
 
 struct MeshInstance
 {
@@ -70,7 +71,10 @@ class MeshSetBase
 {
 public:
 	MeshSetBase(std::shared_ptr<Evergreen::DeviceResources> deviceResources);
-	void BindToIA() const;
+	void BindToIA(RenderStateCache& cache) const;
+
+	// Unique id of this mesh set, used as the mesh set id of the RenderQueue sort key
+	ND inline std::uint16_t SortId() const noexcept { return m_sortId; }
 
 protected:
 	std::shared_ptr<Evergreen::DeviceResources> m_deviceResources;
@@ -79,6 +83,7 @@ protected:
 
 	UINT m_sizeOfT;
 	bool m_finalized;
+	std::uint16_t m_sortId;
 };
 
 template<class T>
@@ -107,7 +112,7 @@ public:
 	ND inline ID3D11Buffer* GetRawVertexBufferPointer() noexcept { return m_vertexBuffer.Get(); }
 	ND inline ID3D11Buffer* GetRawIndexBufferPointer() noexcept { return m_indexBuffer.Get(); }
 
-	void UpdateVertices(std::vector<T>& newVertices);
+	void UpdateVertices(const std::vector<T>& newVertices);
 
 private:
 	void Subdivide(MeshData& meshData) const;
@@ -117,8 +122,9 @@ private:
 
 	std::function<std::vector<T>(std::vector<GenericVertex>)> m_VertexConversionFn;
 
-	std::vector<T>				m_vertices;
-	std::vector<std::uint16_t>	m_indices;
+	// CPU copies of the buffers, accounted under Evergreen::MemoryCategory::MESHES
+	Evergreen::TrackedVector<T, Evergreen::MemoryCategory::MESHES>				m_vertices;
+	Evergreen::TrackedVector<std::uint16_t, Evergreen::MemoryCategory::MESHES>	m_indices;
 
 	bool m_dynamic;
 	bool m_vertexConversionFunctionIsSet;
@@ -716,14 +722,14 @@ void MeshSet<T>::Finalize()
 }
 
 template<class T>
-void MeshSet<T>::UpdateVertices(std::vector<T>& newVertices)
+void MeshSet<T>::UpdateVertices(const std::vector<T>& newVertices)
 {
 	EG_ASSERT(m_dynamic, "Cannot update vertices unless the vertex buffer is dynamic");
 	EG_ASSERT(m_vertices.size() == newVertices.size(), "Right now, we only support an exact replacement of the existing vertices");
 
 	auto context = m_deviceResources->D3DDeviceContext();
 
-	m_vertices.swap(newVertices);
+	std::copy(newVertices.begin(), newVertices.end(), m_vertices.begin());
 
 	D3D11_MAPPED_SUBRESOURCE ms;
 	ZeroMemory(&ms, sizeof(D3D11_MAPPED_SUBRESOURCE));
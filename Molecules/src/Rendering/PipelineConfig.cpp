@@ -5,6 +5,8 @@
 using namespace Evergreen;
 using namespace DirectX;
 
+static std::uint16_t s_nextPipelineConfigSortId = 0;
+
 PipelineConfig::PipelineConfig(std::shared_ptr<Evergreen::DeviceResources> deviceResources,
 								std::unique_ptr<VertexShader> vertexShader,
 								std::unique_ptr<PixelShader> pixelShader,
@@ -26,7 +28,8 @@ PipelineConfig::PipelineConfig(std::shared_ptr<Evergreen::DeviceResources> devic
 	m_blendState(std::move(blendState)),
 	m_depthStencilState(std::move(depthStencilState)),
 	m_vertexShaderConstantBufferArray(std::move(vertexShaderConstantBufferArray)),
-	m_pixelShaderConstantBufferArray(std::move(pixelShaderConstantBufferArray))
+	m_pixelShaderConstantBufferArray(std::move(pixelShaderConstantBufferArray)),
+	m_sortId(s_nextPipelineConfigSortId++)
 {
 	EG_ASSERT(m_deviceResources != nullptr, "No device resources");
 	EG_ASSERT(m_vertexShader != nullptr, "cannot be nullptr");
@@ -37,38 +40,47 @@ PipelineConfig::PipelineConfig(std::shared_ptr<Evergreen::DeviceResources> devic
 	EG_ASSERT(m_depthStencilState != nullptr, "cannot be nullptr");
 }
 
-void PipelineConfig::ApplyConfig() const
+void PipelineConfig::ApplyConfig(RenderStateCache& cache) const
 {
 	EG_ASSERT(m_deviceResources != nullptr, "No device resources");
 
 	auto context = m_deviceResources->D3DDeviceContext();
 
 	// bind pixel shader
-	GFX_THROW_INFO_ONLY(context->PSSetShader(m_pixelShader->Get(), nullptr, 0u));
+	if (cache.Changed(RenderStateSlot::PIXEL_SHADER, m_pixelShader->Get()))
+		GFX_THROW_INFO_ONLY(context->PSSetShader(m_pixelShader->Get(), nullptr, 0u));
 
 	// bind vertex shader
-	GFX_THROW_INFO_ONLY(context->VSSetShader(m_vertexShader->Get(), nullptr, 0u));
+	if (cache.Changed(RenderStateSlot::VERTEX_SHADER, m_vertexShader->Get()))
+		GFX_THROW_INFO_ONLY(context->VSSetShader(m_vertexShader->Get(), nullptr, 0u));
 
 	// bind vertex layout
-	GFX_THROW_INFO_ONLY(context->IASetInputLayout(m_inputLayout->Get()));
+	if (cache.Changed(RenderStateSlot::INPUT_LAYOUT, m_inputLayout->Get()))
+		GFX_THROW_INFO_ONLY(context->IASetInputLayout(m_inputLayout->Get()));
 
 	// Set primitive topology to triangle list (groups of 3 vertices)
-	GFX_THROW_INFO_ONLY(context->IASetPrimitiveTopology(m_topology));
+	if (cache.Changed(RenderStateSlot::PRIMITIVE_TOPOLOGY, static_cast<std::uintptr_t>(m_topology)))
+		GFX_THROW_INFO_ONLY(context->IASetPrimitiveTopology(m_topology));
 
 	// Set Rasterizer State
-	GFX_THROW_INFO_ONLY(context->RSSetState(m_rasterizerState->Get()));
+	if (cache.Changed(RenderStateSlot::RASTERIZER_STATE, m_rasterizerState->Get()))
+		GFX_THROW_INFO_ONLY(context->RSSetState(m_rasterizerState->Get()));
 
 	// Set Blend State
-	GFX_THROW_INFO_ONLY(context->OMSetBlendState(m_blendState->Get(), m_blendFactor, m_blendSampleMask));
+	// NOTE: The blend factor/sample mask (and stencil ref below) are bound along with the state object, so they are
+	//       part of the cache key. Otherwise, changes made via the setters would never be bound
+	if (cache.Changed(RenderStateSlot::BLEND_STATE, m_blendState->Get(), m_blendSettingsVersion))
+		GFX_THROW_INFO_ONLY(context->OMSetBlendState(m_blendState->Get(), m_blendFactor, m_blendSampleMask));
 
 	// Set Depth Stencil State
-	GFX_THROW_INFO_ONLY(context->OMSetDepthStencilState(m_depthStencilState->Get(), m_stencilRef));
+	if (cache.Changed(RenderStateSlot::DEPTH_STENCIL_STATE, m_depthStencilState->Get(), m_stencilRef))
+		GFX_THROW_INFO_ONLY(context->OMSetDepthStencilState(m_depthStencilState->Get(), m_stencilRef));
 
 	// Set the VS constant buffers
-	if (m_vertexShaderConstantBufferArray != nullptr)
+	if (m_vertexShaderConstantBufferArray != nullptr && cache.Changed(RenderStateSlot::VS_CONSTANT_BUFFERS, m_vertexShaderConstantBufferArray.get()))
 		m_vertexShaderConstantBufferArray->BindVS();
 
 	// Set the PS constant buffers
-	if (m_pixelShaderConstantBufferArray != nullptr)
+	if (m_pixelShaderConstantBufferArray != nullptr && cache.Changed(RenderStateSlot::PS_CONSTANT_BUFFERS, m_pixelShaderConstantBufferArray.get()))
 		m_pixelShaderConstantBufferArray->BindPS();
 }
\ No newline at end of file
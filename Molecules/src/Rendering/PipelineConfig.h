@@ -9,6 +9,7 @@
 #include "RasterizerState.h"
 #include "BlendState.h"
 #include "DepthStencilState.h"
+#include "RenderStateCache.h"
 
 class PipelineConfig
 {
@@ -26,11 +27,15 @@ public:
 	PipelineConfig& operator=(const PipelineConfig&) noexcept = delete;
 	~PipelineConfig() noexcept {}
 
-	void ApplyConfig() const;
+	// Only the parts of the configuration that differ from what the cache says is currently bound are applied
+	void ApplyConfig(RenderStateCache& cache) const;
+
+	// Unique id of this config, used as the pipeline id of the RenderQueue sort key
+	ND inline std::uint16_t SortId() const noexcept { return m_sortId; }
 
 	inline void SetTopology(D3D11_PRIMITIVE_TOPOLOGY topology) noexcept { m_topology = topology; }
-	inline void SetBlendFactor(float blendFactors[4]) noexcept { memcpy(m_blendFactor, blendFactors, sizeof(float) * 4); }
-	inline void SetBlendSampleMask(unsigned int mask) noexcept { m_blendSampleMask = mask; }
+	inline void SetBlendFactor(float blendFactors[4]) noexcept { memcpy(m_blendFactor, blendFactors, sizeof(float) * 4); ++m_blendSettingsVersion; }
+	inline void SetBlendSampleMask(unsigned int mask) noexcept { m_blendSampleMask = mask; ++m_blendSettingsVersion; }
 	inline void SetStencilRef(unsigned int ref) noexcept { m_stencilRef = ref; }
 
 private:
@@ -49,4 +54,9 @@ private:
 	float                                           m_blendFactor[4];
 	unsigned int                                    m_blendSampleMask;
 	unsigned int									m_stencilRef;
+
+	// Bumped whenever the blend factor/sample mask change so that the blend state is re-bound even though the state object is the same
+	unsigned int									m_blendSettingsVersion = 0;
+
+	std::uint16_t									m_sortId;
 };
\ No newline at end of file
@@ -11,43 +11,85 @@ RenderObjectList::RenderObjectList(std::shared_ptr<Evergreen::DeviceResources> d
 	m_mesh(mesh)
 {
 	EG_ASSERT(deviceResources != nullptr, "No device resources");
-
-	auto device = m_deviceResources->D3DDevice();
-
-	D3D11_BUFFER_DESC bd = {};
-	bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	bd.Usage = D3D11_USAGE_DYNAMIC;
-	bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	bd.MiscFlags = 0u;
-	bd.ByteWidth = static_cast<UINT>(MAX_INSTANCES * sizeof(unsigned int)); // Size of buffer in bytes
-	bd.StructureByteStride = sizeof(unsigned int);
-
-	GFX_THROW_INFO(device->CreateBuffer(&bd, nullptr, m_instanceBuffer.ReleaseAndGetAddressOf()));
 }
 
-void RenderObjectList::Update(const Timer& timer) noexcept
+void RenderObjectList::Update(float interpolationAlpha) noexcept
 {
 	EG_ASSERT(m_worldMatrices.size() == m_renderObjects.size(), "Number of world matrices and render objects should match");
 
 	// Re-compute all world matrices every frame because their positions will be changing
 	for (unsigned int iii = 0; iii < m_renderObjects.size(); ++iii)
 	{
-		m_worldMatrices[iii] = m_renderObjects[iii].WorldMatrix();
+		m_worldMatrices[iii] = m_renderObjects[iii].WorldMatrix(interpolationAlpha);
+	}
+
+	// Gather the bounding spheres into SoA form for the culling pass
+	if (m_frustumCullingEnabled)
+	{
+		const size_t count = m_renderObjects.size();
+		m_boundsX.resize(count);
+		m_boundsY.resize(count);
+		m_boundsZ.resize(count);
+		m_boundsRadius.resize(count);
+
+		for (size_t iii = 0; iii < count; ++iii)
+		{
+			const DirectX::XMFLOAT3 translation = m_renderObjects[iii].Translation(interpolationAlpha);
+			const DirectX::XMFLOAT3& scaling = m_renderObjects[iii].Scaling();
+			m_boundsX[iii] = translation.x;
+			m_boundsY[iii] = translation.y;
+			m_boundsZ[iii] = translation.z;
+			m_boundsRadius[iii] = m_meshBoundingRadius * std::max({ scaling.x, scaling.y, scaling.z });
+		}
+	}
+}
+
+void RenderObjectList::CullInstances(const FrustumPlanes& planes) noexcept
+{
+	if (!m_frustumCullingEnabled)
+		return;
+
+	EG_ASSERT(m_boundsX.size() == m_renderObjects.size(), "Bounding spheres are out of date - Update() must be called before CullInstances()");
+
+	const size_t count = m_boundsX.size();
+	m_visibleIndices.resize(count);
+
+	size_t visibleCount = CullSpheres(planes, m_boundsX.data(), m_boundsY.data(), m_boundsZ.data(), m_boundsRadius.data(), count, m_visibleIndices.data());
+
+	// Compact the visible instances into the upload stream
+	m_visibleWorldMatrices.resize(visibleCount);
+	m_visibleMaterialIndices.resize(visibleCount);
+	for (size_t iii = 0; iii < visibleCount; ++iii)
+	{
+		m_visibleWorldMatrices[iii] = m_worldMatrices[m_visibleIndices[iii]];
+		m_visibleMaterialIndices[iii] = m_materialIndices[m_visibleIndices[iii]];
 	}
 }
 
-void RenderObjectList::Render() const
+void RenderObjectList::Render(RenderStateCache& cache) const
 {
 	EG_ASSERT(m_deviceResources != nullptr, "No device resources");
 	EG_ASSERT(m_worldMatrices.size() == m_renderObjects.size(), "Number of world matrices and render objects should match");
 
 	auto context = m_deviceResources->D3DDeviceContext();
+
+	// Only the instances in the upload stream are drawn (this is the compacted list of visible instances when culling is enabled)
+	const size_t instanceCount = GetInstanceWorldMatrices().size();
 	
+	if (instanceCount == 0)
+		return;
+
+	if (m_worldMatrixUploadBuffer != nullptr)
+	{
+		RenderFromUploadBuffers(instanceCount, cache);
+		return;
+	}
+
 	// Loop over the world matrices and draw up to MAX_INSTANCES at a time
 	size_t endIndex = 0; 
-	for (size_t startIndex = 0; startIndex < m_worldMatrices.size(); startIndex += MAX_INSTANCES)
+	for (size_t startIndex = 0; startIndex < instanceCount; startIndex += MAX_INSTANCES)
 	{
-		endIndex = std::min(startIndex + MAX_INSTANCES, m_worldMatrices.size()) - 1;
+		endIndex = std::min(startIndex + static_cast<size_t>(MAX_INSTANCES), instanceCount) - 1;
 
 		// Need to assign lambda that will update pipeline constant buffers 
 		m_bufferUpdateFn(this, startIndex, endIndex);
@@ -56,4 +98,54 @@ void RenderObjectList::Render() const
 			context->DrawIndexedInstanced(m_mesh.IndexCount, static_cast<UINT>(endIndex - startIndex + 1), m_mesh.StartIndexLocation, m_mesh.BaseVertexLocation, 0u);
 		); 
 	}
+}
+
+void RenderObjectList::RenderFromUploadBuffers(size_t instanceCount, RenderStateCache& cache) const
+{
+	auto context = m_deviceResources->D3DDeviceContext();
+
+	// Upload the instance data for the whole list at once. Because sizeof(WorldMatrixInstances) is a multiple of 256,
+	// each chunk of MAX_INSTANCES world matrices starts at a valid constant buffer offset
+	static_assert(sizeof(WorldMatrixInstances) % FrameUploadBuffer::ConstantBufferAlignment == 0);
+	static_assert(sizeof(WorldMatrixInstances) == D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT * 16);
+
+	const std::vector<DirectX::XMFLOAT4X4>& worldMatrices = GetInstanceWorldMatrices();
+	const std::vector<unsigned int>& materialIndices = GetInstanceMaterialIndices();
+
+	size_t worldMatrixOffset = m_worldMatrixUploadBuffer->Upload(worldMatrices.data(), sizeof(XMFLOAT4X4) * instanceCount, FrameUploadBuffer::ConstantBufferAlignment);
+	size_t instanceOffset = m_instanceUploadBuffer->Upload(materialIndices.data(), sizeof(unsigned int) * instanceCount, sizeof(unsigned int));
+
+	// NOTE: Get() must be called after Upload() in case the upload had to re-create the buffer
+	ID3D11Buffer* worldMatrixBuffer = m_worldMatrixUploadBuffer->Get();
+	ID3D11Buffer* instanceBuffer = m_instanceUploadBuffer->Get();
+
+	for (size_t startIndex = 0; startIndex < instanceCount; startIndex += MAX_INSTANCES)
+	{
+		const size_t count = std::min(static_cast<size_t>(MAX_INSTANCES), instanceCount - startIndex);
+
+		// Constant buffer offsets are in 16-byte constants. The view only covers this chunk's world matrices (4 constants
+		// each), rounded up to a multiple of 16 constants as required by VSSetConstantBuffers1. The shader never reads past
+		// 'count' instances, and anything in the view beyond the buffer reads back as 0
+		// The size is part of the cache key: the cache persists across frames, and the ring can come back around to the
+		// same offset with a different number of instances
+		const size_t worldMatrixChunkOffset = worldMatrixOffset + startIndex * sizeof(XMFLOAT4X4);
+		UINT firstConstant = static_cast<UINT>(worldMatrixChunkOffset / 16);
+		UINT numConstants = static_cast<UINT>((count * 4 + 15) & ~static_cast<size_t>(15));
+		if (cache.Changed(RenderStateSlot::VS_INSTANCE_CONSTANT_BUFFER, worldMatrixBuffer, worldMatrixChunkOffset, numConstants))
+		{
+			GFX_THROW_INFO_ONLY(context->VSSetConstantBuffers1(1u, 1u, &worldMatrixBuffer, &firstConstant, &numConstants));
+		}
+
+		const size_t instanceChunkOffset = instanceOffset + startIndex * sizeof(unsigned int);
+		if (cache.Changed(RenderStateSlot::IA_INSTANCE_BUFFER, instanceBuffer, instanceChunkOffset))
+		{
+			UINT strides[1] = { sizeof(unsigned int) };
+			UINT offsets[1] = { static_cast<UINT>(instanceChunkOffset) };
+			GFX_THROW_INFO_ONLY(context->IASetVertexBuffers(1u, 1u, &instanceBuffer, strides, offsets));
+		}
+
+		GFX_THROW_INFO_ONLY(
+			context->DrawIndexedInstanced(m_mesh.IndexCount, static_cast<UINT>(count), m_mesh.StartIndexLocation, m_mesh.BaseVertexLocation, 0u);
+		);
+	}
 }
\ No newline at end of file
@@ -5,29 +5,39 @@
 #include "../Utils/MathHelper.h"
 #include "MeshSet.h"
 #include "Structs.h"
+#include "FrustumCulling.h"
+#include "FrameUploadBuffer.h"
 
 
 class RenderObject
 {
 public:
 	RenderObject(const DirectX::XMFLOAT3& scaling, const DirectX::XMFLOAT3* translation, unsigned int materialIndex) :
+		RenderObject(scaling, translation, nullptr, materialIndex)
+	{}
+	// 'previousTranslation' is optional. When it is provided, the object is drawn at a position interpolated between 
+	// the previous and current translations (see RenderObjectList::Update)
+	RenderObject(const DirectX::XMFLOAT3& scaling, const DirectX::XMFLOAT3* translation, const DirectX::XMFLOAT3* previousTranslation, unsigned int materialIndex) :
 		m_scaling(scaling),
 		m_translation(translation),
+		m_previousTranslation(previousTranslation),
 		m_materialIndex(materialIndex)
 	{}
 	// Must implement copy constructor because it is required when stored in std::vector. See https://stackoverflow.com/questions/40457302/c-vector-emplace-back-calls-copy-constructor
 	RenderObject(const RenderObject&) noexcept = default;
 	~RenderObject() noexcept {};
 
-	ND inline DirectX::XMFLOAT4X4 WorldMatrix() const noexcept
+	ND inline DirectX::XMFLOAT4X4 WorldMatrix(float interpolationAlpha = 1.0f) const noexcept
 	{
 		using namespace DirectX;
 
+		XMFLOAT3 translation = Translation(interpolationAlpha);
+
 		DirectX::XMFLOAT4X4 world;
 		XMStoreFloat4x4(&world,
 			XMMatrixTranspose(
 				XMMatrixScaling(m_scaling.x, m_scaling.y, m_scaling.z) *
-				XMMatrixTranslation(m_translation->x, m_translation->y, m_translation->z)
+				XMMatrixTranslation(translation.x, translation.y, translation.z)
 			)
 		);
 		return world;
@@ -36,10 +46,24 @@ public:
 	{ 
 		return m_materialIndex; 
 	}
+	ND inline const DirectX::XMFLOAT3& Scaling() const noexcept { return m_scaling; }
+	ND inline const DirectX::XMFLOAT3& Translation() const noexcept { return *m_translation; }
+	ND inline DirectX::XMFLOAT3 Translation(float interpolationAlpha) const noexcept
+	{
+		if (m_previousTranslation == nullptr || interpolationAlpha >= 1.0f)
+			return *m_translation;
+
+		return {
+			m_previousTranslation->x + (m_translation->x - m_previousTranslation->x) * interpolationAlpha,
+			m_previousTranslation->y + (m_translation->y - m_previousTranslation->y) * interpolationAlpha,
+			m_previousTranslation->z + (m_translation->z - m_previousTranslation->z) * interpolationAlpha
+		};
+	}
 
 private:
 	DirectX::XMFLOAT3			m_scaling;
-	const DirectX::XMFLOAT3*	m_translation; // Hold a pointer to the translation data which should be managed elsewhere
+	const DirectX::XMFLOAT3*	m_translation;			// Hold a pointer to the translation data which should be managed elsewhere
+	const DirectX::XMFLOAT3*	m_previousTranslation;	// Translation as of the previous simulation step (may be nullptr)
 	unsigned int				m_materialIndex;
 };
 
@@ -52,32 +76,83 @@ public:
 	// Must implement copy constructor because it is required when stored in std::vector. See https://stackoverflow.com/questions/40457302/c-vector-emplace-back-calls-copy-constructor
 	RenderObjectList(const RenderObjectList&) noexcept = default;
 	
-	void Update(const Evergreen::Timer& timer) noexcept;
-	void Render() const;
+	// Rebuilds the world matrices (and bounding spheres) from the current translations. 'interpolationAlpha' is used to 
+	// blend between the previous and current translations of objects that track both (see MoleculesApp::OnUpdate)
+	void Update(float interpolationAlpha = 1.0f) noexcept;
+	void CullInstances(const FrustumPlanes& planes) noexcept;
+	// The instance buffers bound to VS/IA slot 1 go through 'cache' like the rest of the pipeline state
+	void Render(RenderStateCache& cache) const;
 
+	inline void ClearRenderObjects() noexcept
+	{
+		m_renderObjects.clear();
+		m_worldMatrices.clear();
+		m_materialIndices.clear();
+		m_sortMaterialId = MixedMaterials;
+	}
 	inline void AddRenderObject(const DirectX::XMFLOAT3& scaling, const DirectX::XMFLOAT3* translation, unsigned int materialIndex)
 	{
-		m_renderObjects.emplace_back(scaling, translation, materialIndex);
+		AddRenderObject(scaling, translation, nullptr, materialIndex);
+	}
+	inline void AddRenderObject(const DirectX::XMFLOAT3& scaling, const DirectX::XMFLOAT3* translation, const DirectX::XMFLOAT3* previousTranslation, unsigned int materialIndex)
+	{
+		m_renderObjects.emplace_back(scaling, translation, previousTranslation, materialIndex);
 		m_worldMatrices.push_back(m_renderObjects.back().WorldMatrix());
 		m_materialIndices.push_back(materialIndex);
+
+		if (m_renderObjects.size() == 1)
+			m_sortMaterialId = materialIndex;
+		else if (m_sortMaterialId != materialIndex)
+			m_sortMaterialId = MixedMaterials;
+	}
+	// When enabled, CullInstances() will test each render object's bounding sphere against the view frustum and
+	// only the visible instances will be uploaded/drawn. The bounding sphere radius for each object is computed as 
+	// meshBoundingRadius * (largest scaling component)
+	inline void EnableFrustumCulling(float meshBoundingRadius) noexcept
+	{
+		m_frustumCullingEnabled = true;
+		m_meshBoundingRadius = meshBoundingRadius;
+	}
+	inline void DisableFrustumCulling() noexcept { m_frustumCullingEnabled = false; }
+
+	// When set, Render() writes the instance data for the whole list into these per-frame rings (world matrices into
+	// 'worldMatrixBuffer', which is bound to VS slot 1, and material indices into 'instanceBuffer', which is bound to IA
+	// slot 1) and then points each draw at its offset. Otherwise, the buffer update callback is responsible for the uploads
+	inline void SetUploadBuffers(FrameUploadBuffer* worldMatrixBuffer, FrameUploadBuffer* instanceBuffer) noexcept
+	{
+		EG_ASSERT((worldMatrixBuffer == nullptr) == (instanceBuffer == nullptr), "Either both or neither upload buffers must be set");
+		m_worldMatrixUploadBuffer = worldMatrixBuffer;
+		m_instanceUploadBuffer = instanceBuffer;
 	}
 	inline void SetBufferUpdateCallback(std::function<void(const RenderObjectList*, size_t, size_t)> fn) noexcept 
 	{ 
 		m_bufferUpdateFn = fn; 
 	}
 
+	// Material id of the RenderQueue sort key: the material shared by every render object in the list, or MixedMaterials
+	// if the list uses more than one (materials are looked up per-instance, so these lists sort after the others)
+	ND inline std::uint32_t SortMaterialId() const noexcept { return m_sortMaterialId; }
+	static constexpr std::uint32_t MixedMaterials = UINT32_MAX;
+
 	ND inline std::shared_ptr<Evergreen::DeviceResources> GetDeviceResources() const noexcept { return m_deviceResources; }
 	ND inline const std::vector<DirectX::XMFLOAT4X4>& GetWorldMatrices() const noexcept { return m_worldMatrices; }
 	ND inline const std::vector<unsigned int>& GetMaterialIndices() const noexcept { return m_materialIndices; }
-	ND inline Microsoft::WRL::ComPtr<ID3D11Buffer> GetInstanceBuffer() const noexcept { return m_instanceBuffer; }
+
+	// The instance stream is what actually gets uploaded to the GPU. When frustum culling is enabled, it only 
+	// contains the visible instances (compacted), otherwise it is the same as the full world matrix/material lists
+	ND inline const std::vector<DirectX::XMFLOAT4X4>& GetInstanceWorldMatrices() const noexcept { return m_frustumCullingEnabled ? m_visibleWorldMatrices : m_worldMatrices; }
+	ND inline const std::vector<unsigned int>& GetInstanceMaterialIndices() const noexcept { return m_frustumCullingEnabled ? m_visibleMaterialIndices : m_materialIndices; }
 
 private:
+	void RenderFromUploadBuffers(size_t instanceCount, RenderStateCache& cache) const;
+
 	std::shared_ptr<Evergreen::DeviceResources> m_deviceResources;
 
 	MeshInstance m_mesh;
 
-	// Right now, each instance just requires an index into the materials array
-	Microsoft::WRL::ComPtr<ID3D11Buffer> m_instanceBuffer;
+	// Per-frame upload rings (owned by the Scene). Right now, each instance just requires a world matrix and an index into the materials array
+	FrameUploadBuffer* m_worldMatrixUploadBuffer = nullptr;
+	FrameUploadBuffer* m_instanceUploadBuffer = nullptr;
 
 	std::function<void(const RenderObjectList*, size_t, size_t)> m_bufferUpdateFn = [](const RenderObjectList*, size_t, size_t) {};
 
@@ -85,4 +160,16 @@ private:
 	std::vector<RenderObject> m_renderObjects;
 	std::vector<DirectX::XMFLOAT4X4> m_worldMatrices;
 	std::vector<unsigned int> m_materialIndices;
+	std::uint32_t m_sortMaterialId = MixedMaterials;
+
+	// Frustum culling - bounding spheres are stored as structure-of-arrays so they can be tested 8 at a time
+	bool m_frustumCullingEnabled = false;
+	float m_meshBoundingRadius = 1.0f;
+	std::vector<float> m_boundsX;
+	std::vector<float> m_boundsY;
+	std::vector<float> m_boundsZ;
+	std::vector<float> m_boundsRadius;
+	std::vector<uint32_t> m_visibleIndices;
+	std::vector<DirectX::XMFLOAT4X4> m_visibleWorldMatrices;
+	std::vector<unsigned int> m_visibleMaterialIndices;
 };
\ No newline at end of file
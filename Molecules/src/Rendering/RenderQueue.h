@@ -0,0 +1,47 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// NOTE: This file has no Windows/DirectX dependencies.
+
+// A list of draws that is sorted by a 64-bit key before submission so that draws sharing the same pipeline
+// state end up next to each other (which allows the RenderStateCache to skip most of the bind calls).
+//
+// Key layout (most significant bits first):
+//		[63 - 48] pipeline config id
+//		[47 - 32] mesh set id
+//		[31 -  0] material id
+class RenderQueue
+{
+public:
+	struct DrawItem
+	{
+		std::uint64_t Key;
+		std::uint32_t Payload;	// Opaque to the queue - the submitter uses this to find the draw (ex. an index into its own list)
+	};
+
+	[[nodiscard]] static constexpr std::uint64_t MakeKey(std::uint16_t pipelineId, std::uint16_t meshSetId, std::uint32_t materialId) noexcept
+	{
+		return (static_cast<std::uint64_t>(pipelineId) << 48) | (static_cast<std::uint64_t>(meshSetId) << 32) | materialId;
+	}
+	[[nodiscard]] static constexpr std::uint16_t PipelineId(std::uint64_t key) noexcept { return static_cast<std::uint16_t>(key >> 48); }
+	[[nodiscard]] static constexpr std::uint16_t MeshSetId(std::uint64_t key) noexcept { return static_cast<std::uint16_t>(key >> 32); }
+	[[nodiscard]] static constexpr std::uint32_t MaterialId(std::uint64_t key) noexcept { return static_cast<std::uint32_t>(key); }
+
+	inline void Clear() noexcept { m_items.clear(); }
+	inline void Submit(std::uint64_t key, std::uint32_t payload) { m_items.push_back({ key, payload }); }
+
+	// Stable so that draws with identical keys are submitted in the order they were added
+	inline void Sort()
+	{
+		std::stable_sort(m_items.begin(), m_items.end(), [](const DrawItem& lhs, const DrawItem& rhs) { return lhs.Key < rhs.Key; });
+	}
+
+	[[nodiscard]] inline const std::vector<DrawItem>& Items() const noexcept { return m_items; }
+	[[nodiscard]] inline size_t Size() const noexcept { return m_items.size(); }
+
+private:
+	std::vector<DrawItem> m_items;
+};
@@ -0,0 +1,95 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// NOTE: This file has no Windows/DirectX dependencies. The cache only compares opaque pointers, it is up
+//       to the caller (PipelineConfig, MeshSetBase) to issue the actual device context call when a slot changes.
+
+enum class RenderStateSlot
+{
+	VERTEX_SHADER = 0,
+	PIXEL_SHADER,
+	INPUT_LAYOUT,
+	PRIMITIVE_TOPOLOGY,
+	RASTERIZER_STATE,
+	BLEND_STATE,
+	DEPTH_STENCIL_STATE,
+	VS_CONSTANT_BUFFERS,
+	PS_CONSTANT_BUFFERS,
+	IA_VERTEX_BUFFER,
+	IA_INDEX_BUFFER,
+	VS_INSTANCE_CONSTANT_BUFFER,	// VS slot 1 - world matrices sub-allocated from the upload ring (buffer + offset + size)
+	IA_INSTANCE_BUFFER,				// IA slot 1 - per-instance data sub-allocated from the upload ring (buffer + offset)
+	COUNT
+};
+
+// Tracks what is currently bound to each pipeline slot so that redundant bind calls can be skipped
+class RenderStateCache
+{
+public:
+	struct Stats
+	{
+		unsigned int BindsIssued = 0;
+		unsigned int BindsSkipped = 0;
+	};
+
+	RenderStateCache() noexcept { Invalidate(); }
+	RenderStateCache(const RenderStateCache&) = delete;
+	RenderStateCache& operator=(const RenderStateCache&) = delete;
+
+	// Returns true if 'value' differs from what is currently bound to 'slot' (in which case the caller MUST
+	// bind it) and records 'value' as bound. Returns false if the bind call can be skipped.
+	inline bool Changed(RenderStateSlot slot, const void* value) noexcept
+	{
+		return Changed(slot, reinterpret_cast<std::uintptr_t>(value));
+	}
+	inline bool Changed(RenderStateSlot slot, std::uintptr_t value) noexcept
+	{
+		return Changed(slot, value, 0u);
+	}
+	// Same as above, but for slots that are bound at an offset into a buffer (ex. sub-allocations from an upload
+	// ring). The slot only matches when the buffer, the offset and the size of the bound range all match. 'size' can
+	// be left at 0 for binds that do not specify a range (ex. vertex buffers)
+	inline bool Changed(RenderStateSlot slot, const void* value, std::size_t offset, std::size_t size = 0u) noexcept
+	{
+		return Changed(slot, reinterpret_cast<std::uintptr_t>(value), offset, size);
+	}
+	inline bool Changed(RenderStateSlot slot, std::uintptr_t value, std::size_t offset, std::size_t size = 0u) noexcept
+	{
+		const size_t index = static_cast<size_t>(slot);
+		if (m_valid[index] && m_bound[index] == value && m_boundOffset[index] == offset && m_boundSize[index] == size)
+		{
+			++m_stats.BindsSkipped;
+			return false;
+		}
+
+		m_bound[index] = value;
+		m_boundOffset[index] = offset;
+		m_boundSize[index] = size;
+		m_valid[index] = true;
+		++m_stats.BindsIssued;
+		return true;
+	}
+
+	// Forget everything that is bound. This must be called whenever something outside of the cache may have
+	// changed the pipeline state (for example, if the device context was re-created)
+	inline void Invalidate() noexcept
+	{
+		m_valid.fill(false);
+		m_bound.fill(0);
+		m_boundOffset.fill(0);
+		m_boundSize.fill(0);
+	}
+	inline void Invalidate(RenderStateSlot slot) noexcept { m_valid[static_cast<size_t>(slot)] = false; }
+
+	inline void ResetStats() noexcept { m_stats = {}; }
+	[[nodiscard]] inline const Stats& GetStats() const noexcept { return m_stats; }
+
+private:
+	std::array<std::uintptr_t, static_cast<size_t>(RenderStateSlot::COUNT)> m_bound;
+	std::array<std::size_t, static_cast<size_t>(RenderStateSlot::COUNT)> m_boundOffset;
+	std::array<std::size_t, static_cast<size_t>(RenderStateSlot::COUNT)> m_boundSize;
+	std::array<bool, static_cast<size_t>(RenderStateSlot::COUNT)> m_valid;
+	Stats m_stats;
+};
@@ -23,6 +23,10 @@ Scene::Scene(std::shared_ptr<DeviceResources> deviceResources, Simulation* simul
 	m_materials = std::make_unique<MaterialsArray>();
 	CreateMaterials();
 
+	// Per-frame upload rings for instance data. These will grow if needed, but start large enough for a few frames of MAX_INSTANCES instances
+	m_worldMatrixUploadBuffer = std::make_unique<FrameUploadBuffer>(m_deviceResources, D3D11_BIND_CONSTANT_BUFFER, 4 * sizeof(WorldMatrixInstances));
+	m_instanceUploadBuffer = std::make_unique<FrameUploadBuffer>(m_deviceResources, D3D11_BIND_VERTEX_BUFFER, 4 * MAX_INSTANCES * sizeof(unsigned int));
+
 	CreateMainPipelineConfig();
 	CreateBoxPipelineConfig();
 }
@@ -282,11 +286,8 @@ void Scene::CreateMainPipelineConfig()
 	m_vsPerPassConstantsBuffers.push_back(vsPassConstantsBuffer); // The Scene must keep track of this buffer because it is responsible for updating it
 	vsCBA->AddBuffer(vsPassConstantsBuffer);
 
-	// Buffer #2: WorldMatrixInstances - Will be updated by each RenderObjectList before each Draw call
-	std::shared_ptr<ConstantBuffer> vsWorldMatrixInstancesBuffer = std::make_shared<ConstantBuffer>(m_deviceResources);
-	vsWorldMatrixInstancesBuffer->CreateBuffer<WorldMatrixInstances>(D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE, 0u, 0u);
-
-	vsCBA->AddBuffer(vsWorldMatrixInstancesBuffer);
+	// NOTE: WorldMatrixInstances (VS slot 1) is not part of the array - each RenderObjectList sub-allocates its world
+	//       matrices from m_worldMatrixUploadBuffer and binds them at the right offset right before it draws
 
 	// PS Buffers --------------
 	std::unique_ptr<ConstantBufferArray> psCBA = std::make_unique<ConstantBufferArray>(m_deviceResources);
@@ -336,12 +337,27 @@ void Scene::CreateMainPipelineConfig()
 	ms->Finalize();
 
 	// RenderObjectLists ----------------------------------------------------------------------------
-	std::vector<DirectX::XMFLOAT3>& positions = m_simulation->Positions();
-	//std::vector<DirectX::XMFLOAT3>& velocities = m_simulation->Velocities(); Not needed right now
-	std::vector<Element>& elementTypes = m_simulation->ElementTypes();
-
 	std::vector<RenderObjectList> objectLists;
 	objectLists.emplace_back(m_deviceResources, mi);
+	PopulateAtomRenderObjects(objectLists.back());
+
+	// The geosphere has a radius of 1, so the bounding sphere radius is just the atomic radius (the scaling)
+	objectLists.back().EnableFrustumCulling(1.0f);
+
+	objectLists.back().SetUploadBuffers(m_worldMatrixUploadBuffer.get(), m_instanceUploadBuffer.get());
+
+	m_atomConfigIndex = m_configsAndObjectLists.size();
+	m_atomOrderVersion = m_simulation->AtomOrderVersion();
+	m_configsAndObjectLists.push_back(std::make_tuple(std::move(config), std::move(ms), objectLists));
+}
+void Scene::PopulateAtomRenderObjects(RenderObjectList& objectList)
+{
+	SimulationVector<DirectX::XMFLOAT3>& positions = m_simulation->Positions();
+	SimulationVector<DirectX::XMFLOAT3>& previousPositions = m_simulation->PreviousPositions();
+	//SimulationVector<DirectX::XMFLOAT3>& velocities = m_simulation->Velocities(); Not needed right now
+	SimulationVector<Element>& elementTypes = m_simulation->ElementTypes();
+
+	objectList.ClearRenderObjects();
 
 	float r;
 	unsigned int elementType;
@@ -349,51 +365,10 @@ void Scene::CreateMainPipelineConfig()
 	{
 		elementType = static_cast<int>(elementTypes[iii]);
 		r = AtomicRadii[elementType];
-		objectLists.back().AddRenderObject({ r, r, r }, &positions.data()[iii], elementType - 1); // must subtract one because Hydrogen is 1, but its material is at index 0, etc.
+		objectList.AddRenderObject({ r, r, r }, &positions.data()[iii], &previousPositions.data()[iii], elementType - 1); // must subtract one because Hydrogen is 1, but its material is at index 0, etc.
 	}
-
-	objectLists.back().SetBufferUpdateCallback([](const RenderObjectList* renderObjectList, size_t startIndex, size_t endIndex)
-		{
-			using Microsoft::WRL::ComPtr;
-
-			auto context = renderObjectList->GetDeviceResources()->D3DDeviceContext();
-
-			const std::vector<DirectX::XMFLOAT4X4>& worldMatrices = renderObjectList->GetWorldMatrices();
-			const std::vector<unsigned int>& materialIndices = renderObjectList->GetMaterialIndices();
-
-			D3D11_MAPPED_SUBRESOURCE ms; 
-
-			// Update the World buffers at VS slot 1 ------------------------------------------------------
-			ZeroMemory(&ms, sizeof(D3D11_MAPPED_SUBRESOURCE)); 
-			ComPtr<ID3D11Buffer> buffer = nullptr; 
-
-			GFX_THROW_INFO_ONLY(context->VSGetConstantBuffers(1, 1, buffer.ReleaseAndGetAddressOf())); 
-			GFX_THROW_INFO(context->Map(buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &ms));
-			// Only copy the elements between the start and end indices
-			memcpy(ms.pData, &worldMatrices.data()[startIndex], sizeof(XMFLOAT4X4) * (endIndex - startIndex + 1));
-			GFX_THROW_INFO_ONLY(context->Unmap(buffer.Get(), 0)); 
-
-			// --------------------------------------------------------------------------------------------
-			// Update the instance buffer and then bind it to the IA
-
-			Microsoft::WRL::ComPtr<ID3D11Buffer> instanceBuffer = renderObjectList->GetInstanceBuffer();
-
-			ZeroMemory(&ms, sizeof(D3D11_MAPPED_SUBRESOURCE)); 
-
-			GFX_THROW_INFO(context->Map(instanceBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &ms)); 
-			// Only copy the elements between the start and end indices
-			memcpy(ms.pData, &materialIndices.data()[startIndex], sizeof(unsigned int) * (endIndex - startIndex + 1));
-			GFX_THROW_INFO_ONLY(context->Unmap(instanceBuffer.Get(), 0)); 
-
-			UINT strides[1] = { sizeof(unsigned int) }; 
-			UINT offsets[1] = { 0u }; 
-			ID3D11Buffer* vertInstBuffers[1] = { instanceBuffer.Get() }; 
-			GFX_THROW_INFO_ONLY(context->IASetVertexBuffers(1u, 1u, vertInstBuffers, strides, offsets)); 
-		}
-	);
-
-	m_configsAndObjectLists.push_back(std::make_tuple(std::move(config), std::move(ms), objectLists));
 }
+
 void Scene::CreateBoxPipelineConfig()
 {
 	// Shaders
@@ -452,13 +427,8 @@ void Scene::CreateBoxPipelineConfig()
 	std::unique_ptr<DepthStencilState> dss = std::make_unique<DepthStencilState>(m_deviceResources, depthStencilDesc);
 
 	// VS Buffers --------------
-	std::unique_ptr<ConstantBufferArray> vsCBA = std::make_unique<ConstantBufferArray>(m_deviceResources);
-
-	// Buffer #1: WorldViewProjection - Will be updated by Scene once per frame
-	std::shared_ptr<ConstantBuffer> vsWorldViewProjectionBuffer = std::make_shared<ConstantBuffer>(m_deviceResources);
-	vsWorldViewProjectionBuffer->CreateBuffer<WorldViewProjectionMatrix>(D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE, 0u, 0u);
-
-	vsCBA->AddBuffer(vsWorldViewProjectionBuffer);
+	// NOTE: The WorldViewProjection matrix (VS slot 0) is not part of a ConstantBufferArray - the buffer update callback
+	//       below sub-allocates it from m_worldMatrixUploadBuffer and binds it at the right offset right before the box is drawn
 
 	// Pipeline Configuration 
 	std::unique_ptr<PipelineConfig> config = std::make_unique<PipelineConfig>(m_deviceResources,
@@ -468,7 +438,7 @@ void Scene::CreateBoxPipelineConfig()
 		std::move(rs),
 		std::move(bs),
 		std::move(dss),
-		std::move(vsCBA),
+		nullptr,
 		nullptr
 	);
 	config->SetTopology(D3D11_PRIMITIVE_TOPOLOGY::D3D10_PRIMITIVE_TOPOLOGY_LINELIST);
@@ -534,7 +504,6 @@ void Scene::CreateBoxPipelineConfig()
 	objectLists.back().AddRenderObject(scaling, translation, 0u);
 	objectLists.back().SetBufferUpdateCallback([this](const RenderObjectList* renderObjectList, size_t startIndex, size_t endIndex)
 		{
-			using Microsoft::WRL::ComPtr;
 			using namespace DirectX;
 
 			Camera* camera = this->GetCamera();
@@ -543,19 +512,23 @@ void Scene::CreateBoxPipelineConfig()
 			const std::vector<DirectX::XMFLOAT4X4>& worldMatrices = renderObjectList->GetWorldMatrices();
 			EG_ASSERT(worldMatrices.size() == 1, "There should be exactly 1 world matrix for 1 simulation box");
 
-			XMMATRIX worldViewProjection = XMMatrixTranspose(XMLoadFloat4x4(&worldMatrices[0]) * viewProj);
+			WorldViewProjectionMatrix worldViewProjection;
+			XMStoreFloat4x4(&worldViewProjection.worldViewProjection, XMMatrixTranspose(XMLoadFloat4x4(&worldMatrices[0]) * viewProj));
 
 			auto context = renderObjectList->GetDeviceResources()->D3DDeviceContext();
-			D3D11_MAPPED_SUBRESOURCE ms; 
 
-			// Update the World-View-Projection buffer at VS slot 0 ------------------------------------------------------
-			ZeroMemory(&ms, sizeof(D3D11_MAPPED_SUBRESOURCE)); 
-			ComPtr<ID3D11Buffer> buffer = nullptr;  
+			// Upload the World-View-Projection matrix to the constant buffer ring and bind it to VS slot 0 -----------------
+			// NOTE: The bind is tracked under the same cache slot as the ConstantBufferArrays (which also start at VS slot 0),
+			//       so the next config that binds its own array sees that slot 0 changed
+			size_t offset = this->m_worldMatrixUploadBuffer->Upload(&worldViewProjection, sizeof(WorldViewProjectionMatrix), FrameUploadBuffer::ConstantBufferAlignment);
+			ID3D11Buffer* buffer = this->m_worldMatrixUploadBuffer->Get();
 
-			GFX_THROW_INFO_ONLY(context->VSGetConstantBuffers(0, 1, buffer.ReleaseAndGetAddressOf())); 
-			GFX_THROW_INFO(context->Map(buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &ms)); 
-			memcpy(ms.pData, &worldViewProjection, sizeof(XMMATRIX)); 
-			GFX_THROW_INFO_ONLY(context->Unmap(buffer.Get(), 0));
+			if (this->m_renderStateCache.Changed(RenderStateSlot::VS_CONSTANT_BUFFERS, buffer, offset))
+			{
+				UINT firstConstant = static_cast<UINT>(offset / 16);
+				UINT numConstants = 16u; // Constant buffer views must cover a multiple of 16 constants (one matrix is only 4)
+				GFX_THROW_INFO_ONLY(context->VSSetConstantBuffers1(0u, 1u, &buffer, &firstConstant, &numConstants));
+			}
 		}
 	);
 
@@ -618,39 +591,158 @@ void Scene::Update(const Timer& timer)
 	memcpy(ms.pData, &m_passConstants, sizeof(PassConstants));
 	GFX_THROW_INFO_ONLY(context->Unmap(m_psPerPassConstantsBuffers[0]->GetRawBufferPointer(), 0));
 
-	// Update all render object lists
+	// Atoms have moved, so the picking BVH will need to be refit before it is used again
+	m_atomBVHNeedsRefit = true;
+
+	// If the simulation reordered its atoms, each render object now points at a different atom (whose element may
+	// differ), so re-create them. The picking BVH also needs to be rebuilt (clearing the radii forces a full build)
+	if (m_atomOrderVersion != m_simulation->AtomOrderVersion())
+	{
+		m_atomOrderVersion = m_simulation->AtomOrderVersion();
+		PopulateAtomRenderObjects(std::get<2>(m_configsAndObjectLists[m_atomConfigIndex])[0]);
+		m_atomRadii.clear();
+	}
+
+	// Extract the view frustum so each render object list can cull its instances
+	XMFLOAT4X4 viewProjFloats;
+	DirectX::XMStoreFloat4x4(&viewProjFloats, viewProj);
+	m_frustum = ExtractFrustumPlanes(&viewProjFloats.m[0][0]);
+}
+
+void Scene::Render(float interpolationAlpha)
+{
+	// Picking has to hit the atoms where they are drawn, so the BVH follows the interpolated positions too
+	if (interpolationAlpha != m_pickingInterpolationAlpha)
+	{
+		m_pickingInterpolationAlpha = interpolationAlpha;
+		m_atomBVHNeedsRefit = true;
+	}
+
+	// Update all render object lists. This is done here rather than in Update() because the instances need to be rebuilt
+	// at the interpolated positions, which change every frame even when the simulation did not step
 	for (auto& configAndObjectList : m_configsAndObjectLists)
 	{
 		std::vector<RenderObjectList>& objectLists = std::get<2>(configAndObjectList);
 		for (unsigned int iii = 0; iii < objectLists.size(); ++iii)
 		{
-			objectLists[iii].Update(timer);
+			objectLists[iii].Update(interpolationAlpha);
+			objectLists[iii].CullInstances(m_frustum);
 		}
 	}
-}
 
-void Scene::Render()
-{
+	// Everything that binds pipeline state goes through the cache, so whatever was bound last frame is still bound. Direct2D
+	// shares the device, but it saves and restores the Direct3D pipeline state around its own drawing. The only other way
+	// the bound state can be lost is if the device (and therefore the context) was re-created
 	auto context = m_deviceResources->D3DDeviceContext();
+	if (m_renderStateContext != context)
+	{
+		m_renderStateContext = context;
+		m_renderStateCache.Invalidate();
+	}
+	m_renderStateCache.ResetStats();
 
-	// Apply the pipeline config for each list of render objects, render each object, then move onto the next config
-	for (auto& configAndObjectList : m_configsAndObjectLists)
+	// Reclaim the upload space of any frames the GPU has finished with
+	m_worldMatrixUploadBuffer->BeginFrame();
+	m_instanceUploadBuffer->BeginFrame();
+
+	// Queue up one draw per render object list, keyed on the ids of the pipeline config and mesh set it uses and on the
+	// list's material so that draws that share state end up next to each other. The payload packs the (config, list) indices
+	m_renderQueue.Clear();
+	for (size_t configIndex = 0; configIndex < m_configsAndObjectLists.size(); ++configIndex)
 	{
-		std::unique_ptr<PipelineConfig>& config = std::get<0>(configAndObjectList);
-		config->ApplyConfig();
+		EG_ASSERT(configIndex <= UINT16_MAX, "Too many pipeline configs to fit in the payload");
 
-		std::unique_ptr<MeshSetBase>& ms = std::get<1>(configAndObjectList);
-		ms->BindToIA();
+		const std::uint16_t pipelineId = std::get<0>(m_configsAndObjectLists[configIndex])->SortId();
+		const std::uint16_t meshSetId = std::get<1>(m_configsAndObjectLists[configIndex])->SortId();
 
-		std::vector<RenderObjectList>& objectLists = std::get<2>(configAndObjectList);
-		for (unsigned int iii = 0; iii < objectLists.size(); ++iii)
+		std::vector<RenderObjectList>& objectLists = std::get<2>(m_configsAndObjectLists[configIndex]);
+		for (size_t listIndex = 0; listIndex < objectLists.size(); ++listIndex)
 		{
-			objectLists[iii].Render();
+			EG_ASSERT(listIndex <= UINT16_MAX, "Too many render object lists to fit in the payload");
+
+			m_renderQueue.Submit(
+				RenderQueue::MakeKey(pipelineId, meshSetId, objectLists[listIndex].SortMaterialId()),
+				static_cast<std::uint32_t>((configIndex << 16) | listIndex)
+			);
 		}
 	}
+	m_renderQueue.Sort();
+
+	// Apply the pipeline config for each draw (only the state that changed is actually bound), then render the list
+	for (const RenderQueue::DrawItem& item : m_renderQueue.Items())
+	{
+		PipelineConfigAndObjectList& configAndObjectList = m_configsAndObjectLists[item.Payload >> 16];
+
+		std::unique_ptr<PipelineConfig>& config = std::get<0>(configAndObjectList);
+		config->ApplyConfig(m_renderStateCache);
+
+		std::unique_ptr<MeshSetBase>& ms = std::get<1>(configAndObjectList);
+		ms->BindToIA(m_renderStateCache);
+
+		std::get<2>(configAndObjectList)[item.Payload & 0xFFFF].Render(m_renderStateCache);
+	}
+
+	m_worldMatrixUploadBuffer->EndFrame();
+	m_instanceUploadBuffer->EndFrame();
 }
 
 
+void Scene::UpdatePickingBVH()
+{
+	SimulationVector<XMFLOAT3>& positions = m_simulation->Positions();
+	SimulationVector<XMFLOAT3>& previousPositions = m_simulation->PreviousPositions();
+	SimulationVector<Element>& elementTypes = m_simulation->ElementTypes();
+
+	// Same interpolation as RenderObject::WorldMatrix, so the rays are tested against the positions that were last drawn
+	// NOTE: m_pickingPositions is only resized when the atom count changes, which also rebuilds the tree, so the BVH
+	//       never points into a stale allocation
+	const float alpha = m_pickingInterpolationAlpha;
+	m_pickingPositions.resize(positions.size());
+	for (size_t iii = 0; iii < positions.size(); ++iii)
+	{
+		if (alpha >= 1.0f)
+			m_pickingPositions[iii] = positions[iii];
+		else
+			m_pickingPositions[iii] = {
+				previousPositions[iii].x + (positions[iii].x - previousPositions[iii].x) * alpha,
+				previousPositions[iii].y + (positions[iii].y - previousPositions[iii].y) * alpha,
+				previousPositions[iii].z + (positions[iii].z - previousPositions[iii].z) * alpha
+			};
+	}
+	const float* positionData = reinterpret_cast<const float*>(m_pickingPositions.data());
+
+	// Only rebuild the tree if atoms have been added/removed, otherwise just refit the existing tree
+	if (m_atomBVH.SphereCount() != positions.size() || m_atomRadii.size() != positions.size())
+	{
+		m_atomRadii.resize(elementTypes.size());
+		for (unsigned int iii = 0; iii < elementTypes.size(); ++iii)
+			m_atomRadii[iii] = AtomicRadii[static_cast<int>(elementTypes[iii])];
+
+		m_atomBVH.Build(positionData, m_atomRadii.data(), positions.size());
+	}
+	else
+	{
+		m_atomBVH.Refit(positionData, m_atomRadii.data());
+	}
+
+	m_atomBVHNeedsRefit = false;
+}
+std::optional<unsigned int> Scene::Pick(float x, float y)
+{
+	if (m_atomBVHNeedsRefit)
+		UpdatePickingBVH();
+
+	XMFLOAT3 origin, direction;
+	m_camera->ScreenPointToRay(x, y, origin, direction);
+
+	AtomBVH::RayHit hit = m_atomBVH.Raycast(&origin.x, &direction.x);
+	if (hit.index == AtomBVH::InvalidIndex)
+		return std::nullopt;
+
+	// The BVH works with indices into the simulation arrays, which change when the simulation reorders its atoms
+	return m_simulation->AtomId(hit.index);
+}
+
 void Scene::OnChar(CharEvent& e)
 {
 	m_camera->OnChar(e.GetKeyCode());
@@ -669,11 +761,12 @@ void Scene::OnMouseEntered(MouseMoveEvent& e)
 }
 void Scene::OnMouseExited(MouseMoveEvent& e)
 {
-
+	m_hoveredAtom = std::nullopt;
 }
 void Scene::OnMouseMoved(MouseMoveEvent& e)
 {
 	m_camera->OnMouseMove(e.GetX(), e.GetY());
+	m_hoveredAtom = Pick(e.GetX(), e.GetY());
 }
 void Scene::OnMouseScrolledVertical(MouseScrolledEvent& e)
 {
@@ -715,7 +808,8 @@ void Scene::OnMouseButtonReleased(MouseButtonReleasedEvent& e)
 }
 void Scene::OnClick(MouseButtonReleasedEvent& e)
 {
-
+	if (e.GetMouseButton() == MOUSE_BUTTON::EG_LBUTTON)
+		m_selectedAtom = Pick(e.GetX(), e.GetY());
 }
 void Scene::OnDoubleClick(MouseButtonDoubleClickEvent& e)
 {
@@ -13,6 +13,10 @@
 #include "RasterizerState.h"
 #include "BlendState.h"
 #include "DepthStencilState.h"
+#include "AtomBVH.h"
+#include "RenderStateCache.h"
+#include "RenderQueue.h"
+#include "FrameUploadBuffer.h"
 
 class Scene
 {
@@ -21,7 +25,8 @@ class Scene
 public:
 	Scene(std::shared_ptr<Evergreen::DeviceResources> deviceResources, Simulation* simulation, Evergreen::Viewport* viewport);
 	void Update(const Evergreen::Timer& timer);
-	void Render();
+	// 'interpolationAlpha' blends atom positions between the previous and current simulation steps (see MoleculesApp::OnUpdate)
+	void Render(float interpolationAlpha = 1.0f);
 
 	// Event handlers
 	void OnChar(Evergreen::CharEvent& e);
@@ -37,8 +42,17 @@ public:
 	void OnClick(Evergreen::MouseButtonReleasedEvent& e);
 	void OnDoubleClick(Evergreen::MouseButtonDoubleClickEvent& e);
 
+	// Ray pick the atom under the point (x, y) in window coordinates. Returns the id of the nearest atom (see
+	// Simulation::AtomId/IndexOfAtom) or std::nullopt if no atom is under the point
+	ND std::optional<unsigned int> Pick(float x, float y);
+	ND inline std::optional<unsigned int> HoveredAtom() const noexcept { return m_hoveredAtom; }
+	ND inline std::optional<unsigned int> SelectedAtom() const noexcept { return m_selectedAtom; }
+
 	Camera* GetCamera() const noexcept { return m_camera.get(); }
 
+	// Number of pipeline bind calls that were issued/skipped during the most recent call to Render()
+	ND inline const RenderStateCache::Stats& GetRenderStateStats() const noexcept { return m_renderStateCache.GetStats(); }
+
 	MaterialsArray* GetMaterials() noexcept { return m_materials.get(); }
 	inline void UpdateMaterials()
 	{
@@ -50,6 +64,8 @@ private:
 	void CreateBoxPipelineConfig();
 	void CreateMaterials();
 	void LoadDefaultMaterials();
+	void UpdatePickingBVH();
+	void PopulateAtomRenderObjects(RenderObjectList& objectList);
 
 	std::shared_ptr<Evergreen::DeviceResources> m_deviceResources;
 	Simulation* m_simulation;
@@ -57,6 +73,25 @@ private:
 
 	std::vector<PipelineConfigAndObjectList> m_configsAndObjectLists;
 
+	// The atoms are drawn by the first RenderObjectList of this config. It is re-populated whenever the
+	// simulation reorders its atoms
+	size_t m_atomConfigIndex = 0;
+	unsigned int m_atomOrderVersion = 0;
+
+	// Draws are sorted by (pipeline, mesh set, material) each frame and all binds go through the state cache
+	// so that state that is already bound is not bound again
+	RenderQueue m_renderQueue;
+	RenderStateCache m_renderStateCache;
+	// Context the cached state was bound to. The cache is only invalidated if this changes (ie. the device was re-created)
+	const void* m_renderStateContext = nullptr;
+
+	// View frustum as of the most recent Update(), used to cull each render object list when it is rebuilt in Render()
+	FrustumPlanes m_frustum = {};
+
+	// Instance data (world matrices and material indices) for every RenderObjectList is sub-allocated from these each frame
+	std::unique_ptr<FrameUploadBuffer> m_worldMatrixUploadBuffer;
+	std::unique_ptr<FrameUploadBuffer> m_instanceUploadBuffer;
+
 	// Pass Constants that will be updated/bound only once per pass
 	// NOTE: the ConstantBuffer is a shared_ptr so that it can be shared with EVERY PipelineConfig
 	PassConstants m_passConstants;
@@ -68,4 +103,15 @@ private:
 	// Materials
 	std::shared_ptr<ConstantBuffer> m_materialsBuffer;
 	std::unique_ptr<MaterialsArray> m_materials;
+
+	// Picking - The BVH is built once and then refit lazily (at most once per Update or change of interpolation alpha) the
+	// first time it is needed. It is built over m_pickingPositions, the atom positions interpolated the same way they were
+	// last rendered
+	AtomBVH m_atomBVH;
+	std::vector<float> m_atomRadii;
+	std::vector<DirectX::XMFLOAT3> m_pickingPositions;
+	float m_pickingInterpolationAlpha = 1.0f;
+	bool m_atomBVHNeedsRefit = true;
+	std::optional<unsigned int> m_hoveredAtom = std::nullopt;
+	std::optional<unsigned int> m_selectedAtom = std::nullopt;
 };
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "UploadRingAllocator.h"
+
+static inline size_t AlignUp(size_t value, size_t alignment) noexcept
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+UploadRingAllocator::UploadRingAllocator(size_t capacity) noexcept :
+	m_capacity(capacity),
+	m_head(0),
+	m_tail(0),
+	m_used(0),
+	m_currentFrameBytes(0)
+{}
+
+size_t UploadRingAllocator::Allocate(size_t size, size_t alignment) noexcept
+{
+	if (size == 0 || size > m_capacity)
+		return InvalidOffset;
+
+	// When the ring is empty (and no in-flight frame still refers to an offset), start over from the beginning
+	// so we do not have to wrap unnecessarily
+	if (m_used == 0 && m_frames.empty())
+		m_head = m_tail = 0;
+
+	size_t offset = AlignUp(m_head, alignment);
+
+	if (m_used == 0 || m_head > m_tail)
+	{
+		// Free space is [head, capacity) followed by [0, tail)
+		if (offset + size <= m_capacity)
+		{
+			size_t consumed = offset + size - m_head;
+			m_head = offset + size;
+			m_used += consumed;
+			m_currentFrameBytes += consumed;
+			return offset;
+		}
+
+		// Does not fit at the end - skip the rest of the buffer and try at the front
+		if (m_used == 0 || size <= m_tail)
+		{
+			size_t consumed = (m_capacity - m_head) + size;
+			m_head = size;
+			m_used += consumed;
+			m_currentFrameBytes += consumed;
+			return 0;
+		}
+
+		return InvalidOffset;
+	}
+
+	// head <= tail with data in flight: free space is [head, tail)
+	if (offset + size <= m_tail)
+	{
+		size_t consumed = offset + size - m_head;
+		m_head = offset + size;
+		m_used += consumed;
+		m_currentFrameBytes += consumed;
+		return offset;
+	}
+
+	return InvalidOffset;
+}
+
+void UploadRingAllocator::FinishFrame(uint64_t fenceValue)
+{
+	m_frames.push_back({ fenceValue, m_currentFrameBytes, m_head });
+	m_currentFrameBytes = 0;
+}
+
+void UploadRingAllocator::ReleaseCompletedFrames(uint64_t completedFenceValue) noexcept
+{
+	while (!m_frames.empty() && m_frames.front().FenceValue <= completedFenceValue)
+	{
+		m_used -= m_frames.front().Bytes;
+		m_tail = m_frames.front().EndOffset;
+		m_frames.pop_front();
+	}
+}
+
+void UploadRingAllocator::Reset(size_t capacity) noexcept
+{
+	m_capacity = capacity;
+	m_head = 0;
+	m_tail = 0;
+	m_used = 0;
+	m_currentFrameBytes = 0;
+	m_frames.clear();
+}
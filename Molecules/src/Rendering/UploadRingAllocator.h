@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+// NOTE: This file has no Windows/DirectX dependencies. It only does the bookkeeping for a ring buffer,
+//       FrameUploadBuffer owns the actual GPU buffer and decides when frames have completed on the GPU.
+
+// Linear (ring) sub-allocator for per-frame upload data.
+//
+// Allocations are made from the head of the ring and are never freed individually. Instead, all allocations
+// made between two calls to FinishFrame() belong to the same frame and are released together once that
+// frame's fence value has been reported as complete via ReleaseCompletedFrames(). When an allocation does not
+// fit in the space remaining at the end of the buffer, the remaining space is skipped and the allocation wraps
+// around to offset 0 (provided the GPU is done with the data that lives there).
+class UploadRingAllocator
+{
+public:
+	static constexpr size_t InvalidOffset = SIZE_MAX;
+
+	explicit UploadRingAllocator(size_t capacity) noexcept;
+	UploadRingAllocator(const UploadRingAllocator&) = delete;
+	UploadRingAllocator& operator=(const UploadRingAllocator&) = delete;
+
+	// Returns the offset of the allocation or InvalidOffset if there is not enough free space. 'alignment' must be a power of 2
+	[[nodiscard]] size_t Allocate(size_t size, size_t alignment) noexcept;
+
+	// Mark the end of the current frame. Everything allocated since the previous call is released once
+	// ReleaseCompletedFrames() is called with a value >= 'fenceValue'. Fence values must be increasing.
+	void FinishFrame(uint64_t fenceValue);
+	void ReleaseCompletedFrames(uint64_t completedFenceValue) noexcept;
+
+	// Drop all allocations (including in-flight frames) and optionally change the capacity
+	void Reset() noexcept { Reset(m_capacity); }
+	void Reset(size_t capacity) noexcept;
+
+	[[nodiscard]] inline size_t Capacity() const noexcept { return m_capacity; }
+	[[nodiscard]] inline size_t UsedBytes() const noexcept { return m_used; }
+	[[nodiscard]] inline size_t FramesInFlight() const noexcept { return m_frames.size(); }
+
+private:
+	struct FrameRecord
+	{
+		uint64_t FenceValue;
+		size_t Bytes;		// All bytes consumed by the frame, including alignment padding and space skipped when wrapping
+		size_t EndOffset;	// Head of the ring at the end of the frame
+	};
+
+	size_t m_capacity;
+	size_t m_head;	// Next free byte
+	size_t m_tail;	// Oldest byte still in use
+	size_t m_used;
+	size_t m_currentFrameBytes;
+	std::deque<FrameRecord> m_frames;
+};
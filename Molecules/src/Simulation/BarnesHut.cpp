@@ -0,0 +1,380 @@
+#include "BarnesHut.h"
+#include "MortonOrder.h"
+#include "Evergreen/Utils/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Jobs are only worth scheduling when each one gets at least this many atoms
+static constexpr size_t MinAtomsPerJob = 1024;
+
+BarnesHut::BarnesHut(float theta, Evergreen::JobSystem* jobSystem) noexcept :
+	m_theta(theta),
+	m_jobSystem(jobSystem)
+{}
+
+void BarnesHut::InitializeNode(Node& node, uint32_t begin, uint32_t end, const float center[3], float halfSize) const noexcept
+{
+	node.center[0] = center[0];
+	node.center[1] = center[1];
+	node.center[2] = center[2];
+	node.halfSize = halfSize;
+	node.begin = begin;
+	node.end = end;
+	node.firstChild = 0;
+	node.childCount = 0;
+
+	// Monopole and dipole about the center of the cell
+	float charge = 0.0f;
+	float dipole[3] = { 0.0f, 0.0f, 0.0f };
+	for (uint32_t iii = begin; iii < end; ++iii)
+	{
+		const float q = m_sortedCharge[iii];
+		charge += q;
+		dipole[0] += q * (m_sortedX[iii] - center[0]);
+		dipole[1] += q * (m_sortedY[iii] - center[1]);
+		dipole[2] += q * (m_sortedZ[iii] - center[2]);
+	}
+	node.charge = charge;
+	node.dipole[0] = dipole[0];
+	node.dipole[1] = dipole[1];
+	node.dipole[2] = dipole[2];
+}
+
+void BarnesHut::BuildSubtree(std::vector<Node>& nodes, uint32_t nodeIndex, unsigned int depth) const
+{
+	SplitNode(nodes, nodeIndex, depth);
+
+	// NOTE: 'nodes' may be reallocated by the recursive calls, so do not hold a reference across them
+	const uint32_t firstChild = nodes[nodeIndex].firstChild;
+	const uint32_t childCount = nodes[nodeIndex].childCount;
+	for (uint32_t child = firstChild; child < firstChild + childCount; ++child)
+		BuildSubtree(nodes, child, depth + 1);
+}
+
+void BarnesHut::SplitNode(std::vector<Node>& nodes, uint32_t nodeIndex, unsigned int depth) const
+{
+	const uint32_t begin = nodes[nodeIndex].begin;
+	const uint32_t end = nodes[nodeIndex].end;
+	if (end - begin <= MaxLeafSize || depth >= MaxDepth)
+		return;
+
+	// The atoms are sorted by Morton key, so each child's atoms are a contiguous range. The octant of an atom at this
+	// depth is the next 3 bits of its key (x is the lowest bit, then y, then z)
+	const unsigned int shift = 3 * (MaxDepth - 1 - depth);
+	auto octantOf = [this, shift](uint32_t sortedIndex) { return (m_mortonKeys[sortedIndex] >> shift) & 7u; };
+
+	const float childHalfSize = 0.5f * nodes[nodeIndex].halfSize;
+	const float parentCenter[3] = { nodes[nodeIndex].center[0], nodes[nodeIndex].center[1], nodes[nodeIndex].center[2] };
+
+	const uint32_t firstChild = static_cast<uint32_t>(nodes.size());
+	uint32_t childBegin = begin;
+	for (uint32_t octant = 0; octant < 8 && childBegin < end; ++octant)
+	{
+		uint32_t childEnd = childBegin;
+		while (childEnd < end && octantOf(childEnd) == octant)
+			++childEnd;
+		if (childEnd == childBegin)
+			continue;
+
+		const float center[3] = {
+			parentCenter[0] + ((octant & 1u) ? childHalfSize : -childHalfSize),
+			parentCenter[1] + ((octant & 2u) ? childHalfSize : -childHalfSize),
+			parentCenter[2] + ((octant & 4u) ? childHalfSize : -childHalfSize)
+		};
+		nodes.emplace_back();
+		InitializeNode(nodes.back(), childBegin, childEnd, center, childHalfSize);
+		childBegin = childEnd;
+	}
+
+	nodes[nodeIndex].firstChild = firstChild;
+	nodes[nodeIndex].childCount = static_cast<uint32_t>(nodes.size()) - firstChild;
+}
+
+void BarnesHut::Build(const ForceFieldInput& input)
+{
+	const size_t count = input.Count;
+	const float* positions = input.PositionsXYZ;
+
+	// Bounding cube ------------------------------------------------------------------------------------------
+	float boundsMin[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+	float boundsMax[3] = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+	for (size_t iii = 0; iii < count; ++iii)
+	{
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			boundsMin[axis] = std::min(boundsMin[axis], positions[3 * iii + axis]);
+			boundsMax[axis] = std::max(boundsMax[axis], positions[3 * iii + axis]);
+		}
+	}
+	// Pad slightly so the atoms on the max faces still quantize to 1023
+	float size = std::max({ boundsMax[0] - boundsMin[0], boundsMax[1] - boundsMin[1], boundsMax[2] - boundsMin[2] });
+	size = std::max(size * 1.0001f, std::numeric_limits<float>::min());
+	const float scale = 1024.0f / size;
+
+	// Sort along the Morton curve ----------------------------------------------------------------------------
+	m_keys.resize(count);
+	for (size_t iii = 0; iii < count; ++iii)
+	{
+		const float* p = &positions[3 * iii];
+		const uint32_t key = MortonEncode3(
+			std::min(static_cast<uint32_t>((p[0] - boundsMin[0]) * scale), 1023u),
+			std::min(static_cast<uint32_t>((p[1] - boundsMin[1]) * scale), 1023u),
+			std::min(static_cast<uint32_t>((p[2] - boundsMin[2]) * scale), 1023u)
+		);
+		m_keys[iii] = (static_cast<uint64_t>(key) << 32) | static_cast<uint64_t>(iii);
+	}
+	std::sort(m_keys.begin(), m_keys.end());
+
+	m_sortedToOriginal.resize(count);
+	m_mortonKeys.resize(count);
+	m_sortedX.resize(count);
+	m_sortedY.resize(count);
+	m_sortedZ.resize(count);
+	m_sortedCharge.resize(count);
+	for (size_t iii = 0; iii < count; ++iii)
+	{
+		const uint32_t original = static_cast<uint32_t>(m_keys[iii]);
+		m_sortedToOriginal[iii] = original;
+		m_mortonKeys[iii] = static_cast<uint32_t>(m_keys[iii] >> 32);
+		m_sortedX[iii] = positions[3 * static_cast<size_t>(original)];
+		m_sortedY[iii] = positions[3 * static_cast<size_t>(original) + 1];
+		m_sortedZ[iii] = positions[3 * static_cast<size_t>(original) + 2];
+		m_sortedCharge[iii] = m_charges[input.ElementTypes[original]];
+	}
+
+	// Tree ---------------------------------------------------------------------------------------------------
+	// The root and its children are created here, then each child's subtree is built into its own array (in
+	// parallel) and the arrays are stitched together afterwards
+	m_nodes.clear();
+	const float rootCenter[3] = { boundsMin[0] + 0.5f * size, boundsMin[1] + 0.5f * size, boundsMin[2] + 0.5f * size };
+	m_nodes.emplace_back();
+	InitializeNode(m_nodes[0], 0u, static_cast<uint32_t>(count), rootCenter, 0.5f * size);
+
+	std::vector<Node> topLevel = m_nodes;
+	SplitNode(topLevel, 0u, 0u);
+	if (topLevel[0].childCount == 0)
+	{
+		m_nodes = std::move(topLevel);
+		return;
+	}
+
+	const uint32_t rootChildCount = topLevel[0].childCount;
+	std::vector<std::vector<Node>> subtrees(rootChildCount);
+	for (uint32_t child = 0; child < rootChildCount; ++child)
+		subtrees[child].push_back(topLevel[topLevel[0].firstChild + child]);
+
+	auto buildSubtree = [this, &subtrees](uint32_t child)
+	{
+		BuildSubtree(subtrees[child], 0u, 1u);
+	};
+
+	if (m_jobSystem == nullptr || m_jobSystem->ThreadCount() == 1 || rootChildCount <= 1 || count < 2 * MinAtomsPerJob)
+	{
+		for (uint32_t child = 0; child < rootChildCount; ++child)
+			buildSubtree(child);
+	}
+	else
+	{
+		// One job per subtree - they write to separate node arrays. The calling thread builds the first one
+		Evergreen::JobCounter counter;
+		for (uint32_t child = 1; child < rootChildCount; ++child)
+			m_jobSystem->Run([&buildSubtree, child]() { buildSubtree(child); }, &counter);
+		buildSubtree(0);
+		m_jobSystem->Wait(counter);
+	}
+
+	// Final layout: [root][root's children][rest of subtree 0][rest of subtree 1]...
+	// Local index 0 of subtree i maps to 1 + i, local index j > 0 maps to base_i + j - 1
+	size_t totalNodes = 1 + rootChildCount;
+	for (const std::vector<Node>& nodes : subtrees)
+		totalNodes += nodes.size() - 1;
+
+	m_nodes.resize(totalNodes);
+	m_nodes[0].firstChild = 1u;
+	m_nodes[0].childCount = rootChildCount;
+
+	uint32_t base = 1u + rootChildCount;
+	for (uint32_t child = 0; child < rootChildCount; ++child)
+	{
+		const std::vector<Node>& nodes = subtrees[child];
+		auto remap = [child, base](uint32_t local) { return local == 0 ? 1u + child : base + local - 1u; };
+
+		for (uint32_t local = 0; local < nodes.size(); ++local)
+		{
+			Node node = nodes[local];
+			if (node.childCount > 0)
+				node.firstChild = remap(node.firstChild);
+			m_nodes[remap(local)] = node;
+		}
+		base += static_cast<uint32_t>(nodes.size()) - 1u;
+	}
+}
+
+double BarnesHut::Evaluate(size_t sortedBegin, size_t sortedEnd, float* forcesXYZOut) const noexcept
+{
+	const float thetaSquared = m_theta * m_theta;
+	const float softeningSquared = m_softening * m_softening;
+
+	double energy = 0.0;
+	uint32_t stack[8 * MaxDepth + 8];
+
+	for (size_t iii = sortedBegin; iii < sortedEnd; ++iii)
+	{
+		const float qi = m_sortedCharge[iii];
+		if (qi == 0.0f)
+			continue;
+
+		const float x = m_sortedX[iii];
+		const float y = m_sortedY[iii];
+		const float z = m_sortedZ[iii];
+
+		float field[3] = { 0.0f, 0.0f, 0.0f };
+		float potential = 0.0f;
+
+		unsigned int stackSize = 0;
+		stack[stackSize++] = 0u;
+		while (stackSize > 0)
+		{
+			const Node& node = m_nodes[stack[--stackSize]];
+
+			const float dx = x - node.center[0];
+			const float dy = y - node.center[1];
+			const float dz = z - node.center[2];
+			const float distanceSquared = dx * dx + dy * dy + dz * dz;
+			const float nodeSize = 2.0f * node.halfSize;
+			const bool containsAtom = iii >= node.begin && iii < node.end;
+
+			if (!containsAtom && nodeSize * nodeSize < thetaSquared * distanceSquared)
+			{
+				// Far enough away - use the multipole expansion about the cell center
+				const float r2 = distanceSquared + softeningSquared;
+				const float invR = 1.0f / std::sqrt(r2);
+				const float invR3 = invR * invR * invR;
+				const float invR5 = invR3 / r2;
+				const float pDotD = node.dipole[0] * dx + node.dipole[1] * dy + node.dipole[2] * dz;
+
+				potential += node.charge * invR + pDotD * invR3;
+				const float radial = node.charge * invR3 + 3.0f * pDotD * invR5;
+				field[0] += radial * dx - node.dipole[0] * invR3;
+				field[1] += radial * dy - node.dipole[1] * invR3;
+				field[2] += radial * dz - node.dipole[2] * invR3;
+			}
+			else if (node.childCount == 0)
+			{
+				// Leaf - direct sum
+				for (uint32_t jjj = node.begin; jjj < node.end; ++jjj)
+				{
+					if (jjj == iii)
+						continue;
+
+					const float rx = x - m_sortedX[jjj];
+					const float ry = y - m_sortedY[jjj];
+					const float rz = z - m_sortedZ[jjj];
+					const float r2 = rx * rx + ry * ry + rz * rz + softeningSquared;
+					const float invR = 1.0f / std::sqrt(r2);
+					const float qjInvR3 = m_sortedCharge[jjj] * invR * invR * invR;
+
+					potential += m_sortedCharge[jjj] * invR;
+					field[0] += qjInvR3 * rx;
+					field[1] += qjInvR3 * ry;
+					field[2] += qjInvR3 * rz;
+				}
+			}
+			else
+			{
+				for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child)
+					stack[stackSize++] = child;
+			}
+		}
+
+		const float scale = m_coulombConstant * qi;
+		const size_t original = m_sortedToOriginal[iii];
+		forcesXYZOut[3 * original] = scale * field[0];
+		forcesXYZOut[3 * original + 1] = scale * field[1];
+		forcesXYZOut[3 * original + 2] = scale * field[2];
+
+		// Every pair is counted from both sides
+		energy += 0.5 * static_cast<double>(scale) * potential;
+	}
+	return energy;
+}
+
+double BarnesHut::ComputeForces(const ForceFieldInput& input, float* forcesXYZOut)
+{
+	std::fill(forcesXYZOut, forcesXYZOut + 3 * input.Count, 0.0f);
+	m_virial = 0.0;
+	if (input.Count == 0)
+		return 0.0;
+
+	Build(input);
+
+	// Each job handles a contiguous range of the sorted atoms and only ever writes the forces of its own atoms,
+	// so the jobs can all write straight into the output
+	const size_t rangeCount = m_jobSystem == nullptr ? 1 : std::max<size_t>(1, std::min<size_t>(m_jobSystem->ThreadCount(), input.Count / MinAtomsPerJob));
+	double energy = 0.0;
+	if (rangeCount == 1)
+		energy = Evaluate(0, input.Count, forcesXYZOut);
+	else
+	{
+		std::vector<double> energies(rangeCount, 0.0);
+		Evergreen::JobCounter counter;
+		for (size_t r = 1; r < rangeCount; ++r)
+		{
+			m_jobSystem->Run([this, &input, &energies, forcesXYZOut, r, rangeCount]()
+				{
+					energies[r] = Evaluate(input.Count * r / rangeCount, input.Count * (r + 1) / rangeCount, forcesXYZOut);
+				},
+				&counter
+			);
+		}
+		energies[0] = Evaluate(0, input.Count / rangeCount, forcesXYZOut);
+
+		m_jobSystem->Wait(counter);
+
+		for (double e : energies)
+			energy += e;
+	}
+
+	// With open boundaries and pairwise forces, sum_pairs r_ij . f_ij = sum_i r_i . F_i
+	for (size_t iii = 0; iii < 3 * input.Count; ++iii)
+		m_virial += static_cast<double>(input.PositionsXYZ[iii]) * forcesXYZOut[iii];
+
+	return energy;
+}
+
+double BarnesHut::ComputeForcesDirect(const ForceFieldInput& input, float* forcesXYZOut) const noexcept
+{
+	std::fill(forcesXYZOut, forcesXYZOut + 3 * input.Count, 0.0f);
+
+	const float softeningSquared = m_softening * m_softening;
+	double energy = 0.0;
+	for (size_t iii = 0; iii < input.Count; ++iii)
+	{
+		const float qi = m_charges[input.ElementTypes[iii]];
+		for (size_t jjj = iii + 1; jjj < input.Count; ++jjj)
+		{
+			const float qq = m_coulombConstant * qi * m_charges[input.ElementTypes[jjj]];
+			if (qq == 0.0f)
+				continue;
+
+			const float* p = &input.PositionsXYZ[3 * iii];
+			const float* q = &input.PositionsXYZ[3 * jjj];
+			const float rx = p[0] - q[0];
+			const float ry = p[1] - q[1];
+			const float rz = p[2] - q[2];
+			const float r2 = rx * rx + ry * ry + rz * rz + softeningSquared;
+			const float invR = 1.0f / std::sqrt(r2);
+			const float f = qq * invR * invR * invR;
+
+			energy += qq * invR;
+			forcesXYZOut[3 * iii] += f * rx;
+			forcesXYZOut[3 * iii + 1] += f * ry;
+			forcesXYZOut[3 * iii + 2] += f * rz;
+			forcesXYZOut[3 * jjj] -= f * rx;
+			forcesXYZOut[3 * jjj + 1] -= f * ry;
+			forcesXYZOut[3 * jjj + 2] -= f * rz;
+		}
+	}
+	return energy;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ForceField.h"
+
+// NOTE: This file has no Windows/DirectX dependencies.
+
+// Barnes-Hut approximation of the (unscreened, no cutoff) Coulomb interaction between all pairs of atoms.
+//
+// The atoms are sorted along a Morton curve over a cube that encloses them, which makes every octree cell a contiguous
+// range of the sorted atoms. The octree is then built top-down into a linear node array (the children of a node are
+// stored next to each other) with each of the root's subtrees built as its own job on the JobSystem. Each node stores the monopole
+// (total charge) and dipole of its atoms about the center of the cell.
+//
+// When evaluating the force on an atom, a node whose size / distance is less than the opening angle 'theta' is
+// treated as a single multipole. Otherwise its children are visited, down to the leaves where the interactions
+// are summed directly. theta = 0 reproduces the exact O(n^2) sum, and larger values trade accuracy for speed.
+//
+// This does not use the neighbor list (Cutoff() is 0), so it is meant to be combined with a short-range force field
+// (ex. a LennardJonesCoulomb with zero charges) through ForceFieldSum.
+// Periodic boundaries (ForceFieldInput::Box) are ignored - every atom only interacts with the other atoms in the box,
+// not with their periodic images (which would need an Ewald-style sum).
+class BarnesHut : public ForceField
+{
+public:
+	static constexpr size_t MaxElementTypes = LennardJonesCoulomb::MaxElementTypes;
+	static constexpr uint32_t MaxLeafSize = 8;
+	static constexpr unsigned int MaxDepth = 10; // The Morton keys have 10 bits per axis
+
+	struct Node
+	{
+		float center[3];
+		float halfSize;
+		float charge;			// Monopole
+		float dipole[3];		// Sum of q * (x - center)
+		uint32_t begin;			// Range of sorted atoms in this cell
+		uint32_t end;
+		uint32_t firstChild;	// Children are stored contiguously at [firstChild, firstChild + childCount)
+		uint32_t childCount;	// 0 for leaves
+	};
+
+	// Without a JobSystem, the tree is built and evaluated on the calling thread
+	explicit BarnesHut(float theta, Evergreen::JobSystem* jobSystem = nullptr) noexcept;
+	BarnesHut(const BarnesHut&) = delete;
+	BarnesHut& operator=(const BarnesHut&) = delete;
+
+	double ComputeForces(const ForceFieldInput& input, float* forcesXYZOut) override;
+	[[nodiscard]] float Cutoff() const noexcept override { return 0.0f; }
+	[[nodiscard]] double Virial() const noexcept override { return m_virial; }
+
+	// Exact O(n^2) sum with the same charges/softening. Used as the reference when tuning theta
+	double ComputeForcesDirect(const ForceFieldInput& input, float* forcesXYZOut) const noexcept;
+
+	inline void SetTheta(float theta) noexcept { m_theta = theta; }
+	[[nodiscard]] inline float Theta() const noexcept { return m_theta; }
+	inline void SetCharge(int elementType, float charge) noexcept { if (static_cast<size_t>(elementType) < MaxElementTypes) m_charges[elementType] = charge; }
+	inline void SetCoulombConstant(float k) noexcept { m_coulombConstant = k; }
+	// Plummer softening length - keeps the force finite when two atoms overlap
+	inline void SetSoftening(float softening) noexcept { m_softening = softening; }
+	inline void SetJobSystem(Evergreen::JobSystem* jobSystem) noexcept { m_jobSystem = jobSystem; }
+
+	[[nodiscard]] inline const std::vector<Node>& Nodes() const noexcept { return m_nodes; }
+
+private:
+	void Build(const ForceFieldInput& input);
+	void BuildSubtree(std::vector<Node>& nodes, uint32_t nodeIndex, unsigned int depth) const;
+	void SplitNode(std::vector<Node>& nodes, uint32_t nodeIndex, unsigned int depth) const;
+	void InitializeNode(Node& node, uint32_t begin, uint32_t end, const float center[3], float halfSize) const noexcept;
+	double Evaluate(size_t sortedBegin, size_t sortedEnd, float* forcesXYZOut) const noexcept;
+
+	float m_theta;
+	float m_coulombConstant = 1.0f;
+	float m_softening = 1.0e-3f;
+	Evergreen::JobSystem* m_jobSystem;
+	double m_virial = 0.0;
+	float m_charges[MaxElementTypes] = {};
+
+	std::vector<Node> m_nodes;
+
+	// Atoms in Morton order (structure-of-arrays so the leaf loops stream through memory)
+	std::vector<uint64_t> m_keys;		// (Morton key << 32) | original index
+	std::vector<uint32_t> m_sortedToOriginal;
+	std::vector<float> m_sortedX;
+	std::vector<float> m_sortedY;
+	std::vector<float> m_sortedZ;
+	std::vector<float> m_sortedCharge;
+	std::vector<uint32_t> m_mortonKeys;
+};
@@ -0,0 +1,408 @@
+#include "ForceField.h"
+#include "Evergreen/Utils/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+	#include <emmintrin.h>
+	#define FORCE_FIELD_SSE
+#endif
+
+// Jobs are only worth scheduling when each one gets at least this many pairs
+static constexpr size_t MinPairsPerJob = 8192;
+
+// Keeps 1 / r^2 finite if two atoms end up on top of each other
+static constexpr float MinDistanceSquared = 1.0e-6f;
+
+double ForceFieldSum::ComputeForces(const ForceFieldInput& input, float* forcesXYZOut)
+{
+	const size_t floatCount = 3 * input.Count;
+	if (m_forceFields.empty())
+	{
+		std::fill(forcesXYZOut, forcesXYZOut + floatCount, 0.0f);
+		return 0.0;
+	}
+
+	// The first force field writes straight into the output, the rest go through the scratch buffer
+	double energy = m_forceFields[0]->ComputeForces(input, forcesXYZOut);
+
+	m_scratchForces.resize(floatCount);
+	for (size_t iii = 1; iii < m_forceFields.size(); ++iii)
+	{
+		energy += m_forceFields[iii]->ComputeForces(input, m_scratchForces.data());
+		for (size_t jjj = 0; jjj < floatCount; ++jjj)
+			forcesXYZOut[jjj] += m_scratchForces[jjj];
+	}
+	return energy;
+}
+
+float ForceFieldSum::Cutoff() const noexcept
+{
+	float cutoff = 0.0f;
+	for (const std::unique_ptr<ForceField>& forceField : m_forceFields)
+		cutoff = std::max(cutoff, forceField->Cutoff());
+	return cutoff;
+}
+double ForceFieldSum::Virial() const noexcept
+{
+	double virial = 0.0;
+	for (const std::unique_ptr<ForceField>& forceField : m_forceFields)
+		virial += forceField->Virial();
+	return virial;
+}
+
+LennardJonesCoulomb::LennardJonesCoulomb(float cutoff, Evergreen::JobSystem* jobSystem) :
+	m_cutoff(cutoff),
+	m_jobSystem(jobSystem),
+	m_c6(MaxElementTypes * MaxElementTypes, 0.0f),
+	m_c12(MaxElementTypes * MaxElementTypes, 0.0f),
+	m_chargeProduct(MaxElementTypes * MaxElementTypes, 0.0f),
+	m_energyShift(MaxElementTypes * MaxElementTypes, 0.0f)
+{}
+
+void LennardJonesCoulomb::SetElementParameters(int elementType, const ElementParameters& parameters) noexcept
+{
+	const size_t a = static_cast<size_t>(elementType);
+	if (a >= MaxElementTypes)
+		return;
+
+	m_elementParameters[a] = parameters;
+
+	// Lorentz-Berthelot mixing with every other element
+	for (size_t b = 0; b < MaxElementTypes; ++b)
+	{
+		const ElementParameters& other = m_elementParameters[b];
+		UpdatePair(a, b, 0.5f * (parameters.Sigma + other.Sigma), std::sqrt(parameters.Epsilon * other.Epsilon));
+	}
+	UpdateChargeProducts();
+}
+
+void LennardJonesCoulomb::SetPairParameters(int elementTypeA, int elementTypeB, float sigma, float epsilon) noexcept
+{
+	const size_t a = static_cast<size_t>(elementTypeA);
+	const size_t b = static_cast<size_t>(elementTypeB);
+	if (a >= MaxElementTypes || b >= MaxElementTypes)
+		return;
+
+	UpdatePair(a, b, sigma, epsilon);
+}
+
+void LennardJonesCoulomb::SetCoulombConstant(float k) noexcept
+{
+	m_coulombConstant = k;
+	UpdateChargeProducts();
+}
+
+void LennardJonesCoulomb::SetCutoff(float cutoff) noexcept
+{
+	m_cutoff = cutoff;
+	UpdateEnergyShifts();
+}
+
+void LennardJonesCoulomb::UpdatePair(size_t a, size_t b, float sigma, float epsilon) noexcept
+{
+	const float sigma6 = sigma * sigma * sigma * sigma * sigma * sigma;
+	const float c6 = 4.0f * epsilon * sigma6;
+	const float c12 = c6 * sigma6;
+
+	m_c6[a * MaxElementTypes + b] = m_c6[b * MaxElementTypes + a] = c6;
+	m_c12[a * MaxElementTypes + b] = m_c12[b * MaxElementTypes + a] = c12;
+	UpdateEnergyShifts();
+}
+
+void LennardJonesCoulomb::UpdateChargeProducts() noexcept
+{
+	for (size_t a = 0; a < MaxElementTypes; ++a)
+		for (size_t b = 0; b < MaxElementTypes; ++b)
+			m_chargeProduct[a * MaxElementTypes + b] = m_coulombConstant * m_elementParameters[a].Charge * m_elementParameters[b].Charge;
+}
+
+void LennardJonesCoulomb::UpdateEnergyShifts() noexcept
+{
+	const float invCutoff2 = 1.0f / (m_cutoff * m_cutoff);
+	const float invCutoff6 = invCutoff2 * invCutoff2 * invCutoff2;
+	for (size_t iii = 0; iii < m_energyShift.size(); ++iii)
+		m_energyShift[iii] = invCutoff6 * (m_c12[iii] * invCutoff6 - m_c6[iii]);
+}
+
+// Force (divided by r, so it can be multiplied by the separation vector) and energy of a single pair
+static inline float PairForceOverR(float r2, float c6, float c12, float chargeProduct, float energyShift,
+	float invCutoff, float invCutoff2, float& energyOut) noexcept
+{
+	r2 = std::max(r2, MinDistanceSquared);
+	const float invR2 = 1.0f / r2;
+	const float invR6 = invR2 * invR2 * invR2;
+	const float r = std::sqrt(r2);
+	const float invR = 1.0f / r;
+
+	// Lennard-Jones (energy shifted) + Coulomb (shifted force: E = qq * (1/r - 1/rc + (r - rc) / rc^2))
+	energyOut = invR6 * (c12 * invR6 - c6) - energyShift
+		+ chargeProduct * (invR - invCutoff + (r - 1.0f / invCutoff) * invCutoff2);
+
+	return invR6 * invR2 * (12.0f * c12 * invR6 - 6.0f * c6) + chargeProduct * invR * (invR2 - invCutoff2);
+}
+
+double LennardJonesCoulomb::ComputeForcesScalar(const ForceFieldInput& input, float* forcesXYZOut) const noexcept
+{
+	std::fill(forcesXYZOut, forcesXYZOut + 3 * input.Count, 0.0f);
+
+	const float cutoff2 = m_cutoff * m_cutoff;
+	const float invCutoff = 1.0f / m_cutoff;
+	const float invCutoff2 = invCutoff * invCutoff;
+
+	double energy = 0.0;
+	for (size_t iii = 0; iii < input.Count; ++iii)
+	{
+		const float* p = &input.PositionsXYZ[3 * iii];
+		const size_t rowIndex = static_cast<size_t>(input.ElementTypes[iii]) * MaxElementTypes;
+
+		for (uint32_t jjj : input.Neighbors->NeighborsOf(iii))
+		{
+			const float* q = &input.PositionsXYZ[3 * static_cast<size_t>(jjj)];
+			float dx = p[0] - q[0];
+			float dy = p[1] - q[1];
+			float dz = p[2] - q[2];
+			input.Box.MinimumImage(dx, dy, dz);
+			const float r2 = dx * dx + dy * dy + dz * dz;
+			if (r2 >= cutoff2)
+				continue;
+
+			const size_t pairIndex = rowIndex + static_cast<size_t>(input.ElementTypes[jjj]);
+			float pairEnergy;
+			const float f = PairForceOverR(r2, m_c6[pairIndex], m_c12[pairIndex], m_chargeProduct[pairIndex], m_energyShift[pairIndex], invCutoff, invCutoff2, pairEnergy);
+			energy += pairEnergy;
+
+			forcesXYZOut[3 * iii] += f * dx;
+			forcesXYZOut[3 * iii + 1] += f * dy;
+			forcesXYZOut[3 * iii + 2] += f * dz;
+			forcesXYZOut[3 * static_cast<size_t>(jjj)] -= f * dx;
+			forcesXYZOut[3 * static_cast<size_t>(jjj) + 1] -= f * dy;
+			forcesXYZOut[3 * static_cast<size_t>(jjj) + 2] -= f * dz;
+		}
+	}
+	return energy;
+}
+
+double LennardJonesCoulomb::ComputeRange(const ForceFieldInput& input, size_t begin, size_t end, float* forcesXYZ, double& virialOut) const noexcept
+{
+	const float cutoff2 = m_cutoff * m_cutoff;
+	const float invCutoff = 1.0f / m_cutoff;
+	const float invCutoff2 = invCutoff * invCutoff;
+
+	const float* positions = input.PositionsXYZ;
+	const int* types = input.ElementTypes;
+
+	double energy = 0.0;
+	double virial = 0.0;
+	for (size_t iii = begin; iii < end; ++iii)
+	{
+		const float* p = &positions[3 * iii];
+		const size_t rowIndex = static_cast<size_t>(types[iii]) * MaxElementTypes;
+		const std::span<const uint32_t> neighbors = input.Neighbors->NeighborsOf(iii);
+
+		float fx = 0.0f, fy = 0.0f, fz = 0.0f;
+		float atomEnergy = 0.0f;
+		float atomVirial = 0.0f;
+		size_t jjj = 0;
+
+#ifdef FORCE_FIELD_SSE
+		const __m128 xi = _mm_set1_ps(p[0]);
+		const __m128 yi = _mm_set1_ps(p[1]);
+		const __m128 zi = _mm_set1_ps(p[2]);
+		const __m128 vCutoff2 = _mm_set1_ps(cutoff2);
+		const __m128 vInvCutoff = _mm_set1_ps(invCutoff);
+		const __m128 vInvCutoff2 = _mm_set1_ps(invCutoff2);
+		const __m128 vCutoff = _mm_set1_ps(m_cutoff);
+		const __m128 vMinR2 = _mm_set1_ps(MinDistanceSquared);
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 six = _mm_set1_ps(6.0f);
+		const __m128 twelve = _mm_set1_ps(12.0f);
+
+		__m128 fxAccumulator = _mm_setzero_ps();
+		__m128 fyAccumulator = _mm_setzero_ps();
+		__m128 fzAccumulator = _mm_setzero_ps();
+		__m128 energyAccumulator = _mm_setzero_ps();
+		__m128 virialAccumulator = _mm_setzero_ps();
+
+		alignas(16) float xj[4], yj[4], zj[4], c6[4], c12[4], qq[4], shift[4];
+		alignas(16) float fjx[4], fjy[4], fjz[4];
+
+		for (; jjj + 4 <= neighbors.size(); jjj += 4)
+		{
+			// Gather the 4 neighbors and their pair terms
+			for (unsigned int lane = 0; lane < 4; ++lane)
+			{
+				const size_t j = neighbors[jjj + lane];
+				xj[lane] = positions[3 * j];
+				yj[lane] = positions[3 * j + 1];
+				zj[lane] = positions[3 * j + 2];
+
+				const size_t pairIndex = rowIndex + static_cast<size_t>(types[j]);
+				c6[lane] = m_c6[pairIndex];
+				c12[lane] = m_c12[pairIndex];
+				qq[lane] = m_chargeProduct[pairIndex];
+				shift[lane] = m_energyShift[pairIndex];
+			}
+
+			__m128 dx = _mm_sub_ps(xi, _mm_load_ps(xj));
+			__m128 dy = _mm_sub_ps(yi, _mm_load_ps(yj));
+			__m128 dz = _mm_sub_ps(zi, _mm_load_ps(zj));
+			input.Box.MinimumImage(dx, dy, dz);
+			__m128 r2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+			const __m128 inRange = _mm_cmplt_ps(r2, vCutoff2);
+			if (_mm_movemask_ps(inRange) == 0)
+				continue;
+
+			const __m128 unclampedR2 = r2;
+			r2 = _mm_max_ps(r2, vMinR2);
+			const __m128 invR2 = _mm_div_ps(one, r2);
+			const __m128 invR6 = _mm_mul_ps(_mm_mul_ps(invR2, invR2), invR2);
+			const __m128 r = _mm_sqrt_ps(r2);
+			const __m128 invR = _mm_div_ps(one, r);
+			const __m128 vC6 = _mm_load_ps(c6);
+			const __m128 vC12 = _mm_load_ps(c12);
+			const __m128 vQQ = _mm_load_ps(qq);
+
+			// Force / r
+			__m128 f = _mm_mul_ps(_mm_mul_ps(invR6, invR2), _mm_sub_ps(_mm_mul_ps(twelve, _mm_mul_ps(vC12, invR6)), _mm_mul_ps(six, vC6)));
+			f = _mm_add_ps(f, _mm_mul_ps(_mm_mul_ps(vQQ, invR), _mm_sub_ps(invR2, vInvCutoff2)));
+			f = _mm_and_ps(f, inRange);
+
+			// Energy
+			__m128 e = _mm_sub_ps(_mm_mul_ps(invR6, _mm_sub_ps(_mm_mul_ps(vC12, invR6), vC6)), _mm_load_ps(shift));
+			e = _mm_add_ps(e, _mm_mul_ps(vQQ, _mm_add_ps(_mm_sub_ps(invR, vInvCutoff), _mm_mul_ps(_mm_sub_ps(r, vCutoff), vInvCutoff2))));
+			energyAccumulator = _mm_add_ps(energyAccumulator, _mm_and_ps(e, inRange));
+			virialAccumulator = _mm_add_ps(virialAccumulator, _mm_mul_ps(f, unclampedR2)); // r . F = (F / r) * r^2
+
+			const __m128 pairFx = _mm_mul_ps(f, dx);
+			const __m128 pairFy = _mm_mul_ps(f, dy);
+			const __m128 pairFz = _mm_mul_ps(f, dz);
+			fxAccumulator = _mm_add_ps(fxAccumulator, pairFx);
+			fyAccumulator = _mm_add_ps(fyAccumulator, pairFy);
+			fzAccumulator = _mm_add_ps(fzAccumulator, pairFz);
+
+			// Newton's third law - scatter the opposite force to the neighbors
+			_mm_store_ps(fjx, pairFx);
+			_mm_store_ps(fjy, pairFy);
+			_mm_store_ps(fjz, pairFz);
+			for (unsigned int lane = 0; lane < 4; ++lane)
+			{
+				const size_t j = neighbors[jjj + lane];
+				forcesXYZ[3 * j] -= fjx[lane];
+				forcesXYZ[3 * j + 1] -= fjy[lane];
+				forcesXYZ[3 * j + 2] -= fjz[lane];
+			}
+		}
+
+		alignas(16) float sums[4];
+		_mm_store_ps(sums, fxAccumulator);
+		fx = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+		_mm_store_ps(sums, fyAccumulator);
+		fy = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+		_mm_store_ps(sums, fzAccumulator);
+		fz = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+		_mm_store_ps(sums, energyAccumulator);
+		atomEnergy = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+		_mm_store_ps(sums, virialAccumulator);
+		atomVirial = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+#endif
+
+		// Remaining neighbors (or all of them without SSE)
+		for (; jjj < neighbors.size(); ++jjj)
+		{
+			const size_t j = neighbors[jjj];
+			const float* q = &positions[3 * j];
+			float dx = p[0] - q[0];
+			float dy = p[1] - q[1];
+			float dz = p[2] - q[2];
+			input.Box.MinimumImage(dx, dy, dz);
+			const float r2 = dx * dx + dy * dy + dz * dz;
+			if (r2 >= cutoff2)
+				continue;
+
+			const size_t pairIndex = rowIndex + static_cast<size_t>(types[j]);
+			float pairEnergy;
+			const float f = PairForceOverR(r2, m_c6[pairIndex], m_c12[pairIndex], m_chargeProduct[pairIndex], m_energyShift[pairIndex], invCutoff, invCutoff2, pairEnergy);
+			atomEnergy += pairEnergy;
+			atomVirial += f * r2;
+
+			fx += f * dx;
+			fy += f * dy;
+			fz += f * dz;
+			forcesXYZ[3 * j] -= f * dx;
+			forcesXYZ[3 * j + 1] -= f * dy;
+			forcesXYZ[3 * j + 2] -= f * dz;
+		}
+
+		forcesXYZ[3 * iii] += fx;
+		forcesXYZ[3 * iii + 1] += fy;
+		forcesXYZ[3 * iii + 2] += fz;
+		energy += atomEnergy;
+		virial += atomVirial;
+	}
+	virialOut = virial;
+	return energy;
+}
+
+double LennardJonesCoulomb::ComputeForces(const ForceFieldInput& input, float* forcesXYZOut)
+{
+	const size_t floatCount = 3 * input.Count;
+	std::fill(forcesXYZOut, forcesXYZOut + floatCount, 0.0f);
+
+	m_virial = 0.0;
+	if (input.Count == 0)
+		return 0.0;
+
+	const NeighborList& neighbors = *input.Neighbors;
+	const size_t pairCount = neighbors.PairCount();
+	const size_t rangeCount = m_jobSystem == nullptr ? 1 : std::max<size_t>(1, std::min<size_t>(m_jobSystem->ThreadCount(), pairCount / MinPairsPerJob));
+
+	if (rangeCount == 1)
+		return ComputeRange(input, 0, input.Count, forcesXYZOut, m_virial);
+
+	// Split the atoms so each range gets roughly the same number of pairs (the CSR offsets are a running total)
+	const std::vector<uint32_t>& offsets = neighbors.Offsets();
+	std::vector<size_t> boundaries(rangeCount + 1);
+	boundaries[0] = 0;
+	boundaries[rangeCount] = input.Count;
+	for (size_t r = 1; r < rangeCount; ++r)
+	{
+		const uint32_t targetPairs = static_cast<uint32_t>(pairCount * r / rangeCount);
+		boundaries[r] = static_cast<size_t>(std::lower_bound(offsets.begin(), offsets.end() - 1, targetPairs) - offsets.begin());
+	}
+
+	m_threadForces.resize(rangeCount - 1);
+	std::vector<double> energies(rangeCount, 0.0);
+	std::vector<double> virials(rangeCount, 0.0);
+
+	Evergreen::JobCounter counter;
+	for (size_t r = 1; r < rangeCount; ++r)
+	{
+		m_jobSystem->Run([this, &input, &boundaries, &energies, &virials, r, floatCount]()
+			{
+				std::vector<float>& forces = m_threadForces[r - 1];
+				forces.assign(floatCount, 0.0f);
+				energies[r] = ComputeRange(input, boundaries[r], boundaries[r + 1], forces.data(), virials[r]);
+			},
+			&counter
+		);
+	}
+
+	// The calling thread takes the first range and accumulates directly into the output
+	energies[0] = ComputeRange(input, boundaries[0], boundaries[1], forcesXYZOut, virials[0]);
+
+	m_jobSystem->Wait(counter);
+
+	// Reduce the per-range buffers. The ranges are fixed, so the result does not depend on which thread ran which job
+	for (const std::vector<float>& forces : m_threadForces)
+		for (size_t iii = 0; iii < floatCount; ++iii)
+			forcesXYZOut[iii] += forces[iii];
+
+	double energy = 0.0;
+	for (size_t r = 0; r < rangeCount; ++r)
+	{
+		energy += energies[r];
+		m_virial += virials[r];
+	}
+	return energy;
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "NeighborList.h"
+
+namespace Evergreen { class JobSystem; }
+
+// NOTE: This file has no Windows/DirectX dependencies. Positions and forces are tightly packed xyz triplets
+//       (the layout of std::vector<DirectX::XMFLOAT3>) and element types are the integer values of the Element enum.
+
+struct ForceFieldInput
+{
+	const float* PositionsXYZ = nullptr;
+	const int* ElementTypes = nullptr;
+	size_t Count = 0;
+
+	// Half neighbor list covering at least Cutoff() of the force field (pairs beyond the cutoff are ignored)
+	const NeighborList* Neighbors = nullptr;
+
+	// Periodic boundaries - when enabled, pair displacements use the minimum image. Must match the neighbor list's box
+	PeriodicBox Box;
+};
+
+// Interface for the force stage of the Simulation. Implementations compute the total force on every atom
+// from the current positions and return the potential energy of the system.
+class ForceField
+{
+public:
+	virtual ~ForceField() noexcept {}
+
+	// Overwrites 'forcesXYZOut' (3 * input.Count floats) and returns the total potential energy
+	virtual double ComputeForces(const ForceFieldInput& input, float* forcesXYZOut) = 0;
+
+	// Distance beyond which pairs do not interact. The Simulation sizes its neighbor list from this
+	[[nodiscard]] virtual float Cutoff() const noexcept = 0;
+
+	// Sum over pairs of r_ij . f_ij (r_ij = r_i - r_j, f_ij = force on i due to j) from the most recent call to
+	// ComputeForces(). This is the interaction term of the pressure. Force fields that do not compute it return 0
+	[[nodiscard]] virtual double Virial() const noexcept { return 0.0; }
+};
+
+// Sum of several force fields (ex. a short-range pair kernel plus a long-range solver such as BarnesHut)
+class ForceFieldSum : public ForceField
+{
+public:
+	ForceFieldSum() noexcept = default;
+	ForceFieldSum(const ForceFieldSum&) = delete;
+	ForceFieldSum& operator=(const ForceFieldSum&) = delete;
+
+	inline void Add(std::unique_ptr<ForceField> forceField) { m_forceFields.push_back(std::move(forceField)); }
+
+	double ComputeForces(const ForceFieldInput& input, float* forcesXYZOut) override;
+	// The largest cutoff of any of the force fields (the neighbor list has to cover all of them)
+	[[nodiscard]] float Cutoff() const noexcept override;
+	[[nodiscard]] double Virial() const noexcept override;
+
+private:
+	std::vector<std::unique_ptr<ForceField>> m_forceFields;
+	std::vector<float> m_scratchForces;
+};
+
+// Lennard-Jones + Coulomb pair potential with a cutoff.
+//
+// Parameters are set per element and combined per pair with the Lorentz-Berthelot rules (sigma is the arithmetic
+// mean, epsilon the geometric mean). SetPairParameters() can override a single pair afterwards. Both terms are
+// shifted so the energy goes to zero at the cutoff, and the Coulomb term is also force-shifted so the force is
+// continuous there, which keeps the total energy well conserved with velocity-Verlet integration.
+//
+// The kernel walks the neighbor list 4 pairs at a time with SSE. Atoms are split into ranges that hold roughly the
+// same number of pairs, which run as jobs on the JobSystem, and every range accumulates into its own force buffer (each
+// pair updates both atoms, so ranges would otherwise race on the same atoms) which are summed at the end.
+class LennardJonesCoulomb : public ForceField
+{
+public:
+	static constexpr size_t MaxElementTypes = 16;
+
+	struct ElementParameters
+	{
+		float Sigma = 0.0f;
+		float Epsilon = 0.0f;
+		float Charge = 0.0f;
+	};
+
+	// Without a JobSystem, the forces are computed on the calling thread
+	explicit LennardJonesCoulomb(float cutoff, Evergreen::JobSystem* jobSystem = nullptr);
+	LennardJonesCoulomb(const LennardJonesCoulomb&) = delete;
+	LennardJonesCoulomb& operator=(const LennardJonesCoulomb&) = delete;
+
+	double ComputeForces(const ForceFieldInput& input, float* forcesXYZOut) override;
+	[[nodiscard]] float Cutoff() const noexcept override { return m_cutoff; }
+
+	// NOTE: Each of these rebuilds the pair tables for the affected element(s)
+	void SetElementParameters(int elementType, const ElementParameters& parameters) noexcept;
+	void SetPairParameters(int elementTypeA, int elementTypeB, float sigma, float epsilon) noexcept;
+	void SetCoulombConstant(float k) noexcept;
+	void SetCutoff(float cutoff) noexcept;
+
+	inline void SetJobSystem(Evergreen::JobSystem* jobSystem) noexcept { m_jobSystem = jobSystem; }
+	[[nodiscard]] inline const ElementParameters& GetElementParameters(int elementType) const noexcept { return m_elementParameters[static_cast<size_t>(elementType)]; }
+
+	[[nodiscard]] double Virial() const noexcept override { return m_virial; }
+
+	// Reference implementation of the pair kernel (one pair at a time, single thread). Produces the same result
+	// as ComputeForces() up to floating point rounding
+	double ComputeForcesScalar(const ForceFieldInput& input, float* forcesXYZOut) const noexcept;
+
+private:
+	void UpdatePair(size_t a, size_t b, float sigma, float epsilon) noexcept;
+	void UpdateChargeProducts() noexcept;
+	void UpdateEnergyShifts() noexcept;
+
+	double ComputeRange(const ForceFieldInput& input, size_t begin, size_t end, float* forcesXYZ, double& virialOut) const noexcept;
+
+	float m_cutoff;
+	float m_coulombConstant = 1.0f;
+	Evergreen::JobSystem* m_jobSystem;
+	double m_virial = 0.0;
+
+	ElementParameters m_elementParameters[MaxElementTypes];
+
+	// Flat [a * MaxElementTypes + b] tables so the kernel can look up both atoms' terms with a single index
+	std::vector<float> m_c6;
+	std::vector<float> m_c12;
+	std::vector<float> m_chargeProduct;
+	std::vector<float> m_energyShift;
+
+	// One force buffer per range after the first (the first range writes straight into the output)
+	std::vector<std::vector<float>> m_threadForces;
+};
@@ -0,0 +1,44 @@
+#include "MortonOrder.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+void ComputeMortonOrder(const float* positionsXYZ, size_t count, std::vector<uint32_t>& orderOut)
+{
+	orderOut.resize(count);
+	std::iota(orderOut.begin(), orderOut.end(), 0u);
+	if (count < 2)
+		return;
+
+	float boundsMin[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+	float boundsMax[3] = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+	for (size_t iii = 0; iii < count; ++iii)
+	{
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			boundsMin[axis] = std::min(boundsMin[axis], positionsXYZ[3 * iii + axis]);
+			boundsMax[axis] = std::max(boundsMax[axis], positionsXYZ[3 * iii + axis]);
+		}
+	}
+
+	// Quantize each axis to 10 bits over the bounding box
+	float scale[3];
+	for (unsigned int axis = 0; axis < 3; ++axis)
+	{
+		float extent = boundsMax[axis] - boundsMin[axis];
+		scale[axis] = extent > 0.0f ? 1023.0f / extent : 0.0f;
+	}
+
+	std::vector<uint32_t> keys(count);
+	for (size_t iii = 0; iii < count; ++iii)
+	{
+		const float* p = &positionsXYZ[3 * iii];
+		keys[iii] = MortonEncode3(
+			static_cast<uint32_t>((p[0] - boundsMin[0]) * scale[0]),
+			static_cast<uint32_t>((p[1] - boundsMin[1]) * scale[1]),
+			static_cast<uint32_t>((p[2] - boundsMin[2]) * scale[2])
+		);
+	}
+
+	std::stable_sort(orderOut.begin(), orderOut.end(), [&keys](uint32_t lhs, uint32_t rhs) { return keys[lhs] < keys[rhs]; });
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// NOTE: This file has no Windows/DirectX dependencies. Positions are expected as tightly packed xyz
+//       triplets (which is exactly the layout of std::vector<DirectX::XMFLOAT3>).
+
+// Interleave the low 10 bits of x, y and z into a 30-bit Morton (Z-order) code
+[[nodiscard]] constexpr uint32_t MortonEncode3(uint32_t x, uint32_t y, uint32_t z) noexcept
+{
+	auto spread = [](uint32_t v) constexpr -> uint32_t
+	{
+		v &= 0x000003FF;
+		v = (v | (v << 16)) & 0x030000FF;
+		v = (v | (v << 8)) & 0x0300F00F;
+		v = (v | (v << 4)) & 0x030C30C3;
+		v = (v | (v << 2)) & 0x09249249;
+		return v;
+	};
+	return spread(x) | (spread(y) << 1) | (spread(z) << 2);
+}
+
+// Compute the order that sorts the points along a Z-order curve over their bounding box. 'orderOut' is resized to
+// 'count' and orderOut[newIndex] = oldIndex. Points with the same Morton code keep their relative order, so sorting
+// points that are already sorted returns the identity permutation.
+void ComputeMortonOrder(const float* positionsXYZ, size_t count, std::vector<uint32_t>& orderOut);
+
+// Reorder 'values' so that values[newIndex] = old values[order[newIndex]]. 'scratch' is used as the temporary
+// buffer so repeated calls do not have to allocate
+template<typename T, typename Allocator, typename ScratchAllocator>
+void ApplyPermutation(std::vector<T, Allocator>& values, const std::vector<uint32_t>& order, std::vector<T, ScratchAllocator>& scratch)
+{
+	scratch.resize(values.size());
+	for (size_t iii = 0; iii < order.size(); ++iii)
+		scratch[iii] = values[order[iii]];
+
+	// NOTE: Copy back rather than swapping so that 'values' keeps its allocation (other code may hold pointers into it)
+	std::copy(scratch.begin(), scratch.end(), values.begin());
+}
@@ -0,0 +1,232 @@
+#include "NeighborList.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Upper bound on the number of grid cells per atom. If the atoms are spread out far more than the list radius
+// (ex. a handful of atoms in a huge box), the cells are made larger rather than allocating a mostly empty grid
+static constexpr size_t MaxCellsPerAtom = 8;
+
+NeighborList::NeighborList(float cutoff, float skin) noexcept :
+	m_cutoff(cutoff),
+	m_skin(skin)
+{}
+
+void NeighborList::SetCutoff(float cutoff) noexcept
+{
+	m_cutoff = cutoff;
+	m_valid = false;
+}
+void NeighborList::SetSkin(float skin) noexcept
+{
+	m_skin = skin;
+	m_valid = false;
+}
+void NeighborList::SetPeriodicBox(const PeriodicBox& box) noexcept
+{
+	m_box = box;
+	m_valid = false;
+}
+
+bool NeighborList::NeedsRebuild(const float* positionsXYZ, size_t count) noexcept
+{
+	if (!m_valid || count != AtomCount())
+		return true;
+
+	float maxDisplacementSquared = 0.0f;
+	for (size_t iii = 0; iii < 3 * count; iii += 3)
+	{
+		// NOTE: Wrapping an atom across a periodic face moves it by a full box length, which is not real displacement
+		float dx = positionsXYZ[iii] - m_referencePositions[iii];
+		float dy = positionsXYZ[iii + 1] - m_referencePositions[iii + 1];
+		float dz = positionsXYZ[iii + 2] - m_referencePositions[iii + 2];
+		m_box.MinimumImage(dx, dy, dz);
+		maxDisplacementSquared = std::max(maxDisplacementSquared, dx * dx + dy * dy + dz * dz);
+	}
+	m_stats.MaxDisplacement = std::sqrt(maxDisplacementSquared);
+
+	const float halfSkin = 0.5f * m_skin;
+	return maxDisplacementSquared > halfSkin * halfSkin;
+}
+
+bool NeighborList::Update(const float* positionsXYZ, size_t count)
+{
+	++m_stats.Updates;
+
+	if (!NeedsRebuild(positionsXYZ, count))
+		return false;
+
+	Build(positionsXYZ, count);
+	return true;
+}
+
+void NeighborList::Build(const float* positionsXYZ, size_t count)
+{
+	++m_stats.Builds;
+	m_valid = true;
+	m_stats.MaxDisplacement = 0.0f;
+
+	m_referencePositions.assign(positionsXYZ, positionsXYZ + 3 * count);
+	m_offsets.assign(count + 1, 0u);
+	m_neighbors.clear();
+
+	if (count == 0)
+	{
+		m_stats.PairCount = 0;
+		m_stats.CellCount = 0;
+		return;
+	}
+
+	const float listRadius = ListRadius();
+	const float listRadiusSquared = listRadius * listRadius;
+
+	// Grid bounds ---------------------------------------------------------------------------------
+	// With periodic boundaries the grid covers exactly the box (so the cells on opposite faces are neighbors),
+	// otherwise it covers the bounding box of the atoms
+	float boundsMin[3];
+	float boundsExtent[3];
+	if (m_box.Enabled)
+	{
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			boundsMin[axis] = m_box.Min[axis];
+			boundsExtent[axis] = m_box.Length[axis];
+		}
+	}
+	else
+	{
+		float boundsMax[3] = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+		boundsMin[0] = boundsMin[1] = boundsMin[2] = std::numeric_limits<float>::max();
+		for (size_t iii = 0; iii < count; ++iii)
+		{
+			for (unsigned int axis = 0; axis < 3; ++axis)
+			{
+				boundsMin[axis] = std::min(boundsMin[axis], positionsXYZ[3 * iii + axis]);
+				boundsMax[axis] = std::max(boundsMax[axis], positionsXYZ[3 * iii + axis]);
+			}
+		}
+		for (unsigned int axis = 0; axis < 3; ++axis)
+			boundsExtent[axis] = boundsMax[axis] - boundsMin[axis];
+	}
+
+	// Cells must be at least as large as the list radius so that all neighbors are within the 27 surrounding cells.
+	// Periodic grids have to tile the box exactly, so there the cells are stretched to Length / floor(Length / radius)
+	size_t dims[3];
+	float cellSize[3];
+	float targetCellSize = std::max(listRadius, std::numeric_limits<float>::min());
+	auto computeDims = [&]()
+	{
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			if (m_box.Enabled)
+			{
+				dims[axis] = std::max<size_t>(1, static_cast<size_t>(boundsExtent[axis] / targetCellSize));
+				cellSize[axis] = boundsExtent[axis] / static_cast<float>(dims[axis]);
+			}
+			else
+			{
+				dims[axis] = std::max<size_t>(1, static_cast<size_t>(boundsExtent[axis] / targetCellSize) + 1);
+				cellSize[axis] = targetCellSize;
+			}
+		}
+	};
+	computeDims();
+	while (dims[0] * dims[1] * dims[2] > MaxCellsPerAtom * count)
+	{
+		targetCellSize *= 2.0f;
+		computeDims();
+	}
+	const size_t cellCount = dims[0] * dims[1] * dims[2];
+	m_stats.CellCount = cellCount;
+
+	const float invCellSize[3] = { 1.0f / cellSize[0], 1.0f / cellSize[1], 1.0f / cellSize[2] };
+	auto cellCoordinate = [&](float p, unsigned int axis) -> size_t
+	{
+		float offset = p - boundsMin[axis];
+		if (m_box.Enabled)
+			offset -= boundsExtent[axis] * std::floor(offset * m_box.InvLength[axis]); // Atoms may not have been wrapped yet
+		return std::min(static_cast<size_t>(std::max(offset, 0.0f) * invCellSize[axis]), dims[axis] - 1);
+	};
+
+	// Bin the atoms (counting sort so the atoms in each cell end up contiguous and in increasing index order) -----
+	m_atomCells.resize(count);
+	m_cellStart.assign(cellCount + 1, 0u);
+	for (size_t iii = 0; iii < count; ++iii)
+	{
+		const float* p = &positionsXYZ[3 * iii];
+		const size_t cell = (cellCoordinate(p[2], 2) * dims[1] + cellCoordinate(p[1], 1)) * dims[0] + cellCoordinate(p[0], 0);
+		m_atomCells[iii] = static_cast<uint32_t>(cell);
+		++m_cellStart[cell + 1];
+	}
+	for (size_t cell = 0; cell < cellCount; ++cell)
+		m_cellStart[cell + 1] += m_cellStart[cell];
+
+	m_cellAtoms.resize(count);
+	{
+		std::vector<uint32_t> cursor(m_cellStart.begin(), m_cellStart.end() - 1);
+		for (size_t iii = 0; iii < count; ++iii)
+			m_cellAtoms[cursor[m_atomCells[iii]]++] = static_cast<uint32_t>(iii);
+	}
+
+	// The (up to 3) distinct neighboring cell coordinates along one axis. Periodic grids wrap around, and when an
+	// axis has fewer than 3 cells the wrapped coordinates repeat, so duplicates are dropped to avoid double counting
+	auto neighborCoordinates = [&](size_t c, unsigned int axis, size_t out[3]) -> unsigned int
+	{
+		const size_t n = dims[axis];
+		unsigned int outCount = 0;
+		for (int offset = -1; offset <= 1; ++offset)
+		{
+			size_t coordinate;
+			if (m_box.Enabled)
+				coordinate = (c + n - 1 + static_cast<size_t>(offset + 1)) % n;
+			else if ((offset < 0 && c == 0) || (offset > 0 && c + 1 >= n))
+				continue;
+			else
+				coordinate = c + offset;
+
+			if (std::find(out, out + outCount, coordinate) == out + outCount)
+				out[outCount++] = coordinate;
+		}
+		return outCount;
+	};
+
+	// Collect the pairs. Atoms are visited in index order so the CSR arrays can be appended to directly -------
+	for (size_t iii = 0; iii < count; ++iii)
+	{
+		m_offsets[iii] = static_cast<uint32_t>(m_neighbors.size());
+
+		const float* p = &positionsXYZ[3 * iii];
+		const size_t cell = m_atomCells[iii];
+		size_t xs[3], ys[3], zs[3];
+		const unsigned int xCount = neighborCoordinates(cell % dims[0], 0, xs);
+		const unsigned int yCount = neighborCoordinates((cell / dims[0]) % dims[1], 1, ys);
+		const unsigned int zCount = neighborCoordinates(cell / (dims[0] * dims[1]), 2, zs);
+
+		for (unsigned int z = 0; z < zCount; ++z)
+		{
+			for (unsigned int y = 0; y < yCount; ++y)
+			{
+				for (unsigned int x = 0; x < xCount; ++x)
+				{
+					const size_t neighborCell = (zs[z] * dims[1] + ys[y]) * dims[0] + xs[x];
+					for (uint32_t jjj = m_cellStart[neighborCell]; jjj < m_cellStart[neighborCell + 1]; ++jjj)
+					{
+						const uint32_t other = m_cellAtoms[jjj];
+						if (other <= iii)
+							continue;
+
+						const float* q = &positionsXYZ[3 * static_cast<size_t>(other)];
+						float dx = q[0] - p[0];
+						float dy = q[1] - p[1];
+						float dz = q[2] - p[2];
+						m_box.MinimumImage(dx, dy, dz);
+						if (dx * dx + dy * dy + dz * dz < listRadiusSquared)
+							m_neighbors.push_back(other);
+					}
+				}
+			}
+		}
+	}
+	m_offsets[count] = static_cast<uint32_t>(m_neighbors.size());
+	m_stats.PairCount = m_neighbors.size();
+}
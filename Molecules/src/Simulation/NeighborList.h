@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "PeriodicBox.h"
+
+// NOTE: This file has no Windows/DirectX dependencies. Positions are expected as tightly packed xyz
+//       triplets (which is exactly the layout of std::vector<DirectX::XMFLOAT3>).
+
+// Verlet neighbor list for pair interactions.
+//
+// Every pair of atoms closer than (cutoff + skin) is recorded when the list is built. As long as no atom has
+// moved more than skin / 2 since then, no pair that was outside the list can have come within the cutoff,
+// so the list remains valid and does not need to be rebuilt every step.
+//
+// Builds use a uniform cell grid with cells of size (cutoff + skin) so each atom only has to be compared
+// against the atoms in its own and the 26 surrounding cells. The result is a half list (each pair is stored
+// once, under the lower index) in CSR form: the neighbors of atom i are Neighbors()[Offsets()[i] .. Offsets()[i + 1]).
+class NeighborList
+{
+public:
+	struct Stats
+	{
+		uint64_t Updates = 0;			// Number of calls to Update()
+		uint64_t Builds = 0;			// Number of times the list was actually rebuilt
+		size_t PairCount = 0;			// Number of pairs in the current list
+		size_t CellCount = 0;			// Number of cells in the grid used for the most recent build
+		float MaxDisplacement = 0.0f;	// Largest distance any atom has moved since the last build (as of the most recent Update())
+
+		[[nodiscard]] inline double UpdatesPerBuild() const noexcept { return Builds == 0 ? 0.0 : static_cast<double>(Updates) / Builds; }
+	};
+
+	NeighborList(float cutoff, float skin) noexcept;
+	NeighborList(const NeighborList&) = delete;
+	NeighborList& operator=(const NeighborList&) = delete;
+
+	// Rebuilds the list if the number of atoms changed or any atom has moved more than half the skin since the
+	// last build. Returns true if the list was rebuilt
+	bool Update(const float* positionsXYZ, size_t count);
+	void Build(const float* positionsXYZ, size_t count);
+	[[nodiscard]] bool NeedsRebuild(const float* positionsXYZ, size_t count) noexcept;
+
+	// Force a rebuild on the next call to Update() (ex. after the atoms have been reordered)
+	inline void Invalidate() noexcept { m_valid = false; }
+
+	// Changing either value invalidates the list (it will be rebuilt on the next call to Update())
+	void SetCutoff(float cutoff) noexcept;
+	void SetSkin(float skin) noexcept;
+	// With a periodic box, the cell grid wraps across the faces of the box and distances use the minimum image.
+	// ListRadius() must not exceed half of the smallest box length
+	void SetPeriodicBox(const PeriodicBox& box) noexcept;
+	[[nodiscard]] inline const PeriodicBox& GetPeriodicBox() const noexcept { return m_box; }
+	[[nodiscard]] inline float Cutoff() const noexcept { return m_cutoff; }
+	[[nodiscard]] inline float Skin() const noexcept { return m_skin; }
+	[[nodiscard]] inline float ListRadius() const noexcept { return m_cutoff + m_skin; }
+
+	[[nodiscard]] inline const std::vector<uint32_t>& Offsets() const noexcept { return m_offsets; }
+	[[nodiscard]] inline const std::vector<uint32_t>& Neighbors() const noexcept { return m_neighbors; }
+	[[nodiscard]] inline std::span<const uint32_t> NeighborsOf(size_t atom) const noexcept
+	{
+		return { m_neighbors.data() + m_offsets[atom], m_neighbors.data() + m_offsets[atom + 1] };
+	}
+	[[nodiscard]] inline size_t AtomCount() const noexcept { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+	[[nodiscard]] inline size_t PairCount() const noexcept { return m_neighbors.size(); }
+
+	[[nodiscard]] inline const Stats& GetStats() const noexcept { return m_stats; }
+	inline void ResetStats() noexcept
+	{
+		m_stats.Updates = 0;
+		m_stats.Builds = 0;
+	}
+
+private:
+	float m_cutoff;
+	float m_skin;
+	bool m_valid = false;
+	PeriodicBox m_box;
+
+	// CSR neighbor list
+	std::vector<uint32_t> m_offsets;
+	std::vector<uint32_t> m_neighbors;
+
+	// Positions at the time of the last build, used to measure how far each atom has moved
+	std::vector<float> m_referencePositions;
+
+	// Cell grid (also CSR - the atoms in cell c are m_cellAtoms[m_cellStart[c] .. m_cellStart[c + 1]))
+	std::vector<uint32_t> m_atomCells;
+	std::vector<uint32_t> m_cellStart;
+	std::vector<uint32_t> m_cellAtoms;
+
+	Stats m_stats;
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "SampleRing.h"
+
+// NOTE: This file has no Windows/DirectX dependencies.
+
+// Snapshot of the system-wide observables after a simulation step. Units are the simulation's own (Boltzmann's
+// constant is 1, so Temperature is in energy units)
+struct ObservableSample
+{
+	static constexpr size_t MaxElementTypes = 16;
+
+	uint64_t Step = 0;
+	double Time = 0.0;
+
+	double KineticEnergy = 0.0;
+	double PotentialEnergy = 0.0;
+	double Temperature = 0.0;	// 2 KE / (3 N)
+	double Pressure = 0.0;		// (2 KE + virial) / (3 V)
+	double Momentum[3] = { 0.0, 0.0, 0.0 };
+
+	uint32_t AtomCount = 0;
+	uint32_t ElementCounts[MaxElementTypes] = {};
+
+	[[nodiscard]] inline double TotalEnergy() const noexcept { return KineticEnergy + PotentialEnergy; }
+};
+
+// Samples published by the Simulation after every step. The UI and the trajectory recorder each read from it at
+// their own pace without ever blocking the simulation
+using ObservableRing = SampleRing<ObservableSample, 256>;
+
+// Per-thread partial sums of the reductions that are folded into the integration loops. Cache-line aligned so the
+// threads' accumulators never share a line
+struct alignas(64) ObservablePartialSums
+{
+	double MassVelocitySquared = 0.0;	// sum of m v^2 (twice the kinetic energy)
+	double Momentum[3] = { 0.0, 0.0, 0.0 };
+
+	// Promoted to double before multiplying, so fast atoms don't lose precision in float before being accumulated
+	inline void Add(float mass, float vx, float vy, float vz) noexcept
+	{
+		const double m = mass;
+		const double x = vx;
+		const double y = vy;
+		const double z = vz;
+		MassVelocitySquared += m * (x * x + y * y + z * z);
+		Momentum[0] += m * x;
+		Momentum[1] += m * y;
+		Momentum[2] += m * z;
+	}
+	inline void Add(const ObservablePartialSums& other) noexcept
+	{
+		MassVelocitySquared += other.MassVelocitySquared;
+		Momentum[0] += other.Momentum[0];
+		Momentum[1] += other.Momentum[1];
+		Momentum[2] += other.Momentum[2];
+	}
+};
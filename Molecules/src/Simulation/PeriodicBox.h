@@ -0,0 +1,76 @@
+#pragma once
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+	#include <emmintrin.h>
+	#define PERIODIC_BOX_SSE
+#endif
+
+// NOTE: This file has no Windows/DirectX dependencies.
+
+// Axis-aligned box with periodic boundaries. Positions are wrapped into [Min, Min + Length) and displacements
+// between atoms use the minimum-image convention (the nearest periodic copy of the other atom). When 'Enabled'
+// is false, every function is a no-op so callers can use the same code path for open/reflective boundaries.
+struct PeriodicBox
+{
+	bool Enabled = false;
+	float Min[3] = { 0.0f, 0.0f, 0.0f };
+	float Length[3] = { 1.0f, 1.0f, 1.0f };
+	float InvLength[3] = { 1.0f, 1.0f, 1.0f };
+
+	PeriodicBox() noexcept = default;
+	PeriodicBox(const float min[3], const float length[3]) noexcept :
+		Enabled(true)
+	{
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			Min[axis] = min[axis];
+			Length[axis] = length[axis];
+			InvLength[axis] = 1.0f / length[axis];
+		}
+	}
+
+	// Smallest box length - a neighbor/interaction radius must not exceed half of this for the minimum image to be unique
+	[[nodiscard]] inline float SmallestLength() const noexcept
+	{
+		return std::fmin(Length[0], std::fmin(Length[1], Length[2]));
+	}
+
+	inline void MinimumImage(float& dx, float& dy, float& dz) const noexcept
+	{
+		if (!Enabled)
+			return;
+		dx -= Length[0] * std::round(dx * InvLength[0]);
+		dy -= Length[1] * std::round(dy * InvLength[1]);
+		dz -= Length[2] * std::round(dz * InvLength[2]);
+	}
+
+	// Wrap the position into the box. Returns the amount each coordinate was shifted by
+	inline void Wrap(float* position, float* shiftOut = nullptr) const noexcept
+	{
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			float shift = 0.0f;
+			if (Enabled)
+			{
+				shift = -Length[axis] * std::floor((position[axis] - Min[axis]) * InvLength[axis]);
+				position[axis] += shift;
+			}
+			if (shiftOut != nullptr)
+				shiftOut[axis] = shift;
+		}
+	}
+
+#ifdef PERIODIC_BOX_SSE
+	// Minimum image for 4 displacements at once. Rounds to nearest with cvtps (the default MXCSR rounding mode), which
+	// is fine for any displacement that fits in an int32 multiple of the box length
+	inline void MinimumImage(__m128& dx, __m128& dy, __m128& dz) const noexcept
+	{
+		if (!Enabled)
+			return;
+		dx = _mm_sub_ps(dx, _mm_mul_ps(_mm_set1_ps(Length[0]), _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(dx, _mm_set1_ps(InvLength[0]))))));
+		dy = _mm_sub_ps(dy, _mm_mul_ps(_mm_set1_ps(Length[1]), _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(dy, _mm_set1_ps(InvLength[1]))))));
+		dz = _mm_sub_ps(dz, _mm_mul_ps(_mm_set1_ps(Length[2]), _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(dz, _mm_set1_ps(InvLength[2]))))));
+	}
+#endif
+};
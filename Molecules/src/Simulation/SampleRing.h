@@ -0,0 +1,126 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// NOTE: This file has no Windows/DirectX dependencies.
+
+// Fixed-size ring of samples with a single producer and any number of consumers, none of which ever take a lock
+// or wait on each other. The producer always succeeds (overwriting the oldest sample once the ring is full), so a
+// slow consumer can never stall the producer - it just misses samples.
+//
+// Each slot is a seqlock: the producer makes the slot's sequence odd while writing and then sets it to a value that
+// identifies the sample, and a reader only accepts a copy if the sequence was that value both before and after
+// copying. The payload is stored as relaxed atomic words so concurrent reads of a slot being overwritten are not a
+// data race (the torn copy is simply rejected).
+template<typename T, size_t Capacity>
+class SampleRing
+{
+	static_assert(std::is_trivially_copyable_v<T>, "SampleRing only supports trivially copyable samples");
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SampleRing capacity must be a power of 2");
+
+	static constexpr size_t WordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+public:
+	SampleRing() noexcept
+	{
+		for (Slot& slot : m_slots)
+			slot.sequence.store(0, std::memory_order_relaxed);
+	}
+	SampleRing(const SampleRing&) = delete;
+	SampleRing& operator=(const SampleRing&) = delete;
+
+	// Producer only
+	void Publish(const T& sample) noexcept
+	{
+		const uint64_t index = m_published.load(std::memory_order_relaxed);
+		Slot& slot = m_slots[index & (Capacity - 1)];
+
+		uint64_t words[WordCount] = {};
+		std::memcpy(words, &sample, sizeof(T));
+
+		slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (size_t iii = 0; iii < WordCount; ++iii)
+			slot.words[iii].store(words[iii], std::memory_order_relaxed);
+		slot.sequence.store(2 * index + 2, std::memory_order_release);
+
+		m_published.store(index + 1, std::memory_order_release);
+	}
+
+	// Total number of samples ever published. Sample n (0-based) is only available while n >= PublishedCount() - Capacity
+	[[nodiscard]] inline uint64_t PublishedCount() const noexcept { return m_published.load(std::memory_order_acquire); }
+
+	// Most recent sample. False if nothing has been published yet
+	bool ReadLatest(T& sampleOut) const noexcept
+	{
+		while (true)
+		{
+			const uint64_t published = PublishedCount();
+			if (published == 0)
+				return false;
+			if (TryRead(published - 1, sampleOut))
+				return true;
+			// The producer lapped us while copying - try again with the new latest sample
+		}
+	}
+
+	// Copies up to 'maxCount' samples, starting at 'cursor' (a per-consumer position, initially 0), and advances the
+	// cursor past them. If the consumer fell more than Capacity samples behind, the missed samples are skipped and
+	// 'droppedOut' (if provided) is incremented by how many were lost
+	size_t Read(uint64_t& cursor, T* samplesOut, size_t maxCount, uint64_t* droppedOut = nullptr) const noexcept
+	{
+		size_t count = 0;
+		while (count < maxCount)
+		{
+			const uint64_t published = PublishedCount();
+			if (cursor >= published)
+				break;
+
+			if (published - cursor > Capacity)
+			{
+				if (droppedOut != nullptr)
+					*droppedOut += published - Capacity - cursor;
+				cursor = published - Capacity;
+			}
+
+			if (TryRead(cursor, samplesOut[count]))
+				++count;
+			else if (droppedOut != nullptr)
+				++(*droppedOut);
+			++cursor;
+		}
+		return count;
+	}
+
+private:
+	bool TryRead(uint64_t index, T& sampleOut) const noexcept
+	{
+		const Slot& slot = m_slots[index & (Capacity - 1)];
+		const uint64_t expected = 2 * index + 2;
+		if (slot.sequence.load(std::memory_order_acquire) != expected)
+			return false;
+
+		uint64_t words[WordCount];
+		for (size_t iii = 0; iii < WordCount; ++iii)
+			words[iii] = slot.words[iii].load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) != expected)
+			return false;
+
+		std::memcpy(&sampleOut, words, sizeof(T));
+		return true;
+	}
+
+	struct alignas(64) Slot
+	{
+		std::atomic<uint64_t> sequence;
+		std::atomic<uint64_t> words[WordCount];
+	};
+
+	Slot m_slots[Capacity];
+	alignas(64) std::atomic<uint64_t> m_published = 0;
+};
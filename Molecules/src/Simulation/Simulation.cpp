@@ -1,9 +1,14 @@
 #include "Simulation.h"
+#include "Evergreen/Utils/JobSystem.h"
 
+// Jobs are only worth scheduling for the integration loops when each one gets at least this many atoms
+static constexpr size_t MinAtomsPerJob = 16384;
 
+static_assert(AtomicMasses.size() <= ObservableSample::MaxElementTypes, "Not enough element counts in ObservableSample");
 
 Simulation::Simulation() noexcept :
 	m_isPaused(true),
+	m_neighborList(1.0f, 0.3f),
 	m_boxMax(3.0f)
 {}
 
@@ -11,37 +16,382 @@ void Simulation::Add(Element element, const DirectX::XMFLOAT3& position, const D
 {
 	m_elementTypes.push_back(element);
 	m_positions.push_back(position);
+	m_previousPositions.push_back(position);
 	m_velocities.push_back(velocity);
+
+	m_atomIndices.push_back(m_atomIds.size());
+	m_atomIds.push_back(static_cast<unsigned int>(m_atomIndices.size() - 1));
+
+	++m_elementCounts[static_cast<size_t>(element)];
+	m_observableSums.Add(AtomicMasses[static_cast<int>(element)], velocity.x, velocity.y, velocity.z);
+
+	m_forcesAreValid = false;
 }
 
+#ifndef MOLECULES_HEADLESS
 void Simulation::Update(const Evergreen::Timer& timer)
+{
+	Step(static_cast<float>(timer.GetElapsedSeconds()));
+}
+#endif
+
+void Simulation::Step(float timeDelta)
 {
 	EG_ASSERT(m_positions.size() == m_velocities.size(), "Invalid");
 	EG_ASSERT(m_positions.size() == m_elementTypes.size(), "Invalid");
 
-	float timeDelta = static_cast<float>(timer.GetElapsedSeconds());
+	// Keep the state from before this step so rendering can interpolate between the two. This is done even when
+	// paused/skipped so that the previous and current states match and the interpolation does not move anything
+	// NOTE: copy element-wise rather than assigning the vector so that m_previousPositions is never reallocated
+	//       (RenderObjects hold pointers into it)
+	EG_ASSERT(m_previousPositions.size() == m_positions.size(), "Invalid");
+	std::copy(m_positions.begin(), m_positions.end(), m_previousPositions.begin());
 
 	if (m_isPaused)
 		return;
 
-	if (timeDelta > 0.1)
+	if (timeDelta > MaxTimeStep)
+		return;
+
+	if (m_spatialSortInterval > 0 && ++m_stepsSinceSpatialSort >= m_spatialSortInterval)
+		SortAtomsSpatially();
+
+	if (m_forceField == nullptr)
+		IntegrateBallistic(timeDelta);
+	else
+		IntegrateVelocityVerlet(timeDelta);
+
+	++m_stepCount;
+	m_simulationTime += timeDelta;
+	PublishObservables();
+
+	if (m_trajectoryWriter != nullptr && m_stepCount % m_trajectoryInterval == 0)
+		RecordTrajectoryFrame();
+}
+
+void Simulation::SortAtomsSpatially()
+{
+	m_stepsSinceSpatialSort = 0;
+
+	ComputeMortonOrder(reinterpret_cast<const float*>(m_positions.data()), m_positions.size(), m_spatialOrder);
+
+	// Nothing to do if the atoms are already in order
+	bool isIdentity = true;
+	for (size_t iii = 0; iii < m_spatialOrder.size() && isIdentity; ++iii)
+		isIdentity = m_spatialOrder[iii] == iii;
+	if (isIdentity)
 		return;
 
-	float radius = 0.0f;
-	for (unsigned int iii = 0; iii < m_positions.size(); ++iii)
+	// NOTE: ApplyPermutation copies back into the existing arrays (rather than swapping them) because the
+	//       render objects hold pointers into m_positions/m_previousPositions
+	SimulationVector<DirectX::XMFLOAT3> scratch;
+	ApplyPermutation(m_positions, m_spatialOrder, scratch);
+	ApplyPermutation(m_previousPositions, m_spatialOrder, scratch);
+	ApplyPermutation(m_velocities, m_spatialOrder, scratch);
+	if (m_forces.size() == m_positions.size())
+		ApplyPermutation(m_forces, m_spatialOrder, scratch);
+
+	SimulationVector<Element> elementScratch;
+	ApplyPermutation(m_elementTypes, m_spatialOrder, elementScratch);
+
+	SimulationVector<unsigned int> idScratch;
+	ApplyPermutation(m_atomIds, m_spatialOrder, idScratch);
+	for (size_t iii = 0; iii < m_atomIds.size(); ++iii)
+		m_atomIndices[m_atomIds[iii]] = iii;
+
+	// The neighbor list refers to atoms by index
+	m_neighborList.Invalidate();
+
+	++m_atomOrderVersion;
+}
+
+void Simulation::ReflectOffWalls(unsigned int atom) noexcept
+{
+	float radius = AtomicRadii[static_cast<int>(m_elementTypes[atom])];
+
+	if (m_positions[atom].x + radius > m_boxMax || m_positions[atom].x - radius < -m_boxMax)
+		m_velocities[atom].x *= -1;
+
+	if (m_positions[atom].y + radius > m_boxMax || m_positions[atom].y - radius < -m_boxMax)
+		m_velocities[atom].y *= -1;
+
+	if (m_positions[atom].z + radius > m_boxMax || m_positions[atom].z - radius < -m_boxMax)
+		m_velocities[atom].z *= -1;
+}
+
+void Simulation::WrapIntoBox(unsigned int atom) noexcept
+{
+	float shift[3];
+	GetPeriodicBox().Wrap(&m_positions[atom].x, shift);
+
+	// Move the previous position by the same amount so that rendering interpolates from just outside the face the
+	// atom re-entered through, rather than streaking across the whole box
+	m_previousPositions[atom].x += shift[0];
+	m_previousPositions[atom].y += shift[1];
+	m_previousPositions[atom].z += shift[2];
+}
+
+void Simulation::ParallelForAtoms(const std::function<void(size_t, size_t, ObservablePartialSums&)>& fn)
+{
+	// Each range accumulates into its own partial sums, which are then reduced into m_observableSums
+	const size_t count = m_positions.size();
+	const size_t rangeCount = m_jobSystem == nullptr ? 1 : std::max<size_t>(1, std::min<size_t>(m_jobSystem->ThreadCount(), count / MinAtomsPerJob));
+	m_threadObservableSums.assign(rangeCount, ObservablePartialSums());
+
+	if (rangeCount == 1)
+		fn(0, count, m_threadObservableSums[0]);
+	else
+	{
+		Evergreen::JobCounter counter;
+		for (size_t r = 1; r < rangeCount; ++r)
+			m_jobSystem->Run([this, &fn, r, rangeCount, count]() { fn(count * r / rangeCount, count * (r + 1) / rangeCount, m_threadObservableSums[r]); }, &counter);
+
+		fn(0, count / rangeCount, m_threadObservableSums[0]);
+
+		m_jobSystem->Wait(counter);
+	}
+
+	m_observableSums = ObservablePartialSums();
+	for (const ObservablePartialSums& sums : m_threadObservableSums)
+		m_observableSums.Add(sums);
+}
+
+void Simulation::IntegrateBallistic(float timeDelta)
+{
+	ParallelForAtoms([this, timeDelta](size_t begin, size_t end, ObservablePartialSums& sums)
+		{
+			for (size_t iii = begin; iii < end; ++iii)
+			{
+				m_positions[iii].x += m_velocities[iii].x * timeDelta;
+				m_positions[iii].y += m_velocities[iii].y * timeDelta;
+				m_positions[iii].z += m_velocities[iii].z * timeDelta;
+
+				if (m_boundaryMode == BoundaryMode::PERIODIC)
+					WrapIntoBox(static_cast<unsigned int>(iii));
+				else
+					ReflectOffWalls(static_cast<unsigned int>(iii));
+
+				sums.Add(AtomicMasses[static_cast<int>(m_elementTypes[iii])], m_velocities[iii].x, m_velocities[iii].y, m_velocities[iii].z);
+			}
+		}
+	);
+	m_potentialEnergy = 0.0;
+
+	// Without a force field, nothing reads the neighbor list, so it is not kept up to date. It is rebuilt on the first
+	// ComputeForces() after a force field is set (SetForceField changes the cutoff, which invalidates it)
+}
+
+void Simulation::IntegrateVelocityVerlet(float timeDelta)
+{
+	// Forces are carried over from the end of the previous step. They only need to be computed here for the very
+	// first step (or after atoms were added/the force field was changed)
+	if (!m_forcesAreValid)
+		ComputeForces();
+
+	const float halfTimeDelta = 0.5f * timeDelta;
+
+	// v(t + dt/2) = v(t) + a(t) dt/2		x(t + dt) = x(t) + v(t + dt/2) dt
+	// NOTE: The sums from this pass are discarded (the observables are taken at the end of the step)
+	ParallelForAtoms([this, timeDelta, halfTimeDelta](size_t begin, size_t end, ObservablePartialSums&)
+		{
+			for (size_t iii = begin; iii < end; ++iii)
+			{
+				float invMass = 1.0f / AtomicMasses[static_cast<int>(m_elementTypes[iii])];
+				m_velocities[iii].x += m_forces[iii].x * invMass * halfTimeDelta;
+				m_velocities[iii].y += m_forces[iii].y * invMass * halfTimeDelta;
+				m_velocities[iii].z += m_forces[iii].z * invMass * halfTimeDelta;
+
+				m_positions[iii].x += m_velocities[iii].x * timeDelta;
+				m_positions[iii].y += m_velocities[iii].y * timeDelta;
+				m_positions[iii].z += m_velocities[iii].z * timeDelta;
+
+				if (m_boundaryMode == BoundaryMode::PERIODIC)
+					WrapIntoBox(static_cast<unsigned int>(iii));
+			}
+		}
+	);
+
+	// a(t + dt)
+	ComputeForces();
+
+	// v(t + dt) = v(t + dt/2) + a(t + dt) dt/2, with the kinetic energy/momentum reduction folded in while the
+	// velocities are in registers anyway
+	ParallelForAtoms([this, halfTimeDelta](size_t begin, size_t end, ObservablePartialSums& sums)
+		{
+			for (size_t iii = begin; iii < end; ++iii)
+			{
+				const float mass = AtomicMasses[static_cast<int>(m_elementTypes[iii])];
+				const float invMass = 1.0f / mass;
+				m_velocities[iii].x += m_forces[iii].x * invMass * halfTimeDelta;
+				m_velocities[iii].y += m_forces[iii].y * invMass * halfTimeDelta;
+				m_velocities[iii].z += m_forces[iii].z * invMass * halfTimeDelta;
+
+				if (m_boundaryMode == BoundaryMode::REFLECTIVE)
+					ReflectOffWalls(static_cast<unsigned int>(iii));
+
+				sums.Add(mass, m_velocities[iii].x, m_velocities[iii].y, m_velocities[iii].z);
+			}
+		}
+	);
+}
+
+void Simulation::PublishObservables()
+{
+	ObservableSample sample;
+	sample.Step = m_stepCount;
+	sample.Time = m_simulationTime;
+	sample.KineticEnergy = KineticEnergy();
+	sample.PotentialEnergy = m_potentialEnergy;
+	sample.Momentum[0] = m_observableSums.Momentum[0];
+	sample.Momentum[1] = m_observableSums.Momentum[1];
+	sample.Momentum[2] = m_observableSums.Momentum[2];
+
+	const size_t atomCount = m_positions.size();
+	sample.AtomCount = static_cast<uint32_t>(atomCount);
+	std::copy(m_elementCounts.begin(), m_elementCounts.end(), sample.ElementCounts);
+
+	// Equipartition (3 degrees of freedom per atom, k_B = 1) and the virial equation of state
+	const double volume = 8.0 * static_cast<double>(m_boxMax) * m_boxMax * m_boxMax;
+	const double virial = m_forceField != nullptr ? m_forceField->Virial() : 0.0;
+	sample.Temperature = atomCount > 0 ? 2.0 * sample.KineticEnergy / (3.0 * atomCount) : 0.0;
+	sample.Pressure = (2.0 * sample.KineticEnergy + virial) / (3.0 * volume);
+
+	m_observables.Publish(sample);
+}
+
+void Simulation::ComputeForces()
+{
+	EG_ASSERT(m_forceField != nullptr, "No force field");
+
+	// Only rebuilds the neighbor list if some atom has moved more than half the skin since the last build. Force fields
+	// without a cutoff (ex. BarnesHut on its own) don't use it at all
+	const float* positions = reinterpret_cast<const float*>(m_positions.data());
+	if (m_forceField->Cutoff() > 0.0f)
+		m_neighborList.Update(positions, m_positions.size());
+
+	static_assert(std::is_same_v<std::underlying_type_t<Element>, int>, "ForceFieldInput expects the Element values as int");
+
+	ForceFieldInput input;
+	input.PositionsXYZ = positions;
+	input.ElementTypes = reinterpret_cast<const int*>(m_elementTypes.data());
+	input.Count = m_positions.size();
+	input.Neighbors = &m_neighborList;
+	input.Box = m_neighborList.GetPeriodicBox();
+	EG_ASSERT(!input.Box.Enabled || m_neighborList.ListRadius() <= 0.5f * input.Box.SmallestLength(), "Neighbor list radius is larger than half the periodic box");
+
+	m_forces.resize(m_positions.size());
+	m_potentialEnergy = m_forceField->ComputeForces(input, reinterpret_cast<float*>(m_forces.data()));
+	m_forcesAreValid = true;
+}
+
+void Simulation::SetForceField(std::unique_ptr<ForceField> forceField) noexcept
+{
+	m_forceField = std::move(forceField);
+	m_forcesAreValid = false;
+	m_potentialEnergy = 0.0;
+
+	if (m_forceField != nullptr)
+		m_neighborList.SetCutoff(m_forceField->Cutoff());
+}
+
+void Simulation::SetBoundaryMode(BoundaryMode mode) noexcept
+{
+	m_boundaryMode = mode;
+	m_neighborList.SetPeriodicBox(GetPeriodicBox());
+	m_forcesAreValid = false;
+
+	if (mode == BoundaryMode::PERIODIC)
 	{
-		radius = AtomicRadii[static_cast<int>(m_elementTypes[iii])];
+		for (unsigned int iii = 0; iii < m_positions.size(); ++iii)
+			WrapIntoBox(iii);
+	}
+}
 
-		m_positions[iii].x += m_velocities[iii].x * timeDelta;
-		if (m_positions[iii].x + radius > m_boxMax || m_positions[iii].x - radius < -m_boxMax) 
-			m_velocities[iii].x *= -1;
+void Simulation::SetBoxHalfExtent(float halfExtent) noexcept
+{
+	m_boxMax = halfExtent;
+	SetBoundaryMode(m_boundaryMode);
+}
 
-		m_positions[iii].y += m_velocities[iii].y * timeDelta;
-		if (m_positions[iii].y + radius > m_boxMax || m_positions[iii].y - radius < -m_boxMax)
-			m_velocities[iii].y *= -1;
+PeriodicBox Simulation::GetPeriodicBox() const noexcept
+{
+	if (m_boundaryMode != BoundaryMode::PERIODIC)
+		return PeriodicBox();
 
-		m_positions[iii].z += m_velocities[iii].z * timeDelta;
-		if (m_positions[iii].z + radius > m_boxMax || m_positions[iii].z - radius < -m_boxMax)
-			m_velocities[iii].z *= -1;
+	const float min[3] = { -m_boxMax, -m_boxMax, -m_boxMax };
+	const float length[3] = { 2.0f * m_boxMax, 2.0f * m_boxMax, 2.0f * m_boxMax };
+	return PeriodicBox(min, length);
+}
+
+bool Simulation::StartRecording(const std::string& filename, unsigned int interval, const TrajectoryWriter::Settings& settings)
+{
+	StopRecording();
+
+	// Element types in atom id order, to match the frames
+	std::vector<int> elementTypes(m_elementTypes.size());
+	for (size_t id = 0; id < m_atomIndices.size(); ++id)
+		elementTypes[id] = static_cast<int>(m_elementTypes[m_atomIndices[id]]);
+
+	std::unique_ptr<TrajectoryWriter> writer = std::make_unique<TrajectoryWriter>();
+	if (!writer->Open(filename, elementTypes.data(), elementTypes.size(), settings))
+	{
+		EG_ERROR("Failed to open trajectory file '{}'", filename);
+		return false;
 	}
-} 
\ No newline at end of file
+
+	m_trajectoryWriter = std::move(writer);
+	m_trajectoryInterval = interval == 0 ? 1 : interval;
+	m_trajectoryPositions.resize(m_positions.size());
+	m_trajectoryVelocities.resize(m_velocities.size());
+
+	// Record the starting state as the first frame
+	RecordTrajectoryFrame();
+	return true;
+}
+
+bool Simulation::StopRecording() noexcept
+{
+	if (m_trajectoryWriter == nullptr)
+		return false;
+
+	const bool succeeded = m_trajectoryWriter->Close();
+	if (!succeeded)
+		EG_ERROR("Failed to write the trajectory file");
+	m_trajectoryWriter = nullptr;
+	return succeeded;
+}
+
+void Simulation::RecordTrajectoryFrame()
+{
+	EG_ASSERT(m_trajectoryPositions.size() == m_positions.size(), "Atoms were added while recording a trajectory");
+
+	for (size_t id = 0; id < m_atomIndices.size(); ++id)
+	{
+		m_trajectoryPositions[id] = m_positions[m_atomIndices[id]];
+		m_trajectoryVelocities[id] = m_velocities[m_atomIndices[id]];
+	}
+
+	ObservableSample observables;
+	const bool haveObservables = m_observables.ReadLatest(observables);
+
+	if (!m_trajectoryWriter->WriteFrame(m_stepCount, m_simulationTime,
+		reinterpret_cast<const float*>(m_trajectoryPositions.data()), reinterpret_cast<const float*>(m_trajectoryVelocities.data()),
+		haveObservables ? &observables : nullptr))
+	{
+		EG_ERROR("Failed to write trajectory frame - stopping the recording");
+		StopRecording();
+	}
+}
+
+std::unique_ptr<LennardJonesCoulomb> CreateDefaultForceField(float cutoff, Evergreen::JobSystem* jobSystem)
+{
+	std::unique_ptr<LennardJonesCoulomb> forceField = std::make_unique<LennardJonesCoulomb>(cutoff, jobSystem);
+
+	// The Lennard-Jones minimum is at 2^(1/6) * sigma, so with sigma = 2r / 2^(1/6) (and arithmetic mixing), the minimum
+	// for each pair of elements is at the sum of their radii
+	const float invSixthRootOfTwo = 1.0f / std::pow(2.0f, 1.0f / 6.0f);
+	for (int element = static_cast<int>(Element::Hydrogen); element < static_cast<int>(AtomicRadii.size()); ++element)
+		forceField->SetElementParameters(element, { 2.0f * AtomicRadii[element] * invSixthRootOfTwo, 1.0f, 0.0f });
+
+	return forceField;
+}
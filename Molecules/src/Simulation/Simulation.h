@@ -1,6 +1,10 @@
 #pragma once
-#include "pch.h"
-#include <Evergreen.h>
+#include "SimulationPlatform.h"
+#include "NeighborList.h"
+#include "ForceField.h"
+#include "MortonOrder.h"
+#include "Trajectory.h"
+#include "Observables.h"
 
 enum class Element
 {
@@ -33,6 +37,33 @@ constexpr std::array<float, 11> AtomicRadii{
 	}
 };
 
+// Atomic masses in unified atomic mass units
+constexpr std::array<float, 11> AtomicMasses{
+	{
+		0.0f,		// Invalid value to take up the 0 index spot
+		1.008f,		// Hydrogen
+		4.0026f,	// Helium
+		6.94f,		// Lithium
+		9.0122f,	// Beryllium
+		10.81f,		// Boron
+		12.011f,	// Carbon
+		14.007f,	// Nitrogen
+		15.999f,	// Oxygen
+		18.998f,	// Flourine
+		20.180f		// Neon
+	}
+};
+
+// Lennard-Jones + Coulomb force field with every element neutral, epsilon = 1 and sigma chosen so that the
+// potential minimum of each pair sits where the two atoms' radii touch
+std::unique_ptr<LennardJonesCoulomb> CreateDefaultForceField(float cutoff, Evergreen::JobSystem* jobSystem = nullptr);
+
+enum class BoundaryMode
+{
+	REFLECTIVE = 0,	// Atoms bounce off the walls of the box
+	PERIODIC		// Atoms leaving through one face re-enter through the opposite one and interact across the faces
+};
+
 
 class Simulation
 {
@@ -44,23 +75,130 @@ public:
 
 	void Add(Element element, const DirectX::XMFLOAT3& position, const DirectX::XMFLOAT3& velocity) noexcept;
 
+	// Steps longer than this are skipped (ex. the first frame after the window was dragged)
+	static constexpr float MaxTimeStep = 0.1f;
+
+#ifndef MOLECULES_HEADLESS
 	void Update(const Evergreen::Timer& timer);
+#endif
+	// Advance the simulation by one step of 'timeDelta' seconds (does nothing while paused)
+	void Step(float timeDelta);
+
+	// With no force field (the default), atoms move ballistically. Otherwise, the positions are integrated with
+	// velocity-Verlet using the forces from the force field. The neighbor list cutoff is updated to match
+	void SetForceField(std::unique_ptr<ForceField> forceField) noexcept;
+	ND inline ForceField* GetForceField() const noexcept { return m_forceField.get(); }
+	ND inline double PotentialEnergy() const noexcept { return m_potentialEnergy; }
+	// Kept up to date by the integration loops (and Add()), so these do not need a pass over the atoms
+	ND inline double KineticEnergy() const noexcept { return 0.5 * m_observableSums.MassVelocitySquared; }
+	ND inline DirectX::XMFLOAT3 Momentum() const noexcept
+	{
+		return { static_cast<float>(m_observableSums.Momentum[0]), static_cast<float>(m_observableSums.Momentum[1]), static_cast<float>(m_observableSums.Momentum[2]) };
+	}
+
+	// Energies, temperature, pressure, momentum and element counts are reduced inside the integration loops (no
+	// separate pass over the atoms) and published after every step. Consumers (ex. the UI) read from the ring at
+	// their own pace - see SampleRing
+	ND inline const ObservableRing& Observables() const noexcept { return m_observables; }
 
-	ND inline std::vector<DirectX::XMFLOAT3>& Positions() noexcept { return m_positions; }
-	ND inline std::vector<DirectX::XMFLOAT3>& Velocities() noexcept { return m_velocities; }
-	ND inline std::vector<Element>& ElementTypes() noexcept { return m_elementTypes; }
+	// Runs the integration loops as jobs. Only worth it for large systems - small ones (or no JobSystem) stay on the
+	// calling thread. The force field has its own JobSystem (see LennardJonesCoulomb/BarnesHut)
+	inline void SetJobSystem(Evergreen::JobSystem* jobSystem) noexcept { m_jobSystem = jobSystem; }
 
+	ND inline SimulationVector<DirectX::XMFLOAT3>& Positions() noexcept { return m_positions; }
+	ND inline SimulationVector<DirectX::XMFLOAT3>& Velocities() noexcept { return m_velocities; }
+	// Positions as they were before the most recent call to Update. Rendering interpolates between these and Positions()
+	ND inline SimulationVector<DirectX::XMFLOAT3>& PreviousPositions() noexcept { return m_previousPositions; }
+	ND inline SimulationVector<Element>& ElementTypes() noexcept { return m_elementTypes; }
+
+	// Pairs of atoms within (cutoff + skin) of each other. Kept up to date by Update(), but only actually rebuilt
+	// once some atom has moved more than half the skin
+	ND inline const NeighborList& GetNeighborList() const noexcept { return m_neighborList; }
+	ND inline NeighborList& GetNeighborList() noexcept { return m_neighborList; }
+
+	// Every so often, the per-atom arrays are reordered along a Morton (Z-order) curve so that atoms that are close in
+	// space are also close in memory, which keeps the neighbor-based kernels from missing the cache constantly. This 
+	// means an atom's index into Positions()/Velocities()/ElementTypes() can change. Each atom also has an id (assigned
+	// by Add() in increasing order) that never changes and should be used to refer to an atom across frames.
+	void SortAtomsSpatially();
+	// Sort every 'steps' simulation steps (0 disables the periodic sort)
+	inline void SetSpatialSortInterval(unsigned int steps) noexcept { m_spatialSortInterval = steps; }
+	ND inline unsigned int AtomId(size_t index) const noexcept { return m_atomIds[index]; }
+	ND inline size_t IndexOfAtom(unsigned int id) const noexcept { return m_atomIndices[id]; }
+	// Incremented every time the atoms are reordered. Anything that caches data per atom index (or pointers into
+	// the per-atom arrays) must refresh it when this changes
+	ND inline unsigned int AtomOrderVersion() const noexcept { return m_atomOrderVersion; }
+
+	// In PERIODIC mode, positions are kept inside the box and all pair displacements use the minimum image, so the
+	// neighbor list radius (cutoff + skin) must not exceed half the box length
+	void SetBoundaryMode(BoundaryMode mode) noexcept;
+	ND inline BoundaryMode GetBoundaryMode() const noexcept { return m_boundaryMode; }
+	ND PeriodicBox GetPeriodicBox() const noexcept;
+
+	// Snapshot the positions/velocities to a trajectory file every 'interval' steps. Encoding and file I/O happen off the
+	// simulation step (see TrajectoryWriter), so recording does not slow down Update() beyond copying the frame.
+	// NOTE: Atoms must not be added while recording
+	bool StartRecording(const std::string& filename, unsigned int interval, const TrajectoryWriter::Settings& settings = {});
+	bool StopRecording() noexcept;
+	ND inline bool IsRecording() const noexcept { return m_trajectoryWriter != nullptr; }
+	ND inline const TrajectoryWriter* GetTrajectoryWriter() const noexcept { return m_trajectoryWriter.get(); }
+	ND inline uint64_t StepCount() const noexcept { return m_stepCount; }
+	ND inline double SimulationTime() const noexcept { return m_simulationTime; }
+
+	// The box spans [-halfExtent, halfExtent] along each axis
+	void SetBoxHalfExtent(float halfExtent) noexcept;
+	ND inline float BoxHalfExtent() const noexcept { return m_boxMax; }
 	ND inline DirectX::XMFLOAT3 BoxScaling() const noexcept { return { m_boxMax, m_boxMax, m_boxMax }; }
 	ND inline const DirectX::XMFLOAT3* BoxTranslation() const noexcept { return &m_boxCenter; }
 
 private:
-	std::vector<DirectX::XMFLOAT3> m_positions;
-	std::vector<DirectX::XMFLOAT3> m_velocities;
-	std::vector<Element> m_elementTypes;
+	void IntegrateBallistic(float timeDelta);
+	void IntegrateVelocityVerlet(float timeDelta);
+	void ComputeForces();
+	void ReflectOffWalls(unsigned int atom) noexcept;
+	void WrapIntoBox(unsigned int atom) noexcept;
+	void RecordTrajectoryFrame();
+	void PublishObservables();
+	void ParallelForAtoms(const std::function<void(size_t, size_t, ObservablePartialSums&)>& fn);
+
+	SimulationVector<DirectX::XMFLOAT3> m_positions;
+	SimulationVector<DirectX::XMFLOAT3> m_velocities;
+	SimulationVector<DirectX::XMFLOAT3> m_previousPositions;
+	SimulationVector<Element> m_elementTypes;
+
+	// Stable ids: m_atomIds[index] is the id of the atom at that index, m_atomIndices[id] is the inverse
+	SimulationVector<unsigned int> m_atomIds;
+	SimulationVector<size_t> m_atomIndices;
+	unsigned int m_atomOrderVersion = 0;
+	unsigned int m_spatialSortInterval = 100;
+	unsigned int m_stepsSinceSpatialSort = 0;
+	std::vector<uint32_t> m_spatialOrder;
 
 	bool m_isPaused;
 
+	NeighborList m_neighborList;
+
+	std::unique_ptr<ForceField> m_forceField = nullptr;
+	SimulationVector<DirectX::XMFLOAT3> m_forces;
+	bool m_forcesAreValid = false; // Forces for the current positions (invalidated when atoms are added or the force field changes)
+	double m_potentialEnergy = 0.0;
+
+	Evergreen::JobSystem* m_jobSystem = nullptr;
+	ObservablePartialSums m_observableSums;		// As of the most recent step
+	std::vector<ObservablePartialSums> m_threadObservableSums;
+	std::array<uint32_t, ObservableSample::MaxElementTypes> m_elementCounts = {};
+	ObservableRing m_observables;
+
+	uint64_t m_stepCount = 0;
+	double m_simulationTime = 0.0;
+
+	std::unique_ptr<TrajectoryWriter> m_trajectoryWriter = nullptr;
+	unsigned int m_trajectoryInterval = 1;
+	SimulationVector<DirectX::XMFLOAT3> m_trajectoryPositions;	// Gathered into atom id order
+	SimulationVector<DirectX::XMFLOAT3> m_trajectoryVelocities;
+
 	float m_boxMax;
+	BoundaryMode m_boundaryMode = BoundaryMode::REFLECTIVE;
 
 	// This is necessary so that we can pass a pointer to this this when we create the Box RenderObject
 	const DirectX::XMFLOAT3 m_boxCenter = { 0.0f, 0.0f, 0.0f };
@@ -0,0 +1,50 @@
+#pragma once
+
+// The Simulation is also compiled without Evergreen/Windows/DirectX by the headless batch runner (MoleculesBatch),
+// which defines MOLECULES_HEADLESS. In that case, this provides the few things the simulation code uses from them.
+#ifdef MOLECULES_HEADLESS
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// ND, the logging macros and EG_ASSERT come from Evergreen's headless stand-ins (Evergreen/headless), which are also
+// what the standard library only parts of Evergreen that the simulation uses (ex. JobSystem) build against
+#include "Evergreen/Core.h"
+
+template<typename T>
+using SimulationVector = std::vector<T>;
+
+namespace DirectX
+{
+// Layout compatible with DirectXMath's XMFLOAT3
+struct XMFLOAT3
+{
+	float x;
+	float y;
+	float z;
+
+	XMFLOAT3() = default;
+	constexpr XMFLOAT3(float _x, float _y, float _z) noexcept : x(_x), y(_y), z(_z) {}
+};
+}
+
+#else
+
+#include "pch.h"
+#include <Evergreen.h>
+
+// The simulation's per-atom arrays, accounted under Evergreen::MemoryCategory::SIMULATION. In the headless build
+// (above), there is no accounting and this is a plain std::vector
+template<typename T>
+using SimulationVector = Evergreen::TrackedVector<T, Evergreen::MemoryCategory::SIMULATION>;
+
+#endif
@@ -0,0 +1,633 @@
+#include "Trajectory.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+static constexpr char FileMagic[8] = { 'M', 'O', 'L', 'T', 'R', 'A', 'J', '1' };
+static constexpr char FooterMagic[8] = { 'M', 'O', 'L', 'T', 'I', 'D', 'X', '1' };
+static constexpr uint32_t FileVersion = 1;
+
+// Encoding helpers ----------------------------------------------------------------------------------------------
+
+// IEEE half precision with round-to-nearest-even. Values too large for a half become infinity
+static uint16_t FloatToHalf(float value) noexcept
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	const uint32_t sign = (bits >> 16) & 0x8000u;
+	const uint32_t absBits = bits & 0x7FFFFFFFu;
+
+	if (absBits >= 0x7F800000u) // Inf/NaN
+		return static_cast<uint16_t>(sign | 0x7C00u | (absBits > 0x7F800000u ? 0x0200u : 0u));
+	if (absBits >= 0x477FF000u) // Rounds to a value larger than the largest half
+		return static_cast<uint16_t>(sign | 0x7C00u);
+	if (absBits < 0x38800000u) // Subnormal half (or zero)
+	{
+		if (absBits < 0x33000000u)
+			return static_cast<uint16_t>(sign);
+		const uint32_t exponent = absBits >> 23;
+		const uint32_t mantissa = (absBits & 0x007FFFFFu) | 0x00800000u;
+		const uint32_t shift = 126u - exponent;
+		uint32_t half = mantissa >> shift;
+		const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+		const uint32_t halfway = 1u << (shift - 1u);
+		if (remainder > halfway || (remainder == halfway && (half & 1u)))
+			++half;
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	uint32_t half = (absBits - 0x38000000u) >> 13;
+	const uint32_t remainder = absBits & 0x1FFFu;
+	if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+		++half;
+	return static_cast<uint16_t>(sign | half);
+}
+
+static float HalfToFloat(uint16_t half) noexcept
+{
+	const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+	uint32_t exponent = (half >> 10) & 0x1Fu;
+	uint32_t mantissa = half & 0x3FFu;
+
+	uint32_t bits;
+	if (exponent == 0x1Fu)
+		bits = sign | 0x7F800000u | (mantissa << 13);
+	else if (exponent != 0)
+		bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+	else if (mantissa == 0)
+		bits = sign;
+	else
+	{
+		// Subnormal half -> normalize
+		exponent = 113u;
+		while ((mantissa & 0x400u) == 0)
+		{
+			mantissa <<= 1;
+			--exponent;
+		}
+		bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+	}
+
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static inline void AppendVarint(std::vector<uint8_t>& buffer, int32_t value)
+{
+	// Zigzag so that small negative deltas are also small
+	uint32_t zigzag = (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+	while (zigzag >= 0x80u)
+	{
+		buffer.push_back(static_cast<uint8_t>(zigzag | 0x80u));
+		zigzag >>= 7;
+	}
+	buffer.push_back(static_cast<uint8_t>(zigzag));
+}
+
+// Returns false if the varint runs past 'end'
+static inline bool ReadVarint(const uint8_t*& cursor, const uint8_t* end, int32_t& valueOut) noexcept
+{
+	uint32_t zigzag = 0;
+	for (unsigned int shift = 0; shift < 35; shift += 7)
+	{
+		if (cursor == end)
+			return false;
+		const uint8_t byte = *cursor++;
+		zigzag |= static_cast<uint32_t>(byte & 0x7Fu) << shift;
+		if ((byte & 0x80u) == 0)
+		{
+			valueOut = static_cast<int32_t>(zigzag >> 1) ^ -static_cast<int32_t>(zigzag & 1u);
+			return true;
+		}
+	}
+	return false;
+}
+
+template<typename T>
+static inline void AppendBytes(std::vector<uint8_t>& buffer, const T& value)
+{
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+// TrajectoryWriter ----------------------------------------------------------------------------------------------
+
+TrajectoryWriter::~TrajectoryWriter() noexcept
+{
+	Close();
+}
+
+bool TrajectoryWriter::Open(const std::string& filename, const int* elementTypes, size_t atomCount, const Settings& settings)
+{
+	Close();
+
+	m_file.open(filename, std::ios::binary | std::ios::trunc);
+	if (!m_file.is_open())
+		return false;
+
+	m_settings = settings;
+	m_settings.KeyframeInterval = std::max(1u, m_settings.KeyframeInterval);
+	m_atomCount = atomCount;
+	m_index.clear();
+	m_previousQuantized.assign(6 * atomCount, 0);
+	m_stats = Stats();
+	m_ioFailed = false;
+	m_bytesOnDisk = 0;
+	m_chunksWritten = 0;
+	m_stopRequested = false;
+	m_backBufferBusy = false;
+	m_frontBuffer.clear();
+	m_frontBuffer.reserve(m_settings.ChunkSize + sizeof(TrajectoryFrameHeader) + 24 * atomCount);
+	m_backBuffer.clear();
+
+	TrajectoryFileHeader header = {};
+	std::memcpy(header.Magic, FileMagic, sizeof(FileMagic));
+	header.Version = FileVersion;
+	header.AtomCount = static_cast<uint32_t>(atomCount);
+	header.Encoding = m_settings.Encoding;
+	header.KeyframeInterval = m_settings.KeyframeInterval;
+	header.PositionPrecision = m_settings.PositionPrecision;
+	header.VelocityPrecision = m_settings.VelocityPrecision;
+	AppendBytes(m_frontBuffer, header);
+	for (size_t iii = 0; iii < atomCount; ++iii)
+		AppendBytes(m_frontBuffer, static_cast<int32_t>(elementTypes[iii]));
+	m_stats.BytesEncoded = m_frontBuffer.size();
+
+	m_ioThread = std::thread(&TrajectoryWriter::IoThreadMain, this);
+	return true;
+}
+
+bool TrajectoryWriter::WriteFrame(uint64_t step, double time, const float* positionsXYZ, const float* velocitiesXYZ,
+	const ObservableSample* observables)
+{
+	if (!IsOpen() || HasFailed())
+		return false;
+
+	const bool keyframe = m_settings.Encoding != TrajectoryEncoding::QUANTIZED_DELTA ||
+		m_index.size() % m_settings.KeyframeInterval == 0;
+
+	// The header is written with a placeholder size and patched once the payload has been encoded
+	const size_t headerPosition = m_frontBuffer.size();
+	TrajectoryFrameHeader header = {};
+	header.Step = step;
+	header.Time = time;
+	header.Flags = (keyframe ? TrajectoryKeyframeFlag : 0u) | (observables != nullptr ? TrajectoryObservablesFlag : 0u);
+	AppendBytes(m_frontBuffer, header);
+
+	EncodeFrame(positionsXYZ, velocitiesXYZ, keyframe);
+	if (observables != nullptr)
+		AppendBytes(m_frontBuffer, *observables);
+
+	header.PayloadSize = static_cast<uint32_t>(m_frontBuffer.size() - headerPosition - sizeof(TrajectoryFrameHeader));
+	std::memcpy(&m_frontBuffer[headerPosition], &header, sizeof(header));
+
+	TrajectoryIndexEntry entry = {};
+	entry.Offset = m_stats.BytesEncoded;
+	entry.Step = step;
+	entry.Time = time;
+	entry.PayloadSize = header.PayloadSize;
+	entry.Flags = header.Flags;
+	m_index.push_back(entry);
+
+	m_stats.BytesEncoded += sizeof(TrajectoryFrameHeader) + header.PayloadSize;
+	++m_stats.FramesWritten;
+
+	if (m_frontBuffer.size() >= m_settings.ChunkSize)
+		TryHandOffChunk();
+
+	m_stats.BytesOnDisk = m_bytesOnDisk.load(std::memory_order_relaxed);
+	m_stats.ChunksWritten = m_chunksWritten.load(std::memory_order_relaxed);
+	return true;
+}
+
+void TrajectoryWriter::EncodeFrame(const float* positionsXYZ, const float* velocitiesXYZ, bool keyframe)
+{
+	const size_t valueCount = 3 * m_atomCount;
+
+	switch (m_settings.Encoding)
+	{
+	case TrajectoryEncoding::FLOAT32:
+	{
+		const size_t begin = m_frontBuffer.size();
+		m_frontBuffer.resize(begin + 2 * valueCount * sizeof(float));
+		std::memcpy(&m_frontBuffer[begin], positionsXYZ, valueCount * sizeof(float));
+		std::memcpy(&m_frontBuffer[begin + valueCount * sizeof(float)], velocitiesXYZ, valueCount * sizeof(float));
+		break;
+	}
+	case TrajectoryEncoding::FLOAT16:
+	{
+		const size_t begin = m_frontBuffer.size();
+		m_frontBuffer.resize(begin + 2 * valueCount * sizeof(uint16_t));
+		uint8_t* out = &m_frontBuffer[begin];
+		for (const float* values : { positionsXYZ, velocitiesXYZ })
+		{
+			for (size_t iii = 0; iii < valueCount; ++iii)
+			{
+				const uint16_t half = FloatToHalf(values[iii]);
+				std::memcpy(out, &half, sizeof(half));
+				out += sizeof(half);
+			}
+		}
+		break;
+	}
+	case TrajectoryEncoding::QUANTIZED_DELTA:
+	{
+		const float invPrecision[2] = { 1.0f / m_settings.PositionPrecision, 1.0f / m_settings.VelocityPrecision };
+		const float* values[2] = { positionsXYZ, velocitiesXYZ };
+		for (unsigned int array = 0; array < 2; ++array)
+		{
+			int32_t* previous = &m_previousQuantized[array * valueCount];
+			for (size_t iii = 0; iii < valueCount; ++iii)
+			{
+				const int32_t quantized = static_cast<int32_t>(std::lround(values[array][iii] * invPrecision[array]));
+				AppendVarint(m_frontBuffer, keyframe ? quantized : quantized - previous[iii]);
+				previous[iii] = quantized;
+			}
+		}
+		break;
+	}
+	}
+}
+
+void TrajectoryWriter::TryHandOffChunk() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_backBufferBusy)
+		{
+			// Keep appending to the front buffer and try again on the next frame rather than waiting
+			++m_stats.DeferredHandoffs;
+			return;
+		}
+		m_frontBuffer.swap(m_backBuffer);
+		m_backBufferBusy = true;
+	}
+	m_ioWake.notify_one();
+	m_frontBuffer.clear();
+}
+
+void TrajectoryWriter::IoThreadMain() noexcept
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_ioWake.wait(lock, [this]() { return m_backBufferBusy || m_stopRequested; });
+		if (!m_backBufferBusy)
+			return;
+
+		// Write without holding the lock so the simulation thread can keep checking (and not waiting on) the state
+		lock.unlock();
+		if (!m_ioFailed.load(std::memory_order_relaxed))
+		{
+			m_file.write(reinterpret_cast<const char*>(m_backBuffer.data()), static_cast<std::streamsize>(m_backBuffer.size()));
+			if (m_file.fail())
+				m_ioFailed = true;
+			else
+			{
+				m_bytesOnDisk.fetch_add(m_backBuffer.size(), std::memory_order_relaxed);
+				m_chunksWritten.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		m_backBuffer.clear();
+		lock.lock();
+
+		m_backBufferBusy = false;
+		m_ioIdle.notify_all();
+	}
+}
+
+bool TrajectoryWriter::Close() noexcept
+{
+	if (!IsOpen())
+		return false;
+
+	// Hand over whatever is left in the front buffer (waiting for the I/O thread to be free first), then stop the thread
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_ioIdle.wait(lock, [this]() { return !m_backBufferBusy; });
+		if (!m_frontBuffer.empty())
+		{
+			m_frontBuffer.swap(m_backBuffer);
+			m_backBufferBusy = true;
+			m_ioWake.notify_one();
+			m_ioIdle.wait(lock, [this]() { return !m_backBufferBusy; });
+		}
+		m_stopRequested = true;
+	}
+	m_ioWake.notify_one();
+	m_ioThread.join();
+	m_frontBuffer.clear();
+
+	// Frame index + footer
+	bool succeeded = !m_ioFailed;
+	if (succeeded)
+	{
+		TrajectoryFooter footer = {};
+		footer.IndexOffset = m_stats.BytesEncoded;
+		footer.FrameCount = m_index.size();
+		std::memcpy(footer.Magic, FooterMagic, sizeof(FooterMagic));
+
+		m_file.write(reinterpret_cast<const char*>(m_index.data()), static_cast<std::streamsize>(m_index.size() * sizeof(TrajectoryIndexEntry)));
+		m_file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+		m_file.flush();
+		succeeded = !m_file.fail();
+	}
+	m_file.close();
+
+	m_stats.BytesOnDisk = m_bytesOnDisk;
+	m_stats.ChunksWritten = m_chunksWritten;
+	return succeeded;
+}
+
+// TrajectoryReader ----------------------------------------------------------------------------------------------
+
+bool TrajectoryReader::Open(const std::string& filename)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	m_fileHandle = file;
+	m_mappingHandle = mapping;
+	m_size = static_cast<size_t>(size.QuadPart);
+#else
+	const int file = ::open(filename.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0)
+	{
+		::close(file);
+		return false;
+	}
+	void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	::close(file);
+	if (data == MAP_FAILED)
+		return false;
+	m_size = static_cast<size_t>(status.st_size);
+#endif
+	m_data = static_cast<const uint8_t*>(data);
+
+	// Header + element types
+	if (m_size < sizeof(TrajectoryFileHeader))
+	{
+		Close();
+		return false;
+	}
+	std::memcpy(&m_header, m_data, sizeof(m_header));
+	if (std::memcmp(m_header.Magic, FileMagic, sizeof(FileMagic)) != 0 || m_header.Version != FileVersion ||
+		m_header.Encoding > TrajectoryEncoding::QUANTIZED_DELTA ||
+		m_size < sizeof(TrajectoryFileHeader) + static_cast<size_t>(m_header.AtomCount) * sizeof(int32_t))
+	{
+		Close();
+		return false;
+	}
+	m_elementTypes.resize(m_header.AtomCount);
+	for (size_t iii = 0; iii < m_header.AtomCount; ++iii)
+	{
+		int32_t type;
+		std::memcpy(&type, m_data + sizeof(TrajectoryFileHeader) + iii * sizeof(int32_t), sizeof(type));
+		m_elementTypes[iii] = type;
+	}
+
+	m_hadIndex = ReadIndex();
+	if (!m_hadIndex)
+		RebuildIndex();
+
+	m_quantized.assign(6 * static_cast<size_t>(m_header.AtomCount), 0);
+	m_quantizedFrame = SIZE_MAX;
+	return true;
+}
+
+void TrajectoryReader::Close() noexcept
+{
+	if (m_data != nullptr)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(m_data);
+		CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+		CloseHandle(static_cast<HANDLE>(m_fileHandle));
+#else
+		munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+	}
+	m_data = nullptr;
+	m_size = 0;
+	m_fileHandle = nullptr;
+	m_mappingHandle = nullptr;
+	m_index.clear();
+	m_elementTypes.clear();
+	m_quantizedFrame = SIZE_MAX;
+}
+
+bool TrajectoryReader::ReadIndex() noexcept
+{
+	if (m_size < sizeof(TrajectoryFooter))
+		return false;
+
+	TrajectoryFooter footer;
+	std::memcpy(&footer, m_data + m_size - sizeof(footer), sizeof(footer));
+	if (std::memcmp(footer.Magic, FooterMagic, sizeof(FooterMagic)) != 0 ||
+		footer.IndexOffset + footer.FrameCount * sizeof(TrajectoryIndexEntry) + sizeof(TrajectoryFooter) != m_size)
+		return false;
+
+	m_index.resize(footer.FrameCount);
+	std::memcpy(m_index.data(), m_data + footer.IndexOffset, m_index.size() * sizeof(TrajectoryIndexEntry));
+
+	for (const TrajectoryIndexEntry& entry : m_index)
+	{
+		if (entry.Offset + sizeof(TrajectoryFrameHeader) + entry.PayloadSize > footer.IndexOffset)
+		{
+			m_index.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+void TrajectoryReader::RebuildIndex() noexcept
+{
+	// Payload size of a frame without observables: exact for the float encodings, a range for the varints
+	const uint64_t valueCount = 6 * static_cast<uint64_t>(m_header.AtomCount);
+	uint64_t minPayload = valueCount * sizeof(float);
+	uint64_t maxPayload = minPayload;
+	if (m_header.Encoding == TrajectoryEncoding::FLOAT16)
+		minPayload = maxPayload = valueCount * sizeof(uint16_t);
+	else if (m_header.Encoding == TrajectoryEncoding::QUANTIZED_DELTA)
+		minPayload = valueCount, maxPayload = 5 * valueCount;
+
+	// Walk the frame headers up to the last complete frame. A partially written index (or footer) after the frames can
+	// look like more frames, so stop at the first header that could not have been written for this file
+	m_index.clear();
+	uint64_t offset = sizeof(TrajectoryFileHeader) + static_cast<uint64_t>(m_header.AtomCount) * sizeof(int32_t);
+	while (offset + sizeof(TrajectoryFrameHeader) <= m_size)
+	{
+		TrajectoryFrameHeader header;
+		std::memcpy(&header, m_data + offset, sizeof(header));
+		const uint64_t observablesSize = (header.Flags & TrajectoryObservablesFlag) != 0 ? sizeof(ObservableSample) : 0;
+		if ((header.Flags & ~(TrajectoryKeyframeFlag | TrajectoryObservablesFlag)) != 0 ||
+			header.PayloadSize < minPayload + observablesSize || header.PayloadSize > maxPayload + observablesSize ||
+			(!m_index.empty() && header.Step < m_index.back().Step) ||
+			offset + sizeof(TrajectoryFrameHeader) + header.PayloadSize > m_size)
+			break;
+
+		TrajectoryIndexEntry entry = {};
+		entry.Offset = offset;
+		entry.Step = header.Step;
+		entry.Time = header.Time;
+		entry.PayloadSize = header.PayloadSize;
+		entry.Flags = header.Flags;
+		m_index.push_back(entry);
+
+		offset += sizeof(TrajectoryFrameHeader) + header.PayloadSize;
+	}
+}
+
+size_t TrajectoryReader::FrameAtStep(uint64_t step) const noexcept
+{
+	auto it = std::upper_bound(m_index.begin(), m_index.end(), step,
+		[](uint64_t s, const TrajectoryIndexEntry& entry) { return s < entry.Step; });
+	return it == m_index.begin() ? 0 : static_cast<size_t>(it - m_index.begin()) - 1;
+}
+
+bool TrajectoryReader::ReadFrameObservables(size_t frame, ObservableSample& observablesOut) const noexcept
+{
+	if (frame >= m_index.size())
+		return false;
+
+	const TrajectoryIndexEntry& entry = m_index[frame];
+	if ((entry.Flags & TrajectoryObservablesFlag) == 0 || entry.PayloadSize < sizeof(ObservableSample))
+		return false;
+
+	const uint8_t* payloadEnd = m_data + entry.Offset + sizeof(TrajectoryFrameHeader) + entry.PayloadSize;
+	std::memcpy(&observablesOut, payloadEnd - sizeof(ObservableSample), sizeof(ObservableSample));
+	return true;
+}
+
+bool TrajectoryReader::DecodeDeltaFrame(size_t frame) noexcept
+{
+	const TrajectoryIndexEntry& entry = m_index[frame];
+	const uint8_t* cursor = m_data + entry.Offset + sizeof(TrajectoryFrameHeader);
+	const uint8_t* end = cursor + entry.PayloadSize;
+	const bool keyframe = (entry.Flags & TrajectoryKeyframeFlag) != 0;
+
+	for (int32_t& value : m_quantized)
+	{
+		int32_t delta;
+		if (!ReadVarint(cursor, end, delta))
+		{
+			m_quantizedFrame = SIZE_MAX;
+			return false;
+		}
+		value = keyframe ? delta : value + delta;
+	}
+	m_quantizedFrame = frame;
+	return true;
+}
+
+bool TrajectoryReader::ReadFrame(size_t frame, float* positionsXYZOut, float* velocitiesXYZOut) noexcept
+{
+	if (frame >= m_index.size())
+		return false;
+
+	const size_t valueCount = 3 * static_cast<size_t>(m_header.AtomCount);
+	const TrajectoryIndexEntry& entry = m_index[frame];
+	const uint8_t* payload = m_data + entry.Offset + sizeof(TrajectoryFrameHeader);
+	float* outputs[2] = { positionsXYZOut, velocitiesXYZOut };
+
+	switch (m_header.Encoding)
+	{
+	case TrajectoryEncoding::FLOAT32:
+		if (entry.PayloadSize < 2 * valueCount * sizeof(float))
+			return false;
+		for (unsigned int array = 0; array < 2; ++array)
+		{
+			if (outputs[array] != nullptr)
+				std::memcpy(outputs[array], payload + array * valueCount * sizeof(float), valueCount * sizeof(float));
+		}
+		return true;
+
+	case TrajectoryEncoding::FLOAT16:
+		if (entry.PayloadSize < 2 * valueCount * sizeof(uint16_t))
+			return false;
+		for (unsigned int array = 0; array < 2; ++array)
+		{
+			if (outputs[array] == nullptr)
+				continue;
+			const uint8_t* in = payload + array * valueCount * sizeof(uint16_t);
+			for (size_t iii = 0; iii < valueCount; ++iii)
+			{
+				uint16_t half;
+				std::memcpy(&half, in + iii * sizeof(uint16_t), sizeof(half));
+				outputs[array][iii] = HalfToFloat(half);
+			}
+		}
+		return true;
+
+	case TrajectoryEncoding::QUANTIZED_DELTA:
+	{
+		// Start from the closest keyframe, unless the frame we decoded last is between that keyframe and this frame
+		size_t keyframe = frame;
+		while (keyframe > 0 && (m_index[keyframe].Flags & TrajectoryKeyframeFlag) == 0)
+			--keyframe;
+		const size_t first = (m_quantizedFrame != SIZE_MAX && m_quantizedFrame >= keyframe && m_quantizedFrame <= frame) ?
+			m_quantizedFrame + 1 : keyframe;
+
+		for (size_t iii = first; iii <= frame; ++iii)
+		{
+			if (!DecodeDeltaFrame(iii))
+				return false;
+		}
+
+		const float precision[2] = { m_header.PositionPrecision, m_header.VelocityPrecision };
+		for (unsigned int array = 0; array < 2; ++array)
+		{
+			if (outputs[array] == nullptr)
+				continue;
+			const int32_t* quantized = &m_quantized[array * valueCount];
+			for (size_t iii = 0; iii < valueCount; ++iii)
+				outputs[array][iii] = static_cast<float>(quantized[iii]) * precision[array];
+		}
+		return true;
+	}
+	}
+	return false;
+}
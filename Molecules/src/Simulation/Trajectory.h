@@ -0,0 +1,196 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Observables.h"
+
+// NOTE: This file has no DirectX dependencies. Positions and velocities are tightly packed xyz triplets and the
+//       atoms of every frame are stored in stable atom id order (not the Simulation's current index order).
+//
+// File layout (little-endian):
+//
+//		TrajectoryFileHeader
+//		int32_t elementTypes[AtomCount]
+//		{ TrajectoryFrameHeader, payload } per frame
+//		TrajectoryIndexEntry[FrameCount]	<- frame index, written by TrajectoryWriter::Close()
+//		TrajectoryFooter
+//
+// The payload of a frame holds the positions followed by the velocities, encoded according to the file's encoding.
+// With QUANTIZED_DELTA, each value is rounded to a multiple of the precision and stored as a zigzag varint of the
+// difference from the previous frame (keyframes store the difference from 0), so random access decodes forward from
+// the nearest keyframe. Frames flagged with TrajectoryObservablesFlag end with the raw ObservableSample for that
+// step, so plots of energy/temperature/pressure don't require decoding any atoms. If the writer never got to write the index (ex. the app crashed), the reader rebuilds it by
+// walking the frame headers.
+
+enum class TrajectoryEncoding : uint32_t
+{
+	FLOAT32 = 0,
+	FLOAT16,
+	QUANTIZED_DELTA
+};
+
+struct TrajectoryFileHeader
+{
+	char Magic[8];
+	uint32_t Version;
+	uint32_t AtomCount;
+	TrajectoryEncoding Encoding;
+	uint32_t KeyframeInterval;
+	float PositionPrecision;
+	float VelocityPrecision;
+};
+static_assert(sizeof(TrajectoryFileHeader) == 32);
+
+struct TrajectoryFrameHeader
+{
+	uint64_t Step;
+	double Time;
+	uint32_t PayloadSize;
+	uint32_t Flags;
+};
+static_assert(sizeof(TrajectoryFrameHeader) == 24);
+
+struct TrajectoryIndexEntry
+{
+	uint64_t Offset;	// Of the frame header
+	uint64_t Step;
+	double Time;
+	uint32_t PayloadSize;
+	uint32_t Flags;
+};
+static_assert(sizeof(TrajectoryIndexEntry) == 32);
+
+struct TrajectoryFooter
+{
+	uint64_t IndexOffset;
+	uint64_t FrameCount;
+	char Magic[8];
+};
+static_assert(sizeof(TrajectoryFooter) == 24);
+
+static constexpr uint32_t TrajectoryKeyframeFlag = 1u;
+static constexpr uint32_t TrajectoryObservablesFlag = 2u;
+
+// Encodes frames on the calling (simulation) thread into an in-memory chunk and hands full chunks to a background
+// thread that writes them to disk. There are two chunk buffers: while the I/O thread writes one, frames are appended
+// to the other. If the I/O thread is still busy when a chunk fills up, the chunk just keeps growing until the next
+// WriteFrame() finds the I/O thread idle - WriteFrame() never waits on the disk.
+class TrajectoryWriter
+{
+public:
+	struct Settings
+	{
+		TrajectoryEncoding Encoding = TrajectoryEncoding::QUANTIZED_DELTA;
+		uint32_t KeyframeInterval = 64;		// QUANTIZED_DELTA only
+		float PositionPrecision = 1.0e-4f;	// QUANTIZED_DELTA only
+		float VelocityPrecision = 1.0e-4f;	// QUANTIZED_DELTA only
+		size_t ChunkSize = 1 << 20;			// Bytes buffered before the chunk is handed to the I/O thread
+	};
+
+	struct Stats
+	{
+		uint64_t FramesWritten = 0;
+		uint64_t BytesEncoded = 0;		// Header + frames so far (what the file will contain, excluding the index)
+		uint64_t BytesOnDisk = 0;		// Written by the I/O thread so far
+		uint64_t ChunksWritten = 0;
+		uint64_t DeferredHandoffs = 0;	// Times a full chunk had to keep growing because the I/O thread was busy
+	};
+
+	TrajectoryWriter() noexcept = default;
+	TrajectoryWriter(const TrajectoryWriter&) = delete;
+	TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+	~TrajectoryWriter() noexcept;
+
+	bool Open(const std::string& filename, const int* elementTypes, size_t atomCount, const Settings& settings);
+	// 'observables' is optional - when given, it is stored at the end of the frame's payload
+	bool WriteFrame(uint64_t step, double time, const float* positionsXYZ, const float* velocitiesXYZ,
+		const ObservableSample* observables = nullptr);
+	// Writes any buffered frames, then the frame index and footer. Blocks until everything is on disk
+	bool Close() noexcept;
+
+	[[nodiscard]] inline bool IsOpen() const noexcept { return m_ioThread.joinable(); }
+	[[nodiscard]] inline bool HasFailed() const noexcept { return m_ioFailed.load(std::memory_order_relaxed); }
+	[[nodiscard]] inline const Stats& GetStats() const noexcept { return m_stats; }
+
+private:
+	void IoThreadMain() noexcept;
+	void TryHandOffChunk() noexcept;
+	void EncodeFrame(const float* positionsXYZ, const float* velocitiesXYZ, bool keyframe);
+
+	Settings m_settings;
+	size_t m_atomCount = 0;
+	std::ofstream m_file;
+
+	std::vector<uint8_t> m_frontBuffer;		// Owned by the caller's thread
+	std::vector<uint8_t> m_backBuffer;		// Owned by the I/O thread while m_backBufferBusy is set
+	bool m_backBufferBusy = false;
+	bool m_stopRequested = false;
+	std::mutex m_mutex;
+	std::condition_variable m_ioWake;
+	std::condition_variable m_ioIdle;
+	std::thread m_ioThread;
+	std::atomic<bool> m_ioFailed = false;
+	std::atomic<uint64_t> m_bytesOnDisk = 0;
+	std::atomic<uint64_t> m_chunksWritten = 0;
+
+	std::vector<TrajectoryIndexEntry> m_index;
+	std::vector<int32_t> m_previousQuantized;	// QUANTIZED_DELTA: the quantized values of the previous frame
+	Stats m_stats;
+};
+
+// Random-access reader over a memory-mapped trajectory file
+class TrajectoryReader
+{
+public:
+	TrajectoryReader() noexcept = default;
+	TrajectoryReader(const TrajectoryReader&) = delete;
+	TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+	~TrajectoryReader() noexcept { Close(); }
+
+	bool Open(const std::string& filename);
+	void Close() noexcept;
+
+	[[nodiscard]] inline bool IsOpen() const noexcept { return m_data != nullptr; }
+	[[nodiscard]] inline size_t AtomCount() const noexcept { return m_header.AtomCount; }
+	[[nodiscard]] inline size_t FrameCount() const noexcept { return m_index.size(); }
+	[[nodiscard]] inline TrajectoryEncoding Encoding() const noexcept { return m_header.Encoding; }
+	// Element type of each atom, by atom id
+	[[nodiscard]] inline const std::vector<int>& ElementTypes() const noexcept { return m_elementTypes; }
+	[[nodiscard]] inline uint64_t FrameStep(size_t frame) const noexcept { return m_index[frame].Step; }
+	[[nodiscard]] inline double FrameTime(size_t frame) const noexcept { return m_index[frame].Time; }
+	// Last frame at or before 'step' (for scrubbing)
+	[[nodiscard]] size_t FrameAtStep(uint64_t step) const noexcept;
+	// False if the index had to be rebuilt because the file was not closed properly
+	[[nodiscard]] inline bool HadIndex() const noexcept { return m_hadIndex; }
+
+	// Either output may be null. Decoding a QUANTIZED_DELTA frame costs (frame - keyframe) frame decodes, except
+	// when playing forward, where the previously read frame is reused
+	bool ReadFrame(size_t frame, float* positionsXYZOut, float* velocitiesXYZOut) noexcept;
+	// False if the frame was written without observables
+	bool ReadFrameObservables(size_t frame, ObservableSample& observablesOut) const noexcept;
+
+private:
+	bool ReadIndex() noexcept;
+	void RebuildIndex() noexcept;
+	bool DecodeDeltaFrame(size_t frame) noexcept;
+
+	const uint8_t* m_data = nullptr;
+	size_t m_size = 0;
+	void* m_fileHandle = nullptr;
+	void* m_mappingHandle = nullptr;
+
+	TrajectoryFileHeader m_header = {};
+	std::vector<int> m_elementTypes;
+	std::vector<TrajectoryIndexEntry> m_index;
+	bool m_hadIndex = false;
+
+	// QUANTIZED_DELTA: the quantized values of the most recently decoded frame
+	std::vector<int32_t> m_quantized;
+	size_t m_quantizedFrame = SIZE_MAX;
+};
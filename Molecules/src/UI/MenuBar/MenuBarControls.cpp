@@ -19,7 +19,7 @@ void MenuBarButtonOnMouseEnter(Button* button, const std::string& paneName)
 	}
 	else
 	{
-		button->BackgroundBrush(g_menuBarButtonColorMouseOverPaneClosed);
+		button->AnimateBackgroundColor(g_menuBarButtonColorMouseOverPaneClosed);
 		button->BorderWidth(0.0f);
 	}
 }
@@ -81,7 +81,7 @@ void FileDropDownOnMouseLeave(Button* button, MouseMoveEvent& e)
 	}
 	else
 	{
-		button->BackgroundBrush(g_menuBarButtonColorDefault);
+		button->AnimateBackgroundColor(g_menuBarButtonColorDefault);
 	}
 }
 void FileDropDownOnClick(Button* button, MouseButtonReleasedEvent& e)
@@ -137,7 +137,7 @@ void EditDropDownOnMouseLeave(Button* button, MouseMoveEvent& e)
 	}
 	else
 	{
-		button->BackgroundBrush(g_menuBarButtonColorDefault);
+		button->AnimateBackgroundColor(g_menuBarButtonColorDefault);
 	}
 }
 void EditDropDownOnClick(Button* button, MouseButtonReleasedEvent& e)
@@ -183,7 +183,7 @@ void ViewDropDownOnMouseLeave(Button* button, MouseMoveEvent& e)
 	}
 	else
 	{
-		button->BackgroundBrush(g_menuBarButtonColorDefault);
+		button->AnimateBackgroundColor(g_menuBarButtonColorDefault);
 	}
 }
 void ViewDropDownOnClick(Button* button, MouseButtonReleasedEvent& e)
@@ -285,11 +285,11 @@ void MenuBarDropDownPaneOnMouseExitedContentRegion(Pane* pane, MouseMoveEvent& e
 }
 void MenuBarDropDownPaneButtonOnMouseEnter(Button* button, MouseMoveEvent&)
 {
-	button->BackgroundBrush(g_menuBarButtonColorMouseOverPaneClosed);
+	button->AnimateBackgroundColor(g_menuBarButtonColorMouseOverPaneClosed);
 }
 void MenuBarDropDownPaneButtonOnMouseLeave(Button* button, MouseMoveEvent&)
 {
-	button->BackgroundBrush(g_menuBarButtonColorPaneOpen);
+	button->AnimateBackgroundColor(g_menuBarButtonColorPaneOpen);
 }
 void MenuBarDropDownPaneButtonOnClick(Button* button, MouseButtonReleasedEvent& e, const std::string& paneName, const std::string& buttonName)
 {
@@ -392,11 +392,11 @@ void EditDropDownCameraButtonOnClick(Button* button, MouseButtonReleasedEvent& e
 	MenuBarDropDownPaneButtonOnClick(button, e, "EditDropDownPane", "EditDropDownButton");
 	RightPanelAddTab(selectedTab, "RightPanel_CameraButton", "right_panel_camera_tab.json", "right_panel_camera_content.json");
 }
-void EditDropDownMaterialsButtonOnClick(Button* button, MouseButtonReleasedEvent& e, Button*& selectedTab, Scene* scene, Element& currentElement)
+void EditDropDownMaterialsButtonOnClick(Button* button, MouseButtonReleasedEvent& e, Button*& selectedTab, Scene* scene, MaterialEditObservables& observables, Element& currentElement)
 {
 	MenuBarDropDownPaneButtonOnClick(button, e, "EditDropDownPane", "EditDropDownButton");
 	RightPanelAddTab(selectedTab, "RightPanel_MaterialsButton", "right_panel_materials_tab.json", "right_panel_materials_content.json");
-	MaterialEditElementSelectorDropDownItemOnClick(button->GetUI(), scene, L"Hydrogen", currentElement, Element::Hydrogen); 
+	MaterialEditElementSelectorDropDownItemOnClick(button->GetUI(), scene, observables, L"Hydrogen", currentElement, Element::Hydrogen); 
 }
 void EditDropDownLightingButtonOnClick(Button* button, MouseButtonReleasedEvent& e, Button*& selectedTab)
 {
@@ -4,6 +4,8 @@
 #include "../../Simulation/Simulation.h"
 #include "../../Rendering/Scene.h"
 
+struct MaterialEditObservables;
+
 
 // Menu Bar Buttons - Generic
 void MenuBarButtonOnMouseEnter(Evergreen::Button* button, const std::string& paneName);
@@ -43,7 +45,7 @@ void FileDropDownExitButtonOnClick(Evergreen::Button* button, Evergreen::MouseBu
 
 // EDIT
 void EditDropDownCameraButtonOnClick(Evergreen::Button* button, Evergreen::MouseButtonReleasedEvent& e, Evergreen::Button*& selectedTab);
-void EditDropDownMaterialsButtonOnClick(Evergreen::Button* button, Evergreen::MouseButtonReleasedEvent& e, Evergreen::Button*& selectedTab, Scene* scene, Element& currentElement);
+void EditDropDownMaterialsButtonOnClick(Evergreen::Button* button, Evergreen::MouseButtonReleasedEvent& e, Evergreen::Button*& selectedTab, Scene* scene, MaterialEditObservables& observables, Element& currentElement);
 void EditDropDownLightingButtonOnClick(Evergreen::Button* button, Evergreen::MouseButtonReleasedEvent& e, Evergreen::Button*& selectedTab);
 
 // VIEW Pane
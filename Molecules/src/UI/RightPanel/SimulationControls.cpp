@@ -2,3 +2,42 @@
 
 using namespace Evergreen;
 
+static constexpr std::array<const wchar_t*, 11> ElementSymbols{
+	L"", L"H", L"He", L"Li", L"Be", L"B", L"C", L"N", L"O", L"F", L"Ne"
+};
+
+std::wstring FormatSimulationObservable(const ObservableSample& sample, SimulationObservable observable)
+{
+	switch (observable)
+	{
+	case SimulationObservable::STEP:				return std::format(L"{}", sample.Step);
+	case SimulationObservable::TIME:				return std::format(L"{:.3f}", sample.Time);
+	case SimulationObservable::KINETIC_ENERGY:		return std::format(L"{:.4f}", sample.KineticEnergy);
+	case SimulationObservable::POTENTIAL_ENERGY:	return std::format(L"{:.4f}", sample.PotentialEnergy);
+	case SimulationObservable::TOTAL_ENERGY:		return std::format(L"{:.4f}", sample.TotalEnergy());
+	case SimulationObservable::TEMPERATURE:			return std::format(L"{:.4f}", sample.Temperature);
+	case SimulationObservable::PRESSURE:			return std::format(L"{:.4f}", sample.Pressure);
+	case SimulationObservable::MOMENTUM:
+		return std::format(L"({:.3f}, {:.3f}, {:.3f})", sample.Momentum[0], sample.Momentum[1], sample.Momentum[2]);
+	case SimulationObservable::ATOM_COUNTS:
+	{
+		std::wstring counts = std::format(L"{}", sample.AtomCount);
+		for (size_t iii = 1; iii < ElementSymbols.size(); ++iii)
+		{
+			if (sample.ElementCounts[iii] > 0)
+				counts += std::format(L"  {}: {}", ElementSymbols[iii], sample.ElementCounts[iii]);
+		}
+		return counts;
+	}
+	}
+
+	EG_ASSERT(false, "Unrecognized SimulationObservable");
+	return L"";
+}
+
+void SimulationObservableTextOnUpdate(Text* text, const ObservableSample& sample, SimulationObservable observable)
+{
+	std::wstring value = FormatSimulationObservable(sample, observable);
+	if (value != text->GetText())
+		text->SetText(value);
+}
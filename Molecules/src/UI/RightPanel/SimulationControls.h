@@ -4,3 +4,22 @@
 #include "../../Simulation/Simulation.h"
 #include "../../Rendering/Scene.h"
 
+// Values that can be shown in the Simulation tab. Each value Text's OnUpdate callback reads the latest sample
+// published by the Simulation, so the UI never has to walk the atoms itself
+enum class SimulationObservable
+{
+	STEP = 0,
+	TIME,
+	KINETIC_ENERGY,
+	POTENTIAL_ENERGY,
+	TOTAL_ENERGY,
+	TEMPERATURE,
+	PRESSURE,
+	MOMENTUM,
+	ATOM_COUNTS
+};
+
+std::wstring FormatSimulationObservable(const ObservableSample& sample, SimulationObservable observable);
+
+// Only calls SetText (which re-lays out the text) when the formatted value actually changed
+void SimulationObservableTextOnUpdate(Evergreen::Text* text, const ObservableSample& sample, SimulationObservable observable);
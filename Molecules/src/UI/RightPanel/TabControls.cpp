@@ -2,57 +2,45 @@
 
 using namespace Evergreen;
 
-void MaterialEditElementSelectorDropDownItemOnClick(UI* ui, Scene* scene, const std::wstring& elementName, Element& currentElement, Element newElement)
+void MaterialEditObservables::Register()
+{
+	JSONLoaders::AddObservable("MaterialEdit_ElementName", ElementName);
+	JSONLoaders::AddObservable("MaterialEdit_DiffuseAlbedoX", DiffuseAlbedoX);
+	JSONLoaders::AddObservable("MaterialEdit_DiffuseAlbedoY", DiffuseAlbedoY);
+	JSONLoaders::AddObservable("MaterialEdit_DiffuseAlbedoZ", DiffuseAlbedoZ);
+	JSONLoaders::AddObservable("MaterialEdit_FresnelX", FresnelX);
+	JSONLoaders::AddObservable("MaterialEdit_FresnelY", FresnelY);
+	JSONLoaders::AddObservable("MaterialEdit_FresnelZ", FresnelZ);
+	JSONLoaders::AddObservable("MaterialEdit_Shininess", Shininess);
+}
+void MaterialEditObservables::Set(const std::wstring& elementName, const Material& material)
+{
+	ElementName.Set(elementName);
+	DiffuseAlbedoX.Set(material.DiffuseAlbedo.x);
+	DiffuseAlbedoY.Set(material.DiffuseAlbedo.y);
+	DiffuseAlbedoZ.Set(material.DiffuseAlbedo.z);
+	FresnelX.Set(material.FresnelR0.x);
+	FresnelY.Set(material.FresnelR0.y);
+	FresnelZ.Set(material.FresnelR0.z);
+	Shininess.Set(material.Shininess);
+}
+
+void MaterialEditElementSelectorDropDownItemOnClick(UI* ui, Scene* scene, MaterialEditObservables& observables, const std::wstring& elementName, Element& currentElement, Element newElement)
 {
 	EG_ASSERT(ui != nullptr, "UI cannot be nullptr");
 	EG_ASSERT(scene != nullptr, "Scene cannot be nullptr");
 
-	Text* dropDownText = ui->GetControlByName<Text>("RightPanel_ElementSelectorDropDown_Text");
-	EG_ASSERT(dropDownText != nullptr, "Could not find drop down text");
-	dropDownText->SetText(elementName);
-
 	currentElement = newElement;
 
 	Pane* pane = ui->GetPane("RightPanel_ElementSelectorDropDown_Pane");
 	EG_ASSERT(pane != nullptr, "Pane not found");
 	pane->SetVisible(false);
 
-	// Update the sliders that can edit the material
+	// Update the drop down text and the sliders that can edit the material
 	MaterialsArray* materials = scene->GetMaterials();
 	EG_ASSERT(materials != nullptr, "materials not found");
 
-	const Material& material = materials->materials[static_cast<int>(currentElement) - 1];
-
-	Layout* rightPanelContentLayout = ui->GetLayoutByName("RightPanelLayout_ContentLayout");
-	EG_ASSERT(rightPanelContentLayout != nullptr, "Could not find layout");
-
-	SliderFloat* diffuseAlbedoX = rightPanelContentLayout->GetControlByName<SliderFloat>("MaterialDiffuseAlbedoXSlider");
-	EG_ASSERT(diffuseAlbedoX != nullptr, "diffuseAlbedoX not found");
-	diffuseAlbedoX->SetValue(material.DiffuseAlbedo.x);
-
-	SliderFloat* diffuseAlbedoY = rightPanelContentLayout->GetControlByName<SliderFloat>("MaterialDiffuseAlbedoYSlider");
-	EG_ASSERT(diffuseAlbedoY != nullptr, "diffuseAlbedoY not found");
-	diffuseAlbedoY->SetValue(material.DiffuseAlbedo.y);
-
-	SliderFloat* diffuseAlbedoZ = rightPanelContentLayout->GetControlByName<SliderFloat>("MaterialDiffuseAlbedoZSlider");
-	EG_ASSERT(diffuseAlbedoZ != nullptr, "diffuseAlbedoZ not found");
-	diffuseAlbedoZ->SetValue(material.DiffuseAlbedo.z);
-
-	SliderFloat* fresnelX = rightPanelContentLayout->GetControlByName<SliderFloat>("MaterialFresnelXSlider");
-	EG_ASSERT(fresnelX != nullptr, "fresnelX not found");
-	fresnelX->SetValue(material.FresnelR0.x);
-
-	SliderFloat* fresnelY = rightPanelContentLayout->GetControlByName<SliderFloat>("MaterialFresnelYSlider");
-	EG_ASSERT(fresnelY != nullptr, "fresnelY not found");
-	fresnelY->SetValue(material.FresnelR0.y);
-
-	SliderFloat* fresnelZ = rightPanelContentLayout->GetControlByName<SliderFloat>("MaterialFresnelZSlider");
-	EG_ASSERT(fresnelZ != nullptr, "fresnelZ not found");
-	fresnelZ->SetValue(material.FresnelR0.z);
-
-	SliderFloat* shininess = rightPanelContentLayout->GetControlByName<SliderFloat>("MaterialShininessSlider");
-	EG_ASSERT(shininess != nullptr, "shininess not found");
-	shininess->SetValue(material.Shininess);
+	observables.Set(elementName, materials->materials[static_cast<int>(currentElement) - 1]);
 }
 
 // Right Panel Tabs - Generic -------------------------------------------------------------------
@@ -9,7 +9,25 @@ const D2D1_COLOR_F g_rightPanelTabColorNotSelected = D2D1::ColorF(0.2f, 0.2f, 0.
 const D2D1_COLOR_F g_rightPanelTabColorMouseOver = D2D1::ColorF(0.25f, 0.25f, 0.25f);
 const D2D1_COLOR_F g_rightPanelTabColorMouseDown = D2D1::ColorF(0.3f, 0.3f, 0.3f);
 
-void MaterialEditElementSelectorDropDownItemOnClick(Evergreen::UI* ui, Scene* scene, const std::wstring& elementName, Element& currentElement, Element newElement);
+// The material editor's controls are bound to these (see right_panel_materials_content.json), so selecting an element
+// only sets the values - the controls pick them up (if they changed) the next time the UI updates
+struct MaterialEditObservables
+{
+	Evergreen::Observable<std::wstring> ElementName{ L"Hydrogen" };
+	Evergreen::Observable<float> DiffuseAlbedoX{ 1.0f };
+	Evergreen::Observable<float> DiffuseAlbedoY{ 1.0f };
+	Evergreen::Observable<float> DiffuseAlbedoZ{ 1.0f };
+	Evergreen::Observable<float> FresnelX{ 1.0f };
+	Evergreen::Observable<float> FresnelY{ 1.0f };
+	Evergreen::Observable<float> FresnelZ{ 1.0f };
+	Evergreen::Observable<float> Shininess{ 1.0f };
+
+	// Must be called before loading the JSON that binds to them
+	void Register();
+	void Set(const std::wstring& elementName, const Material& material);
+};
+
+void MaterialEditElementSelectorDropDownItemOnClick(Evergreen::UI* ui, Scene* scene, MaterialEditObservables& observables, const std::wstring& elementName, Element& currentElement, Element newElement);
 
 // Right Panel Tabs - Generic -------------------------------------------------------------------
 void RightPanelTabChangeBackgroundAndCloseButtonColor(Evergreen::Button* button, const D2D1_COLOR_F& background, D2D1::ColorF::Enum text);
@@ -0,0 +1,310 @@
+#include "BatchConfig.h"
+#include "Simulation/BarnesHut.h"
+
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+static constexpr std::array ElementNames = { "Null", "Hydrogen", "Helium", "Lithium", "Beryllium", "Boron", "Carbon", "Nitrogen", "Oxygen", "Flourine", "Neon" };
+static_assert(ElementNames.size() == AtomicRadii.size());
+
+static std::runtime_error ConfigError(const std::string& message)
+{
+	return std::runtime_error("Invalid batch config: " + message);
+}
+
+static void WarnAboutUnrecognizedKeys(const json& data, std::initializer_list<const char*> recognizedKeys, const char* objectName)
+{
+	for (auto& [key, value] : data.items())
+	{
+		if (std::find_if(recognizedKeys.begin(), recognizedKeys.end(), [&key](const char* k) { return key == k; }) == recognizedKeys.end())
+			EG_WARN("Batch config '{}' object: Unrecognized key '{}'", objectName, key);
+	}
+}
+
+template<typename T>
+static T ParseNumber(const json& data, const char* key, T defaultValue)
+{
+	if (!data.contains(key))
+		return defaultValue;
+	if (!data[key].is_number())
+		throw ConfigError(std::string("'") + key + "' must be a number");
+	if constexpr (std::is_unsigned_v<T>)
+	{
+		if (data[key].get<double>() < 0.0)
+			throw ConfigError(std::string("'") + key + "' must be >= 0");
+	}
+	return data[key].get<T>();
+}
+
+static Element ParseElement(const json& data, const char* key)
+{
+	if (!data.contains(key) || !data[key].is_string())
+		throw ConfigError(std::string("'") + key + "' must be the name of an element");
+
+	const std::string name = data[key].get<std::string>();
+	if (name == "Fluorine")
+		return Element::Flourine;
+	for (size_t iii = 1; iii < ElementNames.size(); ++iii)
+	{
+		if (name == ElementNames[iii])
+			return static_cast<Element>(iii);
+	}
+	throw ConfigError("Unknown element '" + name + "'");
+}
+
+static DirectX::XMFLOAT3 ParseFloat3(const json& data, const char* key)
+{
+	if (!data.contains(key))
+		return { 0.0f, 0.0f, 0.0f };
+	const json& value = data[key];
+	if (!value.is_array() || value.size() != 3 || !value[0].is_number() || !value[1].is_number() || !value[2].is_number())
+		throw ConfigError(std::string("'") + key + "' must be an array of 3 numbers");
+	return { value[0].get<float>(), value[1].get<float>(), value[2].get<float>() };
+}
+
+static void ParseForceField(const json& data, BatchConfig& config)
+{
+	WarnAboutUnrecognizedKeys(data, { "Type", "Cutoff", "Skin", "BarnesHut" }, "ForceField");
+
+	if (data.contains("Type"))
+	{
+		const std::string type = data["Type"].is_string() ? data["Type"].get<std::string>() : "";
+		if (type == "None")
+			config.UseForceField = false;
+		else if (type != "LennardJonesCoulomb")
+			throw ConfigError("'ForceField.Type' must be \"LennardJonesCoulomb\" or \"None\"");
+	}
+	config.Cutoff = ParseNumber(data, "Cutoff", config.Cutoff);
+	config.Skin = ParseNumber(data, "Skin", config.Skin);
+	if (config.Cutoff <= 0.0f || config.Skin < 0.0f)
+		throw ConfigError("'ForceField.Cutoff' must be > 0 and 'ForceField.Skin' must be >= 0");
+
+	if (data.contains("BarnesHut"))
+	{
+		const json& barnesHut = data["BarnesHut"];
+		WarnAboutUnrecognizedKeys(barnesHut, { "Theta", "Softening", "CoulombConstant", "Charges" }, "BarnesHut");
+
+		config.UseBarnesHut = true;
+		config.Theta = ParseNumber(barnesHut, "Theta", config.Theta);
+		config.Softening = ParseNumber(barnesHut, "Softening", config.Softening);
+		config.CoulombConstant = ParseNumber(barnesHut, "CoulombConstant", config.CoulombConstant);
+		if (barnesHut.contains("Charges"))
+		{
+			if (!barnesHut["Charges"].is_object())
+				throw ConfigError("'BarnesHut.Charges' must be an object of { \"Element\": charge }");
+			for (auto& [name, charge] : barnesHut["Charges"].items())
+			{
+				const json element = { { "Element", name } };
+				if (!charge.is_number())
+					throw ConfigError("Charge of '" + name + "' must be a number");
+				config.Charges[static_cast<size_t>(ParseElement(element, "Element"))] = charge.get<float>();
+			}
+		}
+	}
+}
+
+static void ParseAtoms(const json& data, BatchConfig& config)
+{
+	if (!data.is_array())
+		throw ConfigError("'Atoms' must be an array");
+
+	for (const json& atomData : data)
+	{
+		WarnAboutUnrecognizedKeys(atomData, { "Element", "Position", "Velocity" }, "Atoms");
+
+		BatchConfig::Atom atom;
+		atom.Type = ParseElement(atomData, "Element");
+		atom.Position = ParseFloat3(atomData, "Position");
+		atom.Velocity = ParseFloat3(atomData, "Velocity");
+		config.Atoms.push_back(atom);
+	}
+}
+
+// Simple cubic lattice centered in the box. Every atom gets a random direction with the same speed, and the average
+// velocity is then removed so the system as a whole does not drift
+static void ParseLattice(const json& data, BatchConfig& config)
+{
+	WarnAboutUnrecognizedKeys(data, { "Element", "Count", "Spacing", "Speed", "Seed" }, "Lattice");
+
+	const Element element = ParseElement(data, "Element");
+	const DirectX::XMFLOAT3 count = ParseFloat3(data, "Count");
+	const float spacing = ParseNumber(data, "Spacing", 2.0f * AtomicRadii[static_cast<size_t>(element)]);
+	const float speed = ParseNumber(data, "Speed", 0.0f);
+	const unsigned int seed = ParseNumber(data, "Seed", 1u);
+
+	const int nx = static_cast<int>(count.x), ny = static_cast<int>(count.y), nz = static_cast<int>(count.z);
+	if (nx <= 0 || ny <= 0 || nz <= 0)
+		throw ConfigError("'Lattice.Count' must be 3 positive integers");
+
+	std::mt19937 rng(seed);
+	std::normal_distribution<float> normal(0.0f, 1.0f);
+
+	const size_t first = config.Atoms.size();
+	DirectX::XMFLOAT3 averageVelocity = { 0.0f, 0.0f, 0.0f };
+	for (int z = 0; z < nz; ++z)
+	{
+		for (int y = 0; y < ny; ++y)
+		{
+			for (int x = 0; x < nx; ++x)
+			{
+				BatchConfig::Atom atom;
+				atom.Type = element;
+				atom.Position = { (x - 0.5f * (nx - 1)) * spacing, (y - 0.5f * (ny - 1)) * spacing, (z - 0.5f * (nz - 1)) * spacing };
+
+				DirectX::XMFLOAT3 direction = { normal(rng), normal(rng), normal(rng) };
+				const float length = std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+				const float scale = length > 0.0f ? speed / length : 0.0f;
+				atom.Velocity = { direction.x * scale, direction.y * scale, direction.z * scale };
+				averageVelocity.x += atom.Velocity.x;
+				averageVelocity.y += atom.Velocity.y;
+				averageVelocity.z += atom.Velocity.z;
+
+				config.Atoms.push_back(atom);
+			}
+		}
+	}
+
+	const float invCount = 1.0f / static_cast<float>(config.Atoms.size() - first);
+	for (size_t iii = first; iii < config.Atoms.size(); ++iii)
+	{
+		config.Atoms[iii].Velocity.x -= averageVelocity.x * invCount;
+		config.Atoms[iii].Velocity.y -= averageVelocity.y * invCount;
+		config.Atoms[iii].Velocity.z -= averageVelocity.z * invCount;
+	}
+}
+
+static void ParseTrajectory(const json& data, BatchConfig& config)
+{
+	WarnAboutUnrecognizedKeys(data, { "File", "Interval", "Encoding", "KeyframeInterval", "PositionPrecision", "VelocityPrecision" }, "Trajectory");
+
+	if (!data.contains("File") || !data["File"].is_string())
+		throw ConfigError("'Trajectory.File' must be a string");
+	config.TrajectoryFile = data["File"].get<std::string>();
+	config.TrajectoryInterval = ParseNumber(data, "Interval", config.TrajectoryInterval);
+
+	TrajectoryWriter::Settings& settings = config.TrajectorySettings;
+	if (data.contains("Encoding"))
+	{
+		const std::string encoding = data["Encoding"].is_string() ? data["Encoding"].get<std::string>() : "";
+		if (encoding == "Float32")
+			settings.Encoding = TrajectoryEncoding::FLOAT32;
+		else if (encoding == "Float16")
+			settings.Encoding = TrajectoryEncoding::FLOAT16;
+		else if (encoding == "QuantizedDelta")
+			settings.Encoding = TrajectoryEncoding::QUANTIZED_DELTA;
+		else
+			throw ConfigError("'Trajectory.Encoding' must be \"Float32\", \"Float16\" or \"QuantizedDelta\"");
+	}
+	settings.KeyframeInterval = ParseNumber(data, "KeyframeInterval", settings.KeyframeInterval);
+	settings.PositionPrecision = ParseNumber(data, "PositionPrecision", settings.PositionPrecision);
+	settings.VelocityPrecision = ParseNumber(data, "VelocityPrecision", settings.VelocityPrecision);
+	if (settings.PositionPrecision <= 0.0f || settings.VelocityPrecision <= 0.0f)
+		throw ConfigError("'Trajectory' precisions must be > 0");
+}
+
+BatchConfig LoadBatchConfig(const std::string& filename)
+{
+	std::ifstream file(filename);
+	if (!file.is_open())
+		throw std::runtime_error("Failed to open batch config '" + filename + "'");
+
+	json data;
+	try
+	{
+		data = json::parse(file);
+	}
+	catch (json::parse_error& e)
+	{
+		throw std::runtime_error("Failed to parse batch config '" + filename + "': " + e.what());
+	}
+
+	WarnAboutUnrecognizedKeys(data, { "Steps", "TimeStep", "Threads", "BoxHalfExtent", "Boundary", "SpatialSortInterval",
+		"ForceField", "Atoms", "Lattice", "Trajectory", "Stats", "ProgressInterval" }, "root");
+
+	BatchConfig config;
+	if (!data.contains("Steps"))
+		throw ConfigError("'Steps' is required");
+	config.Steps = ParseNumber(data, "Steps", config.Steps);
+	config.TimeStep = ParseNumber(data, "TimeStep", config.TimeStep);
+	if (config.TimeStep <= 0.0f || config.TimeStep > Simulation::MaxTimeStep)
+		throw ConfigError("'TimeStep' must be > 0 and <= " + std::to_string(Simulation::MaxTimeStep));
+	config.Threads = std::max(1u, ParseNumber(data, "Threads", config.Threads));
+	config.BoxHalfExtent = ParseNumber(data, "BoxHalfExtent", config.BoxHalfExtent);
+	if (config.BoxHalfExtent <= 0.0f)
+		throw ConfigError("'BoxHalfExtent' must be > 0");
+	config.SpatialSortInterval = ParseNumber(data, "SpatialSortInterval", config.SpatialSortInterval);
+	config.ProgressInterval = ParseNumber(data, "ProgressInterval", config.ProgressInterval);
+
+	if (data.contains("Boundary"))
+	{
+		const std::string boundary = data["Boundary"].is_string() ? data["Boundary"].get<std::string>() : "";
+		if (boundary == "Periodic")
+			config.Boundary = BoundaryMode::PERIODIC;
+		else if (boundary == "Reflective")
+			config.Boundary = BoundaryMode::REFLECTIVE;
+		else
+			throw ConfigError("'Boundary' must be \"Periodic\" or \"Reflective\"");
+	}
+
+	if (data.contains("ForceField"))
+		ParseForceField(data["ForceField"], config);
+	if (data.contains("Atoms"))
+		ParseAtoms(data["Atoms"], config);
+	if (data.contains("Lattice"))
+		ParseLattice(data["Lattice"], config);
+	if (config.Atoms.empty())
+		throw ConfigError("No atoms - add an 'Atoms' array and/or a 'Lattice'");
+
+	if (config.Boundary == BoundaryMode::PERIODIC && config.UseForceField && config.Cutoff + config.Skin > config.BoxHalfExtent)
+		throw ConfigError("'Cutoff' + 'Skin' must not exceed 'BoxHalfExtent' (half the box length) with periodic boundaries");
+
+	if (data.contains("Trajectory"))
+		ParseTrajectory(data["Trajectory"], config);
+	if (data.contains("Stats"))
+	{
+		if (!data["Stats"].is_string())
+			throw ConfigError("'Stats' must be a file name");
+		config.StatsFile = data["Stats"].get<std::string>();
+	}
+
+	return config;
+}
+
+std::unique_ptr<Simulation> CreateSimulation(const BatchConfig& config, Evergreen::JobSystem* jobSystem)
+{
+	std::unique_ptr<Simulation> simulation = std::make_unique<Simulation>();
+
+	for (const BatchConfig::Atom& atom : config.Atoms)
+		simulation->Add(atom.Type, atom.Position, atom.Velocity);
+
+	simulation->SetBoxHalfExtent(config.BoxHalfExtent);
+	simulation->SetBoundaryMode(config.Boundary);
+	simulation->SetSpatialSortInterval(config.SpatialSortInterval);
+	simulation->SetJobSystem(jobSystem);
+	simulation->GetNeighborList().SetSkin(config.Skin);
+
+	if (config.UseForceField)
+	{
+		std::unique_ptr<LennardJonesCoulomb> lennardJones = CreateDefaultForceField(config.Cutoff, jobSystem);
+		if (config.UseBarnesHut)
+		{
+			std::unique_ptr<BarnesHut> barnesHut = std::make_unique<BarnesHut>(config.Theta, jobSystem);
+			barnesHut->SetSoftening(config.Softening);
+			barnesHut->SetCoulombConstant(config.CoulombConstant);
+			for (size_t iii = 0; iii < config.Charges.size(); ++iii)
+				barnesHut->SetCharge(static_cast<int>(iii), config.Charges[iii]);
+
+			std::unique_ptr<ForceFieldSum> sum = std::make_unique<ForceFieldSum>();
+			sum->Add(std::move(lennardJones));
+			sum->Add(std::move(barnesHut));
+			simulation->SetForceField(std::move(sum));
+		}
+		else
+			simulation->SetForceField(std::move(lennardJones));
+	}
+
+	simulation->Play();
+	return simulation;
+}
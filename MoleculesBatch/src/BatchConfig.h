@@ -0,0 +1,74 @@
+#pragma once
+#include "Simulation/Simulation.h"
+
+#include <nlohmann/json.hpp>
+using json = nlohmann::json;
+
+#include <stdexcept>
+
+// Everything needed to set up and run one headless simulation. Loaded from a JSON file of the form:
+//
+//	{
+//		"Steps": 10000,
+//		"TimeStep": 0.001,
+//		"Threads": 4,
+//		"BoxHalfExtent": 3.0,
+//		"Boundary": "Periodic",						// or "Reflective"
+//		"SpatialSortInterval": 100,
+//		"ForceField": {
+//			"Type": "LennardJonesCoulomb",			// or "None" for ballistic motion
+//			"Cutoff": 1.0,
+//			"Skin": 0.3,
+//			"BarnesHut": { "Theta": 0.5, "Softening": 0.001, "CoulombConstant": 1.0, "Charges": { "Hydrogen": 0.4, "Oxygen": -0.8 } }
+//		},
+//		"Atoms": [ { "Element": "Neon", "Position": [0, 0, 0], "Velocity": [0.1, 0, 0] } ],
+//		"Lattice": { "Element": "Neon", "Count": [8, 8, 8], "Spacing": 0.35, "Speed": 0.5, "Seed": 1 },
+//		"Trajectory": { "File": "run.traj", "Interval": 10, "Encoding": "QuantizedDelta", "KeyframeInterval": 64,
+//						"PositionPrecision": 0.0001, "VelocityPrecision": 0.0001 },
+//		"Stats": "stats.json",
+//		"ProgressInterval": 1000
+//	}
+//
+// Only "Steps" and at least one of "Atoms"/"Lattice" are required.
+struct BatchConfig
+{
+	struct Atom
+	{
+		Element Type = Element::Hydrogen;
+		DirectX::XMFLOAT3 Position = { 0.0f, 0.0f, 0.0f };
+		DirectX::XMFLOAT3 Velocity = { 0.0f, 0.0f, 0.0f };
+	};
+
+	uint64_t Steps = 0;
+	float TimeStep = 0.001f;
+	unsigned int Threads = 1;
+	float BoxHalfExtent = 3.0f;
+	BoundaryMode Boundary = BoundaryMode::REFLECTIVE;
+	unsigned int SpatialSortInterval = 100;
+
+	bool UseForceField = true;
+	float Cutoff = 1.0f;
+	float Skin = 0.3f;
+
+	bool UseBarnesHut = false;
+	float Theta = 0.5f;
+	float Softening = 1.0e-3f;
+	float CoulombConstant = 1.0f;
+	std::array<float, AtomicRadii.size()> Charges = {};
+
+	std::vector<Atom> Atoms;
+
+	std::string TrajectoryFile;
+	unsigned int TrajectoryInterval = 10;
+	TrajectoryWriter::Settings TrajectorySettings;
+
+	std::string StatsFile;
+	uint64_t ProgressInterval = 0;
+};
+
+// Throws std::runtime_error with a description of the problem if the file cannot be read or is invalid
+BatchConfig LoadBatchConfig(const std::string& filename);
+
+// 'jobSystem' (used by the integration loops and the force fields) must outlive the simulation. With nullptr,
+// everything runs on the calling thread
+std::unique_ptr<Simulation> CreateSimulation(const BatchConfig& config, Evergreen::JobSystem* jobSystem);
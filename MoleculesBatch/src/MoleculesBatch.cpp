@@ -0,0 +1,161 @@
+#include "BatchConfig.h"
+#include "Evergreen/Utils/JobSystem.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+// Headless batch runner - loads a BatchConfig, runs the simulation for the requested number of steps and reports
+// the throughput. Only the simulation core and Evergreen's JobSystem are compiled in (no Windows/DirectX), so it also
+// builds on Linux.
+//
+//	MoleculesBatch <config.json> [--steps N] [--threads N] [--trajectory FILE] [--stats FILE] [--quiet]
+//
+// Command line options override the corresponding values from the config file.
+
+static void PrintUsage()
+{
+	std::cerr << "Usage: MoleculesBatch <config.json> [--steps N] [--threads N] [--trajectory FILE] [--stats FILE] [--quiet]\n";
+}
+
+static bool ParseCommandLine(int argc, char** argv, BatchConfig& config, bool& quiet)
+{
+	for (int iii = 2; iii < argc; ++iii)
+	{
+		const bool hasValue = iii + 1 < argc;
+		if (std::strcmp(argv[iii], "--quiet") == 0)
+			quiet = true;
+		else if (std::strcmp(argv[iii], "--steps") == 0 && hasValue)
+			config.Steps = std::stoull(argv[++iii]);
+		else if (std::strcmp(argv[iii], "--threads") == 0 && hasValue)
+			config.Threads = std::max(1u, static_cast<unsigned int>(std::stoul(argv[++iii])));
+		else if (std::strcmp(argv[iii], "--trajectory") == 0 && hasValue)
+			config.TrajectoryFile = argv[++iii];
+		else if (std::strcmp(argv[iii], "--stats") == 0 && hasValue)
+			config.StatsFile = argv[++iii];
+		else
+		{
+			std::cerr << "Unrecognized argument '" << argv[iii] << "'\n";
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	BatchConfig config;
+	bool quiet = false;
+	try
+	{
+		config = LoadBatchConfig(argv[1]);
+		if (!ParseCommandLine(argc, argv, config, quiet))
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+
+	// 'Threads' counts the calling thread, which also runs jobs while it waits on them
+	std::unique_ptr<Evergreen::JobSystem> jobSystem = config.Threads > 1 ? std::make_unique<Evergreen::JobSystem>(config.Threads - 1) : nullptr;
+	std::unique_ptr<Simulation> simulation = CreateSimulation(config, jobSystem.get());
+	const size_t atomCount = simulation->Positions().size();
+
+	if (!config.TrajectoryFile.empty() && !simulation->StartRecording(config.TrajectoryFile, config.TrajectoryInterval, config.TrajectorySettings))
+		return 1;
+
+	// The first step computes the initial forces, so the starting energy is only known after it. Report the energy
+	// after step 1 as the initial energy rather than leaving it at zero
+	using clock = std::chrono::steady_clock;
+	double initialEnergy = 0.0;
+	const clock::time_point start = clock::now();
+	clock::time_point lastProgress = start;
+
+	for (uint64_t step = 1; step <= config.Steps; ++step)
+	{
+		simulation->Step(config.TimeStep);
+
+		if (step == 1)
+			initialEnergy = simulation->PotentialEnergy() + simulation->KineticEnergy();
+
+		if (!quiet && config.ProgressInterval > 0 && step % config.ProgressInterval == 0)
+		{
+			const clock::time_point now = clock::now();
+			const double seconds = std::chrono::duration<double>(now - lastProgress).count();
+			lastProgress = now;
+			std::cerr << "step " << step << "/" << config.Steps
+				<< "  energy " << simulation->PotentialEnergy() + simulation->KineticEnergy()
+				<< "  steps/s " << static_cast<double>(config.ProgressInterval) / seconds << '\n';
+		}
+	}
+
+	const double wallSeconds = std::chrono::duration<double>(clock::now() - start).count();
+
+	// Grab the trajectory stats before StopRecording() destroys the writer
+	const TrajectoryWriter* writer = simulation->GetTrajectoryWriter();
+	const TrajectoryWriter::Stats trajectoryStats = writer != nullptr ? writer->GetStats() : TrajectoryWriter::Stats();
+	const bool trajectoryFailed = simulation->IsRecording() && !simulation->StopRecording();
+
+	// The writer's byte counts do not include the frame index and footer, which are only written when it is closed,
+	// so report the size of the finished file instead
+	uint64_t trajectoryBytes = 0;
+	if (!config.TrajectoryFile.empty())
+	{
+		std::error_code error;
+		const std::uintmax_t fileSize = std::filesystem::file_size(config.TrajectoryFile, error);
+		if (!error)
+			trajectoryBytes = static_cast<uint64_t>(fileSize);
+	}
+	const double finalEnergy = simulation->PotentialEnergy() + simulation->KineticEnergy();
+	const NeighborList::Stats& neighborStats = simulation->GetNeighborList().GetStats();
+	ObservableSample observables;
+	simulation->Observables().ReadLatest(observables);
+
+	json stats;
+	stats["Atoms"] = atomCount;
+	stats["Steps"] = config.Steps;
+	stats["Threads"] = config.Threads;
+	stats["TimeStep"] = config.TimeStep;
+	stats["WallSeconds"] = wallSeconds;
+	stats["StepsPerSecond"] = wallSeconds > 0.0 ? static_cast<double>(config.Steps) / wallSeconds : 0.0;
+	stats["AtomStepsPerSecond"] = wallSeconds > 0.0 ? static_cast<double>(config.Steps) * static_cast<double>(atomCount) / wallSeconds : 0.0;
+	stats["InitialEnergy"] = initialEnergy;
+	stats["FinalEnergy"] = finalEnergy;
+	stats["RelativeEnergyDrift"] = initialEnergy != 0.0 ? (finalEnergy - initialEnergy) / std::abs(initialEnergy) : 0.0;
+	stats["FinalTemperature"] = observables.Temperature;
+	stats["FinalPressure"] = observables.Pressure;
+	stats["NeighborListBuilds"] = neighborStats.Builds;
+	stats["NeighborPairs"] = neighborStats.PairCount;
+	stats["TrajectoryFrames"] = trajectoryStats.FramesWritten;
+	stats["TrajectoryBytes"] = trajectoryBytes;
+
+	const std::string statsText = stats.dump(4);
+	if (!quiet)
+		std::cout << statsText << '\n';
+	if (!config.StatsFile.empty())
+	{
+		std::ofstream statsFile(config.StatsFile);
+		statsFile << statsText << '\n';
+		if (statsFile.fail())
+		{
+			std::cerr << "Failed to write stats file '" << config.StatsFile << "'\n";
+			return 1;
+		}
+	}
+
+	return trajectoryFailed ? 1 : 0;
+}
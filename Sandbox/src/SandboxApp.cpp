@@ -23,9 +23,13 @@ public:
 
 protected:
 	std::unique_ptr<Scene> m_scene;
+	// The FPS text is bound to this, so it is only re-laid out when the frame rate actually changes
+	Observable<unsigned int> m_framesPerSecond;
 
 	void OnUpdate(const Timer& timer) override
 	{
+		m_framesPerSecond.Set(timer.GetFramesPerSecond());
+
 		auto vp = m_ui->GetControlByName<Viewport>("MainViewport");
 		m_scene->SetAspectRatio(vp->GetAspectRatio());
 
@@ -66,14 +70,8 @@ private:
 
 
 		// TESTING ================================================================================
-		// Text::OnUpdate
-		JSONLoaders::AddOnUpdateCallback("SetFPSText",
-			[](Control* c, const Timer& timer)
-			{
-				Text* text = static_cast<Text*>(c);
-				text->SetText(std::format(L"{}", timer.GetFramesPerSecond()));
-			}
-		);
+		// Text binding (main.json: "Text": "{bind:fps}")
+		JSONLoaders::AddObservable("fps", m_framesPerSecond);
 		
 		
 		
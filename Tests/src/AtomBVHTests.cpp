@@ -0,0 +1,136 @@
+#include "Check.h"
+#include "AtomBVH.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// Brute force reference: nearest t >= 0 over every sphere (same intersection math as AtomBVH::Raycast)
+static AtomBVH::RayHit RaycastBruteForce(const std::vector<float>& positions, const std::vector<float>& radii, const float origin[3], const float direction[3])
+{
+	AtomBVH::RayHit hit;
+	float best = std::numeric_limits<float>::infinity();
+	const float a = direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2];
+
+	for (size_t iii = 0; iii < radii.size(); ++iii)
+	{
+		const float* c = &positions[3 * iii];
+		const float oc[3] = { origin[0] - c[0], origin[1] - c[1], origin[2] - c[2] };
+		const float b = oc[0] * direction[0] + oc[1] * direction[1] + oc[2] * direction[2];
+		const float cc = oc[0] * oc[0] + oc[1] * oc[1] + oc[2] * oc[2] - radii[iii] * radii[iii];
+		const float discriminant = b * b - a * cc;
+		if (discriminant < 0.0f)
+			continue;
+
+		const float root = std::sqrt(discriminant);
+		float t = (-b - root) / a;
+		if (t < 0.0f)
+			t = (-b + root) / a;
+		if (t >= 0.0f && t < best)
+		{
+			best = t;
+			hit.index = static_cast<uint32_t>(iii);
+			hit.distance = t;
+		}
+	}
+	return hit;
+}
+
+// Casts 'rayCount' random rays through the cloud and checks that the BVH finds the same nearest sphere as brute force
+static void CheckRaysMatchBruteForce(const AtomBVH& bvh, const std::vector<float>& positions, const std::vector<float>& radii, TestRandom& random, unsigned int rayCount)
+{
+	unsigned int hits = 0;
+	unsigned int mismatches = 0;
+	for (unsigned int ray = 0; ray < rayCount; ++ray)
+	{
+		const float origin[3] = { random.NextFloat(-40.0f, 40.0f), random.NextFloat(-40.0f, 40.0f), -60.0f };
+		const float target[3] = { random.NextFloat(-20.0f, 20.0f), random.NextFloat(-20.0f, 20.0f), random.NextFloat(-20.0f, 20.0f) };
+		const float direction[3] = { target[0] - origin[0], target[1] - origin[1], target[2] - origin[2] };
+
+		AtomBVH::RayHit expected = RaycastBruteForce(positions, radii, origin, direction);
+		AtomBVH::RayHit actual = bvh.Raycast(origin, direction);
+
+		// Two spheres can be hit at exactly the same distance, so compare distances rather than requiring the same index
+		const bool same = expected.index == actual.index ||
+			(expected.index != AtomBVH::InvalidIndex && actual.index != AtomBVH::InvalidIndex && std::abs(expected.distance - actual.distance) <= 1e-6f);
+		if (!same)
+			++mismatches;
+		if (expected.index != AtomBVH::InvalidIndex)
+			++hits;
+	}
+
+	CHECK(mismatches == 0);
+	CHECK(hits > 0); // Make sure the test actually exercises hits and not just misses
+}
+
+static void TestBuildAndRefit()
+{
+	TestRandom random(27);
+	const size_t count = 20000;
+
+	std::vector<float> positions(3 * count);
+	std::vector<float> radii(count);
+	for (size_t iii = 0; iii < count; ++iii)
+	{
+		positions[3 * iii + 0] = random.NextFloat(-25.0f, 25.0f);
+		positions[3 * iii + 1] = random.NextFloat(-25.0f, 25.0f);
+		positions[3 * iii + 2] = random.NextFloat(-25.0f, 25.0f);
+		radii[iii] = random.NextFloat(0.1f, 0.6f);
+	}
+
+	AtomBVH bvh;
+	CHECK(bvh.Empty());
+
+	double buildMs = TimeMilliseconds([&]() { bvh.Build(positions.data(), radii.data(), count); });
+	CHECK(bvh.SphereCount() == count);
+	CHECK(!bvh.Empty());
+	CheckRaysMatchBruteForce(bvh, positions, radii, random, 2000);
+
+	// Move every sphere and refit - the topology is kept, but the results must still be exact
+	for (size_t iii = 0; iii < 3 * count; ++iii)
+		positions[iii] += random.NextFloat(-2.0f, 2.0f);
+
+	double refitMs = TimeMilliseconds([&]() { bvh.Refit(positions.data(), radii.data()); });
+	CheckRaysMatchBruteForce(bvh, positions, radii, random, 2000);
+
+	const float origin[3] = { 0.0f, 0.0f, -60.0f };
+	const float direction[3] = { 0.01f, 0.02f, 1.0f };
+	AtomBVH::RayHit hit;
+	double bvhRayUs = 1000.0 * TimeMilliseconds([&]() { hit = bvh.Raycast(origin, direction); }, 1000);
+	double bruteRayUs = 1000.0 * TimeMilliseconds([&]() { hit = RaycastBruteForce(positions, radii, origin, direction); }, 100);
+	std::printf("AtomBVH (%zu spheres): build %.3f ms, refit %.3f ms, raycast %.2f us (brute force %.2f us)\n", count, buildMs, refitMs, bvhRayUs, bruteRayUs);
+}
+
+static void TestEdgeCases()
+{
+	// A single sphere, the ray starting inside it, and a zero direction
+	std::vector<float> positions = { 0.0f, 0.0f, 5.0f };
+	std::vector<float> radii = { 1.0f };
+
+	AtomBVH bvh;
+	bvh.Build(positions.data(), radii.data(), 1);
+
+	const float origin[3] = { 0.0f, 0.0f, 0.0f };
+	const float forward[3] = { 0.0f, 0.0f, 1.0f };
+	const float backward[3] = { 0.0f, 0.0f, -1.0f };
+	const float zero[3] = { 0.0f, 0.0f, 0.0f };
+
+	AtomBVH::RayHit hit = bvh.Raycast(origin, forward);
+	CHECK(hit.index == 0);
+	CHECK_NEAR(hit.distance, 4.0f, 1e-5f);
+
+	CHECK(bvh.Raycast(origin, backward).index == AtomBVH::InvalidIndex);
+	CHECK(bvh.Raycast(origin, zero).index == AtomBVH::InvalidIndex);
+
+	const float inside[3] = { 0.0f, 0.0f, 5.0f };
+	hit = bvh.Raycast(inside, forward);
+	CHECK(hit.index == 0);
+	CHECK_NEAR(hit.distance, 1.0f, 1e-5f);
+}
+
+int main()
+{
+	TestBuildAndRefit();
+	TestEdgeCases();
+	return TestResult("AtomBVHTests");
+}
@@ -0,0 +1,209 @@
+#include "Check.h"
+#include "BarnesHut.h"
+#include "Evergreen/Utils/JobSystem.h"
+
+#include <cmath>
+#include <vector>
+
+struct ErrorStats
+{
+	double RmsRelative;	// sqrt(sum |F - F_direct|^2 / sum |F_direct|^2)
+	double EnergyRelative;
+};
+
+static ErrorStats CompareToDirect(const std::vector<float>& forces, double energy, const std::vector<float>& directForces, double directEnergy)
+{
+	double errorSquared = 0.0;
+	double magnitudeSquared = 0.0;
+	for (size_t iii = 0; iii < forces.size(); ++iii)
+	{
+		const double difference = static_cast<double>(forces[iii]) - directForces[iii];
+		errorSquared += difference * difference;
+		magnitudeSquared += static_cast<double>(directForces[iii]) * directForces[iii];
+	}
+	return { std::sqrt(errorSquared / magnitudeSquared), std::abs(energy - directEnergy) / std::abs(directEnergy) };
+}
+
+// Random cloud of +/- charges (two element types), clumped a little so the tree is not uniform. 'extent' scales with the
+// atom count so the density stays the same across sizes
+static void MakeCloud(TestRandom& random, size_t count, float extent, std::vector<float>& positions, std::vector<int>& elementTypes)
+{
+	positions.resize(3 * count);
+	elementTypes.resize(count);
+	for (size_t iii = 0; iii < count; ++iii)
+	{
+		const float clump = (iii % 4 == 0) ? 0.4f * extent : 0.0f;
+		positions[3 * iii + 0] = random.NextFloat(-extent, extent) * (iii % 3 == 0 ? 0.3f : 1.0f) + clump;
+		positions[3 * iii + 1] = random.NextFloat(-extent, extent);
+		positions[3 * iii + 2] = random.NextFloat(-extent, extent) + clump;
+		elementTypes[iii] = static_cast<int>(iii % 2);
+	}
+}
+
+static void TestThetaSweep()
+{
+	TestRandom random(34);
+	const size_t count = 4000;
+
+	std::vector<float> positions;
+	std::vector<int> elementTypes;
+	MakeCloud(random, count, 20.0f, positions, elementTypes);
+
+	ForceFieldInput input;
+	input.PositionsXYZ = positions.data();
+	input.ElementTypes = elementTypes.data();
+	input.Count = count;
+
+	BarnesHut solver(0.0f);
+	solver.SetCharge(0, 1.0f);
+	solver.SetCharge(1, -1.0f);
+	solver.SetSoftening(0.05f);
+
+	std::vector<float> directForces(3 * count), forces(3 * count);
+	double directEnergy = 0.0;
+	double directMs = TimeMilliseconds([&]() { directEnergy = solver.ComputeForcesDirect(input, directForces.data()); });
+
+	// theta = 0 opens every node, so it is the exact sum (up to summation order)
+	// Larger theta must stay within the error expected of a dipole expansion and get faster
+	struct Case { float Theta; double MaxRmsError; };
+	const Case cases[] = { { 0.0f, 1e-5 }, { 0.3f, 3e-3 }, { 0.5f, 1e-2 }, { 0.7f, 3e-2 }, { 1.0f, 8e-2 } };
+
+	double previousError = 0.0;
+	for (const Case& testCase : cases)
+	{
+		solver.SetTheta(testCase.Theta);
+		double energy = 0.0;
+		double ms = TimeMilliseconds([&]() { energy = solver.ComputeForces(input, forces.data()); });
+		ErrorStats error = CompareToDirect(forces, energy, directForces, directEnergy);
+
+		CHECK(error.RmsRelative <= testCase.MaxRmsError);
+		CHECK(error.EnergyRelative <= testCase.MaxRmsError);
+		CHECK(error.RmsRelative + 1e-7 >= previousError); // Opening fewer nodes never makes it more accurate on average
+		previousError = error.RmsRelative;
+
+		std::printf("BarnesHut theta %.1f (%zu atoms): %.3f ms, rms force error %.2e, energy error %.2e (direct %.3f ms)\n",
+			testCase.Theta, count, ms, error.RmsRelative, error.EnergyRelative, directMs);
+	}
+
+	// The result does not depend on whether the subtrees are built/evaluated as jobs on other threads
+	solver.SetTheta(0.5f);
+	std::vector<float> threadedForces(3 * count);
+	const double energy = solver.ComputeForces(input, forces.data());
+	Evergreen::JobSystem jobs(3);
+	solver.SetJobSystem(&jobs);
+	const double threadedEnergy = solver.ComputeForces(input, threadedForces.data());
+	CHECK_NEAR(threadedEnergy, energy, 1e-9 * std::abs(energy));
+	CHECK(CompareToDirect(threadedForces, threadedEnergy, forces, energy).RmsRelative < 1e-6);
+}
+
+// Cost against the atom count, on 1 and 4 threads, next to the O(n^2) direct sum. The printed exponent is the slope of
+// log(time) over log(count) between consecutive sizes: about 1 (plus a little for the log n) for Barnes-Hut, 2 for direct
+static void TestScaling()
+{
+	Evergreen::JobSystem jobs(3);
+	double previousCount = 0.0, previousSerialMs = 0.0, previousDirectMs = 0.0;
+
+	for (size_t count : { size_t(2000), size_t(8000), size_t(32000) })
+	{
+		TestRandom random(234 + count);
+		std::vector<float> positions;
+		std::vector<int> elementTypes;
+		MakeCloud(random, count, 20.0f * std::cbrt(count / 4000.0f), positions, elementTypes);
+
+		ForceFieldInput input;
+		input.PositionsXYZ = positions.data();
+		input.ElementTypes = elementTypes.data();
+		input.Count = count;
+
+		BarnesHut solver(0.5f);
+		solver.SetCharge(0, 1.0f);
+		solver.SetCharge(1, -1.0f);
+		solver.SetSoftening(0.05f);
+
+		std::vector<float> directForces(3 * count), forces(3 * count), threadedForces(3 * count);
+		double directEnergy = 0.0, energy = 0.0, threadedEnergy = 0.0;
+		const double directMs = TimeMilliseconds([&]() { directEnergy = solver.ComputeForcesDirect(input, directForces.data()); });
+
+		(void)solver.ComputeForces(input, forces.data()); // Warm up (node/scratch allocations)
+		const double serialMs = TimeMilliseconds([&]() { energy = solver.ComputeForces(input, forces.data()); }, 3);
+		solver.SetJobSystem(&jobs);
+		(void)solver.ComputeForces(input, threadedForces.data());
+		const double threadedMs = TimeMilliseconds([&]() { threadedEnergy = solver.ComputeForces(input, threadedForces.data()); }, 3);
+
+		CHECK(CompareToDirect(forces, energy, directForces, directEnergy).RmsRelative <= 1e-2);
+		CHECK(CompareToDirect(threadedForces, threadedEnergy, forces, energy).RmsRelative < 1e-6);
+
+		std::printf("BarnesHut theta 0.5 (%zu atoms): 1 thread %.3f ms, %u threads %.3f ms, direct %.3f ms",
+			count, serialMs, jobs.ThreadCount(), threadedMs, directMs);
+		if (previousCount > 0.0)
+		{
+			const double logCountRatio = std::log(count / previousCount);
+			std::printf(", exponent %.2f (direct %.2f)", std::log(serialMs / previousSerialMs) / logCountRatio, std::log(directMs / previousDirectMs) / logCountRatio);
+		}
+		std::printf("\n");
+
+		previousCount = static_cast<double>(count);
+		previousSerialMs = serialMs;
+		previousDirectMs = directMs;
+	}
+}
+
+static void TestTreeInvariants()
+{
+	TestRandom random(134);
+	const size_t count = 3000;
+	std::vector<float> positions(3 * count);
+	std::vector<int> elementTypes(count, 0);
+	for (float& value : positions)
+		value = random.NextFloat(-10.0f, 10.0f);
+
+	ForceFieldInput input;
+	input.PositionsXYZ = positions.data();
+	input.ElementTypes = elementTypes.data();
+	input.Count = count;
+
+	BarnesHut solver(0.5f);
+	solver.SetCharge(0, 1.0f);
+	std::vector<float> forces(3 * count);
+	(void)solver.ComputeForces(input, forces.data());
+
+	const std::vector<BarnesHut::Node>& nodes = solver.Nodes();
+	CHECK(!nodes.empty());
+	CHECK(nodes[0].begin == 0 && nodes[0].end == count);
+	CHECK_NEAR(nodes[0].charge, static_cast<float>(count), 1e-3f * count);
+
+	// Children partition their parent's atoms and their charges add up. Leaves are small unless the depth limit was hit
+	bool partitions = true;
+	bool chargesAddUp = true;
+	bool leavesSmall = true;
+	for (const BarnesHut::Node& node : nodes)
+	{
+		if (node.childCount == 0)
+		{
+			leavesSmall = leavesSmall && (node.end - node.begin <= BarnesHut::MaxLeafSize || node.halfSize <= nodes[0].halfSize / (1 << BarnesHut::MaxDepth) * 2.0f);
+			continue;
+		}
+
+		uint32_t expectedBegin = node.begin;
+		float charge = 0.0f;
+		for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child)
+		{
+			partitions = partitions && nodes[child].begin == expectedBegin;
+			expectedBegin = nodes[child].end;
+			charge += nodes[child].charge;
+		}
+		partitions = partitions && expectedBegin == node.end;
+		chargesAddUp = chargesAddUp && std::abs(charge - node.charge) <= 1e-3f * std::fmax(1.0f, std::abs(node.charge));
+	}
+	CHECK(partitions);
+	CHECK(chargesAddUp);
+	CHECK(leavesSmall);
+}
+
+int main()
+{
+	TestThetaSweep();
+	TestScaling();
+	TestTreeInvariants();
+	return TestResult("BarnesHutTests");
+}
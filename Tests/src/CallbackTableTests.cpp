@@ -0,0 +1,114 @@
+#include "Check.h"
+#include "Evergreen/UI/Controls/CallbackTable.h"
+
+#include <string>
+
+using Evergreen::CallbackSlot;
+using Evergreen::CallbackTable;
+
+struct TestEvent
+{
+	int Value;
+};
+
+static constexpr CallbackSlot<void(TestEvent&)> SlotA{ 0 };
+static constexpr CallbackSlot<void(TestEvent&)> SlotB{ 3 };
+static constexpr CallbackSlot<void(int)> SlotC{ 7 };
+
+static void TestSetAndInvoke()
+{
+	CallbackTable table;
+	int hits = 0;
+	TestEvent e{ 1 };
+
+	table.Invoke(SlotA, e); // Never set - nothing happens
+	CHECK(table.Count() == 0u && table.HeapBytes() == 0u);
+
+	table.Set(SlotB, std::function<void(TestEvent&)>([&hits](TestEvent& event) { hits += event.Value; }));
+	table.Set(SlotA, std::function<void(TestEvent&)>([&hits](TestEvent& event) { hits += 10 * event.Value; }));
+	table.Set(SlotC, std::function<void(int)>([&hits](int value) { hits += 100 * value; }));
+	CHECK(table.Count() == 3u);
+
+	table.Invoke(SlotA, e);
+	table.Invoke(SlotB, e);
+	table.Invoke(SlotC, 2);
+	CHECK(hits == 211);
+
+	// Replace, then remove
+	table.Set(SlotA, std::function<void(TestEvent&)>([&hits](TestEvent&) { hits = -1; }));
+	table.Invoke(SlotA, e);
+	CHECK(hits == -1);
+	table.Set(SlotA, std::function<void(TestEvent&)>());
+	CHECK(!table.IsSet(SlotA) && table.IsSet(SlotB) && table.Count() == 2u);
+	table.Invoke(SlotB, e);
+	CHECK(hits == 0);
+}
+
+// Callbacks that change the table while they run. The running callback's captures must stay valid until it returns,
+// including captures stored inside the std::function itself
+static void TestReentrancy()
+{
+	CallbackTable table;
+	int total = 0;
+
+	std::string tag = "captured";
+	table.Set(SlotA, std::function<void(TestEvent&)>([&table, &total, tag](TestEvent& event)
+		{
+			table.Set(SlotA, std::function<void(TestEvent&)>());
+			total += event.Value;
+			CHECK(tag == "captured");
+		}
+	));
+	TestEvent e{ 1 };
+	table.Invoke(SlotA, e);
+	CHECK(!table.IsSet(SlotA) && total == 1);
+
+	// Replace itself, add and remove others and invoke them, all from inside a callback
+	total = 0;
+	table.Set(SlotC, std::function<void(int)>([&total](int value) { total += value; }));
+	table.Set(SlotA, std::function<void(TestEvent&)>([&table, &total](TestEvent& event)
+		{
+			table.Set(SlotA, std::function<void(TestEvent&)>([&total](TestEvent&) { total += 1000; }));
+			table.Set(SlotB, std::function<void(TestEvent&)>([&total](TestEvent&) { total += 100; }));
+			table.Invoke(SlotC, 10);
+
+			TestEvent nested{ 0 };
+			table.Invoke(SlotB, nested);
+			table.Invoke(SlotA, nested);
+			table.Set(SlotC, std::function<void(int)>());
+			total += event.Value;
+		}
+	));
+	e.Value = 5;
+	table.Invoke(SlotA, e);
+	CHECK(total == 1115);
+	CHECK(table.IsSet(SlotA) && table.IsSet(SlotB) && !table.IsSet(SlotC) && table.Count() == 2u);
+
+	table.Invoke(SlotA, e);
+	CHECK(total == 2115);
+}
+
+int main()
+{
+	TestSetAndInvoke();
+	TestReentrancy();
+
+	// Dispatch cost of a callback whose closure is too big for std::function's small buffer
+	CallbackTable table;
+	double padding[16] = { 0.0, 1.0 };
+	long long sum = 0;
+	table.Set(SlotA, std::function<void(TestEvent&)>([padding, &sum](TestEvent& event) { sum += event.Value + static_cast<long long>(padding[1]); }));
+
+	const unsigned int invokeCount = 10000000;
+	TestEvent e{ 1 };
+	double ms = TimeMilliseconds([&]()
+		{
+			for (unsigned int iii = 0; iii < invokeCount; ++iii)
+				table.Invoke(SlotA, e);
+		}
+	);
+	CHECK(sum == 2LL * invokeCount);
+	std::printf("CallbackTable: %.2f ns per Invoke, %zu bytes per table\n", 1e6 * ms / invokeCount, sizeof(CallbackTable));
+
+	return TestResult("CallbackTableTests");
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+
+// Minimal helpers shared by the test executables. A failed CHECK prints the expression and its location and is
+// counted, and main() returns TestResult() so that ctest reports the executable as failed if anything did not hold.
+
+inline int& CheckFailures() noexcept
+{
+	static int failures = 0;
+	return failures;
+}
+
+#define CHECK(x) { if (!(x)) { std::fprintf(stderr, "%s:%d - CHECK failed: %s\n", __FILE__, __LINE__, #x); ++CheckFailures(); } }
+#define CHECK_NEAR(a, b, tolerance) { if (!(std::abs((a) - (b)) <= (tolerance))) { std::fprintf(stderr, "%s:%d - CHECK_NEAR failed: %s = %g, %s = %g (tolerance %g)\n", __FILE__, __LINE__, #a, static_cast<double>(a), #b, static_cast<double>(b), static_cast<double>(tolerance)); ++CheckFailures(); } }
+
+inline int TestResult(const char* name) noexcept
+{
+	if (CheckFailures() == 0)
+		std::printf("%s: all checks passed\n", name);
+	else
+		std::printf("%s: %d check(s) FAILED\n", name, CheckFailures());
+	return CheckFailures() == 0 ? 0 : 1;
+}
+
+// Runs 'fn' 'iterations' times and returns the average time of one run in milliseconds
+template<typename F>
+double TimeMilliseconds(F&& fn, unsigned int iterations = 1)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned int iii = 0; iii < iterations; ++iii)
+		fn();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+// Small deterministic generator so every run (and every platform) tests the same data
+class TestRandom
+{
+public:
+	explicit TestRandom(unsigned long long seed) noexcept : m_state(seed) {}
+
+	inline unsigned int NextUInt() noexcept
+	{
+		m_state = m_state * 6364136223846793005ULL + 1442695040888963407ULL;
+		return static_cast<unsigned int>(m_state >> 33);
+	}
+	// Uniform in [low, high)
+	inline float NextFloat(float low, float high) noexcept
+	{
+		return low + (high - low) * (static_cast<float>(NextUInt() & 0xFFFFFF) / 16777216.0f);
+	}
+
+private:
+	unsigned long long m_state;
+};
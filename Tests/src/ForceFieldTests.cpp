@@ -0,0 +1,259 @@
+#include "Check.h"
+#include "ForceField.h"
+#include "Simulation.h"
+#include "Evergreen/Utils/JobSystem.h"
+
+#include <cmath>
+#include <vector>
+
+// Jittered cubic lattice so no two atoms are close enough for the Lennard-Jones term to blow up
+struct TestSystem
+{
+	std::vector<float> Positions;
+	std::vector<int> ElementTypes;
+};
+
+static TestSystem MakeLattice(TestRandom& random, unsigned int side, float spacing)
+{
+	TestSystem system;
+	for (unsigned int x = 0; x < side; ++x)
+	{
+		for (unsigned int y = 0; y < side; ++y)
+		{
+			for (unsigned int z = 0; z < side; ++z)
+			{
+				system.Positions.push_back(x * spacing + random.NextFloat(-0.15f, 0.15f));
+				system.Positions.push_back(y * spacing + random.NextFloat(-0.15f, 0.15f));
+				system.Positions.push_back(z * spacing + random.NextFloat(-0.15f, 0.15f));
+				system.ElementTypes.push_back(static_cast<int>(random.NextUInt() % 2));
+			}
+		}
+	}
+	return system;
+}
+
+static void SetParameters(LennardJonesCoulomb& forceField)
+{
+	forceField.SetElementParameters(0, { 1.0f, 1.0f, 0.5f });
+	forceField.SetElementParameters(1, { 1.2f, 0.5f, -0.5f });
+	forceField.SetCoulombConstant(2.0f);
+}
+
+// Largest per-component difference relative to the largest force magnitude
+static float MaxRelativeDifference(const std::vector<float>& a, const std::vector<float>& b)
+{
+	float maxDifference = 0.0f;
+	float maxMagnitude = 0.0f;
+	for (size_t iii = 0; iii < a.size(); ++iii)
+	{
+		maxDifference = std::fmax(maxDifference, std::abs(a[iii] - b[iii]));
+		maxMagnitude = std::fmax(maxMagnitude, std::abs(b[iii]));
+	}
+	return maxMagnitude == 0.0f ? maxDifference : maxDifference / maxMagnitude;
+}
+
+static void TestSimdMatchesScalar()
+{
+	TestRandom random(32);
+	TestSystem system = MakeLattice(random, 16, 1.1f);
+	const size_t count = system.ElementTypes.size();
+
+	LennardJonesCoulomb forceField(2.5f);
+	SetParameters(forceField);
+
+	NeighborList neighbors(forceField.Cutoff(), 0.3f);
+	neighbors.Build(system.Positions.data(), count);
+
+	ForceFieldInput input;
+	input.PositionsXYZ = system.Positions.data();
+	input.ElementTypes = system.ElementTypes.data();
+	input.Count = count;
+	input.Neighbors = &neighbors;
+
+	std::vector<float> simd(3 * count), scalar(3 * count), threaded(3 * count);
+	double simdEnergy = 0.0, scalarEnergy = 0.0, threadedEnergy = 0.0;
+
+	double simdMs = TimeMilliseconds([&]() { simdEnergy = forceField.ComputeForces(input, simd.data()); }, 5);
+	const double simdVirial = forceField.Virial();
+	double scalarMs = TimeMilliseconds([&]() { scalarEnergy = forceField.ComputeForcesScalar(input, scalar.data()); }, 5);
+
+	CHECK(MaxRelativeDifference(simd, scalar) < 1e-4f);
+	CHECK_NEAR(simdEnergy, scalarEnergy, 1e-4 * std::abs(scalarEnergy));
+
+	// Splitting the atoms across jobs only changes the order the forces are summed in
+	Evergreen::JobSystem jobs(3);
+	forceField.SetJobSystem(&jobs);
+	double threadedMs = TimeMilliseconds([&]() { threadedEnergy = forceField.ComputeForces(input, threaded.data()); }, 5);
+	CHECK(MaxRelativeDifference(threaded, simd) < 1e-4f);
+	CHECK_NEAR(threadedEnergy, simdEnergy, 1e-6 * std::abs(simdEnergy));
+	CHECK_NEAR(forceField.Virial(), simdVirial, 1e-6 * std::abs(simdVirial));
+
+	// Newton's third law - the net force is zero (relative to the size of the individual forces)
+	double net[3] = { 0.0, 0.0, 0.0 };
+	double magnitude = 0.0;
+	for (size_t iii = 0; iii < count; ++iii)
+	{
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			net[axis] += simd[3 * iii + axis];
+			magnitude += std::abs(simd[3 * iii + axis]);
+		}
+	}
+	for (unsigned int axis = 0; axis < 3; ++axis)
+		CHECK(std::abs(net[axis]) < 1e-4 * magnitude);
+
+	// Throughput in neighbor list pairs per second, so it can be compared across system sizes
+	auto megaPairsPerSecond = [&neighbors](double ms) { return 1e-3 * static_cast<double>(neighbors.PairCount()) / ms; };
+	std::printf("LennardJonesCoulomb (%zu atoms, %zu pairs): SIMD %.1f Mpairs/s, scalar %.1f Mpairs/s, 4 threads %.1f Mpairs/s\n",
+		count, neighbors.PairCount(), megaPairsPerSecond(simdMs), megaPairsPerSecond(scalarMs), megaPairsPerSecond(threadedMs));
+}
+
+// The forces must be the negative gradient of the energy
+static void TestForceIsEnergyGradient()
+{
+	TestRandom random(132);
+	TestSystem system = MakeLattice(random, 4, 1.1f);
+	const size_t count = system.ElementTypes.size();
+
+	LennardJonesCoulomb forceField(2.5f);
+	SetParameters(forceField);
+
+	// Large skin so the list stays valid while single atoms are nudged
+	NeighborList neighbors(forceField.Cutoff(), 1.0f);
+	neighbors.Build(system.Positions.data(), count);
+
+	ForceFieldInput input;
+	input.PositionsXYZ = system.Positions.data();
+	input.ElementTypes = system.ElementTypes.data();
+	input.Count = count;
+	input.Neighbors = &neighbors;
+
+	std::vector<float> forces(3 * count), scratch(3 * count);
+	forceField.ComputeForcesScalar(input, forces.data());
+
+	const float h = 1e-3f;
+	for (size_t atom = 0; atom < count; atom += 7)
+	{
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			float& coordinate = system.Positions[3 * atom + axis];
+			const float original = coordinate;
+
+			coordinate = original + h;
+			const double energyPlus = forceField.ComputeForcesScalar(input, scratch.data());
+			coordinate = original - h;
+			const double energyMinus = forceField.ComputeForcesScalar(input, scratch.data());
+			coordinate = original;
+
+			const double numeric = -(energyPlus - energyMinus) / (2.0 * h);
+			CHECK_NEAR(forces[3 * atom + axis], numeric, 2e-2 * std::fmax(1.0, std::abs(numeric)));
+		}
+	}
+}
+
+static void TestForceFieldSum()
+{
+	TestRandom random(232);
+	TestSystem system = MakeLattice(random, 6, 1.1f);
+	const size_t count = system.ElementTypes.size();
+
+	auto shortRange = std::make_unique<LennardJonesCoulomb>(2.0f);
+	auto longRange = std::make_unique<LennardJonesCoulomb>(3.0f);
+	SetParameters(*shortRange);
+	SetParameters(*longRange);
+
+	NeighborList neighbors(3.0f, 0.3f);
+	neighbors.Build(system.Positions.data(), count);
+
+	ForceFieldInput input;
+	input.PositionsXYZ = system.Positions.data();
+	input.ElementTypes = system.ElementTypes.data();
+	input.Count = count;
+	input.Neighbors = &neighbors;
+
+	std::vector<float> expectedShort(3 * count), expectedLong(3 * count), actual(3 * count);
+	const double energyShort = shortRange->ComputeForces(input, expectedShort.data());
+	const double energyLong = longRange->ComputeForces(input, expectedLong.data());
+	const double virial = shortRange->Virial() + longRange->Virial();
+
+	ForceFieldSum sum;
+	sum.Add(std::move(shortRange));
+	sum.Add(std::move(longRange));
+	CHECK(sum.Cutoff() == 3.0f);
+
+	const double energy = sum.ComputeForces(input, actual.data());
+	CHECK_NEAR(energy, energyShort + energyLong, 1e-9 * std::abs(energy));
+	CHECK_NEAR(sum.Virial(), virial, 1e-9 * std::abs(virial));
+
+	for (size_t iii = 0; iii < 3 * count; ++iii)
+		expectedShort[iii] += expectedLong[iii];
+	CHECK(MaxRelativeDifference(actual, expectedShort) < 1e-6f);
+}
+
+// Velocity-Verlet through Simulation::Step must conserve the total energy. A warm Helium crystal in a periodic box, so
+// atoms keep crossing the cutoff and the neighbor list gets rebuilt along the way
+static void TestEnergyConservation()
+{
+	const unsigned int side = 6;
+	const float spacing = 0.26f;				// Just past the pair minimum (2 * Helium radius)
+	const float halfExtent = 0.5f * side * spacing;
+	const float timeStep = 0.002f;
+	const unsigned int steps = 4000;
+
+	TestRandom random(332);
+	Simulation simulation;
+	simulation.SetBoxHalfExtent(halfExtent);
+	for (unsigned int x = 0; x < side; ++x)
+	{
+		for (unsigned int y = 0; y < side; ++y)
+		{
+			for (unsigned int z = 0; z < side; ++z)
+			{
+				const DirectX::XMFLOAT3 position{ -halfExtent + (x + 0.5f) * spacing, -halfExtent + (y + 0.5f) * spacing, -halfExtent + (z + 0.5f) * spacing };
+				const DirectX::XMFLOAT3 velocity{ random.NextFloat(-0.5f, 0.5f), random.NextFloat(-0.5f, 0.5f), random.NextFloat(-0.5f, 0.5f) };
+				simulation.Add(Element::Helium, position, velocity);
+			}
+		}
+	}
+
+	// (cutoff + skin) must not exceed half the box length in PERIODIC mode
+	simulation.GetNeighborList().SetSkin(0.1f);
+	simulation.SetForceField(CreateDefaultForceField(0.6f));
+	simulation.SetBoundaryMode(BoundaryMode::PERIODIC);
+	simulation.Play();
+
+	// The forces (and so the potential energy) are only computed by the first step
+	simulation.Step(timeStep);
+	const double initialEnergy = simulation.PotentialEnergy() + simulation.KineticEnergy();
+	const double initialKineticEnergy = simulation.KineticEnergy();
+
+	double maxDrift = 0.0;
+	double ms = TimeMilliseconds([&]()
+		{
+			for (unsigned int step = 1; step < steps; ++step)
+			{
+				simulation.Step(timeStep);
+				maxDrift = std::fmax(maxDrift, std::abs(simulation.PotentialEnergy() + simulation.KineticEnergy() - initialEnergy));
+			}
+		}
+	);
+	const double finalEnergy = simulation.PotentialEnergy() + simulation.KineticEnergy();
+
+	// The crystal must actually have moved energy between kinetic and potential for this to test anything
+	CHECK(std::abs(simulation.KineticEnergy() - initialKineticEnergy) > 0.05 * initialKineticEnergy);
+	CHECK(std::abs(finalEnergy - initialEnergy) < 1e-3 * std::abs(initialEnergy));
+	CHECK(maxDrift < 5e-3 * std::abs(initialEnergy));
+
+	std::printf("Energy conservation (%zu atoms, %u steps of %g): relative drift %.2e (max %.2e), %.3f ms per step\n",
+		simulation.Positions().size(), steps, timeStep, std::abs(finalEnergy - initialEnergy) / std::abs(initialEnergy),
+		maxDrift / std::abs(initialEnergy), ms / (steps - 1));
+}
+
+int main()
+{
+	TestSimdMatchesScalar();
+	TestForceIsEnergyGradient();
+	TestForceFieldSum();
+	TestEnergyConservation();
+	return TestResult("ForceFieldTests");
+}
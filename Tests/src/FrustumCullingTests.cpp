@@ -0,0 +1,94 @@
+#include "Check.h"
+#include "FrustumCulling.h"
+
+#include <cmath>
+#include <vector>
+
+// Perspective projection laid out like XMMatrixPerspectiveFovLH (row vectors). The camera is at the origin looking
+// down +z, so this is also the view-projection matrix
+static void PerspectiveFovLH(float fovY, float aspect, float nearZ, float farZ, float m[16])
+{
+	const float yScale = 1.0f / std::tan(fovY * 0.5f);
+	const float xScale = yScale / aspect;
+	const float range = farZ / (farZ - nearZ);
+
+	for (unsigned int iii = 0; iii < 16; ++iii)
+		m[iii] = 0.0f;
+
+	m[0] = xScale;
+	m[5] = yScale;
+	m[10] = range;
+	m[11] = 1.0f;
+	m[14] = -range * nearZ;
+}
+
+static bool IsVisible(const FrustumPlanes& planes, float x, float y, float z, float radius)
+{
+	uint32_t index = 0;
+	return CullSpheresScalar(planes, &x, &y, &z, &radius, 1, &index) == 1;
+}
+
+static void TestExtractPlanes()
+{
+	float m[16];
+	PerspectiveFovLH(1.5707963f, 1.0f, 1.0f, 100.0f, m); // 90 degree field of view
+	FrustumPlanes planes = ExtractFrustumPlanes(m);
+
+	// Every plane normal is unit length
+	for (unsigned int iii = 0; iii < FrustumPlanes::Count; ++iii)
+		CHECK_NEAR(planes.a[iii] * planes.a[iii] + planes.b[iii] * planes.b[iii] + planes.c[iii] * planes.c[iii], 1.0f, 1e-5f);
+
+	CHECK(IsVisible(planes, 0.0f, 0.0f, 10.0f, 0.1f));		// Straight ahead
+	CHECK(!IsVisible(planes, 0.0f, 0.0f, -10.0f, 1.0f));		// Behind the camera
+	CHECK(!IsVisible(planes, 0.0f, 0.0f, 0.5f, 0.1f));		// In front of the near plane
+	CHECK(!IsVisible(planes, 0.0f, 0.0f, 150.0f, 1.0f));		// Past the far plane
+	CHECK(IsVisible(planes, 0.0f, 0.0f, 100.5f, 1.0f));		// Straddling the far plane
+	CHECK(!IsVisible(planes, 20.0f, 0.0f, 10.0f, 1.0f));		// Outside the right plane (x = z at 90 degrees)
+	CHECK(IsVisible(planes, 10.5f, 0.0f, 10.0f, 1.0f));		// Straddling the right plane
+	CHECK(!IsVisible(planes, 0.0f, -20.0f, 10.0f, 1.0f));	// Below the bottom plane
+}
+
+// The SIMD path must produce exactly the same (ordered) indices as the scalar reference, including for counts that
+// are not a multiple of the SIMD width
+static void TestSimdMatchesScalar()
+{
+	float m[16];
+	PerspectiveFovLH(1.0f, 16.0f / 9.0f, 0.5f, 200.0f, m);
+	FrustumPlanes planes = ExtractFrustumPlanes(m);
+
+	TestRandom random(26);
+	const size_t maxCount = 100003;
+	std::vector<float> x(maxCount), y(maxCount), z(maxCount), radius(maxCount);
+	for (size_t iii = 0; iii < maxCount; ++iii)
+	{
+		x[iii] = random.NextFloat(-150.0f, 150.0f);
+		y[iii] = random.NextFloat(-150.0f, 150.0f);
+		z[iii] = random.NextFloat(-50.0f, 250.0f);
+		radius[iii] = random.NextFloat(0.1f, 3.0f);
+	}
+
+	std::vector<uint32_t> simdIndices(maxCount), scalarIndices(maxCount);
+	for (size_t count : { size_t(0), size_t(1), size_t(7), size_t(8), size_t(9), size_t(15), size_t(16), size_t(17), size_t(1000), maxCount })
+	{
+		size_t simdVisible = CullSpheres(planes, x.data(), y.data(), z.data(), radius.data(), count, simdIndices.data());
+		size_t scalarVisible = CullSpheresScalar(planes, x.data(), y.data(), z.data(), radius.data(), count, scalarIndices.data());
+
+		CHECK(simdVisible == scalarVisible);
+		bool same = simdVisible == scalarVisible;
+		for (size_t iii = 0; same && iii < simdVisible; ++iii)
+			same = simdIndices[iii] == scalarIndices[iii];
+		CHECK(same);
+	}
+
+	size_t visible = 0;
+	double simdMs = TimeMilliseconds([&]() { visible = CullSpheres(planes, x.data(), y.data(), z.data(), radius.data(), maxCount, simdIndices.data()); }, 20);
+	double scalarMs = TimeMilliseconds([&]() { visible = CullSpheresScalar(planes, x.data(), y.data(), z.data(), radius.data(), maxCount, scalarIndices.data()); }, 20);
+	std::printf("CullSpheres (%zu spheres, %zu visible): SIMD %.3f ms, scalar %.3f ms\n", maxCount, visible, simdMs, scalarMs);
+}
+
+int main()
+{
+	TestExtractPlanes();
+	TestSimdMatchesScalar();
+	return TestResult("FrustumCullingTests");
+}
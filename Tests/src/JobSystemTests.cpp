@@ -0,0 +1,194 @@
+#include "Check.h"
+#include "Evergreen/Utils/JobSystem.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using Evergreen::JobCounter;
+using Evergreen::JobSystem;
+
+// Lots of tiny jobs, scheduled from the pool's own thread (more than fit in one deque, so some overflow into the
+// injection queue) and waited on with a single counter
+static void TestManyJobs(JobSystem& jobs)
+{
+	const unsigned int jobCount = 20000;
+	std::atomic<uint64_t> sum = 0;
+
+	JobCounter counter;
+	for (unsigned int iii = 0; iii < jobCount; ++iii)
+		jobs.Run([&sum, iii]() { sum.fetch_add(iii, std::memory_order_relaxed); }, &counter);
+	jobs.Wait(counter);
+
+	CHECK(counter.IsDone());
+	CHECK(sum.load() == static_cast<uint64_t>(jobCount) * (jobCount - 1) / 2);
+}
+
+// Jobs that schedule and wait on their own children. Waiting threads help execute jobs, so this must not deadlock
+// even though every thread ends up waiting inside a job
+static void Recurse(JobSystem& jobs, unsigned int depth, std::atomic<unsigned int>& leaves)
+{
+	if (depth == 0)
+	{
+		leaves.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	JobCounter children;
+	for (unsigned int iii = 0; iii < 4; ++iii)
+		jobs.Run([&jobs, depth, &leaves]() { Recurse(jobs, depth - 1, leaves); }, &children);
+	jobs.Wait(children);
+}
+
+static void TestNestedWaits(JobSystem& jobs)
+{
+	std::atomic<unsigned int> leaves = 0;
+	Recurse(jobs, 6, leaves);
+	CHECK(leaves.load() == 4096u);
+}
+
+// A chain of stages where every job of a stage must see all of the previous stage's writes
+static void TestDependencies(JobSystem& jobs)
+{
+	const unsigned int stageCount = 50;
+	const unsigned int jobsPerStage = 16;
+	std::vector<std::atomic<unsigned int>> stageDone(stageCount);
+	std::vector<JobCounter> counters(stageCount);
+	std::atomic<unsigned int> orderViolations = 0;
+
+	for (unsigned int stage = 0; stage < stageCount; ++stage)
+	{
+		auto job = [&stageDone, &orderViolations, stage]()
+		{
+			if (stage > 0 && stageDone[stage - 1].load(std::memory_order_acquire) != jobsPerStage)
+				orderViolations.fetch_add(1, std::memory_order_relaxed);
+			stageDone[stage].fetch_add(1, std::memory_order_acq_rel);
+		};
+
+		for (unsigned int iii = 0; iii < jobsPerStage; ++iii)
+		{
+			if (stage == 0)
+				jobs.Run(job, &counters[stage]);
+			else
+				jobs.RunAfter(counters[stage - 1], job, &counters[stage]);
+		}
+	}
+
+	jobs.Wait(counters[stageCount - 1]);
+	for (unsigned int stage = 0; stage < stageCount; ++stage)
+		jobs.Wait(counters[stage]);
+
+	CHECK(orderViolations.load() == 0u);
+	CHECK(stageDone[stageCount - 1].load() == jobsPerStage);
+}
+
+// Every index is visited exactly once, for grain sizes that do and do not divide the range
+static void TestParallelFor(JobSystem& jobs)
+{
+	const size_t count = 100003;
+	std::vector<std::atomic<unsigned int>> visits(count);
+
+	for (size_t grain : { size_t(0), size_t(1), size_t(7), size_t(1000), count, 2 * count })
+	{
+		for (std::atomic<unsigned int>& visit : visits)
+			visit.store(0, std::memory_order_relaxed);
+
+		jobs.ParallelFor(0, count, grain, [&visits, grain](size_t begin, size_t end)
+			{
+				for (size_t iii = begin; iii < end; ++iii)
+					visits[iii].fetch_add(1, std::memory_order_relaxed);
+			}
+		);
+
+		bool exactlyOnce = true;
+		for (const std::atomic<unsigned int>& visit : visits)
+			exactlyOnce = exactlyOnce && visit.load(std::memory_order_relaxed) == 1u;
+		CHECK(exactlyOnce);
+	}
+
+	// Empty ranges are a no-op
+	bool called = false;
+	jobs.ParallelFor(5, 5, 1, [&called](size_t, size_t) { called = true; });
+	CHECK(!called);
+}
+
+// Threads outside the pool schedule through the injection queue and wait (helping) on their own counters
+static void TestExternalThreads(JobSystem& jobs)
+{
+	std::atomic<unsigned int> executed = 0;
+	std::vector<std::thread> threads;
+	for (unsigned int thread = 0; thread < 4; ++thread)
+	{
+		threads.emplace_back([&jobs, &executed]()
+			{
+				CHECK(jobs.CurrentThreadIndex() == jobs.ThreadCount());
+
+				JobCounter counter;
+				for (unsigned int iii = 0; iii < 1000; ++iii)
+					jobs.Run([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); }, &counter);
+				jobs.Wait(counter);
+			}
+		);
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+
+	CHECK(executed.load() == 4000u);
+}
+
+static void RunAll(unsigned int workerThreads)
+{
+	JobSystem jobs(workerThreads);
+	CHECK(jobs.ThreadCount() == workerThreads + 1);
+	CHECK(jobs.CurrentThreadIndex() == 0u);
+
+	// Repeat so that workers go to sleep and are woken up again between rounds
+	for (unsigned int round = 0; round < 5; ++round)
+	{
+		TestManyJobs(jobs);
+		TestNestedWaits(jobs);
+		TestDependencies(jobs);
+		TestParallelFor(jobs);
+		TestExternalThreads(jobs);
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	JobSystem::Stats stats = jobs.GetStats();
+	CHECK(stats.JobsExecuted > 0);
+
+	// Scheduling overhead: empty jobs, and a ParallelFor over a cheap loop body
+	const unsigned int jobCount = 100000;
+	double runMs = TimeMilliseconds([&]()
+		{
+			JobCounter counter;
+			for (unsigned int iii = 0; iii < jobCount; ++iii)
+				jobs.Run([]() {}, &counter);
+			jobs.Wait(counter);
+		}
+	);
+
+	std::vector<float> values(1 << 22, 1.0f);
+	double parallelForMs = TimeMilliseconds([&]()
+		{
+			jobs.ParallelFor(0, values.size(), 16384, [&values](size_t begin, size_t end)
+				{
+					for (size_t iii = begin; iii < end; ++iii)
+						values[iii] = values[iii] * 1.0001f + 0.5f;
+				}
+			);
+		}, 10
+	);
+
+	std::printf("JobSystem (%u threads): %.0f ns per empty job, ParallelFor over %zu floats %.3f ms, %llu jobs executed (%llu stolen, %llu injected)\n",
+		jobs.ThreadCount(), 1e6 * runMs / jobCount, values.size(), parallelForMs,
+		static_cast<unsigned long long>(jobs.GetStats().JobsExecuted), static_cast<unsigned long long>(jobs.GetStats().JobsStolen), static_cast<unsigned long long>(jobs.GetStats().JobsInjected));
+}
+
+int main()
+{
+	// No worker threads (everything runs on the calling thread while it waits), then increasingly contended pools
+	for (unsigned int workerThreads : { 0u, 1u, 3u, 7u })
+		RunAll(workerThreads);
+
+	return TestResult("JobSystemTests");
+}
@@ -0,0 +1,208 @@
+#include "Check.h"
+#include "MortonOrder.h"
+#include "ForceField.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+// Inverse of MortonEncode3 (compacts every third bit)
+static uint32_t Compact(uint32_t v)
+{
+	v &= 0x09249249;
+	v = (v | (v >> 2)) & 0x030C30C3;
+	v = (v | (v >> 4)) & 0x0300F00F;
+	v = (v | (v >> 8)) & 0x030000FF;
+	v = (v | (v >> 16)) & 0x000003FF;
+	return v;
+}
+
+static void TestEncode()
+{
+	static_assert(MortonEncode3(1, 0, 0) == 1);
+	static_assert(MortonEncode3(0, 1, 0) == 2);
+	static_assert(MortonEncode3(0, 0, 1) == 4);
+	static_assert(MortonEncode3(1023, 1023, 1023) == 0x3FFFFFFF);
+	static_assert(MortonEncode3(1024, 0, 0) == 0); // Only the low 10 bits are used
+
+	TestRandom random(33);
+	bool roundTrips = true;
+	for (unsigned int iii = 0; iii < 100000; ++iii)
+	{
+		const uint32_t x = random.NextUInt() & 0x3FF;
+		const uint32_t y = random.NextUInt() & 0x3FF;
+		const uint32_t z = random.NextUInt() & 0x3FF;
+		const uint32_t code = MortonEncode3(x, y, z);
+		roundTrips = roundTrips && Compact(code) == x && Compact(code >> 1) == y && Compact(code >> 2) == z;
+	}
+	CHECK(roundTrips);
+}
+
+static double AverageStep(const std::vector<float>& positions)
+{
+	double total = 0.0;
+	const size_t count = positions.size() / 3;
+	for (size_t iii = 1; iii < count; ++iii)
+	{
+		const float dx = positions[3 * iii + 0] - positions[3 * iii - 3];
+		const float dy = positions[3 * iii + 1] - positions[3 * iii - 2];
+		const float dz = positions[3 * iii + 2] - positions[3 * iii - 1];
+		total += std::sqrt(dx * dx + dy * dy + dz * dz);
+	}
+	return total / static_cast<double>(count - 1);
+}
+
+struct Position
+{
+	float x, y, z;
+};
+
+static void TestPermutationRoundTrip()
+{
+	TestRandom random(133);
+	const size_t count = 50000;
+
+	std::vector<Position> positions(count);
+	for (Position& p : positions)
+		p = { random.NextFloat(-30.0f, 30.0f), random.NextFloat(-30.0f, 30.0f), random.NextFloat(-30.0f, 30.0f) };
+	std::vector<uint32_t> ids(count);
+	std::iota(ids.begin(), ids.end(), 0u);
+
+	const std::vector<Position> original = positions;
+	const float* xyz = reinterpret_cast<const float*>(positions.data());
+
+	std::vector<uint32_t> order;
+	double orderMs = TimeMilliseconds([&]() { ComputeMortonOrder(xyz, count, order); });
+
+	// The order is a permutation of [0, count)
+	std::vector<unsigned int> seen(count, 0u);
+	for (uint32_t index : order)
+		if (index < count)
+			++seen[index];
+	CHECK(order.size() == count);
+	CHECK(std::all_of(seen.begin(), seen.end(), [](unsigned int s) { return s == 1u; }));
+
+	std::vector<Position> positionScratch;
+	std::vector<uint32_t> idScratch;
+	double applyMs = TimeMilliseconds([&]() { ApplyPermutation(positions, order, positionScratch); });
+	ApplyPermutation(ids, order, idScratch);
+
+	// Every value moved along with its id
+	bool consistent = true;
+	for (size_t iii = 0; iii < count; ++iii)
+		consistent = consistent && ids[iii] == order[iii] && positions[iii].x == original[ids[iii]].x && positions[iii].y == original[ids[iii]].y && positions[iii].z == original[ids[iii]].z;
+	CHECK(consistent);
+
+	// Sorting points that are already sorted is the identity
+	std::vector<uint32_t> secondOrder;
+	ComputeMortonOrder(xyz, count, secondOrder);
+	std::vector<uint32_t> identity(count);
+	std::iota(identity.begin(), identity.end(), 0u);
+	CHECK(secondOrder == identity);
+
+	// Applying the inverse permutation restores the original order exactly
+	std::vector<uint32_t> inverse(count);
+	for (size_t iii = 0; iii < count; ++iii)
+		inverse[ids[iii]] = static_cast<uint32_t>(iii);
+	ApplyPermutation(positions, inverse, positionScratch);
+	bool restored = true;
+	for (size_t iii = 0; iii < count; ++iii)
+		restored = restored && positions[iii].x == original[iii].x && positions[iii].y == original[iii].y && positions[iii].z == original[iii].z;
+	CHECK(restored);
+
+	// Neighbors in memory are neighbors in space after sorting
+	std::vector<float> unsortedXYZ(reinterpret_cast<const float*>(original.data()), reinterpret_cast<const float*>(original.data()) + 3 * count);
+	ApplyPermutation(positions, order, positionScratch);
+	std::vector<float> sortedXYZ(xyz, xyz + 3 * count);
+	const double unsortedStep = AverageStep(unsortedXYZ);
+	const double sortedStep = AverageStep(sortedXYZ);
+	CHECK(sortedStep < 0.25 * unsortedStep);
+
+	std::printf("MortonOrder (%zu atoms): order %.3f ms, apply %.3f ms, average step %.2f -> %.2f\n", count, orderMs, applyMs, unsortedStep, sortedStep);
+}
+
+// The reason for sorting: the neighbor kernels read the positions of each atom's neighbors, which are scattered over
+// the whole array unless the atoms are sorted. Same system and force field, unsorted and after sorting
+static void TestForceThroughput()
+{
+	// Jittered lattice (so no two atoms are close enough for the Lennard-Jones term to blow up), stored in random order
+	TestRandom random(233);
+	const unsigned int side = 48;
+	const float spacing = 1.1f;
+	std::vector<Position> positions;
+	for (unsigned int x = 0; x < side; ++x)
+		for (unsigned int y = 0; y < side; ++y)
+			for (unsigned int z = 0; z < side; ++z)
+				positions.push_back({ x * spacing + random.NextFloat(-0.15f, 0.15f), y * spacing + random.NextFloat(-0.15f, 0.15f), z * spacing + random.NextFloat(-0.15f, 0.15f) });
+	for (size_t iii = positions.size() - 1; iii > 0; --iii)
+		std::swap(positions[iii], positions[random.NextUInt() % (iii + 1)]);
+
+	const size_t count = positions.size();
+	std::vector<int> elementTypes(count);
+	for (size_t iii = 0; iii < count; ++iii)
+		elementTypes[iii] = static_cast<int>(iii % 2);
+
+	LennardJonesCoulomb forceField(2.5f);
+	forceField.SetElementParameters(0, { 1.0f, 1.0f, 0.5f });
+	forceField.SetElementParameters(1, { 1.2f, 0.5f, -0.5f });
+	forceField.SetCoulombConstant(2.0f);
+
+	std::vector<float> forces(3 * count);
+	auto run = [&](size_t& pairCount, double& energy)
+	{
+		const float* xyz = reinterpret_cast<const float*>(positions.data());
+		NeighborList neighbors(forceField.Cutoff(), 0.3f);
+		neighbors.Build(xyz, count);
+		pairCount = neighbors.PairCount();
+
+		ForceFieldInput input;
+		input.PositionsXYZ = xyz;
+		input.ElementTypes = elementTypes.data();
+		input.Count = count;
+		input.Neighbors = &neighbors;
+
+		forceField.ComputeForces(input, forces.data()); // Warm up
+		return TimeMilliseconds([&]() { energy = forceField.ComputeForces(input, forces.data()); }, 5);
+	};
+
+	size_t unsortedPairs = 0, sortedPairs = 0;
+	double unsortedEnergy = 0.0, sortedEnergy = 0.0;
+	const double unsortedMs = run(unsortedPairs, unsortedEnergy);
+
+	std::vector<uint32_t> order;
+	std::vector<Position> positionScratch;
+	std::vector<int> elementScratch;
+	ComputeMortonOrder(reinterpret_cast<const float*>(positions.data()), count, order);
+	ApplyPermutation(positions, order, positionScratch);
+	ApplyPermutation(elementTypes, order, elementScratch);
+	const double sortedMs = run(sortedPairs, sortedEnergy);
+
+	// Sorting only changes the order the work is done in
+	CHECK(sortedPairs == unsortedPairs);
+	CHECK_NEAR(sortedEnergy, unsortedEnergy, 1e-6 * std::abs(unsortedEnergy));
+
+	std::printf("LennardJonesCoulomb (%zu atoms, %zu pairs): unsorted %.1f Mpairs/s, Morton sorted %.1f Mpairs/s\n",
+		count, sortedPairs, 1e-3 * unsortedPairs / unsortedMs, 1e-3 * sortedPairs / sortedMs);
+}
+
+static void TestDegenerate()
+{
+	std::vector<uint32_t> order;
+	ComputeMortonOrder(nullptr, 0, order);
+	CHECK(order.empty());
+
+	// All points on a plane (zero extent on one axis) and duplicates keep their relative order
+	std::vector<float> flat = { 1.0f, 0.0f, 5.0f,	0.0f, 0.0f, 5.0f,	1.0f, 0.0f, 5.0f,	0.0f, 0.0f, 5.0f };
+	ComputeMortonOrder(flat.data(), 4, order);
+	CHECK((order == std::vector<uint32_t>{ 1u, 3u, 0u, 2u }));
+}
+
+int main()
+{
+	TestEncode();
+	TestPermutationRoundTrip();
+	TestForceThroughput();
+	TestDegenerate();
+	return TestResult("MortonOrderTests");
+}
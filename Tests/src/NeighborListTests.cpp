@@ -0,0 +1,145 @@
+#include "Check.h"
+#include "NeighborList.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using PairList = std::vector<std::pair<uint32_t, uint32_t>>;
+
+// Every pair closer than 'radius' (with the minimum image when the box is enabled), as (lower, higher) index pairs
+static PairList BruteForcePairs(const std::vector<float>& positions, float radius, const PeriodicBox& box)
+{
+	PairList pairs;
+	const size_t count = positions.size() / 3;
+	for (size_t i = 0; i < count; ++i)
+	{
+		for (size_t j = i + 1; j < count; ++j)
+		{
+			float dx = positions[3 * i + 0] - positions[3 * j + 0];
+			float dy = positions[3 * i + 1] - positions[3 * j + 1];
+			float dz = positions[3 * i + 2] - positions[3 * j + 2];
+			box.MinimumImage(dx, dy, dz);
+			if (dx * dx + dy * dy + dz * dz < radius * radius)
+				pairs.emplace_back(static_cast<uint32_t>(i), static_cast<uint32_t>(j));
+		}
+	}
+	return pairs;
+}
+
+static PairList ListPairs(const NeighborList& list)
+{
+	PairList pairs;
+	for (size_t i = 0; i < list.AtomCount(); ++i)
+		for (uint32_t j : list.NeighborsOf(i))
+			pairs.emplace_back(std::min(static_cast<uint32_t>(i), j), std::max(static_cast<uint32_t>(i), j));
+	std::sort(pairs.begin(), pairs.end());
+	return pairs;
+}
+
+// The list must hold every pair inside the list radius exactly once. Pairs that are right on the boundary may or may
+// not be included depending on rounding, so only pairs that are clearly inside/outside are compared
+static void CheckMatchesBruteForce(const NeighborList& list, const std::vector<float>& positions, const PeriodicBox& box)
+{
+	const PairList listPairs = ListPairs(list);
+	CHECK(std::adjacent_find(listPairs.begin(), listPairs.end()) == listPairs.end()); // No duplicates
+
+	const PairList inner = BruteForcePairs(positions, list.ListRadius() * 0.999f, box);
+	const PairList outer = BruteForcePairs(positions, list.ListRadius() * 1.001f, box);
+
+	CHECK(std::includes(listPairs.begin(), listPairs.end(), inner.begin(), inner.end()));
+	CHECK(std::includes(outer.begin(), outer.end(), listPairs.begin(), listPairs.end()));
+	CHECK(list.PairCount() == listPairs.size());
+}
+
+static std::vector<float> RandomPositions(TestRandom& random, size_t count, float min, float max)
+{
+	std::vector<float> positions(3 * count);
+	for (float& value : positions)
+		value = random.NextFloat(min, max);
+	return positions;
+}
+
+static void TestOpenBoundaries()
+{
+	TestRandom random(31);
+	std::vector<float> positions = RandomPositions(random, 3000, -10.0f, 10.0f);
+
+	NeighborList list(1.5f, 0.3f);
+	double buildMs = TimeMilliseconds([&]() { list.Build(positions.data(), positions.size() / 3); });
+	CheckMatchesBruteForce(list, positions, PeriodicBox());
+
+	std::vector<float> copy = positions;
+	double bruteMs = TimeMilliseconds([&]() { copy = positions; (void)BruteForcePairs(copy, list.ListRadius(), PeriodicBox()); });
+	std::printf("NeighborList (%zu atoms, %zu pairs): build %.3f ms, brute force %.3f ms\n", positions.size() / 3, list.PairCount(), buildMs, bruteMs);
+}
+
+static void TestPeriodicBoundaries()
+{
+	TestRandom random(131);
+	const float min[3] = { 0.0f, 0.0f, 0.0f };
+	const float length[3] = { 12.0f, 9.0f, 15.0f };
+	PeriodicBox box(min, length);
+
+	std::vector<float> positions(3 * 2000);
+	for (size_t iii = 0; iii < positions.size(); ++iii)
+		positions[iii] = random.NextFloat(0.0f, length[iii % 3]);
+
+	NeighborList list(1.8f, 0.4f);
+	list.SetPeriodicBox(box);
+	list.Build(positions.data(), positions.size() / 3);
+	CheckMatchesBruteForce(list, positions, box);
+
+	// Pairs across each face of the box must be found
+	std::vector<float> acrossFaces = {
+		0.1f, 4.0f, 7.0f,	11.9f, 4.0f, 7.0f,	// x
+		6.0f, 0.1f, 7.0f,	6.0f, 8.9f, 7.0f,	// y
+		6.0f, 4.0f, 0.1f,	6.0f, 4.0f, 14.9f	// z
+	};
+	list.Build(acrossFaces.data(), 6);
+	CHECK(list.PairCount() == 3);
+	CheckMatchesBruteForce(list, acrossFaces, box);
+}
+
+static void TestSkin()
+{
+	TestRandom random(231);
+	std::vector<float> positions = RandomPositions(random, 500, -5.0f, 5.0f);
+	const size_t count = positions.size() / 3;
+
+	NeighborList list(1.0f, 0.4f);
+	CHECK(list.Update(positions.data(), count));	// First update always builds
+	CHECK(!list.Update(positions.data(), count));	// Nothing moved
+
+	// Moving every atom by less than skin / 2 keeps the list valid. It must then still hold every pair within the cutoff
+	for (float& value : positions)
+		value += random.NextFloat(-0.1f, 0.1f);
+	CHECK(!list.Update(positions.data(), count));
+
+	const PairList listPairs = ListPairs(list);
+	const PairList withinCutoff = BruteForcePairs(positions, list.Cutoff(), PeriodicBox());
+	CHECK(std::includes(listPairs.begin(), listPairs.end(), withinCutoff.begin(), withinCutoff.end()));
+
+	// Moving one atom by more than skin / 2 forces a rebuild
+	positions[0] += 0.25f;
+	CHECK(list.Update(positions.data(), count));
+	CheckMatchesBruteForce(list, positions, PeriodicBox());
+
+	// As does changing the atom count, the cutoff or invalidating
+	CHECK(list.Update(positions.data(), count - 1));
+	list.Invalidate();
+	CHECK(list.Update(positions.data(), count - 1));
+	list.SetCutoff(1.2f);
+	CHECK(list.Update(positions.data(), count - 1));
+
+	CHECK(list.GetStats().Updates == 7);
+	CHECK(list.GetStats().Builds == 5);
+}
+
+int main()
+{
+	TestOpenBoundaries();
+	TestPeriodicBoundaries();
+	TestSkin();
+	return TestResult("NeighborListTests");
+}
@@ -0,0 +1,195 @@
+#include "Check.h"
+#include "Evergreen/Utils/PieceTable.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using Evergreen::PieceTable;
+
+// Line queries computed directly from a std::wstring
+static std::vector<size_t> LineStarts(const std::wstring& text)
+{
+	std::vector<size_t> starts = { 0 };
+	for (size_t iii = 0; iii < text.size(); ++iii)
+		if (text[iii] == L'\n')
+			starts.push_back(iii + 1);
+	return starts;
+}
+
+static bool MatchesReference(const PieceTable& table, const std::wstring& reference)
+{
+	if (table.Size() != reference.size() || table.Empty() != reference.empty())
+		return false;
+	if (table.ToString() != reference)
+		return false;
+
+	const std::vector<size_t> starts = LineStarts(reference);
+	if (table.LineCount() != starts.size())
+		return false;
+
+	for (size_t line = 0; line < starts.size(); ++line)
+	{
+		const size_t end = line + 1 < starts.size() ? starts[line + 1] - 1 : reference.size();
+		if (table.LineStart(line) != starts[line] || table.LineLength(line) != end - starts[line])
+			return false;
+		if (table.Line(line) != reference.substr(starts[line], end - starts[line]))
+			return false;
+	}
+
+	for (size_t position = 0; position < reference.size(); ++position)
+	{
+		if (table.At(position) != reference[position])
+			return false;
+
+		const size_t line = static_cast<size_t>(std::upper_bound(starts.begin(), starts.end(), position) - starts.begin()) - 1;
+		if (table.LineOfPosition(position) != line)
+			return false;
+	}
+	return true;
+}
+
+static std::wstring RandomText(TestRandom& random, size_t length)
+{
+	static const wchar_t alphabet[] = L"abcdefghij \n\né中";
+	std::wstring text(length, L' ');
+	for (wchar_t& c : text)
+		c = alphabet[random.NextUInt() % (sizeof(alphabet) / sizeof(wchar_t) - 1)];
+	return text;
+}
+
+// Random inserts/erases (including typing runs that extend the last piece) mirrored on a std::wstring
+static void TestRandomEdits()
+{
+	TestRandom random(43);
+	std::wstring reference = RandomText(random, 200);
+	PieceTable table(reference);
+	CHECK(MatchesReference(table, reference));
+
+	unsigned int mismatches = 0;
+	size_t cursor = 0;
+	for (unsigned int edit = 0; edit < 3000; ++edit)
+	{
+		const unsigned int kind = random.NextUInt() % 10;
+		if (kind < 4)
+		{
+			// Typing at the cursor
+			const std::wstring text = RandomText(random, 1);
+			cursor = std::min(cursor, reference.size());
+			table.Insert(cursor, text);
+			reference.insert(cursor, text);
+			++cursor;
+		}
+		else if (kind < 7)
+		{
+			const size_t position = random.NextUInt() % (reference.size() + 1);
+			const std::wstring text = RandomText(random, 1 + random.NextUInt() % 20);
+			table.Insert(position, text);
+			reference.insert(position, text);
+			cursor = position + text.size();
+		}
+		else if (!reference.empty())
+		{
+			const size_t position = random.NextUInt() % reference.size();
+			const size_t count = 1 + random.NextUInt() % 15; // May run past the end, which erases to the end
+			table.Erase(position, count);
+			reference.erase(position, std::min(count, reference.size() - position));
+			cursor = position;
+		}
+
+		if (edit % 50 == 0 && !MatchesReference(table, reference))
+			++mismatches;
+	}
+	CHECK(mismatches == 0u);
+	CHECK(MatchesReference(table, reference));
+
+	// Substrings that span pieces
+	bool substringsMatch = true;
+	for (unsigned int iii = 0; iii < 500 && !reference.empty(); ++iii)
+	{
+		const size_t position = random.NextUInt() % reference.size();
+		const size_t count = random.NextUInt() % 64;
+		substringsMatch = substringsMatch && table.Substring(position, count) == reference.substr(position, count);
+	}
+	CHECK(substringsMatch);
+
+	// Erasing everything and reassigning
+	table.Erase(0, table.Size());
+	CHECK(MatchesReference(table, std::wstring()));
+	CHECK(table.LineCount() == 1);
+
+	table.Assign(L"one\ntwo\n");
+	CHECK(MatchesReference(table, L"one\ntwo\n"));
+	CHECK(table.LineCount() == 3);
+	CHECK(table.PieceCount() == 1);
+
+	table.Clear();
+	CHECK(table.Empty());
+}
+
+// Typing extends the last piece instead of adding one per character
+static void TestTypingCoalesces()
+{
+	PieceTable table(L"hello world");
+	table.Insert(5, L",");
+	const size_t pieces = table.PieceCount();
+	table.Insert(6, L" dear");
+	table.Insert(11, L"!");
+	CHECK(table.PieceCount() == pieces);
+	CHECK(table.ToString() == L"hello, dear! world");
+}
+
+// Typing in the middle of a large document: the piece table never moves the existing text, std::wstring moves
+// everything after the cursor on every keystroke
+static void BenchmarkTyping()
+{
+	TestRandom random(143);
+	const std::wstring document = RandomText(random, 1024 * 1024);
+	const size_t keystrokes = 5000;
+
+	PieceTable table(document);
+	std::wstring reference = document;
+
+	size_t cursor = document.size() / 3;
+	double tableMs = TimeMilliseconds([&]()
+		{
+			for (size_t iii = 0; iii < keystrokes; ++iii)
+				table.Insert(cursor + iii, L"x");
+		}
+	);
+	double stringMs = TimeMilliseconds([&]()
+		{
+			for (size_t iii = 0; iii < keystrokes; ++iii)
+				reference.insert(cursor + iii, L"x");
+		}
+	);
+
+	CHECK(table.ToString() == reference);
+
+	// Jumping around the document between edits (each edit splits a piece)
+	double scatteredMs = TimeMilliseconds([&]()
+		{
+			for (size_t iii = 0; iii < 2000; ++iii)
+			{
+				table.Insert(random.NextUInt() % table.Size(), L"y");
+				table.Erase(random.NextUInt() % table.Size(), 1);
+			}
+		}
+	);
+
+	const size_t line = table.LineCount() / 2;
+	size_t lineStart = 0;
+	double lineLookupUs = 1000.0 * TimeMilliseconds([&]() { lineStart = table.LineStart(line); }, 1000);
+	CHECK(lineStart <= table.Size());
+
+	std::printf("PieceTable (%zu chars, %zu pieces): %zu keystrokes %.3f ms (std::wstring %.3f ms), 2000 scattered edits %.3f ms, LineStart %.3f us\n",
+		table.Size(), table.PieceCount(), keystrokes, tableMs, stringMs, scatteredMs, lineLookupUs);
+}
+
+int main()
+{
+	TestRandomEdits();
+	TestTypingCoalesces();
+	BenchmarkTyping();
+	return TestResult("PieceTableTests");
+}
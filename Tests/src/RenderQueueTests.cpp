@@ -0,0 +1,135 @@
+#include "Check.h"
+#include "RenderQueue.h"
+#include "RenderStateCache.h"
+
+#include <vector>
+
+static void TestKeyLayout()
+{
+	constexpr std::uint64_t key = RenderQueue::MakeKey(0xABCDu, 0x1234u, 0xDEADBEEFu);
+	static_assert(RenderQueue::PipelineId(key) == 0xABCDu);
+	static_assert(RenderQueue::MeshSetId(key) == 0x1234u);
+	static_assert(RenderQueue::MaterialId(key) == 0xDEADBEEFu);
+
+	// Pipeline dominates mesh set, which dominates material
+	CHECK(RenderQueue::MakeKey(1u, 0u, 0u) > RenderQueue::MakeKey(0u, 0xFFFFu, 0xFFFFFFFFu));
+	CHECK(RenderQueue::MakeKey(0u, 1u, 0u) > RenderQueue::MakeKey(0u, 0u, 0xFFFFFFFFu));
+}
+
+static void TestStableSort()
+{
+	RenderQueue queue;
+	queue.Submit(RenderQueue::MakeKey(2u, 0u, 0u), 0u);
+	queue.Submit(RenderQueue::MakeKey(1u, 5u, 0u), 1u);
+	queue.Submit(RenderQueue::MakeKey(2u, 0u, 0u), 2u);
+	queue.Submit(RenderQueue::MakeKey(1u, 3u, 7u), 3u);
+	queue.Submit(RenderQueue::MakeKey(2u, 0u, 0u), 4u);
+	queue.Sort();
+
+	const std::vector<std::uint32_t> expected = { 3u, 1u, 0u, 2u, 4u };
+	CHECK(queue.Size() == expected.size());
+	for (size_t iii = 0; iii < expected.size() && iii < queue.Size(); ++iii)
+		CHECK(queue.Items()[iii].Payload == expected[iii]);
+
+	queue.Clear();
+	CHECK(queue.Size() == 0);
+}
+
+static void TestCache()
+{
+	RenderStateCache cache;
+	int shaderA = 0, shaderB = 0, buffer = 0;
+
+	CHECK(cache.Changed(RenderStateSlot::VERTEX_SHADER, &shaderA));
+	CHECK(!cache.Changed(RenderStateSlot::VERTEX_SHADER, &shaderA));
+	CHECK(cache.Changed(RenderStateSlot::VERTEX_SHADER, &shaderB));
+	CHECK(cache.Changed(RenderStateSlot::PIXEL_SHADER, &shaderB)); // Slots are independent
+
+	// nullptr is a valid value to bind and must not look like "already bound" after an invalidate
+	cache.Invalidate();
+	CHECK(cache.Changed(RenderStateSlot::VERTEX_SHADER, nullptr));
+	CHECK(!cache.Changed(RenderStateSlot::VERTEX_SHADER, nullptr));
+
+	// Invalidating one slot leaves the others alone
+	CHECK(cache.Changed(RenderStateSlot::PIXEL_SHADER, &shaderA));
+	cache.Invalidate(RenderStateSlot::VERTEX_SHADER);
+	CHECK(cache.Changed(RenderStateSlot::VERTEX_SHADER, nullptr));
+	CHECK(!cache.Changed(RenderStateSlot::PIXEL_SHADER, &shaderA));
+
+	// Buffer + offset slots only match when both match
+	CHECK(cache.Changed(RenderStateSlot::IA_INSTANCE_BUFFER, &buffer, 0u));
+	CHECK(!cache.Changed(RenderStateSlot::IA_INSTANCE_BUFFER, &buffer, 0u));
+	CHECK(cache.Changed(RenderStateSlot::IA_INSTANCE_BUFFER, &buffer, 256u));
+	CHECK(cache.Changed(RenderStateSlot::IA_INSTANCE_BUFFER, &shaderA, 256u));
+
+	// Constant buffer views also match on their size, so a view that grew at the same offset is bound again
+	CHECK(cache.Changed(RenderStateSlot::VS_INSTANCE_CONSTANT_BUFFER, &buffer, 512u, 16u));
+	CHECK(!cache.Changed(RenderStateSlot::VS_INSTANCE_CONSTANT_BUFFER, &buffer, 512u, 16u));
+	CHECK(cache.Changed(RenderStateSlot::VS_INSTANCE_CONSTANT_BUFFER, &buffer, 512u, 64u));
+
+	// Stats
+	cache.ResetStats();
+	CHECK(cache.Changed(RenderStateSlot::BLEND_STATE, &shaderA));
+	CHECK(!cache.Changed(RenderStateSlot::BLEND_STATE, &shaderA));
+	CHECK(cache.GetStats().BindsIssued == 1);
+	CHECK(cache.GetStats().BindsSkipped == 1);
+}
+
+// Submits draws for 'pipelineCount' pipelines x 'meshSetCount' mesh sets in an interleaved order and counts the binds
+// the cache lets through with and without sorting
+static unsigned int CountBinds(bool sort)
+{
+	const unsigned int pipelineCount = 4;
+	const unsigned int meshSetCount = 8;
+	const unsigned int repeats = 16;
+
+	RenderQueue queue;
+	for (unsigned int repeat = 0; repeat < repeats; ++repeat)
+		for (unsigned int meshSet = 0; meshSet < meshSetCount; ++meshSet)
+			for (unsigned int pipeline = 0; pipeline < pipelineCount; ++pipeline)
+				queue.Submit(RenderQueue::MakeKey(static_cast<std::uint16_t>(pipeline), static_cast<std::uint16_t>(meshSet), 0u), 0u);
+
+	if (sort)
+		queue.Sort();
+
+	RenderStateCache cache;
+	for (const RenderQueue::DrawItem& item : queue.Items())
+	{
+		cache.Changed(RenderStateSlot::VERTEX_SHADER, static_cast<std::uintptr_t>(RenderQueue::PipelineId(item.Key)));
+		cache.Changed(RenderStateSlot::PIXEL_SHADER, static_cast<std::uintptr_t>(RenderQueue::PipelineId(item.Key)));
+		cache.Changed(RenderStateSlot::IA_VERTEX_BUFFER, static_cast<std::uintptr_t>(RenderQueue::MeshSetId(item.Key)));
+	}
+	return cache.GetStats().BindsIssued;
+}
+
+static void TestSortingReducesBinds()
+{
+	const unsigned int unsorted = CountBinds(false);
+	const unsigned int sorted = CountBinds(true);
+
+	// Sorted: each pipeline binds 2 shaders once, and each of its 8 mesh sets once => 4 * (2 + 8)
+	CHECK(sorted == 4u * (2u + 8u));
+	CHECK(sorted < unsorted);
+	std::printf("RenderQueue: %u binds unsorted, %u binds sorted\n", unsorted, sorted);
+
+	TestRandom random(28);
+	RenderQueue queue;
+	for (unsigned int iii = 0; iii < 100000; ++iii)
+		queue.Submit(RenderQueue::MakeKey(static_cast<std::uint16_t>(random.NextUInt() % 16), static_cast<std::uint16_t>(random.NextUInt() % 64), random.NextUInt() % 10), iii);
+
+	double sortMs = TimeMilliseconds([&]() { queue.Sort(); });
+	bool ordered = true;
+	for (size_t iii = 1; iii < queue.Size(); ++iii)
+		ordered = ordered && queue.Items()[iii - 1].Key <= queue.Items()[iii].Key;
+	CHECK(ordered);
+	std::printf("RenderQueue: sorted %zu draws in %.3f ms\n", queue.Size(), sortMs);
+}
+
+int main()
+{
+	TestKeyLayout();
+	TestStableSort();
+	TestCache();
+	TestSortingReducesBinds();
+	return TestResult("RenderQueueTests");
+}
@@ -0,0 +1,256 @@
+#include "Check.h"
+#include "Evergreen/Rendering/Software/SoftwareRasterizer.h"
+#include "Evergreen/Utils/JobSystem.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+using namespace Evergreen;
+
+// This file is built twice: SoftwareRasterizerTests (SSE2 span blending where available) and
+// SoftwareRasterizerScalarTests (EG_RASTER_NO_SIMD). ctest runs the scalar build first with '--write <file>', which
+// saves its rendering of the reference scene, and then the default build with '--compare <file>', which requires
+// its own rendering to be identical. Both builds also check the scene against a golden hash.
+
+// Hash of the reference scene (FNV style over every pixel of the serial rendering). Update it only when a change to
+// the rasterizer is meant to change its output, after looking at the new image
+static constexpr uint64_t ReferenceSceneHash = 0x4db941dd17286354ULL;
+
+static int Red(uint32_t pixel) noexcept { return pixel & 0xFF; }
+static int Alpha(uint32_t pixel) noexcept { return pixel >> 24; }
+
+static uint64_t HashPixels(const RasterImage& image) noexcept
+{
+	uint64_t hash = 0;
+	for (uint32_t pixel : image.Pixels())
+		hash = hash * 1099511628211ULL + pixel;
+	return hash;
+}
+
+// Exact coverage of pixel aligned and half pixel rectangles, hairlines, and clipping
+static void TestPrimitives()
+{
+	RasterImage image(100, 100, 0);
+	RasterCommandList list;
+	RasterPaintId red = list.AddSolidPaint({ 1, 0, 0, 1 });
+	list.FillRectangle({ 10, 10, 20, 20 }, red);
+	list.FillRectangle({ 30.5f, 10, 40, 20 }, red);
+	list.DrawLine(50, 10.5f, 60, 10.5f, red, 1.0f);
+	list.DrawLine(50, 30, 60, 30, red, 1.0f);
+	list.PushClip({ 70.4f, 0, 80, 100 }, false);
+	list.FillRectangle({ 60, 50, 90, 60 }, red);
+	list.PopClip();
+	list.PushClip({ 0, 0, 5, 5 });
+	list.FillRectangle({ 50, 50, 60, 60 }, red); // Clipped away entirely
+	list.PopClip();
+	CHECK(list.Size() == 5);
+
+	SoftwareRasterizer rasterizer;
+	rasterizer.Rasterize(list, image);
+	CHECK(rasterizer.GetStats().commands == 5);
+
+	CHECK(image.Pixel(10, 10) == 0xFF0000FFu);
+	CHECK(image.Pixel(19, 19) == 0xFF0000FFu);
+	CHECK(image.Pixel(20, 19) == 0 && image.Pixel(9, 10) == 0);
+
+	// Left edge at x = 30.5 covers half of column 30
+	CHECK(Alpha(image.Pixel(30, 15)) == 128 && Red(image.Pixel(30, 15)) == 128);
+
+	// A 1 pixel line on a pixel center fills exactly one row, a line on a pixel edge half fills two
+	CHECK(image.Pixel(55, 10) == 0xFF0000FFu && image.Pixel(55, 11) == 0 && image.Pixel(55, 9) == 0);
+	CHECK(Alpha(image.Pixel(55, 29)) == 128 && Alpha(image.Pixel(55, 30)) == 128);
+
+	// Aliased clips snap to whole pixels
+	CHECK(image.Pixel(69, 55) == 0 && image.Pixel(70, 55) == 0xFF0000FFu);
+	CHECK(image.Pixel(79, 55) == 0xFF0000FFu && image.Pixel(80, 55) == 0);
+
+	CHECK(image.Pixel(50, 50) == 0 && image.Pixel(59, 59) == 0);
+}
+
+static void TestBlendingAndGradients()
+{
+	RasterImage image(64, 64, RasterImage::Pack({ 1, 1, 1, 1 }));
+	RasterCommandList list;
+	list.FillRectangle({ 0, 0, 10, 10 }, list.AddSolidPaint({ 0, 0, 0, 1 }, 0.5f));
+
+	RasterPaint gradient;
+	gradient.type = RasterPaintType::LINEAR_GRADIENT;
+	gradient.point0[0] = 0;
+	gradient.point1[0] = 64;
+	gradient.stops = { { 0.0f, { 0, 0, 0, 1 } }, { 1.0f, { 1, 0, 0, 1 } } };
+	list.FillRectangle({ 0, 20, 64, 30 }, list.AddPaint(gradient));
+
+	list.FillEllipse(40, 50, 8, 8, list.AddSolidPaint({ 0, 0, 1, 1 }));
+
+	SoftwareRasterizer rasterizer;
+	rasterizer.Rasterize(list, image);
+
+	CHECK(image.Pixel(5, 5) == 0xFF808080u || image.Pixel(5, 5) == 0xFF7F7F7Fu);
+	CHECK(Red(image.Pixel(0, 25)) < 5 && Red(image.Pixel(63, 25)) > 250);
+	CHECK(std::abs(Red(image.Pixel(32, 25)) - 128) < 4);
+	CHECK(image.Pixel(40, 50) == 0xFFFF0000u);
+	CHECK(image.Pixel(40, 40) == 0xFFFFFFFFu);
+
+	// Antialiased edge of the ellipse
+	int edge = Red(image.Pixel(47, 50));
+	CHECK(edge > 0 && edge < 255);
+}
+
+static void TestGlyphs(GlyphAtlas& atlas)
+{
+	std::vector<uint8_t> bits(8 * 10, 255);
+	CHECK(atlas.Add(1, 8, 10, 0, -10, bits.data(), 8) != nullptr);
+	CHECK(atlas.Add(2, 6, 10, 1, -10, bits.data(), 8) != nullptr);
+	CHECK(atlas.Add(3, 0, 0, 0, 0, nullptr, 0) != nullptr); // Whitespace glyphs have no bitmap
+	std::vector<uint8_t> tooWide(100 * 10);
+	CHECK(atlas.Add(4, 100, 10, 0, 0, tooWide.data(), 100) == nullptr);
+	CHECK(atlas.GlyphCount() == 3);
+
+	RasterImage image(64, 64, 0);
+	RasterCommandList list;
+	RasterGlyph glyphs[2] = { { 10, 20, 1 }, { 20.4f, 20, 2 } };
+	list.DrawGlyphs(atlas, glyphs, list.AddSolidPaint({ 0, 1, 0, 1 }));
+
+	SoftwareRasterizer rasterizer;
+	rasterizer.Rasterize(list, image);
+
+	CHECK(image.Pixel(10, 10) == 0xFF00FF00u && image.Pixel(17, 19) == 0xFF00FF00u && image.Pixel(18, 15) == 0);
+	// Glyph origins are rounded to whole pixels, then offset by the glyph's left bearing
+	CHECK(image.Pixel(20, 15) == 0 && image.Pixel(21, 15) == 0xFF00FF00u);
+	CHECK(image.Pixel(26, 15) == 0xFF00FF00u && image.Pixel(27, 15) == 0);
+	CHECK(image.Pixel(10, 20) == 0);
+}
+
+// Every command type and paint, overlapping across many tiles, with antialiased and aliased clips
+static void BuildReferenceScene(RasterCommandList& list, const GlyphAtlas& atlas, const RasterImage& image, int repeats)
+{
+	list.Clear();
+	RasterPaintId red = list.AddSolidPaint({ 1, 0, 0, 1 });
+	RasterPaintId blue = list.AddSolidPaint({ 0, 0, 1, 0.5f });
+
+	RasterPaint linear;
+	linear.type = RasterPaintType::LINEAR_GRADIENT;
+	linear.point0[0] = 0;
+	linear.point0[1] = 0;
+	linear.point1[0] = 200;
+	linear.point1[1] = 0;
+	linear.stops = { { 1.0f, { 0, 1, 0, 1 } }, { 0.0f, { 0, 0, 0, 1 } } };
+	RasterPaintId green = list.AddPaint(linear);
+
+	RasterPaint radial;
+	radial.type = RasterPaintType::RADIAL_GRADIENT;
+	radial.point0[0] = 300;
+	radial.point0[1] = 300;
+	radial.point1[0] = 50;
+	radial.point1[1] = 30;
+	radial.stops = { { 0.0f, { 1, 1, 1, 1 } }, { 1.0f, { 1, 1, 1, 0 } } };
+	RasterPaintId white = list.AddPaint(radial);
+
+	for (int iii = 0; iii < repeats; ++iii)
+	{
+		float o = static_cast<float>(iii % 50) * 7.3f;
+		list.FillRectangle({ o, o, o + 40.5f, o + 20.25f }, iii % 2 ? red : blue);
+		list.DrawRectangle({ o + 3, o + 100, o + 90, o + 150 }, green, 2.0f);
+		list.FillRoundedRectangle({ o + 200, o, o + 260, o + 30 }, 6, 4, white);
+		list.DrawRoundedRectangle({ o + 200, o + 50, o + 260, o + 80 }, 5, 5, red, 1.0f);
+		list.PushClip({ o + 10.5f, o + 10.5f, o + 300, o + 200 }, iii % 3 == 0);
+		list.FillEllipse(o + 100, o + 100, 40, 25, blue);
+		list.DrawEllipse(o + 150, o + 120, 30, 30, red, 3.0f);
+		list.DrawLine(o, o + 300, o + 400, o + 250, green, 1.5f);
+		list.PopClip();
+		list.DrawImage(image, { o + 400, o + 10, o + 464, o + 74 }, { 0, 0, 16, 16 }, 0.8f);
+		RasterGlyph glyphs[3] = { { o + 500, o + 40, 1 }, { o + 510, o + 40, 2 }, { o + 520, o + 40, 99 } };
+		list.DrawGlyphs(atlas, glyphs, red);
+	}
+}
+
+static bool WriteImage(const char* path, const RasterImage& image)
+{
+	std::ofstream file(path, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(image.Pixels().data()), static_cast<std::streamsize>(image.Pixels().size() * sizeof(uint32_t)));
+	return static_cast<bool>(file);
+}
+
+static bool ReadImage(const char* path, RasterImage& image)
+{
+	std::ifstream file(path, std::ios::binary);
+	std::vector<uint32_t> pixels(image.Pixels().size());
+	file.read(reinterpret_cast<char*>(pixels.data()), static_cast<std::streamsize>(pixels.size() * sizeof(uint32_t)));
+	if (!file)
+		return false;
+	for (uint32_t y = 0; y < image.Height(); ++y)
+		std::memcpy(image.Row(y), pixels.data() + static_cast<size_t>(y) * image.Width(), image.Width() * sizeof(uint32_t));
+	return true;
+}
+
+// The reference scene rendered on the calling thread and on 4 threads (3 workers plus the caller) must be identical,
+// and must match the golden hash
+static void TestReferenceScene(const GlyphAtlas& atlas, const char* writePath, const char* comparePath)
+{
+	RasterImage source(16, 16);
+	for (uint32_t y = 0; y < 16; ++y)
+		for (uint32_t x = 0; x < 16; ++x)
+			source.Row(y)[x] = RasterImage::Pack({ x / 15.0f, y / 15.0f, 0.5f, 1 });
+
+	RasterCommandList list;
+	BuildReferenceScene(list, atlas, source, 400);
+
+	const uint32_t background = RasterImage::Pack({ 0.2f, 0.2f, 0.2f, 1 });
+	RasterImage serial(1280, 720, background);
+	RasterImage parallel(1280, 720, background);
+
+	SoftwareRasterizer serialRasterizer;
+	serialRasterizer.Rasterize(list, serial);
+
+	JobSystem jobs(3);
+	SoftwareRasterizer parallelRasterizer(&jobs);
+	parallelRasterizer.Rasterize(list, parallel);
+
+	CHECK(RasterImage::CountDifferences(serial, parallel) == 0);
+	CHECK(HashPixels(serial) == ReferenceSceneHash);
+
+	if (writePath != nullptr)
+		CHECK(WriteImage(writePath, serial));
+	if (comparePath != nullptr)
+	{
+		RasterImage other(1280, 720, 0);
+		CHECK(ReadImage(comparePath, other));
+		CHECK(RasterImage::CountDifferences(serial, other) == 0);
+	}
+
+	RasterImage wrongSize(10, 10);
+	CHECK(RasterImage::CountDifferences(serial, wrongSize) == 1280u * 720u);
+
+	const SoftwareRasterizerStats& stats = serialRasterizer.GetStats();
+	double serialTime = TimeMilliseconds([&]() { serialRasterizer.Rasterize(list, serial); }, 5);
+	double parallelTime = TimeMilliseconds([&]() { parallelRasterizer.Rasterize(list, parallel); }, 5);
+	std::printf("Reference scene: %zu commands, %zu of %zu tiles drawn, %zu bin entries\n", stats.commands, stats.tilesDrawn, stats.tiles, stats.binEntries);
+	std::printf("Rasterize 1280x720: %.2f ms serial, %.2f ms on %u threads (binning %.2f ms)\n", serialTime, parallelTime, jobs.ThreadCount(), parallelRasterizer.GetStats().binMilliseconds);
+}
+
+int main(int argc, char** argv)
+{
+	const char* writePath = nullptr;
+	const char* comparePath = nullptr;
+	for (int iii = 1; iii + 1 < argc; iii += 2)
+	{
+		if (std::strcmp(argv[iii], "--write") == 0)
+			writePath = argv[iii + 1];
+		else if (std::strcmp(argv[iii], "--compare") == 0)
+			comparePath = argv[iii + 1];
+	}
+
+	TestPrimitives();
+	TestBlendingAndGradients();
+
+	GlyphAtlas atlas(64, 64);
+	TestGlyphs(atlas);
+	TestReferenceScene(atlas, writePath, comparePath);
+
+#ifdef EG_RASTER_NO_SIMD
+	return TestResult("SoftwareRasterizerScalarTests");
+#else
+	return TestResult("SoftwareRasterizerTests");
+#endif
+}
@@ -0,0 +1,310 @@
+#include "Check.h"
+#include "Trajectory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// A random walk of 'atomCount' atoms over 'frameCount' frames. Positions and velocities drift a little every frame
+// (like a real trajectory), so QUANTIZED_DELTA frames are mostly small deltas
+struct ReferenceTrajectory
+{
+	size_t AtomCount = 0;
+	std::vector<int> ElementTypes;
+	std::vector<std::vector<float>> Positions;	// Per frame, xyz
+	std::vector<std::vector<float>> Velocities;	// Per frame, xyz
+	std::vector<ObservableSample> Observables;	// Per frame, only written for every third frame
+
+	[[nodiscard]] static uint64_t Step(size_t frame) noexcept { return 5 + 10 * static_cast<uint64_t>(frame); }
+	// Exactly representable, so an index entry read as a frame header has plausible looking (zero) payload size bits
+	[[nodiscard]] static double Time(size_t frame) noexcept { return 0.5 * static_cast<double>(Step(frame)); }
+	[[nodiscard]] static bool HasObservables(size_t frame) noexcept { return frame % 3 == 0; }
+};
+
+static ReferenceTrajectory MakeReference(TestRandom& random, size_t atomCount, size_t frameCount)
+{
+	ReferenceTrajectory reference;
+	reference.AtomCount = atomCount;
+	reference.ElementTypes.resize(atomCount);
+	for (size_t iii = 0; iii < atomCount; ++iii)
+		reference.ElementTypes[iii] = static_cast<int>(random.NextUInt() % 5);
+
+	std::vector<float> positions(3 * atomCount), velocities(3 * atomCount);
+	for (size_t iii = 0; iii < 3 * atomCount; ++iii)
+	{
+		positions[iii] = random.NextFloat(-12.0f, 12.0f);
+		velocities[iii] = random.NextFloat(-2.0f, 2.0f);
+	}
+
+	for (size_t frame = 0; frame < frameCount; ++frame)
+	{
+		for (size_t iii = 0; iii < 3 * atomCount; ++iii)
+		{
+			velocities[iii] += random.NextFloat(-0.05f, 0.05f);
+			positions[iii] += 0.01f * velocities[iii];
+		}
+		reference.Positions.push_back(positions);
+		reference.Velocities.push_back(velocities);
+
+		ObservableSample sample;
+		sample.Step = ReferenceTrajectory::Step(frame);
+		sample.Time = ReferenceTrajectory::Time(frame);
+		sample.KineticEnergy = 100.0 + frame;
+		sample.PotentialEnergy = -250.0 - 0.5 * frame;
+		sample.Temperature = 1.5 + 0.01 * frame;
+		sample.Pressure = 0.25 * frame;
+		sample.Momentum[0] = 1e-6 * frame;
+		sample.AtomCount = static_cast<uint32_t>(atomCount);
+		sample.ElementCounts[0] = static_cast<uint32_t>(frame);
+		reference.Observables.push_back(sample);
+	}
+	return reference;
+}
+
+static bool WriteReference(const std::string& filename, const ReferenceTrajectory& reference, const TrajectoryWriter::Settings& settings)
+{
+	TrajectoryWriter writer;
+	if (!writer.Open(filename, reference.ElementTypes.data(), reference.AtomCount, settings))
+		return false;
+	for (size_t frame = 0; frame < reference.Positions.size(); ++frame)
+	{
+		const ObservableSample* observables = ReferenceTrajectory::HasObservables(frame) ? &reference.Observables[frame] : nullptr;
+		if (!writer.WriteFrame(ReferenceTrajectory::Step(frame), ReferenceTrajectory::Time(frame),
+			reference.Positions[frame].data(), reference.Velocities[frame].data(), observables))
+			return false;
+	}
+	CHECK(writer.GetStats().FramesWritten == reference.Positions.size());
+	return writer.Close();
+}
+
+// Largest amount a decoded value may differ from the value that was written
+static float Tolerance(TrajectoryEncoding encoding, float value, float precision) noexcept
+{
+	switch (encoding)
+	{
+	case TrajectoryEncoding::FLOAT32:			return 0.0f;
+	case TrajectoryEncoding::FLOAT16:			return std::abs(value) * (1.0f / 2048.0f) + 1e-7f;	// Half of an 11 bit mantissa ulp
+	case TrajectoryEncoding::QUANTIZED_DELTA:	return 0.5f * precision + std::abs(value) * 2.5e-7f;	// Rounding to the grid + float rounding
+	}
+	return 0.0f;
+}
+
+// Compares frame 'frame' read back from 'reader' to the reference and returns the largest position error
+static float CheckFrame(TrajectoryReader& reader, const ReferenceTrajectory& reference, size_t frame, const TrajectoryWriter::Settings& settings)
+{
+	std::vector<float> positions(3 * reference.AtomCount), velocities(3 * reference.AtomCount);
+	CHECK(reader.ReadFrame(frame, positions.data(), velocities.data()));
+
+	float maxError = 0.0f;
+	bool withinTolerance = true;
+	for (size_t iii = 0; iii < 3 * reference.AtomCount; ++iii)
+	{
+		const float position = reference.Positions[frame][iii];
+		const float velocity = reference.Velocities[frame][iii];
+		const float positionError = std::abs(positions[iii] - position);
+		maxError = std::max(maxError, positionError);
+		withinTolerance = withinTolerance &&
+			positionError <= Tolerance(settings.Encoding, position, settings.PositionPrecision) &&
+			std::abs(velocities[iii] - velocity) <= Tolerance(settings.Encoding, velocity, settings.VelocityPrecision);
+	}
+	CHECK(withinTolerance);
+	if (!withinTolerance)
+		std::fprintf(stderr, "  frame %zu is outside the tolerance of its encoding\n", frame);
+	return maxError;
+}
+
+static const char* EncodingName(TrajectoryEncoding encoding) noexcept
+{
+	switch (encoding)
+	{
+	case TrajectoryEncoding::FLOAT32:			return "FLOAT32";
+	case TrajectoryEncoding::FLOAT16:			return "FLOAT16";
+	case TrajectoryEncoding::QUANTIZED_DELTA:	return "QUANTIZED_DELTA";
+	}
+	return "?";
+}
+
+static std::string TestFilename(const char* name)
+{
+	return (std::filesystem::temp_directory_path() / (std::string("TrajectoryTests_") + name + ".traj")).string();
+}
+
+// Write -> read for every encoding: forward playback, backward scrubbing across keyframes and random access must all
+// decode to the written values within the encoding's precision
+static void TestRoundTrip(const ReferenceTrajectory& reference, TrajectoryEncoding encoding)
+{
+	TrajectoryWriter::Settings settings;
+	settings.Encoding = encoding;
+	settings.KeyframeInterval = 8;
+	settings.PositionPrecision = 1.0e-3f;
+	settings.VelocityPrecision = 1.0e-2f;
+	settings.ChunkSize = 16 * 1024; // Small enough that the file is written in several chunks
+
+	const std::string filename = TestFilename(EncodingName(encoding));
+	const size_t frameCount = reference.Positions.size();
+	const double writeMs = TimeMilliseconds([&]() { CHECK(WriteReference(filename, reference, settings)); });
+
+	TrajectoryReader reader;
+	CHECK(reader.Open(filename));
+	if (!reader.IsOpen())
+		return;
+	CHECK(reader.HadIndex());
+	CHECK(reader.Encoding() == encoding);
+	CHECK(reader.AtomCount() == reference.AtomCount);
+	CHECK(reader.FrameCount() == frameCount);
+	CHECK(reader.ElementTypes() == reference.ElementTypes);
+	for (size_t frame = 0; frame < reader.FrameCount(); ++frame)
+	{
+		CHECK(reader.FrameStep(frame) == ReferenceTrajectory::Step(frame));
+		CHECK(reader.FrameTime(frame) == ReferenceTrajectory::Time(frame));
+	}
+
+	float maxError = 0.0f;
+	const double forwardMs = TimeMilliseconds([&]()
+	{
+		for (size_t frame = 0; frame < frameCount; ++frame)
+			maxError = std::max(maxError, CheckFrame(reader, reference, frame, settings));
+	});
+
+	// Backward, which for QUANTIZED_DELTA restarts from the previous keyframe every time
+	for (size_t frame = frameCount; frame-- > 0;)
+		CheckFrame(reader, reference, frame, settings);
+
+	TestRandom random(36);
+	for (unsigned int iii = 0; iii < 64; ++iii)
+		CheckFrame(reader, reference, random.NextUInt() % frameCount, settings);
+
+	// Either output may be null
+	std::vector<float> velocities(3 * reference.AtomCount);
+	CHECK(reader.ReadFrame(frameCount / 2, nullptr, velocities.data()));
+	CHECK(reader.ReadFrame(frameCount / 2 + 1, nullptr, nullptr));
+	CheckFrame(reader, reference, frameCount / 2 + 2, settings);
+	CHECK(!reader.ReadFrame(frameCount, velocities.data(), velocities.data()));
+
+	const uintmax_t fileBytes = std::filesystem::file_size(filename);
+	const double rawBytes = static_cast<double>(frameCount) * 24.0 * reference.AtomCount;
+	std::printf("Trajectory %s (%zu atoms, %zu frames): %.2f bytes/atom/frame, write %.3f ms, read forward %.3f ms, max position error %.2e\n",
+		EncodingName(encoding), reference.AtomCount, frameCount, 24.0 * fileBytes / rawBytes, writeMs, forwardMs, maxError);
+
+	reader.Close();
+	std::filesystem::remove(filename);
+}
+
+static void TestFrameAtStepAndObservables(const ReferenceTrajectory& reference)
+{
+	const std::string filename = TestFilename("Observables");
+	CHECK(WriteReference(filename, reference, TrajectoryWriter::Settings()));
+
+	TrajectoryReader reader;
+	CHECK(reader.Open(filename));
+	if (!reader.IsOpen())
+		return;
+
+	// Last frame at or before the step
+	const size_t frameCount = reader.FrameCount();
+	CHECK(reader.FrameAtStep(0) == 0);
+	CHECK(reader.FrameAtStep(ReferenceTrajectory::Step(0)) == 0);
+	for (size_t frame = 0; frame < frameCount; ++frame)
+	{
+		CHECK(reader.FrameAtStep(ReferenceTrajectory::Step(frame)) == frame);
+		CHECK(reader.FrameAtStep(ReferenceTrajectory::Step(frame) + 9) == frame);
+	}
+	CHECK(reader.FrameAtStep(UINT64_MAX) == frameCount - 1);
+
+	for (size_t frame = 0; frame < frameCount; ++frame)
+	{
+		ObservableSample sample;
+		const bool hasObservables = reader.ReadFrameObservables(frame, sample);
+		CHECK(hasObservables == ReferenceTrajectory::HasObservables(frame));
+		if (!hasObservables)
+			continue;
+
+		const ObservableSample& expected = reference.Observables[frame];
+		CHECK(sample.Step == expected.Step);
+		CHECK(sample.Time == expected.Time);
+		CHECK(sample.TotalEnergy() == expected.TotalEnergy());
+		CHECK(sample.Temperature == expected.Temperature);
+		CHECK(sample.Pressure == expected.Pressure);
+		CHECK(sample.Momentum[0] == expected.Momentum[0]);
+		CHECK(sample.AtomCount == expected.AtomCount);
+		CHECK(sample.ElementCounts[0] == expected.ElementCounts[0]);
+	}
+	ObservableSample sample;
+	CHECK(!reader.ReadFrameObservables(frameCount, sample));
+
+	// The observables follow the atoms in the payload and must not disturb decoding them
+	TrajectoryWriter::Settings settings;
+	for (size_t frame = 0; frame < frameCount; ++frame)
+		CheckFrame(reader, reference, frame, settings);
+
+	reader.Close();
+	std::filesystem::remove(filename);
+}
+
+// A file whose writer never got to Close() (crash, power loss) has no index and may end in a partial frame. The reader
+// rebuilds the index from the frame headers and keeps every complete frame
+static void TestTruncatedFile(const ReferenceTrajectory& reference)
+{
+	TrajectoryWriter::Settings settings;
+	settings.KeyframeInterval = 8;
+
+	const std::string filename = TestFilename("Truncated");
+	CHECK(WriteReference(filename, reference, settings));
+
+	// The frames end where the index starts
+	const size_t frameCount = reference.Positions.size();
+	const uintmax_t fullSize = std::filesystem::file_size(filename);
+	const uintmax_t framesEnd = fullSize - frameCount * sizeof(TrajectoryIndexEntry) - sizeof(TrajectoryFooter);
+
+	struct Case
+	{
+		const char* Name;
+		uintmax_t Size;
+		size_t ExpectedFrames;
+	};
+	// Each case cuts off more of the same file
+	const Case cases[] = {
+		{ "without the footer", fullSize - sizeof(TrajectoryFooter), frameCount },
+		{ "in the index", framesEnd + sizeof(TrajectoryIndexEntry) + 12, frameCount },
+		{ "at the end of the frames", framesEnd, frameCount },
+		{ "inside the last frame", framesEnd - 7, frameCount - 1 },
+	};
+
+	TrajectoryReader reader;
+	for (const Case& test : cases)
+	{
+		std::filesystem::resize_file(filename, test.Size);
+		CHECK(reader.Open(filename));
+		if (!reader.IsOpen())
+			continue;
+		CHECK(!reader.HadIndex());
+		CHECK(reader.FrameCount() == test.ExpectedFrames);
+		if (reader.FrameCount() != test.ExpectedFrames)
+			std::fprintf(stderr, "  truncated %s: %zu frames, expected %zu\n", test.Name, reader.FrameCount(), test.ExpectedFrames);
+
+		for (size_t frame = 0; frame < std::min(reader.FrameCount(), test.ExpectedFrames); ++frame)
+		{
+			CHECK(reader.FrameStep(frame) == ReferenceTrajectory::Step(frame));
+			CheckFrame(reader, reference, frame, settings);
+		}
+		reader.Close();
+	}
+
+	std::filesystem::remove(filename);
+}
+
+int main()
+{
+	TestRandom random(3636);
+	const ReferenceTrajectory reference = MakeReference(random, 2000, 40);
+
+	TestRoundTrip(reference, TrajectoryEncoding::FLOAT32);
+	TestRoundTrip(reference, TrajectoryEncoding::FLOAT16);
+	TestRoundTrip(reference, TrajectoryEncoding::QUANTIZED_DELTA);
+	TestFrameAtStepAndObservables(reference);
+	TestTruncatedFile(reference);
+
+	return TestResult("TrajectoryTests");
+}
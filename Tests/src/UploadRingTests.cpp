@@ -0,0 +1,137 @@
+#include "Check.h"
+#include "UploadRingAllocator.h"
+
+#include <deque>
+#include <vector>
+
+// Simulates a GPU that finishes each frame 'latency' frames after it was submitted. Every byte handed out is tagged
+// with the frame that owns it, and an allocation must never overlap a byte that belongs to a frame the GPU has not
+// finished yet. Returns the number of times the ring wrapped around
+static unsigned int RunFrames(UploadRingAllocator& ring, TestRandom& random, unsigned int frameCount, unsigned int latency, unsigned int allocationsPerFrame, size_t maxSize)
+{
+	const uint64_t Free = 0;
+	std::vector<uint64_t> owner(ring.Capacity(), Free);
+
+	unsigned int wraps = 0;
+	unsigned int failures = 0;
+	size_t previousOffset = 0;
+	uint64_t completed = 0;
+
+	for (uint64_t frame = 1; frame <= frameCount; ++frame)
+	{
+		// Frames older than 'latency' are done on the GPU
+		if (frame > latency)
+		{
+			completed = frame - latency;
+			ring.ReleaseCompletedFrames(completed);
+			for (uint64_t& byteOwner : owner)
+				if (byteOwner != Free && byteOwner <= completed)
+					byteOwner = Free;
+		}
+
+		for (unsigned int iii = 0; iii < allocationsPerFrame; ++iii)
+		{
+			const size_t size = 1 + random.NextUInt() % maxSize;
+			const size_t alignment = size_t(1) << (random.NextUInt() % 9); // 1 to 256
+
+			const size_t offset = ring.Allocate(size, alignment);
+			if (offset == UploadRingAllocator::InvalidOffset)
+			{
+				++failures;
+				continue;
+			}
+
+			CHECK(offset % alignment == 0);
+			CHECK(offset + size <= ring.Capacity());
+			if (offset + size > ring.Capacity())
+				continue;
+
+			bool overlaps = false;
+			for (size_t byte = offset; byte < offset + size; ++byte)
+			{
+				overlaps = overlaps || owner[byte] != Free;
+				owner[byte] = frame;
+			}
+			CHECK(!overlaps);
+
+			if (offset < previousOffset)
+				++wraps;
+			previousOffset = offset + size;
+		}
+
+		ring.FinishFrame(frame);
+		CHECK(ring.FramesInFlight() <= latency + 1);
+	}
+
+	// With small enough allocations, the ring must never run out of space
+	CHECK(failures == 0);
+	return wraps;
+}
+
+static void TestWraparound()
+{
+	TestRandom random(29);
+
+	// Three frames in flight of up to ~8 x 300 bytes each fits comfortably in 16KB, so the ring wraps many times
+	UploadRingAllocator ring(16 * 1024);
+	const unsigned int wraps = RunFrames(ring, random, 2000, 3, 8, 300);
+	CHECK(wraps > 100);
+
+	// Once the GPU catches up, everything is released and the whole ring is available again
+	ring.ReleaseCompletedFrames(UINT64_MAX);
+	CHECK(ring.UsedBytes() == 0);
+	CHECK(ring.FramesInFlight() == 0);
+	CHECK(ring.Allocate(ring.Capacity(), 256) == 0);
+	std::printf("UploadRingAllocator: wrapped %u times over 2000 frames\n", wraps);
+}
+
+static void TestFullRing()
+{
+	UploadRingAllocator ring(1024);
+
+	// Larger than the ring, or zero bytes
+	CHECK(ring.Allocate(2048, 16) == UploadRingAllocator::InvalidOffset);
+	CHECK(ring.Allocate(0, 16) == UploadRingAllocator::InvalidOffset);
+
+	CHECK(ring.Allocate(600, 256) == 0);
+	ring.FinishFrame(1);
+
+	// 600 -> 768 (aligned) + 256 = 1024 fits exactly at the end
+	CHECK(ring.Allocate(256, 256) == 768);
+	ring.FinishFrame(2);
+
+	// Frame 1 still owns [0, 600), so nothing fits until it completes
+	CHECK(ring.Allocate(64, 16) == UploadRingAllocator::InvalidOffset);
+
+	// Once it does, the allocation wraps around to the front. Frame 2 owns everything from the end of frame 1 (including
+	// its alignment padding), so only [0, 600) is free
+	ring.ReleaseCompletedFrames(1);
+	CHECK(ring.Allocate(512, 256) == 0);
+	CHECK(ring.Allocate(64, 16) == 512);
+	CHECK(ring.Allocate(64, 16) == UploadRingAllocator::InvalidOffset);
+	ring.FinishFrame(3);
+
+	// Frame 2 completing frees the rest of the buffer
+	ring.ReleaseCompletedFrames(2);
+	CHECK(ring.Allocate(256, 16) == 576);
+
+	// Reset drops everything, including frames in flight
+	ring.Reset(4096);
+	CHECK(ring.Capacity() == 4096);
+	CHECK(ring.UsedBytes() == 0);
+	CHECK(ring.FramesInFlight() == 0);
+	CHECK(ring.Allocate(4096, 256) == 0);
+}
+
+int main()
+{
+	TestWraparound();
+	TestFullRing();
+
+	UploadRingAllocator ring(64 * 1024 * 1024);
+	size_t offset = 0;
+	double allocateNs = 1e6 * TimeMilliseconds([&]() { offset = ring.Allocate(64 * 1024, 256); if (offset == UploadRingAllocator::InvalidOffset) ring.Reset(); }, 100000);
+	std::printf("UploadRingAllocator: %.1f ns per allocation\n", allocateNs);
+
+	return TestResult("UploadRingTests");
+}